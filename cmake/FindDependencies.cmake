@@ -52,6 +52,24 @@ if(OMNICPP_USE_STB)
     message(STATUS "Found stb")
 endif()
 
+# ============================================================================
+# asio (Standalone Async I/O)
+# ============================================================================
+# Header-only; backs omnicpp::concurrency::ThreadPool
+CPMAddPackage(
+    NAME asio
+    GIT_TAG asio-1-30-2
+    GITHUB_REPOSITORY chriskohlhoff/asio
+    DOWNLOAD_ONLY YES
+)
+if(asio_ADDED AND NOT TARGET asio::asio)
+    add_library(asio INTERFACE)
+    add_library(asio::asio ALIAS asio)
+    target_include_directories(asio SYSTEM INTERFACE ${asio_SOURCE_DIR}/asio/include)
+    target_compile_definitions(asio INTERFACE ASIO_STANDALONE ASIO_NO_DEPRECATED)
+    message(STATUS "Found asio")
+endif()
+
 # ============================================================================
 # GLFW (Windowing Library)
 # ============================================================================
@@ -192,6 +210,39 @@ if(OMNICPP_USE_NLOHMANN_JSON)
     message(STATUS "Found nlohmann_json: ${nlohmann_json_VERSION}")
 endif()
 
+# ============================================================================
+# Lua (Scripting)
+# ============================================================================
+# Built from the release tarball as a static library; backs
+# omnicpp::scripting::ScriptManager
+if(OMNICPP_USE_LUA)
+    CPMAddPackage(
+        NAME lua
+        VERSION 5.4.6
+        URL https://www.lua.org/ftp/lua-5.4.6.tar.gz
+        DOWNLOAD_ONLY YES
+    )
+    if(lua_ADDED AND NOT TARGET lua::lua)
+        enable_language(C)
+        file(GLOB LUA_SOURCES ${lua_SOURCE_DIR}/src/*.c)
+        # Drop the standalone interpreter and compiler (they define main)
+        list(REMOVE_ITEM LUA_SOURCES ${lua_SOURCE_DIR}/src/lua.c ${lua_SOURCE_DIR}/src/luac.c
+                                     ${lua_SOURCE_DIR}/src/onelua.c)
+        add_library(lua STATIC ${LUA_SOURCES})
+        add_library(lua::lua ALIAS lua)
+        set_target_properties(lua PROPERTIES POSITION_INDEPENDENT_CODE ON)
+        target_include_directories(lua SYSTEM PUBLIC ${lua_SOURCE_DIR}/src)
+        if(UNIX)
+            target_compile_definitions(lua PRIVATE LUA_USE_POSIX)
+            target_link_libraries(lua PRIVATE m)
+        endif()
+        message(STATUS "Found lua: 5.4.6")
+    elseif(NOT TARGET lua::lua)
+        message(WARNING "Lua not found, scripting will be disabled")
+        set(OMNICPP_USE_LUA OFF CACHE BOOL "Embed Lua for scripting" FORCE)
+    endif()
+endif()
+
 # ============================================================================
 # Google Test (Testing Framework)
 # ============================================================================
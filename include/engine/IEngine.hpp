@@ -7,10 +7,16 @@
 #ifndef OMNICPP_IENGINE_HPP
 #define OMNICPP_IENGINE_HPP
 
+#include "engine/graphics/frame_capture.hpp"
 #include <cstdint>
+#include <memory>
 
 namespace omnicpp {
 
+namespace core {
+class ITimeProvider;
+}
+
 // Forward declarations
 class IRenderer;
 class IInputManager;
@@ -24,13 +30,32 @@ class IPlatform;
  * @brief Engine configuration structure
  */
 struct EngineConfig {
-    IRenderer* renderer;
-    IInputManager* input_manager;
-    IAudioManager* audio_manager;
-    IPhysicsEngine* physics_engine;
-    IResourceManager* resource_manager;
-    ILogger* logger;
-    IPlatform* platform;
+    IRenderer* renderer = nullptr;
+    IInputManager* input_manager = nullptr;
+    IAudioManager* audio_manager = nullptr;
+    IPhysicsEngine* physics_engine = nullptr;
+    IResourceManager* resource_manager = nullptr;
+    ILogger* logger = nullptr;
+    IPlatform* platform = nullptr;
+
+    // Startup
+    bool parallel_init = true; // Start independent subsystems on the thread pool (false = serial)
+
+    // Frame loop (run())
+    uint32_t max_fps = 60;   // Paced against absolute deadlines; 0 = uncapped
+    uint64_t max_frames = 0; // Leave run() after N frames (0 = until the window closes)
+    float fixed_timestep = 1.0f / 60.0f; // Simulation step in seconds
+    uint32_t pipeline_depth = 3;         // Frames in flight: simulate N+1 | extract N | submit N-1 (1 = serial)
+
+    // Headless / server runs
+    bool headless = false; // No window, GPU or audio device; unset renderer/audio get null backends
+    bool enable_frame_capture = false;
+    OmniCpp::Engine::Graphics::FrameCaptureConfig capture;
+    std::shared_ptr<core::ITimeProvider> time_provider; // nullptr = system clock; a VirtualTimeProvider
+                                                        // runs unpaced, one fixed step per frame
+
+    // Diagnostics
+    bool enable_profiling = false; // Record OMNICPP_PROFILE_SCOPE timings (when compiled in)
 };
 
 /**
@@ -62,6 +87,24 @@ public:
      * @brief Render frame
      */
     virtual void render() = 0;
+
+    /**
+     * @brief Run the frame loop until the window closes or max_frames have started
+     *
+     * Each frame goes through simulate (fixed steps), extract and submit.
+     * With pipeline_depth > 1 those stages of consecutive frames overlap,
+     * and every frame in flight is finished before run() returns. Frames
+     * are paced to max_fps against absolute deadlines, and frame-time
+     * percentiles are logged when the loop ends.
+     */
+    virtual void run() = 0;
+
+    /**
+     * @brief Arm capture of the next presented frames
+     * @param frame_count Number of consecutive frames to capture
+     * @note Requires enable_frame_capture; goes to the null renderer when headless
+     */
+    virtual void request_frame_capture(uint32_t frame_count) = 0;
     
     /**
      * @brief Get renderer subsystem
@@ -0,0 +1,113 @@
+/**
+ * @file decoder.hpp
+ * @brief Pluggable audio decoders (WAV built in)
+ */
+
+#pragma once
+
+#include "engine/audio/mixer.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace omnicpp {
+namespace audio {
+
+  /**
+   * @brief Sequential PCM source producing interleaved float frames
+   *
+   * Used from one thread at a time: the loader for resident sounds, the
+   * mixer's streaming thread for streamed ones.
+   */
+  class AudioDecoder {
+  public:
+    virtual ~AudioDecoder () = default;
+
+    [[nodiscard]] virtual uint32_t channels () const = 0;
+    [[nodiscard]] virtual uint32_t sample_rate () const = 0;
+
+    /**
+     * @brief Total length in frames, or 0 if unknown
+     */
+    [[nodiscard]] virtual uint64_t frame_count () const = 0;
+
+    /**
+     * @brief Decode up to out.size() / channels() frames
+     * @return Frames written; 0 at the end of the stream
+     */
+    virtual std::size_t read (std::span<float> out) = 0;
+
+    virtual bool seek (uint64_t frame) = 0;
+  };
+
+  /**
+   * @brief RIFF/WAVE decoder: 8/16/24/32-bit integer PCM and 32-bit float
+   */
+  class WavDecoder final : public AudioDecoder {
+  public:
+    WavDecoder () = default;
+    ~WavDecoder () override;
+
+    WavDecoder (const WavDecoder&) = delete;
+    WavDecoder& operator= (const WavDecoder&) = delete;
+
+    bool open (const std::string& path);
+
+    [[nodiscard]] uint32_t channels () const override { return m_channels; }
+    [[nodiscard]] uint32_t sample_rate () const override { return m_sample_rate; }
+    [[nodiscard]] uint64_t frame_count () const override { return m_frame_count; }
+    std::size_t read (std::span<float> out) override;
+    bool seek (uint64_t frame) override;
+
+  private:
+    std::FILE* m_file{ nullptr };
+    uint16_t m_format{ 0 };
+    uint16_t m_bits{ 0 };
+    uint32_t m_channels{ 0 };
+    uint32_t m_sample_rate{ 0 };
+    uint32_t m_block_align{ 0 };
+    long m_data_offset{ 0 };
+    uint64_t m_frame_count{ 0 };
+    uint64_t m_cursor{ 0 };
+    std::vector<uint8_t> m_raw;
+  };
+
+  using DecoderFactory = std::function<std::unique_ptr<AudioDecoder> (const std::string& path)>;
+
+  /**
+   * @brief Maps file extensions to decoder factories
+   *
+   * WAV is registered by default; codecs that need a library (Ogg Vorbis,
+   * FLAC, ...) are registered by whoever links it.
+   */
+  class DecoderRegistry {
+  public:
+    DecoderRegistry ();
+
+    /**
+     * @param extension Lower-case, with the dot (".ogg")
+     */
+    void register_decoder (std::string extension, DecoderFactory factory);
+
+    /**
+     * @return nullptr if no decoder handles the extension or the file cannot be opened
+     */
+    [[nodiscard]] std::unique_ptr<AudioDecoder> open (const std::string& path) const;
+
+  private:
+    std::unordered_map<std::string, DecoderFactory> m_factories;
+  };
+
+  /**
+   * @brief Decode a whole stream into memory
+   * @return nullptr if the decoder produced nothing
+   */
+  [[nodiscard]] std::shared_ptr<SoundData> decode_all (AudioDecoder& decoder);
+
+} // namespace audio
+} // namespace omnicpp
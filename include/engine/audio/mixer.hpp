@@ -0,0 +1,255 @@
+/**
+ * @file mixer.hpp
+ * @brief Lock-free real-time audio mixer and output devices
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace omnicpp {
+namespace audio {
+
+  /**
+   * @brief Decoded PCM, interleaved float frames (1 or 2 channels)
+   */
+  struct SoundData {
+    std::vector<float> samples;
+    uint32_t channels{ 1 };
+    uint32_t sample_rate{ 48000 };
+
+    [[nodiscard]] std::size_t frame_count () const { return channels ? samples.size () / channels : 0; }
+  };
+
+  class AudioDecoder;
+
+  using SoundId = uint32_t;
+  inline constexpr SoundId INVALID_SOUND = 0;
+
+  /**
+   * @brief A playing instance of a sound (slot and generation packed)
+   */
+  struct VoiceHandle {
+    uint32_t value{ 0 };
+
+    [[nodiscard]] bool valid () const { return value != 0; }
+    [[nodiscard]] bool operator== (const VoiceHandle&) const = default;
+  };
+
+  /**
+   * @brief Initial voice parameters
+   */
+  struct VoiceParams {
+    float gain{ 1.0f };
+    float pan{ 0.0f };   // -1 = left, 0 = centre, 1 = right (balance for stereo sounds)
+    float pitch{ 1.0f }; // Playback rate multiplier
+    bool loop{ false };
+    uint64_t start_frame{ 0 }; // Source frame to start from (wrapped for looping sounds)
+  };
+
+  /**
+   * @brief Destination for mixed audio, driven by the mixer thread
+   *
+   * write() receives one block of interleaved stereo float frames and may
+   * block until the device wants the next one; that wait is what paces the
+   * mixer.
+   */
+  class AudioOutput {
+  public:
+    virtual ~AudioOutput () = default;
+
+    virtual bool open (uint32_t sample_rate, uint32_t block_frames) = 0;
+    virtual bool write (std::span<const float> interleaved) = 0;
+    virtual void close () = 0;
+  };
+
+  /**
+   * @brief Discards audio; optionally sleeps to real-time pace
+   */
+  class NullAudioOutput final : public AudioOutput {
+  public:
+    explicit NullAudioOutput (bool paced = false);
+
+    bool open (uint32_t sample_rate, uint32_t block_frames) override;
+    bool write (std::span<const float> interleaved) override;
+    void close () override;
+
+    [[nodiscard]] uint64_t get_frames_written () const { return m_frames_written; }
+
+  private:
+    bool m_paced;
+    uint32_t m_sample_rate{ 0 };
+    uint64_t m_frames_written{ 0 };
+    int64_t m_start_ns{ 0 };
+  };
+
+  /**
+   * @brief Writes a 32-bit float stereo WAV file (offline rendering, tests)
+   */
+  class WavFileOutput final : public AudioOutput {
+  public:
+    explicit WavFileOutput (std::string path);
+    ~WavFileOutput () override;
+
+    WavFileOutput (const WavFileOutput&) = delete;
+    WavFileOutput& operator= (const WavFileOutput&) = delete;
+
+    bool open (uint32_t sample_rate, uint32_t block_frames) override;
+    bool write (std::span<const float> interleaved) override;
+    void close () override;
+
+    [[nodiscard]] uint64_t get_frames_written () const { return m_frames_written; }
+
+  private:
+    std::string m_path;
+    std::FILE* m_file{ nullptr };
+    uint64_t m_frames_written{ 0 };
+  };
+
+  /**
+   * @brief Mixer configuration
+   */
+  struct MixerConfig {
+    uint32_t sample_rate{ 48000 };
+    uint32_t block_frames{ 256 };
+    uint32_t max_voices{ 256 };
+    std::size_t command_capacity{ 1024 };
+    uint32_t max_streams{ 16 };               // Voices that may stream at once
+    uint32_t stream_buffer_frames{ 32768 };   // Ring per streamed voice (~0.7 s at 48 kHz)
+    uint32_t stream_chunk_frames{ 4096 };     // Decoded per read
+    uint32_t stream_low_watermark{ 16384 };   // Refill when fewer frames than this are buffered
+  };
+
+  /**
+   * @brief Mixer counters (written by the mixing thread, readable anywhere)
+   */
+  struct MixerStats {
+    uint64_t blocks{ 0 };
+    uint64_t voices_mixed{ 0 };      // Sum over blocks of the voices mixed in each
+    uint64_t mix_ns{ 0 };            // Time spent inside render()
+    uint64_t commands{ 0 };
+    uint64_t dropped_commands{ 0 };  // Rejected because the command queue was full
+    uint32_t peak_voices{ 0 };
+    uint64_t stream_frames_decoded{ 0 };
+    uint64_t stream_underruns{ 0 };  // Blocks in which a started stream ran dry
+  };
+
+  /**
+   * @brief Real-time software mixer
+   *
+   * The control side (play, stop, set_gain, ..., update) belongs to one
+   * thread, typically the game thread. It never touches voice state
+   * directly: every change is a fixed-size command pushed through a
+   * lock-free SPSC queue and applied by the mixing thread at the start of
+   * its next block. Finished voices come back through a second SPSC queue
+   * and are recycled by update(), which also releases removed sounds once
+   * no voice reads them.
+   *
+   * The mixing side (render, or the output thread) neither locks nor
+   * allocates: voices live in a preallocated array, sounds are read
+   * through pointers the control side keeps alive, and all scratch buffers
+   * are sized at initialize(). Each voice is resampled with linear
+   * interpolation (a straight copy at unity rate) and accumulated with
+   * per-block gain and constant-power pan ramps; gain, pan, interpolation
+   * and the final interleave use SSE where available.
+   *
+   * Streamed voices read from a per-voice ring that a background thread
+   * keeps topped up from an AudioDecoder: once a ring drops below the low
+   * watermark it is refilled chunk by chunk until full. Looping streams
+   * seek the decoder back to the start and keep writing into the same
+   * ring, so the mixer never sees the seam. Rings are allocated up front
+   * (max_streams of them); the decoder thread is the only one doing IO.
+   */
+  class Mixer {
+  public:
+    Mixer ();
+    ~Mixer ();
+
+    Mixer (const Mixer&) = delete;
+    Mixer& operator= (const Mixer&) = delete;
+
+    Mixer (Mixer&&) noexcept;
+    Mixer& operator= (Mixer&&) noexcept;
+
+    bool initialize (const MixerConfig& config = {});
+    void shutdown ();
+
+    /**
+     * @brief Register decoded audio; the mixer reads it in place
+     */
+    SoundId add_sound (std::shared_ptr<const SoundData> sound);
+
+    /**
+     * @brief Stop the sound's voices; the data is released by a later update()
+     */
+    void remove_sound (SoundId sound);
+
+    /**
+     * @return The registered data, or null for unknown and removed sounds
+     */
+    [[nodiscard]] std::shared_ptr<const SoundData> get_sound (SoundId sound) const;
+
+    /**
+     * @return An invalid handle when no voice is free or the command queue is full
+     */
+    VoiceHandle play (SoundId sound, const VoiceParams& params = {});
+
+    /**
+     * @brief Play from a decoder, streamed through a prefetch ring
+     *
+     * The voice starts once the first chunk is decoded. Pitch is limited
+     * to 4x for streamed voices.
+     * @return An invalid handle when no stream or voice is free
+     */
+    VoiceHandle play_stream (std::unique_ptr<AudioDecoder> decoder, const VoiceParams& params = {});
+
+    bool stop (VoiceHandle voice); // Fades out over one block
+    bool pause (VoiceHandle voice);
+    bool resume (VoiceHandle voice);
+    bool set_gain (VoiceHandle voice, float gain);
+    bool set_pan (VoiceHandle voice, float pan);
+    bool set_pitch (VoiceHandle voice, float pitch);
+    void set_master_gain (float gain);
+
+    /**
+     * @brief Recycle finished voices and release removed sounds (control thread)
+     */
+    void update ();
+
+    /**
+     * @brief True from play() until update() sees the voice finish
+     */
+    [[nodiscard]] bool is_playing (VoiceHandle voice) const;
+    [[nodiscard]] uint32_t get_active_voice_count () const;
+
+    /**
+     * @brief Mix one block on the calling thread (pull-model devices, offline rendering)
+     * @param out block_frames interleaved stereo frames
+     *
+     * Must not be called while an output thread is running.
+     */
+    void render (std::span<float> out);
+
+    /**
+     * @brief Open the device and start the mixing thread that feeds it
+     */
+    bool start_output (std::unique_ptr<AudioOutput> output);
+    void stop_output ();
+    [[nodiscard]] bool is_output_running () const;
+
+    [[nodiscard]] MixerStats get_stats () const;
+    [[nodiscard]] const MixerConfig& get_config () const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+} // namespace audio
+} // namespace omnicpp
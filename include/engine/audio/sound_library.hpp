@@ -0,0 +1,84 @@
+/**
+ * @file sound_library.hpp
+ * @brief Sound loading with a resident/streamed split by decoded size
+ */
+
+#pragma once
+
+#include "engine/audio/decoder.hpp"
+#include "engine/audio/mixer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace omnicpp {
+namespace audio {
+
+  /**
+   * @brief Loading policy
+   */
+  struct SoundLibraryConfig {
+    std::size_t resident_limit_bytes{ 1024 * 1024 }; // Decoded size up to which a sound is kept in memory
+  };
+
+  /**
+   * @brief A loaded sound: resident in the mixer, or a file to stream from
+   */
+  struct SoundAsset {
+    std::string path;
+    SoundId sound{ INVALID_SOUND }; // Resident sounds only
+    bool streamed{ false };
+    uint32_t channels{ 0 };
+    uint32_t sample_rate{ 0 };
+    uint64_t frame_count{ 0 };
+
+    [[nodiscard]] bool valid () const { return sound != INVALID_SOUND || streamed; }
+  };
+
+  /**
+   * @brief Decides per file whether to decode up front or stream
+   *
+   * Short effects are decoded once and shared by every voice that plays
+   * them. Anything whose decoded PCM would exceed resident_limit_bytes (or
+   * whose length the decoder cannot tell) is streamed instead: each play
+   * opens its own decoder and the mixer's decoder thread feeds it through
+   * a prefetch ring, so a five-minute track costs a ring, not 50 MB.
+   *
+   * Control-thread only, like the Mixer calls it makes.
+   */
+  class SoundLibrary {
+  public:
+    explicit SoundLibrary (Mixer& mixer, const SoundLibraryConfig& config = {});
+    ~SoundLibrary ();
+
+    SoundLibrary (const SoundLibrary&) = delete;
+    SoundLibrary& operator= (const SoundLibrary&) = delete;
+
+    /**
+     * @brief Register codecs here (WAV is built in)
+     */
+    [[nodiscard]] DecoderRegistry& get_decoders () { return m_decoders; }
+
+    /**
+     * @brief Probe and, for short sounds, decode a file; repeated loads return the same asset
+     * @return An invalid asset if no decoder could open the file
+     */
+    SoundAsset load (const std::string& path);
+
+    VoiceHandle play (const SoundAsset& asset, const VoiceParams& params = {});
+
+    void unload (const std::string& path);
+
+    [[nodiscard]] std::size_t get_resident_bytes () const { return m_resident_bytes; }
+
+  private:
+    Mixer& m_mixer;
+    SoundLibraryConfig m_config;
+    DecoderRegistry m_decoders;
+    std::unordered_map<std::string, SoundAsset> m_assets;
+    std::size_t m_resident_bytes{ 0 };
+  };
+
+} // namespace audio
+} // namespace omnicpp
@@ -0,0 +1,181 @@
+/**
+ * @file voice_manager.hpp
+ * @brief Emitter virtualization, voice pooling and priority stealing on top of the mixer
+ */
+
+#pragma once
+
+#include "engine/audio/mixer.hpp"
+#include "engine/math/Vec3.hpp"
+#include "engine/memory/SoAContainers.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace omnicpp {
+namespace audio {
+
+  using EmitterId = uint32_t;
+  inline constexpr EmitterId INVALID_EMITTER = 0;
+
+  /**
+   * @brief A positioned sound source
+   */
+  struct EmitterDesc {
+    SoundId sound{ INVALID_SOUND };
+    math::Vec3 position;
+    float gain{ 1.0f };
+    float pitch{ 1.0f };
+    float priority{ 1.0f };        // Relative importance when voices are scarce
+    float min_distance{ 1.0f };    // Full volume inside this radius
+    float max_distance{ 100.0f };  // Silent (and never real) beyond this radius
+    bool loop{ false };
+  };
+
+  /**
+   * @brief Where the player hears from
+   */
+  struct Listener {
+    math::Vec3 position;
+    math::Vec3 right{ 1.0f, 0.0f, 0.0f }; // Unit vector; pan is the projection onto it
+  };
+
+  /**
+   * @brief Voice budget
+   *
+   * The mixer needs some headroom over max_real_voices: a stolen voice
+   * keeps its mixer slot until its fade-out block has played and
+   * Mixer::update() has recycled it.
+   */
+  struct VoiceManagerConfig {
+    uint32_t max_real_voices{ 32 };
+    float audibility_threshold{ 0.001f }; // -60 dB: quieter emitters stay virtual
+    float steal_hysteresis{ 1.25f };      // Score bonus for voices that are already real
+  };
+
+  /**
+   * @brief Counters; the first three describe the last update()
+   */
+  struct VoiceManagerStats {
+    uint32_t emitters{ 0 };
+    uint32_t real_voices{ 0 };
+    uint32_t virtual_voices{ 0 };
+    uint64_t promotions{ 0 };  // Virtual -> real
+    uint64_t demotions{ 0 };   // Real -> virtual
+    uint64_t steals{ 0 };      // Demotions of still-audible voices to make room for higher scores
+    uint64_t expired{ 0 };     // One-shots that finished, real or virtual
+    uint64_t update_ns{ 0 };   // Duration of the last update()
+  };
+
+  /**
+   * @brief Distance attenuation and pan for `count` emitters stored as columns
+   *
+   * Attenuation is inverse-distance clamped to [min_distance, max_distance]
+   * and zero beyond max_distance. Pan is the projection of the emitter
+   * direction onto listener.right, narrowing toward the centre inside
+   * min_distance. Four emitters per step with SSE where available.
+   */
+  void spatialize (const Listener& listener, std::size_t count, const float* x, const float* y, const float* z,
+      const float* min_distance, const float* max_distance, float* attenuation, float* pan);
+
+  /**
+   * @brief Maps any number of emitters onto a fixed pool of mixer voices
+   *
+   * Every emitter is always virtual: update() attenuates all of them in one
+   * SIMD pass over the emitter columns and advances their playback cursor
+   * by dt, whether or not they are heard. Only the max_real_voices
+   * emitters with the best score (priority x gain x attenuation, with a
+   * hysteresis bonus for voices already playing) own a real mixer voice;
+   * the rest cost a few floats per update. When an emitter loses its place
+   * its voice is stopped (stolen); when it gains one it is started at its
+   * cursor, so a looping ambience that was virtual for ten seconds resumes
+   * ten seconds further in. One-shots expire from their cursor whether
+   * real or virtual, and are removed.
+   *
+   * The mixer therefore never mixes more than max_real_voices voices from
+   * this manager, regardless of how many emitters exist. Control-thread
+   * only, like the Mixer calls it makes; the owner still calls
+   * Mixer::update().
+   */
+  class VoiceManager {
+  public:
+    explicit VoiceManager (Mixer& mixer, const VoiceManagerConfig& config = {});
+    ~VoiceManager ();
+
+    VoiceManager (const VoiceManager&) = delete;
+    VoiceManager& operator= (const VoiceManager&) = delete;
+
+    /**
+     * @return INVALID_EMITTER if the sound is not registered with the mixer
+     */
+    EmitterId add_emitter (const EmitterDesc& desc);
+    void remove_emitter (EmitterId emitter);
+
+    bool set_position (EmitterId emitter, const math::Vec3& position);
+    bool set_gain (EmitterId emitter, float gain);
+    bool set_priority (EmitterId emitter, float priority);
+
+    /**
+     * @brief Spatialize, advance cursors, expire one-shots and reassign real voices
+     */
+    void update (const Listener& listener, float dt);
+
+    /**
+     * @brief False once removed or (for one-shots) finished
+     */
+    [[nodiscard]] bool is_active (EmitterId emitter) const;
+    [[nodiscard]] bool is_real (EmitterId emitter) const;
+    [[nodiscard]] VoiceHandle get_voice (EmitterId emitter) const;
+
+    /**
+     * @brief Source frame the emitter has reached
+     */
+    [[nodiscard]] uint64_t get_cursor (EmitterId emitter) const;
+
+    /**
+     * @brief gain x attenuation as of the last update()
+     */
+    [[nodiscard]] float get_audibility (EmitterId emitter) const;
+
+    [[nodiscard]] const VoiceManagerStats& get_stats () const { return m_stats; }
+
+  private:
+    // Hot columns, read by the per-update passes
+    enum Column : std::size_t { X, Y, Z, MIN_DISTANCE, MAX_DISTANCE, GAIN, PRIORITY, PITCH, ATTENUATION, PAN };
+    using Columns = memory::SoAVector<float, float, float, float, float, float, float, float, float, float>;
+
+    /**
+     * @brief Per-emitter playback state, same index as the columns
+     */
+    struct Playback {
+      EmitterId id{ INVALID_EMITTER };
+      SoundId sound{ INVALID_SOUND };
+      VoiceHandle voice;
+      double cursor{ 0.0 };     // Source frames
+      double frames{ 0.0 };
+      double sample_rate{ 0.0 };
+      bool loop{ false };
+    };
+
+    [[nodiscard]] const std::size_t* find (EmitterId emitter) const;
+    void erase (std::size_t index);
+    void demote (std::size_t index, bool stolen);
+
+    Mixer& m_mixer;
+    VoiceManagerConfig m_config;
+    Columns m_columns;
+    std::vector<Playback> m_playback;
+    std::unordered_map<EmitterId, std::size_t> m_index;
+    EmitterId m_next_id{ 1 };
+
+    // Scratch, reused across updates
+    std::vector<float> m_scores;
+    std::vector<uint32_t> m_candidates;
+    std::vector<uint8_t> m_selected;
+
+    VoiceManagerStats m_stats;
+  };
+
+} // namespace audio
+} // namespace omnicpp
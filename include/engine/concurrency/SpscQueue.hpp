@@ -0,0 +1,126 @@
+/**
+ * @file SpscQueue.hpp
+ * @brief Bounded lock-free single-producer single-consumer queue
+ * @version 1.0.0
+ *
+ * For handing work to threads that must never block or allocate, such as
+ * the audio mixer: push and pop are wait-free and touch only
+ * preallocated storage.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace omnicpp {
+namespace concurrency {
+
+// ============================================================================
+// SPSC Queue - one producer thread, one consumer thread
+// ============================================================================
+
+/**
+ * @brief Fixed-capacity ring with acquire/release indices
+ * @tparam T Element type (moved in and out)
+ *
+ * Capacity is rounded up to a power of two. Each side caches the other
+ * side's index and only re-reads it when the ring looks full or empty, so
+ * steady traffic costs one shared cache-line transfer per batch rather
+ * than per element.
+ */
+template<typename T>
+class SpscQueue {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "SpscQueue elements must be nothrow movable");
+
+public:
+    explicit SpscQueue(std::size_t capacity)
+        : capacity_(round_up(capacity)), mask_(capacity_ - 1),
+          slots_(std::make_unique<Slot[]>(capacity_)) {}
+
+    ~SpscQueue() {
+        while (try_pop()) {
+        }
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Producer side
+     * @return false when the queue is full (the element is untouched)
+     */
+    template<typename U>
+    bool try_push(U&& item) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ >= capacity_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ >= capacity_) {
+                return false;
+            }
+        }
+        ::new (slots_[tail & mask_].storage) T(std::forward<U>(item));
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side
+     */
+    [[nodiscard]] std::optional<T> try_pop() {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return std::nullopt;
+            }
+        }
+        T* item = std::launder(reinterpret_cast<T*>(slots_[head & mask_].storage));
+        std::optional<T> result(std::move(*item));
+        item->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return result;
+    }
+
+    /**
+     * @brief Approximate element count (exact only when both sides are idle)
+     */
+    [[nodiscard]] std::size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static std::size_t round_up(std::size_t value) {
+        std::size_t capacity = 2;
+        while (capacity < value) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    static constexpr std::size_t kCacheLine = 64;
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};  // Written by the consumer
+    std::size_t tail_cache_{0};                              // Consumer's view of tail_
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};  // Written by the producer
+    std::size_t head_cache_{0};                              // Producer's view of head_
+};
+
+} // namespace concurrency
+} // namespace omnicpp
@@ -15,6 +15,8 @@
 #include <future>
 #include <memory>
 #include <type_traits>
+#include <asio/awaitable.hpp>
+#include <asio/co_spawn.hpp>
 #include <asio/io_context.hpp>
 #include <asio/thread_pool.hpp>
 #include <asio/post.hpp>
@@ -153,10 +155,10 @@ public:
     [[nodiscard]] const asio::thread_pool& get_pool() const noexcept { return pool_; }
     
     /**
-     * @brief Get the io_context for custom asio operations
+     * @brief Get the pool executor for custom asio operations
      */
-    [[nodiscard]] asio::io_context& get_io_context() noexcept {
-        return pool_.get_executor().context();
+    [[nodiscard]] asio::thread_pool::executor_type get_executor() noexcept {
+        return pool_.get_executor();
     }
     
     /**
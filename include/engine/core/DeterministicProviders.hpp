@@ -11,12 +11,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <random>
 #include <memory>
 #include <functional>
 #include <concepts>
 #include <optional>
+#include <queue>
 #include "engine/core/StrongTypes.hpp"
 
 namespace omnicpp {
@@ -206,6 +208,53 @@ private:
     std::chrono::steady_clock::time_point start_;
 };
 
+/**
+ * @brief Thread-safe virtual clock for headless and faster-than-real-time runs
+ *
+ * Unlike MockTimeProvider, reads and advances may come from different
+ * threads (e.g. the main loop advancing while pipeline stages read).
+ * Time only moves when advance() is called.
+ *
+ * Usage:
+ *   auto clock = std::make_shared<VirtualTimeProvider>();
+ *   config.time_provider = clock;   // Engine advances by fixed_timestep per frame
+ */
+class VirtualTimeProvider : public ITimeProvider {
+public:
+    explicit VirtualTimeProvider(
+        std::chrono::system_clock::time_point epoch = std::chrono::system_clock::time_point{}
+    ) : epoch_(epoch) {}
+    
+    [[nodiscard]] std::chrono::steady_clock::time_point now() const override {
+        return std::chrono::steady_clock::time_point{
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(elapsed())
+        };
+    }
+    
+    [[nodiscard]] std::chrono::system_clock::time_point system_now() const override {
+        return epoch_ + std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed());
+    }
+    
+    [[nodiscard]] std::chrono::nanoseconds elapsed() const override {
+        return std::chrono::nanoseconds(elapsed_ns_.load(std::memory_order_acquire));
+    }
+    
+    /**
+     * @brief Advance virtual time by a duration
+     */
+    template<typename Rep, typename Period>
+    void advance(std::chrono::duration<Rep, Period> duration) {
+        elapsed_ns_.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+            std::memory_order_acq_rel
+        );
+    }
+
+private:
+    std::atomic<int64_t> elapsed_ns_{0};
+    std::chrono::system_clock::time_point epoch_;
+};
+
 // ============================================================================
 // Random Provider Interface
 // ============================================================================
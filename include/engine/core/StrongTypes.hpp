@@ -227,7 +227,7 @@ private:
 /**
  * @brief Normalized value (0.0 to 1.0)
  */
-using Normalized = Bounded<float, 0, 1>;
+using Normalized = Bounded<float, 0.0f, 1.0f>;
 
 /**
  * @brief Health points (0 to 100)
@@ -237,7 +237,7 @@ using Health = Bounded<int, 0, 100>;
 /**
  * @brief Opacity (0.0 to 1.0)
  */
-using Opacity = Bounded<float, 0, 1>;
+using Opacity = Bounded<float, 0.0f, 1.0f>;
 
 /**
  * @brief Volume (0 to 100)
@@ -0,0 +1,86 @@
+/**
+ * @file frame_pacer.hpp
+ * @brief High-resolution frame limiter with hybrid sleep/spin waiting
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace OmniCpp::Engine::Core {
+
+  /**
+   * @brief Frame pacer configuration structure
+   */
+  struct FramePacerConfig {
+    uint32_t target_fps{ 60 };                                  // 0 = unlimited
+    std::chrono::nanoseconds spin_threshold{ std::chrono::milliseconds (1) };
+    uint32_t history_size{ 512 };                               // Frames kept for percentiles
+  };
+
+  /**
+   * @brief Frame-time distribution over the recent history window
+   */
+  struct FrameTimeStats {
+    double mean_ms{ 0.0 };
+    double p50_ms{ 0.0 };
+    double p90_ms{ 0.0 };
+    double p99_ms{ 0.0 };
+    double max_ms{ 0.0 };
+    uint64_t frame_count{ 0 };
+    uint64_t missed_deadlines{ 0 }; // Frames that overran by more than one period
+  };
+
+  /**
+   * @brief Paces the main loop against absolute deadlines
+   *
+   * Deadlines advance by exactly one period per frame, so oversleeping one
+   * frame shortens the next wait instead of accumulating drift. The wait
+   * sleeps on an absolute monotonic deadline (clock_nanosleep with
+   * TIMER_ABSTIME on POSIX) until spin_threshold before the deadline, then
+   * spins with a pause hint for the remainder. A frame that overruns by more
+   * than a full period re-anchors the schedule rather than bursting to catch up.
+   */
+  class FramePacer {
+  public:
+    FramePacer ();
+    ~FramePacer ();
+
+    FramePacer (const FramePacer&) = delete;
+    FramePacer& operator= (const FramePacer&) = delete;
+
+    FramePacer (FramePacer&&) noexcept;
+    FramePacer& operator= (FramePacer&&) noexcept;
+
+    /**
+     * @brief Apply configuration and anchor the schedule at the current time
+     */
+    void initialize (const FramePacerConfig& config);
+
+    /**
+     * @brief Re-anchor the schedule at the current time and clear history
+     */
+    void reset ();
+
+    /**
+     * @brief Block until the next frame deadline
+     * @return Seconds between the previous and this frame start
+     */
+    float wait_for_next_frame ();
+
+    /**
+     * @brief Change the target rate without resetting history
+     */
+    void set_target_fps (uint32_t target_fps);
+
+    [[nodiscard]] std::chrono::nanoseconds get_frame_period () const;
+    [[nodiscard]] FrameTimeStats get_stats () const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+} // namespace OmniCpp::Engine::Core
@@ -0,0 +1,108 @@
+/**
+ * @file frame_pipeline.hpp
+ * @brief Pipelined frame loop with overlapped stages
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace omnicpp::concurrency {
+  class ThreadPool;
+}
+
+namespace OmniCpp::Engine::Core {
+
+  /**
+   * @brief One stage of the frame pipeline
+   *
+   * `run` receives the frame number and the slot index (frame % depth) the
+   * stage should read from and write to. A slot is only ever touched by one
+   * stage at a time, so per-slot state (e.g. extracted draw lists) needs no
+   * locking.
+   */
+  struct PipelineStage {
+    std::string name;
+    std::function<void (uint64_t frame, uint32_t slot)> run;
+    bool main_thread_only{ false };
+  };
+
+  /**
+   * @brief Frame pipeline configuration structure
+   */
+  struct FramePipelineConfig {
+    uint32_t depth{ 1 }; // Frames in flight; 1 = serial (debugging)
+  };
+
+  /**
+   * @brief Per-stage timing of the most recent tick
+   */
+  struct PipelineStageTiming {
+    std::string name;
+    uint64_t frame{ 0 };
+    double duration_ms{ 0.0 };
+  };
+
+  /**
+   * @brief Runs consecutive frames' stages concurrently
+   *
+   * With S stages and depth D, stage s of frame N runs during tick
+   * N + min(s, D - 1). Stages sharing the same lag run back to back as one
+   * task; different lags run concurrently, so with three stages and D = 3
+   * one tick simulates frame N+1, extracts frame N and submits frame N-1.
+   * Each tick ends with a fence: tick() returns only once every stage
+   * started in it has finished, which is where slot ownership moves on to
+   * the next stage. Task groups containing a main_thread_only stage run on
+   * the thread calling tick(); the rest go to the thread pool.
+   */
+  class FramePipeline {
+  public:
+    FramePipeline ();
+    ~FramePipeline ();
+
+    FramePipeline (const FramePipeline&) = delete;
+    FramePipeline& operator= (const FramePipeline&) = delete;
+
+    FramePipeline (FramePipeline&&) noexcept;
+    FramePipeline& operator= (FramePipeline&&) noexcept;
+
+    /**
+     * @brief Initialize the pipeline
+     * @param stages Stages in data-flow order
+     * @param config Pipeline configuration (depth is clamped to [1, stages])
+     * @param pool Worker pool (nullptr = global pool)
+     * @return true if successful, false otherwise
+     */
+    bool initialize (std::vector<PipelineStage> stages, const FramePipelineConfig& config,
+        omnicpp::concurrency::ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Advance one frame boundary
+     */
+    void tick ();
+
+    /**
+     * @brief Finish every frame in flight without starting new ones
+     */
+    void flush ();
+
+    /**
+     * @brief Change the pipeline depth (flushes first)
+     */
+    void set_depth (uint32_t depth);
+
+    [[nodiscard]] uint32_t get_depth () const;
+    [[nodiscard]] uint64_t get_frames_started () const;
+    [[nodiscard]] uint64_t get_frames_completed () const;
+    [[nodiscard]] const std::vector<PipelineStageTiming>& get_last_tick_timings () const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+} // namespace OmniCpp::Engine::Core
@@ -0,0 +1,215 @@
+/**
+ * @file profiler.hpp
+ * @brief Hierarchical per-frame CPU profiler behind OMNICPP_PROFILE_SCOPE
+ *
+ * OMNICPP_PROFILE_SCOPE ("physics") times the enclosing block;
+ * OMNICPP_PROFILE_SCOPE_BEGIN (var, "record") / OMNICPP_PROFILE_SCOPE_END (var)
+ * time a stretch that ends before its block does;
+ * OMNICPP_PROFILE_FRAME () marks the end of a frame. With
+ * OMNICPP_PROFILE_ENABLED 0 (CMake: OMNICPP_ENABLE_PROFILER=OFF) both
+ * expand to nothing. Compiled in, a scope costs one relaxed load while
+ * the profiler is switched off, and two timestamp reads (RDTSC on x86-64,
+ * steady_clock elsewhere) plus a store into the calling thread's ring
+ * while it is on. Scope names must outlive the profiler (string literals).
+ *
+ * The frame mark drains every thread's ring, aggregates the frame per
+ * scope name, keeps the worst_frames slowest frames with all their
+ * samples, and optionally hands the frame to the trace exporter (as
+ * slices) and the worst frames to telemetry (as spans).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #else
+    #include <x86intrin.h>
+  #endif
+  #define OMNICPP_PROFILE_RDTSC 1
+#endif
+
+#ifndef OMNICPP_PROFILE_ENABLED
+  #define OMNICPP_PROFILE_ENABLED 0
+#endif
+
+namespace omnicpp::telemetry {
+  class ChromeTraceExporter;
+}
+
+namespace OmniCpp::Engine::Core {
+
+  struct ProfilerConfig {
+    std::size_t ring_capacity{ 16384 }; // Scopes per thread between frame marks, rounded up to a power of two
+    std::size_t worst_frames{ 8 };      // Slowest frames kept with all their samples
+    bool spans_for_worst_frames{ true }; // Submit each new worst frame to telemetry as a span tree
+  };
+
+  /**
+   * @brief One timed scope, relative to the start of its frame
+   */
+  struct ScopeSample {
+    const char* name{ nullptr };
+    uint32_t thread{ 0 }; // SpanRecorder thread number, shared with spans and trace tracks
+    uint32_t depth{ 0 };  // 0 for a scope with no enclosing scope on its thread
+    int64_t start_ns{ 0 };
+    int64_t duration_ns{ 0 };
+  };
+
+  /**
+   * @brief All calls of one scope name in a frame
+   */
+  struct ScopeStats {
+    const char* name{ nullptr };
+    uint32_t depth{ 0 }; // Of the first call
+    uint32_t calls{ 0 };
+    double total_ms{ 0.0 };
+    double max_ms{ 0.0 };
+  };
+
+  struct FrameProfile {
+    uint64_t frame{ 0 };
+    double duration_ms{ 0.0 };
+    std::vector<ScopeStats> scopes;   // In order of first start
+    std::vector<ScopeSample> samples; // Every scope, by thread then start
+  };
+
+  /**
+   * @brief Process-wide frame profiler
+   */
+  class Profiler {
+  public:
+    static Profiler& instance ();
+
+    void configure (const ProfilerConfig& config);
+
+    /**
+     * @brief Switch recording on or off at run time (off by default)
+     */
+    void set_enabled (bool enabled);
+    [[nodiscard]] bool is_enabled () const noexcept { return m_enabled.load (std::memory_order_relaxed); }
+
+    /**
+     * @brief Close the current frame and start the next (OMNICPP_PROFILE_FRAME)
+     */
+    void end_frame ();
+
+    [[nodiscard]] FrameProfile last_frame () const;
+
+    /**
+     * @brief The slowest frames seen since the last reset, slowest first
+     */
+    [[nodiscard]] std::vector<FrameProfile> worst_frames () const;
+
+    /**
+     * @brief Scopes lost to full rings
+     */
+    [[nodiscard]] uint64_t dropped () const;
+
+    void reset ();
+
+    /**
+     * @brief Also write every frame's scopes as slices and its time as a counter
+     */
+    void set_trace_exporter (std::shared_ptr<omnicpp::telemetry::ChromeTraceExporter> exporter);
+
+    Profiler (const Profiler&) = delete;
+    Profiler& operator= (const Profiler&) = delete;
+
+    /**
+     * @brief Raw timestamp (TSC ticks or steady_clock nanoseconds)
+     */
+    static uint64_t now () noexcept {
+#if defined(OMNICPP_PROFILE_RDTSC)
+      return __rdtsc ();
+#else
+      return static_cast<uint64_t> (std::chrono::steady_clock::now ().time_since_epoch ().count ());
+#endif
+    }
+
+    struct ThreadBuffer;
+
+    /**
+     * @brief The calling thread's ring, or nullptr while disabled
+     */
+    [[nodiscard]] ThreadBuffer* buffer () noexcept {
+      return m_enabled.load (std::memory_order_relaxed) ? thread_buffer () : nullptr;
+    }
+
+    static void push (ThreadBuffer& buffer, const char* name, uint64_t start, uint64_t end, uint32_t depth) noexcept;
+    static uint32_t enter (ThreadBuffer& buffer) noexcept;
+
+  private:
+    Profiler ();
+    ~Profiler ();
+
+    ThreadBuffer* thread_buffer ();
+
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+    std::atomic<bool> m_enabled{ false };
+  };
+
+  /**
+   * @brief RAII timer behind OMNICPP_PROFILE_SCOPE
+   */
+  class ProfileScope {
+  public:
+    explicit ProfileScope (const char* name) noexcept : m_buffer (Profiler::instance ().buffer ()), m_name (name) {
+      if (m_buffer != nullptr) {
+        m_depth = Profiler::enter (*m_buffer);
+        m_start = Profiler::now ();
+      }
+    }
+
+    ~ProfileScope () {
+      end ();
+    }
+
+    /**
+     * @brief Close the scope before it goes out of scope (later calls do nothing)
+     */
+    void end () noexcept {
+      if (m_buffer != nullptr) {
+        Profiler::push (*m_buffer, m_name, m_start, Profiler::now (), m_depth);
+        m_buffer = nullptr;
+      }
+    }
+
+    ProfileScope (const ProfileScope&) = delete;
+    ProfileScope& operator= (const ProfileScope&) = delete;
+
+  private:
+    Profiler::ThreadBuffer* m_buffer;
+    const char* m_name;
+    uint64_t m_start{ 0 };
+    uint32_t m_depth{ 0 };
+  };
+
+} // namespace OmniCpp::Engine::Core
+
+#define OMNICPP_PROFILE_CONCAT_INNER(a, b) a##b
+#define OMNICPP_PROFILE_CONCAT(a, b) OMNICPP_PROFILE_CONCAT_INNER (a, b)
+
+#if OMNICPP_PROFILE_ENABLED
+  #define OMNICPP_PROFILE_SCOPE(name) \
+    ::OmniCpp::Engine::Core::ProfileScope OMNICPP_PROFILE_CONCAT (omnicpp_profile_scope_, __LINE__) { name }
+  #define OMNICPP_PROFILE_SCOPE_BEGIN(var, name) ::OmniCpp::Engine::Core::ProfileScope var { name }
+  #define OMNICPP_PROFILE_SCOPE_END(var) var.end ()
+  #define OMNICPP_PROFILE_FUNCTION() OMNICPP_PROFILE_SCOPE (__func__)
+  #define OMNICPP_PROFILE_FRAME() ::OmniCpp::Engine::Core::Profiler::instance ().end_frame ()
+#else
+  #define OMNICPP_PROFILE_SCOPE(name) static_cast<void> (0)
+  #define OMNICPP_PROFILE_SCOPE_BEGIN(var, name) static_cast<void> (0)
+  #define OMNICPP_PROFILE_SCOPE_END(var) static_cast<void> (0)
+  #define OMNICPP_PROFILE_FUNCTION() static_cast<void> (0)
+  #define OMNICPP_PROFILE_FRAME() static_cast<void> (0)
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file subsystem_graph.hpp
+ * @brief Dependency-ordered subsystem startup and shutdown
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace omnicpp::concurrency {
+  class ThreadPool;
+}
+
+namespace OmniCpp::Engine::Core {
+
+  /**
+   * @brief Description of one engine subsystem
+   */
+  struct SubsystemDesc {
+    std::string name;
+    std::vector<std::string> dependencies;  // Names that must be initialized first
+    std::function<bool ()> initialize;
+    std::function<void ()> shutdown;
+    bool main_thread_only{ false };         // Window system / Qt objects, graphics surfaces
+  };
+
+  /**
+   * @brief Timing of one subsystem during startup
+   */
+  struct SubsystemTiming {
+    std::string name;
+    double start_ms{ 0.0 };     // Relative to the start of initialize()
+    double duration_ms{ 0.0 };
+    bool main_thread{ false };
+  };
+
+  /**
+   * @brief Startup timing summary
+   */
+  struct StartupReport {
+    double wall_ms{ 0.0 };              // Elapsed time of initialize()
+    double serial_ms{ 0.0 };            // Sum of all subsystem init times
+    double critical_path_ms{ 0.0 };     // Sum of init times along the critical path
+    std::vector<std::string> critical_path;
+    std::vector<SubsystemTiming> timings;
+  };
+
+  /**
+   * @brief Initializes subsystems as a dependency DAG
+   *
+   * Subsystems whose dependencies are satisfied are posted to the thread
+   * pool; those flagged main_thread_only run on the thread that called
+   * initialize(). If any initializer fails, nothing new is started, work in
+   * flight is allowed to finish, and everything already up is shut down
+   * again. shutdown() runs serially in the reverse of the order in which
+   * subsystems finished initializing, which is always a valid reverse
+   * topological order.
+   */
+  class SubsystemGraph {
+  public:
+    SubsystemGraph ();
+    ~SubsystemGraph ();
+
+    SubsystemGraph (const SubsystemGraph&) = delete;
+    SubsystemGraph& operator= (const SubsystemGraph&) = delete;
+
+    SubsystemGraph (SubsystemGraph&&) noexcept;
+    SubsystemGraph& operator= (SubsystemGraph&&) noexcept;
+
+    /**
+     * @brief Register a subsystem
+     * @return false if a subsystem with the same name already exists
+     */
+    bool add (SubsystemDesc desc);
+
+    /**
+     * @brief Initialize every registered subsystem
+     * @param pool Worker pool (nullptr = serial, in topological order, for debugging)
+     * @return true if all subsystems initialized successfully
+     */
+    bool initialize (omnicpp::concurrency::ThreadPool* pool);
+
+    /**
+     * @brief Shut down initialized subsystems in reverse topological order
+     */
+    void shutdown ();
+
+    [[nodiscard]] std::size_t size () const;
+    [[nodiscard]] std::vector<std::string> get_initialization_order () const;
+    [[nodiscard]] const StartupReport& get_startup_report () const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+} // namespace OmniCpp::Engine::Core
@@ -0,0 +1,168 @@
+/**
+ * @file frame_capture.hpp
+ * @brief Asynchronous frame readback ring for captures and thumbnails
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace omnicpp::concurrency {
+  class ThreadPool;
+}
+
+namespace OmniCpp::Engine::Graphics {
+
+  /**
+   * @brief Output encoding for captured frames
+   */
+  enum class CaptureEncoding : uint8_t { Raw = 0, Qoi, Png };
+
+  /**
+   * @brief Pixel layout of the readback source
+   */
+  enum class CapturePixelFormat : uint8_t { RGBA8 = 0, BGRA8 };
+
+  /**
+   * @brief Frame capture configuration structure
+   */
+  struct FrameCaptureConfig {
+    uint32_t ring_size{ 3 };                        // Readback slots in flight
+    CaptureEncoding encoding{ CaptureEncoding::Qoi };
+    std::string output_directory;                   // Empty = deliver via callback only
+    std::string file_prefix{ "frame" };
+  };
+
+  /**
+   * @brief A captured frame, always delivered as tightly packed RGBA8
+   *
+   * `data` holds raw RGBA pixels for CaptureEncoding::Raw and the encoded
+   * file contents otherwise.
+   */
+  struct CapturedFrame {
+    uint64_t frame_index{ 0 };
+    uint32_t width{ 0 };
+    uint32_t height{ 0 };
+    CaptureEncoding encoding{ CaptureEncoding::Raw };
+    std::vector<uint8_t> data;
+  };
+
+  /**
+   * @brief Capture counters, readable from any thread
+   */
+  struct FrameCaptureStats {
+    uint64_t requested{ 0 };
+    uint64_t captured{ 0 };
+    uint64_t deferred{ 0 };                 // Frames an armed request waited because every slot was busy
+    uint64_t dropped{ 0 };                  // Armed requests given up (still pending at shutdown)
+    uint64_t encode_time_ns{ 0 };           // Total time spent on pool threads
+    uint64_t max_render_thread_ns{ 0 };     // Worst render-thread cost of one capture hook
+  };
+
+  using FrameCaptureCallback = std::function<void (CapturedFrame&&)>;
+
+  /**
+   * @brief Readback ring that keeps captures off the render thread
+   *
+   * The renderer claims a slot with begin_capture() while recording a frame,
+   * copies the image into that slot's host-visible buffer and calls
+   * complete_capture() once the GPU work is known to be finished (i.e. N
+   * frames later, after the in-flight fence has been waited on). Conversion
+   * and encoding then run on a ThreadPool worker, and the slot is released
+   * when the worker is done. Nothing on the render thread ever blocks: when
+   * every slot is still busy the request stays armed for the next frame and
+   * the wait is counted as deferred.
+   *
+   * Headless backends without GPU memory use host_slot() for storage.
+   */
+  class FrameCaptureRing {
+  public:
+    FrameCaptureRing ();
+    ~FrameCaptureRing ();
+
+    FrameCaptureRing (const FrameCaptureRing&) = delete;
+    FrameCaptureRing& operator= (const FrameCaptureRing&) = delete;
+
+    FrameCaptureRing (FrameCaptureRing&&) noexcept;
+    FrameCaptureRing& operator= (FrameCaptureRing&&) noexcept;
+
+    /**
+     * @brief Initialize the ring
+     * @param config Capture configuration
+     * @param pool Pool used for encoding (nullptr = global pool)
+     * @return true if successful, false otherwise
+     */
+    bool initialize (const FrameCaptureConfig& config, omnicpp::concurrency::ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Wait for outstanding encodes and release the ring
+     */
+    void shutdown ();
+
+    /**
+     * @brief Arm capture of the next frames
+     * @param frame_count Number of consecutive frames to capture
+     */
+    void request_capture (uint32_t frame_count = 1);
+
+    /**
+     * @brief Set the consumer callback (invoked on a pool thread)
+     */
+    void set_callback (FrameCaptureCallback callback);
+
+    /**
+     * @brief Claim a slot for the frame being recorded (render thread)
+     * @return Slot index, or nullopt if no capture is armed or all slots are busy
+     */
+    [[nodiscard]] std::optional<uint32_t> begin_capture (uint64_t frame_index);
+
+    /**
+     * @brief Hand a filled slot over to the pool for conversion and encoding
+     * @param slot Slot returned by begin_capture()
+     * @param pixels Slot pixels; must stay valid until the slot is released
+     * @param row_pitch Bytes per source row
+     */
+    void complete_capture (uint32_t slot, const uint8_t* pixels, uint32_t width, uint32_t height,
+        std::size_t row_pitch, CapturePixelFormat format);
+
+    /**
+     * @brief Return a claimed slot without capturing (e.g. frame was skipped)
+     */
+    void cancel_capture (uint32_t slot);
+
+    /**
+     * @brief Host memory for a slot, for backends without mapped GPU buffers
+     */
+    [[nodiscard]] uint8_t* host_slot (uint32_t slot, std::size_t bytes);
+
+    /**
+     * @brief Record the render-thread cost of one capture hook
+     */
+    void note_render_thread_cost (uint64_t nanoseconds);
+
+    /**
+     * @brief Block until every slot has been released
+     */
+    void wait_idle ();
+
+    [[nodiscard]] bool is_capture_armed () const;
+    [[nodiscard]] uint32_t get_ring_size () const;
+    [[nodiscard]] FrameCaptureStats get_stats () const;
+
+    /**
+     * @brief Encode tightly packed RGBA8 pixels as a QOI image
+     */
+    [[nodiscard]] static std::vector<uint8_t> encode_qoi (const uint8_t* rgba, uint32_t width, uint32_t height);
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+} // namespace OmniCpp::Engine::Graphics
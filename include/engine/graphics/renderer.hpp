@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "engine/graphics/frame_capture.hpp"
 #include <cstdint>
 #include <memory>
 
@@ -23,6 +24,8 @@ namespace OmniCpp::Engine::Graphics {
     bool vsync{ true };
     uint32_t msaa_samples{ 4 };
     bool enable_debug{ false };
+    bool enable_frame_capture{ false };
+    FrameCaptureConfig capture;
   };
 
   /**
@@ -52,6 +55,13 @@ namespace OmniCpp::Engine::Graphics {
     void set_paddle_position(bool is_left, float y);
     [[nodiscard]] uint32_t get_frame_count () const;
 
+    /**
+     * @brief Arm asynchronous capture of the next presented frames
+     * @param frame_count Number of consecutive frames to capture
+     */
+    void request_frame_capture (uint32_t frame_count = 1);
+    [[nodiscard]] FrameCaptureRing& get_frame_capture ();
+
   private:
     struct Impl;
     std::unique_ptr<Impl> m_impl;
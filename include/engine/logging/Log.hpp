@@ -8,6 +8,31 @@
  *   omnicpp::log::init();  // Call once at startup
  *   omnicpp::log::info("Message with {}", arg);
  *   omnicpp::log::shutdown();  // Call at shutdown
+ *
+ * The helpers below do not format on the calling thread. After the level
+ * check, built-in argument types (numbers, strings, string views) are
+ * copied into Quill's queue and formatted by the backend thread; a call
+ * below the runtime level costs one relaxed load. Calls below
+ * OMNICPP_LOG_ACTIVE_LEVEL (CMake: OMNICPP_LOG_COMPILE_LEVEL) compile to
+ * nothing, for the helpers and the LOG_* macros alike.
+ *
+ * Hot paths log through the subsystem macros instead:
+ *   LOG_TRACE_IN(omnicpp::log::Subsystem::Memory, "Allocated {} bytes", size);
+ * Below OMNICPP_LOG_ACTIVE_LEVEL these are removed together with their
+ * arguments; otherwise the subsystem's runtime level is checked (one
+ * relaxed load) before the arguments are evaluated.
+ *
+ * Per-frame and per-event paths rate-limit instead, with state per call site:
+ *   LOG_WARN_EVERY_N(100, "...", args);        // 1st, 101st, 201st, ...
+ *   LOG_DEBUG_EVERY_MS(1000, "...", args);     // at most once a second
+ *   LOG_ERROR_RATE_LIMITED(5, 20, "...", args); // 5/s sustained, bursts of 20
+ * A message let through after others were dropped is preceded by a count
+ * of the dropped ones; report_suppressed() (also run by shutdown()) flushes
+ * counts still pending.
+ *
+ * The helpers and macros above also copy each record into the flight
+ * recorder (flight_recorder.hpp), which survives a crash that loses
+ * whatever Quill had not written yet.
  */
 
 #pragma once
@@ -19,12 +44,45 @@
 #include <quill/core/LogLevel.h>
 #include <quill/sinks/ConsoleSink.h>
 
+#include "engine/logging/flight_recorder.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <format>
 #include <string>
+#include <string_view>
 #include <mutex>
 #include <source_location>
+#include <type_traits>
+#include <utility>
+
+// Same scale as QUILL_COMPILE_ACTIVE_LOG_LEVEL_*; defaults to Quill's threshold
+#ifndef OMNICPP_LOG_ACTIVE_LEVEL
+#define OMNICPP_LOG_ACTIVE_LEVEL QUILL_COMPILE_ACTIVE_LOG_LEVEL
+#endif
 
 namespace omnicpp::log {
 
+/**
+ * @brief Engine areas with their own runtime log level
+ */
+enum class Subsystem : uint8_t {
+    Core,
+    Memory,
+    Events,
+    Render,
+    Audio,
+    Network,
+    Physics,
+    Scripting,
+    Resources,
+    Input,
+    Utils,
+    Count
+};
+
 // ============================================================================
 // Initialization and shutdown
 // ============================================================================
@@ -44,6 +102,27 @@ namespace detail {
         static quill::Logger* logger = nullptr;
         return logger;
     }
+
+    using SubsystemLevels = std::array<std::atomic<quill::LogLevel>, static_cast<std::size_t>(Subsystem::Count)>;
+
+    template<std::size_t... Is>
+    constexpr SubsystemLevels initial_subsystem_levels(std::index_sequence<Is...>) {
+        return { { ((void) Is, std::atomic<quill::LogLevel>{ quill::LogLevel::Info })... } };
+    }
+
+    // constinit: checking a level is the relaxed load alone, no static-init guard
+    inline constinit SubsystemLevels g_subsystem_levels =
+        initial_subsystem_levels(std::make_index_sequence<static_cast<std::size_t>(Subsystem::Count)>{});
+
+    inline SubsystemLevels& subsystem_levels() {
+        return g_subsystem_levels;
+    }
+
+    inline void set_subsystem_levels(quill::LogLevel level) {
+        for (auto& subsystem : subsystem_levels()) {
+            subsystem.store(level, std::memory_order_relaxed);
+        }
+    }
 }
 
 /**
@@ -74,13 +153,22 @@ inline void init(quill::LogLevel min_level = quill::LogLevel::Info) {
     );
     
     detail::global_logger()->set_log_level(min_level);
+    detail::set_subsystem_levels(min_level);
     detail::is_initialized() = true;
+
+    // Always on; call flight::open() before init() to choose the file
+    if (!flight::is_open()) {
+        flight::open();
+    }
 }
 
+void report_suppressed();
+
 /**
  * @brief Shutdown the logging system
  */
 inline void shutdown() {
+    report_suppressed();
     std::lock_guard<std::mutex> lock(detail::init_mutex());
     
     if (!detail::is_initialized()) {
@@ -103,12 +191,31 @@ inline quill::Logger* logger() {
 }
 
 /**
- * @brief Set the minimum log level
+ * @brief Set the minimum log level, for the logger and every subsystem
  */
 inline void set_level(quill::LogLevel level) {
     if (auto* log = logger()) {
         log->set_log_level(level);
     }
+    detail::set_subsystem_levels(level);
+}
+
+/**
+ * @brief Set one subsystem's minimum level (for the LOG_*_IN macros)
+ */
+inline void set_level(Subsystem subsystem, quill::LogLevel level) {
+    detail::subsystem_levels()[static_cast<std::size_t>(subsystem)].store(level, std::memory_order_relaxed);
+}
+
+[[nodiscard]] inline quill::LogLevel get_level(Subsystem subsystem) {
+    return detail::subsystem_levels()[static_cast<std::size_t>(subsystem)].load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Whether a subsystem logs at a level: the whole runtime check of the LOG_*_IN macros
+ */
+[[nodiscard]] inline bool enabled(Subsystem subsystem, quill::LogLevel level) {
+    return level >= detail::subsystem_levels()[static_cast<std::size_t>(subsystem)].load(std::memory_order_relaxed);
 }
 
 // ============================================================================
@@ -126,46 +233,341 @@ inline void set_level(quill::LogLevel level) {
 // Convenience functions (for when macros aren't suitable)
 // ============================================================================
 
+/**
+ * @brief A checked format string plus the call site it was written at
+ */
 template<typename... Args>
-void trace(std::format_string<Args...> fmt, Args&&... args) {
-    if (auto* log = logger()) {
-        QUILL_LOG_TRACE_L3(log, "{}", std::format(fmt, std::forward<Args>(args)...));
+struct Format {
+    std::format_string<Args...> fmt;
+    const char* text; // The literal itself, as Quill and the flight recorder take it
+    std::source_location location;
+
+    template<typename S>
+    consteval Format(const S& literal, std::source_location where = std::source_location::current())
+        : fmt(literal), text(std::string_view(literal).data()), location(where) {}
+};
+
+namespace detail {
+    /**
+     * @brief Types Quill encodes as raw bytes for the backend to format
+     */
+    template<typename T>
+    inline constexpr bool is_encodable = [] {
+        using U = std::remove_cvref_t<T>;
+        using D = std::decay_t<U>;
+        return std::is_arithmetic_v<U> || std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view> ||
+               std::is_same_v<D, const char*> || std::is_same_v<D, char*>;
+    }();
+
+    inline constexpr char kPreformatted[] = "{}";
+
+    /**
+     * @brief Hand one record to Quill, tagged with the caller's location
+     *
+     * Quill's own macros keep the location in a static per expansion, which
+     * these helpers, shared by every call site, cannot; the runtime-metadata
+     * macro carries it in the record instead. The arguments are still encoded
+     * and formatted by the backend thread.
+     */
+    template<typename... Args>
+    void log_at(quill::Logger* log, quill::LogLevel level, const char* fmt, const std::source_location& location,
+                Args&&... args) {
+        QUILL_LOG_RUNTIME_METADATA(log, level, location.file_name(), location.line(), location.function_name(), fmt,
+                                   std::forward<Args>(args)...);
+    }
+
+    template<quill::LogLevel Level, typename... Args>
+    void emit(quill::Logger* log, const Format<std::type_identity_t<Args>...>& format, Args&&... args) {
+        const bool record = flight::detail::g_open.load(std::memory_order_relaxed);
+        if constexpr ((is_encodable<Args> && ...)) {
+            if (record) {
+                flight::detail::record(static_cast<uint8_t>(Level), format.text, format.location, args...);
+            }
+            log_at(log, Level, format.text, format.location, std::forward<Args>(args)...);
+        } else {
+            // A type Quill cannot encode: format on this thread, as before, but only once enabled
+            std::string text = std::format(format.fmt, std::forward<Args>(args)...);
+            if (record) {
+                flight::detail::record(static_cast<uint8_t>(Level), kPreformatted, format.location, text);
+            }
+            log_at(log, Level, kPreformatted, format.location, std::move(text));
+        }
+    }
+
+    template<quill::LogLevel Level, typename... Args>
+    void write(const Format<std::type_identity_t<Args>...>& format, Args&&... args) {
+        if constexpr (static_cast<int>(Level) >= OMNICPP_LOG_ACTIVE_LEVEL) {
+            quill::Logger* log = logger();
+            if (log && log->template should_log_statement<Level>()) {
+                emit<Level, Args...>(log, format, std::forward<Args>(args)...);
+            }
+        }
+    }
+
+    /**
+     * @brief Write once a subsystem level has passed; the logger's own level does not apply
+     */
+    template<quill::LogLevel Level, typename... Args>
+    void write_enabled(Format<std::type_identity_t<Args>...> format, Args&&... args) {
+        if (quill::Logger* log = logger()) {
+            emit<Level, Args...>(log, format, std::forward<Args>(args)...);
+        }
+    }
+} // namespace detail
+
+// ============================================================================
+// Rate limiting (used by the LOG_*_EVERY_N / _EVERY_MS / _RATE_LIMITED macros)
+// ============================================================================
+
+namespace detail {
+    inline constexpr char kSuppressed[] = "Suppressed {} similar messages";
+
+    inline int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * @brief Per-call-site limiter state
+     *
+     * Limiters link themselves into a global list for report_suppressed(), so
+     * they must be static (the macros declare them so) and are never unlinked.
+     */
+    struct RateLimiter {
+        std::source_location location;
+        quill::LogLevel level;
+        std::atomic<uint64_t> suppressed{ 0 };
+        RateLimiter* next{ nullptr };
+
+        static std::atomic<RateLimiter*>& head() {
+            static std::atomic<RateLimiter*> first{ nullptr };
+            return first;
+        }
+
+        RateLimiter(std::source_location where, quill::LogLevel lvl) : location(where), level(lvl) {
+            next = head().load(std::memory_order_relaxed);
+            while (!head().compare_exchange_weak(next, this, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+
+        /**
+         * @brief Record the outcome; on admission, first report what was dropped since the last one
+         */
+        bool pass(bool admitted) {
+            if (!admitted) {
+                suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            report();
+            return true;
+        }
+
+        void report() {
+            if (suppressed.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+            const uint64_t count = suppressed.exchange(0, std::memory_order_relaxed);
+            quill::Logger* log = global_logger();
+            if (count > 0 && log) {
+                log_at(log, level, kSuppressed, location, count);
+            }
+        }
+    };
+
+    /**
+     * @brief Admits the 1st, (n+1)th, (2n+1)th... call
+     */
+    struct EveryN : RateLimiter {
+        uint64_t n;
+        std::atomic<uint64_t> calls{ 0 };
+
+        EveryN(std::source_location where, quill::LogLevel lvl, uint64_t every) : RateLimiter(where, lvl), n(every) {}
+
+        bool admit() {
+            return pass(n <= 1 || calls.fetch_add(1, std::memory_order_relaxed) % n == 0);
+        }
+    };
+
+    /**
+     * @brief Admits at most one call per period
+     */
+    struct EveryMs : RateLimiter {
+        int64_t period_ns;
+        std::atomic<int64_t> next_ns{ 0 };
+
+        EveryMs(std::source_location where, quill::LogLevel lvl, int64_t period_ms)
+            : RateLimiter(where, lvl), period_ns(period_ms * 1000000) {}
+
+        bool admit() {
+            const int64_t now = now_ns();
+            int64_t due = next_ns.load(std::memory_order_relaxed);
+            return pass(now >= due && next_ns.compare_exchange_strong(due, now + period_ns, std::memory_order_relaxed));
+        }
+    };
+
+    /**
+     * @brief Token bucket, kept as one timestamp (GCRA): `rate` per second sustained, up to `burst` at once
+     *
+     * The "theoretical arrival time" advances by 1/rate per admitted call;
+     * a call is admitted while it is at most burst-1 intervals ahead of now.
+     */
+    struct TokenBucket : RateLimiter {
+        int64_t interval_ns;
+        int64_t tolerance_ns;
+        std::atomic<int64_t> tat_ns{ 0 };
+
+        TokenBucket(std::source_location where, quill::LogLevel lvl, double rate, uint32_t burst)
+            : RateLimiter(where, lvl),
+              interval_ns(static_cast<int64_t>(1e9 / (rate > 0.0 ? rate : 1e-9))),
+              tolerance_ns(interval_ns * static_cast<int64_t>(burst > 0 ? burst - 1 : 0)) {}
+
+        bool admit() {
+            const int64_t now = now_ns();
+            int64_t tat = tat_ns.load(std::memory_order_relaxed);
+            for (;;) {
+                const int64_t start = tat > now ? tat : now;
+                if (start - now > tolerance_ns) {
+                    return pass(false);
+                }
+                if (tat_ns.compare_exchange_weak(tat, start + interval_ns, std::memory_order_relaxed)) {
+                    return pass(true);
+                }
+            }
+        }
+    };
+} // namespace detail
+
+/**
+ * @brief Log the dropped-message counts still pending at every rate-limited call site
+ *
+ * Counts are otherwise reported when the site next lets a message through,
+ * so call this periodically (or let shutdown() do it) to see the tail of a storm.
+ */
+inline void report_suppressed() {
+    for (detail::RateLimiter* limiter = detail::RateLimiter::head().load(std::memory_order_acquire); limiter;
+         limiter = limiter->next) {
+        limiter->report();
     }
 }
 
 template<typename... Args>
-void debug(std::format_string<Args...> fmt, Args&&... args) {
-    if (auto* log = logger()) {
-        QUILL_LOG_DEBUG(log, "{}", std::format(fmt, std::forward<Args>(args)...));
-    }
+void trace(Format<std::type_identity_t<Args>...> fmt, Args&&... args) {
+    detail::write<quill::LogLevel::TraceL3, Args...>(fmt, std::forward<Args>(args)...);
 }
 
 template<typename... Args>
-void info(std::format_string<Args...> fmt, Args&&... args) {
-    if (auto* log = logger()) {
-        QUILL_LOG_INFO(log, "{}", std::format(fmt, std::forward<Args>(args)...));
-    }
+void debug(Format<std::type_identity_t<Args>...> fmt, Args&&... args) {
+    detail::write<quill::LogLevel::Debug, Args...>(fmt, std::forward<Args>(args)...);
 }
 
 template<typename... Args>
-void warn(std::format_string<Args...> fmt, Args&&... args) {
-    if (auto* log = logger()) {
-        QUILL_LOG_WARNING(log, "{}", std::format(fmt, std::forward<Args>(args)...));
-    }
+void info(Format<std::type_identity_t<Args>...> fmt, Args&&... args) {
+    detail::write<quill::LogLevel::Info, Args...>(fmt, std::forward<Args>(args)...);
 }
 
 template<typename... Args>
-void error(std::format_string<Args...> fmt, Args&&... args) {
-    if (auto* log = logger()) {
-        QUILL_LOG_ERROR(log, "{}", std::format(fmt, std::forward<Args>(args)...));
-    }
+void warn(Format<std::type_identity_t<Args>...> fmt, Args&&... args) {
+    detail::write<quill::LogLevel::Warning, Args...>(fmt, std::forward<Args>(args)...);
 }
 
 template<typename... Args>
-void critical(std::format_string<Args...> fmt, Args&&... args) {
-    if (auto* log = logger()) {
-        QUILL_LOG_CRITICAL(log, "{}", std::format(fmt, std::forward<Args>(args)...));
-    }
+void error(Format<std::type_identity_t<Args>...> fmt, Args&&... args) {
+    detail::write<quill::LogLevel::Error, Args...>(fmt, std::forward<Args>(args)...);
+}
+
+template<typename... Args>
+void critical(Format<std::type_identity_t<Args>...> fmt, Args&&... args) {
+    detail::write<quill::LogLevel::Critical, Args...>(fmt, std::forward<Args>(args)...);
 }
 
 } // namespace omnicpp::log
+
+// ============================================================================
+// Subsystem logging macros - arguments are only evaluated when enabled
+// ============================================================================
+
+#define OMNICPP_LOG_IN_(level, subsystem, ...)                                                    \
+    do {                                                                                          \
+        if (::omnicpp::log::enabled(subsystem, level)) {                                          \
+            ::omnicpp::log::detail::write_enabled<level>(__VA_ARGS__);                            \
+        }                                                                                         \
+    } while (0)
+
+// Still type-checked, so variables used only for logging do not warn, but never evaluated
+#define OMNICPP_LOG_STRIPPED_(level, subsystem, ...)                                              \
+    do {                                                                                          \
+        if constexpr (false) {                                                                    \
+            ::omnicpp::log::detail::write_enabled<level>(__VA_ARGS__);                            \
+        }                                                                                         \
+    } while (0)
+
+// Level check first, then the call site's limiter, then argument evaluation
+#define OMNICPP_LOG_LIMITED_(level, limiter_type, limiter_args, ...)                                \
+    do {                                                                                          \
+        if constexpr (static_cast<int>(level) >= OMNICPP_LOG_ACTIVE_LEVEL) {                      \
+            ::quill::Logger* omnicpp_log_ = ::omnicpp::log::logger();                             \
+            if (omnicpp_log_ && omnicpp_log_->template should_log_statement<level>()) {           \
+                static ::omnicpp::log::detail::limiter_type omnicpp_limiter_{                     \
+                    std::source_location::current(), level, OMNICPP_LOG_UNPAREN_ limiter_args };  \
+                if (omnicpp_limiter_.admit()) {                                                   \
+                    ::omnicpp::log::detail::write_enabled<level>(__VA_ARGS__);                    \
+                }                                                                                 \
+            }                                                                                     \
+        }                                                                                         \
+    } while (0)
+
+#define OMNICPP_LOG_UNPAREN_(...) __VA_ARGS__
+
+#define LOG_TRACE_EVERY_N(n, ...) OMNICPP_LOG_LIMITED_(::quill::LogLevel::TraceL3, EveryN, (n), __VA_ARGS__)
+#define LOG_DEBUG_EVERY_N(n, ...) OMNICPP_LOG_LIMITED_(::quill::LogLevel::Debug, EveryN, (n), __VA_ARGS__)
+#define LOG_INFO_EVERY_N(n, ...) OMNICPP_LOG_LIMITED_(::quill::LogLevel::Info, EveryN, (n), __VA_ARGS__)
+#define LOG_WARN_EVERY_N(n, ...) OMNICPP_LOG_LIMITED_(::quill::LogLevel::Warning, EveryN, (n), __VA_ARGS__)
+#define LOG_ERROR_EVERY_N(n, ...) OMNICPP_LOG_LIMITED_(::quill::LogLevel::Error, EveryN, (n), __VA_ARGS__)
+
+#define LOG_TRACE_EVERY_MS(ms, ...) OMNICPP_LOG_LIMITED_(::quill::LogLevel::TraceL3, EveryMs, (ms), __VA_ARGS__)
+#define LOG_DEBUG_EVERY_MS(ms, ...) OMNICPP_LOG_LIMITED_(::quill::LogLevel::Debug, EveryMs, (ms), __VA_ARGS__)
+#define LOG_INFO_EVERY_MS(ms, ...) OMNICPP_LOG_LIMITED_(::quill::LogLevel::Info, EveryMs, (ms), __VA_ARGS__)
+#define LOG_WARN_EVERY_MS(ms, ...) OMNICPP_LOG_LIMITED_(::quill::LogLevel::Warning, EveryMs, (ms), __VA_ARGS__)
+#define LOG_ERROR_EVERY_MS(ms, ...) OMNICPP_LOG_LIMITED_(::quill::LogLevel::Error, EveryMs, (ms), __VA_ARGS__)
+
+#define LOG_TRACE_RATE_LIMITED(per_second, burst, ...)                                             \
+    OMNICPP_LOG_LIMITED_(::quill::LogLevel::TraceL3, TokenBucket, (per_second, burst), __VA_ARGS__)
+#define LOG_DEBUG_RATE_LIMITED(per_second, burst, ...)                                             \
+    OMNICPP_LOG_LIMITED_(::quill::LogLevel::Debug, TokenBucket, (per_second, burst), __VA_ARGS__)
+#define LOG_INFO_RATE_LIMITED(per_second, burst, ...)                                              \
+    OMNICPP_LOG_LIMITED_(::quill::LogLevel::Info, TokenBucket, (per_second, burst), __VA_ARGS__)
+#define LOG_WARN_RATE_LIMITED(per_second, burst, ...)                                              \
+    OMNICPP_LOG_LIMITED_(::quill::LogLevel::Warning, TokenBucket, (per_second, burst), __VA_ARGS__)
+#define LOG_ERROR_RATE_LIMITED(per_second, burst, ...)                                             \
+    OMNICPP_LOG_LIMITED_(::quill::LogLevel::Error, TokenBucket, (per_second, burst), __VA_ARGS__)
+
+#if OMNICPP_LOG_ACTIVE_LEVEL <= QUILL_COMPILE_ACTIVE_LOG_LEVEL_TRACE_L3
+#define LOG_TRACE_IN(subsystem, ...) OMNICPP_LOG_IN_(::quill::LogLevel::TraceL3, subsystem, __VA_ARGS__)
+#else
+#define LOG_TRACE_IN(subsystem, ...) OMNICPP_LOG_STRIPPED_(::quill::LogLevel::TraceL3, subsystem, __VA_ARGS__)
+#endif
+
+#if OMNICPP_LOG_ACTIVE_LEVEL <= QUILL_COMPILE_ACTIVE_LOG_LEVEL_DEBUG
+#define LOG_DEBUG_IN(subsystem, ...) OMNICPP_LOG_IN_(::quill::LogLevel::Debug, subsystem, __VA_ARGS__)
+#else
+#define LOG_DEBUG_IN(subsystem, ...) OMNICPP_LOG_STRIPPED_(::quill::LogLevel::Debug, subsystem, __VA_ARGS__)
+#endif
+
+#if OMNICPP_LOG_ACTIVE_LEVEL <= QUILL_COMPILE_ACTIVE_LOG_LEVEL_INFO
+#define LOG_INFO_IN(subsystem, ...) OMNICPP_LOG_IN_(::quill::LogLevel::Info, subsystem, __VA_ARGS__)
+#else
+#define LOG_INFO_IN(subsystem, ...) OMNICPP_LOG_STRIPPED_(::quill::LogLevel::Info, subsystem, __VA_ARGS__)
+#endif
+
+#if OMNICPP_LOG_ACTIVE_LEVEL <= QUILL_COMPILE_ACTIVE_LOG_LEVEL_WARNING
+#define LOG_WARN_IN(subsystem, ...) OMNICPP_LOG_IN_(::quill::LogLevel::Warning, subsystem, __VA_ARGS__)
+#else
+#define LOG_WARN_IN(subsystem, ...) OMNICPP_LOG_STRIPPED_(::quill::LogLevel::Warning, subsystem, __VA_ARGS__)
+#endif
+
+#if OMNICPP_LOG_ACTIVE_LEVEL <= QUILL_COMPILE_ACTIVE_LOG_LEVEL_ERROR
+#define LOG_ERROR_IN(subsystem, ...) OMNICPP_LOG_IN_(::quill::LogLevel::Error, subsystem, __VA_ARGS__)
+#else
+#define LOG_ERROR_IN(subsystem, ...) OMNICPP_LOG_STRIPPED_(::quill::LogLevel::Error, subsystem, __VA_ARGS__)
+#endif
@@ -0,0 +1,389 @@
+/**
+ * @file binary_log.hpp
+ * @brief Binary structured log: format IDs once, then packed arguments per event
+ *
+ * For high-volume events where even deferred text formatting costs too
+ * much disk and parsing. A call site registers its format string, level,
+ * location and argument types once; each event after that is a few bytes:
+ * the site ID, a timestamp delta and the raw arguments.
+ *
+ *   omnicpp::log::binary::open("game.blog");
+ *   BLOG_INFO("Spawned {} at {:.1f},{:.1f}", entity, x, y);
+ *   omnicpp::log::binary::close();
+ *
+ * Each thread writes into its own lock-free ring; a background thread
+ * drains the rings into the file. A full ring drops the event (counted,
+ * reported in the file) instead of blocking the caller. Timestamps are
+ * TSC ticks where available; the file carries the clock calibration.
+ * omnicpp_logcat turns files into text or JSON and filters them.
+ *
+ * File layout (little-endian, integers as LEB128 varints unless noted):
+ *   header:  "OMNIBLOG" u32 version, f64 ticks_per_second, u64 base_ticks, i64 base_unix_ns (raw)
+ *   Format:  id, u8 level, u8 arg_count, u8 types[arg_count], str file, line, str format
+ *   Thread:  thread, str name           (the events that follow are from this thread)
+ *   Event:   id, zigzag tick delta from the thread's previous event, args
+ *   Sync:    id, u64 ticks, args          (an event with an absolute timestamp)
+ *   Dropped: thread, count
+ *   Clock:   u64 ticks, i64 ns since open (raw; refines ticks_per_second)
+ * Strings are a varint length and bytes; floats are raw IEEE 754.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <format>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// Same scale as QUILL_COMPILE_ACTIVE_LOG_LEVEL_*, shared with Log.hpp
+#ifndef OMNICPP_LOG_ACTIVE_LEVEL
+#define OMNICPP_LOG_ACTIVE_LEVEL 0
+#endif
+
+namespace omnicpp::log::binary {
+
+  /**
+   * @brief Event severity; the values match Quill's compile-time level scale
+   */
+  enum class Level : uint8_t { Trace = 0, Debug = 3, Info = 4, Warning = 6, Error = 7, Critical = 8 };
+
+  enum class ArgType : uint8_t { Bool, Int, UInt, F32, F64, Str };
+
+  enum class RecordType : uint8_t { Format = 1, Thread = 2, Event = 3, Sync = 4, Dropped = 5, Clock = 6 };
+
+  inline constexpr char FILE_MAGIC[8] = { 'O', 'M', 'N', 'I', 'B', 'L', 'O', 'G' };
+  inline constexpr uint32_t FILE_VERSION = 1;
+  inline constexpr std::size_t MAX_RECORD = 512; // Longer string arguments are truncated to fit
+
+  struct BinaryLogConfig {
+    std::size_t ring_bytes{ 1u << 20 };  // Per thread, rounded up to a power of two
+    uint32_t flush_interval_ms{ 10 };    // How often the writer drains the rings
+    Level min_level{ Level::Trace };
+  };
+
+  struct BinaryLogStats {
+    uint64_t events{ 0 };        // Accepted into a ring
+    uint64_t dropped{ 0 };       // Ring full
+    uint64_t bytes_written{ 0 }; // File size so far
+  };
+
+  /**
+   * @brief Start writing to `path` (truncates it); closes any file already open
+   */
+  bool open (const std::string& path, const BinaryLogConfig& config = {});
+
+  /**
+   * @brief Drain every ring, write the final clock record and close the file
+   */
+  void close ();
+
+  /**
+   * @brief Block until every event logged before the call is in the file
+   */
+  void flush ();
+
+  [[nodiscard]] bool is_open ();
+  [[nodiscard]] BinaryLogStats get_stats ();
+  void set_level (Level level);
+
+  /**
+   * @brief Name the calling thread in the file
+   */
+  void set_thread_name (std::string_view name);
+
+  /**
+   * @brief Raw timestamp: TSC ticks on x86, steady_clock nanoseconds elsewhere
+   */
+  [[nodiscard]] uint64_t ticks ();
+
+  /**
+   * @brief ticks() per second, measured once per process (the first call takes about 10 ms)
+   */
+  [[nodiscard]] double ticks_per_second ();
+
+  namespace detail {
+
+    /**
+     * @brief Whether a level survives OMNICPP_LOG_ACTIVE_LEVEL
+     */
+    inline constexpr int ACTIVE_LEVEL = OMNICPP_LOG_ACTIVE_LEVEL;
+
+    constexpr bool compiled_in (Level level) {
+      return static_cast<int> (level) >= ACTIVE_LEVEL;
+    }
+
+    inline std::atomic<bool> g_enabled{ false };
+    inline std::atomic<uint8_t> g_min_level{ 0 };
+
+    template<typename T>
+    constexpr ArgType arg_type () {
+      using U = std::decay_t<T>;
+      if constexpr (std::is_same_v<U, bool>) {
+        return ArgType::Bool;
+      } else if constexpr (std::is_enum_v<U>) {
+        return std::is_signed_v<std::underlying_type_t<U>> ? ArgType::Int : ArgType::UInt;
+      } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        return ArgType::Int;
+      } else if constexpr (std::is_integral_v<U>) {
+        return ArgType::UInt;
+      } else if constexpr (std::is_same_v<U, float>) {
+        return ArgType::F32;
+      } else if constexpr (std::is_floating_point_v<U>) {
+        return ArgType::F64;
+      } else if constexpr (std::is_convertible_v<const U&, std::string_view>) {
+        return ArgType::Str;
+      } else {
+        static_assert(std::is_same_v<U, bool>, "Binary log arguments must be numbers, enums or strings");
+      }
+    }
+
+    /**
+     * @brief What the decoder formats a value as (enums as their underlying integer)
+     */
+    template<typename T, bool = std::is_enum_v<T>>
+    struct Formatted {
+      using type = T;
+    };
+
+    template<typename T>
+    struct Formatted<T, true> {
+      using type = std::underlying_type_t<T>;
+    };
+
+    /**
+     * @brief Format string checked against the argument types at compile time
+     */
+    template<typename Tuple>
+    struct CheckedFormat;
+
+    template<typename... Ts>
+    struct CheckedFormat<std::tuple<Ts...>> {
+      const char* text;
+
+      template<std::size_t N>
+      consteval CheckedFormat (const char (&literal)[N]) : text (literal) {
+        (void) std::format_string<const typename Formatted<Ts>::type&...> (literal);
+      }
+
+      static constexpr std::array<ArgType, sizeof...(Ts)> types{ arg_type<Ts> ()... };
+    };
+
+    uint32_t register_site (Level level, const char* format, const char* file, uint32_t line, const ArgType* types,
+        std::size_t count);
+
+    template<typename Tuple>
+    uint32_t register_site (Level level, CheckedFormat<Tuple> format, const char* file, uint32_t line) {
+      return register_site (level, format.text, file, line, CheckedFormat<Tuple>::types.data (),
+          CheckedFormat<Tuple>::types.size ());
+    }
+
+    /**
+     * @brief Bounded writer over a record buffer (MAX_RECORD bytes unless given)
+     */
+    class Encoder {
+    public:
+      Encoder (uint8_t* buffer, std::size_t args, std::size_t capacity = MAX_RECORD)
+          : m_begin (buffer), m_cursor (buffer), m_remaining (args), m_capacity (capacity) {}
+
+      void byte (uint8_t value) { *m_cursor++ = value; }
+
+      void varint (uint64_t value) {
+        while (value >= 0x80) {
+          *m_cursor++ = static_cast<uint8_t> (value | 0x80);
+          value >>= 7;
+        }
+        *m_cursor++ = static_cast<uint8_t> (value);
+      }
+
+      void zigzag (int64_t value) {
+        varint ((static_cast<uint64_t> (value) << 1) ^ static_cast<uint64_t> (value >> 63));
+      }
+
+      template<typename T>
+      void raw (T value) {
+        std::memcpy (m_cursor, &value, sizeof (T));
+        m_cursor += sizeof (T);
+      }
+
+      void string (std::string_view text) {
+        // Leave the worst case for the length varint and every argument still to come
+        const std::size_t reserved = size () + 10 + 10 * m_remaining;
+        const std::size_t room = reserved < m_capacity ? m_capacity - reserved : 0;
+        const std::size_t length = text.size () < room ? text.size () : room;
+        varint (length);
+        std::memcpy (m_cursor, text.data (), length);
+        m_cursor += length;
+      }
+
+      template<typename T>
+      void arg (const T& value) {
+        constexpr ArgType type = arg_type<T> ();
+        --m_remaining;
+        if constexpr (type == ArgType::Bool) {
+          byte (value ? 1 : 0);
+        } else if constexpr (type == ArgType::Int) {
+          zigzag (static_cast<int64_t> (value));
+        } else if constexpr (type == ArgType::UInt) {
+          varint (static_cast<uint64_t> (value));
+        } else if constexpr (type == ArgType::F32) {
+          raw<float> (value);
+        } else if constexpr (type == ArgType::F64) {
+          raw<double> (static_cast<double> (value));
+        } else {
+          string (std::string_view (value));
+        }
+      }
+
+      [[nodiscard]] std::size_t size () const { return static_cast<std::size_t> (m_cursor - m_begin); }
+
+    private:
+      uint8_t* m_begin;
+      uint8_t* m_cursor;
+      std::size_t m_remaining;
+      std::size_t m_capacity;
+    };
+
+    /**
+     * @brief Header of an event for the calling thread's ring; returns false when the event must be dropped
+     */
+    bool begin_event (Encoder& encoder, uint32_t site);
+    void commit_event (const uint8_t* record, std::size_t size);
+
+    template<typename... Args>
+    void write (uint32_t site, const Args&... args) {
+      // Header up to 16 bytes, fixed-size arguments up to 10; strings are clamped by Encoder::string
+      static_assert(16 + 10 * sizeof...(Args) + 10 < MAX_RECORD, "Too many binary log arguments");
+      uint8_t record[MAX_RECORD];
+      Encoder encoder (record, sizeof...(Args));
+      if (begin_event (encoder, site)) {
+        (encoder.arg (args), ...);
+        commit_event (record, encoder.size ());
+      }
+    }
+
+  } // namespace detail
+
+  // ==========================================================================
+  // Reading (used by omnicpp_logcat)
+  // ==========================================================================
+
+  struct FormatInfo {
+    uint32_t id{ 0 };
+    Level level{ Level::Info };
+    std::vector<ArgType> types;
+    std::string file;
+    uint32_t line{ 0 };
+    std::string format;
+  };
+
+  struct Value {
+    ArgType type{ ArgType::Int };
+    int64_t i{ 0 };
+    uint64_t u{ 0 };
+    double f{ 0.0 };
+    std::string s;
+  };
+
+  /**
+   * @brief One event; `format` and `thread_name` stay valid as long as the reader
+   */
+  struct DecodedEvent {
+    const FormatInfo* format{ nullptr };
+    uint32_t thread{ 0 };
+    std::string_view thread_name;
+    uint64_t ticks{ 0 };
+    double seconds{ 0.0 };  // Since the file was opened
+    int64_t unix_ns{ 0 };
+    std::vector<Value> args;
+
+    /**
+     * @brief The message as the format string would have produced it
+     */
+    [[nodiscard]] std::string message () const;
+  };
+
+  /**
+   * @brief Sequential decoder for a binary log file
+   */
+  class BinaryLogReader {
+  public:
+    bool open (const std::string& path);
+
+    /**
+     * @brief Decode the next event, consuming the metadata records before it
+     * @return false at the end of the file or on corruption (see error())
+     */
+    bool next (DecodedEvent& event);
+
+    [[nodiscard]] const std::deque<FormatInfo>& formats () const { return m_formats; }
+    [[nodiscard]] uint64_t dropped () const { return m_dropped; }
+    [[nodiscard]] const std::string& error () const { return m_error; }
+    [[nodiscard]] std::string_view thread_name (uint32_t thread) const;
+
+  private:
+    bool fail (const char* what);
+    bool read_varint (uint64_t& value);
+    bool read_string (std::string& text);
+    template<typename T>
+    bool read_raw (T& value);
+    bool read_args (const FormatInfo& format, DecodedEvent& event);
+    void to_time (DecodedEvent& event) const;
+
+    std::vector<uint8_t> m_data;
+    std::size_t m_offset{ 0 };
+    // Deques: decoded events point into both, and they only grow at the back
+    std::deque<FormatInfo> m_formats;                       // Indexed by site id
+    std::deque<std::pair<uint32_t, std::string>> m_threads; // Names
+    std::vector<std::pair<uint32_t, uint64_t>> m_last_ticks; // Per thread, for deltas
+    uint32_t m_thread{ 0 };
+    double m_ticks_per_second{ 1e9 };
+    uint64_t m_base_ticks{ 0 };
+    int64_t m_base_unix_ns{ 0 };
+    uint64_t m_start_ticks{ 0 };
+    uint64_t m_dropped{ 0 };
+    std::string m_error;
+  };
+
+  [[nodiscard]] const char* level_name (Level level);
+
+  /**
+   * @brief Decode arguments packed by Encoder::arg, advancing `cursor`
+   * @return false if they run past `end`
+   */
+  bool decode_args (const uint8_t*& cursor, const uint8_t* end, const std::vector<ArgType>& types,
+      std::vector<Value>& args);
+
+} // namespace omnicpp::log::binary
+
+// ============================================================================
+// Binary logging macros - arguments are only evaluated when enabled
+// ============================================================================
+
+#define OMNICPP_BLOG_(level, fmt, ...)                                                                          \
+  do {                                                                                                          \
+    if constexpr (::omnicpp::log::binary::detail::compiled_in (level)) {                                      \
+      if (::omnicpp::log::binary::detail::g_enabled.load (std::memory_order_relaxed) &&                         \
+          static_cast<uint8_t> (level) >=                                                                       \
+              ::omnicpp::log::binary::detail::g_min_level.load (std::memory_order_relaxed)) {                   \
+        static const uint32_t omnicpp_blog_site_ = ::omnicpp::log::binary::detail::register_site (              \
+            level,                                                                                              \
+            ::omnicpp::log::binary::detail::CheckedFormat<decltype (std::make_tuple (__VA_ARGS__))> (fmt),      \
+            __FILE__, __LINE__);                                                                                \
+        ::omnicpp::log::binary::detail::write (omnicpp_blog_site_ __VA_OPT__ (, ) __VA_ARGS__);                 \
+      }                                                                                                         \
+    }                                                                                                           \
+  } while (0)
+
+#define BLOG_TRACE(fmt, ...) OMNICPP_BLOG_ (::omnicpp::log::binary::Level::Trace, fmt __VA_OPT__ (, ) __VA_ARGS__)
+#define BLOG_DEBUG(fmt, ...) OMNICPP_BLOG_ (::omnicpp::log::binary::Level::Debug, fmt __VA_OPT__ (, ) __VA_ARGS__)
+#define BLOG_INFO(fmt, ...) OMNICPP_BLOG_ (::omnicpp::log::binary::Level::Info, fmt __VA_OPT__ (, ) __VA_ARGS__)
+#define BLOG_WARN(fmt, ...) OMNICPP_BLOG_ (::omnicpp::log::binary::Level::Warning, fmt __VA_OPT__ (, ) __VA_ARGS__)
+#define BLOG_ERROR(fmt, ...) OMNICPP_BLOG_ (::omnicpp::log::binary::Level::Error, fmt __VA_OPT__ (, ) __VA_ARGS__)
@@ -0,0 +1,150 @@
+/**
+ * @file flight_recorder.hpp
+ * @brief Crash-resilient ring of recent log records in a memory-mapped file
+ *
+ * Quill formats and writes on a background thread, so when the process
+ * dies the last messages are often still in its queues. The flight
+ * recorder keeps its own copy of every record that passes the log level
+ * check: each thread owns a fixed ring of slots in a MAP_SHARED file, and
+ * a record is encoded straight into the next slot, overwriting the oldest.
+ * There is no lock, no syscall and no formatting on the logging path.
+ *
+ * Because the pages belong to the file, they survive the process: after a
+ * crash (not a power loss) the file holds the last slots_per_thread records
+ * of every thread. A slot carries a sequence number that is odd while it is
+ * being written, so a record torn by the crash is recognized and skipped.
+ *
+ * log::init() opens the recorder at FlightRecorderConfig::path, moving the
+ * previous run's file to `<path>.prev` first, so it is on unless disabled.
+ * The default path is omnicpp_flight.bin in $XDG_RUNTIME_DIR, or in the
+ * system temp directory without one, never the working directory.
+ * Decode either file with `omnicpp_logcat <file>`.
+ *
+ * File layout (native endianness; the decoder expects the writer's):
+ *   header:  "OMNIFLTR" u32 version, u32 threads, u32 slots_per_thread, u32 slot_bytes,
+ *            i64 created_unix_ns, u64 pid, u64 unrecorded (records from threads without a ring)
+ *   rings:   per thread { u32 owner, u32 thread, u64 written, char name[48] }
+ *   slots:   threads * slots_per_thread slots of slot_bytes:
+ *            { u32 seq, u16 size, u8 level, u8 arg_count, u32 thread, u32 line, i64 unix_ns,
+ *              u8 types[arg_count], str format, str file, args }
+ * Strings and arguments are encoded as in binary_log.hpp.
+ */
+
+#pragma once
+
+#include "engine/logging/binary_log.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace omnicpp::log::flight {
+
+  inline constexpr char FILE_MAGIC[8] = { 'O', 'M', 'N', 'I', 'F', 'L', 'T', 'R' };
+  inline constexpr uint32_t FILE_VERSION = 1;
+
+  struct FlightRecorderConfig {
+    std::string path;                  // Empty = default_path()
+    uint32_t threads{ 32 };            // Rings; threads beyond this are not recorded (counted as unrecorded)
+    uint32_t slots_per_thread{ 1024 }; // Records kept per thread
+    uint32_t slot_bytes{ 256 };        // Longer records have their strings truncated
+  };
+
+  /**
+   * @brief Where open() maps the file when FlightRecorderConfig::path is empty
+   * @return `omnicpp_flight.bin` in $XDG_RUNTIME_DIR, else in the system temp directory
+   */
+  std::string default_path ();
+
+  /**
+   * @brief Map a new recorder file, keeping the previous one as `<path>.prev`
+   */
+  bool open (const FlightRecorderConfig& config = {});
+
+  /**
+   * @brief Stop recording (the records stay in the file)
+   *
+   * The mapping itself is kept until exit, so a thread still inside a
+   * record never writes to unmapped memory.
+   */
+  void close ();
+
+  [[nodiscard]] bool is_open ();
+
+  /**
+   * @brief Name the calling thread in the file
+   */
+  void set_thread_name (std::string_view name);
+
+  namespace detail {
+
+    inline std::atomic<bool> g_open{ false };
+
+    /**
+     * @brief A claimed slot: the payload is filled in place, then published
+     */
+    struct Slot {
+      void* header{ nullptr };
+      uint8_t* payload{ nullptr };
+      std::size_t capacity{ 0 };
+    };
+
+    /**
+     * @brief The calling thread's next slot; empty when the thread has no ring
+     */
+    Slot begin_record ();
+    void end_record (const Slot& slot, uint8_t level, uint32_t line, std::size_t arg_count, std::size_t size);
+
+    template<typename... Args>
+    void record (uint8_t level, const char* format, const std::source_location& location, const Args&... args) {
+      static_assert(sizeof...(Args) < 32, "Too many flight recorder arguments");
+      const Slot slot = begin_record ();
+      if (slot.payload == nullptr) {
+        return;
+      }
+      binary::detail::Encoder encoder (slot.payload, sizeof...(Args) + 2, slot.capacity);
+      (encoder.byte (static_cast<uint8_t> (binary::detail::arg_type<Args> ())), ...);
+      encoder.string (format);
+      encoder.string (location.file_name ());
+      (encoder.arg (args), ...);
+      end_record (slot, level, location.line (), sizeof...(Args), encoder.size ());
+    }
+
+  } // namespace detail
+
+  /**
+   * @brief Decoder for a recorder file, live or left behind by a crash
+   *
+   * Events come out oldest first across all threads.
+   */
+  class FlightRecorderReader {
+  public:
+    bool open (const std::string& path);
+    bool next (binary::DecodedEvent& event);
+
+    [[nodiscard]] const std::vector<binary::DecodedEvent>& events () const { return m_events; }
+    [[nodiscard]] const std::deque<binary::FormatInfo>& formats () const { return m_formats; }
+    [[nodiscard]] uint64_t torn () const { return m_torn; }       // Slots caught mid-write
+    [[nodiscard]] uint64_t dropped () const { return m_dropped; } // Records from threads without a ring
+    [[nodiscard]] uint64_t pid () const { return m_pid; }
+    [[nodiscard]] const std::string& error () const { return m_error; }
+
+  private:
+    bool fail (const char* what);
+
+    std::vector<binary::DecodedEvent> m_events;
+    std::size_t m_next{ 0 };
+    std::deque<binary::FormatInfo> m_formats; // One per distinct (format, file, line, level)
+    std::deque<std::string> m_thread_names;
+    uint64_t m_torn{ 0 };
+    uint64_t m_dropped{ 0 };
+    uint64_t m_pid{ 0 };
+    std::string m_error;
+  };
+
+} // namespace omnicpp::log::flight
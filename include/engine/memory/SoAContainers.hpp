@@ -13,6 +13,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <type_traits>
@@ -75,8 +76,19 @@ public:
     static constexpr std::size_t kComponentAligns[] = { alignof(Components)... };
     
 private:
+    // Arrays come from posix_memalign/_aligned_malloc, so they must not be freed with delete[]
+    struct AlignedDeleter {
+        void operator()(void* ptr) const noexcept {
+            #if defined(_MSC_VER)
+                _aligned_free(ptr);
+            #else
+                std::free(ptr);
+            #endif
+        }
+    };
+
     // Aligned storage for each component array
-    std::tuple<std::unique_ptr<ComponentType<Components>[]...> > arrays_;
+    std::tuple<std::unique_ptr<Components[], AlignedDeleter>...> arrays_;
     
     SizeType size_{0};
     SizeType capacity_{0};
@@ -143,8 +155,11 @@ private:
 public:
     SoAVector() = default;
     
-    explicit SoAVector(SizeType initial_capacity) {
-        reserve(initial_capacity);
+    explicit SoAVector(SizeType initial_capacity) : capacity_(initial_capacity) {
+        // Allocate directly: reserve() builds a container through this constructor
+        if (capacity_ > 0) {
+            allocate_all(capacity_, std::make_index_sequence<kComponentCount>{});
+        }
     }
     
     ~SoAVector() = default;
@@ -361,7 +376,7 @@ public:
             : container_(container), index_(index) {}
         
         value_type operator*() const {
-            return get_tuple<0>(index_);
+            return get_tuple(index_, std::make_index_sequence<kComponentCount>{});
         }
         
         Iterator& operator++() { ++index_; return *this; }
@@ -386,16 +401,9 @@ public:
         SoAVector* container_;
         SizeType index_;
         
-        template<std::size_t I>
-        value_type get_tuple(SizeType idx) const {
-            if constexpr (I < kComponentCount - 1) {
-                return std::tuple_cat(
-                    std::tie(container_->get<I>()[idx]),
-                    get_tuple<I + 1>(idx)
-                );
-            } else {
-                return std::tie(container_->get<I>()[idx]);
-            }
+        template<std::size_t... Is>
+        value_type get_tuple(SizeType idx, std::index_sequence<Is...>) const {
+            return value_type(container_->template get<Is>()[idx]...);
         }
     };
     
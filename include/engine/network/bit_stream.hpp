@@ -0,0 +1,295 @@
+/**
+ * @file bit_stream.hpp
+ * @brief Bit-packing writer and reader for replication payloads
+ */
+
+#pragma once
+
+#include "engine/core/StrongTypes.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace OmniCpp::Engine::Network {
+
+  /**
+   * @brief Bits needed to store any value in [0, range]
+   */
+  [[nodiscard]] constexpr uint32_t bits_required (uint64_t range) noexcept {
+    return range == 0 ? 0 : static_cast<uint32_t> (std::bit_width (range));
+  }
+
+  /**
+   * @brief Steps needed to cover [min, max] at the given resolution
+   */
+  [[nodiscard]] inline uint32_t quantization_steps (float min, float max, float resolution) noexcept {
+    return static_cast<uint32_t> (std::ceil ((max - min) / resolution));
+  }
+
+  /**
+   * @brief Map a float in [min, max] to an integer step (clamped)
+   */
+  [[nodiscard]] inline uint32_t quantize (float value, float min, float max, uint32_t steps) noexcept {
+    const float t = std::clamp ((value - min) / (max - min), 0.0f, 1.0f);
+    return static_cast<uint32_t> (std::lround (t * static_cast<float> (steps)));
+  }
+
+  [[nodiscard]] inline float dequantize (uint32_t step, float min, float max, uint32_t steps) noexcept {
+    return min + (max - min) * (static_cast<float> (step) / static_cast<float> (steps));
+  }
+
+  [[nodiscard]] constexpr uint64_t zigzag_encode (int64_t value) noexcept {
+    return (static_cast<uint64_t> (value) << 1) ^ static_cast<uint64_t> (value >> 63);
+  }
+
+  [[nodiscard]] constexpr int64_t zigzag_decode (uint64_t value) noexcept {
+    return static_cast<int64_t> (value >> 1) ^ -static_cast<int64_t> (value & 1);
+  }
+
+  /**
+   * @brief Writes values LSB-first into a caller-owned buffer
+   *
+   * Never allocates. Writing past the end sets overflowed() and drops the
+   * excess, so callers check once after encoding instead of per call.
+   */
+  class BitWriter {
+  public:
+    explicit BitWriter (std::span<uint8_t> buffer) noexcept : m_buffer (buffer) {
+    }
+
+    /**
+     * @brief Append the low `bits` bits of `value` (bits <= 32)
+     */
+    void write_bits (uint32_t value, uint32_t bits) noexcept {
+      if (bits == 0) {
+        return;
+      }
+      if (bits < 32) {
+        value &= (1u << bits) - 1;
+      }
+      m_scratch |= static_cast<uint64_t> (value) << m_scratch_bits;
+      m_scratch_bits += bits;
+      m_bits_written += bits;
+      while (m_scratch_bits >= 8) {
+        put_byte (static_cast<uint8_t> (m_scratch));
+        m_scratch >>= 8;
+        m_scratch_bits -= 8;
+      }
+    }
+
+    void write_bool (bool value) noexcept { write_bits (value ? 1u : 0u, 1); }
+
+    void write_u64 (uint64_t value) noexcept {
+      write_bits (static_cast<uint32_t> (value), 32);
+      write_bits (static_cast<uint32_t> (value >> 32), 32);
+    }
+
+    void write_float (float value) noexcept { write_bits (std::bit_cast<uint32_t> (value), 32); }
+
+    /**
+     * @brief Variable-length unsigned integer: 7 payload bits + 1 continuation bit per group
+     */
+    void write_varint (uint64_t value) noexcept {
+      while (value >= 0x80) {
+        write_bits (static_cast<uint32_t> (value & 0x7F) | 0x80, 8);
+        value >>= 7;
+      }
+      write_bits (static_cast<uint32_t> (value), 8);
+    }
+
+    /**
+     * @brief Signed varint via zigzag so small negative values stay small
+     */
+    void write_varint_signed (int64_t value) noexcept { write_varint (zigzag_encode (value)); }
+
+    /**
+     * @brief Integer in [min, max] using exactly bits_required(max - min) bits
+     */
+    void write_bounded (int64_t value, int64_t min, int64_t max) noexcept {
+      const uint64_t range = static_cast<uint64_t> (max - min);
+      const uint64_t offset = static_cast<uint64_t> (std::clamp (value, min, max) - min);
+      const uint32_t bits = bits_required (range);
+      if (bits > 32) {
+        write_bits (static_cast<uint32_t> (offset), 32);
+        write_bits (static_cast<uint32_t> (offset >> 32), bits - 32);
+      } else {
+        write_bits (static_cast<uint32_t> (offset), bits);
+      }
+    }
+
+    /**
+     * @brief Float in [min, max] snapped to `resolution`
+     */
+    void write_quantized (float value, float min, float max, float resolution) noexcept {
+      const uint32_t steps = quantization_steps (min, max, resolution);
+      write_bits (quantize (value, min, max, steps), bits_required (steps));
+    }
+
+    /**
+     * @brief core::Bounded integers use their compile-time range
+     */
+    template<std::integral T, T Min, T Max>
+    void write (const omnicpp::core::Bounded<T, Min, Max>& value) noexcept {
+      write_bounded (static_cast<int64_t> (value.get ()), static_cast<int64_t> (Min), static_cast<int64_t> (Max));
+    }
+
+    /**
+     * @brief core::Bounded floats are quantized across their range
+     */
+    template<uint32_t Bits = 16, std::floating_point T, T Min, T Max>
+    void write (const omnicpp::core::Bounded<T, Min, Max>& value) noexcept {
+      static_assert (Bits > 0 && Bits <= 32, "quantized floats take 1-32 bits");
+      constexpr auto steps = static_cast<uint32_t> ((uint64_t{ 1 } << Bits) - 1);
+      write_bits (quantize (static_cast<float> (value.get ()), static_cast<float> (Min), static_cast<float> (Max), steps), Bits);
+    }
+
+    /**
+     * @brief Pad to a byte boundary and return the bytes used
+     */
+    std::size_t flush () noexcept {
+      if (m_scratch_bits > 0) {
+        put_byte (static_cast<uint8_t> (m_scratch));
+        m_bits_written += 8 - m_scratch_bits;
+        m_scratch = 0;
+        m_scratch_bits = 0;
+      }
+      return std::min (m_bytes, m_buffer.size ());
+    }
+
+    [[nodiscard]] std::size_t bits_written () const noexcept { return m_bits_written; }
+    [[nodiscard]] std::size_t bytes_written () const noexcept { return (m_bits_written + 7) / 8; }
+    [[nodiscard]] bool overflowed () const noexcept { return m_bytes > m_buffer.size (); }
+
+  private:
+    void put_byte (uint8_t byte) noexcept {
+      if (m_bytes < m_buffer.size ()) {
+        m_buffer[m_bytes] = byte;
+      }
+      ++m_bytes;
+    }
+
+    std::span<uint8_t> m_buffer;
+    uint64_t m_scratch{ 0 };
+    uint32_t m_scratch_bits{ 0 };
+    std::size_t m_bytes{ 0 };
+    std::size_t m_bits_written{ 0 };
+  };
+
+  /**
+   * @brief Mirror of BitWriter
+   *
+   * Reading past the end yields zeros and sets failed(); like the writer,
+   * check once after decoding.
+   */
+  class BitReader {
+  public:
+    explicit BitReader (std::span<const uint8_t> buffer) noexcept : m_buffer (buffer) {
+    }
+
+    uint32_t read_bits (uint32_t bits) noexcept {
+      if (bits == 0) {
+        return 0;
+      }
+      while (m_scratch_bits < bits) {
+        uint64_t byte = 0;
+        if (m_bytes < m_buffer.size ()) {
+          byte = m_buffer[m_bytes];
+        } else {
+          m_failed = true;
+        }
+        ++m_bytes;
+        m_scratch |= byte << m_scratch_bits;
+        m_scratch_bits += 8;
+      }
+      const uint32_t value = static_cast<uint32_t> (bits == 32 ? m_scratch : m_scratch & ((1ull << bits) - 1));
+      m_scratch >>= bits;
+      m_scratch_bits -= bits;
+      return value;
+    }
+
+    bool read_bool () noexcept { return read_bits (1) != 0; }
+
+    uint64_t read_u64 () noexcept {
+      const uint64_t low = read_bits (32);
+      return low | (static_cast<uint64_t> (read_bits (32)) << 32);
+    }
+
+    float read_float () noexcept { return std::bit_cast<float> (read_bits (32)); }
+
+    uint64_t read_varint () noexcept {
+      uint64_t value = 0;
+      for (uint32_t shift = 0; shift < 64; shift += 7) {
+        const uint32_t group = read_bits (8);
+        value |= static_cast<uint64_t> (group & 0x7F) << shift;
+        if (!(group & 0x80) || m_failed) {
+          return value;
+        }
+      }
+      m_failed = true; // More than 10 groups: corrupt
+      return value;
+    }
+
+    int64_t read_varint_signed () noexcept { return zigzag_decode (read_varint ()); }
+
+    int64_t read_bounded (int64_t min, int64_t max) noexcept {
+      const uint32_t bits = bits_required (static_cast<uint64_t> (max - min));
+      uint64_t offset = 0;
+      if (bits > 32) {
+        offset = read_bits (32);
+        offset |= static_cast<uint64_t> (read_bits (bits - 32)) << 32;
+      } else {
+        offset = read_bits (bits);
+      }
+      if (offset > static_cast<uint64_t> (max - min)) {
+        m_failed = true;
+        return max;
+      }
+      return min + static_cast<int64_t> (offset);
+    }
+
+    float read_quantized (float min, float max, float resolution) noexcept {
+      const uint32_t steps = quantization_steps (min, max, resolution);
+      return dequantize (std::min (read_bits (bits_required (steps)), steps), min, max, steps);
+    }
+
+    template<std::integral T, T Min, T Max>
+    void read (omnicpp::core::Bounded<T, Min, Max>& value) noexcept {
+      value = static_cast<T> (read_bounded (static_cast<int64_t> (Min), static_cast<int64_t> (Max)));
+    }
+
+    template<uint32_t Bits = 16, std::floating_point T, T Min, T Max>
+    void read (omnicpp::core::Bounded<T, Min, Max>& value) noexcept {
+      static_assert (Bits > 0 && Bits <= 32, "quantized floats take 1-32 bits");
+      constexpr auto steps = static_cast<uint32_t> ((uint64_t{ 1 } << Bits) - 1);
+      value = static_cast<T> (dequantize (read_bits (Bits), static_cast<float> (Min), static_cast<float> (Max), steps));
+    }
+
+    /**
+     * @brief Skip to the next byte boundary
+     */
+    void align () noexcept {
+      const uint32_t drop = m_scratch_bits % 8;
+      m_scratch >>= drop;
+      m_scratch_bits -= drop;
+    }
+
+    [[nodiscard]] bool failed () const noexcept { return m_failed; }
+    [[nodiscard]] std::size_t bits_remaining () const noexcept {
+      const std::size_t total = m_buffer.size () * 8;
+      const std::size_t consumed = m_bytes * 8 - m_scratch_bits;
+      return consumed >= total ? 0 : total - consumed;
+    }
+
+  private:
+    std::span<const uint8_t> m_buffer;
+    uint64_t m_scratch{ 0 };
+    uint32_t m_scratch_bits{ 0 };
+    std::size_t m_bytes{ 0 };
+    bool m_failed{ false };
+  };
+
+} // namespace OmniCpp::Engine::Network
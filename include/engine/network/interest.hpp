@@ -0,0 +1,172 @@
+/**
+ * @file interest.hpp
+ * @brief Spatial relevance filtering and prioritized, budgeted replication
+ */
+
+#pragma once
+
+#include "engine/math/Vec3.hpp"
+#include "engine/network/snapshot.hpp"
+#include "engine/network/transport.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace OmniCpp::Engine::Network {
+
+  /**
+   * @brief An entity as seen by the replication scheduler
+   */
+  struct ReplicatedEntity {
+    uint32_t entity_id{ 0 };
+    omnicpp::math::Vec3 position{ 0.0f, 0.0f, 0.0f };
+    float priority{ 1.0f };        // Accumulated per tick at zero distance
+    uint32_t size_estimate{ 16 };  // Bytes one update is expected to cost on the wire
+    bool always_relevant{ false }; // Game state, the client's own avatar, ...
+  };
+
+  /**
+   * @brief Uniform grid over entity positions
+   *
+   * Rebuilt each tick by sorting entities by cell, which keeps storage in
+   * two flat arrays that are reused from tick to tick. Queries visit only
+   * the cells overlapping the query sphere.
+   */
+  class SpatialGrid {
+  public:
+    explicit SpatialGrid (float cell_size = 64.0f);
+
+    void build (std::span<const ReplicatedEntity> entities);
+
+    /**
+     * @brief Append the indices (into the built span) of entities within `radius` of `center`
+     */
+    void query (const omnicpp::math::Vec3& center, float radius, std::vector<uint32_t>& out) const;
+
+    [[nodiscard]] float get_cell_size () const { return m_cell_size; }
+
+  private:
+    struct CellEntry {
+      uint64_t cell{ 0 };
+      uint32_t index{ 0 };
+    };
+
+    [[nodiscard]] static uint64_t cell_key (int32_t x, int32_t y, int32_t z);
+    [[nodiscard]] int32_t cell_coordinate (float value) const;
+
+    float m_cell_size;
+    float m_inverse_cell_size;
+    std::span<const ReplicatedEntity> m_entities;
+    std::vector<CellEntry> m_entries; // Sorted by cell
+  };
+
+  /**
+   * @brief Scheduler tuning
+   */
+  struct InterestConfig {
+    float cell_size{ 64.0f };
+    float relevance_radius{ 256.0f };
+    float min_distance_weight{ 0.1f };  // Weight at the edge of the radius (1 at the center)
+    float enter_boost{ 1000.0f };       // Added when an entity becomes relevant so it is sent at once
+    uint32_t bytes_per_tick{ 4096 };    // Per-client budget
+  };
+
+  /**
+   * @brief Outcome of one client's scheduling pass
+   */
+  struct InterestSchedule {
+    std::vector<uint32_t> send;     // Entity ids to update this tick, most important first
+    std::vector<uint32_t> relevant; // Every relevant entity id, sorted
+    uint32_t bytes_scheduled{ 0 };
+    uint32_t deferred{ 0 };         // Relevant but over budget this tick
+  };
+
+  /**
+   * @brief Scheduler counters, summed over clients since the last reset
+   */
+  struct InterestStats {
+    uint64_t ticks{ 0 };
+    uint64_t relevant{ 0 };
+    uint64_t scheduled{ 0 };
+    uint64_t deferred{ 0 };
+    uint64_t bytes_scheduled{ 0 };
+  };
+
+  /**
+   * @brief Per-client relevance and priority scheduling
+   *
+   * Each tick the server hands over every replicated entity once
+   * (set_entities), then asks for each client's schedule. An entity is
+   * relevant to a client when it lies within relevance_radius of the
+   * client's view position or is always_relevant. Every relevant entity
+   * adds its distance-weighted priority to the client's accumulator for
+   * it; the highest accumulators are sent first until the client's byte
+   * budget runs out, and sending resets an accumulator. Deferred entities
+   * keep accumulating, so distant or low-priority entities still go out,
+   * just less often.
+   *
+   * Cost per client is proportional to the entities near it, not to the
+   * world.
+   */
+  class InterestManager {
+  public:
+    explicit InterestManager (const InterestConfig& config = {});
+
+    void add_client (ConnectionId client, const omnicpp::math::Vec3& view_position);
+    void remove_client (ConnectionId client);
+    void set_view (ConnectionId client, const omnicpp::math::Vec3& view_position);
+
+    /**
+     * @brief Replace the entity set for this tick (the span must stay valid until the next call)
+     */
+    void set_entities (std::span<const ReplicatedEntity> entities);
+
+    /**
+     * @brief Relevance and send order for one client this tick
+     * @return false for an unknown client
+     */
+    bool schedule (ConnectionId client, InterestSchedule& out);
+
+    [[nodiscard]] std::size_t get_client_count () const { return m_clients.size (); }
+    [[nodiscard]] const InterestConfig& get_config () const { return m_config; }
+    [[nodiscard]] const InterestStats& get_stats () const { return m_stats; }
+    void reset_stats () { m_stats = {}; }
+
+  private:
+    struct ClientState {
+      omnicpp::math::Vec3 view_position;
+      std::unordered_map<uint32_t, float> accumulators; // Relevant entities by id
+    };
+
+    struct Candidate {
+      float accumulator{ 0.0f };
+      uint32_t index{ 0 };
+    };
+
+    InterestConfig m_config;
+    SpatialGrid m_grid;
+    std::span<const ReplicatedEntity> m_entities;
+    std::vector<uint32_t> m_always_relevant;
+    std::unordered_map<ConnectionId, ClientState> m_clients;
+    std::vector<uint32_t> m_query;
+    std::vector<Candidate> m_candidates;
+    InterestStats m_stats;
+  };
+
+  /**
+   * @brief Build the snapshot one client should be sent from the world snapshot
+   *
+   * Scheduled entities carry their current state; relevant entities that
+   * were deferred repeat what the client last received, so a delta against
+   * `previous` spends nothing on them; entities that are no longer relevant
+   * are dropped, which the codec encodes as a removal.
+   *
+   * @param world Full world snapshot (sorted by id)
+   * @param previous What this client was last sent, or nullptr
+   */
+  void build_client_snapshot (const Snapshot& world, const InterestSchedule& schedule, const Snapshot* previous,
+      Snapshot& out);
+
+} // namespace OmniCpp::Engine::Network
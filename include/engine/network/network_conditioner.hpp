@@ -0,0 +1,106 @@
+/**
+ * @file network_conditioner.hpp
+ * @brief Simulated latency, jitter, loss, duplication, reordering and bandwidth limits
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace OmniCpp::Engine::Network {
+
+  class DatagramBatch;
+  class GatherBatch;
+
+  /**
+   * @brief Impairments applied to outgoing datagrams
+   *
+   * Probabilities are in [0, 1]. Randomness comes from a SeededRandomProvider
+   * seeded with `seed`, so the same traffic sees the same drops, delays and
+   * duplicates on every run.
+   */
+  struct NetworkConditionerConfig {
+    bool enabled{ false };
+    std::chrono::milliseconds latency{ 0 };          // One-way delay added to every datagram
+    std::chrono::milliseconds jitter{ 0 };           // Uniform +/- variation around latency
+    double loss{ 0.0 };
+    double duplicate{ 0.0 };
+    double reorder{ 0.0 };                           // Chance a datagram is held back and overtaken
+    std::chrono::milliseconds reorder_delay{ 20 };   // Extra hold for reordered datagrams
+    uint64_t bandwidth{ 0 };                         // Bytes per second, 0 = unlimited
+    std::chrono::milliseconds max_queue_delay{ 250 }; // Datagrams queued longer behind the bandwidth cap are dropped
+    uint64_t seed{ 1 };
+  };
+
+  /**
+   * @brief Conditioner counters
+   */
+  struct NetworkConditionerStats {
+    uint64_t datagrams_offered{ 0 };
+    uint64_t datagrams_delivered{ 0 };
+    uint64_t bytes_delivered{ 0 };
+    uint64_t dropped_loss{ 0 };
+    uint64_t dropped_queue{ 0 }; // Tail drops behind the bandwidth cap
+    uint64_t duplicated{ 0 };
+    uint64_t reordered{ 0 };
+  };
+
+  /**
+   * @brief Delay line between a sender and its socket
+   *
+   * enqueue() copies datagrams in and decides their fate; release() hands
+   * back those whose delivery time has passed. Without reordering,
+   * datagrams leave in the order they entered even when jitter would
+   * swap them, as on a real path. The bandwidth cap serializes datagrams
+   * through a virtual link of that rate.
+   *
+   * Payload buffers are recycled, so steady traffic does not allocate.
+   */
+  class NetworkConditioner {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit NetworkConditioner (const NetworkConditionerConfig& config = {});
+    ~NetworkConditioner ();
+
+    NetworkConditioner (const NetworkConditioner&) = delete;
+    NetworkConditioner& operator= (const NetworkConditioner&) = delete;
+
+    NetworkConditioner (NetworkConditioner&&) noexcept;
+    NetworkConditioner& operator= (NetworkConditioner&&) noexcept;
+
+    /**
+     * @brief Replace the impairments and reseed; queued datagrams keep their schedule
+     */
+    void configure (const NetworkConditionerConfig& config);
+
+    /**
+     * @brief Take every datagram in `batch`, sent at `now`
+     */
+    void enqueue (const DatagramBatch& batch, Clock::time_point now);
+    void enqueue (const GatherBatch& batch, Clock::time_point now);
+
+    /**
+     * @brief Move datagrams due by `now` into `out` until it is full
+     * @return Datagrams added
+     */
+    std::size_t release (Clock::time_point now, DatagramBatch& out);
+
+    /**
+     * @brief Discard everything queued
+     */
+    void clear ();
+
+    [[nodiscard]] std::size_t get_queued_count () const;
+    [[nodiscard]] const NetworkConditionerConfig& get_config () const;
+    [[nodiscard]] const NetworkConditionerStats& get_stats () const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+} // namespace OmniCpp::Engine::Network
@@ -5,8 +5,10 @@
 
 #pragma once
 
+#include "engine/network/transport.hpp"
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 
 namespace OmniCpp::Engine::Network {
@@ -18,6 +20,9 @@ namespace OmniCpp::Engine::Network {
     uint16_t port{ 8080 };
     bool is_server{ false };
     uint32_t max_connections{ 32 };
+    uint16_t mtu{ 1200 };
+    std::chrono::milliseconds connection_timeout{ 5000 };
+    NetworkConditionerConfig conditioner; // Simulated bad network for testing
   };
 
   /**
@@ -39,9 +44,31 @@ namespace OmniCpp::Engine::Network {
     void update ();
 
     bool start_server ();
+
+    /**
+     * @brief Connect to a server
+     * @param address "host:port", or "host" to use the configured port
+     * @return true if the handshake was started
+     */
     bool connect_to_server (const std::string& address);
     void disconnect ();
 
+    /**
+     * @brief Queue a message to one connection
+     */
+    bool send (ConnectionId connection, Channel channel, std::span<const uint8_t> data);
+
+    /**
+     * @brief Queue a message to every connected peer
+     */
+    void broadcast (Channel channel, std::span<const uint8_t> data);
+
+    bool poll_message (Message& out);
+    bool poll_event (TransportEvent& out);
+
+    [[nodiscard]] bool is_connected () const;
+    [[nodiscard]] Transport& get_transport ();
+
   private:
     struct Impl;
     std::unique_ptr<Impl> m_impl;
@@ -0,0 +1,294 @@
+/**
+ * @file packet_buffer.hpp
+ * @brief Pooled, reference-counted packet buffers with headroom
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <utility>
+
+namespace OmniCpp::Engine::Network {
+
+  namespace detail {
+
+    struct PacketPoolState;
+
+    /**
+     * @brief One fixed-capacity buffer carved from a pool slab
+     */
+    struct PacketBlock {
+      PacketPoolState* pool{ nullptr };
+      PacketBlock* next_free{ nullptr };
+      uint8_t* bytes{ nullptr };
+      uint32_t capacity{ 0 };
+      uint32_t refs{ 0 };
+    };
+
+    void release_block (PacketBlock* block) noexcept;
+
+  } // namespace detail
+
+  /**
+   * @brief Handle to a window of a pooled block
+   *
+   * Copying shares the block (reference count); the block returns to its
+   * pool when the last handle goes away. Each handle has its own
+   * [offset, offset + size) window, so slice() hands out part of a packet
+   * without copying. prepend() and append() grow the window into the
+   * block's headroom and tailroom and only succeed while the handle is the
+   * block's sole owner, so shared bytes are never rewritten.
+   *
+   * Like the pool, handles are not thread-safe: keep a block's handles on
+   * one thread.
+   */
+  class PacketBuffer {
+  public:
+    PacketBuffer () noexcept = default;
+
+    ~PacketBuffer () { reset (); }
+
+    PacketBuffer (const PacketBuffer& other) noexcept
+        : m_block (other.m_block), m_offset (other.m_offset), m_length (other.m_length) {
+      if (m_block) {
+        ++m_block->refs;
+      }
+    }
+
+    PacketBuffer& operator= (const PacketBuffer& other) noexcept {
+      if (this != &other) {
+        PacketBuffer copy (other);
+        swap (copy);
+      }
+      return *this;
+    }
+
+    PacketBuffer (PacketBuffer&& other) noexcept
+        : m_block (other.m_block), m_offset (other.m_offset), m_length (other.m_length) {
+      other.m_block = nullptr;
+      other.m_offset = 0;
+      other.m_length = 0;
+    }
+
+    PacketBuffer& operator= (PacketBuffer&& other) noexcept {
+      if (this != &other) {
+        reset ();
+        swap (other);
+      }
+      return *this;
+    }
+
+    void swap (PacketBuffer& other) noexcept {
+      std::swap (m_block, other.m_block);
+      std::swap (m_offset, other.m_offset);
+      std::swap (m_length, other.m_length);
+    }
+
+    /**
+     * @brief Drop this handle's reference
+     */
+    void reset () noexcept {
+      if (m_block) {
+        detail::release_block (m_block);
+        m_block = nullptr;
+      }
+      m_offset = 0;
+      m_length = 0;
+    }
+
+    [[nodiscard]] explicit operator bool () const noexcept { return m_block != nullptr; }
+
+    [[nodiscard]] uint8_t* data () noexcept { return m_block ? m_block->bytes + m_offset : nullptr; }
+    [[nodiscard]] const uint8_t* data () const noexcept { return m_block ? m_block->bytes + m_offset : nullptr; }
+    [[nodiscard]] std::size_t size () const noexcept { return m_length; }
+    [[nodiscard]] bool empty () const noexcept { return m_length == 0; }
+
+    [[nodiscard]] uint8_t* begin () noexcept { return data (); }
+    [[nodiscard]] uint8_t* end () noexcept { return data () + m_length; }
+    [[nodiscard]] const uint8_t* begin () const noexcept { return data (); }
+    [[nodiscard]] const uint8_t* end () const noexcept { return data () + m_length; }
+
+    [[nodiscard]] uint8_t& operator[] (std::size_t i) noexcept { return data ()[i]; }
+    [[nodiscard]] uint8_t operator[] (std::size_t i) const noexcept { return data ()[i]; }
+    [[nodiscard]] uint8_t back () const noexcept { return data ()[m_length - 1]; }
+
+    [[nodiscard]] std::span<uint8_t> span () noexcept { return { data (), m_length }; }
+    [[nodiscard]] std::span<const uint8_t> span () const noexcept { return { data (), m_length }; }
+    operator std::span<const uint8_t> () const noexcept { return span (); }
+
+    /**
+     * @brief Free bytes in front of / behind the window
+     */
+    [[nodiscard]] std::size_t headroom () const noexcept { return m_block ? m_offset : 0; }
+    [[nodiscard]] std::size_t tailroom () const noexcept {
+      return m_block ? m_block->capacity - m_offset - m_length : 0;
+    }
+
+    [[nodiscard]] uint32_t use_count () const noexcept { return m_block ? m_block->refs : 0; }
+    [[nodiscard]] bool unique () const noexcept { return use_count () == 1; }
+
+    /**
+     * @brief Grow the window forward into the headroom (e.g. to add a header)
+     * @return The new leading bytes, or empty if shared or out of headroom
+     */
+    std::span<uint8_t> prepend (std::size_t count) noexcept {
+      if (!unique () || count > headroom ()) {
+        return {};
+      }
+      m_offset -= static_cast<uint32_t> (count);
+      m_length += static_cast<uint32_t> (count);
+      return { data (), count };
+    }
+
+    /**
+     * @brief Grow the window backward into the tailroom
+     * @return The new trailing bytes, or empty if shared or out of tailroom
+     */
+    std::span<uint8_t> append (std::size_t count) noexcept {
+      if (!unique () || count > tailroom ()) {
+        return {};
+      }
+      m_length += static_cast<uint32_t> (count);
+      return { end () - count, count };
+    }
+
+    bool append (std::span<const uint8_t> bytes) noexcept {
+      auto target = append (bytes.size ());
+      if (target.size () != bytes.size ()) {
+        return false;
+      }
+      if (!bytes.empty ()) {
+        std::memcpy (target.data (), bytes.data (), bytes.size ());
+      }
+      return true;
+    }
+
+    /**
+     * @brief Shrink the window from the front (e.g. after parsing a header)
+     */
+    void consume (std::size_t count) noexcept {
+      count = count < m_length ? count : m_length;
+      m_offset += static_cast<uint32_t> (count);
+      m_length -= static_cast<uint32_t> (count);
+    }
+
+    /**
+     * @brief Shrink the window from the back
+     */
+    void truncate (std::size_t length) noexcept {
+      if (length < m_length) {
+        m_length = static_cast<uint32_t> (length);
+      }
+    }
+
+    /**
+     * @brief Another handle on part of this window, sharing the block
+     */
+    [[nodiscard]] PacketBuffer slice (std::size_t offset, std::size_t length) const noexcept {
+      PacketBuffer view (*this);
+      offset = offset < m_length ? offset : m_length;
+      view.m_offset += static_cast<uint32_t> (offset);
+      view.m_length = static_cast<uint32_t> (length < m_length - offset ? length : m_length - offset);
+      return view;
+    }
+
+    /**
+     * @brief Reset the window to `headroom` bytes in and empty; sole owner only
+     */
+    bool rewind (std::size_t headroom) noexcept {
+      if (!unique () || headroom > m_block->capacity) {
+        return false;
+      }
+      m_offset = static_cast<uint32_t> (headroom);
+      m_length = 0;
+      return true;
+    }
+
+    friend bool operator== (const PacketBuffer& buffer, std::span<const uint8_t> bytes) noexcept {
+      return buffer.size () == bytes.size () && (bytes.empty () || std::memcmp (buffer.data (), bytes.data (), bytes.size ()) == 0);
+    }
+
+  private:
+    friend class PacketPool;
+
+    PacketBuffer (detail::PacketBlock* block, uint32_t offset) noexcept : m_block (block), m_offset (offset) {
+    }
+
+    detail::PacketBlock* m_block{ nullptr };
+    uint32_t m_offset{ 0 };
+    uint32_t m_length{ 0 };
+  };
+
+  /**
+   * @brief Pool counters
+   */
+  struct PacketPoolStats {
+    uint64_t slabs_allocated{ 0 };
+    uint64_t buffers_acquired{ 0 };
+    uint64_t oversize_acquired{ 0 }; // Larger than the pool's buffers: heap-allocated one-offs
+    std::size_t buffers_in_use{ 0 };
+    std::size_t buffers_free{ 0 };
+  };
+
+  /**
+   * @brief Slab allocator for PacketBuffers
+   *
+   * Buffers are carved from slabs of `buffers_per_slab` blocks and recycled
+   * through a free list, so once the pool has grown to the working set,
+   * acquiring and releasing buffers never touches the heap. Every buffer
+   * starts with `headroom` bytes free in front for headers.
+   *
+   * Buffers may outlive the pool: its memory is released when both the
+   * pool and its last outstanding buffer are gone. Not thread-safe.
+   */
+  class PacketPool {
+  public:
+    /**
+     * @param buffer_size Usable bytes per buffer after the headroom
+     * @param headroom Bytes reserved in front of each buffer
+     * @param buffers_per_slab Blocks allocated at a time when the pool runs dry
+     */
+    explicit PacketPool (std::size_t buffer_size = 1500, std::size_t headroom = 64, std::size_t buffers_per_slab = 256);
+    ~PacketPool ();
+
+    PacketPool (const PacketPool&) = delete;
+    PacketPool& operator= (const PacketPool&) = delete;
+
+    PacketPool (PacketPool&&) noexcept;
+    PacketPool& operator= (PacketPool&&) noexcept;
+
+    /**
+     * @brief Empty buffer with the default headroom and buffer_size() of tailroom
+     */
+    [[nodiscard]] PacketBuffer acquire ();
+
+    /**
+     * @brief Empty buffer with at least `size` bytes of tailroom
+     *
+     * Sizes above buffer_size() get a dedicated heap block.
+     */
+    [[nodiscard]] PacketBuffer acquire (std::size_t size);
+
+    /**
+     * @brief Buffer holding a copy of `bytes`
+     */
+    [[nodiscard]] PacketBuffer copy (std::span<const uint8_t> bytes);
+
+    /**
+     * @brief Grow the pool until at least `count` buffers are free
+     */
+    void reserve (std::size_t count);
+
+    [[nodiscard]] std::size_t buffer_size () const;
+    [[nodiscard]] std::size_t headroom () const;
+    [[nodiscard]] PacketPoolStats get_stats () const;
+
+  private:
+    detail::PacketPoolState* m_state;
+  };
+
+} // namespace OmniCpp::Engine::Network
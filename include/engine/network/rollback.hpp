@@ -0,0 +1,262 @@
+/**
+ * @file rollback.hpp
+ * @brief Input-prediction and rollback session for deterministic simulations
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace OmniCpp::Engine::Network {
+
+  /**
+   * @brief Rollback counters
+   */
+  struct RollbackStats {
+    uint64_t frames_advanced{ 0 };
+    uint64_t rollbacks{ 0 };
+    uint64_t frames_resimulated{ 0 };
+    uint64_t prediction_misses{ 0 };
+    uint64_t stalls{ 0 };            // advance() refused: too far ahead of remote input
+    uint32_t max_rollback_depth{ 0 };
+    double last_rollback_ms{ 0.0 };
+    double max_rollback_ms{ 0.0 };
+  };
+
+  /**
+   * @brief GGPO-style rollback over a deterministic step function
+   *
+   * Every frame the session saves the state, fills in missing remote input
+   * by repeating that player's last confirmed input, and steps. When a
+   * confirmed remote input disagrees with what was predicted, the next
+   * advance() restores the saved state at that frame and resimulates up to
+   * the present with corrected input.
+   *
+   * State and Input must be trivially copyable: snapshots are plain copies
+   * into fixed rings, so the session never allocates. MaxRollback bounds
+   * both the rewind depth and how far the local side may run ahead of
+   * unconfirmed remote input, which keeps a rollback's cost at MaxRollback
+   * steps at most; size it so that many steps fit in the frame budget.
+   *
+   * Input equality uses operator==.
+   */
+  template<typename State, typename Input, std::size_t Players = 2, std::size_t MaxRollback = 16>
+  class RollbackSession {
+    static_assert (std::is_trivially_copyable_v<State>, "Rollback state must be trivially copyable");
+    static_assert (std::is_trivially_copyable_v<Input>, "Rollback input must be trivially copyable");
+    static_assert (Players >= 1 && MaxRollback >= 1);
+
+  public:
+    using InputArray = std::array<Input, Players>;
+    using StepFunction = void (*) (State& state, const InputArray& inputs) noexcept;
+
+    static constexpr uint32_t NO_FRAME = UINT32_MAX;
+
+    /**
+     * @param initial State at frame 0
+     * @param step Deterministic step function
+     * @param local_player Index of the player fed through advance()
+     * @param input_delay Frames between sampling local input and simulating it
+     */
+    RollbackSession (const State& initial, StepFunction step, uint32_t local_player, uint32_t input_delay = 0)
+        : m_state (initial), m_step (step), m_local_player (local_player),
+          m_input_delay (input_delay < MaxRollback ? input_delay : MaxRollback - 1) {
+      for (auto& slot : m_inputs) {
+        slot.frame.fill (NO_FRAME);
+        slot.confirmed.fill (false);
+      }
+      // Frames inside the input delay run with default input on every peer
+      for (uint32_t frame = 0; frame < m_input_delay; ++frame) {
+        for (uint32_t player = 0; player < Players; ++player) {
+          store_input (player, frame, Input {}, true);
+        }
+      }
+    }
+
+    /**
+     * @brief Simulate one frame with the local player's input
+     * @return false if stalled waiting for remote input (state unchanged)
+     */
+    bool advance (const Input& local_input) {
+      apply_pending_rollback ();
+
+      if (confirmed_frame () + MaxRollback <= m_frame) {
+        ++m_stats.stalls;
+        return false;
+      }
+
+      store_input (m_local_player, m_frame + m_input_delay, local_input, true);
+      simulate_frame (m_frame);
+      ++m_frame;
+      ++m_stats.frames_advanced;
+      return true;
+    }
+
+    /**
+     * @brief Deliver a remote player's input for a frame
+     * @return false if the frame is outside the session window
+     */
+    bool add_remote_input (uint32_t player, uint32_t frame, const Input& input) {
+      if (player >= Players || player == m_local_player) {
+        return false;
+      }
+      const uint32_t oldest = m_frame > MaxRollback ? m_frame - MaxRollback : 0;
+      if (frame < oldest || frame >= m_frame + INPUT_WINDOW - MaxRollback) {
+        return false;
+      }
+
+      auto& slot = m_inputs[frame % INPUT_WINDOW];
+      if (slot.frame[player] == frame && slot.confirmed[player]) {
+        return true; // Duplicate
+      }
+
+      const bool simulated = frame < m_frame;
+      if (simulated && !(slot.values[player] == input)) {
+        ++m_stats.prediction_misses;
+        if (m_rollback_frame == NO_FRAME || frame < m_rollback_frame) {
+          m_rollback_frame = frame;
+        }
+      }
+      store_input (player, frame, input, true);
+      return true;
+    }
+
+    /**
+     * @brief Oldest frame still missing some remote input
+     *
+     * Everything before it is final and will never be rolled back.
+     */
+    [[nodiscard]] uint32_t confirmed_frame () const {
+      uint32_t frame = m_frame > MaxRollback ? m_frame - MaxRollback : 0;
+      frame = frame > m_confirmed_hint ? frame : m_confirmed_hint;
+      while (frame < m_frame + INPUT_WINDOW - MaxRollback && all_confirmed (frame)) {
+        ++frame;
+      }
+      m_confirmed_hint = frame;
+      return frame;
+    }
+
+    /**
+     * @brief The input the simulation used (or will use) for a frame
+     */
+    [[nodiscard]] const Input* get_input (uint32_t player, uint32_t frame) const {
+      const auto& slot = m_inputs[frame % INPUT_WINDOW];
+      return player < Players && slot.frame[player] == frame ? &slot.values[player] : nullptr;
+    }
+
+    /**
+     * @brief Saved state at the start of `frame`, if still in the ring
+     */
+    [[nodiscard]] const State* get_saved_state (uint32_t frame) const {
+      const auto& saved = m_states[frame % STATE_WINDOW];
+      return saved.frame == frame ? &saved.state : nullptr;
+    }
+
+    [[nodiscard]] const State& get_state () const { return m_state; }
+    [[nodiscard]] uint32_t get_frame () const { return m_frame; }
+    [[nodiscard]] uint32_t get_local_player () const { return m_local_player; }
+    [[nodiscard]] uint32_t get_input_delay () const { return m_input_delay; }
+    [[nodiscard]] const RollbackStats& get_stats () const { return m_stats; }
+
+  private:
+    static constexpr std::size_t STATE_WINDOW = MaxRollback + 1;
+    static constexpr std::size_t INPUT_WINDOW = 2 * MaxRollback + 2;
+
+    struct InputSlot {
+      InputArray values{};
+      std::array<uint32_t, Players> frame{};
+      std::array<bool, Players> confirmed{};
+    };
+
+    struct SavedState {
+      State state;
+      uint32_t frame{ NO_FRAME };
+    };
+
+    void store_input (uint32_t player, uint32_t frame, const Input& input, bool confirmed) {
+      auto& slot = m_inputs[frame % INPUT_WINDOW];
+      slot.values[player] = input;
+      slot.frame[player] = frame;
+      slot.confirmed[player] = confirmed;
+    }
+
+    [[nodiscard]] bool all_confirmed (uint32_t frame) const {
+      const auto& slot = m_inputs[frame % INPUT_WINDOW];
+      for (uint32_t player = 0; player < Players; ++player) {
+        if (slot.frame[player] != frame || !slot.confirmed[player]) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Repeat the newest confirmed input before `frame` (default input if none)
+    [[nodiscard]] Input predict (uint32_t player, uint32_t frame) const {
+      const uint32_t oldest = frame > INPUT_WINDOW - 1 ? frame - (INPUT_WINDOW - 1) : 0;
+      for (uint32_t f = frame; f-- > oldest;) {
+        const auto& slot = m_inputs[f % INPUT_WINDOW];
+        if (slot.frame[player] == f && slot.confirmed[player]) {
+          return slot.values[player];
+        }
+      }
+      return Input {};
+    }
+
+    void simulate_frame (uint32_t frame) {
+      auto& slot = m_inputs[frame % INPUT_WINDOW];
+      for (uint32_t player = 0; player < Players; ++player) {
+        if (slot.frame[player] != frame || !slot.confirmed[player]) {
+          store_input (player, frame, predict (player, frame), false);
+        }
+      }
+
+      auto& saved = m_states[frame % STATE_WINDOW];
+      saved.state = m_state;
+      saved.frame = frame;
+      m_step (m_state, slot.values);
+    }
+
+    void apply_pending_rollback () {
+      if (m_rollback_frame == NO_FRAME) {
+        return;
+      }
+      const uint32_t from = m_rollback_frame;
+      m_rollback_frame = NO_FRAME;
+
+      const State* saved = get_saved_state (from);
+      if (!saved) {
+        return; // Cannot happen while stalls keep unconfirmed frames in the ring
+      }
+
+      const auto start = std::chrono::steady_clock::now ();
+      m_state = *saved;
+      for (uint32_t frame = from; frame < m_frame; ++frame) {
+        simulate_frame (frame);
+      }
+      const double elapsed = std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+
+      const uint32_t depth = m_frame - from;
+      ++m_stats.rollbacks;
+      m_stats.frames_resimulated += depth;
+      m_stats.max_rollback_depth = depth > m_stats.max_rollback_depth ? depth : m_stats.max_rollback_depth;
+      m_stats.last_rollback_ms = elapsed;
+      m_stats.max_rollback_ms = elapsed > m_stats.max_rollback_ms ? elapsed : m_stats.max_rollback_ms;
+    }
+
+    State m_state;
+    StepFunction m_step;
+    uint32_t m_local_player;
+    uint32_t m_input_delay;
+    uint32_t m_frame{ 0 };
+    uint32_t m_rollback_frame{ NO_FRAME };
+    mutable uint32_t m_confirmed_hint{ 0 };
+    std::array<SavedState, STATE_WINDOW> m_states{};
+    std::array<InputSlot, INPUT_WINDOW> m_inputs{};
+    RollbackStats m_stats;
+  };
+
+} // namespace OmniCpp::Engine::Network
@@ -0,0 +1,153 @@
+/**
+ * @file server_loop.hpp
+ * @brief Sharded io_uring/epoll datagram loop for dedicated servers
+ */
+
+#pragma once
+
+#include "engine/network/udp_socket.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace OmniCpp::Engine::Network {
+
+  /**
+   * @brief Kernel interface a shard waits on
+   */
+  enum class ServerBackend : uint8_t {
+    Auto,    // io_uring when the kernel supports multishot receive, else epoll
+    IoUring,
+    Epoll
+  };
+
+  [[nodiscard]] const char* to_string (ServerBackend backend);
+
+  /**
+   * @brief Server loop configuration
+   */
+  struct ServerLoopConfig {
+    uint16_t port{ 0 };
+    std::string bind_address{ "0.0.0.0" };
+    std::size_t shard_count{ 0 };      // 0 = one per hardware thread
+    ServerBackend backend{ ServerBackend::Auto };
+    bool pin_threads{ true };          // Shard i runs on CPU i % CPU count
+    bool steer_by_cpu{ false };        // Deliver each datagram to the shard of the CPU that received it
+    std::size_t batch_size{ 64 };      // Datagrams per recvmmsg/sendmmsg
+    std::size_t buffer_count{ 1024 };  // Registered receive buffers per shard (rounded up to a power of two)
+    std::size_t buffer_size{ 2048 };   // Bytes per receive buffer, including the io_uring message header
+    std::size_t socket_buffer_size{ 4 * 1024 * 1024 };
+  };
+
+  /**
+   * @brief Per-shard counters
+   */
+  struct ServerShardStats {
+    uint64_t datagrams_received{ 0 };
+    uint64_t bytes_received{ 0 };
+    uint64_t datagrams_sent{ 0 };
+    uint64_t send_failures{ 0 };
+    uint64_t wakeups{ 0 };            // Returns from epoll_wait / io_uring_enter
+    uint64_t buffers_exhausted{ 0 };  // Multishot receives stopped for lack of registered buffers
+  };
+
+  /**
+   * @brief One shard's socket and thread, handed to the datagram handler
+   *
+   * Everything a handler does through its shard stays on the shard's thread,
+   * so per-connection state kept per shard needs no locking.
+   */
+  class ServerShard {
+  public:
+    ~ServerShard ();
+
+    ServerShard (const ServerShard&) = delete;
+    ServerShard& operator= (const ServerShard&) = delete;
+
+    [[nodiscard]] std::size_t index () const;
+    [[nodiscard]] ServerBackend backend () const;
+
+    /**
+     * @brief Queue a datagram; queued datagrams go out in one batch after the handler returns
+     * @return false if the datagram is larger than the shard's buffers
+     */
+    bool send (const Endpoint& destination, std::span<const uint8_t> data);
+
+  private:
+    friend class ServerLoop;
+
+    struct Impl;
+    explicit ServerShard (std::unique_ptr<Impl> impl);
+    std::unique_ptr<Impl> m_impl;
+  };
+
+  /**
+   * @brief Called on a shard's thread for every received datagram
+   *
+   * `data` is only valid for the duration of the call.
+   */
+  using DatagramHandler = std::function<void (ServerShard& shard, const Endpoint& from, std::span<const uint8_t> data)>;
+
+  /**
+   * @brief Multi-threaded UDP server loop (Linux)
+   *
+   * Each shard owns a socket bound to the same port with SO_REUSEPORT and a
+   * thread that waits on it. The kernel picks the socket by hashing the
+   * sender's address, so a client keeps landing on the same shard for as
+   * long as the loop runs; with steer_by_cpu a BPF program picks the shard
+   * of the receiving CPU instead, which keeps a flow on one core end to end
+   * when NIC queues are spread over CPUs.
+   *
+   * The io_uring backend keeps one multishot recvmsg armed per shard,
+   * filling buffers from a ring registered with the kernel, so steady
+   * traffic needs no receive syscalls at all beyond the wait. The epoll
+   * backend drains the socket with recvmmsg on every wakeup. Replies queued
+   * through ServerShard::send go out with sendmmsg after each batch.
+   */
+  class ServerLoop {
+  public:
+    ServerLoop ();
+    ~ServerLoop ();
+
+    ServerLoop (const ServerLoop&) = delete;
+    ServerLoop& operator= (const ServerLoop&) = delete;
+
+    ServerLoop (ServerLoop&&) noexcept;
+    ServerLoop& operator= (ServerLoop&&) noexcept;
+
+    /**
+     * @brief Bind every shard and start their threads
+     * @return false if a socket could not be bound or the platform is unsupported
+     */
+    bool start (const ServerLoopConfig& config, DatagramHandler handler);
+
+    /**
+     * @brief Wake and join every shard
+     */
+    void stop ();
+
+    [[nodiscard]] bool is_running () const;
+    [[nodiscard]] uint16_t get_local_port () const;
+    [[nodiscard]] std::size_t get_shard_count () const;
+
+    /**
+     * @brief Backend shard 0 ended up on (shards fall back to epoll individually)
+     */
+    [[nodiscard]] ServerBackend get_backend () const;
+
+    /**
+     * @brief Counter snapshot, safe to call while running
+     */
+    [[nodiscard]] ServerShardStats get_stats () const;
+    [[nodiscard]] std::vector<ServerShardStats> get_shard_stats () const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+} // namespace OmniCpp::Engine::Network
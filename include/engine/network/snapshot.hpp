@@ -0,0 +1,189 @@
+/**
+ * @file snapshot.hpp
+ * @brief Quantized transform snapshots with delta compression
+ */
+
+#pragma once
+
+#include "engine/ecs/TransformComponent.hpp"
+#include "engine/network/bit_stream.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace OmniCpp::Engine::Network {
+
+  /**
+   * @brief Replicated subset of an entity's TransformComponent
+   */
+  struct TransformState {
+    uint32_t entity_id{ 0 };
+    omnicpp::math::Vec3 position{ 0.0f, 0.0f, 0.0f };
+    omnicpp::math::Vec3 rotation{ 0.0f, 0.0f, 0.0f }; // Euler degrees
+    omnicpp::math::Vec3 scale{ 1.0f, 1.0f, 1.0f };
+  };
+
+  [[nodiscard]] inline TransformState capture_transform (const omnicpp::ecs::TransformComponent& transform) {
+    return { static_cast<uint32_t> (transform.get_entity_id ()), transform.get_position (), transform.get_rotation (),
+      transform.get_scale () };
+  }
+
+  inline void apply_transform (const TransformState& state, omnicpp::ecs::TransformComponent& transform) {
+    transform.set_position (state.position);
+    transform.set_rotation (state.rotation);
+    transform.set_scale (state.scale);
+  }
+
+  /**
+   * @brief Ranges and resolutions used to quantize transforms
+   *
+   * Both ends must use the same values. Rotations are wrapped to [0, 360).
+   */
+  struct SnapshotQuantization {
+    float position_min{ -4096.0f };
+    float position_max{ 4096.0f };
+    float position_resolution{ 0.001f };
+    float rotation_resolution{ 0.01f };
+    float scale_min{ 0.0f };
+    float scale_max{ 64.0f };
+    float scale_resolution{ 0.001f };
+    uint32_t small_delta_bits{ 8 }; // Per-axis deltas that fit (zigzagged) use this width
+  };
+
+  /**
+   * @brief Per-field change mask bits
+   */
+  enum TransformField : uint8_t {
+    TRANSFORM_POSITION = 1 << 0,
+    TRANSFORM_ROTATION = 1 << 1,
+    TRANSFORM_SCALE = 1 << 2,
+  };
+
+  inline constexpr uint32_t TRANSFORM_FIELD_COUNT = 3;
+
+  /**
+   * @brief One entity in quantized form: position, rotation, scale x/y/z steps
+   */
+  struct QuantizedTransform {
+    uint32_t entity_id{ 0 };
+    std::array<uint32_t, TRANSFORM_FIELD_COUNT * 3> values{};
+
+    [[nodiscard]] bool operator== (const QuantizedTransform&) const = default;
+  };
+
+  /**
+   * @brief World state at one tick, sorted by entity id
+   *
+   * Kept quantized so the encoder diffs exactly what the decoder will hold.
+   */
+  struct Snapshot {
+    uint32_t tick{ 0 };
+    std::vector<QuantizedTransform> entities;
+  };
+
+  /**
+   * @brief Quantization and delta encoding of snapshots
+   *
+   * Wire format (bit-packed):
+   *   tick:varint has_baseline:1 [tick - baseline:varint]
+   *   changed:varint { id_delta:varint [is_new:1] (full | mask:3 { per axis small:1 value }) }
+   *   removed:varint { id_delta:varint }
+   * Entities unchanged since the baseline are omitted; without a baseline
+   * every entity is sent in full.
+   */
+  class SnapshotCodec {
+  public:
+    explicit SnapshotCodec (const SnapshotQuantization& quantization = {});
+
+    void quantize (uint32_t tick, std::span<const TransformState> states, Snapshot& out) const;
+    void dequantize (const Snapshot& snapshot, std::vector<TransformState>& out) const;
+
+    /**
+     * @brief Encode `current` as a delta against `baseline` (nullptr = full)
+     * @return false if the writer overflowed
+     */
+    bool encode (const Snapshot& current, const Snapshot* baseline, BitWriter& writer) const;
+
+    /**
+     * @brief Read the tick and baseline tick without decoding the body
+     */
+    static bool peek_header (std::span<const uint8_t> data, uint32_t& tick, std::optional<uint32_t>& baseline_tick);
+
+    /**
+     * @brief Decode a snapshot; `baseline` must be the one named in the header
+     * @return false on malformed input or a missing baseline
+     */
+    bool decode (BitReader& reader, const Snapshot* baseline, Snapshot& out) const;
+
+    [[nodiscard]] const SnapshotQuantization& get_quantization () const { return m_quantization; }
+
+  private:
+    void write_full (BitWriter& writer, const QuantizedTransform& entity) const;
+    void read_full (BitReader& reader, QuantizedTransform& entity) const;
+
+    SnapshotQuantization m_quantization;
+    std::array<uint32_t, TRANSFORM_FIELD_COUNT> m_steps{};
+    std::array<uint32_t, TRANSFORM_FIELD_COUNT> m_bits{};
+  };
+
+  /**
+   * @brief Server side of one client's snapshot stream
+   *
+   * Remembers recently sent snapshots; each new one is encoded against the
+   * newest snapshot the client has acknowledged, falling back to a full
+   * snapshot when that baseline has left the history.
+   */
+  class SnapshotSender {
+  public:
+    explicit SnapshotSender (const SnapshotCodec& codec, std::size_t history_size = 32);
+
+    /**
+     * @brief Encode and remember a snapshot
+     * @return Bytes written to `out`, or 0 if it did not fit
+     */
+    std::size_t encode (const Snapshot& snapshot, std::span<uint8_t> out);
+
+    /**
+     * @brief Record that the client holds the snapshot for `tick`
+     */
+    void acknowledge (uint32_t tick);
+
+    [[nodiscard]] std::optional<uint32_t> get_baseline_tick () const;
+
+  private:
+    [[nodiscard]] const Snapshot* find (uint32_t tick) const;
+
+    const SnapshotCodec& m_codec;
+    std::vector<std::optional<Snapshot>> m_history;
+    std::optional<uint32_t> m_acked_tick;
+  };
+
+  /**
+   * @brief Client side of a snapshot stream
+   *
+   * Keeps decoded snapshots so later deltas can reference them; acknowledge
+   * the returned tick back to the server.
+   */
+  class SnapshotReceiver {
+  public:
+    explicit SnapshotReceiver (const SnapshotCodec& codec, std::size_t history_size = 32);
+
+    /**
+     * @brief Decode a snapshot payload
+     * @return false if malformed or its baseline is no longer held
+     */
+    bool decode (std::span<const uint8_t> data, Snapshot& out);
+
+    [[nodiscard]] const Snapshot* get_latest () const;
+
+  private:
+    [[nodiscard]] const Snapshot* find (uint32_t tick) const;
+
+    const SnapshotCodec& m_codec;
+    std::vector<std::optional<Snapshot>> m_history;
+    std::optional<uint32_t> m_latest_tick;
+  };
+
+} // namespace OmniCpp::Engine::Network
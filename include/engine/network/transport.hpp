@@ -0,0 +1,210 @@
+/**
+ * @file transport.hpp
+ * @brief Connection-oriented UDP transport with reliability channels
+ */
+
+#pragma once
+
+#include "engine/network/network_conditioner.hpp"
+#include "engine/network/packet_buffer.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace OmniCpp::Engine::Network {
+
+  using ConnectionId = uint32_t;
+
+  /**
+   * @brief Delivery guarantees of a message
+   */
+  enum class Channel : uint8_t {
+    Unreliable = 0,        // Sent once, may be lost, duplicated packets are dropped
+    ReliableOrdered = 1,   // Resent until acked, delivered in send order
+    ReliableUnordered = 2, // Resent until acked, delivered as soon as it arrives
+  };
+
+  inline constexpr std::size_t CHANNEL_COUNT = 3;
+
+  /**
+   * @brief Transport configuration structure
+   */
+  struct TransportConfig {
+    uint16_t port{ 0 };                 // Local port (0 = ephemeral)
+    std::string bind_address{ "0.0.0.0" };
+    bool accept_connections{ false };   // Act as a server
+    uint32_t max_connections{ 32 };
+    uint32_t protocol_id{ 0x4F4D4E49 }; // Packets with another id are ignored
+    uint16_t mtu{ 1200 };               // Largest datagram payload sent
+    std::size_t max_message_size{ 64 * 1024 };
+    std::size_t max_reassembly_bytes{ 1 << 20 }; // Incomplete fragments per connection; over it the peer is dropped
+    std::size_t batch_size{ 64 };       // Datagrams per recvmmsg/sendmmsg
+    std::size_t socket_buffer_size{ 1 << 20 };
+    std::chrono::milliseconds connection_timeout{ 5000 };
+    std::chrono::milliseconds connect_retry_interval{ 100 };
+    std::chrono::milliseconds keepalive_interval{ 100 };
+    std::chrono::milliseconds min_resend_timeout{ 10 };
+    NetworkConditionerConfig conditioner;  // Impairs outgoing datagrams when enabled (testing only)
+  };
+
+  /**
+   * @brief Message delivered to the application
+   *
+   * `data` is a view into the received datagram's pooled buffer (no copy);
+   * holding it keeps that buffer out of the pool.
+   */
+  struct Message {
+    ConnectionId connection{ 0 };
+    Channel channel{ Channel::Unreliable };
+    PacketBuffer data;
+  };
+
+  /**
+   * @brief Connection state change
+   */
+  struct TransportEvent {
+    enum class Type : uint8_t { Connected, Disconnected };
+    Type type{ Type::Connected };
+    ConnectionId connection{ 0 };
+  };
+
+  /**
+   * @brief Transport-wide counters
+   */
+  struct TransportStats {
+    uint64_t packets_sent{ 0 };
+    uint64_t packets_received{ 0 };
+    uint64_t bytes_sent{ 0 };
+    uint64_t bytes_received{ 0 };
+    uint64_t messages_sent{ 0 };
+    uint64_t messages_received{ 0 };
+    uint64_t fragments_sent{ 0 };
+    uint64_t resends{ 0 };
+    uint64_t packets_acked{ 0 };
+    uint64_t duplicates_dropped{ 0 };
+    uint64_t invalid_packets{ 0 };
+    uint64_t reassembly_expired{ 0 };   // Fragment groups given up after a timeout
+    uint64_t reassembly_overflows{ 0 }; // Connections dropped for exceeding max_reassembly_bytes
+    uint64_t send_syscalls{ 0 };
+    uint64_t receive_syscalls{ 0 };
+  };
+
+  /**
+   * @brief UDP transport with per-connection reliability
+   *
+   * Every datagram carries a packet sequence number plus an ack and a 32-bit
+   * ack field for the peer's most recent packets. Messages queued with send()
+   * are coalesced into MTU-sized packets on update(); reliable messages stay
+   * queued until a packet carrying them is acked and are resent after an
+   * RTT-derived timeout. Messages larger than one packet are split into
+   * fragments and reassembled before delivery; incomplete fragment groups
+   * time out on every channel, and a peer whose open groups exceed
+   * max_reassembly_bytes is disconnected. Payloads live in pooled
+   * buffers: packets are sent scatter-gather straight from them and
+   * received messages are slices of the received datagram, so steady
+   * traffic allocates nothing per packet. One Transport can both accept
+   * connections and open outgoing ones. Not thread-safe: drive it from one
+   * thread.
+   */
+  class Transport {
+  public:
+    Transport ();
+    ~Transport ();
+
+    Transport (const Transport&) = delete;
+    Transport& operator= (const Transport&) = delete;
+
+    Transport (Transport&&) noexcept;
+    Transport& operator= (Transport&&) noexcept;
+
+    /**
+     * @brief Bind the socket
+     * @param config Transport configuration
+     * @return true if successful, false otherwise
+     */
+    bool initialize (const TransportConfig& config);
+
+    /**
+     * @brief Disconnect every peer and close the socket
+     */
+    void shutdown ();
+
+    /**
+     * @brief Receive, process timers and flush queued messages
+     */
+    void update ();
+
+    /**
+     * @brief Start a connection handshake
+     * @return Connection id; a Connected event follows once the peer accepts
+     */
+    std::optional<ConnectionId> connect (const std::string& host, uint16_t port);
+
+    /**
+     * @brief Close a connection, notifying the peer
+     */
+    void disconnect (ConnectionId connection);
+
+    /**
+     * @brief Queue a message; it is sent on the next update()
+     * @return false if the connection is unknown, the message is too large or
+     *         the channel's send window is full
+     */
+    bool send (ConnectionId connection, Channel channel, std::span<const uint8_t> data);
+
+    /**
+     * @brief Queue a message built in a buffer from acquire_buffer()
+     *
+     * When the message fits one packet its header is written into the
+     * buffer's headroom and the buffer itself is sent, without copying.
+     */
+    bool send (ConnectionId connection, Channel channel, PacketBuffer data);
+
+    /**
+     * @brief Empty pooled buffer with headroom for the message header
+     */
+    [[nodiscard]] PacketBuffer acquire_buffer ();
+
+    /**
+     * @brief Pop the next received message
+     */
+    bool poll_message (Message& out);
+
+    /**
+     * @brief Pop the next connection event
+     */
+    bool poll_event (TransportEvent& out);
+
+    [[nodiscard]] bool is_connected (ConnectionId connection) const;
+    [[nodiscard]] std::size_t get_connection_count () const;
+    [[nodiscard]] std::vector<ConnectionId> get_connections () const;
+
+    /**
+     * @brief Smoothed round-trip time of a connection in milliseconds
+     */
+    [[nodiscard]] double get_rtt_ms (ConnectionId connection) const;
+
+    [[nodiscard]] uint16_t get_local_port () const;
+    [[nodiscard]] TransportStats get_stats () const;
+
+    /**
+     * @brief Change outgoing network impairments at runtime
+     *
+     * Disabling releases datagrams still held by the conditioner on the next
+     * update().
+     */
+    void set_conditioner (const NetworkConditionerConfig& config);
+
+    [[nodiscard]] NetworkConditionerStats get_conditioner_stats () const;
+    [[nodiscard]] PacketPoolStats get_pool_stats () const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+} // namespace OmniCpp::Engine::Network
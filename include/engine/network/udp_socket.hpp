@@ -0,0 +1,259 @@
+/**
+ * @file udp_socket.hpp
+ * @brief Non-blocking UDP socket with batched send and receive
+ */
+
+#pragma once
+
+#include "engine/network/packet_buffer.hpp"
+#include <asio/ip/udp.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace OmniCpp::Engine::Network {
+
+  using Endpoint = asio::ip::udp::endpoint;
+
+  /**
+   * @brief Fixed-capacity set of datagrams moved by one batched syscall
+   *
+   * Storage is allocated once; receive fills slots in place and senders
+   * build packets directly into the slot returned by prepare().
+   */
+  class DatagramBatch {
+  public:
+    explicit DatagramBatch (std::size_t capacity = 64, std::size_t max_datagram_size = 1500);
+
+    [[nodiscard]] std::size_t capacity () const noexcept { return m_endpoints.size (); }
+    [[nodiscard]] std::size_t size () const noexcept { return m_count; }
+    [[nodiscard]] bool full () const noexcept { return m_count == m_endpoints.size (); }
+    [[nodiscard]] std::size_t max_datagram_size () const noexcept { return m_max_size; }
+    void clear () noexcept { m_count = 0; }
+
+    /**
+     * @brief Reserve the next slot for an outgoing datagram
+     * @return Writable buffer of max_datagram_size() bytes, or empty if full
+     */
+    std::span<uint8_t> prepare (const Endpoint& destination);
+
+    /**
+     * @brief Finish the slot returned by prepare()
+     */
+    void commit (std::size_t length);
+
+    [[nodiscard]] std::span<const uint8_t> data (std::size_t i) const;
+    [[nodiscard]] const Endpoint& endpoint (std::size_t i) const { return m_endpoints[i]; }
+
+    // Raw slot access for socket backends
+    [[nodiscard]] uint8_t* slot (std::size_t i) noexcept { return m_storage.data () + i * m_max_size; }
+    [[nodiscard]] Endpoint& slot_endpoint (std::size_t i) noexcept { return m_endpoints[i]; }
+    void set_slot_length (std::size_t i, std::size_t length) noexcept { m_lengths[i] = length; }
+    void set_size (std::size_t count) noexcept { m_count = count; }
+
+  private:
+    std::vector<uint8_t> m_storage;
+    std::vector<Endpoint> m_endpoints;
+    std::vector<std::size_t> m_lengths;
+    std::size_t m_max_size;
+    std::size_t m_count{ 0 };
+  };
+
+  /**
+   * @brief Outgoing datagrams assembled from shared buffers (scatter-gather)
+   *
+   * Each datagram is a small header written into batch-owned storage
+   * followed by any number of PacketBuffer segments, which are referenced
+   * rather than copied; the kernel gathers them with one iovec each.
+   * Segment handles are kept until clear(), so the buffers stay valid
+   * until the batch has been sent.
+   */
+  class GatherBatch {
+  public:
+    static constexpr std::size_t HEADER_CAPACITY = 32;
+
+    /**
+     * @param capacity Datagrams per batch
+     * @param max_segments Segments across all datagrams in the batch
+     */
+    explicit GatherBatch (std::size_t capacity = 64, std::size_t max_segments = 1024);
+
+    [[nodiscard]] std::size_t capacity () const noexcept { return m_endpoints.size (); }
+    [[nodiscard]] std::size_t size () const noexcept { return m_count; }
+    [[nodiscard]] bool full () const noexcept { return m_count == m_endpoints.size (); }
+    [[nodiscard]] std::size_t segment_room () const noexcept { return m_segments.size () - m_segment_count; }
+
+    /**
+     * @brief Drop every datagram and release the segment references
+     */
+    void clear () noexcept;
+
+    /**
+     * @brief Start a datagram
+     * @return HEADER_CAPACITY bytes for the datagram header, or empty if full
+     */
+    std::span<uint8_t> begin_datagram (const Endpoint& destination);
+
+    /**
+     * @brief Append a segment to the open datagram
+     * @return false if the batch is out of segment slots
+     */
+    bool add_segment (const PacketBuffer& segment);
+
+    /**
+     * @brief Finish the open datagram
+     * @param header_length Bytes used of the span returned by begin_datagram()
+     */
+    void end_datagram (std::size_t header_length);
+
+    [[nodiscard]] const Endpoint& endpoint (std::size_t i) const { return m_endpoints[i]; }
+    [[nodiscard]] std::span<const uint8_t> header (std::size_t i) const {
+      return { m_headers[i].data (), m_header_lengths[i] };
+    }
+    [[nodiscard]] std::span<const PacketBuffer> segments (std::size_t i) const {
+      return { m_segments.data () + m_first_segment[i], m_segment_counts[i] };
+    }
+
+    /**
+     * @brief Total bytes of datagram i (header plus segments)
+     */
+    [[nodiscard]] std::size_t datagram_size (std::size_t i) const;
+
+    /**
+     * @brief Flatten datagram i into `out`
+     * @return Bytes written (truncated to out.size())
+     */
+    std::size_t copy_datagram (std::size_t i, std::span<uint8_t> out) const;
+
+  private:
+    std::vector<Endpoint> m_endpoints;
+    std::vector<std::array<uint8_t, HEADER_CAPACITY>> m_headers;
+    std::vector<uint32_t> m_header_lengths;
+    std::vector<uint32_t> m_first_segment;
+    std::vector<uint32_t> m_segment_counts;
+    std::vector<PacketBuffer> m_segments;
+    std::size_t m_segment_count{ 0 };
+    std::size_t m_count{ 0 };
+    bool m_open{ false };
+  };
+
+  /**
+   * @brief Incoming datagrams received straight into pooled buffers
+   *
+   * Handlers may keep datagram(i) (or slices of it) past the next receive:
+   * before every receive, slots whose buffer is still referenced elsewhere
+   * get a fresh one from the pool instead of being overwritten.
+   */
+  class ReceiveBatch {
+  public:
+    explicit ReceiveBatch (PacketPool& pool, std::size_t capacity = 64);
+
+    [[nodiscard]] std::size_t capacity () const noexcept { return m_endpoints.size (); }
+    [[nodiscard]] std::size_t size () const noexcept { return m_count; }
+    [[nodiscard]] bool full () const noexcept { return m_count == m_endpoints.size (); }
+    void clear () noexcept { m_count = 0; }
+
+    [[nodiscard]] const Endpoint& endpoint (std::size_t i) const { return m_endpoints[i]; }
+    [[nodiscard]] const PacketBuffer& datagram (std::size_t i) const { return m_buffers[i]; }
+
+    /**
+     * @brief Give every slot an empty, sole-owned buffer
+     */
+    void prepare ();
+
+    // Raw slot access for socket backends (valid after prepare())
+    [[nodiscard]] std::size_t max_datagram_size () const noexcept { return m_max_size; }
+    [[nodiscard]] uint8_t* slot (std::size_t i) noexcept { return m_buffers[i].data (); }
+    [[nodiscard]] Endpoint& slot_endpoint (std::size_t i) noexcept { return m_endpoints[i]; }
+    void set_slot_length (std::size_t i, std::size_t length) noexcept { m_buffers[i].append (length); }
+    void set_size (std::size_t count) noexcept { m_count = count; }
+
+  private:
+    PacketPool& m_pool;
+    std::vector<PacketBuffer> m_buffers;
+    std::vector<Endpoint> m_endpoints;
+    std::size_t m_max_size;
+    std::size_t m_count{ 0 };
+  };
+
+  /**
+   * @brief Syscall counters for a socket
+   */
+  struct UdpSocketStats {
+    uint64_t receive_calls{ 0 };
+    uint64_t send_calls{ 0 };
+    uint64_t datagrams_received{ 0 };
+    uint64_t datagrams_sent{ 0 };
+    uint64_t send_failures{ 0 };
+  };
+
+  /**
+   * @brief IPv4 UDP socket on asio
+   *
+   * Uses recvmmsg/sendmmsg on Linux so one syscall moves a whole batch;
+   * other platforms fall back to a receive_from/send_to loop. All calls are
+   * non-blocking. Both paths accept plain DatagramBatches and the
+   * zero-copy ReceiveBatch / GatherBatch.
+   */
+  class UdpSocket {
+  public:
+    UdpSocket ();
+    ~UdpSocket ();
+
+    UdpSocket (const UdpSocket&) = delete;
+    UdpSocket& operator= (const UdpSocket&) = delete;
+
+    UdpSocket (UdpSocket&&) noexcept;
+    UdpSocket& operator= (UdpSocket&&) noexcept;
+
+    /**
+     * @brief Bind to a local port
+     * @param port Port to bind (0 = ephemeral)
+     * @param bind_address Local address to bind
+     * @param buffer_size Kernel send/receive buffer size in bytes (0 = default)
+     * @return true if successful, false otherwise
+     */
+    bool open (uint16_t port, const std::string& bind_address = "0.0.0.0", std::size_t buffer_size = 0);
+    void close ();
+    [[nodiscard]] bool is_open () const;
+
+    /**
+     * @brief Receive as many pending datagrams as fit in the batch
+     * @return Number of datagrams received (batch is overwritten)
+     */
+    std::size_t receive (DatagramBatch& batch);
+
+    /**
+     * @brief Receive into pooled buffers without copying
+     */
+    std::size_t receive (ReceiveBatch& batch);
+
+    /**
+     * @brief Send every datagram in the batch
+     * @return Number of datagrams handed to the kernel
+     */
+    std::size_t send (const DatagramBatch& batch);
+
+    /**
+     * @brief Send scatter-gather datagrams (one sendmsg iovec per segment)
+     */
+    std::size_t send (const GatherBatch& batch);
+
+    /**
+     * @brief Resolve a host name to an IPv4 endpoint
+     */
+    bool resolve (const std::string& host, uint16_t port, Endpoint& out);
+
+    [[nodiscard]] uint16_t get_local_port () const;
+    [[nodiscard]] const UdpSocketStats& get_stats () const;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+} // namespace OmniCpp::Engine::Network
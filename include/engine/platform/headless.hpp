@@ -0,0 +1,90 @@
+/**
+ * @file headless.hpp
+ * @brief Null renderer and audio backends for headless/server runs
+ */
+
+#pragma once
+
+#include "engine/IAudioManager.hpp"
+#include "engine/IRenderer.hpp"
+#include "engine/graphics/frame_capture.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace OmniCpp::Engine::Platform {
+
+  /**
+   * @brief Null renderer configuration structure
+   */
+  struct NullRendererConfig {
+    uint32_t width{ 1280 }; // Size of the back buffer that is never drawn
+    uint32_t height{ 720 };
+    std::array<uint8_t, 4> clear_color{ 0, 0, 0, 255 }; // RGBA8 contents of every captured frame
+    bool enable_frame_capture{ false };
+    Graphics::FrameCaptureConfig capture;
+  };
+
+  /**
+   * @brief Renderer that touches no window system or GPU
+   *
+   * Counts frames so pacing and frame-indexed logic behave as they would
+   * with a real swap chain. Frame captures go through the same
+   * FrameCaptureRing as the Vulkan renderer, using host slots filled with
+   * the clear color, so capture consumers can run headless.
+   */
+  class NullRenderer final : public omnicpp::IRenderer {
+  public:
+    explicit NullRenderer (const NullRendererConfig& config = {});
+    ~NullRenderer () override;
+
+    NullRenderer (const NullRenderer&) = delete;
+    NullRenderer& operator= (const NullRenderer&) = delete;
+
+    bool initialize () override;
+    void shutdown () override;
+    bool begin_frame () override;
+    void end_frame () override;
+    [[nodiscard]] uint32_t get_frame_number () const override;
+
+    /**
+     * @brief Arm capture of the next ended frames
+     * @param frame_count Number of consecutive frames to capture
+     */
+    void request_frame_capture (uint32_t frame_count = 1);
+    [[nodiscard]] Graphics::FrameCaptureRing& get_frame_capture ();
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+  /**
+   * @brief Audio manager that opens no device
+   *
+   * Hands out sound IDs and tracks volume so gameplay code paths run
+   * unchanged on servers.
+   */
+  class NullAudioManager final : public omnicpp::IAudioManager {
+  public:
+    NullAudioManager ();
+    ~NullAudioManager () override;
+
+    NullAudioManager (const NullAudioManager&) = delete;
+    NullAudioManager& operator= (const NullAudioManager&) = delete;
+
+    bool initialize () override;
+    void shutdown () override;
+    uint32_t load_sound (const char* file_path) override;
+    bool play_sound (uint32_t sound_id) override;
+    bool stop_sound (uint32_t sound_id) override;
+    void set_master_volume (float volume) override;
+    [[nodiscard]] float get_master_volume () const override;
+    void update (float delta_time) override;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
+
+} // namespace OmniCpp::Engine::Platform
@@ -0,0 +1,210 @@
+/**
+ * @file LuaBindings.hpp
+ * @brief Compile-time generated Lua <-> C++ call glue
+ * @version 1.0.0
+ *
+ * Requires Lua headers (OMNICPP_HAS_LUA). Arguments may be bool,
+ * integers, floating point, const char* or std::string_view; results may
+ * also be std::string. Argument errors unwind with lua_error (longjmp),
+ * which is why arguments are limited to types with trivial destructors.
+ */
+
+#pragma once
+
+#include "engine/logging/Log.hpp"
+#include "engine/scripting/ScriptManager.hpp"
+
+extern "C" {
+#include <lauxlib.h>
+#include <lua.h>
+}
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace omnicpp {
+namespace scripting {
+namespace lua {
+
+namespace detail {
+
+template<typename T>
+inline constexpr bool kUnsupported = false;
+
+template<typename>
+struct Signature;
+
+template<typename R, typename... Args>
+struct Signature<R (*)(Args...)> {
+    using Return = R;
+    using Arguments = std::tuple<Args...>;
+};
+
+template<typename C, typename R, typename... Args>
+struct Signature<R (C::*)(Args...)> {
+    using Class = C;
+    using Return = R;
+    using Arguments = std::tuple<Args...>;
+};
+
+template<typename C, typename R, typename... Args>
+struct Signature<R (C::*)(Args...) const> {
+    using Class = const C;
+    using Return = R;
+    using Arguments = std::tuple<Args...>;
+};
+
+/**
+ * @brief Read argument `index`; raises a Lua argument error on a type mismatch
+ */
+template<typename T>
+T check(lua_State* state, int index) {
+    using U = std::remove_cvref_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        return lua_toboolean(state, index) != 0;
+    } else if constexpr (std::is_integral_v<U>) {
+        return static_cast<U>(luaL_checkinteger(state, index));
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return static_cast<U>(luaL_checknumber(state, index));
+    } else if constexpr (std::is_same_v<U, std::string_view>) {
+        std::size_t length = 0;
+        const char* text = luaL_checklstring(state, index, &length);
+        return { text, length };
+    } else if constexpr (std::is_same_v<U, const char*>) {
+        return luaL_checkstring(state, index);
+    } else {
+        static_assert(kUnsupported<U>, "Unsupported Lua argument type");
+    }
+}
+
+template<typename T>
+void push(lua_State* state, const T& value) {
+    using U = std::remove_cvref_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        lua_pushboolean(state, value ? 1 : 0);
+    } else if constexpr (std::is_integral_v<U>) {
+        lua_pushinteger(state, static_cast<lua_Integer>(value));
+    } else if constexpr (std::is_floating_point_v<U>) {
+        lua_pushnumber(state, static_cast<lua_Number>(value));
+    } else if constexpr (std::is_same_v<U, std::string_view> || std::is_same_v<U, std::string>) {
+        lua_pushlstring(state, value.data(), value.size());
+    } else if constexpr (std::is_same_v<std::decay_t<U>, const char*> || std::is_same_v<std::decay_t<U>, char*>) {
+        lua_pushstring(state, value);
+    } else {
+        static_assert(kUnsupported<U>, "Unsupported Lua value type");
+    }
+}
+
+/**
+ * @brief Read a result without raising; empty on a type mismatch
+ */
+template<typename T>
+std::optional<T> to(lua_State* state, int index) {
+    if constexpr (std::is_same_v<T, bool>) {
+        return lua_toboolean(state, index) != 0;
+    } else if constexpr (std::is_integral_v<T>) {
+        int ok = 0;
+        const lua_Integer value = lua_tointegerx(state, index, &ok);
+        return ok ? std::optional<T>(static_cast<T>(value)) : std::nullopt;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        int ok = 0;
+        const lua_Number value = lua_tonumberx(state, index, &ok);
+        return ok ? std::optional<T>(static_cast<T>(value)) : std::nullopt;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        if (lua_type(state, index) != LUA_TSTRING) {
+            return std::nullopt;
+        }
+        std::size_t length = 0;
+        const char* text = lua_tolstring(state, index, &length);
+        return std::string(text, length);
+    } else {
+        static_assert(kUnsupported<T>, "Unsupported Lua result type (views would outlive the stack slot)");
+    }
+}
+
+template<typename R, typename Fn, typename... Args>
+int invoke(lua_State* state, Fn&& fn, std::tuple<Args...>*) {
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        if constexpr (std::is_void_v<R>) {
+            fn(check<Args>(state, static_cast<int>(Is) + 1)...);
+            return 0;
+        } else {
+            push(state, fn(check<Args>(state, static_cast<int>(Is) + 1)...));
+            return 1;
+        }
+    }(std::index_sequence_for<Args...>{});
+}
+
+inline void report(lua_State* state) {
+    const char* message = lua_tostring(state, -1);
+    omnicpp::log::error("Lua: {}", message ? message : "(error object is not a string)");
+    lua_pop(state, 1);
+}
+
+} // namespace detail
+
+/**
+ * @brief NativeFunction for a free function, generated at compile time
+ *
+ * manager.register_function("spawn", lua::wrap<&spawn_enemy>);
+ */
+template<auto F>
+int wrap(lua_State* state) {
+    using Sig = detail::Signature<decltype(F)>;
+    return detail::invoke<typename Sig::Return>(state, F, static_cast<typename Sig::Arguments*>(nullptr));
+}
+
+/**
+ * @brief NativeFunction for a member function; `this` comes from the registration context
+ *
+ * manager.register_function("damage", lua::wrap_method<&Health::damage>, &health);
+ */
+template<auto M>
+int wrap_method(lua_State* state) {
+    using Sig = detail::Signature<decltype(M)>;
+    auto* self = static_cast<typename Sig::Class*>(lua_touserdata(state, lua_upvalueindex(1)));
+    return detail::invoke<typename Sig::Return>(
+        state, [self](auto&&... args) -> decltype(auto) { return (self->*M)(std::forward<decltype(args)>(args)...); },
+        static_cast<typename Sig::Arguments*>(nullptr));
+}
+
+/**
+ * @brief Call a resolved Lua function
+ *
+ * Pushes the registry slot and the arguments and runs lua_pcall: no
+ * string lookups and, once the Lua stack has grown, no allocation. Errors
+ * are logged.
+ * @return For R = void, whether the call succeeded; otherwise the result,
+ *         empty on error or when it is not convertible to R
+ */
+template<typename R = void, typename... Args>
+std::conditional_t<std::is_void_v<R>, bool, std::optional<R>> call(lua_State* state, FunctionRef function,
+                                                                   const Args&... args) {
+    lua_rawgeti(state, LUA_REGISTRYINDEX, function.ref);
+    (detail::push(state, args), ...);
+    constexpr int kResults = std::is_void_v<R> ? 0 : 1;
+    if (lua_pcall(state, static_cast<int>(sizeof...(Args)), kResults, 0) != LUA_OK) {
+        detail::report(state);
+        if constexpr (std::is_void_v<R>) {
+            return false;
+        } else {
+            return std::nullopt;
+        }
+    }
+    if constexpr (std::is_void_v<R>) {
+        return true;
+    } else {
+        std::optional<R> result = detail::to<R>(state, -1);
+        lua_pop(state, 1);
+        return result;
+    }
+}
+
+} // namespace lua
+} // namespace scripting
+} // namespace omnicpp
@@ -6,33 +6,152 @@
 
 #pragma once
 
-#include <string>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
+#include <span>
+#include <string>
+#include <type_traits>
 #include <vector>
 
+struct lua_State;
+
 namespace omnicpp {
 namespace scripting {
 
-// Forward declarations
-class LuaVM;
-class Script;
+/**
+ * @brief Native function callable from Lua (same signature as lua_CFunction)
+ */
+using NativeFunction = int (*)(lua_State*);
+
+/**
+ * @brief A Lua function resolved once and kept in the registry
+ *
+ * Calling through a FunctionRef is a registry index, not a global-table
+ * string lookup, so it is what per-frame callbacks should hold.
+ */
+struct FunctionRef {
+    int ref{ -2 }; // LUA_NOREF
+
+    [[nodiscard]] bool valid() const { return ref > 0; }
+};
+
+using TaskId = uint32_t;
+inline constexpr TaskId INVALID_TASK = 0;
+
+/**
+ * @brief Element type of an array view
+ */
+enum class ElementType : uint8_t { Float32, Float64, Int32, UInt32, Int64, UInt8 };
+
+/**
+ * @brief A typed C++ array call_with_columns hands a script as a 1-based table
+ */
+struct ArrayView {
+    void* data{ nullptr };
+    std::size_t size{ 0 };
+    ElementType type{ ElementType::Float32 };
+    bool writable{ false };
+};
+
+/**
+ * @brief View over a span; spans of const elements are read-only in Lua
+ */
+template<typename T>
+ArrayView make_view(std::span<T> values) {
+    using U = std::remove_const_t<T>;
+    ArrayView view;
+    view.data = const_cast<U*>(values.data());
+    view.size = values.size();
+    view.writable = !std::is_const_v<T>;
+    if constexpr (std::is_same_v<U, float>) {
+        view.type = ElementType::Float32;
+    } else if constexpr (std::is_same_v<U, double>) {
+        view.type = ElementType::Float64;
+    } else if constexpr (std::is_same_v<U, int32_t>) {
+        view.type = ElementType::Int32;
+    } else if constexpr (std::is_same_v<U, uint32_t>) {
+        view.type = ElementType::UInt32;
+    } else if constexpr (std::is_same_v<U, int64_t>) {
+        view.type = ElementType::Int64;
+    } else if constexpr (std::is_same_v<U, uint8_t>) {
+        view.type = ElementType::UInt8;
+    } else {
+        static_assert(std::is_same_v<U, float>, "Unsupported array view element type");
+    }
+    return view;
+}
+
+/**
+ * @brief Views over columns Is... of a memory::SoAVector (or anything with span<I>())
+ */
+template<std::size_t... Is, typename Soa>
+std::array<ArrayView, sizeof...(Is)> soa_columns(Soa& soa) {
+    return { make_view(soa.template span<Is>())... };
+}
+
+/**
+ * @brief Script manager configuration
+ */
+struct ScriptConfig {
+    std::string bytecode_cache_dir;  // Where compiled chunks persist across runs; empty keeps them in memory only
+    bool strip_debug_info{ false };  // Smaller bytecode, but errors lose line numbers
+    uint32_t frame_budget_us{ 2000 }; // Lua time per update(): callbacks first, then tasks
+    uint32_t call_budget_us{ 100000 }; // Any other single entry into Lua (loading, call_function, call_with_columns)
+    uint32_t hook_interval{ 1000 };   // VM instructions between budget checks
+};
+
+/**
+ * @brief Loading and call counters
+ */
+struct ScriptStats {
+    uint64_t compiles{ 0 };      // Chunks compiled from source
+    uint64_t memory_hits{ 0 };   // Chunks loaded from the in-memory bytecode cache
+    uint64_t disk_hits{ 0 };     // Chunks loaded from bytecode_cache_dir
+    uint64_t errors{ 0 };        // Compile and runtime errors
+    uint64_t budget_overruns{ 0 }; // Calls aborted for exceeding their budget
+    uint64_t skipped_callbacks{ 0 }; // Update callbacks not run because the frame budget was spent
+    uint64_t preemptions{ 0 };   // Tasks suspended by the budget hook
+    uint64_t tasks_completed{ 0 };
+};
 
 /**
  * @brief Script manager for Lua scripting
- * 
- * Manages loading, execution, and lifecycle of Lua scripts.
+ *
+ * Owns one Lua state. Scripts are compiled once to bytecode and cached by
+ * a hash of their source, in memory and optionally on disk, so reloading
+ * an unchanged script (or starting the game again) skips the parser.
+ * Only point bytecode_cache_dir at a directory the game controls: Lua
+ * does not verify bytecode.
+ *
+ * C++ functions are exposed with register_function(). The typed
+ * wrappers in LuaBindings.hpp (lua::wrap<&fn>) generate the NativeFunction
+ * at compile time, so a call from Lua converts its arguments straight off
+ * the stack with no boxing or name lookups. The other direction goes
+ * through FunctionRefs resolved once with resolve() and lua::call().
+ *
+ * call_with_columns() hands a script whole columns (see soa_columns) as
+ * plain tables and copies the writable ones back, for logic that needs
+ * the whole set at once under one budget. It is not a faster per-entity
+ * path: moving an element through a table costs about what a typed
+ * lua::call saves, so small per-entity functions are as cheap called
+ * one by one.
+ *
+ * A count hook checks the clock every hook_interval VM instructions. A
+ * call that runs past its budget is aborted with a Lua error, and update()
+ * skips the remaining callbacks once the frame budget is spent. Tasks
+ * (start_task) are coroutines resumed by update() with whatever budget
+ * the callbacks left; when it runs out the hook yields the task, and it
+ * continues next frame where it stopped. Either way, a runaway script
+ * costs at most its budget plus one hook interval.
+ *
+ * Like the Lua state it wraps, a ScriptManager belongs to one thread.
+ * Without Lua (OMNICPP_USE_LUA=OFF) it initializes but loads nothing.
  */
 class ScriptManager {
 public:
-    /**
-     * @brief Construct a new Script Manager object
-     */
-    ScriptManager() = default;
-
-    /**
-     * @brief Destroy the Script Manager object
-     */
+    ScriptManager();
     ~ScriptManager();
 
     // Disable copying
@@ -40,72 +159,119 @@ public:
     ScriptManager& operator=(const ScriptManager&) = delete;
 
     // Enable moving
-    ScriptManager(ScriptManager&&) noexcept = default;
-    ScriptManager& operator=(ScriptManager&&) noexcept = default;
+    ScriptManager(ScriptManager&& other) noexcept;
+    ScriptManager& operator=(ScriptManager&& other) noexcept;
 
     /**
-     * @brief Initialize script manager
+     * @brief Create the Lua state and open the standard libraries
      * @return true if initialization succeeded, false otherwise
      */
-    bool initialize();
+    bool initialize(const ScriptConfig& config = {});
 
     /**
-     * @brief Shutdown script manager
+     * @brief Shutdown script manager and close the Lua state
      */
     void shutdown();
 
     /**
-     * @brief Load a script from file
-     * @param path Path to script file
-     * @return Script* Pointer to loaded script, or nullptr if failed
+     * @brief Call every update callback with the frame time, then resume tasks, within the frame budget
+     */
+    void update(float delta_time);
+
+    /**
+     * @brief Compile (or fetch from the bytecode cache) a script file
+     *
+     * Loading a name again replaces the script, which is how hot reload works.
+     * @return true if the script compiled, false otherwise
+     */
+    bool load_script(const std::string& name, const std::string& path);
+
+    /**
+     * @brief Compile a script held in memory
      */
-    Script* load_script(const std::string& path);
+    bool load_script_source(const std::string& name, const std::string& source);
 
     /**
      * @brief Unload a script
-     * @param path Path to script file
+     * @return true if the script was loaded, false otherwise
      */
-    void unload_script(const std::string& path);
+    bool unload_script(const std::string& name);
 
     /**
-     * @brief Execute a script
-     * @param script Pointer to script
+     * @brief Run a loaded script's top-level chunk
      * @return true if execution succeeded, false otherwise
      */
-    bool execute_script(Script* script);
+    bool execute_script(const std::string& name);
 
     /**
-     * @brief Call a Lua function
-     * @param function_name The function name
-     * @param args Arguments to pass to function
+     * @brief Call a global Lua function by name with string arguments
+     *
+     * Convenience for tools and consoles; per-frame code should resolve()
+     * once and call through the FunctionRef.
      * @return true if call succeeded, false otherwise
      */
-    bool call_function(const std::string& function_name, 
-                   const std::vector<std::string>& args = {});
+    bool call_function(const std::string& function_name,
+                       const std::vector<std::string>& args = {});
 
     /**
-     * @brief Register a C++ function to Lua
+     * @brief Register a C++ function as a Lua global
      * @param name The function name in Lua
-     * @param function The C++ function pointer
+     * @param function The native function, typically lua::wrap<&fn>
+     * @param context Passed to the function as upvalue 1 (lua::wrap_method uses it for `this`)
+     */
+    void register_function(const std::string& name, NativeFunction function, void* context = nullptr);
+
+    /**
+     * @brief Look up a global function once
+     * @return An invalid ref if the global is not a function
+     */
+    [[nodiscard]] FunctionRef resolve(const std::string& function_name);
+
+    /**
+     * @brief Drop a resolved function (also removes it from the update callbacks)
      */
-    void register_function(const std::string& name, void* function);
+    void release(FunctionRef& function);
 
     /**
-     * @brief Get Lua VM
-     * @return LuaVM* Pointer to Lua VM
+     * @brief Call `function(delta_time)` from every update()
      */
-    LuaVM* get_lua_vm() const { return m_lua_vm.get(); }
+    bool add_update_callback(FunctionRef function);
 
     /**
-     * @brief Get all loaded scripts
-     * @return const std::vector<Script*>& The scripts
+     * @brief Call `function(count, delta_time, views...)` once, with whole columns
+     *
+     * Each column is copied into a table reused across calls, so the script
+     * indexes it without a metamethod per element. Writable columns are
+     * copied back when the call returns. A script must not keep a view: a
+     * kept read-only one raises errors, a kept writable one holds stale
+     * values that are never copied back.
      */
-    const std::vector<Script*>& get_scripts() const { return m_scripts; }
+    bool call_with_columns(FunctionRef function, std::span<const ArrayView> columns, std::size_t count,
+                           double delta_time = 0.0);
+
+    /**
+     * @brief Run `function(delta_time)` as a coroutine from the next update()
+     *
+     * Each update() resumes it with the frame time (what coroutine.yield()
+     * returns) until it returns or errors.
+     */
+    TaskId start_task(FunctionRef function);
+    [[nodiscard]] bool is_task_running(TaskId task) const;
+    void cancel_task(TaskId task);
+
+    /**
+     * @brief Get the Lua state, for lua::call and custom bindings
+     *
+     * lua::call made directly on the state is only budgeted inside update().
+     */
+    [[nodiscard]] lua_State* get_state() const;
+
+    [[nodiscard]] std::vector<std::string> get_script_names() const;
+    [[nodiscard]] ScriptStats get_stats() const;
 
 private:
-    std::unique_ptr<LuaVM> m_lua_vm;
-    std::unordered_map<std::string, std::unique_ptr<Script>> m_scripts;
-    std::vector<Script*> m_script_list;
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
 };
 
 } // namespace scripting
@@ -11,18 +11,21 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <mutex>
 #include <atomic>
 #include <functional>
 #include <optional>
 #include <span>
-#include <fmt/format.h>
-#include "engine/logging/spdlog_shim.hpp"
+#include <variant>
+#include <vector>
 
 namespace omnicpp {
 namespace telemetry {
@@ -91,12 +94,158 @@ using AttributeValue = std::variant<
  */
 using SpanAttributes = std::unordered_map<std::string, AttributeValue>;
 
+// ============================================================================
+// Interned names and flat span records
+// ============================================================================
+
+/**
+ * @brief Id of an interned string (span, event and attribute names)
+ */
+using NameId = uint32_t;
+
+/**
+ * @brief Intern a string; ids are stable for the life of the process
+ *
+ * Repeated lookups hit a per-thread cache and take no lock.
+ */
+NameId intern(std::string_view text);
+
+/**
+ * @brief The string behind an id
+ */
+const std::string& interned(NameId id);
+
+/**
+ * @brief An attribute key interned once, for hot paths
+ *
+ *   static const AttributeKey kFrame("frame.number");
+ *   span.set_attribute(kFrame, frame);
+ */
+struct AttributeKey {
+    NameId id;
+
+    explicit AttributeKey(std::string_view key) : id(intern(key)) {}
+};
+
+/**
+ * @brief One attribute in a SpanRecord; strings live in the record's text buffer
+ *
+ * Trivial, so a new SpanRecord leaves its slots uninitialised: only the
+ * first attribute_count are ever read, and FlatAttribute{} zeroes one.
+ */
+struct FlatAttribute {
+    enum class Type : uint8_t { Int, Double, Bool, String, Bytes };
+
+    NameId key;
+    Type type;
+    uint8_t owner;   // 0 for the span, n for the span's event n-1
+    uint16_t length; // String and Bytes: bytes at `offset` in the text buffer (Bytes export as a string)
+    union {
+        int64_t i;
+        double d;
+        bool b;
+        uint32_t offset;
+    };
+};
+
+struct FlatEvent {
+    NameId name;
+    uint64_t tick; // log::binary::ticks()
+};
+
+/**
+ * @brief Everything about a span in one fixed-size, allocation-free block
+ *
+ * What a Span fills in while it runs and what the recorder copies into a
+ * thread's ring when it ends. Attributes past MAX_ATTRIBUTES, events past
+ * MAX_EVENTS and text past TEXT_BYTES are dropped (and counted).
+ */
+struct SpanRecord {
+    static constexpr std::size_t MAX_ATTRIBUTES = 12;
+    static constexpr std::size_t MAX_EVENTS = 4;
+    static constexpr std::size_t TEXT_BYTES = 128;
+
+    TraceId trace_id;
+    SpanId span_id;
+    SpanId parent_span_id; // Invalid for a root span
+    NameId name{ 0 };
+    SpanKind kind{ SpanKind::Internal };
+    StatusCode status{ StatusCode::Unset };
+    uint8_t attribute_count{ 0 };
+    uint8_t event_count{ 0 };
+    uint16_t text_used{ 0 };
+    uint16_t status_offset{ 0 };
+    uint16_t status_length{ 0 };
+    uint16_t dropped{ 0 }; // Attributes, events and text that did not fit
+    uint32_t thread{ 0 };  // Recording thread, numbered by SpanRecorder (0: the thread that ends it)
+    uint64_t start_tick{ 0 }; // log::binary::ticks(); the exporter thread converts them to time
+    uint64_t end_tick{ 0 };
+    std::array<FlatAttribute, MAX_ATTRIBUTES> attributes;
+    std::array<FlatEvent, MAX_EVENTS> events;
+    std::array<char, TEXT_BYTES> text;
+
+    /**
+     * @brief Add or overwrite an attribute of the span (owner 0) or of an event
+     */
+    template<typename T>
+    void set_attribute(NameId key, const T& value, uint8_t owner = 0) {
+        using U = std::decay_t<T>;
+        FlatAttribute* slot = find_attribute(key, owner);
+        if (slot == nullptr) {
+            return;
+        }
+        if constexpr (std::is_same_v<U, bool>) {
+            slot->type = FlatAttribute::Type::Bool;
+            slot->b = value;
+        } else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>) {
+            slot->type = FlatAttribute::Type::Int;
+            slot->i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_floating_point_v<U>) {
+            slot->type = FlatAttribute::Type::Double;
+            slot->d = static_cast<double>(value);
+        } else if constexpr (std::is_same_v<U, std::span<const uint8_t>>) {
+            slot->type = FlatAttribute::Type::Bytes;
+            store_text(*slot, { reinterpret_cast<const char*>(value.data()), value.size() });
+        } else if constexpr (std::is_same_v<U, AttributeValue>) {
+            std::visit([&](const auto& alternative) { set_attribute(key, alternative, owner); }, value);
+        } else {
+            slot->type = FlatAttribute::Type::String;
+            store_text(*slot, std::string_view(value));
+        }
+    }
+
+    /**
+     * @brief Record an event; returns its owner index for set_attribute, 0 when full
+     */
+    uint8_t add_event(NameId event_name, uint64_t tick);
+
+    void set_status(StatusCode code, std::string_view description);
+
+    [[nodiscard]] std::string_view text_at(uint32_t offset, uint32_t length) const {
+        return { text.data() + offset, length };
+    }
+
+    /**
+     * @brief An attribute's value in the exported form
+     */
+    [[nodiscard]] AttributeValue value(const FlatAttribute& attribute) const;
+
+private:
+    FlatAttribute* find_attribute(NameId key, uint8_t owner);
+    void store_text(FlatAttribute& attribute, std::string_view value);
+};
+
 // ============================================================================
 // Span
 // ============================================================================
 
 /**
  * @brief Represents a unit of work in a trace
+ *
+ * A span belongs to the thread that runs it: it holds its attributes and
+ * events in a flat SpanRecord, so setting them takes no lock and allocates
+ * nothing. end() hands the record to the SpanRecorder, whose exporter
+ * thread turns it into SpanData. A span that is never ended is not exported.
  */
 class Span {
 public:
@@ -106,106 +255,111 @@ public:
      * @param kind Span kind
      * @param trace_id Parent trace ID
      * @param parent_span_id Parent span ID (optional)
+     * @param recording false for a span the sampler dropped: it still has ids, but end() exports nothing
      */
-    Span(std::string name, SpanKind kind, 
-         TraceId trace_id, 
-         std::optional<SpanId> parent_span_id = std::nullopt);
-    
+    Span(std::string_view name, SpanKind kind,
+         TraceId trace_id,
+         std::optional<SpanId> parent_span_id = std::nullopt,
+         bool recording = true);
+
     ~Span();
-    
+
     // Non-copyable, movable
     Span(const Span&) = delete;
     Span& operator=(const Span&) = delete;
     Span(Span&&) noexcept;
     Span& operator=(Span&&) noexcept;
-    
+
     /**
      * @brief Add an attribute to the span
      */
     template<typename T>
     void set_attribute(std::string_view key, T&& value) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        attributes_[std::string(key)] = AttributeValue(std::forward<T>(value));
+        record_.set_attribute(intern(key), value);
     }
-    
+
+    template<typename T>
+    void set_attribute(const AttributeKey& key, T&& value) {
+        record_.set_attribute(key.id, value);
+    }
+
     /**
      * @brief Add an event to the span
      */
-    void add_event(std::string_view name, 
+    void add_event(std::string_view name,
                    const SpanAttributes& attributes = {});
-    
+
     /**
      * @brief Set span status
      */
     void set_status(StatusCode code, std::string_view description = "");
-    
+
     /**
      * @brief Record an exception
      */
-    void record_exception(std::string_view type, 
+    void record_exception(std::string_view type,
                           std::string_view message,
                           std::string_view stacktrace = "");
-    
+
     /**
      * @brief End the span
      */
     void end();
-    
+
     /**
      * @brief Check if span has ended
      */
-    [[nodiscard]] bool has_ended() const noexcept { return ended_.load(); }
-    
+    [[nodiscard]] bool has_ended() const noexcept { return ended_; }
+
+    /**
+     * @brief Whether end() will export the span
+     */
+    [[nodiscard]] bool is_recording() const noexcept { return recording_; }
+
     /**
      * @brief Get span ID
      */
-    [[nodiscard]] SpanId span_id() const noexcept { return span_id_; }
-    
+    [[nodiscard]] SpanId span_id() const noexcept { return record_.span_id; }
+
     /**
      * @brief Get trace ID
      */
-    [[nodiscard]] TraceId trace_id() const noexcept { return trace_id_; }
-    
+    [[nodiscard]] TraceId trace_id() const noexcept { return record_.trace_id; }
+
     /**
      * @brief Get parent span ID
      */
-    [[nodiscard]] std::optional<SpanId> parent_span_id() const noexcept { 
-        return parent_span_id_; 
+    [[nodiscard]] std::optional<SpanId> parent_span_id() const noexcept {
+        if (!record_.parent_span_id.is_valid()) {
+            return std::nullopt;
+        }
+        return record_.parent_span_id;
     }
-    
+
     /**
      * @brief Get span name
      */
-    [[nodiscard]] const std::string& name() const noexcept { return name_; }
-    
+    [[nodiscard]] const std::string& name() const noexcept { return interned(record_.name); }
+
     /**
      * @brief Get span duration
      */
     [[nodiscard]] std::chrono::nanoseconds duration() const noexcept;
-    
+
     /**
      * @brief Create a child span
      */
     [[nodiscard]] Span create_child(std::string_view child_name, SpanKind kind = SpanKind::Internal);
 
+    /**
+     * @brief The flat record end() exports
+     */
+    [[nodiscard]] const SpanRecord& record() const noexcept { return record_; }
+
 private:
-    std::string name_;
-    SpanKind kind_;
-    TraceId trace_id_;
-    SpanId span_id_;
-    std::optional<SpanId> parent_span_id_;
-    
-    std::chrono::steady_clock::time_point start_time_;
-    std::chrono::steady_clock::time_point end_time_;
-    
-    SpanAttributes attributes_;
-    std::vector<std::pair<std::string, SpanAttributes>> events_;
-    
-    StatusCode status_{StatusCode::Unset};
-    std::string status_description_;
-    
-    std::atomic<bool> ended_{false};
-    mutable std::mutex mutex_;
+    SpanRecord record_;
+    bool recording_{ true };
+    bool ended_{ false };
 };
 
 // ============================================================================
@@ -287,6 +441,15 @@ struct OtlpExporterConfig {
     std::unordered_map<std::string, std::string> headers;
 };
 
+/**
+ * @brief Event data for export
+ */
+struct SpanEventData {
+    std::string name;
+    std::chrono::nanoseconds time;  // Unix nanoseconds
+    SpanAttributes attributes;
+};
+
 /**
  * @brief Span data for export
  */
@@ -299,8 +462,10 @@ struct SpanData {
     std::chrono::nanoseconds start_time;  // Unix nanoseconds
     std::chrono::nanoseconds duration;
     SpanAttributes attributes;
+    std::vector<SpanEventData> events;
     StatusCode status;
     std::string status_description;
+    uint32_t thread{0};  // Recording thread, numbered by SpanRecorder
 };
 
 /**
@@ -349,11 +514,17 @@ struct TelemetryConfig {
     // Batch export configuration
     size_t batch_size{512};
     std::chrono::milliseconds batch_timeout{5000};
-    size_t max_queue_size{2048};
+    size_t max_queue_size{2048};  // Ended spans buffered per thread
 };
 
 /**
  * @brief Main telemetry manager
+ *
+ * Ended spans go into per-thread rings of the SpanRecorder
+ * (span_recorder.hpp); its exporter thread converts them to SpanData every
+ * batch_timeout and hands them to the exporter in batches of batch_size.
+ * max_queue_size bounds each thread's ring: when it is full, spans are
+ * dropped and counted rather than making the caller wait.
  */
 class TelemetryManager {
 public:
@@ -365,11 +536,21 @@ public:
     TelemetryManager& operator=(const TelemetryManager&) = delete;
     TelemetryManager(TelemetryManager&&) = delete;
     TelemetryManager& operator=(TelemetryManager&&) = delete;
-    
+
     /**
-     * @brief Initialize the telemetry system
+     * @brief The process-wide manager (used by the OMNICPP_SPAN macros)
+     */
+    static TelemetryManager& instance();
+
+    /**
+     * @brief Initialize the telemetry system and start the span exporter thread
      */
     bool initialize(const TelemetryConfig& config);
+
+    /**
+     * @brief Where ended spans go; may be set before or after initialize()
+     */
+    void set_exporter(std::shared_ptr<SpanExporter> exporter);
     
     /**
      * @brief Shutdown the telemetry system
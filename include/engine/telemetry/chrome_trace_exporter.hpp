@@ -0,0 +1,88 @@
+/**
+ * @file chrome_trace_exporter.hpp
+ * @brief SpanExporter writing the Chrome Trace Event JSON format
+ * @version 1.0.0
+ *
+ * Opens directly in ui.perfetto.dev or chrome://tracing:
+ * - spans become complete ("X") slices on their recording thread, and span
+ *   events become instant events inside them
+ * - a parent and child span on different threads are joined by a flow arrow
+ * - threads and the process are named from SpanRecorder::set_thread_name()
+ *   and ChromeTraceConfig::process_name
+ * - add_counter() writes counter tracks; the recorder's dropped span count
+ *   is one
+ * - add_slice() writes other timed work, such as frame profiler scopes
+ *
+ * The caller only formats JSON into a buffer; a writer thread owned by the
+ * exporter does the file I/O every flush_interval or when the buffer
+ * reaches buffer_bytes. The file is a JSON array whose closing bracket is
+ * written by shutdown(); the viewers accept a trace cut off without it.
+ */
+
+#pragma once
+
+#include "engine/telemetry/Telemetry.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace omnicpp {
+namespace telemetry {
+
+struct ChromeTraceConfig {
+    std::string path{ "omnicpp_trace.json" };
+    std::string process_name{ "omnicpp" };
+    std::size_t buffer_bytes{ 1 << 20 };              // Wake the writer early past this much pending JSON
+    std::chrono::milliseconds flush_interval{ 1000 }; // Otherwise write this often
+};
+
+class ChromeTraceExporter final : public SpanExporter {
+public:
+    explicit ChromeTraceExporter(ChromeTraceConfig config = {});
+    ~ChromeTraceExporter() override;
+
+    ChromeTraceExporter(const ChromeTraceExporter&) = delete;
+    ChromeTraceExporter& operator=(const ChromeTraceExporter&) = delete;
+
+    /**
+     * @brief False if the file could not be created (error() says why)
+     */
+    [[nodiscard]] bool is_open() const;
+    [[nodiscard]] const std::string& error() const;
+
+    bool export_spans(std::span<const SpanData> spans) override;
+
+    /**
+     * @brief Block until everything exported so far is in the file
+     */
+    void force_flush() override;
+
+    /**
+     * @brief Write what is pending, close the JSON array and the file
+     */
+    void shutdown() override;
+
+    /**
+     * @brief Add a sample to a counter track, timestamped now
+     */
+    void add_counter(std::string_view name, double value);
+
+    /**
+     * @brief Add a slice that is not a span (profiler scopes)
+     * @param thread SpanRecorder thread number
+     * @param start Unix time
+     */
+    void add_slice(uint32_t thread, std::string_view name, std::string_view category, std::chrono::nanoseconds start,
+                   std::chrono::nanoseconds duration);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace telemetry
+} // namespace omnicpp
@@ -0,0 +1,119 @@
+/**
+ * @file span_recorder.hpp
+ * @brief Lock-free per-thread buffering of ended spans
+ * @version 1.0.0
+ *
+ * Span::end() copies its SpanRecord into the calling thread's ring: one
+ * producer (the thread) and one consumer (the exporter thread), so the
+ * hot path is a copy and a release store. The exporter thread drains every
+ * ring, builds SpanData (the allocations, and the conversion of TSC ticks
+ * to time, happen there) and passes batches to the SpanExporter. A full
+ * ring drops the span and counts it.
+ */
+
+#pragma once
+
+#include "engine/telemetry/Telemetry.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace omnicpp {
+namespace telemetry {
+
+struct SpanRecorderConfig {
+    std::size_t ring_capacity{ 2048 };                   // Ended spans per thread, rounded up to a power of two
+    std::size_t batch_size{ 512 };                       // Spans per export_spans() call
+    std::chrono::milliseconds export_interval{ 5000 };   // How often the exporter thread drains
+};
+
+struct SpanRecorderStats {
+    uint64_t recorded{ 0 }; // Accepted into a ring
+    uint64_t dropped{ 0 };  // Ring full
+    uint64_t exported{ 0 }; // Passed to the exporter
+};
+
+/**
+ * @brief Process-wide span buffer and exporter thread
+ */
+class SpanRecorder {
+public:
+    static SpanRecorder& instance();
+
+    /**
+     * @brief Start (or reconfigure) the exporter thread
+     */
+    void start(const SpanRecorderConfig& config);
+
+    /**
+     * @brief Export what is buffered and stop the exporter thread
+     */
+    void stop();
+
+    /**
+     * @brief Block until every span ended before the call has been exported
+     */
+    void flush();
+
+    void set_exporter(std::shared_ptr<SpanExporter> exporter);
+
+    /**
+     * @brief Attributes added to every exported span
+     */
+    void set_global_attributes(SpanAttributes attributes);
+
+    /**
+     * @brief Buffer an ended span (called by Span::end); false if it was dropped
+     */
+    bool submit(const SpanRecord& record);
+
+    /**
+     * @brief This thread's number, as stored in SpanRecord::thread
+     */
+    [[nodiscard]] uint32_t thread_number();
+
+    /**
+     * @brief Name the calling thread in exported traces
+     */
+    void set_thread_name(std::string_view name);
+
+    /**
+     * @brief The name given to a thread number, empty if none
+     */
+    [[nodiscard]] std::string thread_name(uint32_t thread) const;
+
+    [[nodiscard]] bool is_running() const;
+    [[nodiscard]] SpanRecorderStats stats() const;
+
+    /**
+     * @brief Length of a span of log::binary::ticks(), at the rate the exporter thread keeps calibrated
+     */
+    [[nodiscard]] static std::chrono::nanoseconds tick_duration(uint64_t ticks);
+
+    /**
+     * @brief The log::binary::ticks() value at a steady_clock time, for records timed by another clock
+     */
+    [[nodiscard]] static uint64_t tick_at(std::chrono::steady_clock::time_point time);
+
+    /**
+     * @brief Convert a record to export form (what the exporter thread does)
+     */
+    [[nodiscard]] static SpanData to_span_data(const SpanRecord& record);
+
+    SpanRecorder(const SpanRecorder&) = delete;
+    SpanRecorder& operator=(const SpanRecorder&) = delete;
+
+private:
+    SpanRecorder();
+    ~SpanRecorder();
+
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace telemetry
+} // namespace omnicpp
@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include "game/PongSimulation.hpp"
+#include "engine/network/rollback.hpp"
 #include <memory>
 #include <cstdint>
+#include <functional>
 
 namespace omnicpp {
 
@@ -39,6 +42,10 @@ namespace game {
  * - Scoring system
  * - Keyboard controls (W/S for player paddle)
  * - Simple AI opponent
+ * - Optional online play with rollback netcode
+ *
+ * Gameplay runs through pong_step() at a fixed 60 Hz so that local and
+ * online matches share one deterministic simulation.
  */
 class PongGame {
 public:
@@ -83,6 +90,40 @@ public:
      */
     void render();
 
+    /**
+     * @brief Rollback session used for online matches
+     */
+    using RollbackSession = OmniCpp::Engine::Network::RollbackSession<PongState, PongInput, 2, 16>;
+
+    /**
+     * @brief Called with each local input that must reach the remote peer
+     */
+    using SendInputCallback = std::function<void(uint32_t frame, PongInput input)>;
+
+    /**
+     * @brief Switch to an online match against a remote peer
+     *
+     * Both peers must use the same seed. The remote paddle is driven by
+     * inputs passed to receive_remote_input(); until they arrive it is
+     * predicted and corrected by rollback.
+     *
+     * @param local_player Paddle controlled locally (0 = left, 1 = right)
+     * @param seed Shared serve seed
+     * @param send Transport for local inputs (e.g. NetworkManager::send)
+     * @param input_delay Frames of local input delay traded for fewer rollbacks
+     */
+    void enable_online(uint32_t local_player, uint32_t seed, SendInputCallback send, uint32_t input_delay = 0);
+
+    /**
+     * @brief Deliver the remote player's input for a simulation frame
+     */
+    void receive_remote_input(uint32_t frame, PongInput input);
+
+    /**
+     * @brief Rollback session, or nullptr in local play
+     */
+    const RollbackSession* get_rollback_session() const { return m_rollback.get(); }
+
     /**
      * @brief Run the main game loop
      * @return Exit code (0 for success, non-zero for error)
@@ -97,32 +138,19 @@ private:
     void handle_input(const input::InputEvent& event);
 
     /**
-     * @brief Update player paddle based on input
-     * @param delta_time Time since last frame in seconds
-     */
-    void update_player_paddle(float delta_time);
-
-    /**
-     * @brief Update AI paddle (simple tracking)
-     * @param delta_time Time since last frame in seconds
-     */
-    void update_ai_paddle(float delta_time);
-
-    /**
-     * @brief Update ball physics and movement
-     * @param delta_time Time since last frame in seconds
+     * @brief Sample the keyboard into a simulation input
      */
-    void update_ball(float delta_time);
+    PongInput sample_local_input() const;
 
     /**
-     * @brief Check and handle collisions
+     * @brief Run one fixed simulation step (local or through rollback)
      */
-    void check_collisions();
+    void step_simulation();
 
     /**
-     * @brief Reset ball to center with random direction
+     * @brief Copy simulation state onto the entity transforms
      */
-    void reset_ball();
+    void sync_entities();
 
     /**
      * @brief Update score display
@@ -154,38 +182,20 @@ private:
     bool m_initialized;
     bool m_running;
 
-    // Ball physics
-    struct BallState {
-        float x, y, z;
-        float velocity_x, velocity_y, velocity_z;
-        float radius;
-    } m_ball_state;
-
-    // Paddle state
-    struct PaddleState {
-        float x, y, z;
-        float width, height, depth;
-        float speed;
-    } m_player_paddle_state, m_ai_paddle_state;
-
-    // Game boundaries
-    struct GameBounds {
-        float left, right;
-        float top, bottom;
-        float front, back;
-    } m_bounds;
-
-    // Scoring
-    int m_player_score;
-    int m_ai_score;
+    // Simulation state (ball, paddles, scores)
+    PongState m_state;
+    float m_accumulator;
+    int32_t m_reported_scores[2];
+
+    // Online play
+    std::unique_ptr<RollbackSession> m_rollback;
+    SendInputCallback m_send_input;
+    uint32_t m_local_player;
 
     // Constants
-    static constexpr float PADDLE_SPEED = 8.0f;
-    static constexpr float BALL_SPEED = 6.0f;
-    static constexpr float BALL_SPEED_INCREMENT = 0.5f;
-    static constexpr float AI_PADDLE_SPEED = 4.0f;
-    static constexpr float AI_REACTION_DELAY = 0.1f;
-    static constexpr float WINNING_SCORE = 10;
+    static constexpr float AI_PADDLE_SPEED = PONG_AI_PADDLE_SPEED;
+    static constexpr int32_t WINNING_SCORE = PONG_WINNING_SCORE;
+    static constexpr int MAX_STEPS_PER_UPDATE = 5;
 };
 
 } // namespace game
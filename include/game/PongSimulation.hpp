@@ -0,0 +1,100 @@
+/**
+ * @file PongSimulation.hpp
+ * @brief Deterministic fixed-step Pong simulation shared by local and rollback play
+ * @version 1.0.0
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace omnicpp {
+namespace game {
+
+/**
+ * @brief Ball physics state
+ */
+struct BallState {
+    float x, y, z;
+    float velocity_x, velocity_y, velocity_z;
+    float radius;
+};
+
+/**
+ * @brief Paddle state
+ */
+struct PaddleState {
+    float x, y, z;
+    float width, height, depth;
+    float speed;
+};
+
+/**
+ * @brief Playfield boundaries
+ */
+struct GameBounds {
+    float left, right;
+    float top, bottom;
+    float front, back;
+};
+
+/**
+ * @brief One player's input for one simulation step
+ */
+struct PongInput {
+    int8_t move = 0;  // -1 down, 0 idle, +1 up
+
+    bool operator==(const PongInput&) const = default;
+};
+
+/**
+ * @brief Everything a step reads or writes
+ *
+ * Plain data so rollback can snapshot it with a copy. The RNG lives in the
+ * state (not std::rand) so resimulated serves match the original ones.
+ */
+struct PongState {
+    BallState ball;
+    std::array<PaddleState, 2> paddles;  // 0 = left, 1 = right
+    std::array<int32_t, 2> scores;
+    uint32_t rng;
+    uint32_t frame;
+};
+
+inline constexpr uint32_t PONG_TICK_RATE = 60;
+inline constexpr float PONG_FIXED_DT = 1.0f / static_cast<float>(PONG_TICK_RATE);
+
+inline constexpr GameBounds PONG_BOUNDS{-10.0f, 10.0f, 6.0f, -6.0f, -2.0f, 2.0f};
+inline constexpr float PONG_PADDLE_SPEED = 8.0f;
+inline constexpr float PONG_BALL_SPEED = 6.0f;
+inline constexpr float PONG_BALL_SPEED_INCREMENT = 0.5f;
+inline constexpr float PONG_AI_PADDLE_SPEED = 4.0f;
+inline constexpr int32_t PONG_WINNING_SCORE = 10;
+
+/**
+ * @brief Initial state with the ball served from the center
+ * @param seed Serve RNG seed; peers must agree on it
+ */
+PongState pong_initial_state(uint32_t seed);
+
+/**
+ * @brief Advance the simulation by PONG_FIXED_DT
+ *
+ * Deterministic for a given binary and platform, allocation-free and
+ * cheap enough to run many times per frame during a rollback.
+ */
+void pong_step(PongState& state, const std::array<PongInput, 2>& inputs) noexcept;
+
+/**
+ * @brief Input the built-in AI would give for a paddle
+ */
+PongInput pong_ai_input(const PongState& state, uint32_t player) noexcept;
+
+/**
+ * @brief FNV-1a hash of the state, for desync detection
+ */
+uint64_t pong_checksum(const PongState& state) noexcept;
+
+} // namespace game
+} // namespace omnicpp
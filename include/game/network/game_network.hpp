@@ -5,12 +5,21 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <string>
 
+namespace OmniCpp::Engine::Network {
+  class NetworkManager;
+  struct Message;
+}
+
 namespace OmniCpp::Game::Network {
 
   class GameNetwork {
   public:
+    using MessageHandler = std::function<void (const Engine::Network::Message&)>;
+
     GameNetwork ();
     ~GameNetwork ();
 
@@ -18,6 +27,19 @@ namespace OmniCpp::Game::Network {
     void connect (const std::string& address, int port);
     void disconnect ();
     void update ();
+
+    /**
+     * @brief Receive every message update() drains (without one they are discarded)
+     */
+    void set_message_handler (MessageHandler handler);
+
+    [[nodiscard]] bool is_connected () const;
+    [[nodiscard]] Engine::Network::NetworkManager* get_network_manager ();
+
+  private:
+    std::unique_ptr<Engine::Network::NetworkManager> m_network;
+    MessageHandler m_message_handler;
+    bool m_initialized;
   };
 
 } // namespace OmniCpp::Game::Network
@@ -14,13 +14,24 @@
 #include "engine/IResourceManager.hpp"
 #include "engine/ILogger.hpp"
 #include "engine/IPlatform.hpp"
+#include "engine/concurrency/ThreadPool.hpp"
+#include "engine/core/DeterministicProviders.hpp"
+#include "engine/core/frame_pacer.hpp"
+#include "engine/core/frame_pipeline.hpp"
+#include "engine/core/profiler.hpp"
+#include "engine/core/subsystem_graph.hpp"
 #include "engine/logging/Log.hpp"
 #include "engine/window/window_manager.hpp"
 #include "engine/graphics/renderer.hpp"
+#include "engine/platform/headless.hpp"
 
+#include <array>
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace omnicpp {
 
@@ -36,85 +47,110 @@ public:
         // Initialize logging
         omnicpp::log::init();
         omnicpp::log::info("Engine initialization started");
-
-        // Initialize platform
-        if (config.platform) {
-            m_platform.reset(config.platform);
-            if (!m_platform->initialize()) {
-                omnicpp::log::error("Failed to initialize platform");
-                return false;
-            }
-            omnicpp::log::info("Platform initialized");
+        m_config = config;
+        OmniCpp::Engine::Core::Profiler::instance().set_enabled(config.enable_profiling);
+
+        // Take ownership up front so nothing leaks if startup fails part way
+        m_platform.reset(config.platform);
+        m_renderer.reset(config.renderer);
+        m_input_manager.reset(config.input_manager);
+        m_audio_manager.reset(config.audio_manager);
+        m_physics_engine.reset(config.physics_engine);
+        m_resource_manager.reset(config.resource_manager);
+
+        // No GLFW, Qt, GPU or audio device is touched in headless mode
+        const bool windowed = !config.headless;
+        if (!windowed && !m_renderer) {
+            OmniCpp::Engine::Platform::NullRendererConfig renderer_config;
+            renderer_config.enable_frame_capture = config.enable_frame_capture;
+            renderer_config.capture = config.capture;
+            auto null_renderer = std::make_unique<OmniCpp::Engine::Platform::NullRenderer>(renderer_config);
+            m_null_renderer = null_renderer.get();
+            m_renderer = std::move(null_renderer);
         }
-
-        // Initialize window manager and renderer
-        m_window_manager = std::make_unique<OmniCpp::Engine::Window::WindowManager>();
-        if (!m_window_manager->initialize({"OmniCpp Engine", 1280, 720, false, true, true})) {
-            omnicpp::log::error("Failed to initialize window manager");
-            return false;
+        if (!windowed && !m_audio_manager) {
+            m_audio_manager = std::make_unique<OmniCpp::Engine::Platform::NullAudioManager>();
         }
 
-        m_graphics_renderer = std::make_unique<OmniCpp::Engine::Graphics::Renderer>();
-        OmniCpp::Engine::Graphics::RendererConfig renderer_config;
-        renderer_config.vsync = true;
-        renderer_config.msaa_samples = 4;
-        renderer_config.enable_debug = false;
-        if (!m_graphics_renderer->initialize(renderer_config)) {
-            omnicpp::log::error("Failed to initialize graphics renderer");
+        m_time_provider = config.time_provider ? config.time_provider : std::make_shared<omnicpp::core::SystemTimeProvider>();
+        m_virtual_clock = dynamic_cast<omnicpp::core::VirtualTimeProvider*>(m_time_provider.get());
+
+        if (config.fixed_timestep <= 0.0f) {
+            omnicpp::log::error("fixed_timestep must be positive, got {}", config.fixed_timestep);
             return false;
         }
 
-        m_graphics_renderer->set_window_manager(m_window_manager.get());
-
-        // Initialize renderer
-        if (config.renderer) {
-            m_renderer.reset(config.renderer);
-            if (!m_renderer->initialize()) {
-                omnicpp::log::error("Failed to initialize renderer");
-                return false;
-            }
-            omnicpp::log::info("Renderer initialized");
+        // Subsystems declare what they need; independent ones start concurrently.
+        // Anything touching the windowing system or Qt stays on this thread.
+        add_subsystem("platform", {}, m_platform, "platform", windowed);
+
+        if (windowed) {
+            m_subsystems.add({"window", {"platform"},
+                [this]() {
+                    m_window_manager = std::make_unique<OmniCpp::Engine::Window::WindowManager>();
+                    if (!m_window_manager->initialize({"OmniCpp Engine", 1280, 720, false, true, true})) {
+                        omnicpp::log::error("Failed to initialize window manager");
+                        return false;
+                    }
+                    return true;
+                },
+                [this]() { m_window_manager->shutdown(); }, true});
+
+            m_subsystems.add({"graphics", {"window"},
+                [this]() {
+                    m_graphics_renderer = std::make_unique<OmniCpp::Engine::Graphics::Renderer>();
+                    OmniCpp::Engine::Graphics::RendererConfig renderer_config;
+                    renderer_config.vsync = true;
+                    renderer_config.msaa_samples = 4;
+                    renderer_config.enable_debug = false;
+                    renderer_config.enable_frame_capture = m_config.enable_frame_capture;
+                    renderer_config.capture = m_config.capture;
+                    if (!m_graphics_renderer->initialize(renderer_config)) {
+                        omnicpp::log::error("Failed to initialize graphics renderer");
+                        return false;
+                    }
+                    m_graphics_renderer->set_window_manager(m_window_manager.get());
+                    return true;
+                },
+                [this]() { m_graphics_renderer->shutdown(); }, true});
         }
 
-        // Initialize input manager
-        if (config.input_manager) {
-            m_input_manager.reset(config.input_manager);
-            if (!m_input_manager->initialize()) {
-                omnicpp::log::error("Failed to initialize input manager");
-                return false;
-            }
-            omnicpp::log::info("Input manager initialized");
-        }
+        add_subsystem("renderer", windowed ? std::vector<std::string>{"graphics"} : std::vector<std::string>{},
+                      m_renderer, "renderer", windowed);
+        add_subsystem("input", {"platform"}, m_input_manager, "input manager");
+        add_subsystem("audio", {"platform"}, m_audio_manager, "audio manager");
+        add_subsystem("physics", {}, m_physics_engine, "physics engine");
+        add_subsystem("resources", {}, m_resource_manager, "resource manager");
 
-        // Initialize audio manager
-        if (config.audio_manager) {
-            m_audio_manager.reset(config.audio_manager);
-            if (!m_audio_manager->initialize()) {
-                omnicpp::log::error("Failed to initialize audio manager");
-                return false;
-            }
-            omnicpp::log::info("Audio manager initialized");
+        auto* pool = config.parallel_init ? &omnicpp::concurrency::GlobalThreadPool::instance() : nullptr;
+        if (!m_subsystems.initialize(pool)) {
+            omnicpp::log::error("Failed to initialize engine subsystems");
+            return false;
         }
 
-        // Initialize physics engine
-        if (config.physics_engine) {
-            m_physics_engine.reset(config.physics_engine);
-            if (!m_physics_engine->initialize()) {
-                omnicpp::log::error("Failed to initialize physics engine");
-                return false;
-            }
-            omnicpp::log::info("Physics engine initialized");
+        const auto& report = m_subsystems.get_startup_report();
+        omnicpp::log::info("Subsystems initialized in {:.1f} ms ({:.1f} ms serially, {:.1f} ms critical path)",
+                           report.wall_ms, report.serial_ms, report.critical_path_ms);
+
+        // Stage order is data-flow order; see FramePipeline for how they overlap
+        std::vector<OmniCpp::Engine::Core::PipelineStage> stages;
+        stages.push_back({"simulate", [this](uint64_t frame, uint32_t slot) { simulate(frame, slot); }});
+        stages.push_back({"extract", [this](uint64_t, uint32_t slot) { extract(slot); }});
+        stages.push_back({"submit", [this](uint64_t, uint32_t slot) { submit(slot); }, windowed});
+
+        OmniCpp::Engine::Core::FramePipelineConfig pipeline_config;
+        pipeline_config.depth = config.pipeline_depth;
+        if (!m_pipeline.initialize(std::move(stages), pipeline_config)) {
+            omnicpp::log::error("Failed to initialize frame pipeline");
+            m_subsystems.shutdown();
+            return false;
         }
+        m_accumulator = 0.0;
+        m_sim_time = 0.0;
 
-        // Initialize resource manager
-        if (config.resource_manager) {
-            m_resource_manager.reset(config.resource_manager);
-            if (!m_resource_manager->initialize()) {
-                omnicpp::log::error("Failed to initialize resource manager");
-                return false;
-            }
-            omnicpp::log::info("Resource manager initialized");
-        }
+        OmniCpp::Engine::Core::FramePacerConfig pacer_config;
+        pacer_config.target_fps = config.max_fps;
+        m_frame_pacer.initialize(pacer_config);
 
         m_initialized = true;
         omnicpp::log::info("Engine initialization complete");
@@ -128,31 +164,8 @@ public:
 
         omnicpp::log::info("Engine shutdown started");
 
-        // Shutdown in reverse order
-        if (m_resource_manager) {
-            m_resource_manager->shutdown();
-        }
-        if (m_physics_engine) {
-            m_physics_engine->shutdown();
-        }
-        if (m_audio_manager) {
-            m_audio_manager->shutdown();
-        }
-        if (m_input_manager) {
-            m_input_manager->shutdown();
-        }
-        if (m_renderer) {
-            m_renderer->shutdown();
-        }
-        if (m_graphics_renderer) {
-            m_graphics_renderer->shutdown();
-        }
-        if (m_window_manager) {
-            m_window_manager->shutdown();
-        }
-        if (m_platform) {
-            m_platform->shutdown();
-        }
+        // Reverse topological order of how subsystems actually came up
+        m_subsystems.shutdown();
 
         omnicpp::log::info("Engine shutdown complete");
         omnicpp::log::shutdown();
@@ -167,30 +180,35 @@ public:
 
         // Update input
         if (m_input_manager) {
+            OMNICPP_PROFILE_SCOPE("input");
             m_input_manager->process_events(delta_time);
         }
 
         // Update physics
         if (m_physics_engine) {
+            OMNICPP_PROFILE_SCOPE("physics");
             m_physics_engine->update(delta_time);
         }
 
         // Update audio
         if (m_audio_manager) {
+            OMNICPP_PROFILE_SCOPE("audio");
             m_audio_manager->update(delta_time);
         }
 
         // Update window and graphics
         if (m_window_manager) {
+            OMNICPP_PROFILE_SCOPE("window");
             m_window_manager->update();
         }
         if (m_graphics_renderer) {
+            OMNICPP_PROFILE_SCOPE("graphics");
             m_graphics_renderer->update();
         }
 
-        // Check if window should close
+        // Check if window should close; run() stops, shutdown() still runs
         if (m_window_manager && m_window_manager->should_close()) {
-            m_initialized = false;
+            m_running = false;
         }
     }
 
@@ -199,11 +217,6 @@ public:
             return;
         }
 
-        // Check if window should close
-        if (m_window_manager && m_window_manager->should_close()) {
-            m_initialized = false;
-        }
-
         // Update window and graphics
         if (m_window_manager) {
             m_window_manager->update();
@@ -224,6 +237,88 @@ public:
         }
     }
 
+    void run() override {
+        if (!m_initialized) {
+            omnicpp::log::error("Engine not initialized, cannot run");
+            return;
+        }
+
+        omnicpp::log::info("Starting engine main loop");
+        m_running = true;
+        m_frame_pacer.reset();
+        auto last_time = m_time_provider->now();
+        uint64_t frame_count = 0;
+
+        while (m_running) {
+            const auto current_time = m_time_provider->now();
+            const float delta_time = std::chrono::duration<float>(current_time - last_time).count();
+            last_time = current_time;
+
+            // Window/Qt event pumping and input sampling happen on this thread, before
+            // the frame that consumes them is started
+            if (m_input_manager) {
+                OMNICPP_PROFILE_SCOPE("input");
+                m_input_manager->process_events(delta_time);
+            }
+            if (m_window_manager) {
+                OMNICPP_PROFILE_SCOPE_BEGIN(window_scope, "window");
+                m_window_manager->update();
+                OMNICPP_PROFILE_SCOPE_END(window_scope);
+                if (m_window_manager->should_close()) {
+                    break;
+                }
+            }
+
+            // Simulate frame N+1 | extract frame N | submit frame N-1, then fence. The
+            // slot being started was last used by a frame that finished at the previous fence.
+            const auto slot = static_cast<uint32_t>(m_pipeline.get_frames_started() % m_pipeline.get_depth());
+            m_frames[slot].delta_time = delta_time;
+            {
+                OMNICPP_PROFILE_SCOPE("pipeline");
+                m_pipeline.tick();
+            }
+
+            if (m_audio_manager) {
+                OMNICPP_PROFILE_SCOPE("audio");
+                m_audio_manager->update(delta_time);
+            }
+
+            ++frame_count;
+
+            // One profiled frame per loop iteration, pacing wait included in the next
+            OMNICPP_PROFILE_FRAME();
+            if (!m_running || (m_config.max_frames > 0 && frame_count >= m_config.max_frames)) {
+                break;
+            }
+
+            if (m_virtual_clock) {
+                // Virtual time: exactly one fixed step per frame, as fast as the CPU allows
+                m_virtual_clock->advance(std::chrono::duration<float>(m_config.fixed_timestep));
+            } else {
+                // Cap FPS against absolute deadlines (max_fps == 0 runs uncapped)
+                OMNICPP_PROFILE_SCOPE("pace");
+                m_frame_pacer.wait_for_next_frame();
+            }
+        }
+        m_running = false;
+        m_pipeline.flush();
+
+        const auto stats = m_frame_pacer.get_stats();
+        omnicpp::log::info("Frame times ({} frames): mean {:.2f} ms, p50 {:.2f} ms, p90 {:.2f} ms, p99 {:.2f} ms, "
+                           "max {:.2f} ms, {} missed deadlines",
+                           stats.frame_count, stats.mean_ms, stats.p50_ms, stats.p90_ms, stats.p99_ms, stats.max_ms,
+                           stats.missed_deadlines);
+        omnicpp::log::info("Engine main loop stopped");
+    }
+
+    void request_frame_capture(uint32_t frame_count) override {
+        if (m_graphics_renderer) {
+            m_graphics_renderer->request_frame_capture(frame_count);
+        } else if (m_null_renderer) {
+            m_null_renderer->request_frame_capture(frame_count);
+        }
+    }
+
     IRenderer* get_renderer() const override {
         return m_renderer.get();
     }
@@ -257,6 +352,97 @@ public:
     }
 
 private:
+    /**
+     * @brief Per-slot frame data
+     *
+     * simulate fills a slot after its fixed steps; extract and submit read
+     * only that slot, never the live simulation, so they can run while
+     * simulate is already stepping the next frame.
+     */
+    struct FrameData {
+        uint64_t frame = 0;
+        float delta_time = 0.0f;  // Wall time fed into this frame
+        uint32_t steps = 0;       // Fixed steps simulated
+        double sim_time = 0.0;    // Simulated seconds after those steps
+        float alpha = 0.0f;       // Leftover fraction of a step
+        double render_time = 0.0; // Time the submitted frame shows (set by extract)
+    };
+
+    void simulate(uint64_t frame, uint32_t slot) {
+        OMNICPP_PROFILE_SCOPE("simulate");
+        FrameData& data = m_frames[slot];
+        const float step = m_config.fixed_timestep;
+
+        m_accumulator += data.delta_time;
+        data.steps = 0;
+        while (m_accumulator >= step) {
+            if (m_physics_engine) {
+                OMNICPP_PROFILE_SCOPE("physics");
+                m_physics_engine->update(step);
+            }
+            m_accumulator -= step;
+            m_sim_time += step;
+            ++data.steps;
+        }
+
+        data.frame = frame;
+        data.sim_time = m_sim_time;
+        data.alpha = static_cast<float>(m_accumulator / step);
+    }
+
+    void extract(uint32_t slot) {
+        // Present the state interpolated between the last two fixed steps
+        OMNICPP_PROFILE_SCOPE("extract");
+        FrameData& data = m_frames[slot];
+        data.render_time = data.sim_time - (1.0 - data.alpha) * m_config.fixed_timestep;
+    }
+
+    void submit(uint32_t) {
+        if (m_graphics_renderer) {
+            {
+                OMNICPP_PROFILE_SCOPE("graphics");
+                m_graphics_renderer->update();
+            }
+            m_graphics_renderer->render(); // Times its own "record" and "present" scopes
+            m_graphics_renderer->present();
+        }
+        if (m_renderer) {
+            OMNICPP_PROFILE_SCOPE_BEGIN(record_scope, "record");
+            const bool began = m_renderer->begin_frame();
+            OMNICPP_PROFILE_SCOPE_END(record_scope);
+            if (began) {
+                OMNICPP_PROFILE_SCOPE("present");
+                m_renderer->end_frame();
+            }
+        }
+    }
+
+    /**
+     * @brief Register an optional config-supplied subsystem with the startup graph
+     */
+    template<typename T>
+    void add_subsystem(const char* name, std::vector<std::string> dependencies, std::unique_ptr<T>& subsystem,
+                       const char* label, bool main_thread_only = false) {
+        m_subsystems.add({name, std::move(dependencies),
+            [&subsystem, label]() {
+                if (!subsystem) {
+                    return true;
+                }
+                if (!subsystem->initialize()) {
+                    omnicpp::log::error("Failed to initialize {}", label);
+                    return false;
+                }
+                omnicpp::log::info("Initialized {}", label);
+                return true;
+            },
+            [&subsystem]() {
+                if (subsystem) {
+                    subsystem->shutdown();
+                }
+            },
+            main_thread_only});
+    }
+
     std::unique_ptr<IRenderer> m_renderer;
     std::unique_ptr<IInputManager> m_input_manager;
     std::unique_ptr<IAudioManager> m_audio_manager;
@@ -265,7 +451,18 @@ private:
     std::unique_ptr<IPlatform> m_platform;
     std::unique_ptr<OmniCpp::Engine::Window::WindowManager> m_window_manager;
     std::unique_ptr<OmniCpp::Engine::Graphics::Renderer> m_graphics_renderer;
+    OmniCpp::Engine::Platform::NullRenderer* m_null_renderer = nullptr; // Headless m_renderer, for captures
+    std::shared_ptr<omnicpp::core::ITimeProvider> m_time_provider;
+    omnicpp::core::VirtualTimeProvider* m_virtual_clock = nullptr;
+    OmniCpp::Engine::Core::SubsystemGraph m_subsystems;
+    OmniCpp::Engine::Core::FramePipeline m_pipeline;
+    std::array<FrameData, 3> m_frames{}; // One per slot; depth is clamped to the three stages
+    double m_accumulator = 0.0;          // Owned by simulate
+    double m_sim_time = 0.0;
+    OmniCpp::Engine::Core::FramePacer m_frame_pacer;
+    EngineConfig m_config;
     bool m_initialized = false;
+    bool m_running = false;
 };
 
 // Factory functions
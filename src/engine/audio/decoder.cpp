@@ -0,0 +1,200 @@
+/**
+ * @file decoder.cpp
+ * @brief Audio decoder implementations
+ */
+
+#include "engine/audio/decoder.hpp"
+#include "engine/logging/Log.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace omnicpp {
+namespace audio {
+
+  namespace {
+
+    constexpr uint16_t WAVE_FORMAT_PCM = 1;
+    constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+    constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+    uint16_t get_u16 (const uint8_t* in) {
+      return static_cast<uint16_t> (in[0] | in[1] << 8);
+    }
+
+    uint32_t get_u32 (const uint8_t* in) {
+      return static_cast<uint32_t> (in[0]) | static_cast<uint32_t> (in[1]) << 8 |
+             static_cast<uint32_t> (in[2]) << 16 | static_cast<uint32_t> (in[3]) << 24;
+    }
+
+  } // namespace
+
+  WavDecoder::~WavDecoder () {
+    if (m_file) {
+      std::fclose (m_file);
+    }
+  }
+
+  bool WavDecoder::open (const std::string& path) {
+    if (m_file) {
+      std::fclose (m_file);
+    }
+    m_file = std::fopen (path.c_str (), "rb");
+    if (!m_file) {
+      return false;
+    }
+
+    uint8_t riff[12];
+    if (std::fread (riff, 1, sizeof (riff), m_file) != sizeof (riff) || std::memcmp (riff, "RIFF", 4) != 0 ||
+        std::memcmp (riff + 8, "WAVE", 4) != 0) {
+      omnicpp::log::warn ("WavDecoder: '{}' is not a RIFF/WAVE file", path);
+      return false;
+    }
+
+    bool have_format = false;
+    uint8_t chunk[8];
+    while (std::fread (chunk, 1, sizeof (chunk), m_file) == sizeof (chunk)) {
+      const uint32_t size = get_u32 (chunk + 4);
+      const long next = std::ftell (m_file) + static_cast<long> (size + (size & 1)); // Chunks are word-aligned
+      if (std::memcmp (chunk, "fmt ", 4) == 0 && size >= 16) {
+        uint8_t format[40]{};
+        if (std::fread (format, 1, std::min<uint32_t> (size, sizeof (format)), m_file) < 16) {
+          break;
+        }
+        m_format = get_u16 (format);
+        if (m_format == WAVE_FORMAT_EXTENSIBLE && size >= 26) {
+          m_format = get_u16 (format + 24); // First two bytes of the sub-format GUID
+        }
+        m_channels = get_u16 (format + 2);
+        m_sample_rate = get_u32 (format + 4);
+        m_block_align = get_u16 (format + 12);
+        m_bits = get_u16 (format + 14);
+        have_format = true;
+      } else if (std::memcmp (chunk, "data", 4) == 0 && have_format) {
+        const bool supported = (m_format == WAVE_FORMAT_PCM && (m_bits == 8 || m_bits == 16 || m_bits == 24 || m_bits == 32)) ||
+                               (m_format == WAVE_FORMAT_IEEE_FLOAT && m_bits == 32);
+        if (!supported || m_channels == 0 || m_sample_rate == 0 || m_block_align != m_channels * (m_bits / 8)) {
+          omnicpp::log::warn ("WavDecoder: '{}' uses an unsupported encoding (format {}, {} bits)", path, m_format,
+              m_bits);
+          return false;
+        }
+        m_data_offset = std::ftell (m_file);
+        m_frame_count = size / m_block_align;
+        m_cursor = 0;
+        return true;
+      }
+      if (std::fseek (m_file, next, SEEK_SET) != 0) {
+        break;
+      }
+    }
+    omnicpp::log::warn ("WavDecoder: '{}' has no audio data", path);
+    return false;
+  }
+
+  std::size_t WavDecoder::read (std::span<float> out) {
+    if (!m_file || m_channels == 0) {
+      return 0;
+    }
+    const uint64_t frames = std::min<uint64_t> (out.size () / m_channels, m_frame_count - m_cursor);
+    if (frames == 0) {
+      return 0;
+    }
+    m_raw.resize (frames * m_block_align);
+    const std::size_t got = std::fread (m_raw.data (), m_block_align, frames, m_file);
+    m_cursor += got;
+
+    const std::size_t samples = got * m_channels;
+    const uint8_t* in = m_raw.data ();
+    switch (m_bits) {
+      case 8:
+        for (std::size_t i = 0; i < samples; ++i) {
+          out[i] = (static_cast<float> (in[i]) - 128.0f) * (1.0f / 128.0f);
+        }
+        break;
+      case 16:
+        for (std::size_t i = 0; i < samples; ++i) {
+          out[i] = static_cast<float> (static_cast<int16_t> (get_u16 (in + i * 2))) * (1.0f / 32768.0f);
+        }
+        break;
+      case 24:
+        for (std::size_t i = 0; i < samples; ++i) {
+          const uint8_t* s = in + i * 3;
+          const int32_t value = static_cast<int32_t> (static_cast<uint32_t> (s[0]) << 8 |
+                                                      static_cast<uint32_t> (s[1]) << 16 |
+                                                      static_cast<uint32_t> (s[2]) << 24) >> 8;
+          out[i] = static_cast<float> (value) * (1.0f / 8388608.0f);
+        }
+        break;
+      default:
+        if (m_format == WAVE_FORMAT_IEEE_FLOAT) {
+          std::memcpy (out.data (), in, samples * sizeof (float));
+        } else {
+          for (std::size_t i = 0; i < samples; ++i) {
+            out[i] = static_cast<float> (static_cast<int32_t> (get_u32 (in + i * 4))) * (1.0f / 2147483648.0f);
+          }
+        }
+        break;
+    }
+    return got;
+  }
+
+  bool WavDecoder::seek (uint64_t frame) {
+    if (!m_file || frame > m_frame_count) {
+      return false;
+    }
+    if (std::fseek (m_file, m_data_offset + static_cast<long> (frame * m_block_align), SEEK_SET) != 0) {
+      return false;
+    }
+    m_cursor = frame;
+    return true;
+  }
+
+  DecoderRegistry::DecoderRegistry () {
+    register_decoder (".wav", [] (const std::string& path) -> std::unique_ptr<AudioDecoder> {
+      auto decoder = std::make_unique<WavDecoder> ();
+      return decoder->open (path) ? std::move (decoder) : nullptr;
+    });
+  }
+
+  void DecoderRegistry::register_decoder (std::string extension, DecoderFactory factory) {
+    m_factories[std::move (extension)] = std::move (factory);
+  }
+
+  std::unique_ptr<AudioDecoder> DecoderRegistry::open (const std::string& path) const {
+    const auto dot = path.find_last_of ('.');
+    if (dot == std::string::npos) {
+      return nullptr;
+    }
+    std::string extension = path.substr (dot);
+    std::transform (extension.begin (), extension.end (), extension.begin (),
+        [] (unsigned char c) { return static_cast<char> (std::tolower (c)); });
+    auto it = m_factories.find (extension);
+    return it != m_factories.end () ? it->second (path) : nullptr;
+  }
+
+  std::shared_ptr<SoundData> decode_all (AudioDecoder& decoder) {
+    const uint32_t channels = decoder.channels ();
+    if (channels == 0) {
+      return nullptr;
+    }
+    auto sound = std::make_shared<SoundData> ();
+    sound->channels = channels;
+    sound->sample_rate = decoder.sample_rate ();
+    sound->samples.reserve (decoder.frame_count () * channels);
+
+    constexpr std::size_t CHUNK_FRAMES = 4096;
+    std::size_t filled = 0;
+    for (;;) {
+      sound->samples.resize (filled + CHUNK_FRAMES * channels);
+      const std::size_t frames = decoder.read (std::span<float> (sound->samples).subspan (filled));
+      filled += frames * channels;
+      if (frames == 0) {
+        break;
+      }
+    }
+    sound->samples.resize (filled);
+    return filled > 0 ? sound : nullptr;
+  }
+
+} // namespace audio
+} // namespace omnicpp
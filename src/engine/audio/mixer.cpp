@@ -0,0 +1,1145 @@
+/**
+ * @file mixer.cpp
+ * @brief Real-time mixer implementation
+ */
+
+#include "engine/audio/mixer.hpp"
+#include "engine/audio/decoder.hpp"
+#include "engine/concurrency/SpscQueue.hpp"
+#include "engine/logging/Log.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <numbers>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <immintrin.h>
+  #define OMNICPP_AUDIO_SSE 1
+#endif
+
+namespace omnicpp {
+namespace audio {
+
+  namespace {
+
+    constexpr uint64_t FIXED_ONE = uint64_t{ 1 } << 32; // Sound positions are 32.32 fixed-point frames
+    constexpr float FIXED_TO_FLOAT = 1.0f / 4294967296.0f;
+    constexpr float MIN_PITCH = 1.0f / 256.0f;
+    constexpr float MAX_PITCH = 256.0f;
+    constexpr float MAX_STREAM_PITCH = 4.0f; // Bounds how much of a ring one block can read
+
+    int64_t now_ns () {
+      return std::chrono::duration_cast<std::chrono::nanoseconds> (
+          std::chrono::steady_clock::now ().time_since_epoch ())
+          .count ();
+    }
+
+    enum class CommandType : uint8_t { Play, Stop, Pause, Resume, SetGain, SetPan, SetPitch, SetMasterGain };
+
+    /**
+     * @brief Prefetch ring for one streamed voice
+     *
+     * The decoder thread writes and the mixing thread reads; both cursors
+     * are absolute frame counts, so full and empty never look alike.
+     */
+    struct Stream {
+      std::unique_ptr<AudioDecoder> decoder; // Decoder thread only, under the streamer mutex
+      std::vector<float> ring;               // Room for `capacity` stereo frames
+      uint32_t capacity{ 0 };
+      uint32_t channels{ 1 };
+      uint32_t sample_rate{ 48000 };
+      bool loop{ false };
+      std::atomic<uint64_t> written{ 0 };
+      std::atomic<uint64_t> read{ 0 };
+      std::atomic<bool> ended{ false }; // Set after the final frames are published
+    };
+
+    struct Command {
+      CommandType type{ CommandType::Play };
+      uint16_t slot{ 0 };
+      uint16_t generation{ 0 };
+      const SoundData* sound{ nullptr };
+      Stream* stream{ nullptr };
+      float value{ 0.0f };
+      VoiceParams params;
+    };
+
+    struct FinishedEvent {
+      uint16_t slot{ 0 };
+      uint16_t generation{ 0 };
+    };
+
+    /**
+     * @brief Voice state owned by the mixing thread
+     */
+    struct Voice {
+      const SoundData* sound{ nullptr };
+      Stream* stream{ nullptr };
+      uint64_t position{ 0 };
+      uint64_t step{ FIXED_ONE };
+      float rate_ratio{ 1.0f };
+      float gain{ 1.0f };
+      float pan{ 0.0f };
+      float pitch{ 1.0f };
+      float left{ 0.0f };  // Channel gains reached at the end of the last block
+      float right{ 0.0f };
+      float target_left{ 0.0f };
+      float target_right{ 0.0f };
+      uint32_t channels{ 1 };
+      uint16_t generation{ 0 };
+      bool active{ false };
+      bool paused{ false };
+      bool loop{ false };
+      bool stopping{ false };
+      bool started{ false }; // Streams: first frames have arrived
+    };
+
+    void update_step (Voice& voice) {
+      const double step = static_cast<double> (voice.rate_ratio) * voice.pitch * static_cast<double> (FIXED_ONE);
+      voice.step = std::max<uint64_t> (1, static_cast<uint64_t> (step));
+    }
+
+    void update_targets (Voice& voice) {
+      const float pan = std::clamp (voice.pan, -1.0f, 1.0f);
+      if (voice.channels == 2) {
+        // Balance: attenuate the far channel only
+        voice.target_left = voice.gain * std::min (1.0f, 1.0f - pan);
+        voice.target_right = voice.gain * std::min (1.0f, 1.0f + pan);
+      } else {
+        // Constant power: centre is -3 dB on each side
+        const float angle = (pan + 1.0f) * std::numbers::pi_v<float> * 0.25f;
+        voice.target_left = voice.gain * std::cos (angle);
+        voice.target_right = voice.gain * std::sin (angle);
+      }
+    }
+
+    /**
+     * @brief Linear interpolation of `count` frames whose sample pairs lie inside the sound
+     */
+    void interpolate (const float* data, uint32_t channels, uint64_t position, uint64_t step, float* left,
+        float* right, uint32_t count) {
+      if (step == FIXED_ONE && (position & (FIXED_ONE - 1)) == 0) {
+        // Unity rate on a frame boundary: a copy (or de-interleave)
+        const float* source = data + (position >> 32) * channels;
+        if (channels == 1) {
+          std::memcpy (left, source, count * sizeof (float));
+          return;
+        }
+        uint32_t i = 0;
+#if defined(OMNICPP_AUDIO_SSE)
+        for (; i + 4 <= count; i += 4) {
+          const __m128 a = _mm_loadu_ps (source + i * 2);
+          const __m128 b = _mm_loadu_ps (source + i * 2 + 4);
+          _mm_storeu_ps (left + i, _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+          _mm_storeu_ps (right + i, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+        }
+#endif
+        for (; i < count; ++i) {
+          left[i] = source[i * 2];
+          right[i] = source[i * 2 + 1];
+        }
+        return;
+      }
+
+      uint32_t i = 0;
+#if defined(OMNICPP_AUDIO_SSE)
+      // Index and fraction in scalar fixed point, the lerp four frames at a time
+      for (; i + 4 <= count; i += 4) {
+        alignas (16) float fraction[4];
+        alignas (16) float a_left[4], b_left[4], a_right[4], b_right[4];
+        for (uint32_t k = 0; k < 4; ++k) {
+          const uint64_t p = position + (i + k) * step;
+          const float* frame = data + (p >> 32) * channels;
+          fraction[k] = static_cast<float> (static_cast<uint32_t> (p)) * FIXED_TO_FLOAT;
+          a_left[k] = frame[0];
+          b_left[k] = frame[channels];
+          if (channels == 2) {
+            a_right[k] = frame[1];
+            b_right[k] = frame[3];
+          }
+        }
+        const __m128 f = _mm_load_ps (fraction);
+        const __m128 a = _mm_load_ps (a_left);
+        _mm_storeu_ps (left + i, _mm_add_ps (a, _mm_mul_ps (_mm_sub_ps (_mm_load_ps (b_left), a), f)));
+        if (channels == 2) {
+          const __m128 c = _mm_load_ps (a_right);
+          _mm_storeu_ps (right + i, _mm_add_ps (c, _mm_mul_ps (_mm_sub_ps (_mm_load_ps (b_right), c), f)));
+        }
+      }
+#endif
+      for (; i < count; ++i) {
+        const uint64_t p = position + i * step;
+        const float* frame = data + (p >> 32) * channels;
+        const float f = static_cast<float> (static_cast<uint32_t> (p)) * FIXED_TO_FLOAT;
+        left[i] = frame[0] + (frame[channels] - frame[0]) * f;
+        if (channels == 2) {
+          right[i] = frame[1] + (frame[3] - frame[1]) * f;
+        }
+      }
+    }
+
+    /**
+     * @brief Contiguous interleaved frames: a resident sound, or a window copied out of a stream ring
+     */
+    struct SourceView {
+      const float* data{ nullptr };
+      uint64_t frames{ 0 };
+      uint32_t channels{ 1 };
+    };
+
+    /**
+     * @brief Resample up to `count` frames into planar scratch
+     * @return Frames produced; fewer than `count` when a one-shot source ends
+     */
+    uint32_t resample (const SourceView& source, uint64_t& position, uint64_t step, bool loop, float* left,
+        float* right, uint32_t count) {
+      const float* data = source.data;
+      const uint32_t channels = source.channels;
+      const uint64_t end = source.frames << 32;
+      const uint64_t last = source.frames > 0 ? (source.frames - 1) << 32 : 0; // Past this, frame + 1 is outside
+
+      uint32_t produced = 0;
+      while (produced < count) {
+        if (position >= end) {
+          if (!loop || end == 0) {
+            break;
+          }
+          position %= end;
+          continue;
+        }
+        if (position < last) {
+          const uint64_t safe = (last - 1 - position) / step + 1;
+          const uint32_t run = static_cast<uint32_t> (std::min<uint64_t> (safe, count - produced));
+          interpolate (data, channels, position, step, left + produced, right + produced, run);
+          produced += run;
+          position += run * step;
+          continue;
+        }
+        // Final frame: blend toward the loop start, or toward silence
+        const float* frame = data + (position >> 32) * channels;
+        const float f = static_cast<float> (static_cast<uint32_t> (position)) * FIXED_TO_FLOAT;
+        const float next_left = loop ? data[0] : 0.0f;
+        left[produced] = frame[0] + (next_left - frame[0]) * f;
+        if (channels == 2) {
+          const float next_right = loop ? data[1] : 0.0f;
+          right[produced] = frame[1] + (next_right - frame[1]) * f;
+        }
+        ++produced;
+        position += step;
+      }
+      return produced;
+    }
+
+    /**
+     * @brief Copy `frames` frames starting at absolute frame `from` out of a ring (handles the wrap)
+     */
+    void copy_from_ring (const Stream& stream, uint64_t from, uint64_t frames, float* out) {
+      const uint32_t channels = stream.channels;
+      const uint64_t start = from % stream.capacity;
+      const uint64_t first = std::min<uint64_t> (frames, stream.capacity - start);
+      std::memcpy (out, stream.ring.data () + start * channels, first * channels * sizeof (float));
+      std::memcpy (out + first * channels, stream.ring.data (), (frames - first) * channels * sizeof (float));
+    }
+
+    void copy_to_ring (Stream& stream, uint64_t to, uint64_t frames, const float* in) {
+      const uint32_t channels = stream.channels;
+      const uint64_t start = to % stream.capacity;
+      const uint64_t first = std::min<uint64_t> (frames, stream.capacity - start);
+      std::memcpy (stream.ring.data () + start * channels, in, first * channels * sizeof (float));
+      std::memcpy (stream.ring.data (), in + first * channels, (frames - first) * channels * sizeof (float));
+    }
+
+    /**
+     * @brief destination += source * gain, the gain ramping linearly from `from` to `to`
+     */
+    void accumulate (float* destination, const float* source, float from, float to, uint32_t count) {
+      if (from == 0.0f && to == 0.0f) {
+        return;
+      }
+      const float delta = (to - from) / static_cast<float> (count);
+      uint32_t i = 0;
+#if defined(OMNICPP_AUDIO_SSE)
+      __m128 gain = _mm_add_ps (_mm_set1_ps (from), _mm_mul_ps (_mm_set1_ps (delta), _mm_setr_ps (1, 2, 3, 4)));
+      const __m128 increment = _mm_set1_ps (delta * 4.0f);
+      for (; i + 4 <= count; i += 4) {
+        const __m128 mixed = _mm_add_ps (_mm_loadu_ps (destination + i), _mm_mul_ps (_mm_loadu_ps (source + i), gain));
+        _mm_storeu_ps (destination + i, mixed);
+        gain = _mm_add_ps (gain, increment);
+      }
+#endif
+      for (; i < count; ++i) {
+        destination[i] += source[i] * (from + delta * static_cast<float> (i + 1));
+      }
+    }
+
+    /**
+     * @brief Apply the master gain ramp, clamp to [-1, 1] and interleave
+     */
+    void interleave (float* out, const float* left, const float* right, float from, float to, uint32_t count) {
+      const float delta = (to - from) / static_cast<float> (count);
+      uint32_t i = 0;
+#if defined(OMNICPP_AUDIO_SSE)
+      __m128 gain = _mm_add_ps (_mm_set1_ps (from), _mm_mul_ps (_mm_set1_ps (delta), _mm_setr_ps (1, 2, 3, 4)));
+      const __m128 increment = _mm_set1_ps (delta * 4.0f);
+      const __m128 high = _mm_set1_ps (1.0f);
+      const __m128 low = _mm_set1_ps (-1.0f);
+      for (; i + 4 <= count; i += 4) {
+        const __m128 l = _mm_max_ps (low, _mm_min_ps (high, _mm_mul_ps (_mm_loadu_ps (left + i), gain)));
+        const __m128 r = _mm_max_ps (low, _mm_min_ps (high, _mm_mul_ps (_mm_loadu_ps (right + i), gain)));
+        _mm_storeu_ps (out + i * 2, _mm_unpacklo_ps (l, r));
+        _mm_storeu_ps (out + i * 2 + 4, _mm_unpackhi_ps (l, r));
+        gain = _mm_add_ps (gain, increment);
+      }
+#endif
+      for (; i < count; ++i) {
+        const float g = from + delta * static_cast<float> (i + 1);
+        out[i * 2] = std::clamp (left[i] * g, -1.0f, 1.0f);
+        out[i * 2 + 1] = std::clamp (right[i] * g, -1.0f, 1.0f);
+      }
+    }
+
+    void put_u16 (uint8_t* out, uint16_t value) {
+      out[0] = static_cast<uint8_t> (value);
+      out[1] = static_cast<uint8_t> (value >> 8);
+    }
+
+    void put_u32 (uint8_t* out, uint32_t value) {
+      for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t> (value >> (i * 8));
+      }
+    }
+
+    constexpr std::size_t WAV_HEADER_SIZE = 44;
+
+  } // namespace
+
+  // ---------------------------------------------------------------------------
+  // Output devices
+  // ---------------------------------------------------------------------------
+
+  NullAudioOutput::NullAudioOutput (bool paced) : m_paced (paced) {
+  }
+
+  bool NullAudioOutput::open (uint32_t sample_rate, uint32_t /*block_frames*/) {
+    m_sample_rate = sample_rate;
+    m_frames_written = 0;
+    m_start_ns = now_ns ();
+    return sample_rate > 0;
+  }
+
+  bool NullAudioOutput::write (std::span<const float> interleaved) {
+    m_frames_written += interleaved.size () / 2;
+    if (m_paced) {
+      // Sleep until the device would have played everything written so far
+      const auto due = std::chrono::nanoseconds (
+          m_start_ns + static_cast<int64_t> (m_frames_written * 1'000'000'000ull / m_sample_rate));
+      std::this_thread::sleep_until (std::chrono::steady_clock::time_point (due));
+    }
+    return true;
+  }
+
+  void NullAudioOutput::close () {
+  }
+
+  WavFileOutput::WavFileOutput (std::string path) : m_path (std::move (path)) {
+  }
+
+  WavFileOutput::~WavFileOutput () {
+    close ();
+  }
+
+  bool WavFileOutput::open (uint32_t sample_rate, uint32_t /*block_frames*/) {
+    close ();
+    m_file = std::fopen (m_path.c_str (), "wb");
+    if (!m_file) {
+      omnicpp::log::error ("WavFileOutput: Cannot open '{}'", m_path);
+      return false;
+    }
+    m_frames_written = 0;
+
+    // Sizes are patched in close()
+    uint8_t header[WAV_HEADER_SIZE]{};
+    std::memcpy (header, "RIFF", 4);
+    std::memcpy (header + 8, "WAVEfmt ", 8);
+    put_u32 (header + 16, 16);
+    put_u16 (header + 20, 3); // WAVE_FORMAT_IEEE_FLOAT
+    put_u16 (header + 22, 2);
+    put_u32 (header + 24, sample_rate);
+    put_u32 (header + 28, sample_rate * 2 * sizeof (float));
+    put_u16 (header + 32, 2 * sizeof (float));
+    put_u16 (header + 34, 32);
+    std::memcpy (header + 36, "data", 4);
+    return std::fwrite (header, 1, sizeof (header), m_file) == sizeof (header);
+  }
+
+  bool WavFileOutput::write (std::span<const float> interleaved) {
+    if (!m_file) {
+      return false;
+    }
+    // Host floats are written as-is: every supported target is little-endian
+    const std::size_t written = std::fwrite (interleaved.data (), sizeof (float), interleaved.size (), m_file);
+    m_frames_written += written / 2;
+    return written == interleaved.size ();
+  }
+
+  void WavFileOutput::close () {
+    if (!m_file) {
+      return;
+    }
+    const uint32_t data_bytes = static_cast<uint32_t> (m_frames_written * 2 * sizeof (float));
+    uint8_t size[4];
+    put_u32 (size, static_cast<uint32_t> (WAV_HEADER_SIZE - 8 + data_bytes));
+    std::fseek (m_file, 4, SEEK_SET);
+    std::fwrite (size, 1, 4, m_file);
+    put_u32 (size, data_bytes);
+    std::fseek (m_file, 40, SEEK_SET);
+    std::fwrite (size, 1, 4, m_file);
+    std::fclose (m_file);
+    m_file = nullptr;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Mixer
+  // ---------------------------------------------------------------------------
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct Mixer::Impl {
+    struct ControlVoice {
+      uint16_t generation{ 0 };
+      SoundId sound{ INVALID_SOUND };
+      int32_t stream{ -1 }; // Index into streams for streamed voices
+      bool busy{ false };
+    };
+
+    struct SoundEntry {
+      std::shared_ptr<const SoundData> data;
+      uint32_t voices{ 0 };
+      bool removed{ false };
+    };
+
+    MixerConfig config;
+    bool initialized{ false };
+
+    // Control thread
+    std::vector<ControlVoice> control_voices;
+    std::vector<uint16_t> free_slots;
+    std::vector<SoundEntry> sounds; // SoundId - 1
+    std::vector<SoundId> free_sound_ids;
+    std::vector<SoundId> pending_removal;
+    std::vector<std::unique_ptr<Stream>> streams; // Rings allocated once at initialize()
+    std::vector<uint16_t> free_streams;
+
+    std::unique_ptr<concurrency::SpscQueue<Command>> commands;
+    std::unique_ptr<concurrency::SpscQueue<FinishedEvent>> finished;
+
+    // Mixing thread
+    std::vector<Voice> voices;
+    std::vector<uint16_t> active; // Slots of active voices
+    std::vector<float> scratch_left;
+    std::vector<float> scratch_right;
+    std::vector<float> mix_left;
+    std::vector<float> mix_right;
+    std::vector<float> stream_window; // Linear copy of the part of a ring one block reads
+    float master_gain{ 1.0f };
+    float master_target{ 1.0f };
+
+    // Output thread
+    std::unique_ptr<AudioOutput> output;
+    std::vector<float> output_block;
+    std::thread thread;
+    std::atomic<bool> running{ false };
+
+    // Decoder thread
+    std::thread stream_thread;
+    std::mutex stream_mutex; // Guards `streaming` and decoders against the control thread, never taken by the mixer
+    std::condition_variable stream_wake;
+    std::vector<Stream*> streaming;
+    std::vector<float> decode_scratch;
+    bool stream_running{ false };
+
+    // Counters: single writer each, so plain load/store suffices
+    std::atomic<uint64_t> blocks{ 0 };
+    std::atomic<uint64_t> voices_mixed{ 0 };
+    std::atomic<uint64_t> mix_ns{ 0 };
+    std::atomic<uint64_t> commands_applied{ 0 };
+    std::atomic<uint64_t> dropped_commands{ 0 };
+    std::atomic<uint32_t> peak_voices{ 0 };
+    std::atomic<uint64_t> stream_frames_decoded{ 0 };
+    std::atomic<uint64_t> stream_underruns{ 0 };
+
+    static void bump (std::atomic<uint64_t>& counter, uint64_t amount) {
+      counter.store (counter.load (std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static VoiceHandle make_handle (uint16_t slot, uint16_t generation) {
+      return VoiceHandle{ static_cast<uint32_t> (generation) << 16 | static_cast<uint32_t> (slot + 1) };
+    }
+
+    ControlVoice* find (VoiceHandle handle) {
+      const uint32_t slot = (handle.value & 0xFFFF) - 1;
+      if (!handle.valid () || slot >= control_voices.size ()) {
+        return nullptr;
+      }
+      ControlVoice& voice = control_voices[slot];
+      return voice.busy && voice.generation == (handle.value >> 16) ? &voice : nullptr;
+    }
+
+    bool push (const Command& command) {
+      if (!commands || !commands->try_push (command)) {
+        bump (dropped_commands, 1);
+        return false;
+      }
+      return true;
+    }
+
+    bool send (VoiceHandle handle, CommandType type, float value) {
+      ControlVoice* voice = find (handle);
+      if (!voice) {
+        return false;
+      }
+      Command command;
+      command.type = type;
+      command.slot = static_cast<uint16_t> ((handle.value & 0xFFFF) - 1);
+      command.generation = voice->generation;
+      command.value = value;
+      return push (command);
+    }
+
+    void release_sound (SoundId id) {
+      sounds[id - 1] = {};
+      free_sound_ids.push_back (id);
+    }
+
+    /**
+     * @brief Play command for the next free slot (generation already advanced)
+     */
+    Command next_play (const VoiceParams& params) const {
+      const uint16_t slot = free_slots.back ();
+      Command command;
+      command.type = CommandType::Play;
+      command.slot = slot;
+      command.generation = static_cast<uint16_t> (control_voices[slot].generation + 1);
+      command.params = params;
+      return command;
+    }
+
+    VoiceHandle claim (const Command& play, SoundId sound, int32_t stream) {
+      free_slots.pop_back ();
+      ControlVoice& voice = control_voices[play.slot];
+      voice.generation = play.generation;
+      voice.sound = sound;
+      voice.stream = stream;
+      voice.busy = true;
+      return make_handle (play.slot, play.generation);
+    }
+
+    // --- Mixing thread -------------------------------------------------------
+
+    void finish (std::size_t active_index) {
+      const uint16_t slot = active[active_index];
+      Voice& voice = voices[slot];
+      voice.active = false;
+      voice.sound = nullptr;
+      voice.stream = nullptr;
+      // Sized to max_voices and a slot is only replayed after its event is consumed: never full
+      (void) finished->try_push (FinishedEvent{ slot, voice.generation });
+      active[active_index] = active.back ();
+      active.pop_back ();
+    }
+
+    static float clamp_pitch (const Voice& voice, float pitch) {
+      return std::clamp (pitch, MIN_PITCH, voice.stream ? MAX_STREAM_PITCH : MAX_PITCH);
+    }
+
+    /**
+     * @brief Resample a streamed voice from its ring
+     * @param done Set when the stream has ended and every frame was played
+     */
+    uint32_t render_stream (Voice& voice, uint32_t frames, bool& done) {
+      Stream& stream = *voice.stream;
+      const bool ended = stream.ended.load (std::memory_order_acquire); // Before `written`: covers every final frame
+      const uint64_t read = stream.read.load (std::memory_order_relaxed);
+      const uint64_t available = stream.written.load (std::memory_order_acquire) - read;
+      const uint64_t needed = ((voice.position + (frames - 1) * voice.step) >> 32) + 2;
+      const uint64_t window = stream_window.size () / stream.channels;
+      const uint64_t take = std::min ({ available, needed, window });
+      copy_from_ring (stream, read, take, stream_window.data ());
+
+      uint32_t count = frames;
+      if (!ended) {
+        // Only frames whose interpolation pair is already buffered; the rest waits for the decoder
+        const uint64_t last = take >= 2 ? (take - 1) << 32 : 0;
+        count = voice.position < last
+                    ? static_cast<uint32_t> (std::min<uint64_t> (frames, (last - 1 - voice.position) / voice.step + 1))
+                    : 0;
+      }
+      const uint32_t produced = resample ({ stream_window.data (), take, stream.channels }, voice.position, voice.step,
+          false, scratch_left.data (), scratch_right.data (), count);
+
+      const uint64_t consumed = std::min (voice.position >> 32, take);
+      voice.position -= consumed << 32;
+      stream.read.store (read + consumed, std::memory_order_release);
+
+      if (produced < frames) {
+        done = ended;
+        if (!ended && voice.started) {
+          bump (stream_underruns, 1);
+        }
+      }
+      voice.started = voice.started || produced > 0;
+      return produced;
+    }
+
+    void apply (const Command& command) {
+      Voice& voice = voices[command.slot];
+      if (command.type == CommandType::SetMasterGain) {
+        master_target = command.value;
+        return;
+      }
+      if (command.type == CommandType::Play) {
+        if (!voice.active) {
+          active.push_back (command.slot);
+        }
+        voice = {};
+        voice.sound = command.sound;
+        voice.stream = command.stream;
+        voice.generation = command.generation;
+        voice.channels = command.stream ? command.stream->channels : command.sound->channels;
+        const uint32_t rate = command.stream ? command.stream->sample_rate : command.sound->sample_rate;
+        voice.rate_ratio = static_cast<float> (rate) / static_cast<float> (config.sample_rate);
+        voice.gain = command.params.gain;
+        voice.pan = command.params.pan;
+        voice.pitch = clamp_pitch (voice, command.params.pitch);
+        voice.loop = !command.stream && command.params.loop; // Streams loop in the decoder
+        voice.active = true;
+        if (command.sound && command.params.start_frame > 0) {
+          const uint64_t frames = command.sound->frame_count ();
+          const uint64_t start = voice.loop ? command.params.start_frame % frames : command.params.start_frame;
+          voice.position = std::min (start, frames) << 32; // Past the end: finishes in the first block
+        }
+        update_step (voice);
+        update_targets (voice);
+        voice.left = voice.target_left; // Start at full level: onsets stay sharp
+        voice.right = voice.target_right;
+        return;
+      }
+      if (!voice.active || voice.generation != command.generation) {
+        return; // The voice ended before the command arrived
+      }
+      switch (command.type) {
+        case CommandType::Stop:
+          voice.stopping = true;
+          voice.target_left = 0.0f;
+          voice.target_right = 0.0f;
+          break;
+        case CommandType::Pause:
+          voice.paused = true;
+          break;
+        case CommandType::Resume:
+          voice.paused = false;
+          break;
+        case CommandType::SetGain:
+          voice.gain = command.value;
+          update_targets (voice);
+          break;
+        case CommandType::SetPan:
+          voice.pan = command.value;
+          update_targets (voice);
+          break;
+        case CommandType::SetPitch:
+          voice.pitch = clamp_pitch (voice, command.value);
+          update_step (voice);
+          break;
+        default:
+          break;
+      }
+    }
+
+    void render (std::span<float> out) {
+      const int64_t start = now_ns ();
+      const uint32_t frames = static_cast<uint32_t> (std::min<std::size_t> (out.size () / 2, config.block_frames));
+
+      uint64_t applied = 0;
+      while (auto command = commands->try_pop ()) {
+        apply (*command);
+        ++applied;
+      }
+
+      std::fill_n (mix_left.begin (), frames, 0.0f);
+      std::fill_n (mix_right.begin (), frames, 0.0f);
+      const uint32_t active_count = static_cast<uint32_t> (active.size ());
+      uint64_t mixed = 0;
+      for (std::size_t i = 0; i < active.size ();) {
+        Voice& voice = voices[active[i]];
+        if (voice.paused) {
+          if (voice.stopping) {
+            finish (i);
+            continue;
+          }
+          ++i;
+          continue;
+        }
+        bool done = false;
+        uint32_t produced;
+        if (voice.stream) {
+          produced = render_stream (voice, frames, done);
+        } else {
+          const SoundData& sound = *voice.sound;
+          produced = resample ({ sound.samples.data (), sound.frame_count (), sound.channels }, voice.position,
+              voice.step, voice.loop, scratch_left.data (), scratch_right.data (), frames);
+          done = produced < frames;
+        }
+        if (produced > 0) {
+          const float* right = voice.channels == 2 ? scratch_right.data () : scratch_left.data ();
+          accumulate (mix_left.data (), scratch_left.data (), voice.left, voice.target_left, produced);
+          accumulate (mix_right.data (), right, voice.right, voice.target_right, produced);
+          ++mixed;
+        }
+        voice.left = voice.target_left;
+        voice.right = voice.target_right;
+        if (done || voice.stopping) {
+          finish (i);
+          continue;
+        }
+        ++i;
+      }
+
+      interleave (out.data (), mix_left.data (), mix_right.data (), master_gain, master_target, frames);
+      master_gain = master_target;
+      std::fill (out.begin () + frames * 2, out.end (), 0.0f);
+
+      bump (blocks, 1);
+      bump (voices_mixed, mixed);
+      bump (commands_applied, applied);
+      bump (mix_ns, static_cast<uint64_t> (now_ns () - start));
+      if (active_count > peak_voices.load (std::memory_order_relaxed)) {
+        peak_voices.store (active_count, std::memory_order_relaxed);
+      }
+    }
+
+    void run () {
+      while (running.load (std::memory_order_acquire)) {
+        render (output_block);
+        if (!output->write (output_block)) {
+          omnicpp::log::error ("Mixer: Output device write failed, stopping mixer thread");
+          running.store (false, std::memory_order_release);
+        }
+      }
+    }
+
+    // --- Decoder thread ------------------------------------------------------
+
+    /**
+     * @brief Top the ring up once it has drained below the low watermark
+     */
+    void refill (Stream& stream) {
+      uint64_t written = stream.written.load (std::memory_order_relaxed);
+      if (stream.ended.load (std::memory_order_relaxed) ||
+          written - stream.read.load (std::memory_order_acquire) >= config.stream_low_watermark) {
+        return;
+      }
+      const uint32_t channels = stream.channels;
+      bool rewound = false;
+      for (;;) {
+        const uint64_t space = stream.capacity - (written - stream.read.load (std::memory_order_acquire));
+        if (space == 0) {
+          return;
+        }
+        const std::size_t want = static_cast<std::size_t> (std::min<uint64_t> (space, config.stream_chunk_frames));
+        const std::size_t frames = stream.decoder->read (std::span<float> (decode_scratch.data (), want * channels));
+        if (frames == 0) {
+          // Looping: rewind and carry on in the same ring, so the seam is sample-accurate
+          if (stream.loop && !rewound && stream.decoder->seek (0)) {
+            rewound = true; // Empty again straight after a rewind: nothing to loop
+            continue;
+          }
+          stream.ended.store (true, std::memory_order_release);
+          return;
+        }
+        rewound = false;
+        copy_to_ring (stream, written, frames, decode_scratch.data ());
+        written += frames;
+        stream.written.store (written, std::memory_order_release);
+        bump (stream_frames_decoded, frames);
+      }
+    }
+
+    void stream_loop () {
+      // Poll several times per low-watermark period so a slow read still lands in time
+      const auto interval = std::chrono::microseconds (std::clamp<uint64_t> (
+          1'000'000ull * config.stream_low_watermark / config.sample_rate / 4, 500, 20'000));
+      std::unique_lock<std::mutex> lock (stream_mutex);
+      while (stream_running) {
+        for (Stream* stream : streaming) {
+          refill (*stream);
+        }
+        stream_wake.wait_for (lock, interval);
+      }
+    }
+  };
+
+  Mixer::Mixer () : m_impl (std::make_unique<Impl> ()) {
+  }
+
+  Mixer::~Mixer () {
+    if (m_impl) {
+      shutdown ();
+    }
+  }
+
+  Mixer::Mixer (Mixer&& other) noexcept : m_impl (std::move (other.m_impl)) {
+  }
+
+  Mixer& Mixer::operator= (Mixer&& other) noexcept {
+    if (this != &other) {
+      if (m_impl) {
+        shutdown ();
+      }
+      m_impl = std::move (other.m_impl);
+    }
+    return *this;
+  }
+
+  bool Mixer::initialize (const MixerConfig& config) {
+    if (m_impl->initialized) {
+      omnicpp::log::warn ("Mixer: Already initialized");
+      return true;
+    }
+    if (config.sample_rate == 0 || config.block_frames == 0 || config.max_voices == 0 ||
+        config.max_voices > 0xFFFF) {
+      omnicpp::log::error ("Mixer: Invalid configuration ({} Hz, {} frames, {} voices)", config.sample_rate,
+          config.block_frames, config.max_voices);
+      return false;
+    }
+    if (config.max_streams > 0 &&
+        (config.stream_chunk_frames == 0 || config.stream_buffer_frames < config.stream_chunk_frames ||
+            config.stream_low_watermark > config.stream_buffer_frames)) {
+      omnicpp::log::error ("Mixer: Invalid stream configuration ({} frame rings, {} frame chunks, watermark {})",
+          config.stream_buffer_frames, config.stream_chunk_frames, config.stream_low_watermark);
+      return false;
+    }
+
+    Impl& impl = *m_impl;
+    impl.config = config;
+    impl.control_voices.assign (config.max_voices, {});
+    impl.free_slots.clear ();
+    for (uint32_t slot = config.max_voices; slot-- > 0;) {
+      impl.free_slots.push_back (static_cast<uint16_t> (slot));
+    }
+    impl.commands = std::make_unique<concurrency::SpscQueue<Command>> (config.command_capacity);
+    impl.finished = std::make_unique<concurrency::SpscQueue<FinishedEvent>> (config.max_voices);
+
+    impl.voices.assign (config.max_voices, {});
+    impl.active.clear ();
+    impl.active.reserve (config.max_voices);
+    impl.scratch_left.assign (config.block_frames, 0.0f);
+    impl.scratch_right.assign (config.block_frames, 0.0f);
+    impl.mix_left.assign (config.block_frames, 0.0f);
+    impl.mix_right.assign (config.block_frames, 0.0f);
+    impl.output_block.assign (config.block_frames * 2, 0.0f);
+    impl.master_gain = impl.master_target = 1.0f;
+
+    impl.streams.clear ();
+    impl.free_streams.clear ();
+    for (uint32_t i = 0; i < config.max_streams; ++i) {
+      auto stream = std::make_unique<Stream> ();
+      stream->capacity = config.stream_buffer_frames;
+      stream->ring.assign (static_cast<std::size_t> (config.stream_buffer_frames) * 2, 0.0f);
+      impl.streams.push_back (std::move (stream));
+      impl.free_streams.push_back (static_cast<uint16_t> (config.max_streams - 1 - i));
+    }
+    if (config.max_streams > 0) {
+      impl.stream_window.assign (
+          (static_cast<std::size_t> (static_cast<float> (config.block_frames) * MAX_STREAM_PITCH) + 2) * 2, 0.0f);
+      impl.decode_scratch.assign (static_cast<std::size_t> (config.stream_chunk_frames) * 2, 0.0f);
+      impl.streaming.reserve (config.max_streams);
+      impl.stream_running = true;
+      impl.stream_thread = std::thread ([&impl] () { impl.stream_loop (); });
+    }
+    impl.initialized = true;
+
+    omnicpp::log::info ("Mixer: Initialized ({} Hz, {}-frame blocks, {} voices)", config.sample_rate,
+        config.block_frames, config.max_voices);
+    return true;
+  }
+
+  void Mixer::shutdown () {
+    if (!m_impl->initialized) {
+      return;
+    }
+    stop_output ();
+
+    Impl& impl = *m_impl;
+    if (impl.stream_thread.joinable ()) {
+      {
+        std::lock_guard<std::mutex> lock (impl.stream_mutex);
+        impl.stream_running = false;
+      }
+      impl.stream_wake.notify_one ();
+      impl.stream_thread.join ();
+    }
+    impl.streaming.clear ();
+    impl.streams.clear ();
+    impl.free_streams.clear ();
+    impl.voices.clear ();
+    impl.active.clear ();
+    impl.commands.reset ();
+    impl.finished.reset ();
+    impl.control_voices.clear ();
+    impl.free_slots.clear ();
+    impl.sounds.clear ();
+    impl.free_sound_ids.clear ();
+    impl.pending_removal.clear ();
+    impl.initialized = false;
+
+    omnicpp::log::info ("Mixer: Shutdown");
+  }
+
+  SoundId Mixer::add_sound (std::shared_ptr<const SoundData> sound) {
+    Impl& impl = *m_impl;
+    if (!impl.initialized || !sound || sound->channels < 1 || sound->channels > 2 || sound->sample_rate == 0 ||
+        sound->frame_count () == 0) {
+      return INVALID_SOUND;
+    }
+    SoundId id;
+    if (!impl.free_sound_ids.empty ()) {
+      id = impl.free_sound_ids.back ();
+      impl.free_sound_ids.pop_back ();
+    } else {
+      impl.sounds.emplace_back ();
+      id = static_cast<SoundId> (impl.sounds.size ());
+    }
+    impl.sounds[id - 1].data = std::move (sound);
+    return id;
+  }
+
+  void Mixer::remove_sound (SoundId sound) {
+    Impl& impl = *m_impl;
+    if (sound == INVALID_SOUND || sound > impl.sounds.size () || !impl.sounds[sound - 1].data ||
+        impl.sounds[sound - 1].removed) {
+      return;
+    }
+    Impl::SoundEntry& entry = impl.sounds[sound - 1];
+    if (entry.voices == 0) {
+      impl.release_sound (sound);
+      return;
+    }
+    for (std::size_t slot = 0; slot < impl.control_voices.size (); ++slot) {
+      const auto& voice = impl.control_voices[slot];
+      if (voice.busy && voice.sound == sound) {
+        stop (Impl::make_handle (static_cast<uint16_t> (slot), voice.generation));
+      }
+    }
+    entry.removed = true;
+    impl.pending_removal.push_back (sound);
+  }
+
+  std::shared_ptr<const SoundData> Mixer::get_sound (SoundId sound) const {
+    const Impl& impl = *m_impl;
+    if (sound == INVALID_SOUND || sound > impl.sounds.size () || impl.sounds[sound - 1].removed) {
+      return nullptr;
+    }
+    return impl.sounds[sound - 1].data;
+  }
+
+  VoiceHandle Mixer::play (SoundId sound, const VoiceParams& params) {
+    Impl& impl = *m_impl;
+    if (!impl.initialized || sound == INVALID_SOUND || sound > impl.sounds.size ()) {
+      return {};
+    }
+    Impl::SoundEntry& entry = impl.sounds[sound - 1];
+    if (!entry.data || entry.removed || impl.free_slots.empty ()) {
+      return {};
+    }
+
+    Command command = impl.next_play (params);
+    command.sound = entry.data.get ();
+    if (!impl.push (command)) {
+      return {};
+    }
+    ++entry.voices;
+    return impl.claim (command, sound, -1);
+  }
+
+  VoiceHandle Mixer::play_stream (std::unique_ptr<AudioDecoder> decoder, const VoiceParams& params) {
+    Impl& impl = *m_impl;
+    if (!impl.initialized || !decoder || decoder->channels () < 1 || decoder->channels () > 2 ||
+        decoder->sample_rate () == 0 || impl.free_streams.empty () || impl.free_slots.empty ()) {
+      return {};
+    }
+    if (params.start_frame > 0) {
+      const uint64_t frames = decoder->frame_count ();
+      if (!decoder->seek (params.loop && frames > 0 ? params.start_frame % frames : params.start_frame)) {
+        return {};
+      }
+    }
+
+    // Not yet registered with the decoder thread and not referenced by any voice: safe to reset
+    const uint16_t index = impl.free_streams.back ();
+    Stream& stream = *impl.streams[index];
+    stream.channels = decoder->channels ();
+    stream.sample_rate = decoder->sample_rate ();
+    stream.loop = params.loop;
+    stream.written.store (0, std::memory_order_relaxed);
+    stream.read.store (0, std::memory_order_relaxed);
+    stream.ended.store (false, std::memory_order_relaxed);
+
+    Command command = impl.next_play (params);
+    command.stream = &stream;
+    if (!impl.push (command)) {
+      return {};
+    }
+    {
+      std::lock_guard<std::mutex> lock (impl.stream_mutex);
+      stream.decoder = std::move (decoder);
+      impl.streaming.push_back (&stream);
+    }
+    impl.stream_wake.notify_one (); // Decode the first chunk now rather than at the next poll
+    impl.free_streams.pop_back ();
+    return impl.claim (command, INVALID_SOUND, index);
+  }
+
+  bool Mixer::stop (VoiceHandle voice) {
+    return m_impl->send (voice, CommandType::Stop, 0.0f);
+  }
+
+  bool Mixer::pause (VoiceHandle voice) {
+    return m_impl->send (voice, CommandType::Pause, 0.0f);
+  }
+
+  bool Mixer::resume (VoiceHandle voice) {
+    return m_impl->send (voice, CommandType::Resume, 0.0f);
+  }
+
+  bool Mixer::set_gain (VoiceHandle voice, float gain) {
+    return m_impl->send (voice, CommandType::SetGain, std::max (gain, 0.0f));
+  }
+
+  bool Mixer::set_pan (VoiceHandle voice, float pan) {
+    return m_impl->send (voice, CommandType::SetPan, std::clamp (pan, -1.0f, 1.0f));
+  }
+
+  bool Mixer::set_pitch (VoiceHandle voice, float pitch) {
+    return m_impl->send (voice, CommandType::SetPitch, pitch);
+  }
+
+  void Mixer::set_master_gain (float gain) {
+    if (!m_impl->initialized) {
+      return;
+    }
+    Command command;
+    command.type = CommandType::SetMasterGain;
+    command.value = std::max (gain, 0.0f);
+    m_impl->push (command);
+  }
+
+  void Mixer::update () {
+    Impl& impl = *m_impl;
+    if (!impl.initialized) {
+      return;
+    }
+    while (auto event = impl.finished->try_pop ()) {
+      Impl::ControlVoice& voice = impl.control_voices[event->slot];
+      if (!voice.busy || voice.generation != event->generation) {
+        continue;
+      }
+      voice.busy = false;
+      if (voice.stream >= 0) {
+        Stream* stream = impl.streams[static_cast<std::size_t> (voice.stream)].get ();
+        std::unique_ptr<AudioDecoder> decoder;
+        {
+          std::lock_guard<std::mutex> lock (impl.stream_mutex);
+          std::erase (impl.streaming, stream);
+          decoder = std::move (stream->decoder);
+        }
+        impl.free_streams.push_back (static_cast<uint16_t> (voice.stream));
+        voice.stream = -1;
+      } else {
+        --impl.sounds[voice.sound - 1].voices;
+      }
+      voice.sound = INVALID_SOUND;
+      impl.free_slots.push_back (event->slot);
+    }
+    std::erase_if (impl.pending_removal, [&] (SoundId id) {
+      if (impl.sounds[id - 1].voices != 0) {
+        return false;
+      }
+      impl.release_sound (id);
+      return true;
+    });
+  }
+
+  bool Mixer::is_playing (VoiceHandle voice) const {
+    return m_impl->find (voice) != nullptr;
+  }
+
+  uint32_t Mixer::get_active_voice_count () const {
+    return static_cast<uint32_t> (m_impl->control_voices.size () - m_impl->free_slots.size ());
+  }
+
+  void Mixer::render (std::span<float> out) {
+    if (!m_impl->initialized || m_impl->running.load (std::memory_order_acquire)) {
+      std::fill (out.begin (), out.end (), 0.0f);
+      return;
+    }
+    m_impl->render (out);
+  }
+
+  bool Mixer::start_output (std::unique_ptr<AudioOutput> output) {
+    Impl& impl = *m_impl;
+    if (!impl.initialized || !output || impl.thread.joinable ()) {
+      return false;
+    }
+    if (!output->open (impl.config.sample_rate, impl.config.block_frames)) {
+      omnicpp::log::error ("Mixer: Failed to open output device");
+      return false;
+    }
+    impl.output = std::move (output);
+    impl.running.store (true, std::memory_order_release);
+    impl.thread = std::thread ([&impl] () { impl.run (); });
+    return true;
+  }
+
+  void Mixer::stop_output () {
+    Impl& impl = *m_impl;
+    impl.running.store (false, std::memory_order_release);
+    if (impl.thread.joinable ()) {
+      impl.thread.join ();
+    }
+    if (impl.output) {
+      impl.output->close ();
+      impl.output.reset ();
+    }
+  }
+
+  bool Mixer::is_output_running () const {
+    return m_impl->running.load (std::memory_order_acquire);
+  }
+
+  MixerStats Mixer::get_stats () const {
+    const Impl& impl = *m_impl;
+    MixerStats stats;
+    stats.blocks = impl.blocks.load (std::memory_order_relaxed);
+    stats.voices_mixed = impl.voices_mixed.load (std::memory_order_relaxed);
+    stats.mix_ns = impl.mix_ns.load (std::memory_order_relaxed);
+    stats.commands = impl.commands_applied.load (std::memory_order_relaxed);
+    stats.dropped_commands = impl.dropped_commands.load (std::memory_order_relaxed);
+    stats.peak_voices = impl.peak_voices.load (std::memory_order_relaxed);
+    stats.stream_frames_decoded = impl.stream_frames_decoded.load (std::memory_order_relaxed);
+    stats.stream_underruns = impl.stream_underruns.load (std::memory_order_relaxed);
+    return stats;
+  }
+
+  const MixerConfig& Mixer::get_config () const {
+    return m_impl->config;
+  }
+
+} // namespace audio
+} // namespace omnicpp
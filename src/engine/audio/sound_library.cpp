@@ -0,0 +1,85 @@
+/**
+ * @file sound_library.cpp
+ * @brief Sound library implementation
+ */
+
+#include "engine/audio/sound_library.hpp"
+#include "engine/logging/Log.hpp"
+
+namespace omnicpp {
+namespace audio {
+
+  SoundLibrary::SoundLibrary (Mixer& mixer, const SoundLibraryConfig& config) : m_mixer (mixer), m_config (config) {
+  }
+
+  SoundLibrary::~SoundLibrary () {
+    for (const auto& [path, asset] : m_assets) {
+      if (asset.sound != INVALID_SOUND) {
+        m_mixer.remove_sound (asset.sound);
+      }
+    }
+  }
+
+  SoundAsset SoundLibrary::load (const std::string& path) {
+    if (auto it = m_assets.find (path); it != m_assets.end ()) {
+      return it->second;
+    }
+
+    auto decoder = m_decoders.open (path);
+    if (!decoder) {
+      omnicpp::log::warn ("SoundLibrary: No decoder could open '{}'", path);
+      return {};
+    }
+
+    SoundAsset asset;
+    asset.path = path;
+    asset.channels = decoder->channels ();
+    asset.sample_rate = decoder->sample_rate ();
+    asset.frame_count = decoder->frame_count ();
+
+    const std::size_t decoded_bytes = asset.frame_count * asset.channels * sizeof (float);
+    if (asset.frame_count == 0 || decoded_bytes > m_config.resident_limit_bytes) {
+      asset.streamed = true;
+      omnicpp::log::debug ("SoundLibrary: '{}' will stream ({} frames)", path, asset.frame_count);
+    } else {
+      auto data = decode_all (*decoder);
+      asset.sound = data ? m_mixer.add_sound (data) : INVALID_SOUND;
+      if (asset.sound == INVALID_SOUND) {
+        omnicpp::log::warn ("SoundLibrary: Failed to decode '{}'", path);
+        return {};
+      }
+      asset.frame_count = data->frame_count (); // What was actually decoded
+      m_resident_bytes += data->samples.size () * sizeof (float);
+      omnicpp::log::debug ("SoundLibrary: '{}' resident ({} bytes)", path, data->samples.size () * sizeof (float));
+    }
+    m_assets.emplace (path, asset);
+    return asset;
+  }
+
+  VoiceHandle SoundLibrary::play (const SoundAsset& asset, const VoiceParams& params) {
+    if (!asset.streamed) {
+      return m_mixer.play (asset.sound, params);
+    }
+    // Every streamed voice reads the file through its own decoder
+    auto decoder = m_decoders.open (asset.path);
+    if (!decoder) {
+      omnicpp::log::warn ("SoundLibrary: Cannot reopen '{}' for streaming", asset.path);
+      return {};
+    }
+    return m_mixer.play_stream (std::move (decoder), params);
+  }
+
+  void SoundLibrary::unload (const std::string& path) {
+    auto it = m_assets.find (path);
+    if (it == m_assets.end ()) {
+      return;
+    }
+    if (it->second.sound != INVALID_SOUND) {
+      m_mixer.remove_sound (it->second.sound);
+      m_resident_bytes -= it->second.frame_count * it->second.channels * sizeof (float);
+    }
+    m_assets.erase (it);
+  }
+
+} // namespace audio
+} // namespace omnicpp
@@ -0,0 +1,288 @@
+/**
+ * @file voice_manager.cpp
+ * @brief Voice manager implementation
+ */
+
+#include "engine/audio/voice_manager.hpp"
+#include "engine/logging/Log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <immintrin.h>
+  #define OMNICPP_AUDIO_SSE 1
+#endif
+
+namespace omnicpp {
+namespace audio {
+
+  namespace {
+
+    int64_t now_ns () {
+      return std::chrono::duration_cast<std::chrono::nanoseconds> (
+          std::chrono::steady_clock::now ().time_since_epoch ())
+          .count ();
+    }
+
+  } // namespace
+
+  void spatialize (const Listener& listener, std::size_t count, const float* x, const float* y, const float* z,
+      const float* min_distance, const float* max_distance, float* attenuation, float* pan) {
+    std::size_t i = 0;
+#if defined(OMNICPP_AUDIO_SSE)
+    const __m128 lx = _mm_set1_ps (listener.position.x);
+    const __m128 ly = _mm_set1_ps (listener.position.y);
+    const __m128 lz = _mm_set1_ps (listener.position.z);
+    const __m128 rx = _mm_set1_ps (listener.right.x);
+    const __m128 ry = _mm_set1_ps (listener.right.y);
+    const __m128 rz = _mm_set1_ps (listener.right.z);
+    const __m128 one = _mm_set1_ps (1.0f);
+    const __m128 minus_one = _mm_set1_ps (-1.0f);
+    for (; i + 4 <= count; i += 4) {
+      const __m128 dx = _mm_sub_ps (_mm_loadu_ps (x + i), lx);
+      const __m128 dy = _mm_sub_ps (_mm_loadu_ps (y + i), ly);
+      const __m128 dz = _mm_sub_ps (_mm_loadu_ps (z + i), lz);
+      const __m128 dist =
+          _mm_sqrt_ps (_mm_add_ps (_mm_add_ps (_mm_mul_ps (dx, dx), _mm_mul_ps (dy, dy)), _mm_mul_ps (dz, dz)));
+      const __m128 inner = _mm_loadu_ps (min_distance + i);
+      const __m128 clamped = _mm_max_ps (dist, inner);
+      const __m128 audible = _mm_cmple_ps (dist, _mm_loadu_ps (max_distance + i));
+      _mm_storeu_ps (attenuation + i, _mm_and_ps (_mm_div_ps (inner, clamped), audible));
+
+      const __m128 side = _mm_add_ps (_mm_add_ps (_mm_mul_ps (dx, rx), _mm_mul_ps (dy, ry)), _mm_mul_ps (dz, rz));
+      _mm_storeu_ps (pan + i, _mm_min_ps (one, _mm_max_ps (minus_one, _mm_div_ps (side, clamped))));
+    }
+#endif
+    for (; i < count; ++i) {
+      const float dx = x[i] - listener.position.x;
+      const float dy = y[i] - listener.position.y;
+      const float dz = z[i] - listener.position.z;
+      const float dist = std::sqrt (dx * dx + dy * dy + dz * dz);
+      const float clamped = std::max (dist, min_distance[i]);
+      attenuation[i] = dist <= max_distance[i] ? min_distance[i] / clamped : 0.0f;
+      const float side = dx * listener.right.x + dy * listener.right.y + dz * listener.right.z;
+      pan[i] = std::clamp (side / clamped, -1.0f, 1.0f);
+    }
+  }
+
+  VoiceManager::VoiceManager (Mixer& mixer, const VoiceManagerConfig& config) : m_mixer (mixer), m_config (config) {
+  }
+
+  VoiceManager::~VoiceManager () {
+    for (const Playback& playback : m_playback) {
+      if (playback.voice.valid ()) {
+        m_mixer.stop (playback.voice);
+      }
+    }
+  }
+
+  EmitterId VoiceManager::add_emitter (const EmitterDesc& desc) {
+    auto sound = m_mixer.get_sound (desc.sound);
+    if (!sound) {
+      omnicpp::log::warn ("VoiceManager: Unknown sound {}", desc.sound);
+      return INVALID_EMITTER;
+    }
+    const EmitterId id = m_next_id++;
+    m_columns.push_back (desc.position.x, desc.position.y, desc.position.z, std::max (desc.min_distance, 1e-3f),
+        desc.max_distance, desc.gain, desc.priority, desc.pitch, 0.0f, 0.0f);
+
+    Playback playback;
+    playback.id = id;
+    playback.sound = desc.sound;
+    playback.frames = static_cast<double> (sound->frame_count ());
+    playback.sample_rate = static_cast<double> (sound->sample_rate);
+    playback.loop = desc.loop;
+    m_playback.push_back (playback);
+    m_index.emplace (id, m_playback.size () - 1);
+    return id;
+  }
+
+  void VoiceManager::remove_emitter (EmitterId emitter) {
+    if (const std::size_t* index = find (emitter)) {
+      if (m_playback[*index].voice.valid ()) {
+        m_mixer.stop (m_playback[*index].voice);
+      }
+      erase (*index);
+    }
+  }
+
+  bool VoiceManager::set_position (EmitterId emitter, const math::Vec3& position) {
+    const std::size_t* index = find (emitter);
+    if (!index) {
+      return false;
+    }
+    m_columns.get<X> ()[*index] = position.x;
+    m_columns.get<Y> ()[*index] = position.y;
+    m_columns.get<Z> ()[*index] = position.z;
+    return true;
+  }
+
+  bool VoiceManager::set_gain (EmitterId emitter, float gain) {
+    const std::size_t* index = find (emitter);
+    if (!index) {
+      return false;
+    }
+    m_columns.get<GAIN> ()[*index] = gain;
+    return true;
+  }
+
+  bool VoiceManager::set_priority (EmitterId emitter, float priority) {
+    const std::size_t* index = find (emitter);
+    if (!index) {
+      return false;
+    }
+    m_columns.get<PRIORITY> ()[*index] = priority;
+    return true;
+  }
+
+  void VoiceManager::update (const Listener& listener, float dt) {
+    const int64_t start = now_ns ();
+
+    // Cursors first: expiring one-shots shrinks everything after
+    const float* pitch = m_columns.get<PITCH> ();
+    for (std::size_t i = m_playback.size (); i-- > 0;) {
+      Playback& playback = m_playback[i];
+      playback.cursor += static_cast<double> (dt) * static_cast<double> (pitch[i]) * playback.sample_rate;
+      if (playback.voice.valid () && !m_mixer.is_playing (playback.voice)) {
+        playback.voice = {}; // The mixer ended it: the sound ran out or was removed
+        if (!playback.loop) {
+          ++m_stats.expired;
+          erase (i);
+          continue;
+        }
+      }
+      if (playback.cursor >= playback.frames) {
+        if (playback.loop) {
+          playback.cursor = std::fmod (playback.cursor, playback.frames);
+        } else if (!playback.voice.valid ()) {
+          ++m_stats.expired; // Real one-shots end when the mixer reports them, so their tail is heard
+          erase (i);
+          continue;
+        } else {
+          playback.cursor = playback.frames;
+        }
+      }
+    }
+
+    const std::size_t count = m_playback.size ();
+    spatialize (listener, count, m_columns.get<X> (), m_columns.get<Y> (), m_columns.get<Z> (),
+        m_columns.get<MIN_DISTANCE> (), m_columns.get<MAX_DISTANCE> (), m_columns.get<ATTENUATION> (),
+        m_columns.get<PAN> ());
+
+    const float* gain = m_columns.get<GAIN> ();
+    const float* priority = m_columns.get<PRIORITY> ();
+    const float* attenuation = m_columns.get<ATTENUATION> ();
+    const float* pan = m_columns.get<PAN> ();
+
+    m_scores.resize (count);
+    m_selected.assign (count, 0);
+    m_candidates.clear ();
+    for (std::size_t i = 0; i < count; ++i) {
+      const float audibility = gain[i] * attenuation[i];
+      if (audibility < m_config.audibility_threshold) {
+        continue;
+      }
+      const float bonus = m_playback[i].voice.valid () ? m_config.steal_hysteresis : 1.0f;
+      m_scores[i] = priority[i] * audibility * bonus;
+      m_candidates.push_back (static_cast<uint32_t> (i));
+    }
+    if (m_candidates.size () > m_config.max_real_voices) {
+      auto nth = m_candidates.begin () + m_config.max_real_voices;
+      std::nth_element (m_candidates.begin (), nth, m_candidates.end (),
+          [this] (uint32_t a, uint32_t b) { return m_scores[a] > m_scores[b]; });
+      m_candidates.erase (nth, m_candidates.end ());
+    }
+    for (const uint32_t index : m_candidates) {
+      m_selected[index] = 1;
+    }
+
+    // Stop the losers before starting the winners so their mixer slots come free first
+    for (std::size_t i = 0; i < count; ++i) {
+      if (m_playback[i].voice.valid () && !m_selected[i]) {
+        demote (i, gain[i] * attenuation[i] >= m_config.audibility_threshold);
+      }
+    }
+
+    uint32_t real = 0;
+    for (const uint32_t i : m_candidates) {
+      Playback& playback = m_playback[i];
+      const float level = gain[i] * attenuation[i];
+      if (playback.voice.valid ()) {
+        m_mixer.set_gain (playback.voice, level);
+        m_mixer.set_pan (playback.voice, pan[i]);
+        ++real;
+        continue;
+      }
+      VoiceParams params;
+      params.gain = level;
+      params.pan = pan[i];
+      params.pitch = m_columns.get<PITCH> ()[i];
+      params.loop = playback.loop;
+      params.start_frame = static_cast<uint64_t> (playback.cursor);
+      playback.voice = m_mixer.play (playback.sound, params);
+      if (playback.voice.valid ()) {
+        ++m_stats.promotions;
+        ++real;
+      }
+      // Otherwise the mixer is out of voices or commands: stay virtual and retry next update
+    }
+
+    m_stats.emitters = static_cast<uint32_t> (count);
+    m_stats.real_voices = real;
+    m_stats.virtual_voices = static_cast<uint32_t> (count) - real;
+    m_stats.update_ns = static_cast<uint64_t> (now_ns () - start);
+  }
+
+  bool VoiceManager::is_active (EmitterId emitter) const {
+    return find (emitter) != nullptr;
+  }
+
+  bool VoiceManager::is_real (EmitterId emitter) const {
+    const std::size_t* index = find (emitter);
+    return index && m_playback[*index].voice.valid ();
+  }
+
+  VoiceHandle VoiceManager::get_voice (EmitterId emitter) const {
+    const std::size_t* index = find (emitter);
+    return index ? m_playback[*index].voice : VoiceHandle{};
+  }
+
+  uint64_t VoiceManager::get_cursor (EmitterId emitter) const {
+    const std::size_t* index = find (emitter);
+    return index ? static_cast<uint64_t> (m_playback[*index].cursor) : 0;
+  }
+
+  float VoiceManager::get_audibility (EmitterId emitter) const {
+    const std::size_t* index = find (emitter);
+    return index ? m_columns.get<GAIN> ()[*index] * m_columns.get<ATTENUATION> ()[*index] : 0.0f;
+  }
+
+  const std::size_t* VoiceManager::find (EmitterId emitter) const {
+    auto it = m_index.find (emitter);
+    return it != m_index.end () ? &it->second : nullptr;
+  }
+
+  void VoiceManager::erase (std::size_t index) {
+    m_index.erase (m_playback[index].id);
+    const std::size_t last = m_playback.size () - 1;
+    if (index != last) {
+      m_playback[index] = m_playback[last];
+      m_index[m_playback[index].id] = index;
+    }
+    m_playback.pop_back ();
+    m_columns.erase_swap (index);
+  }
+
+  void VoiceManager::demote (std::size_t index, bool stolen) {
+    Playback& playback = m_playback[index];
+    m_mixer.stop (playback.voice);
+    playback.voice = {};
+    ++m_stats.demotions;
+    if (stolen) {
+      ++m_stats.steals;
+    }
+  }
+
+} // namespace audio
+} // namespace omnicpp
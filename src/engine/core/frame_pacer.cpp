@@ -0,0 +1,187 @@
+/**
+ * @file frame_pacer.cpp
+ * @brief Frame pacer implementation
+ */
+
+#include "engine/core/frame_pacer.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #include <immintrin.h>
+  #define OMNICPP_CPU_RELAX() _mm_pause ()
+#elif defined(__aarch64__) || defined(__arm__)
+  #define OMNICPP_CPU_RELAX() asm volatile ("yield" ::: "memory")
+#else
+  #define OMNICPP_CPU_RELAX() std::this_thread::yield ()
+#endif
+
+#if defined(__linux__)
+  #include <cerrno>
+  #include <time.h>
+#endif
+
+namespace OmniCpp::Engine::Core {
+
+  using Clock = std::chrono::steady_clock;
+
+  namespace {
+
+    /**
+     * @brief Sleep until an absolute steady_clock time point
+     */
+    void sleep_until_absolute (Clock::time_point deadline) {
+#if defined(__linux__)
+      // libstdc++ and libc++ both back steady_clock with CLOCK_MONOTONIC
+      const auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds> (deadline.time_since_epoch ());
+      timespec ts{};
+      ts.tv_sec = since_epoch.count () / 1'000'000'000;
+      ts.tv_nsec = since_epoch.count () % 1'000'000'000;
+      while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+      }
+#else
+      std::this_thread::sleep_until (deadline);
+#endif
+    }
+
+  } // namespace
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct FramePacer::Impl {
+    FramePacerConfig config;
+    Clock::duration period{ 0 };
+    Clock::time_point next_deadline;
+    Clock::time_point last_frame_start;
+
+    std::vector<int64_t> history; // Frame times in nanoseconds, ring buffer
+    std::size_t history_head{ 0 };
+    uint64_t frame_count{ 0 };
+    uint64_t missed_deadlines{ 0 };
+
+    void set_rate (uint32_t target_fps) {
+      config.target_fps = target_fps;
+      period = target_fps > 0
+          ? std::chrono::duration_cast<Clock::duration> (std::chrono::nanoseconds (1'000'000'000 / target_fps))
+          : Clock::duration{ 0 };
+    }
+
+    void anchor () {
+      last_frame_start = Clock::now ();
+      next_deadline = last_frame_start + period;
+    }
+  };
+
+  FramePacer::FramePacer () : m_impl (std::make_unique<Impl> ()) {
+    initialize ({});
+  }
+
+  FramePacer::~FramePacer () = default;
+
+  FramePacer::FramePacer (FramePacer&& other) noexcept : m_impl (std::move (other.m_impl)) {
+  }
+
+  FramePacer& FramePacer::operator= (FramePacer&& other) noexcept {
+    if (this != &other) {
+      m_impl = std::move (other.m_impl);
+    }
+    return *this;
+  }
+
+  void FramePacer::initialize (const FramePacerConfig& config) {
+    m_impl->config = config;
+    m_impl->set_rate (config.target_fps);
+    m_impl->history.assign (std::max<uint32_t> (config.history_size, 1), 0);
+    reset ();
+  }
+
+  void FramePacer::reset () {
+    std::fill (m_impl->history.begin (), m_impl->history.end (), 0);
+    m_impl->history_head = 0;
+    m_impl->frame_count = 0;
+    m_impl->missed_deadlines = 0;
+    m_impl->anchor ();
+  }
+
+  float FramePacer::wait_for_next_frame () {
+    Impl& impl = *m_impl;
+
+    if (impl.period.count () > 0) {
+      auto now = Clock::now ();
+
+      if (now > impl.next_deadline + impl.period) {
+        // Overran by more than a frame: re-anchor instead of bursting to catch up
+        ++impl.missed_deadlines;
+        impl.next_deadline = now;
+      } else {
+        const auto sleep_target = impl.next_deadline - impl.config.spin_threshold;
+        if (now < sleep_target) {
+          sleep_until_absolute (sleep_target);
+        }
+        while (Clock::now () < impl.next_deadline) {
+          OMNICPP_CPU_RELAX ();
+        }
+      }
+    }
+
+    const auto frame_start = Clock::now ();
+    const auto frame_time = frame_start - impl.last_frame_start;
+    impl.last_frame_start = frame_start;
+
+    // Absolute schedule: advance from the deadline, not from when we woke up
+    if (impl.period.count () > 0) {
+      impl.next_deadline += impl.period;
+    }
+
+    impl.history[impl.history_head] = std::chrono::duration_cast<std::chrono::nanoseconds> (frame_time).count ();
+    impl.history_head = (impl.history_head + 1) % impl.history.size ();
+    ++impl.frame_count;
+
+    return std::chrono::duration<float> (frame_time).count ();
+  }
+
+  void FramePacer::set_target_fps (uint32_t target_fps) {
+    m_impl->set_rate (target_fps);
+    m_impl->next_deadline = Clock::now () + m_impl->period;
+  }
+
+  std::chrono::nanoseconds FramePacer::get_frame_period () const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (m_impl->period);
+  }
+
+  FrameTimeStats FramePacer::get_stats () const {
+    FrameTimeStats stats;
+    stats.frame_count = m_impl->frame_count;
+    stats.missed_deadlines = m_impl->missed_deadlines;
+
+    const std::size_t count = static_cast<std::size_t> (
+        std::min<uint64_t> (m_impl->frame_count, m_impl->history.size ()));
+    if (count == 0) {
+      return stats;
+    }
+
+    // Until the ring wraps, only the first `count` entries hold samples
+    std::vector<int64_t> samples (m_impl->history.begin (), m_impl->history.begin () + static_cast<std::ptrdiff_t> (count));
+    std::sort (samples.begin (), samples.end ());
+
+    auto percentile = [&samples] (double p) {
+      const auto index = static_cast<std::size_t> (p * static_cast<double> (samples.size () - 1) + 0.5);
+      return static_cast<double> (samples[index]) / 1e6;
+    };
+
+    double total = 0.0;
+    for (int64_t sample : samples) {
+      total += static_cast<double> (sample);
+    }
+
+    stats.mean_ms = total / static_cast<double> (samples.size ()) / 1e6;
+    stats.p50_ms = percentile (0.50);
+    stats.p90_ms = percentile (0.90);
+    stats.p99_ms = percentile (0.99);
+    stats.max_ms = static_cast<double> (samples.back ()) / 1e6;
+    return stats;
+  }
+
+} // namespace OmniCpp::Engine::Core
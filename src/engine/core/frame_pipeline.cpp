@@ -0,0 +1,186 @@
+/**
+ * @file frame_pipeline.cpp
+ * @brief Pipelined frame loop implementation
+ */
+
+#include "engine/core/frame_pipeline.hpp"
+#include "engine/concurrency/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include "engine/logging/Log.hpp"
+
+namespace OmniCpp::Engine::Core {
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct FramePipeline::Impl {
+    std::vector<PipelineStage> stages;
+    std::vector<std::vector<std::size_t>> groups; // Stage indices per lag
+    std::vector<bool> group_main_thread;
+    std::vector<PipelineStageTiming> timings;
+    omnicpp::concurrency::ThreadPool* pool{ nullptr };
+    uint32_t depth{ 1 };
+    uint64_t frames_started{ 0 };
+    uint64_t frames_completed{ 0 };
+    uint64_t run_start{ 0 }; // First frame since the last flush
+    bool initialized{ false };
+
+    void build_groups ();
+    void run_group (std::size_t lag, uint64_t frame);
+    void run_tick (uint64_t cursor);
+  };
+
+  void FramePipeline::Impl::build_groups () {
+    groups.assign (depth, {});
+    group_main_thread.assign (depth, false);
+    for (std::size_t s = 0; s < stages.size (); ++s) {
+      const std::size_t lag = std::min<std::size_t> (s, depth - 1);
+      groups[lag].push_back (s);
+      if (stages[s].main_thread_only) {
+        group_main_thread[lag] = true;
+      }
+    }
+  }
+
+  void FramePipeline::Impl::run_group (std::size_t lag, uint64_t frame) {
+    const auto slot = static_cast<uint32_t> (frame % depth);
+    for (std::size_t s : groups[lag]) {
+      const auto start = std::chrono::steady_clock::now ();
+      stages[s].run (frame, slot);
+      timings[s].frame = frame;
+      timings[s].duration_ms =
+          std::chrono::duration<double, std::milli> (std::chrono::steady_clock::now () - start).count ();
+    }
+  }
+
+  void FramePipeline::Impl::run_tick (uint64_t cursor) {
+    for (auto& timing : timings) {
+      timing.duration_ms = 0.0;
+    }
+
+    std::vector<std::future<void>> pending;
+    std::vector<std::pair<std::size_t, uint64_t>> on_caller;
+
+    for (std::size_t lag = 0; lag < depth; ++lag) {
+      if (cursor < lag) {
+        break;
+      }
+      const uint64_t frame = cursor - lag;
+      if (frame < run_start || frame >= frames_started) {
+        continue;
+      }
+      if (depth == 1 || group_main_thread[lag]) {
+        on_caller.emplace_back (lag, frame);
+      } else {
+        pending.push_back (pool->submit ([this, lag, frame] () { run_group (lag, frame); }));
+      }
+    }
+
+    // Oldest frame first: it is the one closest to the screen
+    for (auto it = on_caller.rbegin (); it != on_caller.rend (); ++it) {
+      run_group (it->first, it->second);
+    }
+
+    // Frame-boundary fence: every stage of this tick finishes before slots change hands
+    for (auto& future : pending) {
+      future.get ();
+    }
+
+    const uint64_t last_stage_frame = cursor >= depth - 1 ? cursor - (depth - 1) : UINT64_MAX;
+    if (last_stage_frame != UINT64_MAX && last_stage_frame >= run_start && last_stage_frame < frames_started) {
+      ++frames_completed;
+    }
+  }
+
+  FramePipeline::FramePipeline () : m_impl (std::make_unique<Impl> ()) {
+  }
+
+  FramePipeline::~FramePipeline () {
+    if (m_impl && m_impl->initialized) {
+      flush ();
+    }
+  }
+
+  FramePipeline::FramePipeline (FramePipeline&& other) noexcept : m_impl (std::move (other.m_impl)) {
+  }
+
+  FramePipeline& FramePipeline::operator= (FramePipeline&& other) noexcept {
+    if (this != &other) {
+      m_impl = std::move (other.m_impl);
+    }
+    return *this;
+  }
+
+  bool FramePipeline::initialize (std::vector<PipelineStage> stages, const FramePipelineConfig& config,
+      omnicpp::concurrency::ThreadPool* pool) {
+    if (m_impl->initialized) {
+      omnicpp::log::warn ("FramePipeline: Already initialized");
+      return true;
+    }
+
+    if (stages.empty ()) {
+      omnicpp::log::error ("FramePipeline: At least one stage is required");
+      return false;
+    }
+
+    m_impl->stages = std::move (stages);
+    m_impl->timings.resize (m_impl->stages.size ());
+    for (std::size_t s = 0; s < m_impl->stages.size (); ++s) {
+      m_impl->timings[s].name = m_impl->stages[s].name;
+    }
+    m_impl->pool = pool ? pool : &omnicpp::concurrency::GlobalThreadPool::instance ();
+    m_impl->depth = std::clamp<uint32_t> (config.depth, 1, static_cast<uint32_t> (m_impl->stages.size ()));
+    m_impl->build_groups ();
+    m_impl->initialized = true;
+
+    omnicpp::log::info ("FramePipeline: {} stages, depth {}{}", m_impl->stages.size (), m_impl->depth,
+        m_impl->depth == 1 ? " (serial)" : "");
+    return true;
+  }
+
+  void FramePipeline::tick () {
+    if (!m_impl->initialized) {
+      return;
+    }
+    const uint64_t cursor = m_impl->frames_started++;
+    m_impl->run_tick (cursor);
+  }
+
+  void FramePipeline::flush () {
+    if (!m_impl->initialized || m_impl->frames_started == m_impl->run_start) {
+      return;
+    }
+    for (uint32_t k = 1; k < m_impl->depth; ++k) {
+      m_impl->run_tick (m_impl->frames_started - 1 + k);
+    }
+    m_impl->run_start = m_impl->frames_started;
+  }
+
+  void FramePipeline::set_depth (uint32_t depth) {
+    if (!m_impl->initialized) {
+      return;
+    }
+    flush ();
+    m_impl->depth = std::clamp<uint32_t> (depth, 1, static_cast<uint32_t> (m_impl->stages.size ()));
+    m_impl->build_groups ();
+  }
+
+  uint32_t FramePipeline::get_depth () const {
+    return m_impl->depth;
+  }
+
+  uint64_t FramePipeline::get_frames_started () const {
+    return m_impl->frames_started;
+  }
+
+  uint64_t FramePipeline::get_frames_completed () const {
+    return m_impl->frames_completed;
+  }
+
+  const std::vector<PipelineStageTiming>& FramePipeline::get_last_tick_timings () const {
+    return m_impl->timings;
+  }
+
+} // namespace OmniCpp::Engine::Core
@@ -0,0 +1,364 @@
+/**
+ * @file profiler.cpp
+ * @brief Per-thread scope rings, frame aggregation and export
+ */
+
+#include "engine/core/profiler.hpp"
+#include "engine/telemetry/chrome_trace_exporter.hpp"
+#include "engine/telemetry/span_recorder.hpp"
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <unordered_map>
+
+namespace OmniCpp::Engine::Core {
+
+  namespace {
+
+    int64_t steady_ns () {
+      return std::chrono::duration_cast<std::chrono::nanoseconds> (
+          std::chrono::steady_clock::now ().time_since_epoch ())
+          .count ();
+    }
+
+    int64_t unix_ns () {
+      return std::chrono::duration_cast<std::chrono::nanoseconds> (
+          std::chrono::system_clock::now ().time_since_epoch ())
+          .count ();
+    }
+
+    constexpr int64_t CALIBRATION_NS = 50'000'000; // Tick rate is re-measured over at least this much steady time
+
+  } // namespace
+
+  /**
+   * @brief Scopes of one thread: the thread produces, end_frame() consumes
+   */
+  struct Profiler::ThreadBuffer {
+    struct Record {
+      const char* name;
+      uint64_t start;
+      uint64_t end;
+      uint32_t depth;
+    };
+
+    ThreadBuffer (std::size_t capacity, uint32_t number) : records (capacity), mask (capacity - 1), thread (number) {}
+
+    std::vector<Record> records;
+    std::size_t mask;
+    uint32_t thread;
+    uint32_t depth{ 0 }; // Open scopes, owner only
+
+    alignas (64) std::atomic<uint64_t> head{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    alignas (64) std::atomic<uint64_t> tail{ 0 };
+    std::atomic<bool> retired{ false };
+  };
+
+  namespace {
+
+    struct BufferHolder {
+      std::shared_ptr<Profiler::ThreadBuffer> buffer;
+
+      ~BufferHolder () {
+        if (buffer) {
+          buffer->retired.store (true, std::memory_order_release);
+        }
+      }
+    };
+
+  } // namespace
+
+  struct Profiler::Impl {
+    mutable std::mutex mutex;
+    ProfilerConfig config;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint64_t retired_dropped{ 0 };
+
+    // Tick to steady_clock conversion; the rate is refined as frames go by
+    uint64_t anchor_tick{ Profiler::now () };
+    int64_t anchor_ns{ steady_ns () };
+    double ticks_per_ns{ 1.0 };
+    int64_t unix_offset_ns{ unix_ns () - steady_ns () };
+
+    uint64_t frame_start{ 0 };
+    uint64_t frame_number{ 0 };
+    FrameProfile last;
+    std::vector<FrameProfile> worst; // Slowest first
+    std::shared_ptr<omnicpp::telemetry::ChromeTraceExporter> exporter;
+
+    Impl () {
+#if defined(OMNICPP_PROFILE_RDTSC)
+      // A first rate from a short spin; calibrate() refines it over the frames that follow
+      int64_t elapsed = 0;
+      uint64_t tick = anchor_tick;
+      while (elapsed < 1'000'000) {
+        tick = Profiler::now ();
+        elapsed = steady_ns () - anchor_ns;
+      }
+      ticks_per_ns = static_cast<double> (tick - anchor_tick) / static_cast<double> (elapsed);
+#endif
+    }
+
+    int64_t to_ns (uint64_t tick) const {
+      return anchor_ns + static_cast<int64_t> (static_cast<double> (static_cast<int64_t> (tick - anchor_tick)) /
+                                               ticks_per_ns);
+    }
+
+    void calibrate (uint64_t tick) {
+#if defined(OMNICPP_PROFILE_RDTSC)
+      const int64_t now = steady_ns ();
+      if (now - anchor_ns >= CALIBRATION_NS) {
+        ticks_per_ns = static_cast<double> (tick - anchor_tick) / static_cast<double> (now - anchor_ns);
+        // Keep the old anchor so the rate is measured over an ever longer window
+      }
+#else
+      static_cast<void> (tick);
+#endif
+    }
+
+    std::vector<ScopeSample> drain (int64_t frame_start_ns) {
+      std::vector<ScopeSample> samples;
+      for (const auto& buffer : buffers) {
+        const uint64_t head = buffer->head.load (std::memory_order_acquire);
+        uint64_t tail = buffer->tail.load (std::memory_order_relaxed);
+        for (; tail != head; ++tail) {
+          const auto& record = buffer->records[tail & buffer->mask];
+          const int64_t start = to_ns (record.start);
+          samples.push_back ({ record.name, buffer->thread, record.depth, start - frame_start_ns,
+              to_ns (record.end) - start });
+        }
+        buffer->tail.store (tail, std::memory_order_release);
+      }
+      std::erase_if (buffers, [this] (const std::shared_ptr<ThreadBuffer>& buffer) {
+        if (!buffer->retired.load (std::memory_order_acquire) ||
+            buffer->head.load (std::memory_order_acquire) != buffer->tail.load (std::memory_order_relaxed)) {
+          return false;
+        }
+        retired_dropped += buffer->dropped.load (std::memory_order_relaxed);
+        return true;
+      });
+      std::sort (samples.begin (), samples.end (), [] (const ScopeSample& a, const ScopeSample& b) {
+        if (a.thread != b.thread) {
+          return a.thread < b.thread;
+        }
+        return a.start_ns != b.start_ns ? a.start_ns < b.start_ns : a.depth < b.depth;
+      });
+      return samples;
+    }
+
+    static std::vector<ScopeStats> aggregate (const std::vector<ScopeSample>& samples) {
+      std::vector<ScopeStats> stats;
+      std::vector<int64_t> first_start;
+      std::unordered_map<const char*, std::size_t> index;
+      for (const auto& sample : samples) {
+        auto [it, inserted] = index.try_emplace (sample.name, stats.size ());
+        if (inserted) {
+          stats.push_back ({ sample.name, sample.depth, 0, 0.0, 0.0 });
+          first_start.push_back (sample.start_ns);
+        }
+        ScopeStats& entry = stats[it->second];
+        const double ms = static_cast<double> (sample.duration_ns) / 1e6;
+        ++entry.calls;
+        entry.total_ms += ms;
+        entry.max_ms = std::max (entry.max_ms, ms);
+        if (sample.start_ns < first_start[it->second]) {
+          first_start[it->second] = sample.start_ns;
+          entry.depth = sample.depth;
+        }
+      }
+      std::vector<std::size_t> order (stats.size ());
+      for (std::size_t i = 0; i < order.size (); ++i) {
+        order[i] = i;
+      }
+      std::sort (order.begin (), order.end (),
+          [&first_start] (std::size_t a, std::size_t b) { return first_start[a] < first_start[b]; });
+      std::vector<ScopeStats> sorted;
+      sorted.reserve (stats.size ());
+      for (const std::size_t i : order) {
+        sorted.push_back (stats[i]);
+      }
+      return sorted;
+    }
+
+    /**
+     * @brief Submit a frame to telemetry: a "frame" root span with one child per scope
+     */
+    static void submit_spans (const FrameProfile& profile, int64_t frame_start_ns) {
+      using namespace omnicpp::telemetry;
+      auto& recorder = SpanRecorder::instance ();
+      if (!recorder.is_running ()) {
+        return;
+      }
+      static const NameId FRAME = intern ("frame");
+      static const AttributeKey FRAME_NUMBER ("frame.number");
+      const auto tick_at = [] (int64_t ns) {
+        return SpanRecorder::tick_at (std::chrono::steady_clock::time_point (std::chrono::nanoseconds (ns)));
+      };
+
+      SpanRecord root;
+      root.trace_id = TraceId::generate ();
+      root.span_id = SpanId::generate ();
+      root.name = FRAME;
+      root.start_tick = tick_at (frame_start_ns);
+      root.end_tick = tick_at (frame_start_ns + static_cast<int64_t> (profile.duration_ms * 1e6));
+      root.set_attribute (FRAME_NUMBER.id, profile.frame);
+      recorder.submit (root);
+
+      std::vector<SpanId> open; // Enclosing scopes of the current thread, by depth
+      uint32_t thread = 0;
+      for (const auto& sample : profile.samples) {
+        if (sample.thread != thread) {
+          thread = sample.thread;
+          open.clear ();
+        }
+        open.resize (std::min<std::size_t> (open.size (), sample.depth));
+        SpanRecord record;
+        record.trace_id = root.trace_id;
+        record.span_id = SpanId::generate ();
+        record.parent_span_id = open.size () == sample.depth && !open.empty () ? open.back () : root.span_id;
+        record.name = intern (sample.name);
+        record.thread = sample.thread;
+        record.start_tick = tick_at (frame_start_ns + sample.start_ns);
+        record.end_tick = tick_at (frame_start_ns + sample.start_ns + sample.duration_ns);
+        recorder.submit (record);
+        open.push_back (record.span_id);
+      }
+    }
+
+    void export_frame (const FrameProfile& profile, int64_t frame_start_ns) const {
+      using std::chrono::nanoseconds;
+      for (const auto& sample : profile.samples) {
+        exporter->add_slice (sample.thread, sample.name, "profile",
+            nanoseconds (frame_start_ns + sample.start_ns + unix_offset_ns), nanoseconds (sample.duration_ns));
+      }
+      exporter->add_counter ("frame_ms", profile.duration_ms);
+    }
+  };
+
+  Profiler::Profiler () : m_impl (std::make_unique<Impl> ()) {}
+
+  Profiler::~Profiler () = default;
+
+  Profiler& Profiler::instance () {
+    static Profiler profiler;
+    return profiler;
+  }
+
+  void Profiler::configure (const ProfilerConfig& config) {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    m_impl->config = config;
+    if (m_impl->worst.size () > config.worst_frames) {
+      m_impl->worst.resize (config.worst_frames);
+    }
+  }
+
+  void Profiler::set_enabled (bool enabled) {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    if (enabled && !m_enabled.load (std::memory_order_relaxed)) {
+      m_impl->frame_start = 0; // The first frame mark after this starts a frame
+    }
+    m_enabled.store (enabled, std::memory_order_relaxed);
+  }
+
+  Profiler::ThreadBuffer* Profiler::thread_buffer () {
+    thread_local BufferHolder holder;
+    if (!holder.buffer) {
+      const uint32_t thread = omnicpp::telemetry::SpanRecorder::instance ().thread_number ();
+      std::lock_guard<std::mutex> lock (m_impl->mutex);
+      const std::size_t capacity = std::bit_ceil (std::max<std::size_t> (m_impl->config.ring_capacity, 2));
+      holder.buffer = std::make_shared<ThreadBuffer> (capacity, thread);
+      m_impl->buffers.push_back (holder.buffer);
+    }
+    return holder.buffer.get ();
+  }
+
+  uint32_t Profiler::enter (ThreadBuffer& buffer) noexcept {
+    return buffer.depth++;
+  }
+
+  void Profiler::push (ThreadBuffer& buffer, const char* name, uint64_t start, uint64_t end, uint32_t depth) noexcept {
+    buffer.depth = depth;
+    const uint64_t head = buffer.head.load (std::memory_order_relaxed);
+    if (head - buffer.tail.load (std::memory_order_acquire) > buffer.mask) {
+      buffer.dropped.store (buffer.dropped.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return;
+    }
+    buffer.records[head & buffer.mask] = { name, start, end, depth };
+    buffer.head.store (head + 1, std::memory_order_release);
+  }
+
+  void Profiler::end_frame () {
+    if (!m_enabled.load (std::memory_order_relaxed)) {
+      return;
+    }
+    const uint64_t tick = now ();
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    Impl& impl = *m_impl;
+    impl.calibrate (tick);
+    const int64_t frame_start_ns = impl.to_ns (impl.frame_start);
+    if (impl.frame_start == 0) {
+      impl.drain (0); // Scopes from before the first mark belong to no frame
+      impl.frame_start = tick;
+      return;
+    }
+
+    FrameProfile profile;
+    profile.frame = impl.frame_number++;
+    profile.duration_ms = static_cast<double> (impl.to_ns (tick) - frame_start_ns) / 1e6;
+    profile.samples = impl.drain (frame_start_ns);
+    profile.scopes = Impl::aggregate (profile.samples);
+    impl.frame_start = tick;
+
+    if (impl.exporter) {
+      impl.export_frame (profile, frame_start_ns);
+    }
+    if (impl.config.worst_frames > 0 &&
+        (impl.worst.size () < impl.config.worst_frames || profile.duration_ms > impl.worst.back ().duration_ms)) {
+      if (impl.config.spans_for_worst_frames) {
+        Impl::submit_spans (profile, frame_start_ns);
+      }
+      const auto at = std::upper_bound (impl.worst.begin (), impl.worst.end (), profile.duration_ms,
+          [] (double duration, const FrameProfile& frame) { return duration > frame.duration_ms; });
+      impl.worst.insert (at, profile);
+      if (impl.worst.size () > impl.config.worst_frames) {
+        impl.worst.pop_back ();
+      }
+    }
+    impl.last = std::move (profile);
+  }
+
+  FrameProfile Profiler::last_frame () const {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    return m_impl->last;
+  }
+
+  std::vector<FrameProfile> Profiler::worst_frames () const {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    return m_impl->worst;
+  }
+
+  uint64_t Profiler::dropped () const {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    uint64_t dropped = m_impl->retired_dropped;
+    for (const auto& buffer : m_impl->buffers) {
+      dropped += buffer->dropped.load (std::memory_order_relaxed);
+    }
+    return dropped;
+  }
+
+  void Profiler::reset () {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    m_impl->drain (0);
+    m_impl->frame_start = 0;
+    m_impl->frame_number = 0;
+    m_impl->last = {};
+    m_impl->worst.clear ();
+  }
+
+  void Profiler::set_trace_exporter (std::shared_ptr<omnicpp::telemetry::ChromeTraceExporter> exporter) {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    m_impl->exporter = std::move (exporter);
+  }
+
+} // namespace OmniCpp::Engine::Core
@@ -0,0 +1,323 @@
+/**
+ * @file subsystem_graph.cpp
+ * @brief Dependency-ordered subsystem startup and shutdown implementation
+ */
+
+#include "engine/core/subsystem_graph.hpp"
+#include "engine/concurrency/ThreadPool.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include "engine/logging/Log.hpp"
+
+namespace OmniCpp::Engine::Core {
+
+  using Clock = std::chrono::steady_clock;
+
+  namespace {
+
+    struct Node {
+      SubsystemDesc desc;
+      std::vector<std::size_t> dependencies;
+      std::vector<std::size_t> dependents;
+      std::size_t pending{ 0 };
+      bool initialized{ false };
+      bool main_thread{ false };
+      Clock::time_point start;
+      Clock::time_point end;
+    };
+
+    double to_ms (Clock::duration duration) {
+      return std::chrono::duration<double, std::milli> (duration).count ();
+    }
+
+  } // namespace
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct SubsystemGraph::Impl {
+    std::vector<Node> nodes;
+    std::unordered_map<std::string, std::size_t> index;
+    std::vector<std::size_t> completion_order;
+    StartupReport report;
+
+    bool resolve (std::vector<std::size_t>& topological_order);
+    bool run_node (std::size_t i);
+    bool initialize_serial (const std::vector<std::size_t>& order);
+    bool initialize_parallel (omnicpp::concurrency::ThreadPool& pool);
+    void build_report (Clock::time_point begin, Clock::time_point end);
+  };
+
+  bool SubsystemGraph::Impl::resolve (std::vector<std::size_t>& topological_order) {
+    for (auto& node : nodes) {
+      node.dependencies.clear ();
+      node.dependents.clear ();
+      node.initialized = false;
+    }
+
+    for (std::size_t i = 0; i < nodes.size (); ++i) {
+      for (const auto& dependency : nodes[i].desc.dependencies) {
+        auto it = index.find (dependency);
+        if (it == index.end ()) {
+          omnicpp::log::error ("SubsystemGraph: '{}' depends on unknown subsystem '{}'", nodes[i].desc.name, dependency);
+          return false;
+        }
+        nodes[i].dependencies.push_back (it->second);
+        nodes[it->second].dependents.push_back (i);
+      }
+      nodes[i].pending = nodes[i].dependencies.size ();
+    }
+
+    // Kahn's algorithm; registration order breaks ties so serial mode is stable
+    std::vector<std::size_t> remaining (nodes.size ());
+    std::deque<std::size_t> ready;
+    for (std::size_t i = 0; i < nodes.size (); ++i) {
+      remaining[i] = nodes[i].pending;
+      if (remaining[i] == 0) {
+        ready.push_back (i);
+      }
+    }
+
+    topological_order.clear ();
+    while (!ready.empty ()) {
+      const std::size_t i = ready.front ();
+      ready.pop_front ();
+      topological_order.push_back (i);
+      for (std::size_t dependent : nodes[i].dependents) {
+        if (--remaining[dependent] == 0) {
+          ready.push_back (dependent);
+        }
+      }
+    }
+
+    if (topological_order.size () != nodes.size ()) {
+      omnicpp::log::error ("SubsystemGraph: Dependency cycle detected");
+      return false;
+    }
+    return true;
+  }
+
+  bool SubsystemGraph::Impl::run_node (std::size_t i) {
+    Node& node = nodes[i];
+    node.start = Clock::now ();
+    bool ok = true;
+    if (node.desc.initialize) {
+      try {
+        ok = node.desc.initialize ();
+      } catch (const std::exception& e) {
+        omnicpp::log::error ("SubsystemGraph: '{}' threw during initialization: {}", node.desc.name, e.what ());
+        ok = false;
+      }
+    }
+    node.end = Clock::now ();
+    if (!ok) {
+      omnicpp::log::error ("SubsystemGraph: Failed to initialize '{}'", node.desc.name);
+    }
+    return ok;
+  }
+
+  bool SubsystemGraph::Impl::initialize_serial (const std::vector<std::size_t>& order) {
+    for (std::size_t i : order) {
+      nodes[i].main_thread = true;
+      if (!run_node (i)) {
+        return false;
+      }
+      nodes[i].initialized = true;
+      completion_order.push_back (i);
+    }
+    return true;
+  }
+
+  bool SubsystemGraph::Impl::initialize_parallel (omnicpp::concurrency::ThreadPool& pool) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::size_t> main_ready;
+    std::size_t in_flight = 0;
+    bool failed = false;
+
+    // Called with the mutex held
+    std::function<void (std::size_t)> dispatch;
+    auto finish = [&] (std::size_t i, bool ok) {
+      if (ok) {
+        nodes[i].initialized = true;
+        completion_order.push_back (i);
+        for (std::size_t dependent : nodes[i].dependents) {
+          if (--nodes[dependent].pending == 0 && !failed) {
+            dispatch (dependent);
+          }
+        }
+      } else {
+        failed = true;
+      }
+    };
+
+    dispatch = [&] (std::size_t i) {
+      if (nodes[i].desc.main_thread_only) {
+        nodes[i].main_thread = true;
+        main_ready.push_back (i);
+        cv.notify_all ();
+        return;
+      }
+      ++in_flight;
+      pool.post ([&, i] () {
+        const bool ok = run_node (i);
+        std::lock_guard<std::mutex> lock (mutex);
+        finish (i, ok);
+        --in_flight;
+        cv.notify_all ();
+      });
+    };
+
+    std::unique_lock<std::mutex> lock (mutex);
+    for (std::size_t i = 0; i < nodes.size (); ++i) {
+      if (nodes[i].pending == 0) {
+        dispatch (i);
+      }
+    }
+
+    while (true) {
+      cv.wait (lock, [&] () { return !main_ready.empty () || in_flight == 0; });
+      if (!main_ready.empty ()) {
+        const std::size_t i = main_ready.front ();
+        main_ready.pop_front ();
+        if (failed) {
+          continue;
+        }
+        lock.unlock ();
+        const bool ok = run_node (i);
+        lock.lock ();
+        finish (i, ok);
+        continue;
+      }
+      break; // Nothing queued for this thread and nothing running on the pool
+    }
+
+    return !failed && completion_order.size () == nodes.size ();
+  }
+
+  void SubsystemGraph::Impl::build_report (Clock::time_point begin, Clock::time_point end) {
+    report = {};
+    report.wall_ms = to_ms (end - begin);
+
+    std::optional<std::size_t> last;
+    for (std::size_t i : completion_order) {
+      const Node& node = nodes[i];
+      report.timings.push_back ({ node.desc.name, to_ms (node.start - begin), to_ms (node.end - node.start), node.main_thread });
+      report.serial_ms += to_ms (node.end - node.start);
+      if (!last || node.end > nodes[*last].end) {
+        last = i;
+      }
+    }
+
+    // Walk back from the last finisher through whichever dependency finished last
+    std::vector<std::string> reversed;
+    while (last) {
+      const Node& node = nodes[*last];
+      reversed.push_back (node.desc.name);
+      report.critical_path_ms += to_ms (node.end - node.start);
+
+      std::optional<std::size_t> previous;
+      for (std::size_t dependency : node.dependencies) {
+        if (nodes[dependency].initialized && (!previous || nodes[dependency].end > nodes[*previous].end)) {
+          previous = dependency;
+        }
+      }
+      last = previous;
+    }
+    report.critical_path.assign (reversed.rbegin (), reversed.rend ());
+  }
+
+  SubsystemGraph::SubsystemGraph () : m_impl (std::make_unique<Impl> ()) {
+  }
+
+  SubsystemGraph::~SubsystemGraph () {
+    if (m_impl) {
+      shutdown ();
+    }
+  }
+
+  SubsystemGraph::SubsystemGraph (SubsystemGraph&& other) noexcept : m_impl (std::move (other.m_impl)) {
+  }
+
+  SubsystemGraph& SubsystemGraph::operator= (SubsystemGraph&& other) noexcept {
+    if (this != &other) {
+      m_impl = std::move (other.m_impl);
+    }
+    return *this;
+  }
+
+  bool SubsystemGraph::add (SubsystemDesc desc) {
+    if (m_impl->index.contains (desc.name)) {
+      omnicpp::log::warn ("SubsystemGraph: Subsystem '{}' already registered", desc.name);
+      return false;
+    }
+    m_impl->index.emplace (desc.name, m_impl->nodes.size ());
+    m_impl->nodes.push_back ({});
+    m_impl->nodes.back ().desc = std::move (desc);
+    return true;
+  }
+
+  bool SubsystemGraph::initialize (omnicpp::concurrency::ThreadPool* pool) {
+    if (!m_impl->completion_order.empty ()) {
+      omnicpp::log::warn ("SubsystemGraph: Already initialized");
+      return true;
+    }
+
+    std::vector<std::size_t> order;
+    if (!m_impl->resolve (order)) {
+      return false;
+    }
+
+    const auto begin = Clock::now ();
+    const bool ok = pool ? m_impl->initialize_parallel (*pool) : m_impl->initialize_serial (order);
+    m_impl->build_report (begin, Clock::now ());
+
+    if (!ok) {
+      shutdown ();
+      return false;
+    }
+
+    const auto& report = m_impl->report;
+    std::string path;
+    for (const auto& name : report.critical_path) {
+      path += path.empty () ? name : " -> " + name;
+    }
+    omnicpp::log::info ("SubsystemGraph: {} subsystems up in {:.2f} ms (serial {:.2f} ms), critical path {:.2f} ms: {}",
+        m_impl->nodes.size (), report.wall_ms, report.serial_ms, report.critical_path_ms, path);
+    return true;
+  }
+
+  void SubsystemGraph::shutdown () {
+    auto& order = m_impl->completion_order;
+    for (auto it = order.rbegin (); it != order.rend (); ++it) {
+      Node& node = m_impl->nodes[*it];
+      if (node.desc.shutdown) {
+        node.desc.shutdown ();
+      }
+      node.initialized = false;
+    }
+    order.clear ();
+  }
+
+  std::size_t SubsystemGraph::size () const {
+    return m_impl->nodes.size ();
+  }
+
+  std::vector<std::string> SubsystemGraph::get_initialization_order () const {
+    std::vector<std::string> names;
+    names.reserve (m_impl->completion_order.size ());
+    for (std::size_t i : m_impl->completion_order) {
+      names.push_back (m_impl->nodes[i].desc.name);
+    }
+    return names;
+  }
+
+  const StartupReport& SubsystemGraph::get_startup_report () const {
+    return m_impl->report;
+  }
+
+} // namespace OmniCpp::Engine::Core
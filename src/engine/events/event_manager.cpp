@@ -77,7 +77,7 @@ namespace OmniCpp::Engine::Events {
 
     auto it = m_impl->subscribers.find (event.get_type ());
     if (it != m_impl->subscribers.end ()) {
-      omnicpp::log::debug("EventManager: Publishing event type {} to {} subscribers", static_cast<int>(event.get_type()), it->second.size());
+      LOG_DEBUG_IN(omnicpp::log::Subsystem::Events, "EventManager: Publishing event type {} to {} subscribers", static_cast<int>(event.get_type()), it->second.size());
       for (const auto& callback : it->second) {
         callback (event);
       }
@@ -93,7 +93,7 @@ namespace OmniCpp::Engine::Events {
     }
 
     m_impl->subscribers[type].push_back (callback);
-    omnicpp::log::debug("EventManager: Subscribed to event type {}", static_cast<int>(type));
+    LOG_DEBUG_IN(omnicpp::log::Subsystem::Events, "EventManager: Subscribed to event type {}", static_cast<int>(type));
   }
 
   void EventManager::unsubscribe (EventType type, EventCallback callback) {
@@ -109,7 +109,7 @@ namespace OmniCpp::Engine::Events {
       auto& callbacks = it->second;
       auto new_end = std::remove (callbacks.begin (), callbacks.end (), callback);
       callbacks.erase (new_end, callbacks.end ());
-      omnicpp::log::debug("EventManager: Unsubscribed from event type {}", static_cast<int>(type));
+      LOG_DEBUG_IN(omnicpp::log::Subsystem::Events, "EventManager: Unsubscribed from event type {}", static_cast<int>(type));
     }
   }
 
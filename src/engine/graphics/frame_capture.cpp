@@ -0,0 +1,436 @@
+/**
+ * @file frame_capture.cpp
+ * @brief Asynchronous frame readback ring implementation
+ */
+
+#include "engine/graphics/frame_capture.hpp"
+#include "engine/concurrency/ThreadPool.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include "engine/logging/Log.hpp"
+
+#if __has_include(<stb_image_write.h>)
+  #define STB_IMAGE_WRITE_IMPLEMENTATION
+  #define STBI_WRITE_NO_STDIO
+  #include <stb_image_write.h>
+  #define OMNICPP_CAPTURE_HAS_PNG 1
+#else
+  #define OMNICPP_CAPTURE_HAS_PNG 0
+#endif
+
+namespace OmniCpp::Engine::Graphics {
+
+  namespace {
+
+    enum SlotState : uint8_t { SLOT_FREE = 0, SLOT_RECORDING, SLOT_ENCODING };
+
+    struct CaptureSlot {
+      std::atomic<uint8_t> state{ SLOT_FREE };
+      uint64_t frame_index{ 0 };
+      std::vector<uint8_t> host_storage;
+    };
+
+    void update_max (std::atomic<uint64_t>& target, uint64_t value) {
+      uint64_t current = target.load (std::memory_order_relaxed);
+      while (value > current
+             && !target.compare_exchange_weak (current, value, std::memory_order_relaxed)) {
+      }
+    }
+
+    const char* encoding_extension (CaptureEncoding encoding) {
+      switch (encoding) {
+      case CaptureEncoding::Qoi:
+        return "qoi";
+      case CaptureEncoding::Png:
+        return "png";
+      default:
+        return "rgba";
+      }
+    }
+
+  } // namespace
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct FrameCaptureRing::Impl {
+    FrameCaptureConfig config;
+    omnicpp::concurrency::ThreadPool* pool{ nullptr };
+    std::unique_ptr<CaptureSlot[]> slots;
+    uint32_t slot_count{ 0 };
+    uint32_t next_slot{ 0 }; // Render thread only
+
+    std::atomic<uint32_t> armed_frames{ 0 };
+
+    std::mutex callback_mutex;
+    FrameCaptureCallback callback;
+
+    std::atomic<uint64_t> requested{ 0 };
+    std::atomic<uint64_t> captured{ 0 };
+    std::atomic<uint64_t> deferred{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<uint64_t> encode_time_ns{ 0 };
+    std::atomic<uint64_t> max_render_thread_ns{ 0 };
+
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+    uint32_t outstanding{ 0 };
+
+    bool initialized{ false };
+
+    void encode_slot (uint32_t slot, const uint8_t* pixels, uint32_t width, uint32_t height,
+        std::size_t row_pitch, CapturePixelFormat format);
+    void release_slot (uint32_t slot);
+  };
+
+  void FrameCaptureRing::Impl::encode_slot (uint32_t slot, const uint8_t* pixels, uint32_t width,
+      uint32_t height, std::size_t row_pitch, CapturePixelFormat format) {
+    const auto start = std::chrono::steady_clock::now ();
+
+    // Tighten the rows and swizzle to RGBA while reading the mapped buffer once
+    CapturedFrame frame;
+    frame.frame_index = slots[slot].frame_index;
+    frame.width = width;
+    frame.height = height;
+
+    std::vector<uint8_t> rgba (static_cast<std::size_t> (width) * height * 4);
+    const std::size_t packed_pitch = static_cast<std::size_t> (width) * 4;
+    for (uint32_t y = 0; y < height; ++y) {
+      const uint8_t* src = pixels + y * row_pitch;
+      uint8_t* dst = rgba.data () + y * packed_pitch;
+      if (format == CapturePixelFormat::BGRA8) {
+        for (uint32_t x = 0; x < width; ++x) {
+          dst[x * 4 + 0] = src[x * 4 + 2];
+          dst[x * 4 + 1] = src[x * 4 + 1];
+          dst[x * 4 + 2] = src[x * 4 + 0];
+          dst[x * 4 + 3] = src[x * 4 + 3];
+        }
+      } else {
+        std::memcpy (dst, src, packed_pitch);
+      }
+    }
+
+    // The source buffer is no longer needed; let the render thread reuse it
+    release_slot (slot);
+
+    CaptureEncoding encoding = config.encoding;
+#if !OMNICPP_CAPTURE_HAS_PNG
+    if (encoding == CaptureEncoding::Png) {
+      encoding = CaptureEncoding::Qoi;
+    }
+#endif
+
+    switch (encoding) {
+    case CaptureEncoding::Qoi:
+      frame.data = FrameCaptureRing::encode_qoi (rgba.data (), width, height);
+      break;
+#if OMNICPP_CAPTURE_HAS_PNG
+    case CaptureEncoding::Png:
+      stbi_write_png_to_func (
+          [] (void* context, void* data, int size) {
+            auto* out = static_cast<std::vector<uint8_t>*> (context);
+            auto* bytes = static_cast<const uint8_t*> (data);
+            out->insert (out->end (), bytes, bytes + size);
+          },
+          &frame.data, static_cast<int> (width), static_cast<int> (height), 4, rgba.data (),
+          static_cast<int> (packed_pitch));
+      break;
+#endif
+    default:
+      frame.data = std::move (rgba);
+      break;
+    }
+    frame.encoding = encoding;
+
+    if (!config.output_directory.empty ()) {
+      char file_name[64];
+      std::snprintf (file_name, sizeof (file_name), "_%06llu.%s",
+          static_cast<unsigned long long> (frame.frame_index), encoding_extension (encoding));
+      const auto path = std::filesystem::path (config.output_directory) / (config.file_prefix + file_name);
+      std::ofstream out (path, std::ios::binary);
+      if (out) {
+        out.write (reinterpret_cast<const char*> (frame.data.data ()),
+            static_cast<std::streamsize> (frame.data.size ()));
+      } else {
+        omnicpp::log::warn ("FrameCapture: Failed to write {}", path.string ());
+      }
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds> (
+        std::chrono::steady_clock::now () - start);
+    encode_time_ns.fetch_add (static_cast<uint64_t> (elapsed.count ()), std::memory_order_relaxed);
+    captured.fetch_add (1, std::memory_order_relaxed);
+
+    FrameCaptureCallback consumer;
+    {
+      std::lock_guard<std::mutex> lock (callback_mutex);
+      consumer = callback;
+    }
+    if (consumer) {
+      consumer (std::move (frame));
+    }
+
+    std::lock_guard<std::mutex> lock (idle_mutex);
+    --outstanding;
+    idle_cv.notify_all ();
+  }
+
+  void FrameCaptureRing::Impl::release_slot (uint32_t slot) {
+    slots[slot].state.store (SLOT_FREE, std::memory_order_release);
+  }
+
+  FrameCaptureRing::FrameCaptureRing () : m_impl (std::make_unique<Impl> ()) {
+  }
+
+  FrameCaptureRing::~FrameCaptureRing () {
+    if (m_impl) {
+      shutdown ();
+    }
+  }
+
+  FrameCaptureRing::FrameCaptureRing (FrameCaptureRing&& other) noexcept
+      : m_impl (std::move (other.m_impl)) {
+  }
+
+  FrameCaptureRing& FrameCaptureRing::operator= (FrameCaptureRing&& other) noexcept {
+    if (this != &other) {
+      m_impl = std::move (other.m_impl);
+    }
+    return *this;
+  }
+
+  bool FrameCaptureRing::initialize (const FrameCaptureConfig& config, omnicpp::concurrency::ThreadPool* pool) {
+    if (m_impl->initialized) {
+      omnicpp::log::warn ("FrameCapture: Already initialized");
+      return true;
+    }
+
+    if (config.ring_size == 0) {
+      omnicpp::log::error ("FrameCapture: ring_size must be at least 1");
+      return false;
+    }
+
+    if (!config.output_directory.empty ()) {
+      std::error_code ec;
+      std::filesystem::create_directories (config.output_directory, ec);
+      if (ec) {
+        omnicpp::log::error ("FrameCapture: Cannot create {}: {}", config.output_directory, ec.message ());
+        return false;
+      }
+    }
+
+#if !OMNICPP_CAPTURE_HAS_PNG
+    if (config.encoding == CaptureEncoding::Png) {
+      omnicpp::log::warn ("FrameCapture: PNG support not compiled in, falling back to QOI");
+    }
+#endif
+
+    m_impl->config = config;
+    m_impl->pool = pool ? pool : &omnicpp::concurrency::GlobalThreadPool::instance ();
+    m_impl->slot_count = config.ring_size;
+    m_impl->slots = std::make_unique<CaptureSlot[]> (config.ring_size);
+    m_impl->next_slot = 0;
+    m_impl->initialized = true;
+
+    omnicpp::log::info ("FrameCapture: Initialized with {} readback slots", config.ring_size);
+    return true;
+  }
+
+  void FrameCaptureRing::shutdown () {
+    if (!m_impl->initialized) {
+      return;
+    }
+
+    // Requests still armed now will never be captured
+    m_impl->dropped.fetch_add (m_impl->armed_frames.exchange (0, std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    wait_idle ();
+    m_impl->slots.reset ();
+    m_impl->slot_count = 0;
+    m_impl->initialized = false;
+
+    omnicpp::log::info ("FrameCapture: Shutdown ({} captured, {} deferred, {} dropped)",
+        m_impl->captured.load (), m_impl->deferred.load (), m_impl->dropped.load ());
+  }
+
+  void FrameCaptureRing::request_capture (uint32_t frame_count) {
+    m_impl->requested.fetch_add (frame_count, std::memory_order_relaxed);
+    m_impl->armed_frames.fetch_add (frame_count, std::memory_order_release);
+  }
+
+  void FrameCaptureRing::set_callback (FrameCaptureCallback callback) {
+    std::lock_guard<std::mutex> lock (m_impl->callback_mutex);
+    m_impl->callback = std::move (callback);
+  }
+
+  std::optional<uint32_t> FrameCaptureRing::begin_capture (uint64_t frame_index) {
+    if (!m_impl->initialized || m_impl->armed_frames.load (std::memory_order_acquire) == 0) {
+      return std::nullopt;
+    }
+
+    const uint32_t slot = m_impl->next_slot;
+    uint8_t expected = SLOT_FREE;
+    if (!m_impl->slots[slot].state.compare_exchange_strong (expected, SLOT_RECORDING,
+            std::memory_order_acq_rel)) {
+      // Consumer is behind; keep the request armed and try again next frame
+      m_impl->deferred.fetch_add (1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+
+    m_impl->armed_frames.fetch_sub (1, std::memory_order_relaxed);
+    m_impl->slots[slot].frame_index = frame_index;
+    m_impl->next_slot = (slot + 1) % m_impl->slot_count;
+    return slot;
+  }
+
+  void FrameCaptureRing::complete_capture (uint32_t slot, const uint8_t* pixels, uint32_t width,
+      uint32_t height, std::size_t row_pitch, CapturePixelFormat format) {
+    if (!m_impl->initialized || slot >= m_impl->slot_count) {
+      return;
+    }
+
+    m_impl->slots[slot].state.store (SLOT_ENCODING, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock (m_impl->idle_mutex);
+      ++m_impl->outstanding;
+    }
+
+    Impl* impl = m_impl.get ();
+    m_impl->pool->post ([impl, slot, pixels, width, height, row_pitch, format] () {
+      impl->encode_slot (slot, pixels, width, height, row_pitch, format);
+    });
+  }
+
+  void FrameCaptureRing::cancel_capture (uint32_t slot) {
+    if (!m_impl->initialized || slot >= m_impl->slot_count) {
+      return;
+    }
+    m_impl->armed_frames.fetch_add (1, std::memory_order_relaxed);
+    m_impl->release_slot (slot);
+  }
+
+  uint8_t* FrameCaptureRing::host_slot (uint32_t slot, std::size_t bytes) {
+    if (!m_impl->initialized || slot >= m_impl->slot_count) {
+      return nullptr;
+    }
+    auto& storage = m_impl->slots[slot].host_storage;
+    if (storage.size () < bytes) {
+      storage.resize (bytes); // Only grows on the first capture or a resize
+    }
+    return storage.data ();
+  }
+
+  void FrameCaptureRing::note_render_thread_cost (uint64_t nanoseconds) {
+    update_max (m_impl->max_render_thread_ns, nanoseconds);
+  }
+
+  void FrameCaptureRing::wait_idle () {
+    std::unique_lock<std::mutex> lock (m_impl->idle_mutex);
+    m_impl->idle_cv.wait (lock, [this] () { return m_impl->outstanding == 0; });
+  }
+
+  bool FrameCaptureRing::is_capture_armed () const {
+    return m_impl->armed_frames.load (std::memory_order_relaxed) > 0;
+  }
+
+  uint32_t FrameCaptureRing::get_ring_size () const {
+    return m_impl->slot_count;
+  }
+
+  FrameCaptureStats FrameCaptureRing::get_stats () const {
+    FrameCaptureStats stats;
+    stats.requested = m_impl->requested.load (std::memory_order_relaxed);
+    stats.captured = m_impl->captured.load (std::memory_order_relaxed);
+    stats.deferred = m_impl->deferred.load (std::memory_order_relaxed);
+    stats.dropped = m_impl->dropped.load (std::memory_order_relaxed);
+    stats.encode_time_ns = m_impl->encode_time_ns.load (std::memory_order_relaxed);
+    stats.max_render_thread_ns = m_impl->max_render_thread_ns.load (std::memory_order_relaxed);
+    return stats;
+  }
+
+  std::vector<uint8_t> FrameCaptureRing::encode_qoi (const uint8_t* rgba, uint32_t width, uint32_t height) {
+    // Reference: "The Quite OK Image Format" specification 1.0
+    constexpr uint8_t QOI_OP_INDEX = 0x00;
+    constexpr uint8_t QOI_OP_DIFF = 0x40;
+    constexpr uint8_t QOI_OP_LUMA = 0x80;
+    constexpr uint8_t QOI_OP_RUN = 0xc0;
+    constexpr uint8_t QOI_OP_RGB = 0xfe;
+    constexpr uint8_t QOI_OP_RGBA = 0xff;
+
+    const std::size_t pixel_count = static_cast<std::size_t> (width) * height;
+    std::vector<uint8_t> out;
+    out.reserve (14 + pixel_count * 5 + 8);
+
+    auto put_u32 = [&out] (uint32_t value) {
+      out.push_back (static_cast<uint8_t> (value >> 24));
+      out.push_back (static_cast<uint8_t> (value >> 16));
+      out.push_back (static_cast<uint8_t> (value >> 8));
+      out.push_back (static_cast<uint8_t> (value));
+    };
+
+    out.insert (out.end (), { 'q', 'o', 'i', 'f' });
+    put_u32 (width);
+    put_u32 (height);
+    out.push_back (4); // RGBA
+    out.push_back (0); // sRGB with linear alpha
+
+    std::array<std::array<uint8_t, 4>, 64> index{};
+    std::array<uint8_t, 4> prev{ 0, 0, 0, 255 };
+    uint32_t run = 0;
+
+    for (std::size_t i = 0; i < pixel_count; ++i) {
+      const std::array<uint8_t, 4> px{ rgba[i * 4 + 0], rgba[i * 4 + 1], rgba[i * 4 + 2], rgba[i * 4 + 3] };
+
+      if (px == prev) {
+        ++run;
+        if (run == 62 || i + 1 == pixel_count) {
+          out.push_back (static_cast<uint8_t> (QOI_OP_RUN | (run - 1)));
+          run = 0;
+        }
+        continue;
+      }
+
+      if (run > 0) {
+        out.push_back (static_cast<uint8_t> (QOI_OP_RUN | (run - 1)));
+        run = 0;
+      }
+
+      const uint8_t hash = static_cast<uint8_t> ((px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64);
+      if (index[hash] == px) {
+        out.push_back (static_cast<uint8_t> (QOI_OP_INDEX | hash));
+      } else {
+        index[hash] = px;
+        if (px[3] == prev[3]) {
+          const int8_t vr = static_cast<int8_t> (px[0] - prev[0]);
+          const int8_t vg = static_cast<int8_t> (px[1] - prev[1]);
+          const int8_t vb = static_cast<int8_t> (px[2] - prev[2]);
+          const int8_t vg_r = static_cast<int8_t> (vr - vg);
+          const int8_t vg_b = static_cast<int8_t> (vb - vg);
+
+          if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+            out.push_back (static_cast<uint8_t> (QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+          } else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8) {
+            out.push_back (static_cast<uint8_t> (QOI_OP_LUMA | (vg + 32)));
+            out.push_back (static_cast<uint8_t> ((vg_r + 8) << 4 | (vg_b + 8)));
+          } else {
+            out.insert (out.end (), { QOI_OP_RGB, px[0], px[1], px[2] });
+          }
+        } else {
+          out.insert (out.end (), { QOI_OP_RGBA, px[0], px[1], px[2], px[3] });
+        }
+      }
+      prev = px;
+    }
+
+    out.insert (out.end (), { 0, 0, 0, 0, 0, 0, 0, 1 });
+    return out;
+  }
+
+} // namespace OmniCpp::Engine::Graphics
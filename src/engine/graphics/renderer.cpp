@@ -4,6 +4,7 @@
  */
 
 #include "engine/graphics/renderer.hpp"
+#include "engine/core/profiler.hpp"
 #include "engine/graphics/shaders.hpp"
 #include "engine/graphics/spirv_shaders.hpp"
 #include "engine/graphics/mesh.hpp"
@@ -16,6 +17,7 @@
 #include <optional>
 #include <set>
 #include <cstdlib>
+#include <chrono>
 
 #ifdef OMNICPP_HAS_VULKAN
 #include <xcb/xcb.h>
@@ -150,7 +152,8 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debug_callback(
         return VK_FALSE;
     }
 
-    omnicpp::log::debug("[Vulkan Validation] {}: {}",
+    // A broken draw can report every frame: keep a steady trickle, not a flood
+    LOG_DEBUG_RATE_LIMITED(20, 50, "[Vulkan Validation] {}: {}",
         callback_data->pMessageIdName ? callback_data->pMessageIdName : "Unknown",
         callback_data->pMessage ? callback_data->pMessage : "No message");
 
@@ -461,6 +464,9 @@ struct Renderer::Impl {
     bool initialized{ false };
     static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
 
+    // Asynchronous frame readback
+    FrameCaptureRing frame_capture;
+
 #ifdef OMNICPP_HAS_VULKAN
     // Vulkan instance
     VkInstance instance{ VK_NULL_HANDLE };
@@ -543,9 +549,190 @@ struct Renderer::Impl {
     // Game state for rendering
     float ball_x{10.0f}, ball_y{5.0f};
     float left_paddle_y{5.0f}, right_paddle_y{5.0f};
+
+    // Frame capture readback buffers (one per capture ring slot)
+    bool capture_supported{ false };
+    CapturePixelFormat capture_pixel_format{ CapturePixelFormat::BGRA8 };
+    bool capture_memory_coherent{ true };
+    std::vector<VkBuffer> capture_buffers;
+    std::vector<VkDeviceMemory> capture_buffers_memory;
+    std::vector<uint8_t*> capture_buffers_mapped;
+    std::array<std::optional<uint32_t>, MAX_FRAMES_IN_FLIGHT> capture_pending{};
+
+    bool create_capture_buffers ();
+    void destroy_capture_buffers ();
+    void retire_capture (uint32_t frame);
+    void record_capture (VkCommandBuffer command_buffer, VkImage image, uint32_t slot);
 #endif
 };
 
+#ifdef OMNICPP_HAS_VULKAN
+bool Renderer::Impl::create_capture_buffers () {
+  const uint32_t slot_count = frame_capture.get_ring_size ();
+  const VkDeviceSize size = static_cast<VkDeviceSize>(swap_chain_extent.width) * swap_chain_extent.height * 4;
+
+  VkPhysicalDeviceMemoryProperties mem_properties;
+  vkGetPhysicalDeviceMemoryProperties(physical_device, &mem_properties);
+
+  capture_buffers.assign(slot_count, VK_NULL_HANDLE);
+  capture_buffers_memory.assign(slot_count, VK_NULL_HANDLE);
+  capture_buffers_mapped.assign(slot_count, nullptr);
+
+  for (uint32_t i = 0; i < slot_count; i++) {
+    VkBufferCreateInfo buffer_info{};
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = size;
+    buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkResult result = vkCreateBuffer(device, &buffer_info, nullptr, &capture_buffers[i]);
+    if (result != VK_SUCCESS) {
+      omnicpp::log::error("Failed to create capture buffer: {} ({})",
+                    vk_result_to_string(result), static_cast<int>(result));
+      return false;
+    }
+
+    VkMemoryRequirements mem_requirements;
+    vkGetBufferMemoryRequirements(device, capture_buffers[i], &mem_requirements);
+
+    // Prefer cached host memory: the CPU reads every byte of it back
+    constexpr VkMemoryPropertyFlags cached = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    constexpr VkMemoryPropertyFlags visible = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    std::optional<uint32_t> memory_type_index;
+    for (VkMemoryPropertyFlags wanted : { cached, visible }) {
+      for (uint32_t type = 0; type < mem_properties.memoryTypeCount && !memory_type_index; type++) {
+        if ((mem_requirements.memoryTypeBits & (1u << type)) &&
+            (mem_properties.memoryTypes[type].propertyFlags & wanted) == wanted) {
+          memory_type_index = type;
+        }
+      }
+      if (memory_type_index) {
+        break;
+      }
+    }
+
+    if (!memory_type_index) {
+      omnicpp::log::error("No host-visible memory type for capture buffers");
+      return false;
+    }
+    capture_memory_coherent = (mem_properties.memoryTypes[*memory_type_index].propertyFlags &
+                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+    VkMemoryAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = mem_requirements.size;
+    alloc_info.memoryTypeIndex = *memory_type_index;
+
+    result = vkAllocateMemory(device, &alloc_info, nullptr, &capture_buffers_memory[i]);
+    if (result != VK_SUCCESS) {
+      omnicpp::log::error("Failed to allocate capture buffer memory: {} ({})",
+                    vk_result_to_string(result), static_cast<int>(result));
+      return false;
+    }
+
+    vkBindBufferMemory(device, capture_buffers[i], capture_buffers_memory[i], 0);
+
+    // Persistently mapped; the pool thread reads straight out of it
+    void* mapped = nullptr;
+    vkMapMemory(device, capture_buffers_memory[i], 0, VK_WHOLE_SIZE, 0, &mapped);
+    capture_buffers_mapped[i] = static_cast<uint8_t*>(mapped);
+  }
+
+  omnicpp::log::info("Frame capture: {} readback buffers of {} bytes", slot_count, size);
+  return true;
+}
+
+void Renderer::Impl::destroy_capture_buffers () {
+  for (size_t i = 0; i < capture_buffers.size(); i++) {
+    if (capture_buffers_memory[i] != VK_NULL_HANDLE) {
+      vkUnmapMemory(device, capture_buffers_memory[i]);
+      vkFreeMemory(device, capture_buffers_memory[i], nullptr);
+    }
+    if (capture_buffers[i] != VK_NULL_HANDLE) {
+      vkDestroyBuffer(device, capture_buffers[i], nullptr);
+    }
+  }
+  capture_buffers.clear();
+  capture_buffers_memory.clear();
+  capture_buffers_mapped.clear();
+}
+
+void Renderer::Impl::retire_capture (uint32_t frame) {
+  // Only called once the frame's in-flight fence has signalled
+  if (!capture_pending[frame]) {
+    return;
+  }
+
+  const uint32_t slot = *capture_pending[frame];
+  capture_pending[frame].reset();
+
+  if (!capture_memory_coherent) {
+    VkMappedMemoryRange range{};
+    range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.memory = capture_buffers_memory[slot];
+    range.offset = 0;
+    range.size = VK_WHOLE_SIZE;
+    vkInvalidateMappedMemoryRanges(device, 1, &range);
+  }
+
+  frame_capture.complete_capture(slot, capture_buffers_mapped[slot], swap_chain_extent.width,
+                                 swap_chain_extent.height, static_cast<size_t>(swap_chain_extent.width) * 4,
+                                 capture_pixel_format);
+}
+
+void Renderer::Impl::record_capture (VkCommandBuffer command_buffer, VkImage image, uint32_t slot) {
+  // The render pass leaves the image in PRESENT_SRC; borrow it for a transfer
+  VkImageMemoryBarrier to_transfer{};
+  to_transfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  to_transfer.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  to_transfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  to_transfer.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  to_transfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  to_transfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  to_transfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  to_transfer.image = image;
+  to_transfer.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  to_transfer.subresourceRange.levelCount = 1;
+  to_transfer.subresourceRange.layerCount = 1;
+
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       0, 0, nullptr, 0, nullptr, 1, &to_transfer);
+
+  VkBufferImageCopy region{};
+  region.bufferOffset = 0;
+  region.bufferRowLength = 0;
+  region.bufferImageHeight = 0;
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.layerCount = 1;
+  region.imageExtent = { swap_chain_extent.width, swap_chain_extent.height, 1 };
+
+  vkCmdCopyImageToBuffer(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         capture_buffers[slot], 1, &region);
+
+  VkImageMemoryBarrier to_present = to_transfer;
+  to_present.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  to_present.dstAccessMask = 0;
+  to_present.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  to_present.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+  VkBufferMemoryBarrier to_host{};
+  to_host.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  to_host.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  to_host.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  to_host.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  to_host.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  to_host.buffer = capture_buffers[slot];
+  to_host.offset = 0;
+  to_host.size = VK_WHOLE_SIZE;
+
+  vkCmdPipelineBarrier(command_buffer,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+                       0, 0, nullptr, 1, &to_host, 1, &to_present);
+}
+#endif
+
 Renderer::Renderer () : m_impl (std::make_unique<Impl> ()) {
 }
 
@@ -844,6 +1031,30 @@ bool Renderer::initialize (const RendererConfig& config) {
   swap_chain_create_info.imageExtent = extent;
   swap_chain_create_info.imageArrayLayers = 1;
   swap_chain_create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  if (config.enable_frame_capture) {
+    // Readback copies straight out of the swap chain image
+    if (swap_chain_support.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) {
+      swap_chain_create_info.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+      m_impl->capture_supported = true;
+    } else {
+      omnicpp::log::warn("Frame capture: Swap chain does not support transfer source usage");
+    }
+
+    switch (surface_format.format) {
+      case VK_FORMAT_B8G8R8A8_UNORM:
+      case VK_FORMAT_B8G8R8A8_SRGB:
+        m_impl->capture_pixel_format = CapturePixelFormat::BGRA8;
+        break;
+      case VK_FORMAT_R8G8B8A8_UNORM:
+      case VK_FORMAT_R8G8B8A8_SRGB:
+        m_impl->capture_pixel_format = CapturePixelFormat::RGBA8;
+        break;
+      default:
+        omnicpp::log::warn("Frame capture: Unsupported swap chain format {}", static_cast<int>(surface_format.format));
+        m_impl->capture_supported = false;
+        break;
+    }
+  }
   swap_chain_create_info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
   swap_chain_create_info.preTransform = swap_chain_support.capabilities.currentTransform;
   swap_chain_create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
@@ -1568,6 +1779,15 @@ bool Renderer::initialize (const RendererConfig& config) {
 
   omnicpp::log::info("Semaphores and fences created successfully");
 
+  if (m_impl->capture_supported) {
+    if (!m_impl->frame_capture.initialize(config.capture) || !m_impl->create_capture_buffers()) {
+      omnicpp::log::warn("Frame capture disabled");
+      m_impl->destroy_capture_buffers();
+      m_impl->frame_capture.shutdown();
+      m_impl->capture_supported = false;
+    }
+  }
+
   m_impl->initialized = true;
 
   omnicpp::log::info("Renderer: Initialized with Vulkan");
@@ -1592,6 +1812,16 @@ void Renderer::shutdown () {
 
   vkDeviceWaitIdle(m_impl->device);
 
+  // Captures still waiting on a fence are abandoned; encodes in flight finish first
+  for (auto& pending : m_impl->capture_pending) {
+    if (pending) {
+      m_impl->frame_capture.cancel_capture(*pending);
+      pending.reset();
+    }
+  }
+  m_impl->frame_capture.shutdown();
+  m_impl->destroy_capture_buffers();
+
   // Cleanup semaphores and fences
   for (size_t i = 0; i < m_impl->MAX_FRAMES_IN_FLIGHT; i++) {
     if (m_impl->image_available_semaphores[i] != VK_NULL_HANDLE) {
@@ -1733,6 +1963,9 @@ void Renderer::render () {
   // Wait for previous frame
   vkWaitForFences(m_impl->device, 1, &m_impl->in_flight_fences[m_impl->current_frame], VK_TRUE, UINT64_MAX);
 
+  // The copy recorded MAX_FRAMES_IN_FLIGHT frames ago is now visible to the host
+  m_impl->retire_capture(m_impl->current_frame);
+
   // Acquire image from swap chain
   uint32_t image_index;
   VkResult result = vkAcquireNextImageKHR(
@@ -1748,7 +1981,7 @@ void Renderer::render () {
     // Swap chain is out of date (window resized/minimized)
     // Just skip this frame - the next frame will try again
     // This is a common occurrence during window operations
-    omnicpp::log::debug("Swap chain out of date, skipping frame");
+    LOG_DEBUG_EVERY_MS(1000, "Swap chain out of date, skipping frame");
     return;
   } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
     omnicpp::log::error("Failed to acquire swap chain image: {} ({})",
@@ -1756,6 +1989,9 @@ void Renderer::render () {
     return;
   }
 
+  // Command buffer recording, up to the submit
+  OMNICPP_PROFILE_SCOPE_BEGIN (record_scope, "record");
+
   // Reset fence for current frame
   vkResetFences(m_impl->device, 1, &m_impl->in_flight_fences[m_impl->current_frame]);
 
@@ -1871,14 +2107,27 @@ void Renderer::render () {
   
   vkCmdEndRenderPass(m_impl->command_buffers[m_impl->current_frame]);
 
+  if (m_impl->capture_supported && m_impl->frame_capture.is_capture_armed()) {
+    const auto capture_start = std::chrono::steady_clock::now();
+    if (auto slot = m_impl->frame_capture.begin_capture(m_impl->frame_count)) {
+      m_impl->record_capture(m_impl->command_buffers[m_impl->current_frame],
+                             m_impl->swap_chain_images[image_index], *slot);
+      m_impl->capture_pending[m_impl->current_frame] = slot;
+    }
+    m_impl->frame_capture.note_render_thread_cost(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - capture_start).count()));
+  }
+
   result = vkEndCommandBuffer(m_impl->command_buffers[m_impl->current_frame]);
   if (result != VK_SUCCESS) {
     omnicpp::log::error("Failed to record command buffer: {} ({})",
                   vk_result_to_string(result), static_cast<int>(result));
     return;
   }
+  OMNICPP_PROFILE_SCOPE_END (record_scope);
 
-  // Submit command buffer
+  // Submit and present; the scope runs to the end of the frame
+  OMNICPP_PROFILE_SCOPE ("present");
   VkSubmitInfo submit_info{};
   submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
@@ -1905,6 +2154,10 @@ void Renderer::render () {
   if (result != VK_SUCCESS) {
     omnicpp::log::error("Failed to submit draw command buffer: {} ({})",
                   vk_result_to_string(result), static_cast<int>(result));
+    if (auto& pending = m_impl->capture_pending[m_impl->current_frame]) {
+      m_impl->frame_capture.cancel_capture(*pending);
+      pending.reset();
+    }
     return;
   }
 
@@ -1926,7 +2179,7 @@ void Renderer::render () {
   if (result == VK_ERROR_OUT_OF_DATE_KHR) {
     // Swap chain is out of date (window resized/minimized)
     // Will be handled on next frame
-    omnicpp::log::debug("Swap chain out of date on present");
+    LOG_DEBUG_EVERY_MS(1000, "Swap chain out of date on present");
   } else if (result != VK_SUCCESS) {
     omnicpp::log::error("Failed to present swap chain image: {} ({})",
                   vk_result_to_string(result), static_cast<int>(result));
@@ -1988,4 +2241,16 @@ uint32_t Renderer::get_frame_count () const {
   return m_impl->frame_count;
 }
 
+void Renderer::request_frame_capture (uint32_t frame_count) {
+  if (m_impl->frame_capture.get_ring_size() == 0) {
+    omnicpp::log::warn("Renderer: Frame capture not enabled");
+    return;
+  }
+  m_impl->frame_capture.request_capture(frame_count);
+}
+
+FrameCaptureRing& Renderer::get_frame_capture () {
+  return m_impl->frame_capture;
+}
+
 } // namespace OmniCpp::Engine::Graphics
@@ -0,0 +1,767 @@
+/**
+ * @file binary_log.cpp
+ * @brief Binary log writer and reader implementation
+ */
+
+#include "engine/logging/binary_log.hpp"
+#include "engine/logging/Log.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #include <intrin.h>
+  #define OMNICPP_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define OMNICPP_HAS_RDTSC 1
+#endif
+
+namespace omnicpp::log::binary {
+
+  namespace {
+
+    int64_t steady_ns () {
+      return std::chrono::duration_cast<std::chrono::nanoseconds> (
+          std::chrono::steady_clock::now ().time_since_epoch ())
+          .count ();
+    }
+
+    int64_t unix_ns () {
+      return std::chrono::duration_cast<std::chrono::nanoseconds> (
+          std::chrono::system_clock::now ().time_since_epoch ())
+          .count ();
+    }
+
+    void put_varint (std::vector<uint8_t>& out, uint64_t value) {
+      while (value >= 0x80) {
+        out.push_back (static_cast<uint8_t> (value | 0x80));
+        value >>= 7;
+      }
+      out.push_back (static_cast<uint8_t> (value));
+    }
+
+    void put_string (std::vector<uint8_t>& out, std::string_view text) {
+      put_varint (out, text.size ());
+      out.insert (out.end (), text.begin (), text.end ());
+    }
+
+    /**
+     * @brief One thread's events, single producer (the thread) and single consumer (the writer)
+     */
+    struct ThreadRing {
+      ThreadRing (std::size_t bytes, uint32_t id) : data (new uint8_t[bytes]), mask (bytes - 1), thread (id) {}
+
+      std::unique_ptr<uint8_t[]> data;
+      std::size_t mask;
+      uint32_t thread;
+
+      // Owner only
+      uint64_t last_ticks{ 0 };
+      uint64_t pending_ticks{ 0 };
+      uint32_t generation{ 0 };
+      uint32_t pending_generation{ 0 };
+      bool resync{ true }; // Next event carries an absolute timestamp
+
+      alignas (64) std::atomic<uint64_t> head{ 0 }; // Bytes published by the owner
+      std::atomic<uint64_t> events{ 0 };
+      std::atomic<uint64_t> dropped{ 0 };
+      alignas (64) std::atomic<uint64_t> tail{ 0 }; // Bytes consumed by the writer
+      std::atomic<bool> retired{ false };
+
+      std::mutex name_mutex;
+      std::string name;
+    };
+
+    struct State {
+      std::mutex mutex; // Everything below; never taken on the logging path once a thread has its ring
+      std::vector<std::shared_ptr<ThreadRing>> rings;
+      std::vector<std::vector<uint8_t>> sites; // Encoded Format records, by site id
+      std::size_t sites_written{ 0 };
+      uint32_t next_thread{ 1 };
+      BinaryLogConfig config;
+
+      std::FILE* file{ nullptr };
+      std::thread writer;
+      std::condition_variable wake;
+      std::condition_variable drained;
+      bool stop{ false };
+      uint64_t flush_requested{ 0 };
+      uint64_t flush_completed{ 0 };
+      int64_t open_ns{ 0 };
+      int64_t last_clock_ns{ 0 };
+      std::atomic<uint32_t> generation{ 0 };
+
+      uint64_t bytes_written{ 0 };
+      uint64_t retired_events{ 0 };
+      uint64_t total_dropped{ 0 };
+
+      ~State ();
+    };
+
+    State& state () {
+      static State instance;
+      return instance;
+    }
+
+    struct RingHolder {
+      std::shared_ptr<ThreadRing> ring;
+
+      ~RingHolder () {
+        if (ring) {
+          ring->retired.store (true, std::memory_order_release);
+        }
+      }
+    };
+
+    ThreadRing* thread_ring () {
+      thread_local RingHolder holder;
+      if (!holder.ring) {
+        State& s = state ();
+        std::lock_guard<std::mutex> lock (s.mutex);
+        const std::size_t bytes = std::bit_ceil (std::max<std::size_t> (s.config.ring_bytes, 4096));
+        holder.ring = std::make_shared<ThreadRing> (bytes, s.next_thread++);
+        s.rings.push_back (holder.ring);
+      }
+      return holder.ring.get ();
+    }
+
+    void write_bytes (State& s, const uint8_t* data, std::size_t size) {
+      if (size > 0) {
+        std::fwrite (data, 1, size, s.file);
+        s.bytes_written += size;
+      }
+    }
+
+    void write_clock_locked (State& s) {
+      uint8_t record[32];
+      detail::Encoder encoder (record, 0);
+      encoder.byte (static_cast<uint8_t> (RecordType::Clock));
+      encoder.raw<uint64_t> (ticks ());
+      s.last_clock_ns = steady_ns ();
+      encoder.raw<int64_t> (s.last_clock_ns - s.open_ns);
+      write_bytes (s, record, encoder.size ());
+    }
+
+    /**
+     * @brief Copy everything published so far into the file
+     *
+     * Ring heads are read before the site list: an event in the snapshot was
+     * logged after its site registered, so the Format record is always
+     * written ahead of the first event that uses it.
+     */
+    void drain_locked (State& s) {
+      std::vector<uint64_t> heads;
+      heads.reserve (s.rings.size ());
+      for (const auto& ring : s.rings) {
+        heads.push_back (ring->head.load (std::memory_order_acquire));
+      }
+      for (; s.sites_written < s.sites.size (); ++s.sites_written) {
+        write_bytes (s, s.sites[s.sites_written].data (), s.sites[s.sites_written].size ());
+      }
+
+      uint8_t record[MAX_RECORD];
+      for (std::size_t i = 0; i < heads.size (); ++i) {
+        ThreadRing& ring = *s.rings[i];
+        const uint64_t tail = ring.tail.load (std::memory_order_relaxed);
+        if (heads[i] != tail) {
+          detail::Encoder encoder (record, 0);
+          encoder.byte (static_cast<uint8_t> (RecordType::Thread));
+          encoder.varint (ring.thread);
+          {
+            std::lock_guard<std::mutex> lock (ring.name_mutex);
+            encoder.string (ring.name);
+          }
+          write_bytes (s, record, encoder.size ());
+
+          const std::size_t size = heads[i] - tail;
+          const std::size_t offset = static_cast<std::size_t> (tail) & ring.mask;
+          const std::size_t first = std::min (size, ring.mask + 1 - offset);
+          write_bytes (s, ring.data.get () + offset, first);
+          write_bytes (s, ring.data.get (), size - first);
+          ring.tail.store (heads[i], std::memory_order_release);
+        }
+        if (const uint64_t dropped = ring.dropped.exchange (0, std::memory_order_relaxed)) {
+          detail::Encoder encoder (record, 0);
+          encoder.byte (static_cast<uint8_t> (RecordType::Dropped));
+          encoder.varint (ring.thread);
+          encoder.varint (dropped);
+          write_bytes (s, record, encoder.size ());
+          s.total_dropped += dropped;
+        }
+      }
+
+      // Rings of exited threads go once they are empty
+      std::erase_if (s.rings, [&s] (const std::shared_ptr<ThreadRing>& ring) {
+        if (!ring->retired.load (std::memory_order_acquire) ||
+            ring->head.load (std::memory_order_acquire) != ring->tail.load (std::memory_order_relaxed)) {
+          return false;
+        }
+        s.retired_events += ring->events.load (std::memory_order_relaxed);
+        return true;
+      });
+
+      if (steady_ns () - s.last_clock_ns >= 1000000000) {
+        write_clock_locked (s);
+      }
+      std::fflush (s.file);
+    }
+
+    /**
+     * @brief Stop the writer and close the file; close() and process exit share it
+     */
+    void shutdown (State& s) {
+      detail::g_enabled.store (false, std::memory_order_relaxed);
+      std::unique_lock<std::mutex> lock (s.mutex);
+      if (s.file == nullptr) {
+        return;
+      }
+      s.stop = true;
+      s.wake.notify_all ();
+      lock.unlock ();
+      s.writer.join ();
+      lock.lock ();
+
+      drain_locked (s);
+      write_clock_locked (s);
+      std::fclose (s.file);
+      s.file = nullptr;
+      s.drained.notify_all ();
+    }
+
+    State::~State () { shutdown (*this); }
+
+    void writer_loop (State& s) {
+      std::unique_lock<std::mutex> lock (s.mutex);
+      while (!s.stop) {
+        s.wake.wait_for (lock, std::chrono::milliseconds (s.config.flush_interval_ms),
+            [&s] { return s.stop || s.flush_requested != s.flush_completed; });
+        const uint64_t requested = s.flush_requested;
+        drain_locked (s);
+        s.flush_completed = requested;
+        s.drained.notify_all ();
+      }
+    }
+
+  } // namespace
+
+  uint64_t ticks () {
+#if defined(OMNICPP_HAS_RDTSC)
+    return __rdtsc ();
+#else
+    return static_cast<uint64_t> (steady_ns ());
+#endif
+  }
+
+  double ticks_per_second () {
+#if defined(OMNICPP_HAS_RDTSC)
+    // Measured once per process; Clock records in each file refine it
+    static const double rate = [] {
+      const int64_t start_ns = steady_ns ();
+      const uint64_t start = ticks ();
+      std::this_thread::sleep_for (std::chrono::milliseconds (10));
+      const uint64_t end = ticks ();
+      const int64_t elapsed_ns = steady_ns () - start_ns;
+      return static_cast<double> (end - start) * 1e9 / static_cast<double> (elapsed_ns);
+    }();
+    return rate;
+#else
+    return 1e9;
+#endif
+  }
+
+  bool open (const std::string& path, const BinaryLogConfig& config) {
+    close ();
+    std::FILE* file = std::fopen (path.c_str (), "wb");
+    if (file == nullptr) {
+      omnicpp::log::error ("BinaryLog: Cannot open {}", path);
+      return false;
+    }
+    std::setvbuf (file, nullptr, _IOFBF, 1 << 20);
+
+    State& s = state ();
+    std::lock_guard<std::mutex> lock (s.mutex);
+    s.file = file;
+    s.config = config;
+    s.bytes_written = 0;
+    s.sites_written = 0; // Every known site is described again in the new file
+    s.stop = false;
+    s.open_ns = steady_ns ();
+    s.last_clock_ns = s.open_ns;
+    for (const auto& ring : s.rings) {
+      // Leftovers from after the previous close() have deltas relative to the old file
+      ring->tail.store (ring->head.load (std::memory_order_acquire), std::memory_order_release);
+    }
+    s.generation.fetch_add (1, std::memory_order_relaxed);
+
+    std::vector<uint8_t> header (std::begin (FILE_MAGIC), std::end (FILE_MAGIC));
+    const auto append = [&header] (const auto& value) {
+      const auto* bytes = reinterpret_cast<const uint8_t*> (&value);
+      header.insert (header.end (), bytes, bytes + sizeof (value));
+    };
+    append (FILE_VERSION);
+    append (ticks_per_second ());
+    append (ticks ());
+    append (unix_ns ());
+    write_bytes (s, header.data (), header.size ());
+
+    s.writer = std::thread (writer_loop, std::ref (s));
+    detail::g_min_level.store (static_cast<uint8_t> (config.min_level), std::memory_order_relaxed);
+    detail::g_enabled.store (true, std::memory_order_release);
+    return true;
+  }
+
+  void close () {
+    shutdown (state ());
+  }
+
+  void flush () {
+    State& s = state ();
+    std::unique_lock<std::mutex> lock (s.mutex);
+    if (s.file == nullptr) {
+      return;
+    }
+    const uint64_t ticket = ++s.flush_requested;
+    s.wake.notify_all ();
+    s.drained.wait (lock, [&s, ticket] { return s.file == nullptr || s.flush_completed >= ticket; });
+  }
+
+  bool is_open () {
+    return detail::g_enabled.load (std::memory_order_relaxed);
+  }
+
+  BinaryLogStats get_stats () {
+    State& s = state ();
+    std::lock_guard<std::mutex> lock (s.mutex);
+    BinaryLogStats stats;
+    stats.events = s.retired_events;
+    stats.dropped = s.total_dropped;
+    for (const auto& ring : s.rings) {
+      stats.events += ring->events.load (std::memory_order_relaxed);
+      stats.dropped += ring->dropped.load (std::memory_order_relaxed);
+    }
+    stats.bytes_written = s.bytes_written;
+    return stats;
+  }
+
+  void set_level (Level level) {
+    detail::g_min_level.store (static_cast<uint8_t> (level), std::memory_order_relaxed);
+  }
+
+  void set_thread_name (std::string_view name) {
+    ThreadRing* ring = thread_ring ();
+    std::lock_guard<std::mutex> lock (ring->name_mutex);
+    ring->name.assign (name);
+  }
+
+  const char* level_name (Level level) {
+    switch (level) {
+      case Level::Trace: return "trace";
+      case Level::Debug: return "debug";
+      case Level::Info: return "info";
+      case Level::Warning: return "warning";
+      case Level::Error: return "error";
+      case Level::Critical: return "critical";
+    }
+    return "unknown";
+  }
+
+  namespace detail {
+
+    uint32_t register_site (Level level, const char* format, const char* file, uint32_t line, const ArgType* types,
+        std::size_t count) {
+      State& s = state ();
+      std::lock_guard<std::mutex> lock (s.mutex);
+      const auto id = static_cast<uint32_t> (s.sites.size ());
+      std::vector<uint8_t> record;
+      record.push_back (static_cast<uint8_t> (RecordType::Format));
+      put_varint (record, id);
+      record.push_back (static_cast<uint8_t> (level));
+      record.push_back (static_cast<uint8_t> (count));
+      for (std::size_t i = 0; i < count; ++i) {
+        record.push_back (static_cast<uint8_t> (types[i]));
+      }
+      put_string (record, file);
+      put_varint (record, line);
+      put_string (record, format);
+      s.sites.push_back (std::move (record));
+      return id;
+    }
+
+    bool begin_event (Encoder& encoder, uint32_t site) {
+      ThreadRing* ring = thread_ring ();
+      const uint64_t used = ring->head.load (std::memory_order_relaxed) - ring->tail.load (std::memory_order_acquire);
+      if (ring->mask + 1 - static_cast<std::size_t> (used) < MAX_RECORD) {
+        // Nearly full: drop before encoding anything
+        ring->dropped.fetch_add (1, std::memory_order_relaxed);
+        return false;
+      }
+      const uint64_t now = ticks ();
+      const uint32_t generation = state ().generation.load (std::memory_order_relaxed);
+      if (ring->resync || ring->generation != generation) {
+        encoder.byte (static_cast<uint8_t> (RecordType::Sync));
+        encoder.varint (site);
+        encoder.raw<uint64_t> (now);
+      } else {
+        encoder.byte (static_cast<uint8_t> (RecordType::Event));
+        encoder.varint (site);
+        encoder.zigzag (static_cast<int64_t> (now - ring->last_ticks));
+      }
+      ring->pending_ticks = now;
+      ring->pending_generation = generation;
+      return true;
+    }
+
+    void commit_event (const uint8_t* record, std::size_t size) {
+      // begin_event left at least MAX_RECORD free, and only the owner adds to the ring
+      ThreadRing* ring = thread_ring ();
+      const uint64_t head = ring->head.load (std::memory_order_relaxed);
+      const std::size_t capacity = ring->mask + 1;
+      const std::size_t offset = static_cast<std::size_t> (head) & ring->mask;
+      const std::size_t first = std::min (size, capacity - offset);
+      std::memcpy (ring->data.get () + offset, record, first);
+      std::memcpy (ring->data.get (), record + first, size - first);
+      ring->head.store (head + size, std::memory_order_release);
+
+      ring->last_ticks = ring->pending_ticks;
+      ring->generation = ring->pending_generation;
+      ring->resync = false;
+      ring->events.store (ring->events.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+  } // namespace detail
+
+  // ==========================================================================
+  // Reader
+  // ==========================================================================
+
+  namespace {
+
+    template<typename T>
+    void format_value (std::string& out, std::string_view spec, const T& value) {
+      const std::string field = "{" + std::string (spec) + "}";
+      try {
+        out += std::vformat (field, std::make_format_args (value));
+      } catch (const std::format_error&) {
+        out += field; // Spec does not suit the stored type; keep it visible rather than fail the line
+      }
+    }
+
+  } // namespace
+
+  namespace {
+
+    bool get_varint (const uint8_t*& cursor, const uint8_t* end, uint64_t& value) {
+      value = 0;
+      for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+        const uint8_t byte = *cursor++;
+        value |= static_cast<uint64_t> (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    template<typename T>
+    bool get_raw (const uint8_t*& cursor, const uint8_t* end, T& value) {
+      if (static_cast<std::size_t> (end - cursor) < sizeof (T)) {
+        return false;
+      }
+      std::memcpy (&value, cursor, sizeof (T));
+      cursor += sizeof (T);
+      return true;
+    }
+
+  } // namespace
+
+  bool decode_args (const uint8_t*& cursor, const uint8_t* end, const std::vector<ArgType>& types,
+      std::vector<Value>& args) {
+    args.resize (types.size ());
+    for (std::size_t i = 0; i < types.size (); ++i) {
+      Value& value = args[i];
+      value.type = types[i];
+      uint64_t raw = 0;
+      switch (value.type) {
+        case ArgType::Bool:
+          if (cursor >= end) {
+            return false;
+          }
+          value.i = *cursor++;
+          break;
+        case ArgType::Int:
+          if (!get_varint (cursor, end, raw)) {
+            return false;
+          }
+          value.i = static_cast<int64_t> (raw >> 1) ^ -static_cast<int64_t> (raw & 1);
+          break;
+        case ArgType::UInt:
+          if (!get_varint (cursor, end, value.u)) {
+            return false;
+          }
+          break;
+        case ArgType::F32: {
+          float f = 0.0f;
+          if (!get_raw (cursor, end, f)) {
+            return false;
+          }
+          value.f = f;
+          break;
+        }
+        case ArgType::F64:
+          if (!get_raw (cursor, end, value.f)) {
+            return false;
+          }
+          break;
+        case ArgType::Str:
+          if (!get_varint (cursor, end, raw) || raw > static_cast<uint64_t> (end - cursor)) {
+            return false;
+          }
+          value.s.assign (reinterpret_cast<const char*> (cursor), raw);
+          cursor += raw;
+          break;
+      }
+    }
+    return true;
+  }
+
+  std::string DecodedEvent::message () const {
+    std::string out;
+    if (format == nullptr) {
+      return out;
+    }
+    const std::string& text = format->format;
+    std::size_t next_arg = 0;
+    for (std::size_t i = 0; i < text.size (); ++i) {
+      const char c = text[i];
+      if ((c == '{' || c == '}') && i + 1 < text.size () && text[i + 1] == c) {
+        out += c; // Escaped brace
+        ++i;
+        continue;
+      }
+      if (c != '{') {
+        out += c;
+        continue;
+      }
+      const std::size_t close = text.find ('}', i);
+      if (close == std::string::npos) {
+        out.append (text, i, std::string::npos);
+        break;
+      }
+      const std::string_view field (text.data () + i + 1, close - i - 1);
+      const std::size_t colon = field.find (':');
+      const std::string_view index = field.substr (0, colon);
+      const std::string_view spec = colon == std::string_view::npos ? std::string_view{} : field.substr (colon);
+      const std::size_t arg = index.empty () ? next_arg++ : std::stoul (std::string (index));
+      if (arg < args.size ()) {
+        const Value& value = args[arg];
+        switch (value.type) {
+          case ArgType::Bool: format_value (out, spec, value.i != 0); break;
+          case ArgType::Int: format_value (out, spec, value.i); break;
+          case ArgType::UInt: format_value (out, spec, value.u); break;
+          case ArgType::F32: format_value (out, spec, static_cast<float> (value.f)); break;
+          case ArgType::F64: format_value (out, spec, value.f); break;
+          case ArgType::Str: format_value (out, spec, value.s); break;
+        }
+      }
+      i = close;
+    }
+    return out;
+  }
+
+  bool BinaryLogReader::open (const std::string& path) {
+    *this = BinaryLogReader{};
+    std::ifstream in (path, std::ios::binary);
+    if (!in) {
+      return fail ("cannot open file");
+    }
+    m_data.assign (std::istreambuf_iterator<char> (in), std::istreambuf_iterator<char> ());
+    if (m_data.size () < sizeof (FILE_MAGIC) || !std::equal (std::begin (FILE_MAGIC), std::end (FILE_MAGIC), m_data.begin ())) {
+      return fail ("not a binary log");
+    }
+    m_offset = sizeof (FILE_MAGIC);
+    uint32_t version = 0;
+    if (!read_raw (version) || version != FILE_VERSION) {
+      return fail ("unsupported version");
+    }
+    if (!read_raw (m_ticks_per_second) || !read_raw (m_base_ticks) || !read_raw (m_base_unix_ns)) {
+      return fail ("truncated header");
+    }
+    m_start_ticks = m_base_ticks;
+    return true;
+  }
+
+  bool BinaryLogReader::next (DecodedEvent& event) {
+    while (m_offset < m_data.size ()) {
+      const auto type = static_cast<RecordType> (m_data[m_offset++]);
+      switch (type) {
+        case RecordType::Format: {
+          FormatInfo info;
+          uint64_t id = 0;
+          uint64_t line = 0;
+          if (!read_varint (id) || m_offset + 2 > m_data.size ()) {
+            return fail ("truncated format record");
+          }
+          info.id = static_cast<uint32_t> (id);
+          info.level = static_cast<Level> (m_data[m_offset++]);
+          const uint8_t count = m_data[m_offset++];
+          if (m_offset + count > m_data.size ()) {
+            return fail ("truncated format record");
+          }
+          for (uint8_t i = 0; i < count; ++i) {
+            info.types.push_back (static_cast<ArgType> (m_data[m_offset++]));
+          }
+          if (!read_string (info.file) || !read_varint (line) || !read_string (info.format)) {
+            return fail ("truncated format record");
+          }
+          info.line = static_cast<uint32_t> (line);
+          if (m_formats.size () <= info.id) {
+            m_formats.resize (info.id + 1);
+          }
+          m_formats[info.id] = std::move (info);
+          break;
+        }
+        case RecordType::Thread: {
+          uint64_t thread = 0;
+          std::string name;
+          if (!read_varint (thread) || !read_string (name)) {
+            return fail ("truncated thread record");
+          }
+          m_thread = static_cast<uint32_t> (thread);
+          auto it = std::find_if (m_threads.begin (), m_threads.end (), [this] (const auto& t) { return t.first == m_thread; });
+          if (it == m_threads.end ()) {
+            m_threads.emplace_back (m_thread, std::move (name));
+          } else if (!name.empty ()) {
+            it->second = std::move (name);
+          }
+          break;
+        }
+        case RecordType::Event:
+        case RecordType::Sync: {
+          uint64_t site = 0;
+          if (!read_varint (site) || site >= m_formats.size () || m_formats[site].file.empty ()) {
+            return fail ("event for an unknown format");
+          }
+          auto last = std::find_if (m_last_ticks.begin (), m_last_ticks.end (), [this] (const auto& t) { return t.first == m_thread; });
+          if (last == m_last_ticks.end ()) {
+            m_last_ticks.emplace_back (m_thread, 0);
+            last = m_last_ticks.end () - 1;
+          }
+          if (type == RecordType::Sync) {
+            if (!read_raw (last->second)) {
+              return fail ("truncated event");
+            }
+          } else {
+            uint64_t delta = 0;
+            if (!read_varint (delta)) {
+              return fail ("truncated event");
+            }
+            last->second += static_cast<uint64_t> (static_cast<int64_t> (delta >> 1) ^ -static_cast<int64_t> (delta & 1));
+          }
+          event.format = &m_formats[site];
+          event.thread = m_thread;
+          event.thread_name = thread_name (m_thread);
+          event.ticks = last->second;
+          if (!read_args (m_formats[site], event)) {
+            return fail ("truncated event arguments");
+          }
+          to_time (event);
+          return true;
+        }
+        case RecordType::Dropped: {
+          uint64_t thread = 0;
+          uint64_t count = 0;
+          if (!read_varint (thread) || !read_varint (count)) {
+            return fail ("truncated dropped record");
+          }
+          m_dropped += count;
+          break;
+        }
+        case RecordType::Clock: {
+          uint64_t clock_ticks = 0;
+          int64_t since_open_ns = 0;
+          if (!read_raw (clock_ticks) || !read_raw (since_open_ns)) {
+            return fail ("truncated clock record");
+          }
+          // Over a longer span the measured rate beats the 10 ms estimate in the header
+          if (since_open_ns > 100000000 && clock_ticks > m_base_ticks) {
+            m_ticks_per_second = static_cast<double> (clock_ticks - m_base_ticks) * 1e9 / static_cast<double> (since_open_ns);
+          }
+          break;
+        }
+        default: return fail ("unknown record type");
+      }
+    }
+    return false;
+  }
+
+  std::string_view BinaryLogReader::thread_name (uint32_t thread) const {
+    for (const auto& [id, name] : m_threads) {
+      if (id == thread) {
+        return name;
+      }
+    }
+    return {};
+  }
+
+  bool BinaryLogReader::fail (const char* what) {
+    m_error = what;
+    m_offset = m_data.size ();
+    return false;
+  }
+
+  bool BinaryLogReader::read_varint (uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && m_offset < m_data.size (); shift += 7) {
+      const uint8_t byte = m_data[m_offset++];
+      value |= static_cast<uint64_t> (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool BinaryLogReader::read_string (std::string& text) {
+    uint64_t length = 0;
+    if (!read_varint (length) || length > m_data.size () - m_offset) {
+      return false;
+    }
+    text.assign (reinterpret_cast<const char*> (m_data.data () + m_offset), length);
+    m_offset += length;
+    return true;
+  }
+
+  template<typename T>
+  bool BinaryLogReader::read_raw (T& value) {
+    if (sizeof (T) > m_data.size () - m_offset) {
+      return false;
+    }
+    std::memcpy (&value, m_data.data () + m_offset, sizeof (T));
+    m_offset += sizeof (T);
+    return true;
+  }
+
+  bool BinaryLogReader::read_args (const FormatInfo& format, DecodedEvent& event) {
+    const uint8_t* cursor = m_data.data () + m_offset;
+    if (!decode_args (cursor, m_data.data () + m_data.size (), format.types, event.args)) {
+      return false;
+    }
+    m_offset = static_cast<std::size_t> (cursor - m_data.data ());
+    return true;
+  }
+
+  void BinaryLogReader::to_time (DecodedEvent& event) const {
+    const double elapsed = static_cast<double> (static_cast<int64_t> (event.ticks - m_start_ticks)) / m_ticks_per_second;
+    event.seconds = elapsed;
+    event.unix_ns = m_base_unix_ns + static_cast<int64_t> (elapsed * 1e9);
+  }
+
+} // namespace omnicpp::log::binary
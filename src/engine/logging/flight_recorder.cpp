@@ -0,0 +1,445 @@
+/**
+ * @file flight_recorder.cpp
+ * @brief Flight recorder mapping, slot publishing and decoder
+ */
+
+#include "engine/logging/flight_recorder.hpp"
+#include "engine/logging/Log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+namespace omnicpp::log::flight {
+
+  namespace {
+
+    struct FileHeader {
+      char magic[8];
+      uint32_t version;
+      uint32_t threads;
+      uint32_t slots_per_thread;
+      uint32_t slot_bytes;
+      int64_t created_unix_ns;
+      uint64_t pid;
+      uint64_t unrecorded;
+      uint8_t reserved[16];
+    };
+    static_assert(sizeof (FileHeader) == 64);
+
+    struct RingHeader {
+      uint32_t owner;   // Thread id of the current owner, 0 when free
+      uint32_t thread;  // Thread id of the last owner, which the name belongs to
+      uint64_t written; // Records written into this ring, ever
+      char name[48];
+    };
+    static_assert(sizeof (RingHeader) == 64);
+
+    struct SlotHeader {
+      uint32_t seq; // 2n+1 while record n is being written, 2n+2 once it is complete
+      uint16_t size;
+      uint8_t level;
+      uint8_t arg_count;
+      uint32_t thread;
+      uint32_t line;
+      int64_t unix_ns;
+    };
+    static_assert(sizeof (SlotHeader) == 24);
+
+    int64_t unix_ns () {
+      return std::chrono::duration_cast<std::chrono::nanoseconds> (
+          std::chrono::system_clock::now ().time_since_epoch ())
+          .count ();
+    }
+
+    uint64_t process_id () {
+#if defined(_WIN32)
+      return GetCurrentProcessId ();
+#else
+      return static_cast<uint64_t> (::getpid ());
+#endif
+    }
+
+    struct Mapping {
+      uint8_t* base{ nullptr };
+      std::size_t size{ 0 };
+      FlightRecorderConfig config;
+    };
+
+    struct State {
+      std::mutex mutex;
+      std::vector<Mapping> retired; // Closed mappings, never unmapped (see close())
+      Mapping current;
+      std::atomic<uint32_t> generation{ 0 };
+      std::atomic<uint32_t> next_thread{ 1 };
+    };
+
+    State& state () {
+      static State instance;
+      return instance;
+    }
+
+    uint8_t* map_file (const std::string& path, std::size_t size) {
+#if defined(_WIN32)
+      HANDLE file = CreateFileA (path.c_str (), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE,
+          nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+      }
+      const auto high = static_cast<DWORD> (static_cast<uint64_t> (size) >> 32);
+      const auto low = static_cast<DWORD> (size & 0xffffffffu);
+      HANDLE mapping = CreateFileMappingA (file, nullptr, PAGE_READWRITE, high, low, nullptr);
+      CloseHandle (file);
+      if (mapping == nullptr) {
+        return nullptr;
+      }
+      void* view = MapViewOfFile (mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+      CloseHandle (mapping); // The view keeps the section alive
+      return static_cast<uint8_t*> (view);
+#else
+      const int fd = ::open (path.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0) {
+        return nullptr;
+      }
+      if (::ftruncate (fd, static_cast<off_t> (size)) != 0) {
+        ::close (fd);
+        return nullptr;
+      }
+      void* view = ::mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      ::close (fd);
+      return view == MAP_FAILED ? nullptr : static_cast<uint8_t*> (view);
+#endif
+    }
+
+    FileHeader* file_header (uint8_t* base) {
+      return reinterpret_cast<FileHeader*> (base);
+    }
+
+    RingHeader* ring_header (uint8_t* base, uint32_t ring) {
+      return reinterpret_cast<RingHeader*> (base + sizeof (FileHeader)) + ring;
+    }
+
+    /**
+     * @brief The calling thread's claim on a ring of the current mapping
+     */
+    struct Owner {
+      uint8_t* base{ nullptr };
+      RingHeader* ring{ nullptr };
+      uint8_t* slots{ nullptr };
+      uint32_t slots_per_thread{ 0 };
+      uint32_t slot_bytes{ 0 };
+      uint32_t generation{ UINT32_MAX };
+      uint32_t thread{ 0 };
+      uint32_t retry{ 0 }; // Records to skip before looking for a free ring again
+
+      void release () {
+        if (ring != nullptr) {
+          std::atomic_ref<uint32_t> (ring->owner).store (0, std::memory_order_release);
+          ring = nullptr;
+        }
+      }
+
+      ~Owner () { release (); }
+    };
+
+    bool claim (Owner& owner) {
+      State& s = state ();
+      const uint32_t generation = s.generation.load (std::memory_order_acquire);
+      if (owner.generation == generation && owner.ring != nullptr) {
+        return true;
+      }
+      if (owner.generation == generation && owner.retry > 0) {
+        --owner.retry;
+        return false;
+      }
+      owner.release ();
+      if (owner.thread == 0) {
+        owner.thread = s.next_thread.fetch_add (1, std::memory_order_relaxed);
+      }
+
+      std::lock_guard<std::mutex> lock (s.mutex);
+      Mapping& mapping = s.current;
+      owner.generation = s.generation.load (std::memory_order_relaxed);
+      owner.base = mapping.base;
+      if (mapping.base == nullptr) {
+        return false;
+      }
+      for (uint32_t i = 0; i < mapping.config.threads; ++i) {
+        RingHeader* ring = ring_header (mapping.base, i);
+        uint32_t expected = 0;
+        if (std::atomic_ref<uint32_t> (ring->owner).compare_exchange_strong (expected, owner.thread,
+                std::memory_order_acq_rel)) {
+          ring->thread = owner.thread;
+          std::memset (ring->name, 0, sizeof (ring->name));
+          owner.ring = ring;
+          owner.slots = mapping.base + sizeof (FileHeader) + sizeof (RingHeader) * mapping.config.threads +
+                        static_cast<std::size_t> (i) * mapping.config.slots_per_thread * mapping.config.slot_bytes;
+          owner.slots_per_thread = mapping.config.slots_per_thread;
+          owner.slot_bytes = mapping.config.slot_bytes;
+          return true;
+        }
+      }
+      owner.retry = 1024;
+      return false;
+    }
+
+    Owner& owner () {
+      thread_local Owner instance;
+      return instance;
+    }
+
+  } // namespace
+
+  std::string default_path () {
+    std::error_code ec;
+    std::filesystem::path directory;
+    if (const char* runtime_dir = std::getenv ("XDG_RUNTIME_DIR"); runtime_dir != nullptr && *runtime_dir != '\0') {
+      directory = runtime_dir;
+    } else {
+      directory = std::filesystem::temp_directory_path (ec);
+    }
+    return (directory / "omnicpp_flight.bin").string ();
+  }
+
+  bool open (const FlightRecorderConfig& requested) {
+    FlightRecorderConfig config = requested;
+    if (config.path.empty ()) {
+      config.path = default_path ();
+    }
+    config.threads = std::max<uint32_t> (config.threads, 1);
+    config.slots_per_thread = std::max<uint32_t> (config.slots_per_thread, 1);
+    config.slot_bytes = std::clamp<uint32_t> ((config.slot_bytes + 7) & ~7u, 64, 4096);
+    const std::size_t size = sizeof (FileHeader) + sizeof (RingHeader) * config.threads +
+                             static_cast<std::size_t> (config.threads) * config.slots_per_thread * config.slot_bytes;
+
+    close ();
+    std::error_code ec;
+    if (std::filesystem::exists (config.path, ec)) {
+      std::filesystem::rename (config.path, config.path + ".prev", ec); // What the last run left, possibly a crash
+    }
+    uint8_t* base = map_file (config.path, size);
+    if (base == nullptr) {
+      omnicpp::log::error ("FlightRecorder: Cannot map {}", config.path);
+      return false;
+    }
+
+    FileHeader* header = file_header (base);
+    std::memcpy (header->magic, FILE_MAGIC, sizeof (FILE_MAGIC));
+    header->version = FILE_VERSION;
+    header->threads = config.threads;
+    header->slots_per_thread = config.slots_per_thread;
+    header->slot_bytes = config.slot_bytes;
+    header->created_unix_ns = unix_ns ();
+    header->pid = process_id ();
+
+    State& s = state ();
+    std::lock_guard<std::mutex> lock (s.mutex);
+    s.current = Mapping{ base, size, config };
+    s.generation.fetch_add (1, std::memory_order_release);
+    detail::g_open.store (true, std::memory_order_release);
+    return true;
+  }
+
+  void close () {
+    State& s = state ();
+    std::lock_guard<std::mutex> lock (s.mutex);
+    detail::g_open.store (false, std::memory_order_relaxed);
+    if (s.current.base == nullptr) {
+      return;
+    }
+    s.retired.push_back (s.current);
+    s.current = Mapping{};
+    s.generation.fetch_add (1, std::memory_order_release);
+  }
+
+  bool is_open () {
+    return detail::g_open.load (std::memory_order_relaxed);
+  }
+
+  void set_thread_name (std::string_view name) {
+    Owner& self = owner ();
+    if (!claim (self)) {
+      return;
+    }
+    const std::size_t length = std::min (name.size (), sizeof (self.ring->name) - 1);
+    std::memcpy (self.ring->name, name.data (), length);
+    self.ring->name[length] = '\0';
+  }
+
+  namespace detail {
+
+    Slot begin_record () {
+      Owner& self = owner ();
+      if (!claim (self)) {
+        if (FileHeader* header = self.base != nullptr ? file_header (self.base) : nullptr) {
+          std::atomic_ref<uint64_t> (header->unrecorded).fetch_add (1, std::memory_order_relaxed);
+        }
+        return {};
+      }
+      const uint64_t n = self.ring->written;
+      auto* header = reinterpret_cast<SlotHeader*> (self.slots + (n % self.slots_per_thread) * self.slot_bytes);
+      std::atomic_ref<uint32_t> (header->seq).store (static_cast<uint32_t> (2 * n + 1), std::memory_order_relaxed);
+      std::atomic_thread_fence (std::memory_order_release); // Odd sequence lands before any payload byte
+      return { header, reinterpret_cast<uint8_t*> (header + 1), self.slot_bytes - sizeof (SlotHeader) };
+    }
+
+    void end_record (const Slot& slot, uint8_t level, uint32_t line, std::size_t arg_count, std::size_t size) {
+      Owner& self = owner ();
+      auto* header = static_cast<SlotHeader*> (slot.header);
+      header->size = static_cast<uint16_t> (size);
+      header->level = level;
+      header->arg_count = static_cast<uint8_t> (arg_count);
+      header->thread = self.thread;
+      header->line = line;
+      header->unix_ns = unix_ns ();
+      const uint64_t n = self.ring->written;
+      std::atomic_ref<uint32_t> (header->seq).store (static_cast<uint32_t> (2 * n + 2), std::memory_order_release);
+      std::atomic_ref<uint64_t> (self.ring->written).store (n + 1, std::memory_order_release);
+    }
+
+  } // namespace detail
+
+  // ==========================================================================
+  // Reader
+  // ==========================================================================
+
+  bool FlightRecorderReader::fail (const char* what) {
+    m_error = what;
+    m_events.clear ();
+    return false;
+  }
+
+  bool FlightRecorderReader::open (const std::string& path) {
+    *this = FlightRecorderReader{};
+    std::ifstream in (path, std::ios::binary);
+    if (!in) {
+      return fail ("cannot open file");
+    }
+    const std::vector<uint8_t> data{ std::istreambuf_iterator<char> (in), std::istreambuf_iterator<char> () };
+    FileHeader header{};
+    if (data.size () < sizeof (header)) {
+      return fail ("not a flight recorder file");
+    }
+    std::memcpy (&header, data.data (), sizeof (header));
+    if (std::memcmp (header.magic, FILE_MAGIC, sizeof (FILE_MAGIC)) != 0) {
+      return fail ("not a flight recorder file");
+    }
+    if (header.version != FILE_VERSION || header.slot_bytes < sizeof (SlotHeader)) {
+      return fail ("unsupported version");
+    }
+    const std::size_t slots_offset = sizeof (FileHeader) + sizeof (RingHeader) * header.threads;
+    if (data.size () < slots_offset + static_cast<std::size_t> (header.threads) * header.slots_per_thread *
+                                          header.slot_bytes) {
+      return fail ("truncated file");
+    }
+    m_pid = header.pid;
+    m_dropped = header.unrecorded;
+
+    std::map<std::tuple<std::string, std::string, uint32_t, uint8_t, std::vector<binary::ArgType>>, std::size_t> ids;
+    std::vector<std::pair<uint64_t, uint32_t>> order; // (unix_ns, seq) per event, for sorting
+    for (uint32_t r = 0; r < header.threads; ++r) {
+      RingHeader ring{};
+      std::memcpy (&ring, data.data () + sizeof (FileHeader) + sizeof (RingHeader) * r, sizeof (ring));
+      ring.name[sizeof (ring.name) - 1] = '\0';
+      m_thread_names.emplace_back (ring.name);
+
+      for (uint32_t i = 0; i < header.slots_per_thread; ++i) {
+        const uint8_t* slot =
+            data.data () + slots_offset + (static_cast<std::size_t> (r) * header.slots_per_thread + i) * header.slot_bytes;
+        SlotHeader slot_header{};
+        std::memcpy (&slot_header, slot, sizeof (slot_header));
+        if (slot_header.seq == 0) {
+          continue; // Never written
+        }
+        if ((slot_header.seq & 1) != 0 || slot_header.size > header.slot_bytes - sizeof (SlotHeader)) {
+          ++m_torn;
+          continue;
+        }
+
+        const uint8_t* cursor = slot + sizeof (SlotHeader);
+        const uint8_t* end = cursor + slot_header.size;
+        std::vector<binary::ArgType> types (slot_header.arg_count);
+        binary::DecodedEvent event;
+        std::vector<binary::Value> strings;
+        const std::vector<binary::ArgType> two_strings{ binary::ArgType::Str, binary::ArgType::Str };
+        if (static_cast<std::size_t> (end - cursor) < types.size ()) {
+          ++m_torn;
+          continue;
+        }
+        for (auto& type : types) {
+          type = static_cast<binary::ArgType> (*cursor++);
+        }
+        if (!binary::decode_args (cursor, end, two_strings, strings) ||
+            !binary::decode_args (cursor, end, types, event.args)) {
+          ++m_torn;
+          continue;
+        }
+
+        auto key = std::make_tuple (strings[0].s, strings[1].s, slot_header.line, slot_header.level, types);
+        auto [it, inserted] = ids.try_emplace (std::move (key), m_formats.size ());
+        if (inserted) {
+          binary::FormatInfo& info = m_formats.emplace_back ();
+          info.id = static_cast<uint32_t> (it->second);
+          info.level = static_cast<binary::Level> (slot_header.level);
+          info.types = std::move (types);
+          info.format = std::move (strings[0].s);
+          info.file = std::move (strings[1].s);
+          info.line = slot_header.line;
+        }
+        event.format = &m_formats[it->second];
+        event.thread = slot_header.thread;
+        if (slot_header.thread == ring.thread) {
+          event.thread_name = m_thread_names.back ();
+        }
+        event.unix_ns = slot_header.unix_ns;
+        event.ticks = static_cast<uint64_t> (slot_header.unix_ns);
+        event.seconds = static_cast<double> (slot_header.unix_ns - header.created_unix_ns) / 1e9;
+        m_events.push_back (std::move (event));
+        order.emplace_back (static_cast<uint64_t> (slot_header.unix_ns), slot_header.seq);
+      }
+    }
+
+    // Oldest first; within one thread the sequence breaks timestamp ties
+    std::vector<std::size_t> index (m_events.size ());
+    for (std::size_t i = 0; i < index.size (); ++i) {
+      index[i] = i;
+    }
+    std::stable_sort (index.begin (), index.end (), [&] (std::size_t a, std::size_t b) {
+      return std::tie (order[a].first, m_events[a].thread, order[a].second) <
+             std::tie (order[b].first, m_events[b].thread, order[b].second);
+    });
+    std::vector<binary::DecodedEvent> sorted;
+    sorted.reserve (m_events.size ());
+    for (const std::size_t i : index) {
+      sorted.push_back (std::move (m_events[i]));
+    }
+    m_events = std::move (sorted);
+    return true;
+  }
+
+  bool FlightRecorderReader::next (binary::DecodedEvent& event) {
+    if (m_next >= m_events.size ()) {
+      return false;
+    }
+    event = m_events[m_next++];
+    return true;
+  }
+
+} // namespace omnicpp::log::flight
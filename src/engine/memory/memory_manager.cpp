@@ -124,7 +124,7 @@ namespace OmniCpp::Engine::Memory {
     m_impl->stats.current_usage += size;
     m_impl->stats.allocation_count++;
 
-    omnicpp::log::trace("MemoryManager: Allocated {} bytes at {}", size, ptr);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Memory, "MemoryManager: Allocated {} bytes at {}", size, ptr);
     return ptr;
   }
 
@@ -143,13 +143,14 @@ namespace OmniCpp::Engine::Memory {
     }
 
     // Update statistics
-    m_impl->stats.total_freed += it->second.size;
-    m_impl->stats.current_usage -= it->second.size;
+    const size_t size = it->second.size;
+    m_impl->stats.total_freed += size;
+    m_impl->stats.current_usage -= size;
 
     // Remove from tracking
     m_impl->allocations.erase (it);
 
-    omnicpp::log::trace("MemoryManager: Deallocated {} bytes at {}", it->second.size, ptr);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Memory, "MemoryManager: Deallocated {} bytes at {}", size, ptr);
 
     // Free memory
     #ifdef _WIN32
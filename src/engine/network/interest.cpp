@@ -0,0 +1,203 @@
+/**
+ * @file interest.cpp
+ * @brief Interest management implementation
+ */
+
+#include "engine/network/interest.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace OmniCpp::Engine::Network {
+
+  namespace {
+
+    float distance_squared (const omnicpp::math::Vec3& a, const omnicpp::math::Vec3& b) {
+      const float dx = a.x - b.x;
+      const float dy = a.y - b.y;
+      const float dz = a.z - b.z;
+      return dx * dx + dy * dy + dz * dz;
+    }
+
+  } // namespace
+
+  SpatialGrid::SpatialGrid (float cell_size)
+      : m_cell_size (std::max (cell_size, 0.001f)), m_inverse_cell_size (1.0f / m_cell_size) {
+  }
+
+  uint64_t SpatialGrid::cell_key (int32_t x, int32_t y, int32_t z) {
+    // 21 bits per axis, offset to unsigned: +/- 1M cells
+    constexpr int32_t BIAS = 1 << 20;
+    constexpr uint64_t MASK = (1u << 21) - 1;
+    return ((static_cast<uint64_t> (x + BIAS) & MASK) << 42) | ((static_cast<uint64_t> (y + BIAS) & MASK) << 21) |
+           (static_cast<uint64_t> (z + BIAS) & MASK);
+  }
+
+  int32_t SpatialGrid::cell_coordinate (float value) const {
+    return static_cast<int32_t> (std::floor (value * m_inverse_cell_size));
+  }
+
+  void SpatialGrid::build (std::span<const ReplicatedEntity> entities) {
+    m_entities = entities;
+    m_entries.resize (entities.size ());
+    for (std::size_t i = 0; i < entities.size (); ++i) {
+      const auto& position = entities[i].position;
+      m_entries[i] = { cell_key (cell_coordinate (position.x), cell_coordinate (position.y), cell_coordinate (position.z)),
+        static_cast<uint32_t> (i) };
+    }
+    std::sort (m_entries.begin (), m_entries.end (), [] (const CellEntry& a, const CellEntry& b) {
+      return a.cell != b.cell ? a.cell < b.cell : a.index < b.index;
+    });
+  }
+
+  void SpatialGrid::query (const omnicpp::math::Vec3& center, float radius, std::vector<uint32_t>& out) const {
+    const float radius_squared = radius * radius;
+    const int32_t min_x = cell_coordinate (center.x - radius);
+    const int32_t max_x = cell_coordinate (center.x + radius);
+    const int32_t min_y = cell_coordinate (center.y - radius);
+    const int32_t max_y = cell_coordinate (center.y + radius);
+    const int32_t min_z = cell_coordinate (center.z - radius);
+    const int32_t max_z = cell_coordinate (center.z + radius);
+
+    auto by_cell = [] (const CellEntry& entry, uint64_t cell) { return entry.cell < cell; };
+    for (int32_t x = min_x; x <= max_x; ++x) {
+      for (int32_t y = min_y; y <= max_y; ++y) {
+        // Cells along z are adjacent keys, so one binary search covers the whole row
+        const uint64_t first = cell_key (x, y, min_z);
+        const uint64_t last = cell_key (x, y, max_z);
+        auto it = std::lower_bound (m_entries.begin (), m_entries.end (), first, by_cell);
+        for (; it != m_entries.end () && it->cell <= last; ++it) {
+          if (distance_squared (m_entities[it->index].position, center) <= radius_squared) {
+            out.push_back (it->index);
+          }
+        }
+      }
+    }
+  }
+
+  InterestManager::InterestManager (const InterestConfig& config) : m_config (config), m_grid (config.cell_size) {
+  }
+
+  void InterestManager::add_client (ConnectionId client, const omnicpp::math::Vec3& view_position) {
+    m_clients[client].view_position = view_position;
+  }
+
+  void InterestManager::remove_client (ConnectionId client) {
+    m_clients.erase (client);
+  }
+
+  void InterestManager::set_view (ConnectionId client, const omnicpp::math::Vec3& view_position) {
+    if (auto it = m_clients.find (client); it != m_clients.end ()) {
+      it->second.view_position = view_position;
+    }
+  }
+
+  void InterestManager::set_entities (std::span<const ReplicatedEntity> entities) {
+    m_entities = entities;
+    m_grid.build (entities);
+    m_always_relevant.clear ();
+    for (std::size_t i = 0; i < entities.size (); ++i) {
+      if (entities[i].always_relevant) {
+        m_always_relevant.push_back (static_cast<uint32_t> (i));
+      }
+    }
+  }
+
+  bool InterestManager::schedule (ConnectionId client, InterestSchedule& out) {
+    auto it = m_clients.find (client);
+    if (it == m_clients.end ()) {
+      return false;
+    }
+    ClientState& state = it->second;
+
+    out.send.clear ();
+    out.relevant.clear ();
+    out.bytes_scheduled = 0;
+    out.deferred = 0;
+
+    m_query.clear ();
+    const float radius = std::max (m_config.relevance_radius, 0.0f);
+    m_grid.query (state.view_position, radius, m_query);
+    for (uint32_t index : m_always_relevant) {
+      if (distance_squared (m_entities[index].position, state.view_position) > radius * radius) {
+        m_query.push_back (index); // Not already found by the grid
+      }
+    }
+
+    // Accumulate; entities that dropped out of relevance lose their accumulator
+    const float inverse_radius = radius > 0.0f ? 1.0f / radius : 0.0f;
+    m_candidates.clear ();
+    for (uint32_t index : m_query) {
+      const ReplicatedEntity& entity = m_entities[index];
+      const float distance = std::sqrt (distance_squared (entity.position, state.view_position));
+      const float weight = std::max (m_config.min_distance_weight, 1.0f - distance * inverse_radius);
+      auto [slot, entered] = state.accumulators.try_emplace (entity.entity_id, 0.0f);
+      slot->second += entity.priority * weight + (entered ? m_config.enter_boost : 0.0f);
+      m_candidates.push_back ({ slot->second, index });
+      out.relevant.push_back (entity.entity_id);
+    }
+    if (state.accumulators.size () > m_candidates.size ()) {
+      std::sort (out.relevant.begin (), out.relevant.end ());
+      std::erase_if (state.accumulators, [&] (const auto& entry) {
+        return !std::binary_search (out.relevant.begin (), out.relevant.end (), entry.first);
+      });
+    }
+
+    // Highest accumulator first; ties go to the lower id so schedules are reproducible
+    std::sort (m_candidates.begin (), m_candidates.end (), [&] (const Candidate& a, const Candidate& b) {
+      return a.accumulator != b.accumulator ? a.accumulator > b.accumulator
+                                            : m_entities[a.index].entity_id < m_entities[b.index].entity_id;
+    });
+    uint32_t budget = m_config.bytes_per_tick;
+    for (const Candidate& candidate : m_candidates) {
+      const ReplicatedEntity& entity = m_entities[candidate.index];
+      if (entity.size_estimate > budget) {
+        ++out.deferred; // A smaller one further down may still fit
+        continue;
+      }
+      budget -= entity.size_estimate;
+      out.bytes_scheduled += entity.size_estimate;
+      out.send.push_back (entity.entity_id);
+      state.accumulators[entity.entity_id] = 0.0f;
+    }
+    std::sort (out.relevant.begin (), out.relevant.end ());
+
+    ++m_stats.ticks;
+    m_stats.relevant += out.relevant.size ();
+    m_stats.scheduled += out.send.size ();
+    m_stats.deferred += out.deferred;
+    m_stats.bytes_scheduled += out.bytes_scheduled;
+    return true;
+  }
+
+  void build_client_snapshot (const Snapshot& world, const InterestSchedule& schedule, const Snapshot* previous,
+      Snapshot& out) {
+    out.tick = world.tick;
+    out.entities.clear ();
+
+    // Scheduled ids, sorted for lookup (the schedule keeps them in priority order)
+    thread_local std::vector<uint32_t> scheduled;
+    scheduled.assign (schedule.send.begin (), schedule.send.end ());
+    std::sort (scheduled.begin (), scheduled.end ());
+
+    auto by_id = [] (const QuantizedTransform& entity, uint32_t id) { return entity.entity_id < id; };
+    auto world_it = world.entities.begin ();
+    auto previous_it = previous ? previous->entities.begin () : world.entities.end ();
+    const auto previous_end = previous ? previous->entities.end () : world.entities.end ();
+
+    for (uint32_t id : schedule.relevant) {
+      // All three sequences are sorted by id, so the cursors only move forward
+      if (std::binary_search (scheduled.begin (), scheduled.end (), id)) {
+        world_it = std::lower_bound (world_it, world.entities.end (), id, by_id);
+        if (world_it != world.entities.end () && world_it->entity_id == id) {
+          out.entities.push_back (*world_it);
+        }
+      } else if (previous) {
+        previous_it = std::lower_bound (previous_it, previous_end, id, by_id);
+        if (previous_it != previous_end && previous_it->entity_id == id) {
+          out.entities.push_back (*previous_it); // Unchanged for this client until it is scheduled
+        }
+      }
+    }
+  }
+
+} // namespace OmniCpp::Engine::Network
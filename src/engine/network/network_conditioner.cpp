@@ -0,0 +1,192 @@
+/**
+ * @file network_conditioner.cpp
+ * @brief Network conditioner implementation
+ */
+
+#include "engine/network/network_conditioner.hpp"
+#include "engine/network/udp_socket.hpp"
+#include "engine/core/DeterministicProviders.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace OmniCpp::Engine::Network {
+
+  namespace {
+
+    struct PendingDatagram {
+      NetworkConditioner::Clock::time_point deliver_at;
+      uint64_t order{ 0 }; // Tie-break so equal deadlines keep enqueue order
+      Endpoint destination;
+      std::vector<uint8_t> data;
+    };
+
+    // Min-heap on (deliver_at, order)
+    struct LaterFirst {
+      bool operator() (const PendingDatagram& a, const PendingDatagram& b) const {
+        return a.deliver_at != b.deliver_at ? a.deliver_at > b.deliver_at : a.order > b.order;
+      }
+    };
+
+  } // namespace
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct NetworkConditioner::Impl {
+    NetworkConditionerConfig config;
+    omnicpp::core::SeededRandomProvider random{ 1 };
+    std::vector<PendingDatagram> queue;
+    std::vector<std::vector<uint8_t>> free_buffers;
+    Clock::time_point link_free_at{};     // When the bandwidth-capped link finishes its backlog
+    Clock::time_point last_in_order{};    // Latest deadline handed to a non-reordered datagram
+    uint64_t next_order{ 0 };
+    NetworkConditionerStats stats;
+
+    std::vector<uint8_t> gather_scratch;
+
+    void offer (const Endpoint& destination, std::span<const uint8_t> data, Clock::time_point now);
+    void schedule (const Endpoint& destination, std::span<const uint8_t> data, Clock::time_point departure);
+    [[nodiscard]] Clock::duration sample_delay ();
+  };
+
+  NetworkConditioner::Clock::duration NetworkConditioner::Impl::sample_delay () {
+    auto delay = std::chrono::duration_cast<Clock::duration> (config.latency);
+    if (config.jitter.count () > 0) {
+      const double offset = (random.next_double () * 2.0 - 1.0) * static_cast<double> (config.jitter.count ());
+      delay += std::chrono::duration_cast<Clock::duration> (std::chrono::duration<double, std::milli> (offset));
+    }
+    return std::max (delay, Clock::duration::zero ());
+  }
+
+  void NetworkConditioner::Impl::schedule (const Endpoint& destination, std::span<const uint8_t> data,
+      Clock::time_point departure) {
+    Clock::time_point deliver_at = departure + sample_delay ();
+    if (config.reorder > 0.0 && random.next_bool (config.reorder)) {
+      deliver_at += config.reorder_delay;
+      ++stats.reordered;
+    } else {
+      // A path delays packets differently but does not swap them
+      deliver_at = std::max (deliver_at, last_in_order);
+      last_in_order = deliver_at;
+    }
+
+    PendingDatagram pending;
+    if (!free_buffers.empty ()) {
+      pending.data = std::move (free_buffers.back ());
+      free_buffers.pop_back ();
+    }
+    pending.data.assign (data.begin (), data.end ());
+    pending.deliver_at = deliver_at;
+    pending.order = next_order++;
+    pending.destination = destination;
+    queue.push_back (std::move (pending));
+    std::push_heap (queue.begin (), queue.end (), LaterFirst {});
+  }
+
+  NetworkConditioner::NetworkConditioner (const NetworkConditionerConfig& config) : m_impl (std::make_unique<Impl> ()) {
+    configure (config);
+  }
+
+  NetworkConditioner::~NetworkConditioner () = default;
+
+  NetworkConditioner::NetworkConditioner (NetworkConditioner&& other) noexcept : m_impl (std::move (other.m_impl)) {
+  }
+
+  NetworkConditioner& NetworkConditioner::operator= (NetworkConditioner&& other) noexcept {
+    if (this != &other) {
+      m_impl = std::move (other.m_impl);
+    }
+    return *this;
+  }
+
+  void NetworkConditioner::configure (const NetworkConditionerConfig& config) {
+    m_impl->config = config;
+    m_impl->random.reseed (config.seed);
+  }
+
+  void NetworkConditioner::Impl::offer (const Endpoint& destination, std::span<const uint8_t> data, Clock::time_point now) {
+    ++stats.datagrams_offered;
+
+    if (config.loss > 0.0 && random.next_bool (config.loss)) {
+      ++stats.dropped_loss;
+      return;
+    }
+
+    Clock::time_point departure = now;
+    if (config.bandwidth > 0) {
+      // Serialize through a link of the configured rate; drop at the tail once the backlog is too long
+      const Clock::time_point start = std::max (link_free_at, now);
+      if (start - now > config.max_queue_delay) {
+        ++stats.dropped_queue;
+        return;
+      }
+      const auto transmit = std::chrono::duration_cast<Clock::duration> (
+          std::chrono::duration<double> (static_cast<double> (data.size ()) / static_cast<double> (config.bandwidth)));
+      link_free_at = start + transmit;
+      departure = link_free_at;
+    }
+
+    schedule (destination, data, departure);
+    if (config.duplicate > 0.0 && random.next_bool (config.duplicate)) {
+      schedule (destination, data, departure);
+      ++stats.duplicated;
+    }
+  }
+
+  void NetworkConditioner::enqueue (const DatagramBatch& batch, Clock::time_point now) {
+    for (std::size_t i = 0; i < batch.size (); ++i) {
+      m_impl->offer (batch.endpoint (i), batch.data (i), now);
+    }
+  }
+
+  void NetworkConditioner::enqueue (const GatherBatch& batch, Clock::time_point now) {
+    auto& scratch = m_impl->gather_scratch;
+    for (std::size_t i = 0; i < batch.size (); ++i) {
+      scratch.resize (batch.datagram_size (i));
+      batch.copy_datagram (i, scratch);
+      m_impl->offer (batch.endpoint (i), scratch, now);
+    }
+  }
+
+  std::size_t NetworkConditioner::release (Clock::time_point now, DatagramBatch& out) {
+    auto& impl = *m_impl;
+    std::size_t released = 0;
+
+    while (!impl.queue.empty () && impl.queue.front ().deliver_at <= now && !out.full ()) {
+      std::pop_heap (impl.queue.begin (), impl.queue.end (), LaterFirst {});
+      PendingDatagram& pending = impl.queue.back ();
+
+      auto slot = out.prepare (pending.destination);
+      const std::size_t length = std::min (slot.size (), pending.data.size ());
+      std::copy_n (pending.data.begin (), length, slot.begin ());
+      out.commit (length);
+
+      ++impl.stats.datagrams_delivered;
+      impl.stats.bytes_delivered += length;
+      impl.free_buffers.push_back (std::move (pending.data));
+      impl.queue.pop_back ();
+      ++released;
+    }
+    return released;
+  }
+
+  void NetworkConditioner::clear () {
+    for (auto& pending : m_impl->queue) {
+      m_impl->free_buffers.push_back (std::move (pending.data));
+    }
+    m_impl->queue.clear ();
+  }
+
+  std::size_t NetworkConditioner::get_queued_count () const {
+    return m_impl->queue.size ();
+  }
+
+  const NetworkConditionerConfig& NetworkConditioner::get_config () const {
+    return m_impl->config;
+  }
+
+  const NetworkConditionerStats& NetworkConditioner::get_stats () const {
+    return m_impl->stats;
+  }
+
+} // namespace OmniCpp::Engine::Network
@@ -4,6 +4,7 @@
  */
 
 #include "engine/network/network_manager.hpp"
+#include <charconv>
 #include <mutex>
 #include "engine/logging/Log.hpp"
 
@@ -14,10 +15,29 @@ namespace OmniCpp::Engine::Network {
    */
   struct NetworkManager::Impl {
     NetworkConfig config;
+    Transport transport;
     std::mutex mutex;
+    bool transport_open{ false };
     bool initialized{ false };
+
+    bool open_transport (uint16_t port, bool accept_connections);
   };
 
+  bool NetworkManager::Impl::open_transport (uint16_t port, bool accept_connections) {
+    if (transport_open) {
+      return true;
+    }
+    TransportConfig transport_config;
+    transport_config.port = port;
+    transport_config.accept_connections = accept_connections;
+    transport_config.max_connections = config.max_connections;
+    transport_config.mtu = config.mtu;
+    transport_config.connection_timeout = config.connection_timeout;
+    transport_config.conditioner = config.conditioner;
+    transport_open = transport.initialize (transport_config);
+    return transport_open;
+  }
+
   NetworkManager::NetworkManager () : m_impl (std::make_unique<Impl> ()) {
   }
 
@@ -58,6 +78,8 @@ namespace OmniCpp::Engine::Network {
       return;
     }
 
+    m_impl->transport.shutdown ();
+    m_impl->transport_open = false;
     m_impl->initialized = false;
 
     omnicpp::log::info("NetworkManager: Shutdown");
@@ -65,7 +87,9 @@ namespace OmniCpp::Engine::Network {
 
   void NetworkManager::update () {
     std::lock_guard<std::mutex> lock (m_impl->mutex);
-    // Update network state here
+    if (m_impl->transport_open) {
+      m_impl->transport.update ();
+    }
   }
 
   bool NetworkManager::start_server () {
@@ -77,7 +101,7 @@ namespace OmniCpp::Engine::Network {
     }
 
     omnicpp::log::info("NetworkManager: Starting server");
-    return true;
+    return m_impl->open_transport (m_impl->config.port, true);
   }
 
   bool NetworkManager::connect_to_server (const std::string& address) {
@@ -88,14 +112,71 @@ namespace OmniCpp::Engine::Network {
       return false;
     }
 
-    omnicpp::log::info("NetworkManager: Connecting to server at {}", address);
-    return true;
+    std::string host = address;
+    uint16_t port = m_impl->config.port;
+    if (const auto colon = address.rfind (':'); colon != std::string::npos) {
+      host = address.substr (0, colon);
+      const auto port_text = address.substr (colon + 1);
+      const auto [end, error] = std::from_chars (port_text.data (), port_text.data () + port_text.size (), port);
+      if (error != std::errc {} || end != port_text.data () + port_text.size ()) {
+        omnicpp::log::error("NetworkManager: Invalid port in address {}", address);
+        return false;
+      }
+    }
+
+    omnicpp::log::info("NetworkManager: Connecting to server at {}:{}", host, port);
+
+    // A server's socket can dial out too; a client binds an ephemeral port
+    if (!m_impl->open_transport (m_impl->config.is_server ? m_impl->config.port : 0, m_impl->config.is_server)) {
+      return false;
+    }
+    return m_impl->transport.connect (host, port).has_value ();
   }
 
   void NetworkManager::disconnect () {
     std::lock_guard<std::mutex> lock (m_impl->mutex);
     omnicpp::log::info("NetworkManager: Disconnecting");
-    // Disconnect here
+    for (ConnectionId connection : m_impl->transport.get_connections ()) {
+      m_impl->transport.disconnect (connection);
+    }
+  }
+
+  bool NetworkManager::send (ConnectionId connection, Channel channel, std::span<const uint8_t> data) {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    return m_impl->transport.send (connection, channel, data);
+  }
+
+  void NetworkManager::broadcast (Channel channel, std::span<const uint8_t> data) {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    for (ConnectionId connection : m_impl->transport.get_connections ()) {
+      if (m_impl->transport.is_connected (connection)) {
+        m_impl->transport.send (connection, channel, data);
+      }
+    }
+  }
+
+  bool NetworkManager::poll_message (Message& out) {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    return m_impl->transport.poll_message (out);
+  }
+
+  bool NetworkManager::poll_event (TransportEvent& out) {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    return m_impl->transport.poll_event (out);
+  }
+
+  bool NetworkManager::is_connected () const {
+    std::lock_guard<std::mutex> lock (m_impl->mutex);
+    for (ConnectionId connection : m_impl->transport.get_connections ()) {
+      if (m_impl->transport.is_connected (connection)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Transport& NetworkManager::get_transport () {
+    return m_impl->transport;
   }
 
 } // namespace OmniCpp::Engine::Network
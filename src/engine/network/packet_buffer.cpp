@@ -0,0 +1,160 @@
+/**
+ * @file packet_buffer.cpp
+ * @brief Packet buffer pool implementation
+ */
+
+#include "engine/network/packet_buffer.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace OmniCpp::Engine::Network {
+
+  namespace detail {
+
+    /**
+     * @brief Pool internals, shared by the pool and its outstanding blocks
+     */
+    struct PacketPoolState {
+      std::size_t buffer_size{ 0 };
+      std::size_t headroom{ 0 };
+      std::size_t buffers_per_slab{ 0 };
+      std::vector<std::unique_ptr<PacketBlock[]>> block_slabs;
+      std::vector<std::unique_ptr<uint8_t[]>> byte_slabs;
+      PacketBlock* free_list{ nullptr };
+      PacketPoolStats stats;
+      bool pool_alive{ true };
+
+      [[nodiscard]] uint32_t block_capacity () const { return static_cast<uint32_t> (headroom + buffer_size); }
+
+      void grow () {
+        const std::size_t capacity = block_capacity ();
+        auto blocks = std::make_unique<PacketBlock[]> (buffers_per_slab);
+        auto bytes = std::make_unique<uint8_t[]> (buffers_per_slab * capacity);
+        for (std::size_t i = 0; i < buffers_per_slab; ++i) {
+          PacketBlock& block = blocks[i];
+          block.pool = this;
+          block.bytes = bytes.get () + i * capacity;
+          block.capacity = static_cast<uint32_t> (capacity);
+          block.next_free = free_list;
+          free_list = &block;
+        }
+        block_slabs.push_back (std::move (blocks));
+        byte_slabs.push_back (std::move (bytes));
+        ++stats.slabs_allocated;
+        stats.buffers_free += buffers_per_slab;
+      }
+
+      PacketBlock* take () {
+        if (!free_list) {
+          grow ();
+        }
+        PacketBlock* block = free_list;
+        free_list = block->next_free;
+        block->next_free = nullptr;
+        block->refs = 1;
+        --stats.buffers_free;
+        ++stats.buffers_in_use;
+        ++stats.buffers_acquired;
+        return block;
+      }
+    };
+
+    void release_block (PacketBlock* block) noexcept {
+      if (--block->refs > 0) {
+        return;
+      }
+
+      PacketPoolState* pool = block->pool;
+      if (block->capacity > pool->block_capacity ()) {
+        // Oversize one-off
+        delete[] block->bytes;
+        delete block;
+      } else {
+        block->next_free = pool->free_list;
+        pool->free_list = block;
+        ++pool->stats.buffers_free;
+      }
+      --pool->stats.buffers_in_use;
+
+      if (!pool->pool_alive && pool->stats.buffers_in_use == 0) {
+        delete pool;
+      }
+    }
+
+  } // namespace detail
+
+  PacketPool::PacketPool (std::size_t buffer_size, std::size_t headroom, std::size_t buffers_per_slab)
+      : m_state (new detail::PacketPoolState ()) {
+    m_state->buffer_size = std::max<std::size_t> (buffer_size, 1);
+    m_state->headroom = headroom;
+    m_state->buffers_per_slab = std::max<std::size_t> (buffers_per_slab, 1);
+  }
+
+  PacketPool::~PacketPool () {
+    if (!m_state) {
+      return;
+    }
+    // Outstanding buffers keep the slabs alive; the last release frees them
+    m_state->pool_alive = false;
+    if (m_state->stats.buffers_in_use == 0) {
+      delete m_state;
+    }
+  }
+
+  PacketPool::PacketPool (PacketPool&& other) noexcept : m_state (other.m_state) {
+    other.m_state = nullptr;
+  }
+
+  PacketPool& PacketPool::operator= (PacketPool&& other) noexcept {
+    if (this != &other) {
+      PacketPool old (std::move (*this));
+      m_state = other.m_state;
+      other.m_state = nullptr;
+    }
+    return *this;
+  }
+
+  PacketBuffer PacketPool::acquire () {
+    return PacketBuffer (m_state->take (), static_cast<uint32_t> (m_state->headroom));
+  }
+
+  PacketBuffer PacketPool::acquire (std::size_t size) {
+    if (size <= m_state->buffer_size) {
+      return acquire ();
+    }
+
+    auto* block = new detail::PacketBlock ();
+    block->pool = m_state;
+    block->capacity = static_cast<uint32_t> (m_state->headroom + size);
+    block->bytes = new uint8_t[block->capacity];
+    block->refs = 1;
+    ++m_state->stats.buffers_in_use;
+    ++m_state->stats.oversize_acquired;
+    return PacketBuffer (block, static_cast<uint32_t> (m_state->headroom));
+  }
+
+  PacketBuffer PacketPool::copy (std::span<const uint8_t> bytes) {
+    PacketBuffer buffer = acquire (bytes.size ());
+    buffer.append (bytes);
+    return buffer;
+  }
+
+  void PacketPool::reserve (std::size_t count) {
+    while (m_state->stats.buffers_free < count) {
+      m_state->grow ();
+    }
+  }
+
+  std::size_t PacketPool::buffer_size () const {
+    return m_state->buffer_size;
+  }
+
+  std::size_t PacketPool::headroom () const {
+    return m_state->headroom;
+  }
+
+  PacketPoolStats PacketPool::get_stats () const {
+    return m_state->stats;
+  }
+
+} // namespace OmniCpp::Engine::Network
@@ -0,0 +1,800 @@
+/**
+ * @file server_loop.cpp
+ * @brief Sharded io_uring/epoll datagram loop implementation
+ */
+
+#include "engine/network/server_loop.hpp"
+#include <algorithm>
+#include <array>
+#include <asio/ip/address.hpp>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <latch>
+#include <thread>
+#include "engine/logging/Log.hpp"
+
+#if defined(__linux__)
+  #include <linux/filter.h>
+  #include <linux/io_uring.h>
+  #include <netinet/in.h>
+  #include <pthread.h>
+  #include <sched.h>
+  #include <sys/epoll.h>
+  #include <sys/eventfd.h>
+  #include <sys/mman.h>
+  #include <sys/socket.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+  #define OMNICPP_HAS_SERVER_LOOP 1
+  #if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+    #define OMNICPP_HAS_IO_URING 1
+  #endif
+#endif
+
+namespace OmniCpp::Engine::Network {
+
+  const char* to_string (ServerBackend backend) {
+    switch (backend) {
+      case ServerBackend::Auto:
+        return "auto";
+      case ServerBackend::IoUring:
+        return "io_uring";
+      case ServerBackend::Epoll:
+        return "epoll";
+    }
+    return "unknown";
+  }
+
+  namespace {
+
+    // Written only by the shard thread, read by anyone
+    struct AtomicShardStats {
+      std::atomic<uint64_t> datagrams_received{ 0 };
+      std::atomic<uint64_t> bytes_received{ 0 };
+      std::atomic<uint64_t> datagrams_sent{ 0 };
+      std::atomic<uint64_t> send_failures{ 0 };
+      std::atomic<uint64_t> wakeups{ 0 };
+      std::atomic<uint64_t> buffers_exhausted{ 0 };
+
+      [[nodiscard]] ServerShardStats snapshot () const {
+        ServerShardStats stats;
+        stats.datagrams_received = datagrams_received.load (std::memory_order_relaxed);
+        stats.bytes_received = bytes_received.load (std::memory_order_relaxed);
+        stats.datagrams_sent = datagrams_sent.load (std::memory_order_relaxed);
+        stats.send_failures = send_failures.load (std::memory_order_relaxed);
+        stats.wakeups = wakeups.load (std::memory_order_relaxed);
+        stats.buffers_exhausted = buffers_exhausted.load (std::memory_order_relaxed);
+        return stats;
+      }
+    };
+
+    // Single writer: a plain load/store pair avoids a locked read-modify-write
+    void bump (std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+      counter.store (counter.load (std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+#ifdef OMNICPP_HAS_IO_URING
+    constexpr uint64_t RECEIVE_TAG = 1;
+    constexpr uint64_t WAKE_TAG = 2;
+    constexpr uint16_t BUFFER_GROUP = 0;
+    constexpr unsigned RING_ENTRIES = 256;
+
+    /**
+     * @brief Bare io_uring: one submission/completion ring pair plus a
+     * provided-buffer ring that multishot receives draw from
+     */
+    class IoUring {
+    public:
+      IoUring () = default;
+      ~IoUring () { close (); }
+
+      IoUring (const IoUring&) = delete;
+      IoUring& operator= (const IoUring&) = delete;
+
+      bool open (std::size_t buffer_count, std::size_t buffer_size) {
+        io_uring_params params {};
+        params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+        m_fd = static_cast<int> (::syscall (__NR_io_uring_setup, RING_ENTRIES, &params));
+        if (m_fd < 0 && errno == EINVAL) {
+          params = {}; // Kernel older than 6.1
+          m_fd = static_cast<int> (::syscall (__NR_io_uring_setup, RING_ENTRIES, &params));
+        }
+        if (m_fd < 0 || !(params.features & IORING_FEAT_SINGLE_MMAP)) {
+          return false;
+        }
+
+        m_ring_size = std::max (params.sq_off.array + params.sq_entries * sizeof (unsigned),
+            params.cq_off.cqes + params.cq_entries * sizeof (io_uring_cqe));
+        m_ring = ::mmap (nullptr, m_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+        m_sqes_size = params.sq_entries * sizeof (io_uring_sqe);
+        void* sqes = ::mmap (nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+        if (m_ring == MAP_FAILED || sqes == MAP_FAILED) {
+          m_ring = m_ring == MAP_FAILED ? nullptr : m_ring;
+          m_sqes = sqes == MAP_FAILED ? nullptr : static_cast<io_uring_sqe*> (sqes);
+          return false;
+        }
+        m_sqes = static_cast<io_uring_sqe*> (sqes);
+
+        auto* base = static_cast<uint8_t*> (m_ring);
+        m_sq_head = reinterpret_cast<unsigned*> (base + params.sq_off.head);
+        m_sq_tail = reinterpret_cast<unsigned*> (base + params.sq_off.tail);
+        m_sq_mask = *reinterpret_cast<unsigned*> (base + params.sq_off.ring_mask);
+        m_sq_array = reinterpret_cast<unsigned*> (base + params.sq_off.array);
+        m_sq_entries = params.sq_entries;
+        m_cq_head = reinterpret_cast<unsigned*> (base + params.cq_off.head);
+        m_cq_tail = reinterpret_cast<unsigned*> (base + params.cq_off.tail);
+        m_cq_mask = *reinterpret_cast<unsigned*> (base + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe*> (base + params.cq_off.cqes);
+        m_local_tail = *m_sq_tail;
+
+        return register_buffers (buffer_count, buffer_size);
+      }
+
+      void close () {
+        if (m_buffer_ring) {
+          ::munmap (m_buffer_ring, m_buffer_ring_size);
+          m_buffer_ring = nullptr;
+        }
+        if (m_sqes) {
+          ::munmap (m_sqes, m_sqes_size);
+          m_sqes = nullptr;
+        }
+        if (m_ring) {
+          ::munmap (m_ring, m_ring_size);
+          m_ring = nullptr;
+        }
+        if (m_fd >= 0) {
+          ::close (m_fd);
+          m_fd = -1;
+        }
+      }
+
+      // Zeroed submission slot, or nullptr if the ring is full
+      io_uring_sqe* next_sqe () {
+        const unsigned head = std::atomic_ref<unsigned> (*m_sq_head).load (std::memory_order_acquire);
+        if (m_local_tail - head >= m_sq_entries) {
+          return nullptr;
+        }
+        const unsigned index = m_local_tail & m_sq_mask;
+        io_uring_sqe* sqe = &m_sqes[index];
+        std::memset (sqe, 0, sizeof (*sqe));
+        m_sq_array[index] = index;
+        ++m_local_tail;
+        ++m_pending;
+        return sqe;
+      }
+
+      // Submits pending entries and blocks until at least `wait` completions are ready
+      int submit_and_wait (unsigned wait) {
+        std::atomic_ref<unsigned> (*m_sq_tail).store (m_local_tail, std::memory_order_release);
+        const int result = static_cast<int> (::syscall (__NR_io_uring_enter, m_fd, m_pending, wait,
+            wait > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0));
+        if (result >= 0) {
+          m_pending -= std::min<unsigned> (m_pending, static_cast<unsigned> (result));
+          return result;
+        }
+        return -errno;
+      }
+
+      template<typename Function>
+      void for_each_completion (Function&& function) {
+        unsigned head = *m_cq_head;
+        const unsigned tail = std::atomic_ref<unsigned> (*m_cq_tail).load (std::memory_order_acquire);
+        for (; head != tail; ++head) {
+          function (m_cqes[head & m_cq_mask]);
+        }
+        std::atomic_ref<unsigned> (*m_cq_head).store (head, std::memory_order_release);
+      }
+
+      [[nodiscard]] uint8_t* buffer (uint16_t id) { return m_buffers.data () + static_cast<std::size_t> (id) * m_buffer_size; }
+      [[nodiscard]] std::size_t buffer_size () const { return m_buffer_size; }
+
+      // Hand a buffer back to the kernel; visible after publish_buffers()
+      void recycle_buffer (uint16_t id) {
+        io_uring_buf& slot = m_buffer_ring[m_buffer_tail & m_buffer_mask];
+        slot.addr = reinterpret_cast<uint64_t> (buffer (id));
+        slot.len = static_cast<uint32_t> (m_buffer_size);
+        slot.bid = id;
+        ++m_buffer_tail;
+      }
+
+      void publish_buffers () {
+        // The ring's tail overlays the reserved field of its first entry
+        std::atomic_ref<uint16_t> (m_buffer_ring[0].resv).store (m_buffer_tail, std::memory_order_release);
+      }
+
+    private:
+      bool register_buffers (std::size_t buffer_count, std::size_t buffer_size) {
+        const auto entries = static_cast<uint32_t> (std::bit_ceil (std::clamp<std::size_t> (buffer_count, 1, 32768)));
+        m_buffer_ring_size = entries * sizeof (io_uring_buf);
+        void* ring = ::mmap (nullptr, m_buffer_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ring == MAP_FAILED) {
+          return false;
+        }
+        m_buffer_ring = static_cast<io_uring_buf*> (ring);
+        m_buffer_mask = static_cast<uint16_t> (entries - 1);
+        m_buffer_size = buffer_size;
+        m_buffers.assign (static_cast<std::size_t> (entries) * buffer_size, 0);
+
+        io_uring_buf_reg registration {};
+        registration.ring_addr = reinterpret_cast<uint64_t> (ring);
+        registration.ring_entries = entries;
+        registration.bgid = BUFFER_GROUP;
+        if (::syscall (__NR_io_uring_register, m_fd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+          return false; // Kernel older than 5.19
+        }
+        for (uint32_t id = 0; id < entries; ++id) {
+          recycle_buffer (static_cast<uint16_t> (id));
+        }
+        publish_buffers ();
+        return true;
+      }
+
+      int m_fd{ -1 };
+      void* m_ring{ nullptr };
+      std::size_t m_ring_size{ 0 };
+      io_uring_sqe* m_sqes{ nullptr };
+      std::size_t m_sqes_size{ 0 };
+      unsigned* m_sq_head{ nullptr };
+      unsigned* m_sq_tail{ nullptr };
+      unsigned* m_sq_array{ nullptr };
+      unsigned m_sq_mask{ 0 };
+      unsigned m_sq_entries{ 0 };
+      unsigned m_local_tail{ 0 };
+      unsigned m_pending{ 0 };
+      unsigned* m_cq_head{ nullptr };
+      unsigned* m_cq_tail{ nullptr };
+      unsigned m_cq_mask{ 0 };
+      io_uring_cqe* m_cqes{ nullptr };
+
+      io_uring_buf* m_buffer_ring{ nullptr };
+      std::size_t m_buffer_ring_size{ 0 };
+      uint16_t m_buffer_mask{ 0 };
+      uint16_t m_buffer_tail{ 0 };
+      std::size_t m_buffer_size{ 0 };
+      std::vector<uint8_t> m_buffers;
+    };
+#endif
+
+  } // namespace
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct ServerShard::Impl {
+    std::size_t index{ 0 };
+    const ServerLoopConfig* config{ nullptr };
+    const DatagramHandler* handler{ nullptr };
+    ServerShard* self{ nullptr };
+    std::atomic<ServerBackend> backend{ ServerBackend::Epoll };
+    std::atomic<bool> stopping{ false };
+    AtomicShardStats stats;
+    std::thread thread;
+
+#ifdef OMNICPP_HAS_SERVER_LOOP
+    int fd{ -1 };
+    int wake_fd{ -1 };
+    DatagramBatch send_batch;
+    std::vector<mmsghdr> send_headers;
+    std::vector<iovec> send_vectors;
+
+    Impl (std::size_t shard_index, const ServerLoopConfig& loop_config)
+        : index (shard_index), config (&loop_config), send_batch (loop_config.batch_size, loop_config.buffer_size),
+          send_headers (send_batch.capacity ()), send_vectors (send_batch.capacity ()) {
+    }
+
+    ~Impl () {
+      if (fd >= 0) {
+        ::close (fd);
+      }
+      if (wake_fd >= 0) {
+        ::close (wake_fd);
+      }
+    }
+
+    void run (std::latch& ready);
+    bool run_io_uring (std::latch*& ready);
+    void run_epoll (std::latch*& ready);
+    void deliver (const void* name, std::size_t name_length, std::span<const uint8_t> data);
+    void flush ();
+    void pin_to_cpu () const;
+#else
+    Impl (std::size_t shard_index, const ServerLoopConfig& loop_config) : index (shard_index), config (&loop_config) {
+    }
+#endif
+  };
+
+  ServerShard::ServerShard (std::unique_ptr<Impl> impl) : m_impl (std::move (impl)) {
+    m_impl->self = this;
+  }
+
+  ServerShard::~ServerShard () = default;
+
+  std::size_t ServerShard::index () const {
+    return m_impl->index;
+  }
+
+  ServerBackend ServerShard::backend () const {
+    return m_impl->backend.load (std::memory_order_relaxed);
+  }
+
+#ifdef OMNICPP_HAS_SERVER_LOOP
+  bool ServerShard::send (const Endpoint& destination, std::span<const uint8_t> data) {
+    auto& batch = m_impl->send_batch;
+    if (data.size () > batch.max_datagram_size ()) {
+      return false;
+    }
+    if (batch.full ()) {
+      m_impl->flush ();
+    }
+    auto slot = batch.prepare (destination);
+    std::copy (data.begin (), data.end (), slot.begin ());
+    batch.commit (data.size ());
+    return true;
+  }
+
+  void ServerShard::Impl::flush () {
+    const std::size_t count = send_batch.size ();
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto payload = send_batch.data (i);
+      const Endpoint& endpoint = send_batch.endpoint (i);
+      send_vectors[i] = { const_cast<uint8_t*> (payload.data ()), payload.size () };
+      send_headers[i] = {};
+      send_headers[i].msg_hdr.msg_name = const_cast<sockaddr*> (endpoint.data ());
+      send_headers[i].msg_hdr.msg_namelen = static_cast<socklen_t> (endpoint.size ());
+      send_headers[i].msg_hdr.msg_iov = &send_vectors[i];
+      send_headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    std::size_t sent = 0;
+    while (sent < count) {
+      const int result = ::sendmmsg (fd, send_headers.data () + sent, static_cast<unsigned int> (count - sent), MSG_DONTWAIT);
+      if (result > 0) {
+        sent += static_cast<std::size_t> (result);
+        continue;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      // A full kernel buffer drops the rest like any lost datagram; other errors skip one
+      const std::size_t dropped = (errno == EAGAIN) ? count - sent : 1; // EAGAIN == EWOULDBLOCK on Linux
+      bump (stats.send_failures, dropped);
+      sent += dropped;
+    }
+    bump (stats.datagrams_sent, count);
+    send_batch.clear ();
+  }
+
+  void ServerShard::Impl::deliver (const void* name, std::size_t name_length, std::span<const uint8_t> data) {
+    Endpoint from;
+    if (name_length > from.capacity ()) {
+      return;
+    }
+    std::memcpy (from.data (), name, name_length);
+    from.resize (name_length);
+    bump (stats.datagrams_received);
+    bump (stats.bytes_received, data.size ());
+    (*handler) (*self, from, data);
+  }
+
+  void ServerShard::Impl::pin_to_cpu () const {
+    cpu_set_t allowed;
+    CPU_ZERO (&allowed);
+    if (::sched_getaffinity (0, sizeof (allowed), &allowed) != 0 || CPU_COUNT (&allowed) == 0) {
+      return;
+    }
+    // i-th allowed CPU, wrapping
+    std::size_t target = index % static_cast<std::size_t> (CPU_COUNT (&allowed));
+    for (std::size_t cpu = 0; cpu < static_cast<std::size_t> (CPU_SETSIZE); ++cpu) {
+      if (CPU_ISSET (cpu, &allowed) && target-- == 0) {
+        cpu_set_t pinned;
+        CPU_ZERO (&pinned);
+        CPU_SET (cpu, &pinned);
+        ::pthread_setaffinity_np (::pthread_self (), sizeof (pinned), &pinned);
+        return;
+      }
+    }
+  }
+
+  void ServerShard::Impl::run (std::latch& ready) {
+    if (config->pin_threads) {
+      pin_to_cpu ();
+    }
+    std::latch* pending_ready = &ready;
+#ifdef OMNICPP_HAS_IO_URING
+    if (config->backend != ServerBackend::Epoll && run_io_uring (pending_ready)) {
+      return;
+    }
+#endif
+    run_epoll (pending_ready);
+  }
+
+  #ifdef OMNICPP_HAS_IO_URING
+  bool ServerShard::Impl::run_io_uring (std::latch*& ready) {
+    IoUring ring;
+    if (!ring.open (config->buffer_count, config->buffer_size)) {
+      if (index == 0) {
+        omnicpp::log::warn ("ServerLoop: io_uring with provided buffers unavailable, using epoll");
+      }
+      return false;
+    }
+
+    // Multishot recvmsg lays each buffer out as header, name, payload
+    msghdr receive_template {};
+    receive_template.msg_namelen = sizeof (sockaddr_in6);
+    const std::size_t payload_offset = sizeof (io_uring_recvmsg_out) + receive_template.msg_namelen;
+    uint64_t wake_value = 0;
+
+    auto arm_receive = [&] () {
+      io_uring_sqe* sqe = ring.next_sqe ();
+      sqe->opcode = IORING_OP_RECVMSG;
+      sqe->fd = fd;
+      sqe->addr = reinterpret_cast<uint64_t> (&receive_template);
+      sqe->len = 1;
+      sqe->flags = IOSQE_BUFFER_SELECT;
+      sqe->buf_group = BUFFER_GROUP;
+      sqe->ioprio = IORING_RECV_MULTISHOT;
+      sqe->user_data = RECEIVE_TAG;
+    };
+    auto arm_wake = [&] () {
+      io_uring_sqe* sqe = ring.next_sqe ();
+      sqe->opcode = IORING_OP_READ;
+      sqe->fd = wake_fd;
+      sqe->addr = reinterpret_cast<uint64_t> (&wake_value);
+      sqe->len = sizeof (wake_value);
+      sqe->user_data = WAKE_TAG;
+    };
+
+    arm_receive ();
+    arm_wake ();
+    backend.store (ServerBackend::IoUring, std::memory_order_relaxed);
+    bool received_any = false;
+
+    while (!stopping.load (std::memory_order_acquire)) {
+      if (ready) {
+        ring.submit_and_wait (0);
+        ready->count_down ();
+        ready = nullptr;
+      }
+      const int result = ring.submit_and_wait (1);
+      if (result < 0 && result != -EINTR && result != -EAGAIN && result != -EBUSY) {
+        omnicpp::log::error ("ServerLoop: Shard {} io_uring_enter failed: {}", index, std::strerror (-result));
+        break;
+      }
+      bump (stats.wakeups);
+
+      bool rearm_receive = false;
+      bool rearm_wake = false;
+      bool unsupported = false;
+      ring.for_each_completion ([&] (const io_uring_cqe& cqe) {
+        if (cqe.user_data == WAKE_TAG) {
+          rearm_wake = true;
+          return;
+        }
+        const bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+        rearm_receive = rearm_receive || !more;
+        if (cqe.res < 0) {
+          if (!received_any && (cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP)) {
+            unsupported = true; // Multishot recvmsg needs Linux 6.0
+          } else if (cqe.res == -ENOBUFS) {
+            bump (stats.buffers_exhausted);
+          }
+          return;
+        }
+        if (!(cqe.flags & IORING_CQE_F_BUFFER)) {
+          return;
+        }
+        received_any = true;
+        const auto id = static_cast<uint16_t> (cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        const uint8_t* buffer = ring.buffer (id);
+        io_uring_recvmsg_out header;
+        std::memcpy (&header, buffer, sizeof (header));
+        const auto length = static_cast<std::size_t> (cqe.res);
+        const std::size_t available = length - std::min (payload_offset, length);
+        deliver (buffer + sizeof (io_uring_recvmsg_out), std::min<std::size_t> (header.namelen, receive_template.msg_namelen),
+            { buffer + payload_offset, std::min<std::size_t> (header.payloadlen, available) });
+        ring.recycle_buffer (id);
+      });
+      ring.publish_buffers ();
+      flush ();
+
+      if (unsupported) {
+        omnicpp::log::warn ("ServerLoop: Shard {} kernel lacks multishot recvmsg, using epoll", index);
+        return false;
+      }
+      if (rearm_receive) {
+        arm_receive ();
+      }
+      if (rearm_wake) {
+        arm_wake ();
+      }
+    }
+    return true;
+  }
+  #endif
+
+  void ServerShard::Impl::run_epoll (std::latch*& ready) {
+    backend.store (ServerBackend::Epoll, std::memory_order_relaxed);
+    const int epoll_fd = ::epoll_create1 (EPOLL_CLOEXEC);
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    ::epoll_ctl (epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    event.data.fd = wake_fd;
+    ::epoll_ctl (epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+    DatagramBatch batch (config->batch_size, config->buffer_size);
+    std::vector<mmsghdr> headers (batch.capacity ());
+    std::vector<iovec> vectors (batch.capacity ());
+    if (ready) {
+      ready->count_down ();
+      ready = nullptr;
+    }
+
+    while (!stopping.load (std::memory_order_acquire)) {
+      std::array<epoll_event, 2> events;
+      const int count = ::epoll_wait (epoll_fd, events.data (), static_cast<int> (events.size ()), -1);
+      if (count < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        omnicpp::log::error ("ServerLoop: Shard {} epoll_wait failed: {}", index, std::strerror (errno));
+        break;
+      }
+      bump (stats.wakeups);
+      for (std::size_t i = 0; i < static_cast<std::size_t> (count); ++i) {
+        if (events[i].data.fd == wake_fd) {
+          uint64_t value = 0;
+          [[maybe_unused]] const auto drained = ::read (wake_fd, &value, sizeof (value));
+        }
+      }
+
+      // Level-triggered: drain what is there now, the next wait catches the rest
+      while (true) {
+        for (std::size_t i = 0; i < batch.capacity (); ++i) {
+          Endpoint& endpoint = batch.slot_endpoint (i);
+          vectors[i] = { batch.slot (i), batch.max_datagram_size () };
+          headers[i] = {};
+          headers[i].msg_hdr.msg_name = endpoint.data ();
+          headers[i].msg_hdr.msg_namelen = static_cast<socklen_t> (endpoint.capacity ());
+          headers[i].msg_hdr.msg_iov = &vectors[i];
+          headers[i].msg_hdr.msg_iovlen = 1;
+        }
+        const int received = ::recvmmsg (fd, headers.data (), static_cast<unsigned int> (batch.capacity ()), MSG_DONTWAIT, nullptr);
+        if (received <= 0) {
+          break;
+        }
+        const auto datagrams = static_cast<std::size_t> (received);
+        for (std::size_t i = 0; i < datagrams; ++i) {
+          const Endpoint& endpoint = batch.slot_endpoint (i);
+          deliver (endpoint.data (), headers[i].msg_hdr.msg_namelen, { batch.slot (i), headers[i].msg_len });
+        }
+        flush ();
+        if (datagrams < batch.capacity ()) {
+          break;
+        }
+      }
+    }
+    ::close (epoll_fd);
+  }
+#else
+  bool ServerShard::send (const Endpoint&, std::span<const uint8_t>) {
+    return false;
+  }
+#endif
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct ServerLoop::Impl {
+    ServerLoopConfig config;
+    DatagramHandler handler;
+    std::vector<std::unique_ptr<ServerShard>> shards;
+    uint16_t port{ 0 };
+    bool running{ false };
+
+    bool open_sockets ();
+    void close_shards ();
+  };
+
+#ifdef OMNICPP_HAS_SERVER_LOOP
+  bool ServerLoop::Impl::open_sockets () {
+    asio::error_code error;
+    const auto address = asio::ip::make_address (config.bind_address, error);
+    if (error) {
+      omnicpp::log::error ("ServerLoop: Invalid bind address '{}': {}", config.bind_address, error.message ());
+      return false;
+    }
+
+    Endpoint endpoint (address, config.port);
+    for (auto& shard : shards) {
+      auto& impl = *shard->m_impl;
+      impl.fd = ::socket (endpoint.protocol ().family (), SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      impl.wake_fd = ::eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+      const int enable = 1;
+      const int buffer_size = static_cast<int> (config.socket_buffer_size);
+      if (impl.fd < 0 || impl.wake_fd < 0 ||
+          ::setsockopt (impl.fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof (enable)) != 0) {
+        omnicpp::log::error ("ServerLoop: Failed to create shard {} socket: {}", impl.index, std::strerror (errno));
+        return false;
+      }
+      if (buffer_size > 0) {
+        ::setsockopt (impl.fd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof (buffer_size));
+        ::setsockopt (impl.fd, SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof (buffer_size));
+      }
+      if (::bind (impl.fd, endpoint.data (), static_cast<socklen_t> (endpoint.size ())) != 0) {
+        omnicpp::log::error ("ServerLoop: Failed to bind shard {} to {}:{}: {}", impl.index, config.bind_address,
+            endpoint.port (), std::strerror (errno));
+        return false;
+      }
+      if (endpoint.port () == 0) {
+        // Ephemeral port: the remaining shards join the one the kernel picked
+        socklen_t length = static_cast<socklen_t> (endpoint.capacity ());
+        ::getsockname (impl.fd, endpoint.data (), &length);
+        endpoint.resize (length);
+      }
+    }
+    port = endpoint.port ();
+
+    if (config.steer_by_cpu) {
+      // Index into the reuseport group = receiving CPU modulo shard count (sockets join in bind order)
+      std::array<sock_filter, 3> code { {
+          { BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t> (SKF_AD_OFF + SKF_AD_CPU) },
+          { BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t> (shards.size ()) },
+          { BPF_RET | BPF_A, 0, 0, 0 },
+      } };
+      sock_fprog program { static_cast<unsigned short> (code.size ()), code.data () };
+      if (::setsockopt (shards.front ()->m_impl->fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof (program)) != 0) {
+        omnicpp::log::warn ("ServerLoop: CPU steering unavailable ({}), using the reuseport hash", std::strerror (errno));
+      }
+    }
+    return true;
+  }
+#else
+  bool ServerLoop::Impl::open_sockets () {
+    omnicpp::log::error ("ServerLoop: Only supported on Linux");
+    return false;
+  }
+#endif
+
+  void ServerLoop::Impl::close_shards () {
+    for (auto& shard : shards) {
+      shard->m_impl->stopping.store (true, std::memory_order_release);
+#ifdef OMNICPP_HAS_SERVER_LOOP
+      if (shard->m_impl->wake_fd >= 0) {
+        const uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write (shard->m_impl->wake_fd, &one, sizeof (one));
+      }
+#endif
+    }
+    // Shards stay (socketless) until the next start so their counters remain readable
+    for (auto& shard : shards) {
+      if (shard->m_impl->thread.joinable ()) {
+        shard->m_impl->thread.join ();
+      }
+#ifdef OMNICPP_HAS_SERVER_LOOP
+      for (int* descriptor : { &shard->m_impl->fd, &shard->m_impl->wake_fd }) {
+        if (*descriptor >= 0) {
+          ::close (*descriptor);
+          *descriptor = -1;
+        }
+      }
+#endif
+    }
+  }
+
+  ServerLoop::ServerLoop () : m_impl (std::make_unique<Impl> ()) {
+  }
+
+  ServerLoop::~ServerLoop () {
+    if (m_impl) {
+      stop ();
+    }
+  }
+
+  ServerLoop::ServerLoop (ServerLoop&& other) noexcept : m_impl (std::move (other.m_impl)) {
+  }
+
+  ServerLoop& ServerLoop::operator= (ServerLoop&& other) noexcept {
+    if (this != &other) {
+      if (m_impl) {
+        stop ();
+      }
+      m_impl = std::move (other.m_impl);
+    }
+    return *this;
+  }
+
+  bool ServerLoop::start (const ServerLoopConfig& config, DatagramHandler handler) {
+    if (m_impl->running) {
+      omnicpp::log::warn ("ServerLoop: Already running");
+      return true;
+    }
+    if (!handler) {
+      omnicpp::log::error ("ServerLoop: A datagram handler is required");
+      return false;
+    }
+
+    m_impl->config = config;
+    if (m_impl->config.shard_count == 0) {
+      m_impl->config.shard_count = std::max (1u, std::thread::hardware_concurrency ());
+    }
+    m_impl->config.batch_size = std::max<std::size_t> (m_impl->config.batch_size, 1);
+    m_impl->handler = std::move (handler);
+
+    m_impl->shards.clear ();
+    for (std::size_t i = 0; i < m_impl->config.shard_count; ++i) {
+      auto impl = std::make_unique<ServerShard::Impl> (i, m_impl->config);
+      impl->handler = &m_impl->handler;
+      m_impl->shards.push_back (std::unique_ptr<ServerShard> (new ServerShard (std::move (impl))));
+    }
+    if (!m_impl->open_sockets ()) {
+      m_impl->shards.clear ();
+      return false;
+    }
+
+#ifdef OMNICPP_HAS_SERVER_LOOP
+    std::latch ready (static_cast<std::ptrdiff_t> (m_impl->shards.size ()));
+    for (auto& shard : m_impl->shards) {
+      ServerShard::Impl* impl = shard->m_impl.get ();
+      impl->thread = std::thread ([impl, &ready] () { impl->run (ready); });
+    }
+    ready.wait ();
+#endif
+    m_impl->running = true;
+
+    omnicpp::log::info ("ServerLoop: Listening on port {} with {} shard(s) on {}{}", m_impl->port, m_impl->shards.size (),
+        to_string (get_backend ()), m_impl->config.steer_by_cpu ? ", steered by CPU" : "");
+    return true;
+  }
+
+  void ServerLoop::stop () {
+    if (!m_impl->running) {
+      return;
+    }
+    m_impl->close_shards ();
+    m_impl->running = false;
+    omnicpp::log::info ("ServerLoop: Stopped");
+  }
+
+  bool ServerLoop::is_running () const {
+    return m_impl->running;
+  }
+
+  uint16_t ServerLoop::get_local_port () const {
+    return m_impl->port;
+  }
+
+  std::size_t ServerLoop::get_shard_count () const {
+    return m_impl->shards.size ();
+  }
+
+  ServerBackend ServerLoop::get_backend () const {
+    return m_impl->shards.empty () ? ServerBackend::Auto : m_impl->shards.front ()->backend ();
+  }
+
+  ServerShardStats ServerLoop::get_stats () const {
+    ServerShardStats total;
+    for (const auto& stats : get_shard_stats ()) {
+      total.datagrams_received += stats.datagrams_received;
+      total.bytes_received += stats.bytes_received;
+      total.datagrams_sent += stats.datagrams_sent;
+      total.send_failures += stats.send_failures;
+      total.wakeups += stats.wakeups;
+      total.buffers_exhausted += stats.buffers_exhausted;
+    }
+    return total;
+  }
+
+  std::vector<ServerShardStats> ServerLoop::get_shard_stats () const {
+    std::vector<ServerShardStats> stats;
+    stats.reserve (m_impl->shards.size ());
+    for (const auto& shard : m_impl->shards) {
+      stats.push_back (shard->m_impl->stats.snapshot ());
+    }
+    return stats;
+  }
+
+} // namespace OmniCpp::Engine::Network
@@ -0,0 +1,346 @@
+/**
+ * @file snapshot.cpp
+ * @brief Quantized transform snapshot implementation
+ */
+
+#include "engine/network/snapshot.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace OmniCpp::Engine::Network {
+
+  namespace {
+
+    float wrap_degrees (float degrees) {
+      float wrapped = std::fmod (degrees, 360.0f);
+      return wrapped < 0.0f ? wrapped + 360.0f : wrapped;
+    }
+
+    bool less_by_id (const QuantizedTransform& a, const QuantizedTransform& b) {
+      return a.entity_id < b.entity_id;
+    }
+
+    uint8_t change_mask (const QuantizedTransform& current, const QuantizedTransform& baseline) {
+      uint8_t mask = 0;
+      for (uint32_t field = 0; field < TRANSFORM_FIELD_COUNT; ++field) {
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+          if (current.values[field * 3 + axis] != baseline.values[field * 3 + axis]) {
+            mask |= static_cast<uint8_t> (1u << field);
+            break;
+          }
+        }
+      }
+      return mask;
+    }
+
+  } // namespace
+
+  SnapshotCodec::SnapshotCodec (const SnapshotQuantization& quantization) : m_quantization (quantization) {
+    const auto& q = m_quantization;
+    m_steps = { quantization_steps (q.position_min, q.position_max, q.position_resolution),
+      quantization_steps (0.0f, 360.0f, q.rotation_resolution),
+      quantization_steps (q.scale_min, q.scale_max, q.scale_resolution) };
+    for (uint32_t field = 0; field < TRANSFORM_FIELD_COUNT; ++field) {
+      m_bits[field] = bits_required (m_steps[field]);
+    }
+    m_quantization.small_delta_bits = std::clamp<uint32_t> (q.small_delta_bits, 1, 31);
+  }
+
+  void SnapshotCodec::quantize (uint32_t tick, std::span<const TransformState> states, Snapshot& out) const {
+    const auto& q = m_quantization;
+    out.tick = tick;
+    out.entities.resize (states.size ());
+    for (std::size_t i = 0; i < states.size (); ++i) {
+      const TransformState& state = states[i];
+      QuantizedTransform& entity = out.entities[i];
+      entity.entity_id = state.entity_id;
+      const float position[3] = { state.position.x, state.position.y, state.position.z };
+      const float rotation[3] = { state.rotation.x, state.rotation.y, state.rotation.z };
+      const float scale[3] = { state.scale.x, state.scale.y, state.scale.z };
+      for (uint32_t axis = 0; axis < 3; ++axis) {
+        entity.values[axis] = Network::quantize (position[axis], q.position_min, q.position_max, m_steps[0]);
+        // 360 degrees is the same orientation as 0
+        entity.values[3 + axis] = Network::quantize (wrap_degrees (rotation[axis]), 0.0f, 360.0f, m_steps[1]) % m_steps[1];
+        entity.values[6 + axis] = Network::quantize (scale[axis], q.scale_min, q.scale_max, m_steps[2]);
+      }
+    }
+    std::sort (out.entities.begin (), out.entities.end (), less_by_id);
+  }
+
+  void SnapshotCodec::dequantize (const Snapshot& snapshot, std::vector<TransformState>& out) const {
+    const auto& q = m_quantization;
+    out.resize (snapshot.entities.size ());
+    for (std::size_t i = 0; i < snapshot.entities.size (); ++i) {
+      const auto& v = snapshot.entities[i].values;
+      auto position = [&] (uint32_t k) { return Network::dequantize (v[k], q.position_min, q.position_max, m_steps[0]); };
+      auto rotation = [&] (uint32_t k) { return Network::dequantize (v[k], 0.0f, 360.0f, m_steps[1]); };
+      auto scale = [&] (uint32_t k) { return Network::dequantize (v[k], q.scale_min, q.scale_max, m_steps[2]); };
+      out[i].entity_id = snapshot.entities[i].entity_id;
+      out[i].position = { position (0), position (1), position (2) };
+      out[i].rotation = { rotation (3), rotation (4), rotation (5) };
+      out[i].scale = { scale (6), scale (7), scale (8) };
+    }
+  }
+
+  void SnapshotCodec::write_full (BitWriter& writer, const QuantizedTransform& entity) const {
+    for (uint32_t k = 0; k < entity.values.size (); ++k) {
+      writer.write_bits (entity.values[k], m_bits[k / 3]);
+    }
+  }
+
+  void SnapshotCodec::read_full (BitReader& reader, QuantizedTransform& entity) const {
+    for (uint32_t k = 0; k < entity.values.size (); ++k) {
+      entity.values[k] = std::min (reader.read_bits (m_bits[k / 3]), m_steps[k / 3]);
+    }
+  }
+
+  bool SnapshotCodec::encode (const Snapshot& current, const Snapshot* baseline, BitWriter& writer) const {
+    static const Snapshot empty;
+    const Snapshot& base = baseline ? *baseline : empty;
+    const uint32_t small_bits = m_quantization.small_delta_bits;
+    const uint64_t small_limit = 1ull << small_bits;
+
+    writer.write_varint (current.tick);
+    writer.write_bool (baseline != nullptr);
+    if (baseline) {
+      writer.write_varint (current.tick - baseline->tick);
+    }
+
+    // Pass 1 counts so the reader knows how many records follow
+    std::size_t changed = 0;
+    std::size_t removed = 0;
+    {
+      std::size_t b = 0;
+      for (const auto& entity : current.entities) {
+        while (b < base.entities.size () && base.entities[b].entity_id < entity.entity_id) {
+          ++removed;
+          ++b;
+        }
+        const bool known = b < base.entities.size () && base.entities[b].entity_id == entity.entity_id;
+        if (!known || base.entities[b] != entity) {
+          ++changed;
+        }
+        b += known ? 1 : 0;
+      }
+      removed += base.entities.size () - b;
+    }
+
+    writer.write_varint (changed);
+    uint32_t previous_id = 0;
+    std::size_t b = 0;
+    for (const auto& entity : current.entities) {
+      while (b < base.entities.size () && base.entities[b].entity_id < entity.entity_id) {
+        ++b;
+      }
+      const bool known = b < base.entities.size () && base.entities[b].entity_id == entity.entity_id;
+      const uint8_t mask = known ? change_mask (entity, base.entities[b]) : 0;
+      if (known && mask == 0) {
+        ++b;
+        continue;
+      }
+
+      writer.write_varint (entity.entity_id - previous_id);
+      previous_id = entity.entity_id;
+      if (baseline) {
+        writer.write_bool (!known);
+      }
+      if (!known) {
+        write_full (writer, entity);
+        continue;
+      }
+
+      const QuantizedTransform& reference = base.entities[b++];
+      writer.write_bits (mask, TRANSFORM_FIELD_COUNT);
+      for (uint32_t field = 0; field < TRANSFORM_FIELD_COUNT; ++field) {
+        if (!(mask & (1u << field))) {
+          continue;
+        }
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+          const uint32_t k = field * 3 + axis;
+          const auto delta = static_cast<int64_t> (entity.values[k]) - static_cast<int64_t> (reference.values[k]);
+          const uint64_t zigzag = zigzag_encode (delta);
+          const bool small = zigzag < small_limit;
+          writer.write_bool (small);
+          if (small) {
+            writer.write_bits (static_cast<uint32_t> (zigzag), small_bits);
+          } else {
+            writer.write_bits (entity.values[k], m_bits[field]);
+          }
+        }
+      }
+    }
+
+    writer.write_varint (removed);
+    previous_id = 0;
+    std::size_t c = 0;
+    for (const auto& entity : base.entities) {
+      while (c < current.entities.size () && current.entities[c].entity_id < entity.entity_id) {
+        ++c;
+      }
+      if (c < current.entities.size () && current.entities[c].entity_id == entity.entity_id) {
+        continue;
+      }
+      writer.write_varint (entity.entity_id - previous_id);
+      previous_id = entity.entity_id;
+    }
+
+    writer.flush ();
+    return !writer.overflowed ();
+  }
+
+  bool SnapshotCodec::peek_header (std::span<const uint8_t> data, uint32_t& tick, std::optional<uint32_t>& baseline_tick) {
+    BitReader reader (data);
+    tick = static_cast<uint32_t> (reader.read_varint ());
+    baseline_tick.reset ();
+    if (reader.read_bool ()) {
+      baseline_tick = tick - static_cast<uint32_t> (reader.read_varint ());
+    }
+    return !reader.failed ();
+  }
+
+  bool SnapshotCodec::decode (BitReader& reader, const Snapshot* baseline, Snapshot& out) const {
+    const uint32_t small_bits = m_quantization.small_delta_bits;
+    out.tick = static_cast<uint32_t> (reader.read_varint ());
+    const bool has_baseline = reader.read_bool ();
+    if (has_baseline) {
+      const auto baseline_tick = out.tick - static_cast<uint32_t> (reader.read_varint ());
+      if (!baseline || baseline->tick != baseline_tick) {
+        return false;
+      }
+    }
+
+    static const Snapshot empty;
+    const Snapshot& base = has_baseline ? *baseline : empty;
+
+    // Changed and new entities arrive in id order, so merge them with the baseline as we go
+    out.entities.clear ();
+    out.entities.reserve (base.entities.size ());
+    std::size_t b = 0;
+    uint32_t id = 0;
+    const uint64_t changed = reader.read_varint ();
+    for (uint64_t i = 0; i < changed && !reader.failed (); ++i) {
+      id += static_cast<uint32_t> (reader.read_varint ());
+      while (b < base.entities.size () && base.entities[b].entity_id < id) {
+        out.entities.push_back (base.entities[b++]);
+      }
+      const bool is_new = has_baseline ? reader.read_bool () : true;
+      QuantizedTransform entity;
+      entity.entity_id = id;
+      if (is_new) {
+        read_full (reader, entity);
+        if (b < base.entities.size () && base.entities[b].entity_id == id) {
+          ++b; // Re-created entity replaces the baseline copy
+        }
+        out.entities.push_back (entity);
+        continue;
+      }
+
+      if (b >= base.entities.size () || base.entities[b].entity_id != id) {
+        return false; // Delta against an entity the baseline does not have
+      }
+      entity = base.entities[b++];
+      const uint32_t mask = reader.read_bits (TRANSFORM_FIELD_COUNT);
+      for (uint32_t field = 0; field < TRANSFORM_FIELD_COUNT; ++field) {
+        if (!(mask & (1u << field))) {
+          continue;
+        }
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+          uint32_t& value = entity.values[field * 3 + axis];
+          if (reader.read_bool ()) {
+            const int64_t delta = zigzag_decode (reader.read_bits (small_bits));
+            value = static_cast<uint32_t> (std::clamp<int64_t> (value + delta, 0, m_steps[field]));
+          } else {
+            value = std::min (reader.read_bits (m_bits[field]), m_steps[field]);
+          }
+        }
+      }
+      out.entities.push_back (entity);
+    }
+    while (b < base.entities.size ()) {
+      out.entities.push_back (base.entities[b++]);
+    }
+
+    // Drop removed entities (both lists are sorted)
+    const uint64_t removed = reader.read_varint ();
+    if (removed > 0) {
+      std::vector<uint32_t> removed_ids;
+      removed_ids.reserve (static_cast<std::size_t> (std::min<uint64_t> (removed, out.entities.size ())));
+      id = 0;
+      for (uint64_t i = 0; i < removed && !reader.failed (); ++i) {
+        id += static_cast<uint32_t> (reader.read_varint ());
+        removed_ids.push_back (id);
+      }
+      std::erase_if (out.entities, [&] (const QuantizedTransform& entity) {
+        return std::binary_search (removed_ids.begin (), removed_ids.end (), entity.entity_id);
+      });
+    }
+
+    return !reader.failed ();
+  }
+
+  SnapshotSender::SnapshotSender (const SnapshotCodec& codec, std::size_t history_size)
+      : m_codec (codec), m_history (std::max<std::size_t> (history_size, 1)) {
+  }
+
+  const Snapshot* SnapshotSender::find (uint32_t tick) const {
+    const auto& slot = m_history[tick % m_history.size ()];
+    return slot && slot->tick == tick ? &*slot : nullptr;
+  }
+
+  std::size_t SnapshotSender::encode (const Snapshot& snapshot, std::span<uint8_t> out) {
+    const Snapshot* baseline = m_acked_tick ? find (*m_acked_tick) : nullptr;
+    BitWriter writer (out);
+    if (!m_codec.encode (snapshot, baseline, writer)) {
+      return 0;
+    }
+    m_history[snapshot.tick % m_history.size ()] = snapshot;
+    return writer.bytes_written ();
+  }
+
+  void SnapshotSender::acknowledge (uint32_t tick) {
+    // Acks can arrive out of order; only move the baseline forward
+    if (find (tick) && (!m_acked_tick || static_cast<int32_t> (tick - *m_acked_tick) > 0)) {
+      m_acked_tick = tick;
+    }
+  }
+
+  std::optional<uint32_t> SnapshotSender::get_baseline_tick () const {
+    return m_acked_tick && find (*m_acked_tick) ? m_acked_tick : std::nullopt;
+  }
+
+  SnapshotReceiver::SnapshotReceiver (const SnapshotCodec& codec, std::size_t history_size)
+      : m_codec (codec), m_history (std::max<std::size_t> (history_size, 1)) {
+  }
+
+  const Snapshot* SnapshotReceiver::find (uint32_t tick) const {
+    const auto& slot = m_history[tick % m_history.size ()];
+    return slot && slot->tick == tick ? &*slot : nullptr;
+  }
+
+  bool SnapshotReceiver::decode (std::span<const uint8_t> data, Snapshot& out) {
+    uint32_t tick = 0;
+    std::optional<uint32_t> baseline_tick;
+    if (!SnapshotCodec::peek_header (data, tick, baseline_tick)) {
+      return false;
+    }
+    const Snapshot* baseline = baseline_tick ? find (*baseline_tick) : nullptr;
+    if (baseline_tick && !baseline) {
+      return false;
+    }
+
+    BitReader reader (data);
+    if (!m_codec.decode (reader, baseline, out)) {
+      return false;
+    }
+    m_history[out.tick % m_history.size ()] = out;
+    if (!m_latest_tick || static_cast<int32_t> (out.tick - *m_latest_tick) > 0) {
+      m_latest_tick = out.tick;
+    }
+    return true;
+  }
+
+  const Snapshot* SnapshotReceiver::get_latest () const {
+    return m_latest_tick ? find (*m_latest_tick) : nullptr;
+  }
+
+} // namespace OmniCpp::Engine::Network
@@ -0,0 +1,1131 @@
+/**
+ * @file transport.cpp
+ * @brief Connection-oriented UDP transport implementation
+ */
+
+#include "engine/network/transport.hpp"
+#include "engine/network/udp_socket.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include "engine/logging/Log.hpp"
+
+namespace OmniCpp::Engine::Network {
+
+  using Clock = std::chrono::steady_clock;
+
+  namespace {
+
+    // Wire format (big-endian):
+    //   packet   = protocol_id:u32 type:u8 sequence:u16 ack:u16 ack_bits:u32 message*
+    //   message  = channel:u8 id:u16 length:u16 [group:u16 index:u8 count:u8] payload
+    // The top bit of `type` marks a valid ack field; the top bit of `channel`
+    // marks a fragment.
+    constexpr std::size_t PACKET_HEADER_SIZE = 13;
+    constexpr std::size_t MESSAGE_HEADER_SIZE = 5;
+    constexpr std::size_t FRAGMENT_HEADER_SIZE = 4;
+    constexpr std::size_t MAX_FRAGMENTS = 255;
+    constexpr std::size_t RECORD_HEADROOM = 16;         // Room to prepend a message header in place
+    constexpr std::size_t MAX_SEGMENTS_PER_PACKET = 256; // Above the minimum-size messages an MTU holds; IOV_MAX is 1024
+    constexpr uint8_t HAS_ACK_FLAG = 0x80;
+    constexpr uint8_t FRAGMENT_FLAG = 0x80;
+
+    constexpr std::size_t SENT_PACKET_WINDOW = 256;
+    constexpr std::size_t RECEIVED_PACKET_WINDOW = 256;
+    constexpr std::size_t SENT_PACKET_MESSAGES = 32; // Typical reliable messages per packet
+    constexpr uint16_t MESSAGE_WINDOW = 512; // Unacked reliable messages per channel
+    constexpr int DISCONNECT_REPEATS = 3;
+    constexpr auto INITIAL_RESEND_TIMEOUT = std::chrono::milliseconds (100);
+    constexpr auto MAX_RESEND_TIMEOUT = std::chrono::milliseconds (1000);
+    constexpr auto FRAGMENT_TIMEOUT = std::chrono::seconds (2);
+
+    enum class PacketType : uint8_t { Connect = 1, Accept = 2, Data = 3, Disconnect = 4 };
+
+    bool sequence_greater (uint16_t a, uint16_t b) {
+      const auto difference = static_cast<uint16_t> (a - b);
+      return difference != 0 && difference < 0x8000;
+    }
+
+    bool is_reliable (Channel channel) {
+      return channel != Channel::Unreliable;
+    }
+
+    class ByteWriter {
+    public:
+      explicit ByteWriter (std::span<uint8_t> buffer) : m_buffer (buffer) {
+      }
+
+      void u8 (uint8_t value) { m_buffer[m_offset++] = value; }
+      void u16 (uint16_t value) {
+        u8 (static_cast<uint8_t> (value >> 8));
+        u8 (static_cast<uint8_t> (value));
+      }
+      void u32 (uint32_t value) {
+        u16 (static_cast<uint16_t> (value >> 16));
+        u16 (static_cast<uint16_t> (value));
+      }
+      void bytes (std::span<const uint8_t> data) {
+        if (!data.empty ()) {
+          std::memcpy (m_buffer.data () + m_offset, data.data (), data.size ());
+          m_offset += data.size ();
+        }
+      }
+
+      [[nodiscard]] std::size_t size () const { return m_offset; }
+      [[nodiscard]] std::size_t remaining () const { return m_buffer.size () - m_offset; }
+
+    private:
+      std::span<uint8_t> m_buffer;
+      std::size_t m_offset{ 0 };
+    };
+
+    class ByteReader {
+    public:
+      explicit ByteReader (std::span<const uint8_t> buffer) : m_buffer (buffer) {
+      }
+
+      bool u8 (uint8_t& value) {
+        if (remaining () < 1) {
+          return false;
+        }
+        value = m_buffer[m_offset++];
+        return true;
+      }
+      bool u16 (uint16_t& value) {
+        uint8_t high = 0;
+        uint8_t low = 0;
+        if (!u8 (high) || !u8 (low)) {
+          return false;
+        }
+        value = static_cast<uint16_t> ((high << 8) | low);
+        return true;
+      }
+      bool u32 (uint32_t& value) {
+        uint16_t high = 0;
+        uint16_t low = 0;
+        if (!u16 (high) || !u16 (low)) {
+          return false;
+        }
+        value = (static_cast<uint32_t> (high) << 16) | low;
+        return true;
+      }
+      bool bytes (std::size_t count, std::span<const uint8_t>& out) {
+        if (remaining () < count) {
+          return false;
+        }
+        out = m_buffer.subspan (m_offset, count);
+        m_offset += count;
+        return true;
+      }
+
+      [[nodiscard]] std::size_t remaining () const { return m_buffer.size () - m_offset; }
+      [[nodiscard]] std::size_t offset () const { return m_offset; }
+
+    private:
+      std::span<const uint8_t> m_buffer;
+      std::size_t m_offset{ 0 };
+    };
+
+    struct OutgoingMessage {
+      PacketBuffer bytes; // Message header and payload exactly as they go on the wire
+      Clock::time_point last_sent{};
+      uint16_t id{ 0 };
+      bool sent{ false };
+    };
+
+    struct IncomingMessage {
+      PacketBuffer payload; // Slice of the received datagram
+      uint16_t id{ 0 };
+      uint16_t group{ 0 };
+      uint8_t fragment_index{ 0 };
+      uint8_t fragment_count{ 0 };
+    };
+
+    struct Reassembly {
+      std::vector<PacketBuffer> parts;
+      std::vector<bool> present;
+      std::size_t received{ 0 };
+      std::size_t reserved{ 0 }; // Charged to Connection::reassembly_bytes until the group completes or expires
+      Clock::time_point started;
+    };
+
+    struct ChannelState {
+      Channel type{ Channel::Unreliable };
+
+      // Send side
+      uint16_t next_send_id{ 0 };
+      uint16_t oldest_unacked{ 0 };
+      std::vector<std::optional<OutgoingMessage>> window; // Reliable, indexed by id % MESSAGE_WINDOW
+      std::vector<OutgoingMessage> unreliable_queue;
+
+      // Receive side
+      uint16_t next_receive_id{ 0 };                           // Ordered
+      std::vector<std::optional<IncomingMessage>> receive_buffer; // Ordered, indexed by id % MESSAGE_WINDOW
+      std::vector<int32_t> received_ids;                       // Unordered duplicate filter
+      uint16_t newest_received{ 0 };
+      bool any_received{ false };
+      std::unordered_map<uint16_t, Reassembly> reassembly;
+    };
+
+    struct SentPacket {
+      Clock::time_point time;
+      std::vector<std::pair<uint8_t, uint16_t>> messages; // (channel, id) of reliable payloads
+      uint16_t sequence{ 0 };
+      bool valid{ false };
+      bool acked{ false };
+    };
+
+    struct Connection {
+      enum class State : uint8_t { Connecting, Connected };
+
+      ConnectionId id{ 0 };
+      Endpoint endpoint;
+      State state{ State::Connecting };
+      Clock::time_point last_received;
+      Clock::time_point last_sent;
+
+      // Packet-level acks
+      uint16_t next_sequence{ 0 };
+      uint16_t remote_sequence{ 0 };
+      bool received_any{ false };
+      bool ack_pending{ false };
+      std::array<int32_t, RECEIVED_PACKET_WINDOW> received_packets;
+      std::array<SentPacket, SENT_PACKET_WINDOW> sent_packets;
+
+      // RFC 6298 style estimator
+      double srtt_ms{ 0.0 };
+      double rttvar_ms{ 0.0 };
+      bool has_rtt{ false };
+
+      std::array<ChannelState, CHANNEL_COUNT> channels;
+      std::size_t reassembly_bytes{ 0 }; // Fragment space claimed by incomplete groups, all channels
+      bool reassembly_overflow{ false }; // Over max_reassembly_bytes; dropped once the datagram is handled
+
+      Connection () {
+        received_packets.fill (-1);
+        for (auto& packet : sent_packets) {
+          packet.messages.reserve (SENT_PACKET_MESSAGES); // Ring slots are reused; keep them from regrowing
+        }
+        for (std::size_t c = 0; c < CHANNEL_COUNT; ++c) {
+          auto& channel = channels[c];
+          channel.type = static_cast<Channel> (c);
+          if (is_reliable (channel.type)) {
+            channel.window.resize (MESSAGE_WINDOW);
+          }
+          if (channel.type == Channel::ReliableOrdered) {
+            channel.receive_buffer.resize (MESSAGE_WINDOW);
+          }
+          if (channel.type == Channel::ReliableUnordered) {
+            channel.received_ids.assign (MESSAGE_WINDOW, -1);
+          }
+        }
+      }
+
+      [[nodiscard]] Clock::duration resend_timeout (Clock::duration minimum) const {
+        if (!has_rtt) {
+          return std::max<Clock::duration> (INITIAL_RESEND_TIMEOUT, minimum);
+        }
+        const auto estimate = std::chrono::duration_cast<Clock::duration> (
+            std::chrono::duration<double, std::milli> (srtt_ms + 4.0 * rttvar_ms));
+        return std::clamp<Clock::duration> (estimate, minimum, MAX_RESEND_TIMEOUT);
+      }
+    };
+
+    // Writes the message header into the headroom in front of the payload
+    bool prepend_message_header (PacketBuffer& payload, uint8_t channel_index, uint16_t id, uint16_t group = 0,
+        uint8_t fragment_index = 0, uint8_t fragment_count = 0) {
+      const std::size_t payload_size = payload.size ();
+      auto header = payload.prepend (MESSAGE_HEADER_SIZE + (fragment_count ? FRAGMENT_HEADER_SIZE : 0));
+      if (header.empty ()) {
+        return false;
+      }
+      ByteWriter writer (header);
+      writer.u8 (static_cast<uint8_t> (channel_index | (fragment_count ? FRAGMENT_FLAG : 0)));
+      writer.u16 (id);
+      writer.u16 (static_cast<uint16_t> (payload_size));
+      if (fragment_count) {
+        writer.u16 (group);
+        writer.u8 (fragment_index);
+        writer.u8 (fragment_count);
+      }
+      return true;
+    }
+
+    struct EndpointHash {
+      std::size_t operator() (const Endpoint& endpoint) const {
+        const auto address = endpoint.address ();
+        const std::size_t host = address.is_v4 () ? address.to_v4 ().to_uint ()
+                                                  : std::hash<std::string> {}(address.to_string ());
+        return host ^ (static_cast<std::size_t> (endpoint.port ()) << 32);
+      }
+    };
+
+  } // namespace
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct Transport::Impl {
+    TransportConfig config;
+    UdpSocket socket;
+    PacketPool pool{ 1500, RECORD_HEADROOM };
+    std::unique_ptr<ReceiveBatch> receive_batch;
+    std::unique_ptr<GatherBatch> send_batch;
+    NetworkConditioner conditioner;
+    std::unique_ptr<DatagramBatch> conditioned_batch; // Allocated once a conditioner is enabled
+    std::unordered_map<ConnectionId, std::unique_ptr<Connection>> connections;
+    std::unordered_map<Endpoint, ConnectionId, EndpointHash> by_endpoint;
+    std::vector<Message> messages; // Drained from message_head; reset once empty so capacity is reused
+    std::size_t message_head{ 0 };
+    std::deque<TransportEvent> events;
+    TransportStats stats;
+    ConnectionId next_connection_id{ 1 };
+    bool initialized{ false };
+
+    [[nodiscard]] std::size_t max_unfragmented () const {
+      return config.mtu - PACKET_HEADER_SIZE - MESSAGE_HEADER_SIZE;
+    }
+    [[nodiscard]] std::size_t fragment_size () const {
+      return config.mtu - PACKET_HEADER_SIZE - MESSAGE_HEADER_SIZE - FRAGMENT_HEADER_SIZE;
+    }
+    [[nodiscard]] std::size_t max_fragments () const {
+      return std::min (MAX_FRAGMENTS, (config.max_message_size + fragment_size () - 1) / fragment_size ());
+    }
+
+    Connection* find (ConnectionId id) const;
+    Connection& add_connection (const Endpoint& endpoint, Connection::State state, Clock::time_point now);
+    void remove_connection (ConnectionId id, bool notify_peer);
+
+    std::span<uint8_t> begin_datagram (const Endpoint& destination);
+    void end_datagram (std::size_t header_length, std::size_t length);
+    void flush_socket ();
+    void release_conditioned (Clock::time_point now);
+    void send_control (const Endpoint& destination, PacketType type);
+    void write_header (ByteWriter& writer, PacketType type, Connection* connection);
+
+    void handle_datagram (const Endpoint& from, const PacketBuffer& datagram, Clock::time_point now);
+    void handle_data (Connection& connection, const PacketBuffer& datagram, ByteReader& reader, uint16_t sequence,
+        Clock::time_point now);
+    void handle_acks (Connection& connection, uint16_t ack, uint32_t ack_bits, Clock::time_point now);
+    void receive_message (Connection& connection, uint8_t channel, IncomingMessage message, Clock::time_point now);
+    void accept_message (Connection& connection, uint8_t channel, IncomingMessage message, Clock::time_point now);
+
+    void check_timeouts (Clock::time_point now);
+    void flush_connection (Connection& connection, Clock::time_point now);
+
+    bool queue_message (ConnectionId connection_id, Channel channel_type, std::span<const uint8_t> data,
+        PacketBuffer* owned);
+  };
+
+  Connection* Transport::Impl::find (ConnectionId id) const {
+    auto it = connections.find (id);
+    return it == connections.end () ? nullptr : it->second.get ();
+  }
+
+  Connection& Transport::Impl::add_connection (const Endpoint& endpoint, Connection::State state, Clock::time_point now) {
+    auto connection = std::make_unique<Connection> ();
+    connection->id = next_connection_id++;
+    connection->endpoint = endpoint;
+    connection->state = state;
+    connection->last_received = now;
+    connection->last_sent = Clock::time_point {};
+    Connection& ref = *connection;
+    by_endpoint.emplace (endpoint, ref.id);
+    connections.emplace (ref.id, std::move (connection));
+    return ref;
+  }
+
+  void Transport::Impl::remove_connection (ConnectionId id, bool notify_peer) {
+    auto it = connections.find (id);
+    if (it == connections.end ()) {
+      return;
+    }
+    if (notify_peer) {
+      // Best effort: sent a few times since nothing acks it
+      for (int i = 0; i < DISCONNECT_REPEATS; ++i) {
+        send_control (it->second->endpoint, PacketType::Disconnect);
+      }
+    }
+    by_endpoint.erase (it->second->endpoint);
+    connections.erase (it);
+    events.push_back ({ TransportEvent::Type::Disconnected, id });
+  }
+
+  std::span<uint8_t> Transport::Impl::begin_datagram (const Endpoint& destination) {
+    if (send_batch->full () || send_batch->segment_room () < MAX_SEGMENTS_PER_PACKET) {
+      flush_socket ();
+    }
+    return send_batch->begin_datagram (destination);
+  }
+
+  void Transport::Impl::end_datagram (std::size_t header_length, std::size_t length) {
+    send_batch->end_datagram (header_length);
+    ++stats.packets_sent;
+    stats.bytes_sent += length;
+  }
+
+  void Transport::Impl::flush_socket () {
+    if (conditioned_batch) {
+      const auto now = Clock::now ();
+      if (conditioner.get_config ().enabled) {
+        conditioner.enqueue (*send_batch, now);
+      } else {
+        socket.send (*send_batch);
+      }
+      send_batch->clear ();
+      release_conditioned (now);
+      return;
+    }
+    socket.send (*send_batch);
+    send_batch->clear ();
+  }
+
+  void Transport::Impl::release_conditioned (Clock::time_point now) {
+    // A disabled conditioner still drains what it holds
+    const auto deadline = conditioner.get_config ().enabled ? now : Clock::time_point::max ();
+    do {
+      conditioned_batch->clear ();
+      if (conditioner.release (deadline, *conditioned_batch) > 0) {
+        socket.send (*conditioned_batch);
+      }
+    } while (conditioned_batch->full ());
+    if (!conditioner.get_config ().enabled && conditioner.get_queued_count () == 0) {
+      conditioned_batch.reset ();
+    }
+  }
+
+  void Transport::Impl::write_header (ByteWriter& writer, PacketType type, Connection* connection) {
+    uint8_t type_byte = static_cast<uint8_t> (type);
+    uint16_t sequence = 0;
+    uint16_t ack = 0;
+    uint32_t ack_bits = 0;
+    if (connection) {
+      sequence = connection->next_sequence++;
+      if (connection->received_any) {
+        type_byte |= HAS_ACK_FLAG;
+        ack = connection->remote_sequence;
+        for (uint32_t bit = 0; bit < 32; ++bit) {
+          const auto previous = static_cast<uint16_t> (ack - 1 - bit);
+          if (connection->received_packets[previous % RECEIVED_PACKET_WINDOW] == previous) {
+            ack_bits |= 1u << bit;
+          }
+        }
+      }
+    }
+    writer.u32 (config.protocol_id);
+    writer.u8 (type_byte);
+    writer.u16 (sequence);
+    writer.u16 (ack);
+    writer.u32 (ack_bits);
+  }
+
+  void Transport::Impl::send_control (const Endpoint& destination, PacketType type) {
+    ByteWriter writer (begin_datagram (destination));
+    write_header (writer, type, nullptr);
+    end_datagram (writer.size (), writer.size ());
+  }
+
+  void Transport::Impl::handle_datagram (const Endpoint& from, const PacketBuffer& datagram, Clock::time_point now) {
+    ByteReader reader (datagram.span ());
+    uint32_t protocol_id = 0;
+    uint8_t type_byte = 0;
+    uint16_t sequence = 0;
+    uint16_t ack = 0;
+    uint32_t ack_bits = 0;
+    if (!reader.u32 (protocol_id) || !reader.u8 (type_byte) || !reader.u16 (sequence) || !reader.u16 (ack) ||
+        !reader.u32 (ack_bits) || protocol_id != config.protocol_id) {
+      ++stats.invalid_packets;
+      return;
+    }
+
+    ++stats.packets_received;
+    stats.bytes_received += datagram.size ();
+
+    auto it = by_endpoint.find (from);
+    Connection* connection = it == by_endpoint.end () ? nullptr : find (it->second);
+    const auto type = static_cast<PacketType> (type_byte & ~HAS_ACK_FLAG);
+
+    switch (type) {
+      case PacketType::Connect:
+        if (connection) {
+          connection->last_received = now;
+          send_control (from, PacketType::Accept); // Our Accept was lost
+          return;
+        }
+        if (!config.accept_connections) {
+          return;
+        }
+        if (connections.size () >= config.max_connections) {
+          omnicpp::log::warn ("Transport: Rejecting {}:{}, connection limit {} reached", from.address ().to_string (),
+              from.port (), config.max_connections);
+          return;
+        }
+        connection = &add_connection (from, Connection::State::Connected, now);
+        events.push_back ({ TransportEvent::Type::Connected, connection->id });
+        send_control (from, PacketType::Accept);
+        return;
+
+      case PacketType::Accept:
+        if (connection && connection->state == Connection::State::Connecting) {
+          connection->state = Connection::State::Connected;
+          events.push_back ({ TransportEvent::Type::Connected, connection->id });
+        }
+        if (connection) {
+          connection->last_received = now;
+        }
+        return;
+
+      case PacketType::Disconnect:
+        if (connection) {
+          remove_connection (connection->id, false);
+        }
+        return;
+
+      case PacketType::Data:
+        if (!connection) {
+          return;
+        }
+        if (connection->state == Connection::State::Connecting) {
+          // Accept was lost but the peer is already talking to us
+          connection->state = Connection::State::Connected;
+          events.push_back ({ TransportEvent::Type::Connected, connection->id });
+        }
+        connection->last_received = now;
+        if (type_byte & HAS_ACK_FLAG) {
+          handle_acks (*connection, ack, ack_bits, now);
+        }
+        handle_data (*connection, datagram, reader, sequence, now);
+        if (connection->reassembly_overflow) {
+          // A peer that opens fragment groups faster than it completes them could exhaust our memory
+          omnicpp::log::warn ("Transport: Dropping connection {} to {}:{}, incomplete fragments exceed {} bytes",
+              connection->id, from.address ().to_string (), from.port (), config.max_reassembly_bytes);
+          remove_connection (connection->id, true);
+        }
+        return;
+
+      default:
+        ++stats.invalid_packets;
+        return;
+    }
+  }
+
+  void Transport::Impl::handle_acks (Connection& connection, uint16_t ack, uint32_t ack_bits, Clock::time_point now) {
+    for (uint32_t bit = 0; bit <= 32; ++bit) {
+      if (bit > 0 && !(ack_bits & (1u << (bit - 1)))) {
+        continue;
+      }
+      const auto sequence = static_cast<uint16_t> (ack - bit);
+      SentPacket& packet = connection.sent_packets[sequence % SENT_PACKET_WINDOW];
+      if (!packet.valid || packet.sequence != sequence || packet.acked) {
+        continue;
+      }
+      packet.acked = true;
+      ++stats.packets_acked;
+
+      const double sample = std::chrono::duration<double, std::milli> (now - packet.time).count ();
+      if (!connection.has_rtt) {
+        connection.srtt_ms = sample;
+        connection.rttvar_ms = sample / 2.0;
+        connection.has_rtt = true;
+      } else {
+        connection.rttvar_ms = 0.75 * connection.rttvar_ms + 0.25 * std::abs (connection.srtt_ms - sample);
+        connection.srtt_ms = 0.875 * connection.srtt_ms + 0.125 * sample;
+      }
+
+      for (const auto& [channel_index, id] : packet.messages) {
+        ChannelState& channel = connection.channels[channel_index];
+        auto& slot = channel.window[id % MESSAGE_WINDOW];
+        if (slot && slot->id == id) {
+          slot.reset ();
+        }
+      }
+      packet.messages.clear ();
+    }
+
+    for (auto& channel : connection.channels) {
+      if (!is_reliable (channel.type)) {
+        continue;
+      }
+      while (channel.oldest_unacked != channel.next_send_id && !channel.window[channel.oldest_unacked % MESSAGE_WINDOW]) {
+        ++channel.oldest_unacked;
+      }
+    }
+  }
+
+  void Transport::Impl::handle_data (Connection& connection, const PacketBuffer& datagram, ByteReader& reader,
+      uint16_t sequence, Clock::time_point now) {
+    if (connection.received_any &&
+        !sequence_greater (sequence, static_cast<uint16_t> (connection.remote_sequence - RECEIVED_PACKET_WINDOW))) {
+      ++stats.duplicates_dropped; // Too old to tell apart from a duplicate
+      return;
+    }
+    int32_t& seen = connection.received_packets[sequence % RECEIVED_PACKET_WINDOW];
+    if (seen == sequence) {
+      ++stats.duplicates_dropped;
+      return;
+    }
+    seen = sequence;
+    if (!connection.received_any || sequence_greater (sequence, connection.remote_sequence)) {
+      connection.remote_sequence = sequence;
+    }
+    connection.received_any = true;
+
+    while (reader.remaining () > 0) {
+      uint8_t channel_byte = 0;
+      IncomingMessage message;
+      uint16_t length = 0;
+      if (!reader.u8 (channel_byte) || !reader.u16 (message.id) || !reader.u16 (length)) {
+        ++stats.invalid_packets;
+        return;
+      }
+      if (channel_byte & FRAGMENT_FLAG) {
+        if (!reader.u16 (message.group) || !reader.u8 (message.fragment_index) || !reader.u8 (message.fragment_count) ||
+            message.fragment_count == 0 || message.fragment_index >= message.fragment_count) {
+          ++stats.invalid_packets;
+          return;
+        }
+      }
+      const uint8_t channel = static_cast<uint8_t> (channel_byte & ~FRAGMENT_FLAG);
+      const std::size_t offset = reader.offset ();
+      std::span<const uint8_t> payload;
+      if (channel >= CHANNEL_COUNT || !reader.bytes (length, payload)) {
+        ++stats.invalid_packets;
+        return;
+      }
+      message.payload = datagram.slice (offset, length); // Shares the datagram's buffer
+      connection.ack_pending = true; // Only packets with content need an ack of their own
+      receive_message (connection, channel, std::move (message), now);
+    }
+  }
+
+  void Transport::Impl::receive_message (Connection& connection, uint8_t channel_index, IncomingMessage message,
+      Clock::time_point now) {
+    ChannelState& channel = connection.channels[channel_index];
+    const uint16_t id = message.id;
+
+    switch (channel.type) {
+      case Channel::Unreliable:
+        accept_message (connection, channel_index, std::move (message), now);
+        return;
+
+      case Channel::ReliableUnordered: {
+        if (channel.any_received) {
+          const auto age = static_cast<uint16_t> (channel.newest_received - id);
+          if (age < 0x8000 && age >= MESSAGE_WINDOW) {
+            ++stats.duplicates_dropped;
+            return;
+          }
+        }
+        int32_t& seen = channel.received_ids[id % MESSAGE_WINDOW];
+        if (seen == id) {
+          ++stats.duplicates_dropped;
+          return;
+        }
+        seen = id;
+        if (!channel.any_received || sequence_greater (id, channel.newest_received)) {
+          channel.newest_received = id;
+        }
+        channel.any_received = true;
+        accept_message (connection, channel_index, std::move (message), now);
+        return;
+      }
+
+      case Channel::ReliableOrdered: {
+        const auto distance = static_cast<uint16_t> (id - channel.next_receive_id);
+        if (distance >= MESSAGE_WINDOW) {
+          ++stats.duplicates_dropped; // Already delivered (or outside the sender's window)
+          return;
+        }
+        auto& slot = channel.receive_buffer[id % MESSAGE_WINDOW];
+        if (slot) {
+          ++stats.duplicates_dropped;
+          return;
+        }
+        slot = std::move (message);
+        while (true) {
+          auto& next = channel.receive_buffer[channel.next_receive_id % MESSAGE_WINDOW];
+          if (!next) {
+            break;
+          }
+          IncomingMessage ready = std::move (*next);
+          next.reset ();
+          ++channel.next_receive_id;
+          accept_message (connection, channel_index, std::move (ready), now);
+        }
+        return;
+      }
+    }
+  }
+
+  void Transport::Impl::accept_message (Connection& connection, uint8_t channel_index, IncomingMessage message,
+      Clock::time_point now) {
+    const auto channel = static_cast<Channel> (channel_index);
+    if (message.fragment_count == 0) {
+      ++stats.messages_received;
+      messages.push_back ({ connection.id, channel, std::move (message.payload) });
+      return;
+    }
+
+    auto& groups = connection.channels[channel_index].reassembly;
+    auto existing = groups.find (message.group);
+    if (existing == groups.end ()) {
+      if (message.fragment_count > max_fragments ()) {
+        ++stats.invalid_packets; // Larger than any message we accept
+        return;
+      }
+      const std::size_t reserved = message.fragment_count * fragment_size ();
+      if (connection.reassembly_bytes + reserved > config.max_reassembly_bytes) {
+        ++stats.reassembly_overflows;
+        connection.reassembly_overflow = true;
+        return;
+      }
+      connection.reassembly_bytes += reserved;
+      existing = groups.emplace (message.group, Reassembly{}).first;
+      Reassembly& created = existing->second;
+      created.parts.resize (message.fragment_count);
+      created.present.assign (message.fragment_count, false);
+      created.reserved = reserved;
+      created.started = now;
+    }
+    Reassembly& group = existing->second;
+    if (group.parts.size () != message.fragment_count || group.present[message.fragment_index]) {
+      ++stats.invalid_packets;
+      return;
+    }
+    group.parts[message.fragment_index] = std::move (message.payload);
+    group.present[message.fragment_index] = true;
+    if (++group.received < group.parts.size ()) {
+      return;
+    }
+
+    std::size_t total = 0;
+    for (const auto& part : group.parts) {
+      total += part.size ();
+    }
+    PacketBuffer data = pool.acquire (total);
+    for (const auto& part : group.parts) {
+      data.append (part.span ());
+    }
+    connection.reassembly_bytes -= group.reserved;
+    groups.erase (existing);
+    ++stats.messages_received;
+    messages.push_back ({ connection.id, channel, std::move (data) });
+  }
+
+  void Transport::Impl::check_timeouts (Clock::time_point now) {
+    std::vector<ConnectionId> expired;
+    std::vector<ConnectionId> stalled;
+    for (auto& [id, connection] : connections) {
+      if (now - connection->last_received > config.connection_timeout) {
+        expired.push_back (id);
+        continue;
+      }
+      for (auto& channel : connection->channels) {
+        // Lost unreliable fragments never arrive. Reliable ones are resent within a few RTTs,
+        // so a reliable group still open after a whole connection timeout is never completed.
+        const auto timeout = is_reliable (channel.type) ? Clock::duration (config.connection_timeout) : FRAGMENT_TIMEOUT;
+        const std::size_t erased = std::erase_if (channel.reassembly, [&] (const auto& entry) {
+          if (now - entry.second.started <= timeout) {
+            return false;
+          }
+          connection->reassembly_bytes -= entry.second.reserved;
+          return true;
+        });
+        stats.reassembly_expired += erased;
+        if (erased > 0 && is_reliable (channel.type)) {
+          stalled.push_back (id);
+        }
+      }
+    }
+    for (ConnectionId id : expired) {
+      const Connection& connection = *connections.at (id);
+      omnicpp::log::warn ("Transport: Connection {} to {}:{} timed out{}", id, connection.endpoint.address ().to_string (),
+          connection.endpoint.port (), connection.state == Connection::State::Connecting ? " while connecting" : "");
+      remove_connection (id, false);
+    }
+    for (ConnectionId id : stalled) {
+      if (const Connection* connection = find (id)) {
+        omnicpp::log::warn ("Transport: Dropping connection {} to {}:{}, a reliable message never completed", id,
+            connection->endpoint.address ().to_string (), connection->endpoint.port ());
+        remove_connection (id, true);
+      }
+    }
+  }
+
+  void Transport::Impl::flush_connection (Connection& connection, Clock::time_point now) {
+    if (connection.state == Connection::State::Connecting) {
+      if (now - connection.last_sent >= config.connect_retry_interval) {
+        send_control (connection.endpoint, PacketType::Connect);
+        connection.last_sent = now;
+      }
+      return;
+    }
+
+    // Packets are gathered from the packet header plus the queued message buffers, uncopied
+    bool open = false;
+    std::size_t packet_size = 0;
+    std::size_t packet_segments = 0;
+    SentPacket* record = nullptr;
+    bool sent_any = false;
+
+    auto close_packet = [&] () {
+      end_datagram (PACKET_HEADER_SIZE, packet_size);
+      open = false;
+      connection.last_sent = now;
+      connection.ack_pending = false;
+      sent_any = true;
+    };
+    auto open_packet = [&] () {
+      ByteWriter writer (begin_datagram (connection.endpoint));
+      const uint16_t sequence = connection.next_sequence;
+      write_header (writer, PacketType::Data, &connection);
+      open = true;
+      packet_size = PACKET_HEADER_SIZE;
+      packet_segments = 0;
+      record = &connection.sent_packets[sequence % SENT_PACKET_WINDOW];
+      record->sequence = sequence;
+      record->time = now;
+      record->valid = true;
+      record->acked = false;
+      record->messages.clear ();
+    };
+    auto write_message = [&] (const OutgoingMessage& message) {
+      const std::size_t size = message.bytes.size ();
+      if (open && (packet_size + size > config.mtu || packet_segments == MAX_SEGMENTS_PER_PACKET)) {
+        close_packet ();
+      }
+      if (!open) {
+        open_packet ();
+      }
+      send_batch->add_segment (message.bytes);
+      packet_size += size;
+      ++packet_segments;
+    };
+
+    // Reliable first (resends, then new messages in id order), unreliable fill the gaps
+    const auto timeout = connection.resend_timeout (config.min_resend_timeout);
+    for (std::size_t c = 0; c < CHANNEL_COUNT; ++c) {
+      ChannelState& channel = connection.channels[c];
+      if (!is_reliable (channel.type)) {
+        continue;
+      }
+      for (uint16_t id = channel.oldest_unacked; id != channel.next_send_id; ++id) {
+        auto& slot = channel.window[id % MESSAGE_WINDOW];
+        if (!slot || (slot->sent && now - slot->last_sent < timeout)) {
+          continue;
+        }
+        if (slot->sent) {
+          ++stats.resends;
+        }
+        write_message (*slot);
+        record->messages.emplace_back (static_cast<uint8_t> (c), id);
+        slot->sent = true;
+        slot->last_sent = now;
+      }
+    }
+
+    auto& unreliable = connection.channels[static_cast<std::size_t> (Channel::Unreliable)].unreliable_queue;
+    for (const auto& message : unreliable) {
+      write_message (message);
+    }
+    unreliable.clear ();
+
+    if (open) {
+      close_packet ();
+    }
+    if (!sent_any && (connection.ack_pending || now - connection.last_sent >= config.keepalive_interval)) {
+      open_packet ();
+      close_packet ();
+    }
+  }
+
+  Transport::Transport () : m_impl (std::make_unique<Impl> ()) {
+  }
+
+  Transport::~Transport () {
+    if (m_impl) {
+      shutdown ();
+    }
+  }
+
+  Transport::Transport (Transport&& other) noexcept : m_impl (std::move (other.m_impl)) {
+  }
+
+  Transport& Transport::operator= (Transport&& other) noexcept {
+    if (this != &other) {
+      m_impl = std::move (other.m_impl);
+    }
+    return *this;
+  }
+
+  bool Transport::initialize (const TransportConfig& config) {
+    if (m_impl->initialized) {
+      omnicpp::log::warn ("Transport: Already initialized");
+      return true;
+    }
+
+    constexpr std::size_t min_mtu = PACKET_HEADER_SIZE + MESSAGE_HEADER_SIZE + FRAGMENT_HEADER_SIZE + 1;
+    if (config.mtu < min_mtu || config.mtu > 65507) {
+      omnicpp::log::error ("Transport: MTU {} outside [{}, 65507]", config.mtu, min_mtu);
+      return false;
+    }
+
+    m_impl->config = config;
+    if (!m_impl->socket.open (config.port, config.bind_address, config.socket_buffer_size)) {
+      return false;
+    }
+
+    // Buffers are sized for a full Ethernet frame so a peer with a larger MTU is still readable
+    m_impl->receive_batch.reset ();
+    m_impl->pool = PacketPool (std::max<std::size_t> (config.mtu, 1500), RECORD_HEADROOM);
+    m_impl->pool.reserve (config.batch_size * 2);
+    m_impl->receive_batch = std::make_unique<ReceiveBatch> (m_impl->pool, config.batch_size);
+    m_impl->send_batch = std::make_unique<GatherBatch> (
+        config.batch_size, std::max (config.batch_size * 16, MAX_SEGMENTS_PER_PACKET));
+    m_impl->stats = {};
+    m_impl->conditioner.clear ();
+    m_impl->conditioned_batch.reset ();
+    if (config.conditioner.enabled) {
+      set_conditioner (config.conditioner);
+    }
+    m_impl->initialized = true;
+
+    omnicpp::log::info ("Transport: Listening on port {} (mtu {}, {})", m_impl->socket.get_local_port (), config.mtu,
+        config.accept_connections ? "accepting connections" : "client only");
+    return true;
+  }
+
+  void Transport::shutdown () {
+    if (!m_impl->initialized) {
+      return;
+    }
+
+    std::vector<ConnectionId> ids;
+    for (const auto& [id, connection] : m_impl->connections) {
+      ids.push_back (id);
+    }
+    for (ConnectionId id : ids) {
+      m_impl->remove_connection (id, true);
+    }
+    m_impl->flush_socket ();
+    if (m_impl->conditioned_batch) {
+      // Deliver held datagrams now so the disconnect notices reach peers
+      m_impl->conditioner.configure ({});
+      m_impl->release_conditioned (Clock::now ());
+    }
+    m_impl->socket.close ();
+    m_impl->messages.clear ();
+    m_impl->message_head = 0;
+    m_impl->initialized = false;
+
+    omnicpp::log::info ("Transport: Shutdown");
+  }
+
+  void Transport::update () {
+    if (!m_impl->initialized) {
+      return;
+    }
+
+    const auto now = Clock::now ();
+    auto& batch = *m_impl->receive_batch;
+    while (m_impl->socket.receive (batch) > 0) {
+      for (std::size_t i = 0; i < batch.size (); ++i) {
+        m_impl->handle_datagram (batch.endpoint (i), batch.datagram (i), now);
+      }
+      if (!batch.full ()) {
+        break; // Socket drained
+      }
+    }
+
+    m_impl->check_timeouts (now);
+    for (auto& [id, connection] : m_impl->connections) {
+      m_impl->flush_connection (*connection, now);
+    }
+    m_impl->flush_socket ();
+  }
+
+  std::optional<ConnectionId> Transport::connect (const std::string& host, uint16_t port) {
+    if (!m_impl->initialized) {
+      omnicpp::log::error ("Transport: Not initialized, cannot connect to {}:{}", host, port);
+      return std::nullopt;
+    }
+
+    Endpoint endpoint;
+    if (!m_impl->socket.resolve (host, port, endpoint)) {
+      return std::nullopt;
+    }
+    if (auto it = m_impl->by_endpoint.find (endpoint); it != m_impl->by_endpoint.end ()) {
+      return it->second;
+    }
+
+    const Connection& connection = m_impl->add_connection (endpoint, Connection::State::Connecting, Clock::now ());
+    omnicpp::log::info ("Transport: Connecting to {}:{} (connection {})", host, port, connection.id);
+    return connection.id;
+  }
+
+  void Transport::disconnect (ConnectionId connection) {
+    if (!m_impl->initialized) {
+      return;
+    }
+    m_impl->remove_connection (connection, true);
+    m_impl->flush_socket ();
+  }
+
+  bool Transport::Impl::queue_message (ConnectionId connection_id, Channel channel_type, std::span<const uint8_t> data,
+      PacketBuffer* owned) {
+    Connection* connection = initialized ? find (connection_id) : nullptr;
+    if (!connection) {
+      return false;
+    }
+    if (data.size () > config.max_message_size) {
+      omnicpp::log::error ("Transport: Message of {} bytes exceeds max_message_size {}", data.size (),
+          config.max_message_size);
+      return false;
+    }
+
+    const std::size_t part_size = fragment_size ();
+    const std::size_t count = data.size () <= max_unfragmented () ? 1 : (data.size () + part_size - 1) / part_size;
+    if (count > MAX_FRAGMENTS) {
+      omnicpp::log::error ("Transport: Message of {} bytes needs {} fragments (max {})", data.size (), count, MAX_FRAGMENTS);
+      return false;
+    }
+
+    const auto channel_index = static_cast<uint8_t> (channel_type);
+    ChannelState& channel = connection->channels[channel_index];
+    const bool reliable = is_reliable (channel_type);
+    if (reliable && static_cast<uint16_t> (channel.next_send_id - channel.oldest_unacked) + count > MESSAGE_WINDOW) {
+      return false; // Back-pressure: the peer has not acked enough yet
+    }
+
+    const uint16_t group = channel.next_send_id;
+    for (std::size_t index = 0; index < count; ++index) {
+      OutgoingMessage message;
+      message.id = channel.next_send_id++;
+      if (count > 1) {
+        const std::size_t offset = index * part_size;
+        message.bytes = pool.acquire ();
+        message.bytes.append (data.subspan (offset, std::min (part_size, data.size () - offset)));
+        prepend_message_header (message.bytes, channel_index, message.id, group, static_cast<uint8_t> (index),
+            static_cast<uint8_t> (count));
+      } else {
+        // A caller-built buffer we own outright gets its header in place; anything else is copied once
+        if (owned && owned->unique () && owned->headroom () >= MESSAGE_HEADER_SIZE) {
+          message.bytes = std::move (*owned);
+        } else {
+          message.bytes = pool.acquire ();
+          message.bytes.append (data);
+        }
+        prepend_message_header (message.bytes, channel_index, message.id);
+      }
+
+      if (reliable) {
+        channel.window[message.id % MESSAGE_WINDOW] = std::move (message);
+      } else {
+        channel.unreliable_queue.push_back (std::move (message));
+      }
+    }
+
+    ++stats.messages_sent;
+    if (count > 1) {
+      stats.fragments_sent += count;
+    }
+    return true;
+  }
+
+  bool Transport::send (ConnectionId connection_id, Channel channel_type, std::span<const uint8_t> data) {
+    return m_impl->queue_message (connection_id, channel_type, data, nullptr);
+  }
+
+  bool Transport::send (ConnectionId connection_id, Channel channel_type, PacketBuffer data) {
+    return m_impl->queue_message (connection_id, channel_type, data.span (), &data);
+  }
+
+  PacketBuffer Transport::acquire_buffer () {
+    return m_impl->pool.acquire ();
+  }
+
+  bool Transport::poll_message (Message& out) {
+    auto& messages = m_impl->messages;
+    if (m_impl->message_head == messages.size ()) {
+      return false;
+    }
+    out = std::move (messages[m_impl->message_head++]);
+    if (m_impl->message_head == messages.size ()) {
+      messages.clear ();
+      m_impl->message_head = 0;
+    }
+    return true;
+  }
+
+  bool Transport::poll_event (TransportEvent& out) {
+    if (m_impl->events.empty ()) {
+      return false;
+    }
+    out = m_impl->events.front ();
+    m_impl->events.pop_front ();
+    return true;
+  }
+
+  bool Transport::is_connected (ConnectionId connection) const {
+    const Connection* found = m_impl->find (connection);
+    return found && found->state == Connection::State::Connected;
+  }
+
+  std::size_t Transport::get_connection_count () const {
+    return m_impl->connections.size ();
+  }
+
+  std::vector<ConnectionId> Transport::get_connections () const {
+    std::vector<ConnectionId> ids;
+    ids.reserve (m_impl->connections.size ());
+    for (const auto& [id, connection] : m_impl->connections) {
+      ids.push_back (id);
+    }
+    std::sort (ids.begin (), ids.end ());
+    return ids;
+  }
+
+  double Transport::get_rtt_ms (ConnectionId connection) const {
+    const Connection* found = m_impl->find (connection);
+    return found ? found->srtt_ms : 0.0;
+  }
+
+  uint16_t Transport::get_local_port () const {
+    return m_impl->socket.get_local_port ();
+  }
+
+  TransportStats Transport::get_stats () const {
+    TransportStats stats = m_impl->stats;
+    const auto& socket_stats = m_impl->socket.get_stats ();
+    stats.send_syscalls = socket_stats.send_calls;
+    stats.receive_syscalls = socket_stats.receive_calls;
+    return stats;
+  }
+
+  void Transport::set_conditioner (const NetworkConditionerConfig& config) {
+    m_impl->conditioner.configure (config);
+    if (config.enabled && !m_impl->conditioned_batch) {
+      m_impl->conditioned_batch = std::make_unique<DatagramBatch> (m_impl->config.batch_size, m_impl->config.mtu);
+    }
+    if (config.enabled) {
+      omnicpp::log::info ("Transport: Conditioner on (latency {} ms +/- {} ms, loss {:.1f}%, duplicate {:.1f}%, reorder {:.1f}%, "
+                          "bandwidth {} B/s)",
+          config.latency.count (), config.jitter.count (), config.loss * 100.0, config.duplicate * 100.0,
+          config.reorder * 100.0, config.bandwidth);
+    }
+  }
+
+  NetworkConditionerStats Transport::get_conditioner_stats () const {
+    return m_impl->conditioner.get_stats ();
+  }
+
+  PacketPoolStats Transport::get_pool_stats () const {
+    return m_impl->pool.get_stats ();
+  }
+
+} // namespace OmniCpp::Engine::Network
@@ -0,0 +1,457 @@
+/**
+ * @file udp_socket.cpp
+ * @brief Non-blocking UDP socket implementation
+ */
+
+#include "engine/network/udp_socket.hpp"
+#include <algorithm>
+#include <asio/io_context.hpp>
+#include <asio/ip/address.hpp>
+#include <cerrno>
+#include <cstddef>
+#include "engine/logging/Log.hpp"
+
+#if defined(__linux__)
+  #include <sys/socket.h>
+  #define OMNICPP_HAS_MMSG 1
+#endif
+
+namespace OmniCpp::Engine::Network {
+
+  DatagramBatch::DatagramBatch (std::size_t capacity, std::size_t max_datagram_size)
+      : m_storage (std::max<std::size_t> (capacity, 1) * max_datagram_size),
+        m_endpoints (std::max<std::size_t> (capacity, 1)),
+        m_lengths (std::max<std::size_t> (capacity, 1), 0),
+        m_max_size (max_datagram_size) {
+  }
+
+  std::span<uint8_t> DatagramBatch::prepare (const Endpoint& destination) {
+    if (full ()) {
+      return {};
+    }
+    m_endpoints[m_count] = destination;
+    return { slot (m_count), m_max_size };
+  }
+
+  void DatagramBatch::commit (std::size_t length) {
+    if (full ()) {
+      return;
+    }
+    m_lengths[m_count] = std::min (length, m_max_size);
+    ++m_count;
+  }
+
+  std::span<const uint8_t> DatagramBatch::data (std::size_t i) const {
+    return { m_storage.data () + i * m_max_size, m_lengths[i] };
+  }
+
+  GatherBatch::GatherBatch (std::size_t capacity, std::size_t max_segments)
+      : m_endpoints (std::max<std::size_t> (capacity, 1)),
+        m_headers (std::max<std::size_t> (capacity, 1)),
+        m_header_lengths (std::max<std::size_t> (capacity, 1), 0),
+        m_first_segment (std::max<std::size_t> (capacity, 1), 0),
+        m_segment_counts (std::max<std::size_t> (capacity, 1), 0),
+        m_segments (std::max<std::size_t> (max_segments, 1)) {
+  }
+
+  void GatherBatch::clear () noexcept {
+    for (std::size_t i = 0; i < m_segment_count; ++i) {
+      m_segments[i].reset ();
+    }
+    m_segment_count = 0;
+    m_count = 0;
+    m_open = false;
+  }
+
+  std::span<uint8_t> GatherBatch::begin_datagram (const Endpoint& destination) {
+    if (full () || m_open) {
+      return {};
+    }
+    m_endpoints[m_count] = destination;
+    m_first_segment[m_count] = static_cast<uint32_t> (m_segment_count);
+    m_segment_counts[m_count] = 0;
+    m_open = true;
+    return m_headers[m_count];
+  }
+
+  bool GatherBatch::add_segment (const PacketBuffer& segment) {
+    if (!m_open || m_segment_count == m_segments.size ()) {
+      return false;
+    }
+    m_segments[m_segment_count++] = segment;
+    ++m_segment_counts[m_count];
+    return true;
+  }
+
+  void GatherBatch::end_datagram (std::size_t header_length) {
+    if (!m_open) {
+      return;
+    }
+    m_header_lengths[m_count] = static_cast<uint32_t> (std::min (header_length, HEADER_CAPACITY));
+    m_open = false;
+    ++m_count;
+  }
+
+  std::size_t GatherBatch::datagram_size (std::size_t i) const {
+    std::size_t total = m_header_lengths[i];
+    for (const auto& segment : segments (i)) {
+      total += segment.size ();
+    }
+    return total;
+  }
+
+  std::size_t GatherBatch::copy_datagram (std::size_t i, std::span<uint8_t> out) const {
+    std::size_t written = 0;
+    auto put = [&] (std::span<const uint8_t> bytes) {
+      const std::size_t count = std::min (bytes.size (), out.size () - written);
+      std::copy_n (bytes.begin (), count, out.begin () + static_cast<std::ptrdiff_t> (written));
+      written += count;
+    };
+    put (header (i));
+    for (const auto& segment : segments (i)) {
+      put (segment.span ());
+    }
+    return written;
+  }
+
+  ReceiveBatch::ReceiveBatch (PacketPool& pool, std::size_t capacity)
+      : m_pool (pool),
+        m_buffers (std::max<std::size_t> (capacity, 1)),
+        m_endpoints (std::max<std::size_t> (capacity, 1)),
+        m_max_size (pool.headroom () + pool.buffer_size ()) {
+  }
+
+  void ReceiveBatch::prepare () {
+    m_count = 0;
+    for (auto& buffer : m_buffers) {
+      // Received datagrams use the whole block; headroom only matters for outgoing buffers
+      if (!buffer.rewind (0)) {
+        buffer = m_pool.acquire ();
+        buffer.rewind (0);
+      }
+    }
+  }
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct UdpSocket::Impl {
+    asio::io_context context;
+    asio::ip::udp::socket socket{ context };
+    UdpSocketStats stats;
+#ifdef OMNICPP_HAS_MMSG
+    std::vector<mmsghdr> headers;
+    std::vector<iovec> vectors;
+#else
+    std::vector<asio::const_buffer> gather_buffers;
+#endif
+
+    template<typename Batch>
+    std::size_t receive_batched (Batch& batch);
+    std::size_t send_batched (const DatagramBatch& batch);
+    std::size_t send_gathered (const GatherBatch& batch);
+    std::size_t send_headers (std::size_t count);
+    template<typename Batch>
+    std::size_t receive_loop (Batch& batch);
+    std::size_t send_loop (const DatagramBatch& batch);
+    std::size_t send_gather_loop (const GatherBatch& batch);
+  };
+
+#ifdef OMNICPP_HAS_MMSG
+  template<typename Batch>
+  std::size_t UdpSocket::Impl::receive_batched (Batch& batch) {
+    const std::size_t capacity = batch.capacity ();
+    headers.resize (capacity);
+    vectors.resize (capacity);
+    for (std::size_t i = 0; i < capacity; ++i) {
+      Endpoint& endpoint = batch.slot_endpoint (i);
+      vectors[i] = { batch.slot (i), batch.max_datagram_size () };
+      headers[i] = {};
+      headers[i].msg_hdr.msg_name = endpoint.data ();
+      headers[i].msg_hdr.msg_namelen = static_cast<socklen_t> (endpoint.capacity ());
+      headers[i].msg_hdr.msg_iov = &vectors[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    ++stats.receive_calls;
+    const int received =
+        ::recvmmsg (socket.native_handle (), headers.data (), static_cast<unsigned int> (capacity), MSG_DONTWAIT, nullptr);
+    if (received <= 0) {
+      return 0;
+    }
+
+    const auto count = static_cast<std::size_t> (received);
+    for (std::size_t i = 0; i < count; ++i) {
+      batch.slot_endpoint (i).resize (headers[i].msg_hdr.msg_namelen);
+      batch.set_slot_length (i, headers[i].msg_len);
+    }
+    batch.set_size (count);
+    return count;
+  }
+
+  std::size_t UdpSocket::Impl::send_batched (const DatagramBatch& batch) {
+    const std::size_t count = batch.size ();
+    headers.resize (std::max (headers.size (), count));
+    vectors.resize (std::max (vectors.size (), count));
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto payload = batch.data (i);
+      const Endpoint& endpoint = batch.endpoint (i);
+      vectors[i] = { const_cast<uint8_t*> (payload.data ()), payload.size () };
+      headers[i] = {};
+      headers[i].msg_hdr.msg_name = const_cast<sockaddr*> (endpoint.data ());
+      headers[i].msg_hdr.msg_namelen = static_cast<socklen_t> (endpoint.size ());
+      headers[i].msg_hdr.msg_iov = &vectors[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    return send_headers (count);
+  }
+
+  std::size_t UdpSocket::Impl::send_gathered (const GatherBatch& batch) {
+    const std::size_t count = batch.size ();
+    std::size_t total_vectors = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      total_vectors += 1 + batch.segments (i).size ();
+    }
+    headers.resize (std::max (headers.size (), count));
+    vectors.resize (std::max (vectors.size (), total_vectors));
+
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      const Endpoint& endpoint = batch.endpoint (i);
+      const auto header = batch.header (i);
+      const std::size_t first = next;
+      vectors[next++] = { const_cast<uint8_t*> (header.data ()), header.size () };
+      for (const auto& segment : batch.segments (i)) {
+        vectors[next++] = { const_cast<uint8_t*> (segment.data ()), segment.size () };
+      }
+      headers[i] = {};
+      headers[i].msg_hdr.msg_name = const_cast<sockaddr*> (endpoint.data ());
+      headers[i].msg_hdr.msg_namelen = static_cast<socklen_t> (endpoint.size ());
+      headers[i].msg_hdr.msg_iov = &vectors[first];
+      headers[i].msg_hdr.msg_iovlen = next - first;
+    }
+    return send_headers (count);
+  }
+
+  std::size_t UdpSocket::Impl::send_headers (std::size_t count) {
+    // sendmmsg may stop early; a hard error on one datagram skips just that one
+    std::size_t sent = 0;
+    while (sent < count) {
+      ++stats.send_calls;
+      const int result = ::sendmmsg (socket.native_handle (), headers.data () + sent,
+          static_cast<unsigned int> (count - sent), MSG_DONTWAIT);
+      if (result > 0) {
+        sent += static_cast<std::size_t> (result);
+        continue;
+      }
+      if (errno == EINTR) {
+        continue;
+      }
+      ++stats.send_failures;
+      if (errno == EAGAIN) { // Same value as EWOULDBLOCK on Linux
+        break; // Kernel buffer full: the rest are dropped like any lost datagram
+      }
+      ++sent;
+    }
+    return sent;
+  }
+#endif
+
+  template<typename Batch>
+  std::size_t UdpSocket::Impl::receive_loop (Batch& batch) {
+    std::size_t count = 0;
+    while (count < batch.capacity ()) {
+      asio::error_code error;
+      ++stats.receive_calls;
+      const std::size_t length = socket.receive_from (
+          asio::buffer (batch.slot (count), batch.max_datagram_size ()), batch.slot_endpoint (count), 0, error);
+      if (error) {
+        break;
+      }
+      batch.set_slot_length (count, length);
+      ++count;
+    }
+    batch.set_size (count);
+    return count;
+  }
+
+  std::size_t UdpSocket::Impl::send_loop (const DatagramBatch& batch) {
+    std::size_t sent = 0;
+    for (std::size_t i = 0; i < batch.size (); ++i) {
+      asio::error_code error;
+      ++stats.send_calls;
+      const auto payload = batch.data (i);
+      socket.send_to (asio::buffer (payload.data (), payload.size ()), batch.endpoint (i), 0, error);
+      if (error) {
+        ++stats.send_failures;
+        continue;
+      }
+      ++sent;
+    }
+    return sent;
+  }
+
+#ifndef OMNICPP_HAS_MMSG
+  std::size_t UdpSocket::Impl::send_gather_loop (const GatherBatch& batch) {
+    std::size_t sent = 0;
+    for (std::size_t i = 0; i < batch.size (); ++i) {
+      gather_buffers.clear ();
+      const auto header = batch.header (i);
+      gather_buffers.push_back (asio::buffer (header.data (), header.size ()));
+      for (const auto& segment : batch.segments (i)) {
+        gather_buffers.push_back (asio::buffer (segment.data (), segment.size ()));
+      }
+      asio::error_code error;
+      ++stats.send_calls;
+      socket.send_to (gather_buffers, batch.endpoint (i), 0, error);
+      if (error) {
+        ++stats.send_failures;
+        continue;
+      }
+      ++sent;
+    }
+    return sent;
+  }
+#endif
+
+  UdpSocket::UdpSocket () : m_impl (std::make_unique<Impl> ()) {
+  }
+
+  UdpSocket::~UdpSocket () {
+    if (m_impl) {
+      close ();
+    }
+  }
+
+  UdpSocket::UdpSocket (UdpSocket&& other) noexcept : m_impl (std::move (other.m_impl)) {
+  }
+
+  UdpSocket& UdpSocket::operator= (UdpSocket&& other) noexcept {
+    if (this != &other) {
+      m_impl = std::move (other.m_impl);
+    }
+    return *this;
+  }
+
+  bool UdpSocket::open (uint16_t port, const std::string& bind_address, std::size_t buffer_size) {
+    if (m_impl->socket.is_open ()) {
+      omnicpp::log::warn ("UdpSocket: Already open");
+      return true;
+    }
+
+    asio::error_code error;
+    const auto address = asio::ip::make_address_v4 (bind_address, error);
+    if (error) {
+      omnicpp::log::error ("UdpSocket: Invalid bind address '{}': {}", bind_address, error.message ());
+      return false;
+    }
+
+    auto& socket = m_impl->socket;
+    socket.open (asio::ip::udp::v4 (), error);
+    if (!error && buffer_size > 0) {
+      socket.set_option (asio::socket_base::receive_buffer_size (static_cast<int> (buffer_size)), error);
+      socket.set_option (asio::socket_base::send_buffer_size (static_cast<int> (buffer_size)), error);
+      error.clear (); // Kernel limits may cap these; not fatal
+    }
+    if (!error) {
+      socket.bind (Endpoint (address, port), error);
+    }
+    if (!error) {
+      socket.non_blocking (true, error);
+    }
+    if (error) {
+      omnicpp::log::error ("UdpSocket: Failed to bind {}:{}: {}", bind_address, port, error.message ());
+      socket.close (error);
+      return false;
+    }
+
+    omnicpp::log::info ("UdpSocket: Bound to {}:{}", bind_address, get_local_port ());
+    return true;
+  }
+
+  void UdpSocket::close () {
+    asio::error_code error;
+    m_impl->socket.close (error);
+  }
+
+  bool UdpSocket::is_open () const {
+    return m_impl->socket.is_open ();
+  }
+
+  std::size_t UdpSocket::receive (DatagramBatch& batch) {
+    batch.clear ();
+    if (!m_impl->socket.is_open ()) {
+      return 0;
+    }
+#ifdef OMNICPP_HAS_MMSG
+    const std::size_t count = m_impl->receive_batched (batch);
+#else
+    const std::size_t count = m_impl->receive_loop (batch);
+#endif
+    m_impl->stats.datagrams_received += count;
+    return count;
+  }
+
+  std::size_t UdpSocket::receive (ReceiveBatch& batch) {
+    batch.prepare ();
+    if (!m_impl->socket.is_open ()) {
+      return 0;
+    }
+#ifdef OMNICPP_HAS_MMSG
+    const std::size_t count = m_impl->receive_batched (batch);
+#else
+    const std::size_t count = m_impl->receive_loop (batch);
+#endif
+    m_impl->stats.datagrams_received += count;
+    return count;
+  }
+
+  std::size_t UdpSocket::send (const GatherBatch& batch) {
+    if (!m_impl->socket.is_open () || batch.size () == 0) {
+      return 0;
+    }
+#ifdef OMNICPP_HAS_MMSG
+    const std::size_t sent = m_impl->send_gathered (batch);
+#else
+    const std::size_t sent = m_impl->send_gather_loop (batch);
+#endif
+    m_impl->stats.datagrams_sent += sent;
+    return sent;
+  }
+
+  std::size_t UdpSocket::send (const DatagramBatch& batch) {
+    if (!m_impl->socket.is_open () || batch.size () == 0) {
+      return 0;
+    }
+#ifdef OMNICPP_HAS_MMSG
+    const std::size_t sent = m_impl->send_batched (batch);
+#else
+    const std::size_t sent = m_impl->send_loop (batch);
+#endif
+    m_impl->stats.datagrams_sent += sent;
+    return sent;
+  }
+
+  bool UdpSocket::resolve (const std::string& host, uint16_t port, Endpoint& out) {
+    asio::error_code error;
+    asio::ip::udp::resolver resolver (m_impl->context);
+    const auto results = resolver.resolve (asio::ip::udp::v4 (), host, std::to_string (port), error);
+    if (error || results.empty ()) {
+      omnicpp::log::error ("UdpSocket: Failed to resolve {}:{}: {}", host, port, error.message ());
+      return false;
+    }
+    out = results.begin ()->endpoint ();
+    return true;
+  }
+
+  uint16_t UdpSocket::get_local_port () const {
+    asio::error_code error;
+    const auto endpoint = m_impl->socket.local_endpoint (error);
+    return error ? 0 : endpoint.port ();
+  }
+
+  const UdpSocketStats& UdpSocket::get_stats () const {
+    return m_impl->stats;
+  }
+
+} // namespace OmniCpp::Engine::Network
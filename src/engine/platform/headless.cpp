@@ -0,0 +1,164 @@
+/**
+ * @file headless.cpp
+ * @brief Null renderer and audio backend implementation
+ */
+
+#include "engine/platform/headless.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include "engine/logging/Log.hpp"
+
+namespace OmniCpp::Engine::Platform {
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct NullRenderer::Impl {
+    NullRendererConfig config;
+    Graphics::FrameCaptureRing frame_capture;
+    std::atomic<uint32_t> frame_number{ 0 };
+    bool in_frame{ false };
+    bool initialized{ false };
+
+    void capture_frame ();
+  };
+
+  void NullRenderer::Impl::capture_frame () {
+    const auto capture_start = std::chrono::steady_clock::now ();
+    if (auto slot = frame_capture.begin_capture (frame_number.load (std::memory_order_relaxed))) {
+      const std::size_t pitch = static_cast<std::size_t> (config.width) * 4;
+      uint8_t* pixels = frame_capture.host_slot (*slot, pitch * config.height);
+      if (pixels == nullptr) {
+        frame_capture.cancel_capture (*slot);
+        return;
+      }
+      for (std::size_t i = 0; i < pitch * config.height; i += 4) {
+        std::copy (config.clear_color.begin (), config.clear_color.end (), pixels + i);
+      }
+      frame_capture.complete_capture (*slot, pixels, config.width, config.height, pitch,
+          Graphics::CapturePixelFormat::RGBA8);
+    }
+    frame_capture.note_render_thread_cost (static_cast<uint64_t> (
+        std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - capture_start)
+            .count ()));
+  }
+
+  NullRenderer::NullRenderer (const NullRendererConfig& config) : m_impl (std::make_unique<Impl> ()) {
+    m_impl->config = config;
+  }
+
+  NullRenderer::~NullRenderer () {
+    shutdown ();
+  }
+
+  bool NullRenderer::initialize () {
+    if (m_impl->initialized) {
+      omnicpp::log::warn ("NullRenderer: Already initialized");
+      return true;
+    }
+    if (m_impl->config.enable_frame_capture && !m_impl->frame_capture.initialize (m_impl->config.capture)) {
+      omnicpp::log::warn ("NullRenderer: Frame capture disabled");
+    }
+    m_impl->initialized = true;
+    omnicpp::log::info ("NullRenderer: Initialized (headless)");
+    return true;
+  }
+
+  void NullRenderer::shutdown () {
+    m_impl->frame_capture.shutdown ();
+    m_impl->initialized = false;
+  }
+
+  bool NullRenderer::begin_frame () {
+    if (!m_impl->initialized || m_impl->in_frame) {
+      return false;
+    }
+    m_impl->in_frame = true;
+    return true;
+  }
+
+  void NullRenderer::end_frame () {
+    if (!m_impl->in_frame) {
+      return;
+    }
+    m_impl->in_frame = false;
+    if (m_impl->frame_capture.is_capture_armed ()) {
+      m_impl->capture_frame ();
+    }
+    m_impl->frame_number.fetch_add (1, std::memory_order_relaxed);
+  }
+
+  uint32_t NullRenderer::get_frame_number () const {
+    return m_impl->frame_number.load (std::memory_order_relaxed);
+  }
+
+  void NullRenderer::request_frame_capture (uint32_t frame_count) {
+    if (m_impl->frame_capture.get_ring_size () == 0) {
+      omnicpp::log::warn ("NullRenderer: Frame capture not enabled");
+      return;
+    }
+    m_impl->frame_capture.request_capture (frame_count);
+  }
+
+  Graphics::FrameCaptureRing& NullRenderer::get_frame_capture () {
+    return m_impl->frame_capture;
+  }
+
+  /**
+   * @brief Private implementation structure (Pimpl idiom)
+   */
+  struct NullAudioManager::Impl {
+    uint32_t next_sound_id{ 1 };
+    float master_volume{ 1.0f };
+    bool initialized{ false };
+  };
+
+  NullAudioManager::NullAudioManager () : m_impl (std::make_unique<Impl> ()) {
+  }
+
+  NullAudioManager::~NullAudioManager () {
+    shutdown ();
+  }
+
+  bool NullAudioManager::initialize () {
+    if (m_impl->initialized) {
+      omnicpp::log::warn ("NullAudioManager: Already initialized");
+      return true;
+    }
+    m_impl->initialized = true;
+    omnicpp::log::info ("NullAudioManager: Initialized (headless)");
+    return true;
+  }
+
+  void NullAudioManager::shutdown () {
+    m_impl->initialized = false;
+  }
+
+  uint32_t NullAudioManager::load_sound (const char* file_path) {
+    if (!m_impl->initialized || file_path == nullptr) {
+      return 0;
+    }
+    return m_impl->next_sound_id++;
+  }
+
+  bool NullAudioManager::play_sound (uint32_t sound_id) {
+    return m_impl->initialized && sound_id != 0 && sound_id < m_impl->next_sound_id;
+  }
+
+  bool NullAudioManager::stop_sound (uint32_t sound_id) {
+    return play_sound (sound_id);
+  }
+
+  void NullAudioManager::set_master_volume (float volume) {
+    m_impl->master_volume = std::clamp (volume, 0.0f, 1.0f);
+  }
+
+  float NullAudioManager::get_master_volume () const {
+    return m_impl->master_volume;
+  }
+
+  void NullAudioManager::update (float) {
+  }
+
+} // namespace OmniCpp::Engine::Platform
@@ -4,30 +4,455 @@
  */
 
 #include "engine/scripting/ScriptManager.hpp"
-#include <mutex>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include "engine/logging/Log.hpp"
 
+#if defined(OMNICPP_HAS_LUA)
+  #include "engine/scripting/LuaBindings.hpp"
+extern "C" {
+  #include <lualib.h>
+}
+#endif
+
 namespace omnicpp {
 namespace scripting {
 
+  namespace {
+
+    constexpr int NO_REF = -2; // LUA_NOREF, usable without the Lua headers
+
+    /**
+     * @brief FNV-1a over the source, seeded with whatever changes the bytecode for the same text
+     */
+    uint64_t hash_source (std::string_view source, uint64_t seed) {
+      uint64_t hash = 14695981039346656037ull ^ seed;
+      for (const char c : source) {
+        hash ^= static_cast<unsigned char> (c);
+        hash *= 1099511628211ull;
+      }
+      return hash;
+    }
+
+    bool read_file (const std::filesystem::path& path, std::string& out) {
+      std::ifstream file (path, std::ios::binary);
+      if (!file) {
+        return false;
+      }
+      std::ostringstream contents;
+      contents << file.rdbuf ();
+      out = std::move (contents).str ();
+      return true;
+    }
+
+#if defined(OMNICPP_HAS_LUA)
+    constexpr const char* COLUMN_TABLE = "omnicpp.ColumnTable";
+
+    int64_t now_ns () {
+      return std::chrono::duration_cast<std::chrono::nanoseconds> (
+          std::chrono::steady_clock::now ().time_since_epoch ())
+          .count ();
+    }
+
+    int append_chunk (lua_State*, const void* data, std::size_t size, void* user) {
+      static_cast<std::string*> (user)->append (static_cast<const char*> (data), size);
+      return 0;
+    }
+
+    // --- Column tables: call_with_columns copies each view into a reused Lua table ---
+    // Indexing a table stays inside the VM; a metamethod per element access
+    // costs more than the copy. The copies run per element type with no
+    // per-element dispatch, and nothing is cleared that the next call
+    // overwrites anyway.
+
+    constexpr int PULL_CHUNK = 32; // Elements fetched onto the stack before converting, popped in one call
+
+    int column_out_of_range (lua_State* state) {
+      return luaL_argerror (state, 2, "index out of range");
+    }
+
+    int column_read_only (lua_State* state) {
+      return luaL_argerror (state, 1, "read-only view");
+    }
+
+    int column_length (lua_State* state) {
+      lua_pushinteger (state, static_cast<lua_Integer> (lua_rawlen (state, lua_upvalueindex (1))));
+      return 1;
+    }
+
+    /**
+     * @brief Store data[0, size) at keys 1..size of the table on top of the stack
+     */
+    template <typename T>
+    void push_elements (lua_State* state, const T* data, std::size_t size) {
+      for (std::size_t i = 0; i < size; ++i) {
+        if constexpr (std::is_floating_point_v<T>) {
+          lua_pushnumber (state, static_cast<lua_Number> (data[i]));
+        } else {
+          lua_pushinteger (state, static_cast<lua_Integer> (data[i]));
+        }
+        lua_rawseti (state, -2, static_cast<lua_Integer> (i + 1));
+      }
+    }
+
+    void push_elements (lua_State* state, const ArrayView& view) {
+      switch (view.type) {
+        case ElementType::Float32: push_elements (state, static_cast<const float*> (view.data), view.size); break;
+        case ElementType::Float64: push_elements (state, static_cast<const double*> (view.data), view.size); break;
+        case ElementType::Int32: push_elements (state, static_cast<const int32_t*> (view.data), view.size); break;
+        case ElementType::UInt32: push_elements (state, static_cast<const uint32_t*> (view.data), view.size); break;
+        case ElementType::Int64: push_elements (state, static_cast<const int64_t*> (view.data), view.size); break;
+        case ElementType::UInt8: push_elements (state, static_cast<const uint8_t*> (view.data), view.size); break;
+      }
+    }
+
+    /**
+     * @brief Copy keys 1..size of the table on top of the stack into data; false if any is not a number
+     *
+     * A non-number leaves its element unchanged; the rest still land.
+     */
+    template <typename T>
+    bool pull_elements (lua_State* state, T* data, std::size_t size) {
+      const int table = lua_gettop (state);
+      const std::size_t chunk = lua_checkstack (state, PULL_CHUNK) ? PULL_CHUNK : 1;
+      bool numeric = true;
+      for (std::size_t start = 0; start < size; start += chunk) {
+        const int count = static_cast<int> (std::min (chunk, size - start));
+        for (int j = 0; j < count; ++j) {
+          lua_rawgeti (state, table, static_cast<lua_Integer> (start + static_cast<std::size_t> (j) + 1));
+        }
+        for (int j = 0; j < count; ++j) {
+          int ok = 0;
+          if constexpr (std::is_floating_point_v<T>) {
+            const lua_Number value = lua_tonumberx (state, table + 1 + j, &ok);
+            if (ok) {
+              data[start + static_cast<std::size_t> (j)] = static_cast<T> (value);
+            }
+          } else {
+            const lua_Integer value = lua_tointegerx (state, table + 1 + j, &ok);
+            if (ok) {
+              data[start + static_cast<std::size_t> (j)] = static_cast<T> (value);
+            }
+          }
+          numeric = numeric && ok != 0;
+        }
+        lua_settop (state, table);
+      }
+      return numeric;
+    }
+
+    bool pull_elements (lua_State* state, const ArrayView& view) {
+      switch (view.type) {
+        case ElementType::Float32: return pull_elements (state, static_cast<float*> (view.data), view.size);
+        case ElementType::Float64: return pull_elements (state, static_cast<double*> (view.data), view.size);
+        case ElementType::Int32: return pull_elements (state, static_cast<int32_t*> (view.data), view.size);
+        case ElementType::UInt32: return pull_elements (state, static_cast<uint32_t*> (view.data), view.size);
+        case ElementType::Int64: return pull_elements (state, static_cast<int64_t*> (view.data), view.size);
+        case ElementType::UInt8: return pull_elements (state, static_cast<uint8_t*> (view.data), view.size);
+      }
+      return true;
+    }
+#endif
+
+  } // namespace
+
   /**
    * @brief Private implementation structure (Pimpl idiom)
    */
   struct ScriptManager::Impl {
     struct ScriptInfo {
       std::string path;
+      uint64_t hash{ 0 };
+      int chunk{ NO_REF }; // Registry reference to the compiled top-level function
     };
     std::unordered_map<std::string, ScriptInfo> scripts;
-    std::mutex mutex;
+    std::unordered_map<uint64_t, std::string> bytecode; // Source hash -> lua_dump output
+    struct Task {
+      TaskId id{ INVALID_TASK };
+      int thread_ref{ NO_REF }; // Keeps the coroutine alive
+      lua_State* thread{ nullptr };
+    };
+    std::vector<FunctionRef> update_callbacks;
+    std::vector<Task> tasks;
+    std::size_t task_cursor{ 0 }; // Round-robin start, so a preempted task does not starve the rest
+    TaskId next_task{ 1 };
+    struct ColumnTable {
+      int table_ref{ NO_REF }; // Holds the elements during a call
+      int proxy_ref{ NO_REF }; // Read-only face of the same table
+      int live_ref{ NO_REF };  // The proxy's metatable while a call runs
+      std::size_t size{ 0 };   // Elements the table holds
+    };
+    std::vector<ColumnTable> column_tables; // Reused by call_with_columns, one per column position
+    ScriptConfig config;
+    ScriptStats stats;
+    lua_State* state{ nullptr };
+    lua_State* running_task{ nullptr };
+    int64_t deadline_ns{ 0 };     // 0 while no budget is armed
     bool initialized{ false };
+
+#if defined(OMNICPP_HAS_LUA)
+    uint64_t seed () const {
+      return static_cast<uint64_t> (LUA_VERSION_NUM) << 1 | (config.strip_debug_info ? 1u : 0u);
+    }
+
+    std::filesystem::path cache_path (uint64_t hash) const {
+      char name[32];
+      std::snprintf (name, sizeof (name), "%016llx.luac", static_cast<unsigned long long> (hash));
+      return std::filesystem::path (config.bytecode_cache_dir) / name;
+    }
+
+    bool load_bytecode (const std::string& code, const std::string& chunk_name) {
+      if (luaL_loadbufferx (state, code.data (), code.size (), chunk_name.c_str (), "b") == LUA_OK) {
+        return true;
+      }
+      lua_pop (state, 1); // Built by another Lua version or truncated: recompile
+      return false;
+    }
+
+    void store_bytecode (uint64_t hash, const std::string& code) const {
+      if (config.bytecode_cache_dir.empty ()) {
+        return;
+      }
+      // Write then rename, so a crash or a concurrent run never leaves a torn chunk behind
+      const std::filesystem::path path = cache_path (hash);
+      std::filesystem::path temporary = path;
+      temporary += ".tmp";
+      {
+        std::ofstream file (temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write (code.data (), static_cast<std::streamsize> (code.size ()))) {
+          omnicpp::log::warn ("ScriptManager: Cannot write bytecode cache '{}'", temporary.string ());
+          return;
+        }
+      }
+      std::error_code error;
+      std::filesystem::rename (temporary, path, error);
+      if (error) {
+        omnicpp::log::warn ("ScriptManager: Cannot write bytecode cache '{}': {}", path.string (), error.message ());
+      }
+    }
+
+    /**
+     * @brief Leave the compiled chunk for `source` on the stack, from the cheapest source available
+     */
+    bool compile (const std::string& name, const std::string& chunk_name, const std::string& source,
+        uint64_t hash) {
+      if (auto it = bytecode.find (hash); it != bytecode.end ()) {
+        if (load_bytecode (it->second, chunk_name)) {
+          ++stats.memory_hits;
+          return true;
+        }
+        bytecode.erase (it);
+      }
+      if (!config.bytecode_cache_dir.empty ()) {
+        std::string code;
+        if (read_file (cache_path (hash), code) && load_bytecode (code, chunk_name)) {
+          ++stats.disk_hits;
+          bytecode.emplace (hash, std::move (code));
+          return true;
+        }
+      }
+
+      if (luaL_loadbufferx (state, source.data (), source.size (), chunk_name.c_str (), "t") != LUA_OK) {
+        ++stats.errors;
+        omnicpp::log::error ("ScriptManager: Failed to compile '{}': {}", name, lua_tostring (state, -1));
+        lua_pop (state, 1);
+        return false;
+      }
+      ++stats.compiles;
+      std::string code;
+      lua_dump (state, append_chunk, &code, config.strip_debug_info ? 1 : 0);
+      store_bytecode (hash, code);
+      bytecode[hash] = std::move (code);
+      return true;
+    }
+
+    bool load (const std::string& name, const std::string& path, const std::string& chunk_name,
+        const std::string& source) {
+      const uint64_t hash = hash_source (source, seed ());
+      if (!compile (name, chunk_name, source, hash)) {
+        return false;
+      }
+      const int chunk = luaL_ref (state, LUA_REGISTRYINDEX);
+      auto [it, inserted] = scripts.try_emplace (name);
+      if (!inserted) {
+        luaL_unref (state, LUA_REGISTRYINDEX, it->second.chunk); // Reload replaces the old chunk
+      }
+      it->second = ScriptInfo{ path, hash, chunk };
+      omnicpp::log::debug ("ScriptManager: Loaded script '{}' from '{}'", name, path.empty () ? "memory" : path);
+      return true;
+    }
+
+    /**
+     * @brief Arms a deadline for the outermost entry into Lua
+     */
+    struct Budget {
+      Impl& impl;
+      bool armed;
+
+      Budget (Impl& owner, uint32_t budget_us) : impl (owner), armed (owner.deadline_ns == 0) {
+        if (armed) {
+          impl.deadline_ns = now_ns () + static_cast<int64_t> (budget_us) * 1000;
+        }
+      }
+      ~Budget () {
+        if (armed) {
+          impl.deadline_ns = 0;
+        }
+      }
+    };
+
+    /**
+     * @brief Count hook: preempt the running task, or abort whatever else overran
+     */
+    static void budget_hook (lua_State* thread, lua_Debug*) {
+      Impl& impl = **static_cast<Impl**> (lua_getextraspace (thread));
+      if (impl.deadline_ns == 0) {
+        return;
+      }
+      const int64_t now = now_ns ();
+      if (now < impl.deadline_ns) {
+        return;
+      }
+      if (thread == impl.running_task) {
+        if (lua_isyieldable (thread)) {
+          ++impl.stats.preemptions;
+          lua_yield (thread, 0); // From a hook this marks the yield; it happens when the hook returns
+          return;
+        }
+        // Under a C call (a sort comparator, say): yield at the next hook outside it, within a grace period
+        if (now < impl.deadline_ns + static_cast<int64_t> (impl.config.frame_budget_us) * 1000) {
+          return;
+        }
+      }
+      ++impl.stats.budget_overruns;
+      luaL_error (thread, "script exceeded its time budget");
+    }
+
+    void register_column_table () {
+      luaL_newmetatable (state, COLUMN_TABLE); // Only consulted for keys the table lacks
+      lua_pushcfunction (state, column_out_of_range);
+      lua_setfield (state, -2, "__index");
+      lua_pushcfunction (state, column_out_of_range);
+      lua_setfield (state, -2, "__newindex");
+      lua_pop (state, 1);
+    }
+
+    /**
+     * @brief Fill the reusable table for a call_with_columns column and push it (or its read-only proxy)
+     */
+    void push_column (std::size_t index, const ArrayView& view) {
+      while (column_tables.size () <= index) {
+        ColumnTable column;
+        lua_createtable (state, 0, 0);
+        luaL_setmetatable (state, COLUMN_TABLE);
+        lua_createtable (state, 0, 0); // Proxy: always empty, so every access reaches its metatable
+        lua_createtable (state, 0, 3);
+        lua_pushvalue (state, -3);
+        lua_setfield (state, -2, "__index");
+        lua_pushcfunction (state, column_read_only);
+        lua_setfield (state, -2, "__newindex");
+        lua_pushvalue (state, -3);
+        lua_pushcclosure (state, column_length, 1);
+        lua_setfield (state, -2, "__len");
+        column.live_ref = luaL_ref (state, LUA_REGISTRYINDEX);
+        column.proxy_ref = luaL_ref (state, LUA_REGISTRYINDEX);
+        column.table_ref = luaL_ref (state, LUA_REGISTRYINDEX);
+        column_tables.push_back (column);
+      }
+      ColumnTable& column = column_tables[index];
+      lua_rawgeti (state, LUA_REGISTRYINDEX, column.table_ref);
+      push_elements (state, view);
+      for (std::size_t i = view.size; i < column.size; ++i) { // Left over from a longer call
+        lua_pushnil (state);
+        lua_rawseti (state, -2, static_cast<lua_Integer> (i + 1));
+      }
+      column.size = view.size;
+      if (!view.writable) {
+        lua_pop (state, 1);
+        lua_rawgeti (state, LUA_REGISTRYINDEX, column.proxy_ref);
+        lua_rawgeti (state, LUA_REGISTRYINDEX, column.live_ref);
+        lua_setmetatable (state, -2);
+      }
+    }
+
+    /**
+     * @brief Copy a writable column back into its view, or cut a read-only one's proxy off from the table
+     *
+     * The table itself keeps its elements until the next call overwrites
+     * them. Returns false if the script stored something other than a number.
+     */
+    bool pull_column (std::size_t index, const ArrayView& view) {
+      const ColumnTable& column = column_tables[index];
+      if (!view.writable) {
+        lua_rawgeti (state, LUA_REGISTRYINDEX, column.proxy_ref);
+        luaL_setmetatable (state, COLUMN_TABLE); // Every access out of range, length 0
+        lua_pop (state, 1);
+        return true;
+      }
+      lua_rawgeti (state, LUA_REGISTRYINDEX, column.table_ref);
+      const bool numeric = pull_elements (state, view);
+      lua_pop (state, 1);
+      return numeric;
+    }
+
+    void finish_task (std::size_t index) {
+      luaL_unref (state, LUA_REGISTRYINDEX, tasks[index].thread_ref);
+      tasks.erase (tasks.begin () + static_cast<std::ptrdiff_t> (index));
+    }
+
+    void resume_tasks (float delta_time) {
+      const std::size_t count = tasks.size ();
+      for (std::size_t n = 0; n < count && !tasks.empty () && now_ns () < deadline_ns; ++n) {
+        if (task_cursor >= tasks.size ()) {
+          task_cursor = 0;
+        }
+        lua_State* thread = tasks[task_cursor].thread;
+        lua_pushnumber (thread, delta_time); // First resume: the argument; later: what coroutine.yield() returns
+        int results = 0;
+        running_task = thread;
+        const int status = lua_resume (thread, state, 1, &results);
+        running_task = nullptr;
+        if (status == LUA_YIELD) {
+          lua_pop (thread, results);
+          ++task_cursor;
+          continue;
+        }
+        if (status == LUA_OK) {
+          ++stats.tasks_completed;
+        } else {
+          ++stats.errors;
+          omnicpp::log::error ("ScriptManager: Task {} failed: {}", tasks[task_cursor].id, lua_tostring (thread, -1));
+        }
+        finish_task (task_cursor);
+      }
+    }
+
+    bool run (int nargs, const std::string& what) {
+      if (lua_pcall (state, nargs, 0, 0) == LUA_OK) {
+        return true;
+      }
+      ++stats.errors;
+      omnicpp::log::error ("ScriptManager: Error in '{}': {}", what, lua_tostring (state, -1));
+      lua_pop (state, 1);
+      return false;
+    }
+#endif
   };
 
   ScriptManager::ScriptManager () : m_impl (std::make_unique<Impl> ()) {
   }
 
   ScriptManager::~ScriptManager () {
-    shutdown ();
+    if (m_impl) {
+      shutdown ();
+    }
   }
 
   ScriptManager::ScriptManager (ScriptManager&& other) noexcept
@@ -41,15 +466,31 @@ namespace scripting {
     return *this;
   }
 
-  bool ScriptManager::initialize () {
-    std::lock_guard<std::mutex> lock (m_impl->mutex);
-
+  bool ScriptManager::initialize (const ScriptConfig& config) {
     if (m_impl->initialized) {
       omnicpp::log::warn("ScriptManager: Already initialized");
       return true;
     }
 
+    m_impl->config = config;
     m_impl->scripts.clear ();
+#if defined(OMNICPP_HAS_LUA)
+    m_impl->state = luaL_newstate ();
+    if (!m_impl->state) {
+      omnicpp::log::error("ScriptManager: Failed to create Lua state");
+      return false;
+    }
+    luaL_openlibs (m_impl->state);
+    *static_cast<Impl**> (lua_getextraspace (m_impl->state)) = m_impl.get (); // Inherited by every coroutine
+    lua_sethook (m_impl->state, Impl::budget_hook, LUA_MASKCOUNT, static_cast<int> (std::max (config.hook_interval, 1u)));
+    m_impl->register_column_table ();
+    if (!config.bytecode_cache_dir.empty ()) {
+      std::error_code error;
+      std::filesystem::create_directories (config.bytecode_cache_dir, error);
+    }
+#else
+    omnicpp::log::warn("ScriptManager: Built without Lua (OMNICPP_USE_LUA=OFF); scripts will not load");
+#endif
     m_impl->initialized = true;
 
     omnicpp::log::info("ScriptManager: Initialized");
@@ -57,40 +498,80 @@ namespace scripting {
   }
 
   void ScriptManager::shutdown () {
-    std::lock_guard<std::mutex> lock (m_impl->mutex);
-
     if (!m_impl->initialized) {
       return;
     }
 
+#if defined(OMNICPP_HAS_LUA)
+    lua_close (m_impl->state); // Releases every registry reference with it
+#endif
+    m_impl->state = nullptr;
     m_impl->scripts.clear ();
+    m_impl->bytecode.clear ();
+    m_impl->update_callbacks.clear ();
+    m_impl->tasks.clear ();
+    m_impl->column_tables.clear ();
+    m_impl->deadline_ns = 0;
     m_impl->initialized = false;
 
     omnicpp::log::info("ScriptManager: Shutdown");
   }
 
   void ScriptManager::update (float delta_time) {
-    std::lock_guard<std::mutex> lock (m_impl->mutex);
-    // Update scripts here
+#if defined(OMNICPP_HAS_LUA)
+    Impl& impl = *m_impl;
+    if (!impl.initialized) {
+      return;
+    }
+    Impl::Budget budget (impl, impl.config.frame_budget_us);
+    // By index: a callback may register or release callbacks through a binding
+    for (std::size_t i = 0; i < impl.update_callbacks.size (); ++i) {
+      if (now_ns () >= impl.deadline_ns) {
+        impl.stats.skipped_callbacks += impl.update_callbacks.size () - i;
+        break;
+      }
+      if (!lua::call (impl.state, impl.update_callbacks[i], delta_time)) {
+        ++impl.stats.errors;
+      }
+    }
+    impl.resume_tasks (delta_time);
+#else
+    (void) delta_time;
+#endif
   }
 
   bool ScriptManager::load_script (const std::string& name, const std::string& path) {
-    std::lock_guard<std::mutex> lock (m_impl->mutex);
-
     if (!m_impl->initialized) {
       omnicpp::log::error("ScriptManager: Not initialized, cannot load script: {}", name);
       return false;
     }
 
-    Impl::ScriptInfo info{ path };
-    m_impl->scripts[name] = info;
-    omnicpp::log::debug("ScriptManager: Loaded script '{}' from '{}'", name, path);
-    return true;
+    std::string source;
+    if (!read_file (path, source)) {
+      omnicpp::log::error("ScriptManager: Cannot read script '{}' from '{}'", name, path);
+      return false;
+    }
+#if defined(OMNICPP_HAS_LUA)
+    return m_impl->load (name, path, "@" + path, source);
+#else
+    return false;
+#endif
   }
 
-  bool ScriptManager::unload_script (const std::string& name) {
-    std::lock_guard<std::mutex> lock (m_impl->mutex);
+  bool ScriptManager::load_script_source (const std::string& name, const std::string& source) {
+    if (!m_impl->initialized) {
+      omnicpp::log::error("ScriptManager: Not initialized, cannot load script: {}", name);
+      return false;
+    }
+#if defined(OMNICPP_HAS_LUA)
+    return m_impl->load (name, {}, "=" + name, source);
+#else
+    (void) source;
+    return false;
+#endif
+  }
 
+  bool ScriptManager::unload_script (const std::string& name) {
     if (!m_impl->initialized) {
       omnicpp::log::error("ScriptManager: Not initialized, cannot unload script: {}", name);
       return false;
@@ -98,6 +579,9 @@ namespace scripting {
 
     auto it = m_impl->scripts.find (name);
     if (it != m_impl->scripts.end ()) {
+#if defined(OMNICPP_HAS_LUA)
+      luaL_unref (m_impl->state, LUA_REGISTRYINDEX, it->second.chunk);
+#endif
       m_impl->scripts.erase (it);
       omnicpp::log::debug("ScriptManager: Unloaded script '{}'", name);
       return true;
@@ -107,20 +591,196 @@ namespace scripting {
   }
 
   bool ScriptManager::execute_script (const std::string& name) {
-    std::lock_guard<std::mutex> lock (m_impl->mutex);
-
     if (!m_impl->initialized) {
       omnicpp::log::error("ScriptManager: Not initialized, cannot execute script: {}", name);
       return false;
     }
 
     auto it = m_impl->scripts.find (name);
-    if (it != m_impl->scripts.end ()) {
-      omnicpp::log::debug("ScriptManager: Executing script '{}'", name);
-      return true;
+    if (it == m_impl->scripts.end ()) {
+      omnicpp::log::warn("ScriptManager: Script '{}' not found", name);
+      return false;
     }
-    omnicpp::log::warn("ScriptManager: Script '{}' not found", name);
+    omnicpp::log::debug("ScriptManager: Executing script '{}'", name);
+#if defined(OMNICPP_HAS_LUA)
+    Impl::Budget budget (*m_impl, m_impl->config.call_budget_us);
+    lua_rawgeti (m_impl->state, LUA_REGISTRYINDEX, it->second.chunk);
+    return m_impl->run (0, name);
+#else
+    return false;
+#endif
+  }
+
+  bool ScriptManager::call_function (const std::string& function_name, const std::vector<std::string>& args) {
+    if (!m_impl->initialized) {
+      omnicpp::log::error("ScriptManager: Not initialized, cannot call function: {}", function_name);
+      return false;
+    }
+#if defined(OMNICPP_HAS_LUA)
+    lua_State* state = m_impl->state;
+    if (lua_getglobal (state, function_name.c_str ()) != LUA_TFUNCTION) {
+      lua_pop (state, 1);
+      omnicpp::log::warn("ScriptManager: Function '{}' not found", function_name);
+      return false;
+    }
+    for (const std::string& arg : args) {
+      lua_pushlstring (state, arg.data (), arg.size ());
+    }
+    Impl::Budget budget (*m_impl, m_impl->config.call_budget_us);
+    return m_impl->run (static_cast<int> (args.size ()), function_name);
+#else
+    (void) args;
+    return false;
+#endif
+  }
+
+  void ScriptManager::register_function (const std::string& name, NativeFunction function, void* context) {
+    if (!m_impl->initialized || !function) {
+      omnicpp::log::error("ScriptManager: Cannot register function: {}", name);
+      return;
+    }
+#if defined(OMNICPP_HAS_LUA)
+    lua_State* state = m_impl->state;
+    if (context) {
+      lua_pushlightuserdata (state, context);
+      lua_pushcclosure (state, function, 1);
+    } else {
+      lua_pushcfunction (state, function);
+    }
+    lua_setglobal (state, name.c_str ());
+#else
+    (void) context;
+#endif
+  }
+
+  FunctionRef ScriptManager::resolve (const std::string& function_name) {
+    if (!m_impl->initialized) {
+      return {};
+    }
+#if defined(OMNICPP_HAS_LUA)
+    lua_State* state = m_impl->state;
+    if (lua_getglobal (state, function_name.c_str ()) != LUA_TFUNCTION) {
+      lua_pop (state, 1);
+      omnicpp::log::warn("ScriptManager: Function '{}' not found", function_name);
+      return {};
+    }
+    return FunctionRef{ luaL_ref (state, LUA_REGISTRYINDEX) };
+#else
+    (void) function_name;
+    return {};
+#endif
+  }
+
+  void ScriptManager::release (FunctionRef& function) {
+    if (!m_impl->initialized || !function.valid ()) {
+      return;
+    }
+    auto& callbacks = m_impl->update_callbacks;
+    callbacks.erase (std::remove_if (callbacks.begin (), callbacks.end (),
+                         [&] (const FunctionRef& callback) { return callback.ref == function.ref; }),
+        callbacks.end ());
+#if defined(OMNICPP_HAS_LUA)
+    luaL_unref (m_impl->state, LUA_REGISTRYINDEX, function.ref);
+#endif
+    function = {};
+  }
+
+  bool ScriptManager::add_update_callback (FunctionRef function) {
+    if (!m_impl->initialized || !function.valid ()) {
+      return false;
+    }
+    m_impl->update_callbacks.push_back (function);
+    return true;
+  }
+
+  bool ScriptManager::call_with_columns (FunctionRef function, std::span<const ArrayView> columns, std::size_t count,
+      double delta_time) {
+    Impl& impl = *m_impl;
+    if (!impl.initialized || !function.valid ()) {
+      return false;
+    }
+#if defined(OMNICPP_HAS_LUA)
+    lua_State* state = impl.state;
+    lua_rawgeti (state, LUA_REGISTRYINDEX, function.ref);
+    lua_pushinteger (state, static_cast<lua_Integer> (count));
+    lua_pushnumber (state, delta_time);
+    for (std::size_t i = 0; i < columns.size (); ++i) {
+      impl.push_column (i, columns[i]);
+    }
+    bool ok;
+    {
+      Impl::Budget budget (impl, impl.config.call_budget_us);
+      ok = impl.run (static_cast<int> (columns.size ()) + 2, "columns");
+    }
+    for (std::size_t i = 0; i < columns.size (); ++i) {
+      if (!impl.pull_column (i, columns[i])) { // Whatever the script wrote before an error still lands
+        ++impl.stats.errors;
+        omnicpp::log::error ("ScriptManager: Error in 'columns': column {} holds a non-number", i + 1);
+        ok = false;
+      }
+    }
+    return ok;
+#else
+    (void) columns;
+    (void) count;
+    (void) delta_time;
     return false;
+#endif
+  }
+
+  TaskId ScriptManager::start_task (FunctionRef function) {
+    Impl& impl = *m_impl;
+    if (!impl.initialized || !function.valid ()) {
+      return INVALID_TASK;
+    }
+#if defined(OMNICPP_HAS_LUA)
+    lua_State* thread = lua_newthread (impl.state);
+    const int thread_ref = luaL_ref (impl.state, LUA_REGISTRYINDEX);
+    lua_rawgeti (impl.state, LUA_REGISTRYINDEX, function.ref);
+    lua_xmove (impl.state, thread, 1); // The coroutine body waits on the thread's stack
+    const TaskId id = impl.next_task++;
+    impl.tasks.push_back (Impl::Task{ id, thread_ref, thread });
+    return id;
+#else
+    return INVALID_TASK;
+#endif
+  }
+
+  bool ScriptManager::is_task_running (TaskId task) const {
+    const auto& tasks = m_impl->tasks;
+    return std::any_of (tasks.begin (), tasks.end (), [task] (const Impl::Task& t) { return t.id == task; });
+  }
+
+  void ScriptManager::cancel_task (TaskId task) {
+#if defined(OMNICPP_HAS_LUA)
+    auto& tasks = m_impl->tasks;
+    for (std::size_t i = 0; i < tasks.size (); ++i) {
+      if (tasks[i].id == task && tasks[i].thread != m_impl->running_task) {
+        m_impl->finish_task (i);
+        return;
+      }
+    }
+#else
+    (void) task;
+#endif
+  }
+
+  lua_State* ScriptManager::get_state () const {
+    return m_impl->state;
+  }
+
+  std::vector<std::string> ScriptManager::get_script_names () const {
+    std::vector<std::string> names;
+    names.reserve (m_impl->scripts.size ());
+    for (const auto& [name, info] : m_impl->scripts) {
+      names.push_back (name);
+    }
+    std::sort (names.begin (), names.end ());
+    return names;
+  }
+
+  ScriptStats ScriptManager::get_stats () const {
+    return m_impl->stats;
   }
 
 } // namespace scripting
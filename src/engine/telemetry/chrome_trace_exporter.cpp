@@ -0,0 +1,401 @@
+/**
+ * @file chrome_trace_exporter.cpp
+ * @brief Chrome Trace Event JSON writer with a background file thread
+ */
+
+#include "engine/telemetry/chrome_trace_exporter.hpp"
+#include "engine/telemetry/span_recorder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <unistd.h>
+#endif
+
+namespace omnicpp {
+namespace telemetry {
+
+namespace {
+
+constexpr std::size_t MAX_TRACKED_SPANS = 4096; // Flow bookkeeping is forgotten past this
+
+uint64_t process_id() {
+#if defined(_WIN32)
+    return GetCurrentProcessId();
+#else
+    return static_cast<uint64_t>(::getpid());
+#endif
+}
+
+int64_t unix_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+uint64_t span_key(const SpanId& id) {
+    uint64_t key = 0;
+    std::memcpy(&key, id.data.data(), sizeof(key));
+    return key;
+}
+
+std::string_view kind_name(SpanKind kind) {
+    switch (kind) {
+        case SpanKind::Internal: return "internal";
+        case SpanKind::Server: return "server";
+        case SpanKind::Client: return "client";
+        case SpanKind::Producer: return "producer";
+        case SpanKind::Consumer: return "consumer";
+    }
+    return "internal";
+}
+
+void append_escaped(std::string& out, std::string_view text) {
+    out += '"';
+    for (const char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += std::format("\\u{:04x}", static_cast<int>(c));
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+void append_number(std::string& out, double value) {
+    if (std::isfinite(value)) {
+        out += std::format("{}", value);
+    } else {
+        out += "null";
+    }
+}
+
+void append_value(std::string& out, const AttributeValue& value) {
+    std::visit(
+        [&out](const auto& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, std::string>) {
+                append_escaped(out, v);
+            } else if constexpr (std::is_same_v<T, bool>) {
+                out += v ? "true" : "false";
+            } else if constexpr (std::is_same_v<T, int64_t>) {
+                out += std::to_string(v);
+            } else if constexpr (std::is_same_v<T, double>) {
+                append_number(out, v);
+            } else {
+                std::string hex;
+                for (const uint8_t byte : v) {
+                    hex += std::format("{:02x}", byte);
+                }
+                append_escaped(out, hex);
+            }
+        },
+        value);
+}
+
+void append_attributes(std::string& out, const SpanAttributes& attributes) {
+    for (const auto& [key, value] : attributes) {
+        out += ',';
+        append_escaped(out, key);
+        out += ':';
+        append_value(out, value);
+    }
+}
+
+// Where a span ran, for drawing flows to and from it (times relative to the trace start)
+struct SpanPlace {
+    uint32_t thread{ 0 };
+    int64_t start_ns{ 0 };
+    int64_t end_ns{ 0 };
+    SpanId span_id;
+};
+
+} // namespace
+
+struct ChromeTraceExporter::Impl {
+    ChromeTraceConfig config;
+    uint64_t pid{ process_id() };
+    int64_t origin_ns{ unix_now_ns() };
+    std::string error;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable written;
+    std::string pending;
+    bool first_event{ true };
+    bool stop{ false };
+    bool open{ false };
+    uint64_t flush_requested{ 0 };
+    uint64_t flush_completed{ 0 };
+
+    std::unordered_map<uint32_t, std::string> thread_names;         // As last written
+    std::unordered_map<uint64_t, SpanPlace> exported;                // Possible parents of later spans
+    std::unordered_map<uint64_t, std::vector<SpanPlace>> orphans;    // Children waiting for their parent
+    uint64_t dropped_spans{ 0 };
+
+    std::ofstream file;
+    std::thread writer;
+
+    double micros(int64_t unix_ns) const { return static_cast<double>(unix_ns - origin_ns) / 1000.0; }
+
+    std::string& begin_event() {
+        pending += first_event ? "\n" : ",\n";
+        first_event = false;
+        return pending;
+    }
+
+    void write_metadata(std::string_view what, uint32_t thread, std::string_view name) {
+        std::string& out = begin_event();
+        out += std::format("{{\"name\":\"{}\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":", what, pid, thread);
+        append_escaped(out, name);
+        out += "}}";
+    }
+
+    void write_counter(std::string_view name, double value, int64_t unix_ns) {
+        std::string& out = begin_event();
+        out += "{\"name\":";
+        append_escaped(out, name);
+        out += std::format(",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":{},\"args\":{{\"value\":", micros(unix_ns), pid);
+        append_number(out, value);
+        out += "}}";
+    }
+
+    void name_thread(uint32_t thread) {
+        std::string name = SpanRecorder::instance().thread_name(thread);
+        if (name.empty()) {
+            name = std::format("thread {}", thread);
+        }
+        auto [it, inserted] = thread_names.try_emplace(thread, name);
+        if (inserted || it->second != name) {
+            it->second = name;
+            write_metadata("thread_name", thread, name);
+        }
+    }
+
+    void write_span(const SpanData& span) {
+        const int64_t start = span.start_time.count();
+        std::string& out = begin_event();
+        out += "{\"name\":";
+        append_escaped(out, span.name);
+        out += std::format(",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":{},\"tid\":{}",
+                           kind_name(span.kind), micros(start), static_cast<double>(span.duration.count()) / 1000.0,
+                           pid, span.thread);
+        out += std::format(",\"args\":{{\"trace_id\":\"{}\",\"span_id\":\"{}\"", span.trace_id.to_hex(),
+                           span.span_id.to_hex());
+        if (span.parent_span_id) {
+            out += std::format(",\"parent_span_id\":\"{}\"", span.parent_span_id->to_hex());
+        }
+        if (span.status != StatusCode::Unset) {
+            out += span.status == StatusCode::Ok ? ",\"status\":\"ok\"" : ",\"status\":\"error\"";
+            if (!span.status_description.empty()) {
+                out += ",\"status_description\":";
+                append_escaped(out, span.status_description);
+            }
+        }
+        append_attributes(out, span.attributes);
+        out += "}}";
+
+        for (const auto& event : span.events) {
+            std::string& line = begin_event();
+            line += "{\"name\":";
+            append_escaped(line, event.name);
+            line += std::format(",\"cat\":\"event\",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f},\"pid\":{},\"tid\":{}",
+                                micros(event.time.count()), pid, span.thread);
+            line += ",\"args\":{\"span_id\":\"" + span.span_id.to_hex() + "\"";
+            append_attributes(line, event.attributes);
+            line += "}}";
+        }
+    }
+
+    /**
+     * @brief Arrow from inside the parent slice to the start of a child on another thread
+     */
+    void write_flow(const SpanPlace& parent, const SpanPlace& child) {
+        if (parent.thread == child.thread) {
+            return; // Nesting already shows it
+        }
+        const int64_t from = std::clamp(child.start_ns, parent.start_ns, parent.end_ns);
+        const std::string id = child.span_id.to_hex();
+        begin_event() += std::format(
+            "{{\"name\":\"span\",\"cat\":\"flow\",\"ph\":\"s\",\"id\":\"0x{}\",\"ts\":{:.3f},\"pid\":{},\"tid\":{}}}", id,
+            static_cast<double>(from) / 1000.0, pid, parent.thread);
+        begin_event() += std::format(
+            "{{\"name\":\"span\",\"cat\":\"flow\",\"ph\":\"f\",\"bp\":\"e\",\"id\":\"0x{}\",\"ts\":{:.3f},\"pid\":{},"
+            "\"tid\":{}}}",
+            id, static_cast<double>(child.start_ns) / 1000.0, pid, child.thread);
+    }
+
+    void link(const SpanData& span) {
+        SpanPlace place;
+        place.thread = span.thread;
+        place.start_ns = span.start_time.count() - origin_ns;
+        place.end_ns = place.start_ns + span.duration.count();
+        place.span_id = span.span_id;
+
+        const uint64_t key = span_key(span.span_id);
+        if (auto waiting = orphans.find(key); waiting != orphans.end()) {
+            for (const SpanPlace& child : waiting->second) {
+                write_flow(place, child);
+            }
+            orphans.erase(waiting);
+        }
+        if (span.parent_span_id) {
+            const uint64_t parent = span_key(*span.parent_span_id);
+            if (auto found = exported.find(parent); found != exported.end()) {
+                write_flow(found->second, place);
+            } else {
+                if (orphans.size() >= MAX_TRACKED_SPANS) {
+                    orphans.clear();
+                }
+                orphans[parent].push_back(place);
+            }
+        }
+        if (exported.size() >= MAX_TRACKED_SPANS) {
+            exported.clear();
+        }
+        exported.insert_or_assign(key, place);
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait_for(lock, config.flush_interval, [this] {
+                return stop || pending.size() >= config.buffer_bytes || flush_requested != flush_completed;
+            });
+            std::string chunk;
+            chunk.swap(pending);
+            const uint64_t requested = flush_requested;
+            const bool stopping = stop;
+            lock.unlock();
+            if (!chunk.empty()) {
+                file.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                file.flush();
+            }
+            lock.lock();
+            flush_completed = std::max(flush_completed, requested);
+            written.notify_all();
+            if (stopping) {
+                return;
+            }
+        }
+    }
+};
+
+ChromeTraceExporter::ChromeTraceExporter(ChromeTraceConfig config) : impl_(std::make_unique<Impl>()) {
+    impl_->config = std::move(config);
+    impl_->file.open(impl_->config.path, std::ios::binary | std::ios::trunc);
+    if (!impl_->file) {
+        impl_->error = "cannot create " + impl_->config.path;
+        return;
+    }
+    impl_->file << '[';
+    impl_->open = true;
+    impl_->write_metadata("process_name", 0, impl_->config.process_name);
+    impl_->writer = std::thread([this] { impl_->run(); });
+}
+
+ChromeTraceExporter::~ChromeTraceExporter() {
+    shutdown();
+}
+
+bool ChromeTraceExporter::is_open() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->open;
+}
+
+const std::string& ChromeTraceExporter::error() const {
+    return impl_->error;
+}
+
+bool ChromeTraceExporter::export_spans(std::span<const SpanData> spans) {
+    const uint64_t dropped = SpanRecorder::instance().stats().dropped;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->open) {
+        return false;
+    }
+    for (const SpanData& span : spans) {
+        impl_->name_thread(span.thread);
+        impl_->write_span(span);
+        impl_->link(span);
+    }
+    if (dropped != impl_->dropped_spans) {
+        impl_->dropped_spans = dropped;
+        impl_->write_counter("omnicpp.spans_dropped", static_cast<double>(dropped), unix_now_ns());
+    }
+    if (impl_->pending.size() >= impl_->config.buffer_bytes) {
+        impl_->wake.notify_one();
+    }
+    return true;
+}
+
+void ChromeTraceExporter::add_counter(std::string_view name, double value) {
+    const int64_t now = unix_now_ns();
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->open) {
+        impl_->write_counter(name, value, now);
+    }
+}
+
+void ChromeTraceExporter::add_slice(uint32_t thread, std::string_view name, std::string_view category,
+                                    std::chrono::nanoseconds start, std::chrono::nanoseconds duration) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (!impl_->open) {
+        return;
+    }
+    impl_->name_thread(thread);
+    std::string& out = impl_->begin_event();
+    out += "{\"name\":";
+    append_escaped(out, name);
+    out += ",\"cat\":";
+    append_escaped(out, category);
+    out += std::format(",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":{},\"tid\":{}}}",
+                       impl_->micros(start.count()), static_cast<double>(duration.count()) / 1000.0, impl_->pid,
+                       thread);
+}
+
+void ChromeTraceExporter::force_flush() {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    if (!impl_->open) {
+        return;
+    }
+    const uint64_t ticket = ++impl_->flush_requested;
+    impl_->wake.notify_all();
+    impl_->written.wait(lock, [this, ticket] { return impl_->flush_completed >= ticket; });
+}
+
+void ChromeTraceExporter::shutdown() {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    if (!impl_->open) {
+        return;
+    }
+    impl_->open = false;
+    impl_->stop = true;
+    impl_->wake.notify_all();
+    lock.unlock();
+    impl_->writer.join();
+    impl_->file << "\n]\n";
+    impl_->file.close();
+}
+
+} // namespace telemetry
+} // namespace omnicpp
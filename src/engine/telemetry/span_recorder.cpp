@@ -0,0 +1,386 @@
+/**
+ * @file span_recorder.cpp
+ * @brief Per-thread span rings and the exporter thread
+ */
+
+#include "engine/telemetry/span_recorder.hpp"
+#include "engine/logging/binary_log.hpp"
+#include <algorithm>
+#include <bit>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace omnicpp {
+namespace telemetry {
+
+namespace {
+
+/**
+ * @brief Ended spans of one thread: the thread produces, the exporter thread consumes
+ */
+struct Ring {
+    Ring(std::size_t capacity, uint32_t number)
+        : slots(new SpanRecord[capacity]), mask(capacity - 1), thread(number) {}
+
+    std::unique_ptr<SpanRecord[]> slots;
+    std::size_t mask;
+    uint32_t thread;
+
+    alignas(64) std::atomic<uint64_t> head{ 0 }; // Written by the owner
+    std::atomic<uint64_t> recorded{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    alignas(64) std::atomic<uint64_t> tail{ 0 }; // Written by the consumer
+    std::atomic<bool> retired{ false };
+};
+
+struct RingHolder {
+    std::shared_ptr<Ring> ring;
+
+    ~RingHolder() {
+        if (ring) {
+            ring->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<SpanRecord> && std::is_standard_layout_v<SpanRecord>);
+
+/**
+ * @brief Copy the fields and only the used part of the arrays (most spans fill a fraction)
+ */
+void copy_used(const SpanRecord& from, SpanRecord& to) {
+    std::memcpy(static_cast<void*>(&to), &from, offsetof(SpanRecord, attributes));
+    std::copy_n(from.attributes.begin(), from.attribute_count, to.attributes.begin());
+    std::copy_n(from.events.begin(), from.event_count, to.events.begin());
+    std::memcpy(to.text.data(), from.text.data(), from.text_used);
+}
+
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+constexpr int64_t CALIBRATION_NS = 1'000'000'000; // Tick rate is re-measured over at least this much steady time
+
+/**
+ * @brief Span timestamps (log::binary::ticks()) to steady_clock time
+ *
+ * Starts from the rate binary_log measured; drain() refines it over an
+ * ever longer window, so only the exporter thread pays for clock reads.
+ */
+struct TickClock {
+    std::atomic<double> ticks_per_ns{ log::binary::ticks_per_second() / 1e9 };
+    uint64_t anchor_tick{ log::binary::ticks() };
+    int64_t anchor_ns{ steady_ns() };
+
+    int64_t to_ns(uint64_t tick) const {
+        return anchor_ns + to_duration(static_cast<int64_t>(tick - anchor_tick));
+    }
+
+    int64_t to_duration(int64_t ticks) const {
+        return static_cast<int64_t>(static_cast<double>(ticks) / ticks_per_ns.load(std::memory_order_relaxed));
+    }
+
+    uint64_t to_tick(int64_t ns) const {
+        return anchor_tick + static_cast<uint64_t>(static_cast<int64_t>(
+                                 static_cast<double>(ns - anchor_ns) * ticks_per_ns.load(std::memory_order_relaxed)));
+    }
+
+    void calibrate() {
+        const uint64_t tick = log::binary::ticks();
+        const int64_t now = steady_ns();
+        if (now - anchor_ns >= CALIBRATION_NS) {
+            // Keep the anchor so the rate is measured over an ever longer window
+            ticks_per_ns.store(static_cast<double>(tick - anchor_tick) / static_cast<double>(now - anchor_ns),
+                               std::memory_order_relaxed);
+        }
+    }
+};
+
+TickClock& tick_clock() {
+    static TickClock clock;
+    return clock;
+}
+
+int64_t steady_to_unix_offset() {
+    static const int64_t offset = [] {
+        const auto unix_now = std::chrono::system_clock::now().time_since_epoch();
+        const auto steady_now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(unix_now - steady_now).count();
+    }();
+    return offset;
+}
+
+} // namespace
+
+struct SpanRecorder::Impl {
+    mutable std::mutex mutex;
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::atomic<uint32_t> next_thread{ 1 };
+    SpanRecorderConfig config;
+    std::shared_ptr<SpanExporter> exporter;
+    SpanAttributes global_attributes;
+    std::unordered_map<uint32_t, std::string> thread_names;
+
+    std::thread worker;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    bool stop{ false };
+    uint64_t flush_requested{ 0 };
+    uint64_t flush_completed{ 0 };
+    std::atomic<bool> running{ false };
+
+    std::mutex drain_mutex; // One consumer at a time: the worker, or stop() after joining it
+    std::atomic<uint64_t> exported{ 0 };
+    uint64_t retired_recorded{ 0 };
+    uint64_t retired_dropped{ 0 };
+
+    uint32_t local_number() {
+        thread_local const uint32_t number = next_thread.fetch_add(1, std::memory_order_relaxed);
+        return number;
+    }
+
+    Ring* local_ring() {
+        thread_local RingHolder holder;
+        if (!holder.ring) {
+            std::lock_guard<std::mutex> lock(mutex);
+            const std::size_t capacity = std::bit_ceil(std::max<std::size_t>(config.ring_capacity, 2));
+            holder.ring = std::make_shared<Ring>(capacity, local_number());
+            rings.push_back(holder.ring);
+        }
+        return holder.ring.get();
+    }
+
+    /**
+     * @brief Move everything published so far to the exporter
+     */
+    void drain() {
+        std::lock_guard<std::mutex> consumer(drain_mutex);
+        tick_clock().calibrate();
+        std::vector<std::shared_ptr<Ring>> snapshot;
+        std::shared_ptr<SpanExporter> target;
+        SpanAttributes globals;
+        std::size_t batch_size = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshot = rings;
+            target = exporter;
+            globals = global_attributes;
+            batch_size = std::max<std::size_t>(config.batch_size, 1);
+        }
+
+        std::vector<SpanData> batch;
+        const auto send = [&] {
+            if (!batch.empty()) {
+                if (target) {
+                    target->export_spans(batch);
+                }
+                exported.fetch_add(batch.size(), std::memory_order_relaxed);
+                batch.clear();
+            }
+        };
+        for (const auto& ring : snapshot) {
+            const uint64_t head = ring->head.load(std::memory_order_acquire);
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            for (; tail != head; ++tail) {
+                SpanData data = SpanRecorder::to_span_data(ring->slots[tail & ring->mask]);
+                for (const auto& [key, value] : globals) {
+                    data.attributes.try_emplace(key, value);
+                }
+                batch.push_back(std::move(data));
+                ring->tail.store(tail + 1, std::memory_order_release); // Slot is free once converted
+                if (batch.size() >= batch_size) {
+                    send();
+                }
+            }
+        }
+        send();
+
+        // Rings of exited threads go once they are empty
+        std::lock_guard<std::mutex> lock(mutex);
+        std::erase_if(rings, [this](const std::shared_ptr<Ring>& ring) {
+            if (!ring->retired.load(std::memory_order_acquire) ||
+                ring->head.load(std::memory_order_acquire) != ring->tail.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            retired_recorded += ring->recorded.load(std::memory_order_relaxed);
+            retired_dropped += ring->dropped.load(std::memory_order_relaxed);
+            return true;
+        });
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop) {
+            wake.wait_for(lock, config.export_interval, [this] { return stop || flush_requested != flush_completed; });
+            const uint64_t requested = flush_requested;
+            lock.unlock();
+            drain();
+            lock.lock();
+            flush_completed = std::max(flush_completed, requested);
+            drained.notify_all();
+        }
+    }
+};
+
+SpanRecorder::SpanRecorder() : impl_(std::make_unique<Impl>()) {}
+
+SpanRecorder::~SpanRecorder() {
+    stop();
+}
+
+SpanRecorder& SpanRecorder::instance() {
+    static SpanRecorder recorder;
+    return recorder;
+}
+
+void SpanRecorder::start(const SpanRecorderConfig& config) {
+    stop();
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->config = config;
+    impl_->stop = false;
+    tick_clock(); // Measures the tick rate here rather than in the first Span::duration()
+    impl_->worker = std::thread([this] { impl_->run(); });
+    impl_->running.store(true, std::memory_order_release);
+}
+
+void SpanRecorder::stop() {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    if (!impl_->worker.joinable()) {
+        return;
+    }
+    impl_->running.store(false, std::memory_order_relaxed);
+    impl_->stop = true;
+    impl_->wake.notify_all();
+    lock.unlock();
+    impl_->worker.join();
+    impl_->drain();
+    lock.lock();
+    impl_->flush_completed = impl_->flush_requested;
+    impl_->drained.notify_all();
+}
+
+void SpanRecorder::flush() {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    if (!impl_->worker.joinable()) {
+        return;
+    }
+    const uint64_t ticket = ++impl_->flush_requested;
+    impl_->wake.notify_all();
+    impl_->drained.wait(lock, [this, ticket] { return impl_->flush_completed >= ticket; });
+}
+
+void SpanRecorder::set_exporter(std::shared_ptr<SpanExporter> exporter) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->exporter = std::move(exporter);
+}
+
+void SpanRecorder::set_global_attributes(SpanAttributes attributes) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->global_attributes = std::move(attributes);
+}
+
+bool SpanRecorder::submit(const SpanRecord& record) {
+    if (!impl_->running.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    Ring* ring = impl_->local_ring();
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) > ring->mask) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    SpanRecord& slot = ring->slots[head & ring->mask];
+    copy_used(record, slot);
+    if (slot.thread == 0) {
+        slot.thread = ring->thread;
+    }
+    ring->head.store(head + 1, std::memory_order_release);
+    ring->recorded.store(ring->recorded.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return true;
+}
+
+uint32_t SpanRecorder::thread_number() {
+    return impl_->local_number();
+}
+
+void SpanRecorder::set_thread_name(std::string_view name) {
+    const uint32_t thread = thread_number();
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->thread_names.insert_or_assign(thread, std::string(name));
+}
+
+std::string SpanRecorder::thread_name(uint32_t thread) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    const auto it = impl_->thread_names.find(thread);
+    return it != impl_->thread_names.end() ? it->second : std::string();
+}
+
+bool SpanRecorder::is_running() const {
+    return impl_->running.load(std::memory_order_relaxed);
+}
+
+SpanRecorderStats SpanRecorder::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    SpanRecorderStats stats;
+    stats.recorded = impl_->retired_recorded;
+    stats.dropped = impl_->retired_dropped;
+    for (const auto& ring : impl_->rings) {
+        stats.recorded += ring->recorded.load(std::memory_order_relaxed);
+        stats.dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    stats.exported = impl_->exported.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::chrono::nanoseconds SpanRecorder::tick_duration(uint64_t ticks) {
+    return std::chrono::nanoseconds(tick_clock().to_duration(static_cast<int64_t>(ticks)));
+}
+
+uint64_t SpanRecorder::tick_at(std::chrono::steady_clock::time_point time) {
+    return tick_clock().to_tick(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+}
+
+SpanData SpanRecorder::to_span_data(const SpanRecord& record) {
+    const TickClock& clock = tick_clock();
+    const int64_t offset = steady_to_unix_offset();
+    SpanData data;
+    data.name = interned(record.name);
+    data.trace_id = record.trace_id;
+    data.span_id = record.span_id;
+    if (record.parent_span_id.is_valid()) {
+        data.parent_span_id = record.parent_span_id;
+    }
+    data.kind = record.kind;
+    data.start_time = std::chrono::nanoseconds(clock.to_ns(record.start_tick) + offset);
+    data.duration = tick_duration(record.end_tick - record.start_tick);
+    data.status = record.status;
+    data.status_description = std::string(record.text_at(record.status_offset, record.status_length));
+    data.thread = record.thread;
+
+    data.events.reserve(record.event_count);
+    for (uint8_t i = 0; i < record.event_count; ++i) {
+        SpanEventData event;
+        event.name = interned(record.events[i].name);
+        event.time = std::chrono::nanoseconds(clock.to_ns(record.events[i].tick) + offset);
+        data.events.push_back(std::move(event));
+    }
+    for (uint8_t i = 0; i < record.attribute_count; ++i) {
+        const FlatAttribute& attribute = record.attributes[i];
+        SpanAttributes& target = attribute.owner == 0 ? data.attributes : data.events[attribute.owner - 1].attributes;
+        target.insert_or_assign(interned(attribute.key), record.value(attribute));
+    }
+    if (record.dropped > 0) {
+        data.attributes.insert_or_assign("omnicpp.dropped_attributes", static_cast<int64_t>(record.dropped));
+    }
+    return data;
+}
+
+} // namespace telemetry
+} // namespace omnicpp
@@ -0,0 +1,456 @@
+/**
+ * @file telemetry.cpp
+ * @brief Trace ids, interned names, span records and the telemetry manager
+ */
+
+#include "engine/telemetry/Telemetry.hpp"
+#include "engine/telemetry/span_recorder.hpp"
+#include "engine/logging/binary_log.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <random>
+
+namespace omnicpp {
+namespace telemetry {
+
+namespace {
+
+/**
+ * @brief Per-thread splitmix64 stream for ids; seeded once, no lock
+ */
+uint64_t next_random() {
+    thread_local uint64_t state = [] {
+        static std::atomic<uint64_t> counter{ 0 };
+        std::random_device device;
+        return (static_cast<uint64_t>(device()) << 32) ^ device() ^
+               (counter.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B97F4A7C15ull);
+    }();
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+template<std::size_t N>
+std::string hex(const std::array<uint8_t, N>& bytes) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string out(N * 2, '0');
+    for (std::size_t i = 0; i < N; ++i) {
+        out[i * 2] = DIGITS[bytes[i] >> 4];
+        out[i * 2 + 1] = DIGITS[bytes[i] & 0x0F];
+    }
+    return out;
+}
+
+template<std::size_t N>
+bool any_set(const std::array<uint8_t, N>& bytes) {
+    return std::any_of(bytes.begin(), bytes.end(), [](uint8_t b) { return b != 0; });
+}
+
+// Interned strings: a global table behind a mutex, and a direct-mapped
+// per-thread cache in front of it so steady-state lookups take no lock
+struct InternTable {
+    std::mutex mutex;
+    std::unordered_map<std::string_view, NameId> ids;
+    std::deque<std::string> names{ std::string() }; // Id 0 is the empty string; deque keeps views stable
+};
+
+InternTable& intern_table() {
+    static InternTable table;
+    return table;
+}
+
+struct CacheEntry {
+    const std::string* name{ nullptr };
+    NameId id{ 0 };
+};
+
+constexpr std::size_t INTERN_CACHE_SIZE = 256;
+
+/**
+ * @brief FNV-1a: names are short, so this beats a call into std::hash
+ */
+std::size_t cache_slot(std::string_view text) {
+    uint32_t hash = 2166136261u;
+    for (const char c : text) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return (hash ^ (hash >> 16)) & (INTERN_CACHE_SIZE - 1);
+}
+
+} // namespace
+
+// ============================================================================
+// Trace Context
+// ============================================================================
+
+std::string TraceId::to_hex() const {
+    return hex(data);
+}
+
+bool TraceId::is_valid() const noexcept {
+    return any_set(data);
+}
+
+TraceId TraceId::generate() {
+    TraceId id;
+    const uint64_t words[2] = { next_random(), next_random() | 1 };
+    std::memcpy(id.data.data(), words, sizeof(words));
+    return id;
+}
+
+std::string SpanId::to_hex() const {
+    return hex(data);
+}
+
+bool SpanId::is_valid() const noexcept {
+    return any_set(data);
+}
+
+SpanId SpanId::generate() {
+    SpanId id;
+    const uint64_t word = next_random() | 1;
+    std::memcpy(id.data.data(), &word, sizeof(word));
+    return id;
+}
+
+// ============================================================================
+// Interned names
+// ============================================================================
+
+NameId intern(std::string_view text) {
+    thread_local std::array<CacheEntry, INTERN_CACHE_SIZE> cache{};
+    CacheEntry& entry = cache[cache_slot(text)];
+    if (entry.name != nullptr && *entry.name == text) {
+        return entry.id;
+    }
+
+    InternTable& table = intern_table();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto it = table.ids.find(text);
+    if (it == table.ids.end()) {
+        const auto id = static_cast<NameId>(table.names.size());
+        table.names.emplace_back(text);
+        it = table.ids.emplace(table.names.back(), id).first;
+    }
+    entry.id = it->second;
+    entry.name = &table.names[it->second];
+    return entry.id;
+}
+
+const std::string& interned(NameId id) {
+    InternTable& table = intern_table();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return id < table.names.size() ? table.names[id] : table.names.front();
+}
+
+// ============================================================================
+// SpanRecord
+// ============================================================================
+
+FlatAttribute* SpanRecord::find_attribute(NameId key, uint8_t owner) {
+    for (uint8_t i = 0; i < attribute_count; ++i) {
+        if (attributes[i].key == key && attributes[i].owner == owner) {
+            attributes[i].length = 0; // Overwritten: any old text stays behind unused
+            return &attributes[i];
+        }
+    }
+    if (attribute_count == MAX_ATTRIBUTES) {
+        ++dropped;
+        return nullptr;
+    }
+    FlatAttribute& slot = attributes[attribute_count++];
+    slot = FlatAttribute{};
+    slot.key = key;
+    slot.owner = owner;
+    return &slot;
+}
+
+void SpanRecord::store_text(FlatAttribute& attribute, std::string_view value) {
+    const std::size_t room = TEXT_BYTES - text_used;
+    if (value.size() > room) {
+        ++dropped;
+        value = value.substr(0, room);
+    }
+    std::memcpy(text.data() + text_used, value.data(), value.size());
+    attribute.offset = text_used;
+    attribute.length = static_cast<uint16_t>(value.size());
+    text_used = static_cast<uint16_t>(text_used + value.size());
+}
+
+uint8_t SpanRecord::add_event(NameId event_name, uint64_t tick) {
+    if (event_count == MAX_EVENTS) {
+        ++dropped;
+        return 0;
+    }
+    events[event_count] = { event_name, tick };
+    return ++event_count;
+}
+
+void SpanRecord::set_status(StatusCode code, std::string_view description) {
+    status = code;
+    FlatAttribute holder{};
+    store_text(holder, description);
+    status_offset = static_cast<uint16_t>(holder.offset);
+    status_length = holder.length;
+}
+
+AttributeValue SpanRecord::value(const FlatAttribute& attribute) const {
+    switch (attribute.type) {
+        case FlatAttribute::Type::Int: return attribute.i;
+        case FlatAttribute::Type::Double: return attribute.d;
+        case FlatAttribute::Type::Bool: return attribute.b;
+        case FlatAttribute::Type::String:
+        case FlatAttribute::Type::Bytes: return std::string(text_at(attribute.offset, attribute.length));
+    }
+    return int64_t{ 0 };
+}
+
+// ============================================================================
+// Span
+// ============================================================================
+
+Span::Span(std::string_view name, SpanKind kind, TraceId trace_id, std::optional<SpanId> parent_span_id,
+           bool recording)
+    : recording_(recording) {
+    record_.trace_id = trace_id;
+    record_.span_id = SpanId::generate();
+    record_.parent_span_id = parent_span_id.value_or(SpanId::invalid());
+    record_.name = intern(name);
+    record_.kind = kind;
+    record_.start_tick = log::binary::ticks();
+}
+
+Span::~Span() = default;
+
+Span::Span(Span&& other) noexcept
+    : record_(other.record_), recording_(other.recording_), ended_(other.ended_) {
+    other.recording_ = false;
+    other.ended_ = true;
+}
+
+Span& Span::operator=(Span&& other) noexcept {
+    if (this != &other) {
+        record_ = other.record_;
+        recording_ = other.recording_;
+        ended_ = other.ended_;
+        other.recording_ = false;
+        other.ended_ = true;
+    }
+    return *this;
+}
+
+void Span::add_event(std::string_view name, const SpanAttributes& attributes) {
+    const uint8_t owner = record_.add_event(intern(name), log::binary::ticks());
+    if (owner == 0) {
+        return;
+    }
+    for (const auto& [key, value] : attributes) {
+        record_.set_attribute(intern(key), value, owner);
+    }
+}
+
+void Span::set_status(StatusCode code, std::string_view description) {
+    record_.set_status(code, description);
+}
+
+void Span::record_exception(std::string_view type, std::string_view message, std::string_view stacktrace) {
+    static const AttributeKey kType("exception.type");
+    static const AttributeKey kMessage("exception.message");
+    static const AttributeKey kStacktrace("exception.stacktrace");
+    static const NameId kException = intern("exception");
+
+    const uint8_t owner = record_.add_event(kException, log::binary::ticks());
+    if (owner == 0) {
+        return;
+    }
+    record_.set_attribute(kType.id, type, owner);
+    record_.set_attribute(kMessage.id, message, owner);
+    if (!stacktrace.empty()) {
+        record_.set_attribute(kStacktrace.id, stacktrace, owner);
+    }
+}
+
+void Span::end() {
+    if (ended_) {
+        return;
+    }
+    ended_ = true;
+    record_.end_tick = log::binary::ticks();
+    if (recording_) {
+        SpanRecorder::instance().submit(record_);
+    }
+}
+
+std::chrono::nanoseconds Span::duration() const noexcept {
+    const uint64_t end_tick = ended_ ? record_.end_tick : log::binary::ticks();
+    return SpanRecorder::tick_duration(end_tick - record_.start_tick);
+}
+
+Span Span::create_child(std::string_view child_name, SpanKind kind) {
+    return Span(child_name, kind, record_.trace_id, record_.span_id, recording_);
+}
+
+// ============================================================================
+// TelemetryManager
+// ============================================================================
+
+namespace {
+
+struct Context {
+    TraceId trace_id;
+    std::optional<SpanId> parent_span_id;
+};
+
+thread_local Context g_context;
+
+class ManagerTracer final : public Tracer {
+public:
+    ManagerTracer(TelemetryManager& manager, std::string name) : manager_(manager), name_(std::move(name)) {}
+
+    Span start_span(std::string_view name, SpanKind kind, const Span* parent) override {
+        if (parent != nullptr) {
+            return manager_.start_span(name, *parent);
+        }
+        return manager_.start_span(name, kind);
+    }
+
+    Span start_span(std::string_view name, SpanKind kind, TraceId trace_id,
+                    std::optional<SpanId> parent_span_id) override {
+        return Span(name, kind, trace_id, parent_span_id, manager_.is_enabled());
+    }
+
+    Span* get_active_span() override { return nullptr; }
+
+    std::string_view name() const override { return name_; }
+
+private:
+    TelemetryManager& manager_;
+    std::string name_;
+};
+
+} // namespace
+
+struct TelemetryManager::Impl {
+    std::mutex mutex;
+    std::shared_ptr<SpanExporter> exporter;
+    std::unordered_map<std::string, std::shared_ptr<Tracer>> tracers;
+    SpanAttributes global_attributes;
+    uint64_t sample_threshold{ ~0ull }; // A trace is recorded when its id hashes below this
+};
+
+TelemetryManager::TelemetryManager() : impl_(std::make_unique<Impl>()) {}
+
+TelemetryManager::~TelemetryManager() {
+    shutdown();
+}
+
+TelemetryManager& TelemetryManager::instance() {
+    static TelemetryManager manager;
+    return manager;
+}
+
+bool TelemetryManager::initialize(const TelemetryConfig& config) {
+    if (initialized_.exchange(true)) {
+        return false;
+    }
+    config_ = config;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        const double rate = std::clamp(config.sampling_rate, 0.0, 1.0);
+        impl_->sample_threshold =
+            rate >= 1.0 ? ~0ull : static_cast<uint64_t>(rate * 18446744073709551616.0);
+        impl_->global_attributes.insert_or_assign("service.name", config.service_name);
+        impl_->global_attributes.insert_or_assign("service.version", config.service_version);
+        impl_->global_attributes.insert_or_assign("deployment.environment", config.environment);
+        SpanRecorder::instance().set_exporter(impl_->exporter);
+        SpanRecorder::instance().set_global_attributes(impl_->global_attributes);
+    }
+    if (config.enabled) {
+        SpanRecorderConfig recorder;
+        recorder.ring_capacity = config.max_queue_size;
+        recorder.batch_size = config.batch_size;
+        recorder.export_interval = config.batch_timeout;
+        SpanRecorder::instance().start(recorder);
+    }
+    enabled_.store(config.enabled);
+    return true;
+}
+
+void TelemetryManager::set_exporter(std::shared_ptr<SpanExporter> exporter) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->exporter = std::move(exporter);
+    if (initialized_.load()) {
+        SpanRecorder::instance().set_exporter(impl_->exporter);
+    }
+}
+
+void TelemetryManager::shutdown() {
+    if (!initialized_.exchange(false)) {
+        return;
+    }
+    enabled_.store(false);
+    SpanRecorder::instance().stop();
+    SpanRecorder::instance().set_exporter(nullptr);
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->exporter) {
+        impl_->exporter->shutdown();
+    }
+    impl_->tracers.clear();
+}
+
+std::shared_ptr<Tracer> TelemetryManager::get_tracer(std::string_view name, std::string_view version) {
+    std::string key(name);
+    if (!version.empty()) {
+        key += '@';
+        key += version;
+    }
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    auto& tracer = impl_->tracers[key];
+    if (!tracer) {
+        tracer = std::make_shared<ManagerTracer>(*this, std::string(name));
+    }
+    return tracer;
+}
+
+Span TelemetryManager::start_span(std::string_view name, SpanKind kind) {
+    const TraceId trace_id = g_context.trace_id.is_valid() ? g_context.trace_id : TraceId::generate();
+    uint64_t hash = 0;
+    std::memcpy(&hash, trace_id.data.data(), sizeof(hash));
+    // The decision follows the trace id, so every service sampling at the same rate agrees
+    const bool sampled = enabled_.load(std::memory_order_relaxed) && hash <= impl_->sample_threshold;
+    return Span(name, kind, trace_id, g_context.parent_span_id, sampled);
+}
+
+Span TelemetryManager::start_span(std::string_view name, const Span& parent) {
+    return Span(name, SpanKind::Internal, parent.trace_id(), parent.span_id(),
+                parent.is_recording() && enabled_.load(std::memory_order_relaxed));
+}
+
+std::pair<TraceId, std::optional<SpanId>> TelemetryManager::get_current_context() const {
+    return { g_context.trace_id, g_context.parent_span_id };
+}
+
+void TelemetryManager::set_context(TraceId trace_id, SpanId parent_span_id) {
+    g_context.trace_id = trace_id;
+    g_context.parent_span_id = parent_span_id.is_valid() ? std::optional<SpanId>(parent_span_id) : std::nullopt;
+}
+
+void TelemetryManager::force_flush() {
+    SpanRecorder::instance().flush();
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if (impl_->exporter) {
+        impl_->exporter->force_flush();
+    }
+}
+
+void TelemetryManager::add_global_attribute(std::string_view key, const AttributeValue& value) {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->global_attributes.insert_or_assign(std::string(key), value);
+    SpanRecorder::instance().set_global_attributes(impl_->global_attributes);
+}
+
+} // namespace telemetry
+} // namespace omnicpp
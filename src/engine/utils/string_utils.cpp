@@ -15,7 +15,7 @@ namespace OmniCpp::Engine::Utils {
     std::string result = str;
     std::transform (result.begin (), result.end (), result.begin (),
         [] (unsigned char c) { return std::tolower (c); });
-    omnicpp::log::trace("StringUtils: Converted '{}' to lowercase", str);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Converted '{}' to lowercase", str);
     return result;
   }
 
@@ -23,13 +23,13 @@ namespace OmniCpp::Engine::Utils {
     std::string result = str;
     std::transform (result.begin (), result.end (), result.begin (),
         [] (unsigned char c) { return std::toupper (c); });
-    omnicpp::log::trace("StringUtils: Converted '{}' to uppercase", str);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Converted '{}' to uppercase", str);
     return result;
   }
 
   std::string StringUtils::trim (const std::string& str) {
     std::string result = trim_right (trim_left (str));
-    omnicpp::log::trace("StringUtils: Trimmed whitespace from '{}'", str);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Trimmed whitespace from '{}'", str);
     return result;
   }
 
@@ -54,7 +54,7 @@ namespace OmniCpp::Engine::Utils {
       result.push_back (item);
     }
 
-    omnicpp::log::trace("StringUtils: Split '{}' into {} parts", str, result.size());
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Split '{}' into {} parts", str, result.size());
     return result;
   }
 
@@ -73,7 +73,7 @@ namespace OmniCpp::Engine::Utils {
     }
 
     std::string result = ss.str ();
-    omnicpp::log::trace("StringUtils: Joined {} parts with delimiter '{}'", parts.size(), delimiter);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Joined {} parts with delimiter '{}'", parts.size(), delimiter);
     return result;
   }
 
@@ -82,7 +82,7 @@ namespace OmniCpp::Engine::Utils {
       return false;
     }
     bool result = std::equal (prefix.begin (), prefix.end (), str.begin ());
-    omnicpp::log::trace("StringUtils: Checking if '{}' starts with '{}': {}", str, prefix, result);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Checking if '{}' starts with '{}': {}", str, prefix, result);
     return result;
   }
 
@@ -91,13 +91,13 @@ namespace OmniCpp::Engine::Utils {
       return false;
     }
     bool result = std::equal (suffix.rbegin (), suffix.rend (), str.rbegin ());
-    omnicpp::log::trace("StringUtils: Checking if '{}' ends with '{}': {}", str, suffix, result);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Checking if '{}' ends with '{}': {}", str, suffix, result);
     return result;
   }
 
   bool StringUtils::contains (const std::string& str, const std::string& substr) {
     bool result = str.find (substr) != std::string::npos;
-    omnicpp::log::trace("StringUtils: Checking if '{}' contains '{}': {}", str, substr, result);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Checking if '{}' contains '{}': {}", str, substr, result);
     return result;
   }
 
@@ -109,7 +109,7 @@ namespace OmniCpp::Engine::Utils {
     }
     std::string result = str;
     result.replace (pos, from.size (), to);
-    omnicpp::log::trace("StringUtils: Replaced first occurrence of '{}' with '{}' in '{}'", from, to, str);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Replaced first occurrence of '{}' with '{}' in '{}'", from, to, str);
     return result;
   }
 
@@ -129,7 +129,7 @@ namespace OmniCpp::Engine::Utils {
       count++;
     }
 
-    omnicpp::log::trace("StringUtils: Replaced {} occurrences of '{}' with '{}' in '{}'", count, from, to, str);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Replaced {} occurrences of '{}' with '{}' in '{}'", count, from, to, str);
     return result;
   }
 
@@ -139,7 +139,7 @@ namespace OmniCpp::Engine::Utils {
     }
     bool result = std::equal (a.begin (), a.end (), b.begin (),
         [] (unsigned char ca, unsigned char cb) { return std::tolower (ca) == std::tolower (cb); });
-    omnicpp::log::trace("StringUtils: Comparing '{}' and '{}' ignoring case: {}", a, b, result);
+    LOG_TRACE_IN(omnicpp::log::Subsystem::Utils, "StringUtils: Comparing '{}' and '{}' ignoring case: {}", a, b, result);
     return result;
   }
 
@@ -179,23 +179,9 @@ int Game::run() {
     omnicpp::log::info("Game: Starting game loop");
     m_running = true;
     
-    auto last_time = std::chrono::high_resolution_clock::now();
-    
-    // Main game loop
-    while (m_running) {
-        auto current_time = std::chrono::high_resolution_clock::now();
-        float delta_time = std::chrono::duration<float>(current_time - last_time).count();
-        last_time = current_time;
-        
-        // Handle input
-        handle_input();
-        
-        // Update game logic
-        update(delta_time);
-        
-        // Render
-        render();
-    }
+    // The engine runs and paces the frame loop (EngineConfig::max_fps)
+    m_engine->run();
+    m_running = false;
     
     omnicpp::log::info("Game: Game loop ended");
     return 0;
@@ -19,7 +19,6 @@
 #include "engine/IPlatform.hpp"
 #include <iostream>
 #include <cmath>
-#include <cstdlib>
 #include <ctime>
 #include "engine/logging/Log.hpp"
 
@@ -31,11 +30,13 @@ PongGame::PongGame(Engine* engine)
     , m_scene(nullptr)
     , m_initialized(false)
     , m_running(false)
-    , m_player_score(0)
-    , m_ai_score(0) {
+    , m_state(pong_initial_state(static_cast<uint32_t>(std::time(nullptr))))
+    , m_accumulator(0.0f)
+    , m_reported_scores{0, 0}
+    , m_local_player(0) {
 
-    // Initialize random seed
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+    // Local play: the right paddle is the AI and moves at its own speed
+    m_state.paddles[1].speed = AI_PADDLE_SPEED;
     omnicpp::log::debug("PongGame: Constructor called");
 }
 
@@ -118,14 +119,6 @@ void PongGame::create_scene() {
 
     m_scene->add_entity(std::move(m_camera_entity));
     m_scene->set_active_camera(camera_component);
-
-    // Set game boundaries
-    m_bounds.left = -10.0f;
-    m_bounds.right = 10.0f;
-    m_bounds.top = 6.0f;
-    m_bounds.bottom = -6.0f;
-    m_bounds.front = -2.0f;
-    m_bounds.back = 2.0f;
 }
 
 void PongGame::create_entities() {
@@ -138,15 +131,6 @@ void PongGame::create_entities() {
 
     m_scene->add_entity(std::move(m_player_paddle));
 
-    // Initialize player paddle state
-    m_player_paddle_state.x = -9.0f;
-    m_player_paddle_state.y = 0.0f;
-    m_player_paddle_state.z = 0.0f;
-    m_player_paddle_state.width = 0.5f;
-    m_player_paddle_state.height = 2.0f;
-    m_player_paddle_state.depth = 0.5f;
-    m_player_paddle_state.speed = PADDLE_SPEED;
-
     // Create AI paddle (right side)
     m_ai_paddle = std::make_unique<ecs::Entity>(3, "AIPaddle");
     auto ai_transform = m_ai_paddle->add_component<ecs::TransformComponent>();
@@ -156,15 +140,6 @@ void PongGame::create_entities() {
 
     m_scene->add_entity(std::move(m_ai_paddle));
 
-    // Initialize AI paddle state
-    m_ai_paddle_state.x = 9.0f;
-    m_ai_paddle_state.y = 0.0f;
-    m_ai_paddle_state.z = 0.0f;
-    m_ai_paddle_state.width = 0.5f;
-    m_ai_paddle_state.height = 2.0f;
-    m_ai_paddle_state.depth = 0.5f;
-    m_ai_paddle_state.speed = AI_PADDLE_SPEED;
-
     // Create ball
     m_ball = std::make_unique<ecs::Entity>(4, "Ball");
     auto ball_transform = m_ball->add_component<ecs::TransformComponent>();
@@ -174,30 +149,27 @@ void PongGame::create_entities() {
 
     m_scene->add_entity(std::move(m_ball));
 
-    // Initialize ball state
-    reset_ball();
+    sync_entities();
 }
 
-void PongGame::reset_ball() {
-    m_ball_state.x = 0.0f;
-    m_ball_state.y = 0.0f;
-    m_ball_state.z = 0.0f;
-    m_ball_state.radius = 0.3f;
-
-    // Random initial direction (left or right)
-    float direction = (std::rand() % 2 == 0) ? 1.0f : -1.0f;
-
-    // Random angle between -45 and 45 degrees
-    float angle = ((std::rand() % 90) - 45.0f) * (3.14159265f / 180.0f);
+void PongGame::enable_online(uint32_t local_player, uint32_t seed, SendInputCallback send, uint32_t input_delay) {
+    m_local_player = local_player & 1;
+    m_send_input = std::move(send);
+    m_state = pong_initial_state(seed);
+    m_reported_scores[0] = 0;
+    m_reported_scores[1] = 0;
+    m_accumulator = 0.0f;
+    m_rollback = std::make_unique<RollbackSession>(m_state, &pong_step, m_local_player, input_delay);
 
-    m_ball_state.velocity_x = direction * BALL_SPEED * std::cos(angle);
-    m_ball_state.velocity_y = BALL_SPEED * std::sin(angle);
-    m_ball_state.velocity_z = 0.0f;
+    omnicpp::log::info("PongGame: Online match as player {} (input delay {} frames)", m_local_player, input_delay);
+}
 
-    // Update ball entity position
-    auto ball_transform = m_ball->get_component<ecs::TransformComponent>();
-    if (ball_transform) {
-        ball_transform->set_position(Vec3{m_ball_state.x, m_ball_state.y, m_ball_state.z});
+void PongGame::receive_remote_input(uint32_t frame, PongInput input) {
+    if (!m_rollback) {
+        return;
+    }
+    if (!m_rollback->add_remote_input(1 - m_local_player, frame, input)) {
+        omnicpp::log::debug("PongGame: Dropped remote input for frame {}", frame);
     }
 }
 
@@ -209,182 +181,95 @@ void PongGame::update(float delta_time) {
     // Update scene
     m_scene_manager->update(delta_time);
 
-    // Update game logic
-    update_player_paddle(delta_time);
-    update_ai_paddle(delta_time);
-    update_ball(delta_time);
-    check_collisions();
+    // Fixed-step simulation; cap catch-up so a long hitch does not spiral
+    m_accumulator += delta_time;
+    int steps = 0;
+    while (m_accumulator >= PONG_FIXED_DT && steps < MAX_STEPS_PER_UPDATE) {
+        step_simulation();
+        m_accumulator -= PONG_FIXED_DT;
+        ++steps;
+    }
+    if (steps == MAX_STEPS_PER_UPDATE) {
+        m_accumulator = 0.0f;
+    }
+
+    sync_entities();
+    update_score();
 }
 
-void PongGame::update_player_paddle(float delta_time) {
+PongInput PongGame::sample_local_input() const {
     auto input_manager = m_engine->get_input_manager();
-    auto paddle_transform = m_player_paddle->get_component<ecs::TransformComponent>();
-
-    if (!paddle_transform) {
-        return;
-    }
-
-    // Move paddle based on input
+    PongInput input;
     if (input_manager->is_key_pressed(input::KeyCode::W)) {
-        m_player_paddle_state.y += m_player_paddle_state.speed * delta_time;
+        input.move += 1;
     }
     if (input_manager->is_key_pressed(input::KeyCode::S)) {
-        m_player_paddle_state.y -= m_player_paddle_state.speed * delta_time;
+        input.move -= 1;
     }
-
-    // Clamp paddle position to bounds
-    float half_height = m_player_paddle_state.height / 2.0f;
-    m_player_paddle_state.y = std::max(m_bounds.bottom + half_height,
-                                       std::min(m_bounds.top - half_height, m_player_paddle_state.y));
-
-    // Update entity transform
-    paddle_transform->set_position(Vec3{m_player_paddle_state.x, m_player_paddle_state.y, m_player_paddle_state.z});
+    return input;
 }
 
-void PongGame::update_ai_paddle(float delta_time) {
-    auto paddle_transform = m_ai_paddle->get_component<ecs::TransformComponent>();
+void PongGame::step_simulation() {
+    const PongInput local_input = sample_local_input();
 
-    if (!paddle_transform) {
+    if (!m_rollback) {
+        pong_step(m_state, {local_input, pong_ai_input(m_state, 1)});
         return;
     }
 
-    // Simple AI: move towards ball Y position
-    float target_y = m_ball_state.y;
-    float dy = target_y - m_ai_paddle_state.y;
-
-    // Move towards ball with reaction delay
-    if (std::abs(dy) > 0.1f) {
-        float move_amount = m_ai_paddle_state.speed * delta_time;
-        if (dy > 0) {
-            m_ai_paddle_state.y += std::min(move_amount, dy);
-        } else {
-            m_ai_paddle_state.y += std::max(-move_amount, dy);
-        }
-    }
-
-    // Clamp paddle position to bounds
-    float half_height = m_ai_paddle_state.height / 2.0f;
-    m_ai_paddle_state.y = std::max(m_bounds.bottom + half_height,
-                                   std::min(m_bounds.top - half_height, m_ai_paddle_state.y));
-
-    // Update entity transform
-    paddle_transform->set_position(Vec3{m_ai_paddle_state.x, m_ai_paddle_state.y, m_ai_paddle_state.z});
-}
-
-void PongGame::update_ball(float delta_time) {
-    auto ball_transform = m_ball->get_component<ecs::TransformComponent>();
-
-    if (!ball_transform) {
+    const uint32_t frame = m_rollback->get_frame() + m_rollback->get_input_delay();
+    if (!m_rollback->advance(local_input)) {
+        // Too far ahead of the remote peer: hold this frame until inputs arrive
         return;
     }
-
-    // Update ball position
-    m_ball_state.x += m_ball_state.velocity_x * delta_time;
-    m_ball_state.y += m_ball_state.velocity_y * delta_time;
-    m_ball_state.z += m_ball_state.velocity_z * delta_time;
-
-    // Update entity transform
-    ball_transform->set_position(Vec3{m_ball_state.x, m_ball_state.y, m_ball_state.z});
+    if (m_send_input) {
+        m_send_input(frame, local_input);
+    }
+    m_state = m_rollback->get_state();
 }
 
-void PongGame::check_collisions() {
-    // Check top and bottom wall collisions
-    if (m_ball_state.y + m_ball_state.radius > m_bounds.top) {
-        m_ball_state.y = m_bounds.top - m_ball_state.radius;
-        m_ball_state.velocity_y = -m_ball_state.velocity_y;
-    } else if (m_ball_state.y - m_ball_state.radius < m_bounds.bottom) {
-        m_ball_state.y = m_bounds.bottom + m_ball_state.radius;
-        m_ball_state.velocity_y = -m_ball_state.velocity_y;
+void PongGame::sync_entities() {
+    auto player_transform = m_player_paddle ? m_player_paddle->get_component<ecs::TransformComponent>() : nullptr;
+    if (player_transform) {
+        const PaddleState& paddle = m_state.paddles[0];
+        player_transform->set_position(Vec3{paddle.x, paddle.y, paddle.z});
     }
 
-    // Check front and back wall collisions
-    if (m_ball_state.z + m_ball_state.radius > m_bounds.back) {
-        m_ball_state.z = m_bounds.back - m_ball_state.radius;
-        m_ball_state.velocity_z = -m_ball_state.velocity_z;
-    } else if (m_ball_state.z - m_ball_state.radius < m_bounds.front) {
-        m_ball_state.z = m_bounds.front + m_ball_state.radius;
-        m_ball_state.velocity_z = -m_ball_state.velocity_z;
+    auto ai_transform = m_ai_paddle ? m_ai_paddle->get_component<ecs::TransformComponent>() : nullptr;
+    if (ai_transform) {
+        const PaddleState& paddle = m_state.paddles[1];
+        ai_transform->set_position(Vec3{paddle.x, paddle.y, paddle.z});
     }
 
-    // Check player paddle collision (left side)
-    float player_half_width = m_player_paddle_state.width / 2.0f;
-    float player_half_height = m_player_paddle_state.height / 2.0f;
-    float player_half_depth = m_player_paddle_state.depth / 2.0f;
-
-    if (m_ball_state.x - m_ball_state.radius < m_player_paddle_state.x + player_half_width &&
-        m_ball_state.x + m_ball_state.radius > m_player_paddle_state.x - player_half_width &&
-        m_ball_state.y - m_ball_state.radius < m_player_paddle_state.y + player_half_height &&
-        m_ball_state.y + m_ball_state.radius > m_player_paddle_state.y - player_half_height &&
-        m_ball_state.z - m_ball_state.radius < m_player_paddle_state.z + player_half_depth &&
-        m_ball_state.z + m_ball_state.radius > m_player_paddle_state.z - player_half_depth) {
-
-        // Ball hit player paddle
-        m_ball_state.x = m_player_paddle_state.x + player_half_width + m_ball_state.radius;
-        m_ball_state.velocity_x = std::abs(m_ball_state.velocity_x) + BALL_SPEED_INCREMENT;
-
-        // Add some angle based on where ball hit paddle
-        float hit_offset = (m_ball_state.y - m_player_paddle_state.y) / player_half_height;
-        m_ball_state.velocity_y += hit_offset * 2.0f;
-
-        // Normalize velocity
-        float speed = std::sqrt(m_ball_state.velocity_x * m_ball_state.velocity_x +
-                               m_ball_state.velocity_y * m_ball_state.velocity_y);
-        m_ball_state.velocity_x = (m_ball_state.velocity_x / speed) * std::abs(m_ball_state.velocity_x);
-        m_ball_state.velocity_y = (m_ball_state.velocity_y / speed) * std::abs(m_ball_state.velocity_x);
+    auto ball_transform = m_ball ? m_ball->get_component<ecs::TransformComponent>() : nullptr;
+    if (ball_transform) {
+        ball_transform->set_position(Vec3{m_state.ball.x, m_state.ball.y, m_state.ball.z});
     }
+}
 
-    // Check AI paddle collision (right side)
-    float ai_half_width = m_ai_paddle_state.width / 2.0f;
-    float ai_half_height = m_ai_paddle_state.height / 2.0f;
-    float ai_half_depth = m_ai_paddle_state.depth / 2.0f;
-
-    if (m_ball_state.x + m_ball_state.radius > m_ai_paddle_state.x - ai_half_width &&
-        m_ball_state.x - m_ball_state.radius < m_ai_paddle_state.x + ai_half_width &&
-        m_ball_state.y - m_ball_state.radius < m_ai_paddle_state.y + ai_half_height &&
-        m_ball_state.y + m_ball_state.radius > m_ai_paddle_state.y - ai_half_height &&
-        m_ball_state.z - m_ball_state.radius < m_ai_paddle_state.z + ai_half_depth &&
-        m_ball_state.z + m_ball_state.radius > m_ai_paddle_state.z - ai_half_depth) {
-
-        // Ball hit AI paddle
-        m_ball_state.x = m_ai_paddle_state.x - ai_half_width - m_ball_state.radius;
-        m_ball_state.velocity_x = -std::abs(m_ball_state.velocity_x) - BALL_SPEED_INCREMENT;
-
-        // Add some angle based on where ball hit paddle
-        float hit_offset = (m_ball_state.y - m_ai_paddle_state.y) / ai_half_height;
-        m_ball_state.velocity_y += hit_offset * 2.0f;
-
-        // Normalize velocity
-        float speed = std::sqrt(m_ball_state.velocity_x * m_ball_state.velocity_x +
-                               m_ball_state.velocity_y * m_ball_state.velocity_y);
-        m_ball_state.velocity_x = (m_ball_state.velocity_x / speed) * std::abs(m_ball_state.velocity_x);
-        m_ball_state.velocity_y = (m_ball_state.velocity_y / speed) * std::abs(m_ball_state.velocity_x);
+void PongGame::update_score() {
+    const int32_t player_score = m_state.scores[0];
+    const int32_t ai_score = m_state.scores[1];
+    if (player_score == m_reported_scores[0] && ai_score == m_reported_scores[1]) {
+        return;
     }
-
-    // Check scoring (ball went past paddles)
-    if (m_ball_state.x < m_bounds.left) {
-        // AI scores
-        m_ai_score++;
-        omnicpp::log::info("PongGame: AI scores! Score: Player {} - AI {}", m_player_score, m_ai_score);
-        reset_ball();
-        update_score();
-    } else if (m_ball_state.x > m_bounds.right) {
-        // Player scores
-        m_player_score++;
-        omnicpp::log::info("PongGame: Player scores! Score: Player {} - AI {}", m_player_score, m_ai_score);
-        reset_ball();
-        update_score();
+    if (player_score > m_reported_scores[0]) {
+        omnicpp::log::info("PongGame: Player scores! Score: Player {} - AI {}", player_score, ai_score);
     }
-}
+    if (ai_score > m_reported_scores[1]) {
+        omnicpp::log::info("PongGame: AI scores! Score: Player {} - AI {}", player_score, ai_score);
+    }
+    m_reported_scores[0] = player_score;
+    m_reported_scores[1] = ai_score;
 
-void PongGame::update_score() {
     // Check for win condition
-    if (m_player_score >= WINNING_SCORE) {
+    if (player_score >= WINNING_SCORE) {
         omnicpp::log::info("PongGame: PLAYER WINS!");
-        omnicpp::log::info("PongGame: Final Score: Player {} - AI {}", m_player_score, m_ai_score);
+        omnicpp::log::info("PongGame: Final Score: Player {} - AI {}", player_score, ai_score);
         m_running = false;
-    } else if (m_ai_score >= WINNING_SCORE) {
+    } else if (ai_score >= WINNING_SCORE) {
         omnicpp::log::info("PongGame: AI WINS!");
-        omnicpp::log::info("PongGame: Final Score: Player {} - AI {}", m_player_score, m_ai_score);
+        omnicpp::log::info("PongGame: Final Score: Player {} - AI {}", player_score, ai_score);
         m_running = false;
     }
 }
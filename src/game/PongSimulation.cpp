@@ -0,0 +1,172 @@
+/**
+ * @file PongSimulation.cpp
+ * @brief Deterministic fixed-step Pong simulation shared by local and rollback play
+ * @version 1.0.0
+ */
+
+#include "game/PongSimulation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace omnicpp {
+namespace game {
+
+static_assert(std::is_trivially_copyable_v<PongState>, "PongState is snapshotted by copy");
+static_assert(sizeof(PongState) == sizeof(float) * 21 + sizeof(int32_t) * 2 + sizeof(uint32_t) * 2,
+              "PongState must have no padding so checksums are stable");
+
+namespace {
+
+constexpr float PI = 3.14159265f;
+
+uint32_t next_random(uint32_t& state) noexcept {
+    // xorshift32: identical sequence on every peer, unlike std::rand
+    uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state = x;
+    return x;
+}
+
+void reset_ball(PongState& state) noexcept {
+    state.ball.x = 0.0f;
+    state.ball.y = 0.0f;
+    state.ball.z = 0.0f;
+    state.ball.radius = 0.3f;
+
+    // Random initial direction (left or right)
+    const float direction = (next_random(state.rng) % 2 == 0) ? 1.0f : -1.0f;
+
+    // Random angle between -45 and 45 degrees
+    const float angle = (static_cast<float>(next_random(state.rng) % 90) - 45.0f) * (PI / 180.0f);
+
+    state.ball.velocity_x = direction * PONG_BALL_SPEED * std::cos(angle);
+    state.ball.velocity_y = PONG_BALL_SPEED * std::sin(angle);
+    state.ball.velocity_z = 0.0f;
+}
+
+void move_paddle(PaddleState& paddle, PongInput input) noexcept {
+    paddle.y += static_cast<float>(std::clamp<int8_t>(input.move, -1, 1)) * paddle.speed * PONG_FIXED_DT;
+
+    // Clamp paddle position to bounds
+    const float half_height = paddle.height / 2.0f;
+    paddle.y = std::max(PONG_BOUNDS.bottom + half_height, std::min(PONG_BOUNDS.top - half_height, paddle.y));
+}
+
+bool overlaps(const BallState& ball, const PaddleState& paddle) noexcept {
+    const float half_width = paddle.width / 2.0f;
+    const float half_height = paddle.height / 2.0f;
+    const float half_depth = paddle.depth / 2.0f;
+    return ball.x - ball.radius < paddle.x + half_width && ball.x + ball.radius > paddle.x - half_width &&
+           ball.y - ball.radius < paddle.y + half_height && ball.y + ball.radius > paddle.y - half_height &&
+           ball.z - ball.radius < paddle.z + half_depth && ball.z + ball.radius > paddle.z - half_depth;
+}
+
+void bounce(BallState& ball, const PaddleState& paddle, float side) noexcept {
+    const float half_width = paddle.width / 2.0f;
+    const float half_height = paddle.height / 2.0f;
+
+    ball.x = paddle.x + side * (half_width + ball.radius);
+    ball.velocity_x = side * (std::abs(ball.velocity_x) + PONG_BALL_SPEED_INCREMENT);
+
+    // Add some angle based on where ball hit paddle
+    const float hit_offset = (ball.y - paddle.y) / half_height;
+    ball.velocity_y += hit_offset * 2.0f;
+
+    // Normalize velocity
+    const float speed = std::sqrt(ball.velocity_x * ball.velocity_x + ball.velocity_y * ball.velocity_y);
+    ball.velocity_x = (ball.velocity_x / speed) * std::abs(ball.velocity_x);
+    ball.velocity_y = (ball.velocity_y / speed) * std::abs(ball.velocity_x);
+}
+
+void check_collisions(PongState& state) noexcept {
+    BallState& ball = state.ball;
+
+    // Check top and bottom wall collisions
+    if (ball.y + ball.radius > PONG_BOUNDS.top) {
+        ball.y = PONG_BOUNDS.top - ball.radius;
+        ball.velocity_y = -ball.velocity_y;
+    } else if (ball.y - ball.radius < PONG_BOUNDS.bottom) {
+        ball.y = PONG_BOUNDS.bottom + ball.radius;
+        ball.velocity_y = -ball.velocity_y;
+    }
+
+    // Check front and back wall collisions
+    if (ball.z + ball.radius > PONG_BOUNDS.back) {
+        ball.z = PONG_BOUNDS.back - ball.radius;
+        ball.velocity_z = -ball.velocity_z;
+    } else if (ball.z - ball.radius < PONG_BOUNDS.front) {
+        ball.z = PONG_BOUNDS.front + ball.radius;
+        ball.velocity_z = -ball.velocity_z;
+    }
+
+    if (overlaps(ball, state.paddles[0])) {
+        bounce(ball, state.paddles[0], 1.0f);
+    }
+    if (overlaps(ball, state.paddles[1])) {
+        bounce(ball, state.paddles[1], -1.0f);
+    }
+
+    // Check scoring (ball went past paddles)
+    if (ball.x < PONG_BOUNDS.left) {
+        state.scores[1]++;
+        reset_ball(state);
+    } else if (ball.x > PONG_BOUNDS.right) {
+        state.scores[0]++;
+        reset_ball(state);
+    }
+}
+
+PaddleState make_paddle(float x) noexcept {
+    return PaddleState{x, 0.0f, 0.0f, 0.5f, 2.0f, 0.5f, PONG_PADDLE_SPEED};
+}
+
+} // namespace
+
+PongState pong_initial_state(uint32_t seed) {
+    PongState state{};
+    state.paddles[0] = make_paddle(-9.0f);
+    state.paddles[1] = make_paddle(9.0f);
+    state.rng = seed != 0 ? seed : 0x9E3779B9u;  // xorshift must not start at zero
+    reset_ball(state);
+    return state;
+}
+
+void pong_step(PongState& state, const std::array<PongInput, 2>& inputs) noexcept {
+    move_paddle(state.paddles[0], inputs[0]);
+    move_paddle(state.paddles[1], inputs[1]);
+
+    state.ball.x += state.ball.velocity_x * PONG_FIXED_DT;
+    state.ball.y += state.ball.velocity_y * PONG_FIXED_DT;
+    state.ball.z += state.ball.velocity_z * PONG_FIXED_DT;
+
+    check_collisions(state);
+    ++state.frame;
+}
+
+PongInput pong_ai_input(const PongState& state, uint32_t player) noexcept {
+    // Simple AI: move towards ball Y position
+    const float dy = state.ball.y - state.paddles[player & 1].y;
+    if (std::abs(dy) <= 0.1f) {
+        return {};
+    }
+    return PongInput{static_cast<int8_t>(dy > 0.0f ? 1 : -1)};
+}
+
+uint64_t pong_checksum(const PongState& state) noexcept {
+    unsigned char bytes[sizeof(PongState)];
+    std::memcpy(bytes, &state, sizeof(bytes));
+
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char byte : bytes) {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace game
+} // namespace omnicpp
@@ -5,7 +5,9 @@
 
 #include "game/network/game_network.hpp"
 #include "engine/logging/Log.hpp"
+#include "engine/network/network_manager.hpp"
 #include <string>
+#include <utility>
 
 namespace OmniCpp::Game::Network {
 
@@ -29,9 +31,12 @@ namespace OmniCpp::Game::Network {
 
     omnicpp::log::info ("Initializing game network...");
 
-    // TODO: Initialize network subsystem
-    // TODO: Setup network sockets
-    // TODO: Configure network parameters
+    m_network = std::make_unique<Engine::Network::NetworkManager> ();
+    if (!m_network->initialize ({})) {
+      omnicpp::log::error ("Failed to initialize game network");
+      m_network.reset ();
+      return;
+    }
 
     m_initialized = true;
     omnicpp::log::info ("GameNetwork initialized successfully");
@@ -43,10 +48,17 @@ namespace OmniCpp::Game::Network {
       return;
     }
 
+    if (port <= 0 || port > 65535) {
+      omnicpp::log::error ("Cannot connect: invalid port {}", port);
+      return;
+    }
+
     omnicpp::log::info ("Connecting to {}:{}...", address, port);
 
-    // TODO: Establish network connection
-    // TODO: Handle connection errors
+    // Completion is reported asynchronously as a Connected event during update()
+    if (!m_network->connect_to_server (address + ":" + std::to_string (port))) {
+      omnicpp::log::error ("Failed to start connection to {}:{}", address, port);
+    }
   }
 
   void GameNetwork::disconnect () {
@@ -57,8 +69,10 @@ namespace OmniCpp::Game::Network {
 
     omnicpp::log::info ("Disconnecting from network...");
 
-    // TODO: Close network connection
-    // TODO: Cleanup network resources
+    m_network->disconnect ();
+    m_network->shutdown ();
+    m_network.reset ();
+    m_initialized = false;
   }
 
   void GameNetwork::update () {
@@ -66,9 +80,36 @@ namespace OmniCpp::Game::Network {
       return;
     }
 
-    // TODO: Update network state
-    // TODO: Process network events
-    // TODO: Handle incoming data
+    m_network->update ();
+
+    Engine::Network::TransportEvent event;
+    while (m_network->poll_event (event)) {
+      if (event.type == Engine::Network::TransportEvent::Type::Connected) {
+        omnicpp::log::info ("Connection {} established", event.connection);
+      } else {
+        omnicpp::log::info ("Connection {} closed", event.connection);
+      }
+    }
+
+    // Drained every update so the transport's receive queue stays bounded
+    Engine::Network::Message message;
+    while (m_network->poll_message (message)) {
+      if (m_message_handler) {
+        m_message_handler (message);
+      }
+    }
+  }
+
+  void GameNetwork::set_message_handler (MessageHandler handler) {
+    m_message_handler = std::move (handler);
+  }
+
+  bool GameNetwork::is_connected () const {
+    return m_initialized && m_network->is_connected ();
+  }
+
+  Engine::Network::NetworkManager* GameNetwork::get_network_manager () {
+    return m_network.get ();
   }
 
 } // namespace OmniCpp::Game::Network
@@ -0,0 +1,260 @@
+/**
+ * @file omnicpp_logcat.cpp
+ * @brief Decode, filter and query binary log and flight recorder files
+ * @version 1.0.0
+ *
+ * omnicpp_logcat [options] game.blog | omnicpp_flight.bin
+ *   --json            One JSON object per event (NDJSON)
+ *   --level=LEVEL     Only events at LEVEL or above (trace, debug, info, warning, error, critical)
+ *   --thread=NAME     Only events from threads named NAME (or with that numeric id)
+ *   --grep=TEXT       Only events whose message contains TEXT
+ *   --file=TEXT       Only events logged from source files containing TEXT
+ *   --since=SECONDS   Only events at least SECONDS after the file was opened
+ *   --until=SECONDS   Only events at most SECONDS after the file was opened
+ *   --stats           Per call site counts instead of events
+ */
+
+#include "engine/logging/binary_log.hpp"
+#include "engine/logging/flight_recorder.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace blog = omnicpp::log::binary;
+namespace flight = omnicpp::log::flight;
+
+namespace {
+
+struct Options {
+    std::string path;
+    bool json{ false };
+    bool stats{ false };
+    blog::Level level{ blog::Level::Trace };
+    std::string thread;
+    std::string grep;
+    std::string file;
+    double since{ 0.0 };
+    double until{ std::numeric_limits<double>::infinity() };
+};
+
+void usage() {
+    std::cerr << "usage: omnicpp_logcat [--json] [--stats] [--level=LEVEL] [--thread=NAME] [--grep=TEXT]\n"
+                 "                      [--file=TEXT] [--since=SECONDS] [--until=SECONDS] FILE\n";
+}
+
+std::optional<blog::Level> parse_level(std::string_view name) {
+    for (blog::Level level : { blog::Level::Trace, blog::Level::Debug, blog::Level::Info, blog::Level::Warning,
+                               blog::Level::Error, blog::Level::Critical }) {
+        if (name == blog::level_name(level)) {
+            return level;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<Options> parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const auto value = [&arg](std::string_view prefix) -> std::optional<std::string> {
+            if (arg.starts_with(prefix)) {
+                return std::string(arg.substr(prefix.size()));
+            }
+            return std::nullopt;
+        };
+
+        if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (auto level = value("--level=")) {
+            const auto parsed = parse_level(*level);
+            if (!parsed) {
+                std::cerr << "omnicpp_logcat: unknown level '" << *level << "'\n";
+                return std::nullopt;
+            }
+            options.level = *parsed;
+        } else if (auto thread = value("--thread=")) {
+            options.thread = *thread;
+        } else if (auto grep = value("--grep=")) {
+            options.grep = *grep;
+        } else if (auto file = value("--file=")) {
+            options.file = *file;
+        } else if (auto since = value("--since=")) {
+            options.since = std::strtod(since->c_str(), nullptr);
+        } else if (auto until = value("--until=")) {
+            options.until = std::strtod(until->c_str(), nullptr);
+        } else if (!arg.starts_with("--") && options.path.empty()) {
+            options.path = arg;
+        } else {
+            return std::nullopt;
+        }
+    }
+    if (options.path.empty()) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+std::string json_escape(std::string_view text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    for (const char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += std::format("\\u{:04x}", static_cast<int>(c));
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+std::string json_value(const blog::Value& value) {
+    switch (value.type) {
+        case blog::ArgType::Bool: return value.i != 0 ? "true" : "false";
+        case blog::ArgType::Int: return std::to_string(value.i);
+        case blog::ArgType::UInt: return std::to_string(value.u);
+        case blog::ArgType::F32:
+        case blog::ArgType::F64: return std::format("{}", value.f);
+        case blog::ArgType::Str: return "\"" + json_escape(value.s) + "\"";
+    }
+    return "null";
+}
+
+bool matches(const Options& options, const blog::DecodedEvent& event, const std::string& message) {
+    if (static_cast<uint8_t>(event.format->level) < static_cast<uint8_t>(options.level)) {
+        return false;
+    }
+    if (event.seconds < options.since || event.seconds > options.until) {
+        return false;
+    }
+    if (!options.thread.empty() && event.thread_name != options.thread &&
+        std::to_string(event.thread) != options.thread) {
+        return false;
+    }
+    if (!options.file.empty() && event.format->file.find(options.file) == std::string::npos) {
+        return false;
+    }
+    return options.grep.empty() || message.find(options.grep) != std::string::npos;
+}
+
+void print_text(const blog::DecodedEvent& event, const std::string& message) {
+    const std::string thread =
+        event.thread_name.empty() ? std::to_string(event.thread) : std::string(event.thread_name);
+    std::cout << std::format("{:>12.6f} {:<8} [{}] {}:{} {}\n", event.seconds, blog::level_name(event.format->level),
+                             thread, event.format->file, event.format->line, message);
+}
+
+void print_json(const blog::DecodedEvent& event, const std::string& message) {
+    std::string line = std::format(
+        "{{\"time\":{:.9f},\"unix_ns\":{},\"level\":\"{}\",\"thread\":{},\"thread_name\":\"{}\",\"file\":\"{}\","
+        "\"line\":{},\"format\":\"{}\",\"message\":\"{}\",\"args\":[",
+        event.seconds, event.unix_ns, blog::level_name(event.format->level), event.thread,
+        json_escape(event.thread_name), json_escape(event.format->file), event.format->line,
+        json_escape(event.format->format), json_escape(message));
+    for (std::size_t i = 0; i < event.args.size(); ++i) {
+        if (i > 0) {
+            line += ',';
+        }
+        line += json_value(event.args[i]);
+    }
+    line += "]}\n";
+    std::cout << line;
+}
+
+/**
+ * @brief Print or count the matching events of either reader
+ */
+template<typename Reader>
+int run(const Options& options, Reader& reader) {
+    if (!reader.open(options.path)) {
+        std::cerr << "omnicpp_logcat: " << options.path << ": " << reader.error() << '\n';
+        return 1;
+    }
+
+    std::vector<uint64_t> counts;
+    blog::DecodedEvent event;
+    while (reader.next(event)) {
+        const std::string message = event.message();
+        if (!matches(options, event, message)) {
+            continue;
+        }
+        if (options.stats) {
+            if (counts.size() <= event.format->id) {
+                counts.resize(event.format->id + 1);
+            }
+            ++counts[event.format->id];
+        } else if (options.json) {
+            print_json(event, message);
+        } else {
+            print_text(event, message);
+        }
+    }
+
+    if (options.stats) {
+        std::vector<uint32_t> sites;
+        for (uint32_t id = 0; id < counts.size(); ++id) {
+            if (counts[id] > 0) {
+                sites.push_back(id);
+            }
+        }
+        std::sort(sites.begin(), sites.end(), [&counts](uint32_t a, uint32_t b) { return counts[a] > counts[b]; });
+        for (const uint32_t id : sites) {
+            const blog::FormatInfo& format = reader.formats()[id];
+            std::cout << std::format("{:>10} {:<8} {}:{} \"{}\"\n", counts[id], blog::level_name(format.level),
+                                     format.file, format.line, format.format);
+        }
+    }
+    if (reader.dropped() > 0) {
+        std::cerr << "omnicpp_logcat: " << reader.dropped() << " events were dropped while logging\n";
+    }
+    if (!reader.error().empty()) {
+        std::cerr << "omnicpp_logcat: " << options.path << ": " << reader.error() << '\n';
+        return 1;
+    }
+    return 0;
+}
+
+bool is_flight_recorder(const std::string& path) {
+    char magic[sizeof(flight::FILE_MAGIC)] = {};
+    std::ifstream in(path, std::ios::binary);
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, flight::FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        usage();
+        return 2;
+    }
+
+    if (is_flight_recorder(options->path)) {
+        flight::FlightRecorderReader reader;
+        const int result = run(*options, reader);
+        if (reader.torn() > 0) {
+            std::cerr << "omnicpp_logcat: " << reader.torn() << " records were being written when the file was left\n";
+        }
+        return result;
+    }
+    blog::BinaryLogReader reader;
+    return run(*options, reader);
+}
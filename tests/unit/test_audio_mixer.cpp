@@ -0,0 +1,360 @@
+/**
+ * @file test_audio_mixer.cpp
+ * @brief Unit tests and throughput benchmark for the real-time mixer
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/audio/mixer.hpp"
+#include "engine/concurrency/SpscQueue.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+using namespace omnicpp::audio;
+
+namespace omnicpp {
+namespace test {
+
+namespace {
+
+constexpr uint32_t BLOCK = 256;
+
+std::shared_ptr<SoundData> ramp_sound(std::size_t frames, uint32_t channels = 1, uint32_t sample_rate = 48000) {
+    auto sound = std::make_shared<SoundData>();
+    sound->channels = channels;
+    sound->sample_rate = sample_rate;
+    sound->samples.resize(frames * channels);
+    for (std::size_t i = 0; i < sound->samples.size(); ++i) {
+        sound->samples[i] = static_cast<float>(i / channels % 100) * 0.01f;
+    }
+    return sound;
+}
+
+std::shared_ptr<SoundData> constant_sound(std::size_t frames, float value) {
+    auto sound = std::make_shared<SoundData>();
+    sound->samples.assign(frames, value);
+    return sound;
+}
+
+class MixerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MixerConfig config;
+        config.block_frames = BLOCK;
+        config.max_voices = 64;
+        ASSERT_TRUE(mixer.initialize(config));
+        block.resize(BLOCK * 2);
+    }
+
+    void render() { mixer.render(block); }
+
+    Mixer mixer;
+    std::vector<float> block;
+};
+
+} // namespace
+
+TEST(SpscQueueTest, PreservesOrderAcrossThreads) {
+    concurrency::SpscQueue<uint64_t> queue(64);
+    constexpr uint64_t COUNT = 100000;
+    std::thread producer([&]() {
+        for (uint64_t i = 0; i < COUNT;) {
+            if (queue.try_push(i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint64_t expected = 0;
+    while (expected < COUNT) {
+        if (auto value = queue.try_pop()) {
+            ASSERT_EQ(*value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(MixerTest, CentredMonoVoiceIsConstantPower) {
+    const SoundId sound = mixer.add_sound(ramp_sound(4800));
+    ASSERT_NE(sound, INVALID_SOUND);
+    ASSERT_TRUE(mixer.play(sound).valid());
+    render();
+
+    const float centre = std::cos(3.14159265f / 4.0f);
+    for (uint32_t i = 0; i < BLOCK; ++i) {
+        const float sample = static_cast<float>(i % 100) * 0.01f;
+        ASSERT_NEAR(block[i * 2], sample * centre, 1e-6f) << "frame " << i;
+        ASSERT_NEAR(block[i * 2 + 1], sample * centre, 1e-6f) << "frame " << i;
+    }
+}
+
+TEST_F(MixerTest, HardPanSilencesTheOtherChannel) {
+    const SoundId sound = mixer.add_sound(constant_sound(4800, 0.5f));
+    VoiceParams params;
+    params.pan = -1.0f;
+    mixer.play(sound, params);
+    render();
+    EXPECT_NEAR(block[10], 0.5f, 1e-6f);
+    EXPECT_NEAR(block[11], 0.0f, 1e-6f);
+}
+
+TEST_F(MixerTest, StereoSoundKeepsChannelsApart) {
+    auto sound = std::make_shared<SoundData>();
+    sound->channels = 2;
+    for (int i = 0; i < 1000; ++i) {
+        sound->samples.push_back(0.25f);
+        sound->samples.push_back(-0.5f);
+    }
+    mixer.play(mixer.add_sound(sound));
+    render();
+    for (uint32_t i = 0; i < BLOCK; ++i) {
+        ASSERT_FLOAT_EQ(block[i * 2], 0.25f);
+        ASSERT_FLOAT_EQ(block[i * 2 + 1], -0.5f);
+    }
+}
+
+TEST_F(MixerTest, ResamplesLowerRateSoundsWithInterpolation) {
+    // 24 kHz into a 48 kHz mixer: every other output frame is a midpoint
+    auto sound = std::make_shared<SoundData>();
+    sound->sample_rate = 24000;
+    for (int i = 0; i < 200; ++i) {
+        sound->samples.push_back(static_cast<float>(i) * 0.001f);
+    }
+    VoiceParams params;
+    params.pan = -1.0f;
+    mixer.play(mixer.add_sound(sound), params);
+    render();
+    for (uint32_t i = 0; i < BLOCK; ++i) {
+        ASSERT_NEAR(block[i * 2], static_cast<float>(i) * 0.0005f, 1e-6f) << "frame " << i;
+    }
+
+    // 200 source frames last 400 output frames, then the voice ends
+    render();
+    EXPECT_NEAR(block[(399 - BLOCK) * 2], 0.0995f, 1e-6f);
+    EXPECT_FLOAT_EQ(block[(400 - BLOCK) * 2], 0.0f);
+    mixer.update();
+    EXPECT_EQ(mixer.get_active_voice_count(), 0u);
+}
+
+TEST_F(MixerTest, PitchChangesPlaybackRate) {
+    const SoundId sound = mixer.add_sound(ramp_sound(10 * BLOCK));
+    VoiceParams params;
+    params.pitch = 2.0f;
+    const VoiceHandle voice = mixer.play(sound, params);
+    for (int i = 0; i < 4; ++i) {
+        render();
+    }
+    mixer.update();
+    EXPECT_TRUE(mixer.is_playing(voice));
+    render(); // The last source frame
+    render(); // Sees the end
+    mixer.update();
+    EXPECT_FALSE(mixer.is_playing(voice)) << "double speed should finish in half the blocks";
+}
+
+TEST_F(MixerTest, OneShotVoicesAreRecycledAndLoopsContinue) {
+    const SoundId shot = mixer.add_sound(constant_sound(100, 0.1f));
+    const SoundId loop = mixer.add_sound(constant_sound(100, 0.2f));
+    const VoiceHandle once = mixer.play(shot);
+    VoiceParams looping;
+    looping.loop = true;
+    looping.pan = 1.0f;
+    const VoiceHandle forever = mixer.play(loop, looping);
+    EXPECT_EQ(mixer.get_active_voice_count(), 2u);
+
+    for (int i = 0; i < 4; ++i) {
+        render();
+        for (uint32_t f = 0; f < BLOCK; ++f) {
+            ASSERT_NEAR(block[f * 2 + 1], 0.2f + (i == 0 && f < 100 ? 0.1f * std::sin(3.14159265f / 4.0f) : 0.0f),
+                        1e-5f) << "block " << i << " frame " << f;
+        }
+    }
+    EXPECT_TRUE(mixer.is_playing(once)) << "still playing until update() sees it finish";
+    mixer.update();
+    EXPECT_FALSE(mixer.is_playing(once));
+    EXPECT_TRUE(mixer.is_playing(forever));
+    EXPECT_FALSE(mixer.stop(once)) << "stale handles are rejected";
+}
+
+TEST_F(MixerTest, StopFadesOutOverOneBlock) {
+    const VoiceHandle voice = mixer.play(mixer.add_sound(constant_sound(48000, 0.5f)));
+    render();
+    ASSERT_TRUE(mixer.stop(voice));
+    render();
+    EXPECT_GT(block[0], block[(BLOCK / 2) * 2]);
+    EXPECT_GT(block[(BLOCK / 2) * 2], block[(BLOCK - 2) * 2]);
+    EXPECT_NEAR(block[(BLOCK - 1) * 2], 0.0f, 1e-6f);
+    render();
+    EXPECT_FLOAT_EQ(block[0], 0.0f);
+    mixer.update();
+    EXPECT_FALSE(mixer.is_playing(voice));
+}
+
+TEST_F(MixerTest, PausedVoicesHoldTheirPosition) {
+    const VoiceHandle voice = mixer.play(mixer.add_sound(ramp_sound(4800)), {1.0f, -1.0f});
+    render();
+    mixer.pause(voice);
+    render();
+    EXPECT_FLOAT_EQ(block[20], 0.0f);
+    mixer.resume(voice);
+    render();
+    EXPECT_NEAR(block[0], static_cast<float>(BLOCK % 100) * 0.01f, 1e-6f);
+}
+
+TEST_F(MixerTest, MasterGainAndClipping) {
+    mixer.play(mixer.add_sound(constant_sound(48000, 0.9f)), {1.0f, -1.0f});
+    mixer.play(mixer.add_sound(constant_sound(48000, 0.9f)), {1.0f, -1.0f});
+    render();
+    EXPECT_FLOAT_EQ(block[0], 1.0f) << "the sum is clamped";
+    mixer.set_master_gain(0.25f);
+    render(); // Ramp
+    render();
+    EXPECT_NEAR(block[0], 0.45f, 1e-6f);
+}
+
+TEST_F(MixerTest, RemovedSoundsAreReleasedOnceSilent) {
+    auto data = constant_sound(48000, 0.5f);
+    std::weak_ptr<SoundData> watch = data;
+    const SoundId sound = mixer.add_sound(std::move(data));
+    mixer.play(sound);
+    mixer.remove_sound(sound);
+    EXPECT_FALSE(watch.expired()) << "a voice may still be reading it";
+    EXPECT_FALSE(mixer.play(sound).valid());
+    render();
+    mixer.update();
+    EXPECT_TRUE(watch.expired());
+}
+
+TEST_F(MixerTest, VoiceExhaustionAndFullCommandQueueFailCleanly) {
+    const SoundId sound = mixer.add_sound(constant_sound(48000, 0.1f));
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_TRUE(mixer.play(sound).valid());
+    }
+    EXPECT_FALSE(mixer.play(sound).valid());
+
+    Mixer small;
+    MixerConfig config;
+    config.command_capacity = 4;
+    ASSERT_TRUE(small.initialize(config));
+    const SoundId other = small.add_sound(constant_sound(48000, 0.1f));
+    int accepted = 0;
+    for (int i = 0; i < 10; ++i) {
+        accepted += small.play(other).valid() ? 1 : 0;
+    }
+    EXPECT_EQ(accepted, 4);
+    EXPECT_EQ(small.get_stats().dropped_commands, 6u);
+    EXPECT_EQ(small.get_active_voice_count(), 4u) << "rejected plays must not leak voices";
+}
+
+TEST(MixerOutputTest, WritesWavFileFromTheMixerThread) {
+    const auto path = std::filesystem::temp_directory_path() / "omnicpp_mixer_test.wav";
+    Mixer mixer;
+    ASSERT_TRUE(mixer.initialize());
+    mixer.play(mixer.add_sound(constant_sound(4800, 0.5f)));
+    ASSERT_TRUE(mixer.start_output(std::make_unique<WavFileOutput>(path.string())));
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (mixer.get_stats().blocks < 20 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    mixer.stop_output();
+    const uint64_t blocks = mixer.get_stats().blocks;
+    ASSERT_GE(blocks, 20u);
+
+    std::FILE* file = std::fopen(path.string().c_str(), "rb");
+    ASSERT_NE(file, nullptr);
+    uint8_t header[44];
+    ASSERT_EQ(std::fread(header, 1, sizeof(header), file), sizeof(header));
+    float first[2];
+    ASSERT_EQ(std::fread(first, sizeof(float), 2, file), 2u);
+    std::fclose(file);
+
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(header), 4), "RIFF");
+    EXPECT_EQ(header[20], 3) << "IEEE float";
+    uint32_t data_bytes = 0;
+    std::memcpy(&data_bytes, header + 40, 4);
+    EXPECT_EQ(data_bytes, blocks * mixer.get_config().block_frames * 2 * sizeof(float));
+    EXPECT_EQ(std::filesystem::file_size(path), 44 + data_bytes);
+    EXPECT_NEAR(first[0], 0.5f * std::cos(3.14159265f / 4.0f), 1e-6f);
+    std::filesystem::remove(path);
+}
+
+TEST(MixerOutputTest, ControlThreadDrivesRunningMixer) {
+    Mixer mixer;
+    MixerConfig config;
+    config.max_voices = 32;
+    ASSERT_TRUE(mixer.initialize(config));
+    const SoundId sound = mixer.add_sound(constant_sound(2000, 0.01f));
+    ASSERT_TRUE(mixer.start_output(std::make_unique<NullAudioOutput>(true)));
+
+    // Start, retune and stop voices from this thread while the mixer thread runs
+    int played = 0;
+    for (int i = 0; i < 200; ++i) {
+        if (auto voice = mixer.play(sound, {0.5f, static_cast<float>(i % 3) - 1.0f}); voice.valid()) {
+            ++played;
+            mixer.set_pitch(voice, 1.5f);
+            if (i % 4 == 0) {
+                mixer.stop(voice);
+            }
+        }
+        mixer.update();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    EXPECT_TRUE(mixer.is_output_running());
+    mixer.stop_output();
+    std::vector<float> block(BLOCK * 2);
+    mixer.render(block); // Apply whatever commands are left on this thread
+    mixer.update();
+    EXPECT_GT(played, 32) << "finished voices should have been recycled";
+    EXPECT_GT(mixer.get_stats().blocks, 0u);
+    EXPECT_EQ(mixer.get_stats().dropped_commands, 0u);
+}
+
+TEST(MixerBenchmarkTest, VoicesMixedPerMillisecond) {
+    constexpr uint32_t VOICES = 256;
+    constexpr int BLOCKS = 400;
+    Mixer mixer;
+    MixerConfig config;
+    config.max_voices = VOICES;
+    config.command_capacity = 2 * VOICES;
+    ASSERT_TRUE(mixer.initialize(config));
+
+    // A realistic spread: unity-rate mono, 44.1 kHz mono, pitched stereo
+    const SoundId unity = mixer.add_sound(ramp_sound(48000));
+    const SoundId cd_rate = mixer.add_sound(ramp_sound(44100, 1, 44100));
+    const SoundId stereo = mixer.add_sound(ramp_sound(48000, 2));
+    for (uint32_t i = 0; i < VOICES; ++i) {
+        VoiceParams params;
+        params.loop = true;
+        params.gain = 0.01f;
+        params.pan = static_cast<float>(i % 5) * 0.5f - 1.0f;
+        params.pitch = i % 3 == 2 ? 1.25f : 1.0f;
+        ASSERT_TRUE(mixer.play(i % 3 == 0 ? unity : (i % 3 == 1 ? cd_rate : stereo), params).valid());
+    }
+
+    std::vector<float> block(config.block_frames * 2);
+    for (int i = 0; i < BLOCKS; ++i) {
+        mixer.render(block);
+    }
+    const auto stats = mixer.get_stats();
+    ASSERT_EQ(stats.voices_mixed, static_cast<uint64_t>(VOICES) * BLOCKS);
+
+    const double ms = static_cast<double>(stats.mix_ns) / 1e6;
+    const double voices_per_ms = static_cast<double>(stats.voices_mixed) / ms;
+    const double block_ms = 1000.0 * config.block_frames / config.sample_rate;
+    // All 256 voices must mix in well under the block's own playback time
+    EXPECT_GT(voices_per_ms * block_ms, 2.0 * VOICES);
+    RecordProperty("voices_per_ms", static_cast<int>(voices_per_ms));
+    RecordProperty("realtime_voice_capacity", static_cast<int>(voices_per_ms * block_ms));
+}
+
+} // namespace test
+} // namespace omnicpp
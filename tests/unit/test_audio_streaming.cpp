@@ -0,0 +1,371 @@
+/**
+ * @file test_audio_streaming.cpp
+ * @brief Unit tests for audio decoders, streamed playback and the sound library
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/audio/decoder.hpp"
+#include "engine/audio/mixer.hpp"
+#include "engine/audio/sound_library.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+using namespace omnicpp::audio;
+
+namespace omnicpp {
+namespace test {
+
+namespace {
+
+constexpr uint32_t BLOCK = 256;
+
+float generated_sample(uint64_t frame, uint32_t channel) {
+    // Never zero, so silence in the output always means "no data"
+    return 0.01f + static_cast<float>(frame % 1000) * 0.0009f + static_cast<float>(channel) * 0.1f;
+}
+
+/**
+ * @brief Synthesizes a known signal; can stall at a frame until released
+ */
+class GeneratorDecoder final : public AudioDecoder {
+public:
+    GeneratorDecoder(uint64_t frames, uint32_t channels = 1, uint32_t sample_rate = 48000)
+        : m_frames(frames), m_channels(channels), m_sample_rate(sample_rate) {}
+
+    void stall_at(uint64_t frame, std::atomic<bool>* release) {
+        m_stall_at = frame;
+        m_release = release;
+    }
+
+    uint32_t channels() const override { return m_channels; }
+    uint32_t sample_rate() const override { return m_sample_rate; }
+    uint64_t frame_count() const override { return m_frames; }
+
+    std::size_t read(std::span<float> out) override {
+        if (m_release && m_cursor >= m_stall_at) {
+            while (!m_release->load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        std::size_t frames = std::min<uint64_t>(out.size() / m_channels, m_frames - m_cursor);
+        if (m_release && m_cursor < m_stall_at) {
+            frames = std::min<uint64_t>(frames, m_stall_at - m_cursor);
+        }
+        for (std::size_t i = 0; i < frames; ++i) {
+            for (uint32_t c = 0; c < m_channels; ++c) {
+                out[i * m_channels + c] = generated_sample(m_cursor + i, c);
+            }
+        }
+        m_cursor += frames;
+        return frames;
+    }
+
+    bool seek(uint64_t frame) override {
+        m_cursor = std::min(frame, m_frames);
+        return true;
+    }
+
+private:
+    uint64_t m_frames;
+    uint32_t m_channels;
+    uint32_t m_sample_rate;
+    uint64_t m_cursor{0};
+    uint64_t m_stall_at{0};
+    std::atomic<bool>* m_release{nullptr};
+};
+
+void write_wav(const std::filesystem::path& path, uint16_t format, uint16_t bits, uint16_t channels,
+               uint32_t rate, const std::vector<float>& samples) {
+    std::vector<uint8_t> data;
+    for (float sample : samples) {
+        if (format == 3) {
+            uint8_t bytes[4];
+            std::memcpy(bytes, &sample, 4);
+            data.insert(data.end(), bytes, bytes + 4);
+        } else if (bits == 16) {
+            const auto value = static_cast<int16_t>(std::lround(sample * 32767.0f));
+            data.push_back(static_cast<uint8_t>(value));
+            data.push_back(static_cast<uint8_t>(value >> 8));
+        } else {
+            const auto value = static_cast<int32_t>(std::lround(sample * 8388607.0f));
+            data.push_back(static_cast<uint8_t>(value));
+            data.push_back(static_cast<uint8_t>(value >> 8));
+            data.push_back(static_cast<uint8_t>(value >> 16));
+        }
+    }
+    auto u16 = [](std::vector<uint8_t>& out, uint16_t v) {
+        out.push_back(static_cast<uint8_t>(v));
+        out.push_back(static_cast<uint8_t>(v >> 8));
+    };
+    auto u32 = [&](std::vector<uint8_t>& out, uint32_t v) {
+        u16(out, static_cast<uint16_t>(v));
+        u16(out, static_cast<uint16_t>(v >> 16));
+    };
+    std::vector<uint8_t> file = {'R', 'I', 'F', 'F'};
+    u32(file, static_cast<uint32_t>(4 + 8 + 16 + 8 + 6 + 8 + data.size()));
+    file.insert(file.end(), {'W', 'A', 'V', 'E', 'L', 'I', 'S', 'T'});
+    u32(file, 6); // An unrelated chunk the decoder must skip
+    file.insert(file.end(), {'i', 'n', 'f', 'o', '!', '!'});
+    file.insert(file.end(), {'f', 'm', 't', ' '});
+    u32(file, 16);
+    u16(file, format);
+    u16(file, channels);
+    u32(file, rate);
+    u32(file, rate * channels * bits / 8);
+    u16(file, static_cast<uint16_t>(channels * bits / 8));
+    u16(file, bits);
+    file.insert(file.end(), {'d', 'a', 't', 'a'});
+    u32(file, static_cast<uint32_t>(data.size()));
+    file.insert(file.end(), data.begin(), data.end());
+
+    std::FILE* out = std::fopen(path.string().c_str(), "wb");
+    ASSERT_NE(out, nullptr);
+    std::fwrite(file.data(), 1, file.size(), out);
+    std::fclose(out);
+}
+
+MixerConfig streaming_config() {
+    MixerConfig config;
+    config.block_frames = BLOCK;
+    config.max_streams = 2;
+    config.stream_buffer_frames = 16384;
+    config.stream_chunk_frames = 2048;
+    config.stream_low_watermark = 8192;
+    return config;
+}
+
+/**
+ * @brief Render until `frames` frames have been collected, pacing so the decoder thread keeps up
+ */
+std::vector<float> render_left(Mixer& mixer, std::size_t frames) {
+    std::vector<float> block(BLOCK * 2);
+    std::vector<float> left;
+    while (left.size() < frames) {
+        mixer.render(block);
+        for (uint32_t i = 0; i < BLOCK; ++i) {
+            left.push_back(block[i * 2]);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return left;
+}
+
+std::size_t first_sound(const std::vector<float>& samples) {
+    std::size_t i = 0;
+    while (i < samples.size() && samples[i] == 0.0f) {
+        ++i;
+    }
+    return i;
+}
+
+class AudioStreamingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() / "omnicpp_audio_streaming";
+        std::filesystem::create_directories(directory);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(directory); }
+
+    std::filesystem::path directory;
+};
+
+} // namespace
+
+TEST_F(AudioStreamingTest, WavDecoderReadsIntegerAndFloatPcm) {
+    const std::vector<float> stereo = {0.5f, -0.5f, 0.25f, -0.25f, 0.0f, 1.0f};
+    write_wav(directory / "s16.wav", 1, 16, 2, 44100, stereo);
+    write_wav(directory / "s24.wav", 1, 24, 1, 22050, stereo);
+    write_wav(directory / "f32.wav", 3, 32, 2, 48000, stereo);
+
+    WavDecoder s16;
+    ASSERT_TRUE(s16.open((directory / "s16.wav").string()));
+    EXPECT_EQ(s16.channels(), 2u);
+    EXPECT_EQ(s16.sample_rate(), 44100u);
+    EXPECT_EQ(s16.frame_count(), 3u);
+    std::vector<float> out(8, -9.0f);
+    ASSERT_EQ(s16.read(out), 3u);
+    for (std::size_t i = 0; i < stereo.size(); ++i) {
+        EXPECT_NEAR(out[i], stereo[i], 1.0f / 32768.0f);
+    }
+    EXPECT_EQ(s16.read(out), 0u);
+    ASSERT_TRUE(s16.seek(2));
+    ASSERT_EQ(s16.read(out), 1u);
+    EXPECT_NEAR(out[1], 1.0f, 1.0f / 32768.0f);
+
+    WavDecoder s24;
+    ASSERT_TRUE(s24.open((directory / "s24.wav").string()));
+    EXPECT_EQ(s24.frame_count(), 6u);
+    ASSERT_EQ(s24.read(out), 6u);
+    EXPECT_NEAR(out[1], -0.5f, 1e-6f);
+
+    WavDecoder f32;
+    ASSERT_TRUE(f32.open((directory / "f32.wav").string()));
+    ASSERT_EQ(f32.read(out), 3u);
+    EXPECT_FLOAT_EQ(out[3], -0.25f);
+
+    WavDecoder missing;
+    EXPECT_FALSE(missing.open((directory / "missing.wav").string()));
+}
+
+TEST_F(AudioStreamingTest, RegistryDispatchesByExtension) {
+    write_wav(directory / "tone.WAV", 1, 16, 1, 48000, {0.1f, 0.2f});
+    DecoderRegistry registry;
+    EXPECT_NE(registry.open((directory / "tone.WAV").string()), nullptr);
+    EXPECT_EQ(registry.open((directory / "tone.ogg").string()), nullptr);
+
+    registry.register_decoder(".ogg", [](const std::string&) -> std::unique_ptr<AudioDecoder> {
+        return std::make_unique<GeneratorDecoder>(10);
+    });
+    auto decoder = registry.open("music/theme.ogg");
+    ASSERT_NE(decoder, nullptr);
+    EXPECT_EQ(decoder->frame_count(), 10u);
+}
+
+TEST(AudioStreamTest, StreamedPlaybackMatchesResident) {
+    constexpr uint64_t FRAMES = 48000;
+    GeneratorDecoder source(FRAMES);
+    auto resident = decode_all(source);
+    ASSERT_NE(resident, nullptr);
+    ASSERT_EQ(resident->frame_count(), FRAMES);
+
+    VoiceParams params;
+    params.pan = -1.0f;
+    params.pitch = 1.3f;
+
+    Mixer reference;
+    ASSERT_TRUE(reference.initialize(streaming_config()));
+    reference.play(reference.add_sound(resident), params);
+    std::vector<float> expected;
+    std::vector<float> block(BLOCK * 2);
+    for (int b = 0; b < 160; ++b) {
+        reference.render(block);
+        for (uint32_t i = 0; i < BLOCK; ++i) {
+            expected.push_back(block[i * 2]);
+        }
+    }
+
+    Mixer mixer;
+    ASSERT_TRUE(mixer.initialize(streaming_config()));
+    const VoiceHandle voice = mixer.play_stream(std::make_unique<GeneratorDecoder>(FRAMES), params);
+    ASSERT_TRUE(voice.valid());
+    const auto streamed = render_left(mixer, expected.size() + 20 * BLOCK);
+
+    const std::size_t start = first_sound(streamed);
+    ASSERT_LT(start, streamed.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(streamed[start + i], expected[i]) << "frame " << i;
+    }
+    EXPECT_EQ(mixer.get_stats().stream_underruns, 0u);
+    EXPECT_EQ(mixer.get_stats().stream_frames_decoded, FRAMES);
+
+    mixer.update();
+    EXPECT_FALSE(mixer.is_playing(voice)) << "the stream ended, so the voice should have finished";
+}
+
+TEST(AudioStreamTest, LoopsAreSeamless) {
+    Mixer mixer;
+    ASSERT_TRUE(mixer.initialize(streaming_config()));
+    VoiceParams params;
+    params.pan = -1.0f;
+    params.loop = true;
+    ASSERT_TRUE(mixer.play_stream(std::make_unique<GeneratorDecoder>(700), params).valid());
+
+    const auto out = render_left(mixer, 40 * BLOCK);
+    const std::size_t start = first_sound(out);
+    ASSERT_LT(start + 5000, out.size());
+    for (std::size_t i = 0; i < 5000; ++i) {
+        ASSERT_FLOAT_EQ(out[start + i], generated_sample(i % 700, 0)) << "frame " << i;
+    }
+    EXPECT_EQ(mixer.get_stats().stream_underruns, 0u);
+}
+
+TEST(AudioStreamTest, StreamsAreRecycledAndLimited) {
+    Mixer mixer;
+    ASSERT_TRUE(mixer.initialize(streaming_config()));
+    const VoiceHandle a = mixer.play_stream(std::make_unique<GeneratorDecoder>(1000));
+    const VoiceHandle b = mixer.play_stream(std::make_unique<GeneratorDecoder>(1000));
+    ASSERT_TRUE(a.valid());
+    ASSERT_TRUE(b.valid());
+    EXPECT_FALSE(mixer.play_stream(std::make_unique<GeneratorDecoder>(1000)).valid()) << "max_streams is 2";
+
+    mixer.stop(a);
+    render_left(mixer, BLOCK);
+    mixer.update();
+    EXPECT_FALSE(mixer.is_playing(a));
+    EXPECT_TRUE(mixer.play_stream(std::make_unique<GeneratorDecoder>(1000)).valid()) << "a's ring was recycled";
+}
+
+TEST(AudioStreamTest, UnderrunKeepsTheVoiceAlive) {
+    Mixer mixer;
+    ASSERT_TRUE(mixer.initialize(streaming_config()));
+    std::atomic<bool> release{false};
+    auto decoder = std::make_unique<GeneratorDecoder>(48000);
+    decoder->stall_at(4 * BLOCK, &release); // A disk that stops responding
+    VoiceParams params;
+    params.pan = -1.0f;
+    const VoiceHandle voice = mixer.play_stream(std::move(decoder), params);
+
+    auto out = render_left(mixer, 16 * BLOCK);
+    EXPECT_GT(mixer.get_stats().stream_underruns, 0u);
+    mixer.update();
+    EXPECT_TRUE(mixer.is_playing(voice));
+
+    release = true;
+    const auto resumed = render_left(mixer, 16 * BLOCK);
+    out.insert(out.end(), resumed.begin(), resumed.end());
+
+    // Played up to the stall, went silent, then carried on from where it stopped
+    const std::size_t start = first_sound(out);
+    std::size_t frame = 0;
+    for (std::size_t i = start; i < out.size() && frame < 4 * BLOCK + 1000; ++i) {
+        if (out[i] != 0.0f) {
+            ASSERT_FLOAT_EQ(out[i], generated_sample(frame, 0)) << "frame " << frame;
+            ++frame;
+        }
+    }
+    EXPECT_GE(frame, 4 * BLOCK + 1000u);
+}
+
+TEST_F(AudioStreamingTest, LibraryKeepsShortSoundsResidentAndStreamsLongOnes) {
+    std::vector<float> short_samples(1000, 0.25f);
+    std::vector<float> long_samples(100000, 0.5f);
+    write_wav(directory / "click.wav", 1, 16, 1, 48000, short_samples);
+    write_wav(directory / "music.wav", 1, 16, 1, 48000, long_samples);
+
+    Mixer mixer;
+    ASSERT_TRUE(mixer.initialize(streaming_config()));
+    SoundLibraryConfig config;
+    config.resident_limit_bytes = 64 * 1024;
+    SoundLibrary library(mixer, config);
+
+    const SoundAsset click = library.load((directory / "click.wav").string());
+    const SoundAsset music = library.load((directory / "music.wav").string());
+    ASSERT_TRUE(click.valid());
+    ASSERT_TRUE(music.valid());
+    EXPECT_FALSE(click.streamed);
+    EXPECT_TRUE(music.streamed);
+    EXPECT_EQ(library.get_resident_bytes(), 1000 * sizeof(float));
+    EXPECT_EQ(library.load((directory / "click.wav").string()).sound, click.sound) << "loads are cached";
+    EXPECT_FALSE(library.load((directory / "missing.wav").string()).valid());
+
+    VoiceParams left;
+    left.pan = -1.0f;
+    ASSERT_TRUE(library.play(music, left).valid());
+    ASSERT_TRUE(library.play(click, left).valid());
+    const auto out = render_left(mixer, 20 * BLOCK);
+    EXPECT_NEAR(out.back(), 0.5f, 1e-4f) << "the streamed track is playing";
+    EXPECT_GT(mixer.get_stats().stream_frames_decoded, 0u);
+
+    library.unload((directory / "click.wav").string());
+    EXPECT_EQ(library.get_resident_bytes(), 0u);
+}
+
+} // namespace test
+} // namespace omnicpp
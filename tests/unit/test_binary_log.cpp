@@ -0,0 +1,240 @@
+/**
+ * @file test_binary_log.cpp
+ * @brief Unit tests and benchmark for the binary structured log
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/logging/binary_log.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace omnicpp {
+namespace test {
+
+namespace blog = log::binary;
+
+namespace {
+
+enum class Weapon : uint8_t { Sword = 3, Bow = 7 };
+
+std::vector<blog::DecodedEvent> read_all(const std::filesystem::path& path, blog::BinaryLogReader& reader) {
+    std::vector<blog::DecodedEvent> events;
+    EXPECT_TRUE(reader.open(path.string())) << reader.error();
+    blog::DecodedEvent event;
+    while (reader.next(event)) {
+        events.push_back(event);
+    }
+    EXPECT_TRUE(reader.error().empty()) << reader.error();
+    return events;
+}
+
+} // namespace
+
+class BinaryLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_path = std::filesystem::temp_directory_path() / "omnicpp_binary_log_test.blog";
+    }
+
+    void TearDown() override {
+        blog::close();
+        std::filesystem::remove(m_path);
+    }
+
+    std::filesystem::path m_path;
+};
+
+TEST_F(BinaryLogTest, RoundTripsArgumentsAndFormatting) {
+    ASSERT_TRUE(blog::open(m_path.string()));
+    blog::set_thread_name("main");
+    const std::string name = "goblin";
+    BLOG_INFO("Spawned {} #{} at {:.1f},{:.1f}", name, 42u, 1.25f, -3.5);
+    BLOG_WARN("hp {} -> {} ({})", 10, -5, true);
+    BLOG_ERROR("weapon {0} {{literal}} {1}", Weapon::Bow, "bow");
+    BLOG_DEBUG("no arguments");
+    blog::close();
+
+    blog::BinaryLogReader reader;
+    const auto events = read_all(m_path, reader);
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0].message(), "Spawned goblin #42 at 1.2,-3.5");
+    EXPECT_EQ(events[1].message(), "hp 10 -> -5 (true)");
+    EXPECT_EQ(events[2].message(), "weapon 7 {literal} bow");
+    EXPECT_EQ(events[3].message(), "no arguments");
+
+    EXPECT_EQ(events[0].format->level, blog::Level::Info);
+    EXPECT_EQ(events[1].format->level, blog::Level::Warning);
+    EXPECT_EQ(events[0].thread_name, "main");
+    EXPECT_NE(events[0].format->file.find("test_binary_log.cpp"), std::string::npos);
+    EXPECT_EQ(events[1].args[1].i, -5);
+    EXPECT_EQ(events[0].args[0].s, "goblin");
+    for (std::size_t i = 1; i < events.size(); ++i) {
+        EXPECT_GE(events[i].ticks, events[i - 1].ticks);
+        EXPECT_GE(events[i].seconds, 0.0);
+    }
+}
+
+TEST_F(BinaryLogTest, FormatIsWrittenOncePerSite) {
+    ASSERT_TRUE(blog::open(m_path.string()));
+    for (int i = 0; i < 1000; ++i) {
+        BLOG_INFO("tick {}", i);
+    }
+    blog::close();
+
+    blog::BinaryLogReader reader;
+    const auto events = read_all(m_path, reader);
+    ASSERT_EQ(events.size(), 1000u);
+    EXPECT_EQ(events[999].message(), "tick 999");
+
+    // Small deltas and small integers: a few bytes per event, not a line of text
+    const auto size = std::filesystem::file_size(m_path);
+    EXPECT_LT(size, 1000u * 8u);
+}
+
+TEST_F(BinaryLogTest, SitesAreDescribedAgainInEachFile) {
+    const auto log_once = [] { BLOG_INFO("reopened {}", 1); };
+    ASSERT_TRUE(blog::open(m_path.string()));
+    log_once();
+    blog::close();
+    ASSERT_TRUE(blog::open(m_path.string()));
+    log_once();
+    blog::close();
+
+    blog::BinaryLogReader reader;
+    const auto events = read_all(m_path, reader);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].message(), "reopened 1");
+}
+
+TEST_F(BinaryLogTest, ThreadsAndLevelFilter) {
+    blog::BinaryLogConfig config;
+    config.min_level = blog::Level::Info;
+    ASSERT_TRUE(blog::open(m_path.string(), config));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            blog::set_thread_name(std::format("worker-{}", t));
+            for (int i = 0; i < 100; ++i) {
+                BLOG_INFO("worker {} step {}", t, i);
+                BLOG_DEBUG("filtered {}", i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    blog::close();
+
+    blog::BinaryLogReader reader;
+    const auto events = read_all(m_path, reader);
+    ASSERT_EQ(events.size(), 400u);
+    std::vector<int> next(4, 0);
+    for (const auto& event : events) {
+        const auto worker = static_cast<std::size_t>(event.args[0].i);
+        ASSERT_LT(worker, 4u);
+        EXPECT_EQ(event.thread_name, std::format("worker-{}", worker));
+        EXPECT_EQ(event.args[1].i, next[worker]++); // Each thread's events stay in order
+    }
+}
+
+TEST_F(BinaryLogTest, LongStringsAreTruncatedToOneRecord) {
+    ASSERT_TRUE(blog::open(m_path.string()));
+    const std::string huge(10000, 'x');
+    BLOG_INFO("{} then {}", huge, 7);
+    blog::close();
+
+    blog::BinaryLogReader reader;
+    const auto events = read_all(m_path, reader);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_GT(events[0].args[0].s.size(), 100u);
+    EXPECT_LT(events[0].args[0].s.size(), blog::MAX_RECORD);
+    EXPECT_EQ(events[0].args[1].i, 7);
+}
+
+TEST_F(BinaryLogTest, FullRingDropsAndCounts) {
+    blog::BinaryLogConfig config;
+    config.ring_bytes = 4096;
+    config.flush_interval_ms = 60000; // Writer only runs on flush()
+    ASSERT_TRUE(blog::open(m_path.string(), config));
+    const std::string payload(200, 'p');
+    // Fresh thread so the small ring size applies
+    std::thread producer([&] {
+        for (int i = 0; i < 100; ++i) {
+            BLOG_INFO("{} {}", payload, i);
+        }
+    });
+    producer.join();
+    const auto stats = blog::get_stats();
+    EXPECT_GT(stats.dropped, 0u);
+    blog::close();
+
+    blog::BinaryLogReader reader;
+    const auto events = read_all(m_path, reader);
+    EXPECT_GT(events.size(), 0u);
+    EXPECT_EQ(events.size() + reader.dropped(), 100u);
+}
+
+TEST_F(BinaryLogTest, RejectsOtherFiles) {
+    {
+        std::ofstream out(m_path);
+        out << "plain text log line\n";
+    }
+    blog::BinaryLogReader reader;
+    EXPECT_FALSE(reader.open(m_path.string()));
+    EXPECT_FALSE(reader.error().empty());
+}
+
+TEST_F(BinaryLogTest, BenchmarkCallerLatencyAndSize) {
+    using Clock = std::chrono::steady_clock;
+    constexpr int CALLS = 20000;
+    constexpr int ROUNDS = 5;
+    ASSERT_TRUE(blog::open(m_path.string()));
+    const std::string name = "entity";
+    const auto per_call_ns = [](Clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / CALLS;
+    };
+
+    // Best of several interleaved rounds, so one preempted round cannot decide the comparison
+    BLOG_INFO("{} {} moved to {:.2f}", name, 0, 0.0); // Register the site outside the timing
+    double binary_ns = 1e9;
+    double format_ns = 1e9;
+    std::size_t text_bytes = 0;
+    for (int round = 0; round < ROUNDS; ++round) {
+        auto start = Clock::now();
+        for (int i = 0; i < CALLS; ++i) {
+            BLOG_INFO("{} {} moved to {:.2f}", name, i, i * 0.5);
+            if (i % 4096 == 0) {
+                blog::flush(); // Keep the ring from filling on a single core
+            }
+        }
+        binary_ns = std::min(binary_ns, per_call_ns(start));
+        blog::flush();
+
+        text_bytes = 0;
+        start = Clock::now();
+        for (int i = 0; i < CALLS; ++i) {
+            text_bytes += std::format("{} {} moved to {:.2f}", name, i, i * 0.5).size();
+        }
+        format_ns = std::min(format_ns, per_call_ns(start));
+    }
+    blog::close();
+    const double binary_bytes =
+        static_cast<double>(std::filesystem::file_size(m_path)) / (static_cast<double>(CALLS) * ROUNDS + 1);
+
+    // Cheaper than formatting the message, and smaller than its text before any timestamp or level prefix
+    EXPECT_LT(binary_ns, format_ns);
+    EXPECT_LT(binary_bytes, static_cast<double>(text_bytes) / CALLS);
+    RecordProperty("binary_ns", static_cast<int>(binary_ns));
+    RecordProperty("binary_bytes", static_cast<int>(binary_bytes));
+    RecordProperty("format_ns", static_cast<int>(format_ns));
+}
+
+} // namespace test
+} // namespace omnicpp
@@ -0,0 +1,155 @@
+/**
+ * @file test_chrome_trace_exporter.cpp
+ * @brief Unit tests for the Chrome Trace Event exporter
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/telemetry/chrome_trace_exporter.hpp"
+#include "engine/telemetry/span_recorder.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace omnicpp {
+namespace test {
+
+using namespace telemetry;
+
+namespace {
+
+std::size_t count(const std::string& text, const std::string& needle) {
+    std::size_t found = 0;
+    for (auto at = text.find(needle); at != std::string::npos; at = text.find(needle, at + needle.size())) {
+        ++found;
+    }
+    return found;
+}
+
+SpanData make_span(std::string name, uint32_t thread, int64_t start_us, int64_t duration_us,
+                   std::optional<SpanId> parent = std::nullopt) {
+    SpanData span;
+    span.name = std::move(name);
+    span.trace_id = TraceId::generate();
+    span.span_id = SpanId::generate();
+    span.parent_span_id = parent;
+    span.kind = SpanKind::Internal;
+    span.start_time = std::chrono::system_clock::now().time_since_epoch() + std::chrono::microseconds(start_us);
+    span.duration = std::chrono::microseconds(duration_us);
+    span.status = StatusCode::Unset;
+    span.thread = thread;
+    return span;
+}
+
+} // namespace
+
+class ChromeTraceExporterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_config.path = (std::filesystem::temp_directory_path() / "omnicpp_trace_test.json").string();
+        m_config.process_name = "trace-test";
+    }
+
+    void TearDown() override {
+        TelemetryManager::instance().shutdown();
+        std::filesystem::remove(m_config.path);
+    }
+
+    std::string contents() const {
+        std::ifstream in(m_config.path, std::ios::binary);
+        std::stringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+
+    ChromeTraceConfig m_config;
+};
+
+TEST_F(ChromeTraceExporterTest, WritesAClosedJsonArray) {
+    ChromeTraceExporter exporter(m_config);
+    ASSERT_TRUE(exporter.is_open()) << exporter.error();
+    SpanData span = make_span("update \"player\"\n", 900, 0, 250);
+    span.attributes["entity"] = int64_t{ 42 };
+    span.attributes["speed"] = 1.5;
+    span.events.push_back({ "collision", span.start_time + std::chrono::microseconds(10), { { "hit", true } } });
+    ASSERT_TRUE(exporter.export_spans({ &span, 1 }));
+    exporter.shutdown();
+    EXPECT_FALSE(exporter.export_spans({ &span, 1 }));
+
+    const std::string trace = contents();
+    EXPECT_EQ(trace.front(), '[');
+    EXPECT_EQ(trace.substr(trace.size() - 3), "\n]\n");
+    EXPECT_NE(trace.find("\"name\":\"update \\\"player\\\"\\n\",\"cat\":\"internal\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"dur\":250.000"), std::string::npos);
+    EXPECT_NE(trace.find("\"entity\":42"), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"collision\",\"cat\":\"event\",\"ph\":\"i\""), std::string::npos);
+    EXPECT_NE(trace.find("\"hit\":true"), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"process_name\",\"ph\":\"M\""), std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"trace-test\"}"), std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"thread 900\"}"), std::string::npos);
+    EXPECT_EQ(trace.find(",,"), std::string::npos);
+}
+
+TEST_F(ChromeTraceExporterTest, FlowsLinkSpansAcrossThreads) {
+    ChromeTraceExporter exporter(m_config);
+    const SpanData parent = make_span("frame", 1, 0, 1000);
+    const SpanData same_thread = make_span("physics", 1, 100, 200, parent.span_id);
+    const SpanData worker = make_span("job", 2, 300, 200, parent.span_id);
+    const SpanData late_parent = make_span("load", 1, 2000, 100);
+    const SpanData early_child = make_span("decode", 3, 2050, 500, late_parent.span_id);
+
+    // Children usually end, and are exported, before their parents
+    const std::vector<SpanData> first{ same_thread, worker, parent, early_child };
+    ASSERT_TRUE(exporter.export_spans(first));
+    ASSERT_TRUE(exporter.export_spans({ &late_parent, 1 }));
+    exporter.shutdown();
+
+    const std::string trace = contents();
+    EXPECT_EQ(count(trace, "\"ph\":\"s\""), 2u);
+    EXPECT_EQ(count(trace, "\"ph\":\"f\""), 2u);
+    EXPECT_NE(trace.find("\"id\":\"0x" + worker.span_id.to_hex() + "\""), std::string::npos);
+    EXPECT_NE(trace.find("\"id\":\"0x" + early_child.span_id.to_hex() + "\""), std::string::npos);
+    EXPECT_EQ(trace.find("\"id\":\"0x" + same_thread.span_id.to_hex() + "\""), std::string::npos);
+}
+
+TEST_F(ChromeTraceExporterTest, CountersAndFlushWhileOpen) {
+    ChromeTraceExporter exporter(m_config);
+    exporter.add_counter("entities", 128);
+    exporter.add_counter("entities", 130);
+    exporter.force_flush();
+
+    const std::string trace = contents(); // Still open: no closing bracket yet
+    EXPECT_EQ(count(trace, "\"name\":\"entities\",\"ph\":\"C\""), 2u);
+    EXPECT_NE(trace.find("\"args\":{\"value\":130}"), std::string::npos);
+    EXPECT_EQ(trace.find(']'), std::string::npos);
+}
+
+TEST_F(ChromeTraceExporterTest, RecordedSpansCarryThreadNames) {
+    auto exporter = std::make_shared<ChromeTraceExporter>(m_config);
+    auto& manager = TelemetryManager::instance();
+    manager.set_exporter(exporter);
+    TelemetryConfig config;
+    config.batch_timeout = std::chrono::milliseconds(10);
+    ASSERT_TRUE(manager.initialize(config));
+
+    Span frame = manager.start_span("frame");
+    std::thread worker([&frame] {
+        SpanRecorder::instance().set_thread_name("worker");
+        frame.create_child("stream_chunk").end();
+    });
+    worker.join();
+    frame.end();
+    manager.shutdown(); // Flushes the recorder and closes the trace
+
+    const std::string trace = contents();
+    EXPECT_NE(trace.find("\"args\":{\"name\":\"worker\"}"), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"stream_chunk\""), std::string::npos);
+    EXPECT_EQ(count(trace, "\"ph\":\"f\""), 1u);
+    EXPECT_EQ(trace.substr(trace.size() - 3), "\n]\n");
+}
+
+} // namespace test
+} // namespace omnicpp
@@ -0,0 +1,154 @@
+/**
+ * @file test_frame_capture.cpp
+ * @brief Unit tests for the asynchronous frame capture ring
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/graphics/frame_capture.hpp"
+#include "engine/concurrency/ThreadPool.hpp"
+#include <mutex>
+#include <vector>
+
+using OmniCpp::Engine::Graphics::CaptureEncoding;
+using OmniCpp::Engine::Graphics::CapturedFrame;
+using OmniCpp::Engine::Graphics::CapturePixelFormat;
+using OmniCpp::Engine::Graphics::FrameCaptureConfig;
+using OmniCpp::Engine::Graphics::FrameCaptureRing;
+
+namespace omnicpp {
+namespace test {
+
+class FrameCaptureTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config.ring_size = 2;
+        config.encoding = CaptureEncoding::Raw;
+        ring.set_callback([this](CapturedFrame&& frame) {
+            std::lock_guard<std::mutex> lock(frames_mutex);
+            frames.push_back(std::move(frame));
+        });
+    }
+
+    void TearDown() override {
+        ring.shutdown();
+    }
+
+    // Simulate a headless backend filling a host slot with a BGRA image
+    void capture_frame(uint32_t slot, uint32_t width, uint32_t height) {
+        const std::size_t pitch = static_cast<std::size_t>(width) * 4 + 8; // Padded rows
+        uint8_t* pixels = ring.host_slot(slot, pitch * height);
+        ASSERT_NE(pixels, nullptr);
+        for (uint32_t y = 0; y < height; ++y) {
+            for (uint32_t x = 0; x < width; ++x) {
+                uint8_t* px = pixels + y * pitch + x * 4;
+                px[0] = 10; // B
+                px[1] = 20; // G
+                px[2] = 30; // R
+                px[3] = 255;
+            }
+        }
+        ring.complete_capture(slot, pixels, width, height, pitch, CapturePixelFormat::BGRA8);
+    }
+
+    concurrency::ThreadPool pool{ 2 };
+    FrameCaptureConfig config;
+    FrameCaptureRing ring;
+    std::mutex frames_mutex;
+    std::vector<CapturedFrame> frames;
+};
+
+TEST_F(FrameCaptureTest, NothingCapturedUntilRequested) {
+    ASSERT_TRUE(ring.initialize(config, &pool));
+    EXPECT_FALSE(ring.begin_capture(0).has_value());
+    EXPECT_FALSE(ring.is_capture_armed());
+}
+
+TEST_F(FrameCaptureTest, DeliversSwizzledTightlyPackedFrame) {
+    ASSERT_TRUE(ring.initialize(config, &pool));
+    ring.request_capture();
+
+    auto slot = ring.begin_capture(42);
+    ASSERT_TRUE(slot.has_value());
+    EXPECT_FALSE(ring.is_capture_armed());
+    capture_frame(*slot, 4, 3);
+    ring.wait_idle();
+
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].frame_index, 42u);
+    EXPECT_EQ(frames[0].width, 4u);
+    EXPECT_EQ(frames[0].height, 3u);
+    ASSERT_EQ(frames[0].data.size(), 4u * 3u * 4u);
+    EXPECT_EQ(frames[0].data[0], 30);
+    EXPECT_EQ(frames[0].data[1], 20);
+    EXPECT_EQ(frames[0].data[2], 10);
+    EXPECT_EQ(frames[0].data[3], 255);
+    EXPECT_EQ(ring.get_stats().captured, 1u);
+}
+
+TEST_F(FrameCaptureTest, DefersWhenAllSlotsBusy) {
+    ASSERT_TRUE(ring.initialize(config, &pool));
+    ring.request_capture(3);
+
+    auto first = ring.begin_capture(0);
+    auto second = ring.begin_capture(1);
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+
+    // Both slots are still owned by the GPU; the third request stays armed
+    EXPECT_FALSE(ring.begin_capture(2).has_value());
+    EXPECT_FALSE(ring.begin_capture(3).has_value());
+    EXPECT_TRUE(ring.is_capture_armed());
+    EXPECT_EQ(ring.get_stats().deferred, 2u);
+    EXPECT_EQ(ring.get_stats().dropped, 0u);
+
+    capture_frame(*first, 2, 2);
+    ring.cancel_capture(*second);
+    ring.wait_idle();
+
+    auto retry = ring.begin_capture(4);
+    EXPECT_TRUE(retry.has_value());
+    capture_frame(*retry, 2, 2);
+    ring.wait_idle();
+    EXPECT_EQ(ring.get_stats().dropped, 0u);
+}
+
+TEST_F(FrameCaptureTest, RequestsPendingAtShutdownAreDropped) {
+    ASSERT_TRUE(ring.initialize(config, &pool));
+    ring.request_capture(3);
+
+    auto slot = ring.begin_capture(0);
+    ASSERT_TRUE(slot.has_value());
+    capture_frame(*slot, 2, 2);
+    ring.wait_idle();
+
+    ring.shutdown();
+    EXPECT_EQ(ring.get_stats().captured, 1u);
+    EXPECT_EQ(ring.get_stats().dropped, 2u);
+}
+
+TEST_F(FrameCaptureTest, QoiEncodingHasValidHeader) {
+    config.encoding = CaptureEncoding::Qoi;
+    ASSERT_TRUE(ring.initialize(config, &pool));
+    ring.request_capture();
+
+    auto slot = ring.begin_capture(0);
+    ASSERT_TRUE(slot.has_value());
+    capture_frame(*slot, 16, 16);
+    ring.wait_idle();
+
+    ASSERT_EQ(frames.size(), 1u);
+    const auto& data = frames[0].data;
+    ASSERT_GE(data.size(), 22u);
+    EXPECT_EQ(frames[0].encoding, CaptureEncoding::Qoi);
+    EXPECT_EQ(data[0], 'q');
+    EXPECT_EQ(data[3], 'f');
+    EXPECT_EQ(data[7], 16); // Width, big endian
+    EXPECT_EQ(data[11], 16);
+    // A single colour compresses to one pixel plus runs
+    EXPECT_LT(data.size(), 16u * 16u * 4u / 10u);
+    EXPECT_EQ(data.back(), 1);
+}
+
+} // namespace test
+} // namespace omnicpp
@@ -0,0 +1,93 @@
+/**
+ * @file test_frame_pacer.cpp
+ * @brief Unit tests for the hybrid sleep/spin frame pacer
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/core/frame_pacer.hpp"
+#include <chrono>
+#include <thread>
+
+using OmniCpp::Engine::Core::FramePacer;
+using OmniCpp::Engine::Core::FramePacerConfig;
+
+namespace omnicpp {
+namespace test {
+
+class FramePacerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        config.target_fps = 200; // 5 ms period keeps the tests short
+        config.history_size = 64;
+    }
+
+    FramePacerConfig config;
+    FramePacer pacer;
+};
+
+TEST_F(FramePacerTest, PeriodMatchesTargetRate) {
+    pacer.initialize(config);
+    EXPECT_EQ(pacer.get_frame_period(), std::chrono::milliseconds(5));
+
+    pacer.set_target_fps(0);
+    EXPECT_EQ(pacer.get_frame_period().count(), 0);
+}
+
+TEST_F(FramePacerTest, AbsoluteDeadlinesDoNotDrift) {
+    pacer.initialize(config);
+
+    const auto start = std::chrono::steady_clock::now();
+    constexpr int frames = 40;
+    for (int i = 0; i < frames; ++i) {
+        // Variable work per frame shortens the wait rather than pushing the schedule
+        if (i % 3 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        pacer.wait_for_next_frame();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto stats = pacer.get_stats();
+
+    EXPECT_GE(elapsed, std::chrono::milliseconds(5 * frames));
+
+    // Sleeping a period from each wake-up would add every oversleep to the schedule; against
+    // absolute deadlines the last frame starts within a period of start + frames * period.
+    // Only an overrun of more than a period (a re-anchor) may move the schedule.
+    if (stats.missed_deadlines == 0) {
+        EXPECT_LT(elapsed, std::chrono::milliseconds(5 * (frames + 1)));
+        EXPECT_LT(stats.mean_ms, 5.0 * (frames + 1) / frames);
+    }
+    RecordProperty("missed_deadlines", static_cast<int>(stats.missed_deadlines));
+}
+
+TEST_F(FramePacerTest, ReportsPercentiles) {
+    pacer.initialize(config);
+    for (int i = 0; i < 20; ++i) {
+        pacer.wait_for_next_frame();
+    }
+
+    const auto stats = pacer.get_stats();
+    EXPECT_EQ(stats.frame_count, 20u);
+    EXPECT_LE(stats.p50_ms, stats.p90_ms);
+    EXPECT_LE(stats.p90_ms, stats.p99_ms);
+    EXPECT_LE(stats.p99_ms, stats.max_ms);
+    EXPECT_GE(stats.p50_ms, 4.5);
+}
+
+TEST_F(FramePacerTest, OverrunReanchorsInsteadOfBursting) {
+    pacer.initialize(config);
+    pacer.wait_for_next_frame();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pacer.wait_for_next_frame();
+    EXPECT_GE(pacer.get_stats().missed_deadlines, 1u);
+
+    // The frame after an overrun still waits a full period
+    const auto before = std::chrono::steady_clock::now();
+    pacer.wait_for_next_frame();
+    EXPECT_GE(std::chrono::steady_clock::now() - before, std::chrono::milliseconds(4));
+}
+
+} // namespace test
+} // namespace omnicpp
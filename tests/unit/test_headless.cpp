@@ -0,0 +1,170 @@
+/**
+ * @file test_headless.cpp
+ * @brief Unit tests for headless backends, the virtual clock and headless engine runs
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/Engine.hpp"
+#include "engine/platform/headless.hpp"
+#include "engine/core/DeterministicProviders.hpp"
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using OmniCpp::Engine::Graphics::CaptureEncoding;
+using OmniCpp::Engine::Graphics::CapturedFrame;
+using OmniCpp::Engine::Platform::NullAudioManager;
+using OmniCpp::Engine::Platform::NullRenderer;
+using OmniCpp::Engine::Platform::NullRendererConfig;
+using omnicpp::core::VirtualTimeProvider;
+
+namespace omnicpp {
+namespace test {
+
+class HeadlessTest : public ::testing::Test {
+protected:
+    NullRenderer renderer;
+    NullAudioManager audio;
+};
+
+TEST_F(HeadlessTest, NullRendererCountsFrames) {
+    EXPECT_FALSE(renderer.begin_frame());
+    ASSERT_TRUE(renderer.initialize());
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(renderer.begin_frame());
+        EXPECT_FALSE(renderer.begin_frame());
+        renderer.end_frame();
+    }
+    EXPECT_EQ(renderer.get_frame_number(), 3u);
+}
+
+TEST_F(HeadlessTest, NullRendererFeedsTheCaptureRing) {
+    NullRendererConfig config;
+    config.width = 8;
+    config.height = 4;
+    config.clear_color = { 10, 20, 30, 255 };
+    config.enable_frame_capture = true;
+    config.capture.encoding = CaptureEncoding::Raw;
+    NullRenderer capturing(config);
+    ASSERT_TRUE(capturing.initialize());
+
+    std::mutex frames_mutex;
+    std::vector<CapturedFrame> frames;
+    capturing.get_frame_capture().set_callback([&](CapturedFrame&& frame) {
+        std::lock_guard<std::mutex> lock(frames_mutex);
+        frames.push_back(std::move(frame));
+    });
+
+    capturing.request_frame_capture(2);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(capturing.begin_frame());
+        capturing.end_frame();
+    }
+    capturing.get_frame_capture().wait_idle();
+
+    std::lock_guard<std::mutex> lock(frames_mutex);
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0].frame_index + frames[1].frame_index, 1u); // Frames 0 and 1, any order
+    EXPECT_EQ(frames[0].width, 8u);
+    EXPECT_EQ(frames[0].height, 4u);
+    ASSERT_EQ(frames[0].data.size(), 8u * 4u * 4u);
+    EXPECT_EQ(frames[0].data[0], 10);
+    EXPECT_EQ(frames[0].data[2], 30);
+    EXPECT_EQ(capturing.get_frame_capture().get_stats().captured, 2u);
+    capturing.shutdown();
+}
+
+TEST_F(HeadlessTest, NullAudioHandsOutSoundIds) {
+    ASSERT_TRUE(audio.initialize());
+    const uint32_t id = audio.load_sound("assets/sounds/hit.wav");
+    EXPECT_NE(id, 0u);
+    EXPECT_TRUE(audio.play_sound(id));
+    EXPECT_TRUE(audio.stop_sound(id));
+    EXPECT_FALSE(audio.play_sound(id + 1));
+
+    audio.set_master_volume(2.0f);
+    EXPECT_FLOAT_EQ(audio.get_master_volume(), 1.0f);
+}
+
+TEST_F(HeadlessTest, VirtualClockOnlyMovesWhenAdvanced) {
+    VirtualTimeProvider clock;
+    const auto start = clock.now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    EXPECT_EQ(clock.now(), start);
+
+    // Ten simulated seconds take no wall time
+    for (int i = 0; i < 600; ++i) {
+        clock.advance(std::chrono::duration<float>(1.0f / 60.0f));
+    }
+    EXPECT_NEAR(std::chrono::duration<double>(clock.elapsed()).count(), 10.0, 1e-3);
+    EXPECT_EQ(clock.now() - start, clock.elapsed());
+}
+
+class HeadlessEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        clock_ = std::make_shared<VirtualTimeProvider>();
+        config_.headless = true;
+        config_.max_frames = 120;
+        config_.time_provider = clock_;
+    }
+
+    void TearDown() override {
+        destroy_engine(engine_);
+    }
+
+    EngineConfig config_;
+    IEngine* engine_ = nullptr;
+    std::shared_ptr<VirtualTimeProvider> clock_;
+};
+
+TEST_F(HeadlessEngineTest, StartsQuicklyAndRunsMaxFrames) {
+    const auto start = std::chrono::steady_clock::now();
+    engine_ = create_engine(config_);
+    const auto startup = std::chrono::steady_clock::now() - start;
+    ASSERT_NE(engine_, nullptr);
+    EXPECT_LT(startup, std::chrono::milliseconds(50));
+    RecordProperty("startup_us",
+        static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(startup).count()));
+    EXPECT_NE(dynamic_cast<NullRenderer*>(engine_->get_renderer()), nullptr);
+    EXPECT_NE(dynamic_cast<NullAudioManager*>(engine_->get_audio_manager()), nullptr);
+
+    engine_->run();
+
+    // One fixed step per frame, except after the last one
+    const double expected = static_cast<double>(config_.max_frames - 1) * config_.fixed_timestep;
+    EXPECT_NEAR(std::chrono::duration<double>(clock_->elapsed()).count(), expected, 1e-3);
+    EXPECT_EQ(engine_->get_renderer()->get_frame_number(), config_.max_frames); // In-flight frames were flushed
+    EXPECT_TRUE(engine_->is_initialized());
+}
+
+TEST_F(HeadlessEngineTest, HeadlessRunsProduceCaptures) {
+    const auto directory = std::filesystem::temp_directory_path() / "omnicpp_headless_captures";
+    std::filesystem::remove_all(directory);
+    config_.max_frames = 10;
+    config_.enable_frame_capture = true;
+    config_.capture.output_directory = directory.string();
+    engine_ = create_engine(config_);
+    ASSERT_NE(engine_, nullptr);
+
+    engine_->request_frame_capture(3);
+    engine_->run();
+    engine_->shutdown(); // Waits for the encodes
+
+    std::size_t files = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.is_regular_file()) {
+            ++files;
+        }
+    }
+    EXPECT_EQ(files, 3u);
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace test
+} // namespace omnicpp
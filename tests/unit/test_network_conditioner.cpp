@@ -0,0 +1,289 @@
+/**
+ * @file test_network_conditioner.cpp
+ * @brief Unit tests for the network conditioner and a conditioned transport harness
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/network/network_conditioner.hpp"
+#include "engine/network/transport.hpp"
+#include "engine/network/udp_socket.hpp"
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace OmniCpp::Engine::Network;
+using namespace std::chrono_literals;
+
+namespace omnicpp {
+namespace test {
+
+namespace {
+
+using Clock = NetworkConditioner::Clock;
+
+const Endpoint DESTINATION(asio::ip::make_address("127.0.0.1"), 9);
+
+// Fills a batch with `count` datagrams whose first 4 bytes are their index
+void fill_batch(DatagramBatch& batch, uint32_t first, std::size_t count, std::size_t size = 100) {
+    batch.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        auto slot = batch.prepare(DESTINATION);
+        const uint32_t index = first + static_cast<uint32_t>(i);
+        std::memset(slot.data(), 0, size);
+        std::memcpy(slot.data(), &index, sizeof(index));
+        batch.commit(size);
+    }
+}
+
+// Releases everything due by `now`, returning datagram indices in delivery order
+std::vector<uint32_t> drain(NetworkConditioner& conditioner, Clock::time_point now) {
+    std::vector<uint32_t> indices;
+    DatagramBatch out(64, 1500);
+    do {
+        out.clear();
+        conditioner.release(now, out);
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            uint32_t index = 0;
+            std::memcpy(&index, out.data(i).data(), sizeof(index));
+            indices.push_back(index);
+        }
+    } while (out.full());
+    return indices;
+}
+
+} // namespace
+
+TEST(NetworkConditionerTest, AppliesLatency) {
+    NetworkConditionerConfig config;
+    config.enabled = true;
+    config.latency = 50ms;
+    NetworkConditioner conditioner(config);
+
+    DatagramBatch batch(16, 1500);
+    fill_batch(batch, 0, 16);
+    const auto start = Clock::now();
+    conditioner.enqueue(batch, start);
+
+    EXPECT_TRUE(drain(conditioner, start + 49ms).empty());
+    const auto released = drain(conditioner, start + 50ms);
+    ASSERT_EQ(released.size(), 16u);
+    for (uint32_t i = 0; i < released.size(); ++i) {
+        EXPECT_EQ(released[i], i);
+    }
+    EXPECT_EQ(conditioner.get_queued_count(), 0u);
+}
+
+TEST(NetworkConditionerTest, JitterKeepsOrderWithoutReordering) {
+    NetworkConditionerConfig config;
+    config.enabled = true;
+    config.latency = 30ms;
+    config.jitter = 20ms;
+    NetworkConditioner conditioner(config);
+
+    DatagramBatch batch(64, 1500);
+    const auto start = Clock::now();
+    for (uint32_t round = 0; round < 20; ++round) {
+        fill_batch(batch, round * 10, 10);
+        conditioner.enqueue(batch, start + round * 1ms);
+    }
+
+    const auto early = drain(conditioner, start + 9ms);
+    EXPECT_TRUE(early.empty()) << "latency - jitter is the earliest delivery";
+    const auto released = drain(conditioner, start + 100ms);
+    ASSERT_EQ(released.size(), 200u);
+    for (uint32_t i = 0; i < released.size(); ++i) {
+        ASSERT_EQ(released[i], i);
+    }
+}
+
+TEST(NetworkConditionerTest, LossIsSeededAndReproducible) {
+    NetworkConditionerConfig config;
+    config.enabled = true;
+    config.loss = 0.2;
+    config.seed = 77;
+
+    auto run = [&]() {
+        NetworkConditioner conditioner(config);
+        DatagramBatch batch(50, 1500);
+        const auto start = Clock::now();
+        for (uint32_t round = 0; round < 200; ++round) {
+            fill_batch(batch, round * 50, 50);
+            conditioner.enqueue(batch, start);
+        }
+        return std::make_pair(drain(conditioner, start), conditioner.get_stats());
+    };
+
+    const auto [first, first_stats] = run();
+    const auto [second, second_stats] = run();
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first_stats.datagrams_offered, 10000u);
+    EXPECT_EQ(first_stats.dropped_loss + first_stats.datagrams_delivered, 10000u);
+    EXPECT_NEAR(static_cast<double>(first_stats.dropped_loss) / 10000.0, 0.2, 0.02);
+
+    config.seed = 78;
+    const auto [other, other_stats] = run();
+    EXPECT_NE(first, other);
+}
+
+TEST(NetworkConditionerTest, DuplicatesAndReorders) {
+    NetworkConditionerConfig config;
+    config.enabled = true;
+    config.latency = 10ms;
+    config.duplicate = 0.1;
+    config.reorder = 0.1;
+    config.reorder_delay = 5ms;
+    NetworkConditioner conditioner(config);
+
+    DatagramBatch batch(10, 1500);
+    const auto start = Clock::now();
+    for (uint32_t round = 0; round < 100; ++round) {
+        fill_batch(batch, round * 10, 10);
+        conditioner.enqueue(batch, start + round * 1ms);
+    }
+    const auto released = drain(conditioner, start + 1s);
+    const auto& stats = conditioner.get_stats();
+
+    EXPECT_EQ(released.size(), 1000u + stats.duplicated);
+    EXPECT_GT(stats.duplicated, 50u);
+    EXPECT_GT(stats.reordered, 50u);
+
+    std::size_t inversions = 0;
+    for (std::size_t i = 1; i < released.size(); ++i) {
+        inversions += released[i] < released[i - 1] ? 1 : 0;
+    }
+    EXPECT_GT(inversions, 0u);
+}
+
+TEST(NetworkConditionerTest, BandwidthCapSerializesAndTailDrops) {
+    NetworkConditionerConfig config;
+    config.enabled = true;
+    config.bandwidth = 100 * 1000; // 100 KB/s: one 1000-byte datagram every 10 ms
+    config.max_queue_delay = 200ms;
+    NetworkConditioner conditioner(config);
+
+    DatagramBatch batch(64, 1500);
+    fill_batch(batch, 0, 50, 1000);
+    const auto start = Clock::now();
+    conditioner.enqueue(batch, start);
+
+    // 21 fit in the 200 ms queue (the first leaves at 10 ms), the rest are dropped
+    EXPECT_EQ(conditioner.get_stats().dropped_queue, 29u);
+    EXPECT_EQ(drain(conditioner, start + 55ms).size(), 5u);
+    EXPECT_EQ(drain(conditioner, start + 1s).size(), 16u);
+}
+
+// In-process harness: one server, several clients, every endpoint conditioned
+TEST(NetworkConditionerTest, HarnessReportsThroughputRttAndResends) {
+    NetworkConditionerConfig impairments;
+    impairments.enabled = true;
+    impairments.latency = 40ms;
+    impairments.jitter = 10ms;
+    impairments.loss = 0.05;
+    impairments.duplicate = 0.02;
+    impairments.reorder = 0.05;
+    impairments.bandwidth = 512 * 1024;
+
+    constexpr std::size_t CLIENTS = 3;
+    constexpr uint32_t MESSAGES = 200;
+    constexpr std::size_t MESSAGE_SIZE = 256;
+
+    Transport server;
+    TransportConfig server_config;
+    server_config.bind_address = "127.0.0.1";
+    server_config.accept_connections = true;
+    server_config.conditioner = impairments;
+    ASSERT_TRUE(server.initialize(server_config));
+
+    std::vector<std::unique_ptr<Transport>> clients;
+    std::vector<ConnectionId> ids;
+    for (std::size_t i = 0; i < CLIENTS; ++i) {
+        TransportConfig client_config;
+        client_config.bind_address = "127.0.0.1";
+        client_config.conditioner = impairments;
+        client_config.conditioner.seed = 100 + i;
+        clients.push_back(std::make_unique<Transport>());
+        ASSERT_TRUE(clients.back()->initialize(client_config));
+        auto id = clients.back()->connect("127.0.0.1", server.get_local_port());
+        ASSERT_TRUE(id.has_value());
+        ids.push_back(*id);
+    }
+
+    std::vector<uint32_t> sent(CLIENTS, 0);
+    std::vector<uint32_t> next_expected(CLIENTS, 0);
+    std::vector<ConnectionId> server_ids(CLIENTS, 0);
+    bool in_order = true;
+    uint64_t bytes_received = 0;
+
+    const auto start = Clock::now();
+    const auto deadline = start + 10s;
+    auto done = [&]() {
+        for (uint32_t expected : next_expected) {
+            if (expected < MESSAGES) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    while (!done() && Clock::now() < deadline) {
+        for (std::size_t i = 0; i < CLIENTS; ++i) {
+            Transport& client = *clients[i];
+            for (int burst = 0; burst < 20 && sent[i] < MESSAGES && client.is_connected(ids[i]); ++burst) {
+                std::vector<uint8_t> payload(MESSAGE_SIZE, static_cast<uint8_t>(i));
+                std::memcpy(payload.data(), &sent[i], sizeof(uint32_t));
+                if (!client.send(ids[i], Channel::ReliableOrdered, payload)) {
+                    break;
+                }
+                ++sent[i];
+            }
+            client.update();
+        }
+
+        server.update();
+        Message message;
+        while (server.poll_message(message)) {
+            const std::size_t client = message.data.back();
+            uint32_t index = 0;
+            std::memcpy(&index, message.data.data(), sizeof(index));
+            in_order = in_order && index == next_expected[client];
+            next_expected[client] = index + 1;
+            server_ids[client] = message.connection;
+            bytes_received += message.data.size();
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    ASSERT_TRUE(done()) << "not every message arrived before the deadline";
+    EXPECT_TRUE(in_order);
+
+    uint64_t resends = 0;
+    uint64_t dropped = 0;
+    double rtt_sum = 0.0;
+    for (std::size_t i = 0; i < CLIENTS; ++i) {
+        resends += clients[i]->get_stats().resends;
+        dropped += clients[i]->get_conditioner_stats().dropped_loss;
+        rtt_sum += clients[i]->get_rtt_ms(ids[i]);
+    }
+    const double rtt = rtt_sum / CLIENTS;
+
+    // Two conditioned 40 ms legs
+    EXPECT_GT(rtt, 60.0);
+    EXPECT_GT(dropped, 0u);
+    EXPECT_GT(resends, 0u);
+
+    RecordProperty("throughput_kib_s", static_cast<int>(bytes_received / seconds / 1024.0));
+    RecordProperty("rtt_ms", static_cast<int>(rtt));
+    RecordProperty("resends", static_cast<int>(resends));
+
+    for (auto& client : clients) {
+        client->shutdown();
+    }
+    server.shutdown();
+}
+
+} // namespace test
+} // namespace omnicpp
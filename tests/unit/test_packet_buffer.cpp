@@ -0,0 +1,245 @@
+/**
+ * @file test_packet_buffer.cpp
+ * @brief Unit tests for pooled packet buffers and the zero-copy transport path
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/network/packet_buffer.hpp"
+#include "engine/network/transport.hpp"
+#include "engine/network/udp_socket.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using namespace OmniCpp::Engine::Network;
+
+namespace {
+
+// Counts every heap allocation in the test binary so steady-state loops can assert none happen
+std::atomic<uint64_t> g_allocations{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// Out of line so the malloc/free pairing is not inlined into callers of the replaced operators
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace omnicpp {
+namespace test {
+
+TEST(PacketBufferTest, PrependsIntoHeadroomWithoutMoving) {
+    PacketPool pool(256, 16, 4);
+    PacketBuffer buffer = pool.acquire();
+    EXPECT_EQ(buffer.headroom(), 16u);
+    EXPECT_EQ(buffer.tailroom(), 256u);
+
+    const std::array<uint8_t, 4> payload{1, 2, 3, 4};
+    ASSERT_TRUE(buffer.append(payload));
+    const uint8_t* payload_start = buffer.data();
+
+    auto header = buffer.prepend(2);
+    ASSERT_EQ(header.size(), 2u);
+    header[0] = 0xAA;
+    header[1] = 0xBB;
+    EXPECT_EQ(buffer.data() + 2, payload_start);
+    const std::array<uint8_t, 6> expected{0xAA, 0xBB, 1, 2, 3, 4};
+    EXPECT_TRUE(buffer == std::span<const uint8_t>(expected));
+
+    EXPECT_TRUE(buffer.prepend(15).empty()) << "only 14 bytes of headroom left";
+    EXPECT_EQ(buffer.tailroom(), 252u);
+    EXPECT_TRUE(buffer.append(253).empty());
+}
+
+TEST(PacketBufferTest, SlicesShareTheBlockAndReturnItToThePool) {
+    PacketPool pool(128, 0, 4);
+    {
+        PacketBuffer buffer = pool.acquire();
+        for (uint8_t i = 0; i < 10; ++i) {
+            buffer.append(std::span<const uint8_t>(&i, 1));
+        }
+        PacketBuffer slice = buffer.slice(3, 4);
+        EXPECT_EQ(slice.size(), 4u);
+        EXPECT_EQ(slice[0], 3);
+        EXPECT_EQ(slice.data(), buffer.data() + 3);
+        EXPECT_EQ(buffer.use_count(), 2u);
+
+        // Shared bytes are read-only
+        EXPECT_TRUE(buffer.append(1).empty());
+        EXPECT_TRUE(slice.prepend(1).empty());
+
+        buffer.reset();
+        EXPECT_EQ(slice.use_count(), 1u);
+        EXPECT_EQ(pool.get_stats().buffers_in_use, 1u);
+    }
+    const auto stats = pool.get_stats();
+    EXPECT_EQ(stats.buffers_in_use, 0u);
+    EXPECT_EQ(stats.buffers_free, 4u);
+
+    // Recycled, not reallocated
+    for (int i = 0; i < 100; ++i) {
+        PacketBuffer a = pool.acquire();
+        PacketBuffer b = pool.acquire();
+    }
+    EXPECT_EQ(pool.get_stats().slabs_allocated, 1u);
+}
+
+TEST(PacketBufferTest, GrowsBySlabsAndServesOversizeFromTheHeap) {
+    PacketPool pool(64, 8, 2);
+    std::vector<PacketBuffer> held;
+    for (int i = 0; i < 5; ++i) {
+        held.push_back(pool.acquire());
+    }
+    EXPECT_EQ(pool.get_stats().slabs_allocated, 3u);
+
+    PacketBuffer big = pool.acquire(1000);
+    EXPECT_GE(big.tailroom(), 1000u);
+    EXPECT_EQ(big.headroom(), 8u);
+    EXPECT_EQ(pool.get_stats().oversize_acquired, 1u);
+    big.reset();
+    EXPECT_EQ(pool.get_stats().buffers_in_use, 5u);
+    EXPECT_EQ(pool.get_stats().buffers_free, 1u) << "oversize blocks are not pooled";
+}
+
+TEST(PacketBufferTest, BuffersMayOutliveThePool) {
+    PacketBuffer survivor;
+    {
+        PacketPool pool(32, 0, 8);
+        const std::array<uint8_t, 3> bytes{7, 8, 9};
+        survivor = pool.copy(bytes);
+    }
+    ASSERT_EQ(survivor.size(), 3u);
+    EXPECT_EQ(survivor[2], 9);
+    survivor.reset(); // Frees the orphaned slabs (checked under sanitizers)
+}
+
+TEST(PacketBufferTest, GatherBatchFlattensHeaderAndSegments) {
+    PacketPool pool(64, 0, 4);
+    const std::array<uint8_t, 3> first{1, 2, 3};
+    const std::array<uint8_t, 2> second{4, 5};
+    PacketBuffer a = pool.copy(first);
+    PacketBuffer b = pool.copy(second);
+
+    GatherBatch batch(4, 8);
+    auto header = batch.begin_datagram(Endpoint(asio::ip::make_address("127.0.0.1"), 9));
+    ASSERT_EQ(header.size(), GatherBatch::HEADER_CAPACITY);
+    header[0] = 0xFF;
+    ASSERT_TRUE(batch.add_segment(a));
+    ASSERT_TRUE(batch.add_segment(b));
+    batch.end_datagram(1);
+    EXPECT_EQ(a.use_count(), 2u) << "segments are referenced, not copied";
+
+    ASSERT_EQ(batch.datagram_size(0), 6u);
+    std::array<uint8_t, 6> flat{};
+    ASSERT_EQ(batch.copy_datagram(0, flat), 6u);
+    const std::array<uint8_t, 6> expected{0xFF, 1, 2, 3, 4, 5};
+    EXPECT_EQ(flat, expected);
+
+    batch.clear();
+    EXPECT_EQ(a.use_count(), 1u);
+}
+
+// Client streams messages built in pooled buffers; after warm-up neither side touches the heap
+TEST(PacketBufferTest, TransportSteadyStateDoesNotAllocate) {
+    Transport server;
+    Transport client;
+    TransportConfig server_config;
+    server_config.bind_address = "127.0.0.1";
+    server_config.accept_connections = true;
+    ASSERT_TRUE(server.initialize(server_config));
+    TransportConfig client_config;
+    client_config.bind_address = "127.0.0.1";
+    ASSERT_TRUE(client.initialize(client_config));
+
+    auto id = client.connect("127.0.0.1", server.get_local_port());
+    ASSERT_TRUE(id.has_value());
+    for (int i = 0; i < 1000 && !client.is_connected(*id); ++i) {
+        client.update();
+        server.update();
+    }
+    ASSERT_TRUE(client.is_connected(*id));
+
+    constexpr int MESSAGES_PER_TICK = 32;
+    constexpr std::size_t MESSAGE_SIZE = 100;
+    uint32_t next_send = 0;
+    uint32_t next_receive = 0;
+    bool in_order = true;
+    Message message;
+
+    auto tick = [&]() {
+        for (int i = 0; i < MESSAGES_PER_TICK; ++i) {
+            PacketBuffer buffer = client.acquire_buffer();
+            auto bytes = buffer.append(MESSAGE_SIZE);
+            std::memset(bytes.data(), 0, bytes.size());
+            std::memcpy(bytes.data(), &next_send, sizeof(next_send));
+            const Channel channel = i % 2 == 0 ? Channel::ReliableOrdered : Channel::Unreliable;
+            if (channel == Channel::ReliableOrdered && !client.send(*id, channel, std::move(buffer))) {
+                break;
+            }
+            if (channel == Channel::Unreliable) {
+                client.send(*id, channel, std::move(buffer));
+            }
+            ++next_send;
+        }
+        client.update();
+        server.update();
+        client.update(); // Acks
+        while (server.poll_message(message)) {
+            if (message.channel == Channel::ReliableOrdered) {
+                uint32_t index = 0;
+                std::memcpy(&index, message.data.data(), sizeof(index));
+                in_order = in_order && index >= next_receive;
+                next_receive = index + 1;
+            }
+        }
+        message = {};
+    };
+
+    for (int i = 0; i < 200; ++i) {
+        tick();
+    }
+    const auto warm_pool = client.get_pool_stats();
+    const auto warm_server_pool = server.get_pool_stats();
+    const uint64_t warm_packets = client.get_stats().packets_sent;
+
+    constexpr int MEASURED_TICKS = 500;
+    const uint64_t allocations_before = g_allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < MEASURED_TICKS; ++i) {
+        tick();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint64_t allocations = g_allocations.load() - allocations_before;
+    const uint64_t packets = client.get_stats().packets_sent - warm_packets;
+
+    EXPECT_TRUE(in_order);
+    EXPECT_GT(packets, 0u);
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_EQ(client.get_pool_stats().slabs_allocated, warm_pool.slabs_allocated);
+    EXPECT_EQ(server.get_pool_stats().slabs_allocated, warm_server_pool.slabs_allocated);
+
+    RecordProperty("messages_per_second", static_cast<int>(MEASURED_TICKS * MESSAGES_PER_TICK / seconds));
+    RecordProperty("steady_state_allocations", static_cast<int>(allocations));
+
+    client.shutdown();
+    server.shutdown();
+}
+
+} // namespace test
+} // namespace omnicpp
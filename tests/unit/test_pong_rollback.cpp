@@ -0,0 +1,266 @@
+/**
+ * @file test_pong_rollback.cpp
+ * @brief Unit tests for rollback netcode over the deterministic Pong simulation
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/network/rollback.hpp"
+#include "game/PongSimulation.hpp"
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <vector>
+
+using namespace OmniCpp::Engine::Network;
+using namespace omnicpp::game;
+
+namespace omnicpp {
+namespace test {
+
+namespace {
+
+constexpr std::size_t MAX_ROLLBACK = 16;
+using PongSession = RollbackSession<PongState, PongInput, 2, MAX_ROLLBACK>;
+
+// 50 ms each way at 60 Hz: a 100 ms round trip
+constexpr uint32_t ONE_WAY_DELAY_TICKS = 3;
+
+struct InputPacket {
+    uint32_t deliver_tick;
+    uint32_t player;
+    uint32_t frame;
+    PongInput input;
+};
+
+// Scripted player: follows the ball, with a deterministic twitch so inputs
+// change often enough to defeat repeat-last prediction
+PongInput scripted_input(const PongState& view, uint32_t player, uint32_t frame) {
+    PongInput input = pong_ai_input(view, player);
+    if ((frame / 7 + player) % 5 == 0) {
+        input.move = static_cast<int8_t>(-input.move);
+    }
+    return input;
+}
+
+struct Peer {
+    PongSession session;
+    std::map<uint32_t, uint64_t> final_checksums;  // frame -> checksum at the start of that frame
+
+    Peer(uint32_t player, uint32_t input_delay)
+        : session(pong_initial_state(1234), &pong_step, player, input_delay) {}
+
+    void record_final_states() {
+        const uint32_t limit = std::min(session.confirmed_frame(), session.get_frame() - 1);
+        uint32_t next = final_checksums.empty() ? 0 : final_checksums.rbegin()->first + 1;
+        for (; next <= limit && session.get_frame() > 0; ++next) {
+            const PongState* saved = session.get_saved_state(next);
+            ASSERT_NE(saved, nullptr) << "frame " << next << " left the ring before it was confirmed";
+            final_checksums[next] = pong_checksum(*saved);
+        }
+    }
+};
+
+struct LoopbackResult {
+    std::vector<std::vector<PongInput>> inputs{2};  // what each player actually sent, by frame
+    RollbackStats stats[2];
+    uint32_t frames[2]{};
+};
+
+// Runs two peers in lockstep ticks with inputs delayed in flight
+LoopbackResult run_loopback(Peer& a, Peer& b, uint32_t ticks) {
+    Peer* peers[2] = {&a, &b};
+    std::deque<InputPacket> in_flight;
+    LoopbackResult result;
+
+    for (uint32_t tick = 0; tick < ticks; ++tick) {
+        while (!in_flight.empty() && in_flight.front().deliver_tick <= tick) {
+            const InputPacket packet = in_flight.front();
+            in_flight.pop_front();
+            Peer& receiver = *peers[1 - packet.player];
+            EXPECT_TRUE(receiver.session.add_remote_input(packet.player, packet.frame, packet.input));
+        }
+
+        for (uint32_t player = 0; player < 2; ++player) {
+            PongSession& session = peers[player]->session;
+            const uint32_t input_frame = session.get_frame() + session.get_input_delay();
+            const PongInput input = scripted_input(session.get_state(), player, input_frame);
+            if (!session.advance(input)) {
+                continue;
+            }
+            auto& sent = result.inputs[player];
+            sent.resize(std::max<std::size_t>(sent.size(), input_frame + 1));
+            sent[input_frame] = input;
+            in_flight.push_back({tick + ONE_WAY_DELAY_TICKS, player, input_frame, input});
+            peers[player]->record_final_states();
+        }
+    }
+
+    for (uint32_t player = 0; player < 2; ++player) {
+        result.stats[player] = peers[player]->session.get_stats();
+        result.frames[player] = peers[player]->session.get_frame();
+    }
+    return result;
+}
+
+// Straight-line replay of the inputs both players really sent
+std::vector<uint64_t> reference_checksums(const LoopbackResult& result, uint32_t frames) {
+    std::vector<uint64_t> checksums;
+    PongState state = pong_initial_state(1234);
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        checksums.push_back(pong_checksum(state));
+        std::array<PongInput, 2> inputs{};
+        for (uint32_t player = 0; player < 2; ++player) {
+            if (frame < result.inputs[player].size()) {
+                inputs[player] = result.inputs[player][frame];
+            }
+        }
+        pong_step(state, inputs);
+    }
+    return checksums;
+}
+
+} // namespace
+
+TEST(PongSimulationTest, StepIsDeterministic) {
+    PongState first = pong_initial_state(42);
+    PongState second = pong_initial_state(42);
+    for (uint32_t frame = 0; frame < 5000; ++frame) {
+        // Right paddle stays idle so points get scored and serves use the RNG
+        const std::array<PongInput, 2> inputs{scripted_input(first, 0, frame), PongInput{}};
+        pong_step(first, inputs);
+        pong_step(second, inputs);
+    }
+    EXPECT_EQ(pong_checksum(first), pong_checksum(second));
+    EXPECT_EQ(first.frame, 5000u);
+    EXPECT_GT(first.scores[0] + first.scores[1], 0) << "5000 frames should include at least one point";
+}
+
+TEST(PongSimulationTest, SeedChangesServe) {
+    EXPECT_NE(pong_checksum(pong_initial_state(1)), pong_checksum(pong_initial_state(2)));
+}
+
+TEST(PongRollbackTest, PeersConvergeOverDelayedLoopback) {
+    Peer a(0, 0);
+    Peer b(1, 0);
+    const LoopbackResult result = run_loopback(a, b, 1200);
+
+    // Prediction must have missed and been corrected
+    EXPECT_GT(result.stats[0].rollbacks, 0u);
+    EXPECT_GT(result.stats[1].rollbacks, 0u);
+    EXPECT_LE(result.stats[0].max_rollback_depth, MAX_ROLLBACK);
+    EXPECT_LE(result.stats[1].max_rollback_depth, MAX_ROLLBACK);
+
+    // Every confirmed frame matches on both peers and the straight replay
+    const auto reference = reference_checksums(result, std::min(result.frames[0], result.frames[1]));
+    std::size_t compared = 0;
+    for (const auto& [frame, checksum] : a.final_checksums) {
+        if (frame >= reference.size()) {
+            continue;
+        }
+        ASSERT_EQ(checksum, reference[frame]) << "peer A desynced at frame " << frame;
+        auto other = b.final_checksums.find(frame);
+        ASSERT_NE(other, b.final_checksums.end());
+        ASSERT_EQ(other->second, checksum) << "peers diverged at frame " << frame;
+        ++compared;
+    }
+    EXPECT_GT(compared, 1000u);
+
+    // 100 ms RTT is six ticks in flight; rollbacks stay well within one frame budget
+    for (const auto& stats : result.stats) {
+        EXPECT_LT(stats.max_rollback_ms, 1000.0 / PONG_TICK_RATE);
+    }
+    RecordProperty("max_rollback_depth", static_cast<int>(result.stats[0].max_rollback_depth));
+}
+
+TEST(PongRollbackTest, InputDelayReducesRollbackDepth) {
+    Peer a0(0, 0);
+    Peer b0(1, 0);
+    const LoopbackResult no_delay = run_loopback(a0, b0, 600);
+
+    Peer a3(0, ONE_WAY_DELAY_TICKS);
+    Peer b3(1, ONE_WAY_DELAY_TICKS);
+    const LoopbackResult with_delay = run_loopback(a3, b3, 600);
+
+    // Delay covering the one-way trip leaves nothing to predict
+    EXPECT_EQ(with_delay.stats[0].rollbacks, 0u);
+    EXPECT_LT(with_delay.stats[0].frames_resimulated, no_delay.stats[0].frames_resimulated);
+
+    const uint32_t frames = std::min({with_delay.frames[0], with_delay.frames[1]});
+    const auto reference = reference_checksums(with_delay, frames);
+    for (const auto& [frame, checksum] : a3.final_checksums) {
+        if (frame < reference.size()) {
+            ASSERT_EQ(checksum, reference[frame]) << "frame " << frame;
+        }
+    }
+}
+
+TEST(PongRollbackTest, StallsWhenRemoteInputStops) {
+    PongSession session(pong_initial_state(7), &pong_step, 0);
+    uint32_t advanced = 0;
+    for (uint32_t i = 0; i < MAX_ROLLBACK * 2; ++i) {
+        advanced += session.advance(PongInput{1}) ? 1 : 0;
+    }
+    EXPECT_EQ(advanced, MAX_ROLLBACK);
+    EXPECT_EQ(session.get_stats().stalls, MAX_ROLLBACK);
+
+    // Remote input for the oldest frame frees one slot
+    EXPECT_TRUE(session.add_remote_input(1, 0, PongInput{}));
+    EXPECT_TRUE(session.advance(PongInput{1}));
+    EXPECT_FALSE(session.advance(PongInput{1}));
+}
+
+TEST(PongRollbackTest, LateMismatchRewindsToDivergence) {
+    PongSession session(pong_initial_state(7), &pong_step, 0);
+    for (uint32_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(session.advance(PongInput{}));
+    }
+
+    // Remote pressed "up" from frame 4 on; the session predicted idle
+    for (uint32_t frame = 0; frame < 10; ++frame) {
+        EXPECT_TRUE(session.add_remote_input(1, frame, PongInput{static_cast<int8_t>(frame >= 4 ? 1 : 0)}));
+    }
+    ASSERT_TRUE(session.advance(PongInput{}));
+    EXPECT_EQ(session.get_stats().rollbacks, 1u);
+    EXPECT_EQ(session.get_stats().max_rollback_depth, 6u);
+
+    PongState expected = pong_initial_state(7);
+    for (uint32_t frame = 0; frame < 11; ++frame) {
+        // Frame 10 is predicted by repeating frame 9's confirmed input
+        pong_step(expected, {PongInput{}, PongInput{static_cast<int8_t>(frame >= 4 ? 1 : 0)}});
+    }
+    EXPECT_EQ(pong_checksum(session.get_state()), pong_checksum(expected));
+
+    // Inputs outside the window are rejected, duplicates ignored
+    EXPECT_TRUE(session.add_remote_input(1, 9, PongInput{1}));
+    EXPECT_FALSE(session.add_remote_input(1, session.get_frame() + 100, PongInput{}));
+    EXPECT_FALSE(session.add_remote_input(0, 3, PongInput{}));
+}
+
+TEST(PongRollbackTest, BenchmarkFullDepthRollback) {
+    PongSession session(pong_initial_state(99), &pong_step, 0);
+    constexpr uint32_t ROUNDS = 2000;
+    double worst_ms = 0.0;
+    double total_ms = 0.0;
+    for (uint32_t round = 0; round < ROUNDS; ++round) {
+        for (uint32_t i = 0; i < MAX_ROLLBACK - 1; ++i) {
+            session.advance(PongInput{static_cast<int8_t>(round % 3 - 1)});
+        }
+        // Confirm every predicted frame with an input that never matches
+        for (uint32_t frame = session.confirmed_frame(); frame < session.get_frame(); ++frame) {
+            session.add_remote_input(1, frame, PongInput{static_cast<int8_t>(1 - static_cast<int>(frame % 3))});
+        }
+        session.advance(PongInput{});
+        worst_ms = std::max(worst_ms, session.get_stats().last_rollback_ms);
+        total_ms += session.get_stats().last_rollback_ms;
+    }
+
+    EXPECT_EQ(session.get_stats().rollbacks, ROUNDS);
+    EXPECT_EQ(session.get_stats().max_rollback_depth, MAX_ROLLBACK);
+    EXPECT_LT(worst_ms, 1000.0 / PONG_TICK_RATE);
+    RecordProperty("rollback_avg_us", static_cast<int>(total_ms / ROUNDS * 1000.0));
+    RecordProperty("rollback_worst_us", static_cast<int>(worst_ms * 1000.0));
+}
+
+} // namespace test
+} // namespace omnicpp
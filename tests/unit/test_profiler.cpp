@@ -0,0 +1,310 @@
+/**
+ * @file test_profiler.cpp
+ * @brief Unit tests and benchmark for the frame profiler
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/Engine.hpp"
+#include "engine/core/DeterministicProviders.hpp"
+#include "engine/core/profiler.hpp"
+#include "engine/telemetry/chrome_trace_exporter.hpp"
+#include "engine/telemetry/span_recorder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace omnicpp {
+namespace test {
+
+using OmniCpp::Engine::Core::FrameProfile;
+using OmniCpp::Engine::Core::Profiler;
+using OmniCpp::Engine::Core::ProfilerConfig;
+
+#if OMNICPP_PROFILE_ENABLED
+
+namespace {
+
+void busy_wait(std::chrono::microseconds duration) {
+    const auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+void simulate_frame(std::chrono::microseconds physics) {
+    OMNICPP_PROFILE_SCOPE("update");
+    {
+        OMNICPP_PROFILE_SCOPE("physics");
+        busy_wait(physics);
+    }
+    for (int i = 0; i < 3; ++i) {
+        OMNICPP_PROFILE_SCOPE("script");
+    }
+}
+
+const OmniCpp::Engine::Core::ScopeStats* find(const FrameProfile& frame, std::string_view name) {
+    for (const auto& scope : frame.scopes) {
+        if (name == scope.name) {
+            return &scope;
+        }
+    }
+    return nullptr;
+}
+
+class CollectingExporter : public telemetry::SpanExporter {
+public:
+    bool export_spans(std::span<const telemetry::SpanData> spans) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_spans.insert(m_spans.end(), spans.begin(), spans.end());
+        return true;
+    }
+
+    void force_flush() override {}
+    void shutdown() override {}
+
+    std::vector<telemetry::SpanData> spans() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_spans;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<telemetry::SpanData> m_spans;
+};
+
+} // namespace
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ProfilerConfig config;
+        config.spans_for_worst_frames = false;
+        config.worst_frames = 2;
+        Profiler::instance().configure(config);
+        Profiler::instance().reset();
+        Profiler::instance().set_enabled(true);
+        OMNICPP_PROFILE_FRAME(); // Start the first frame
+    }
+
+    void TearDown() override {
+        Profiler::instance().set_enabled(false);
+        Profiler::instance().set_trace_exporter(nullptr);
+        telemetry::TelemetryManager::instance().shutdown();
+    }
+};
+
+TEST_F(ProfilerTest, AggregatesNestedScopesPerFrame) {
+    simulate_frame(std::chrono::microseconds(500));
+    OMNICPP_PROFILE_FRAME();
+
+    const FrameProfile frame = Profiler::instance().last_frame();
+    EXPECT_EQ(frame.frame, 0u);
+    ASSERT_EQ(frame.scopes.size(), 3u);
+    EXPECT_STREQ(frame.scopes[0].name, "update");
+    EXPECT_STREQ(frame.scopes[1].name, "physics");
+    EXPECT_STREQ(frame.scopes[2].name, "script");
+    EXPECT_EQ(frame.scopes[0].depth, 0u);
+    EXPECT_EQ(frame.scopes[1].depth, 1u);
+    EXPECT_EQ(frame.scopes[2].calls, 3u);
+    EXPECT_GE(frame.scopes[1].total_ms, 0.45);
+    EXPECT_GE(frame.scopes[0].total_ms, frame.scopes[1].total_ms);
+    EXPECT_GE(frame.duration_ms, frame.scopes[0].total_ms);
+    EXPECT_LT(frame.duration_ms, 1000.0);
+    ASSERT_EQ(frame.samples.size(), 5u);
+    EXPECT_STREQ(frame.samples[0].name, "update");
+    EXPECT_GE(frame.samples[0].start_ns, 0);
+}
+
+TEST_F(ProfilerTest, ScopesCanEndEarly) {
+    {
+        OMNICPP_PROFILE_SCOPE_BEGIN(record_scope, "record");
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        OMNICPP_PROFILE_SCOPE_END(record_scope);
+        OMNICPP_PROFILE_SCOPE_END(record_scope); // Already closed
+        OMNICPP_PROFILE_SCOPE("present");
+    }
+    OMNICPP_PROFILE_FRAME();
+
+    const FrameProfile frame = Profiler::instance().last_frame();
+    ASSERT_EQ(frame.samples.size(), 2u);
+    EXPECT_STREQ(frame.samples[0].name, "record");
+    EXPECT_STREQ(frame.samples[1].name, "present");
+    EXPECT_EQ(frame.samples[1].depth, 0u); // A sibling, not nested in the ended scope
+    EXPECT_GE(find(frame, "record")->total_ms, 0.15);
+}
+
+TEST_F(ProfilerTest, KeepsTheWorstFrames) {
+    for (const int physics_us : { 100, 2000, 300, 1000, 200 }) {
+        simulate_frame(std::chrono::microseconds(physics_us));
+        OMNICPP_PROFILE_FRAME();
+    }
+
+    const auto worst = Profiler::instance().worst_frames();
+    ASSERT_EQ(worst.size(), 2u);
+    EXPECT_EQ(worst[0].frame, 1u);
+    EXPECT_EQ(worst[1].frame, 3u);
+    EXPECT_GE(find(worst[0], "physics")->total_ms, 1.9);
+    EXPECT_EQ(worst[0].samples.size(), 5u);
+    EXPECT_EQ(Profiler::instance().last_frame().frame, 4u);
+}
+
+TEST_F(ProfilerTest, ScopesFromOtherThreads) {
+    std::thread worker([] {
+        OMNICPP_PROFILE_SCOPE("stream");
+        busy_wait(std::chrono::microseconds(100));
+    });
+    worker.join();
+    simulate_frame(std::chrono::microseconds(10));
+    OMNICPP_PROFILE_FRAME();
+
+    const FrameProfile frame = Profiler::instance().last_frame();
+    ASSERT_NE(find(frame, "stream"), nullptr);
+    uint32_t stream_thread = 0;
+    uint32_t update_thread = 0;
+    for (const auto& sample : frame.samples) {
+        if (std::string_view(sample.name) == "stream") {
+            stream_thread = sample.thread;
+        } else if (std::string_view(sample.name) == "update") {
+            update_thread = sample.thread;
+        }
+    }
+    EXPECT_NE(stream_thread, update_thread);
+    EXPECT_EQ(update_thread, telemetry::SpanRecorder::instance().thread_number());
+}
+
+TEST_F(ProfilerTest, DisabledRecordsNothing) {
+    Profiler::instance().set_enabled(false);
+    simulate_frame(std::chrono::microseconds(10));
+    OMNICPP_PROFILE_FRAME();
+    Profiler::instance().set_enabled(true);
+    OMNICPP_PROFILE_FRAME();
+    OMNICPP_PROFILE_FRAME();
+
+    EXPECT_TRUE(Profiler::instance().last_frame().samples.empty());
+}
+
+TEST_F(ProfilerTest, FramesGoToTheTraceExporter) {
+    const auto path = (std::filesystem::temp_directory_path() / "omnicpp_profile_trace.json").string();
+    telemetry::ChromeTraceConfig config;
+    config.path = path;
+    auto exporter = std::make_shared<telemetry::ChromeTraceExporter>(config);
+    Profiler::instance().set_trace_exporter(exporter);
+
+    simulate_frame(std::chrono::microseconds(10));
+    OMNICPP_PROFILE_FRAME();
+    exporter->shutdown();
+
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    const std::string trace = text.str();
+    EXPECT_NE(trace.find("\"name\":\"physics\",\"cat\":\"profile\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"frame_ms\",\"ph\":\"C\""), std::string::npos);
+    std::filesystem::remove(path);
+}
+
+TEST_F(ProfilerTest, WorstFramesBecomeSpans) {
+    ProfilerConfig config;
+    config.worst_frames = 1;
+    Profiler::instance().configure(config);
+    auto exporter = std::make_shared<CollectingExporter>();
+    auto& manager = telemetry::TelemetryManager::instance();
+    manager.set_exporter(exporter);
+    ASSERT_TRUE(manager.initialize({}));
+    manager.start_span("warmup").end(); // This thread's span ring is allocated outside the frames
+    manager.force_flush();
+
+    simulate_frame(std::chrono::microseconds(5000));
+    OMNICPP_PROFILE_FRAME();
+    simulate_frame(std::chrono::microseconds(10)); // Faster: not a new worst frame
+    OMNICPP_PROFILE_FRAME();
+    manager.force_flush();
+
+    auto spans = exporter->spans();
+    spans.erase(spans.begin());
+    ASSERT_EQ(spans.size(), 6u);
+    const telemetry::SpanData& root = spans[0];
+    EXPECT_EQ(root.name, "frame");
+    EXPECT_FALSE(root.parent_span_id.has_value());
+    EXPECT_EQ(std::get<int64_t>(root.attributes.at("frame.number")), 0);
+    EXPECT_EQ(spans[1].name, "update");
+    EXPECT_EQ(spans[1].parent_span_id->to_hex(), root.span_id.to_hex());
+    EXPECT_EQ(spans[2].name, "physics");
+    EXPECT_EQ(spans[2].parent_span_id->to_hex(), spans[1].span_id.to_hex());
+    EXPECT_EQ(spans[2].thread, telemetry::SpanRecorder::instance().thread_number());
+    EXPECT_GE(spans[2].duration, std::chrono::microseconds(4900));
+}
+
+TEST_F(ProfilerTest, EngineFramesAreProfiled) {
+    EngineConfig config;
+    config.headless = true;
+    config.max_frames = 5;
+    config.enable_profiling = true;
+    config.time_provider = std::make_shared<core::VirtualTimeProvider>();
+    IEngine* engine = create_engine(config);
+    ASSERT_NE(engine, nullptr);
+    engine->run();
+
+    // Every stage of the last full frame, including those run on pool threads
+    const FrameProfile frame = Profiler::instance().last_frame();
+    for (const char* name : { "pipeline", "simulate", "extract", "record", "present", "audio" }) {
+        EXPECT_NE(find(frame, name), nullptr) << name;
+    }
+    EXPECT_EQ(find(frame, "pace"), nullptr); // The virtual clock is never paced
+    destroy_engine(engine);
+}
+
+TEST_F(ProfilerTest, BenchmarkScopeCost) {
+    using Clock = std::chrono::steady_clock;
+    constexpr int SCOPES = 1000; // A frame's worth; fits the ring
+    constexpr int FRAMES = 200;
+
+    double enabled_ns = 1e9;
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        const auto start = Clock::now();
+        for (int i = 0; i < SCOPES; ++i) {
+            OMNICPP_PROFILE_SCOPE("bench");
+        }
+        enabled_ns = std::min(enabled_ns, std::chrono::duration<double, std::nano>(Clock::now() - start).count() / SCOPES);
+        OMNICPP_PROFILE_FRAME();
+    }
+
+    Profiler::instance().set_enabled(false);
+    double disabled_ns = 1e9;
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        const auto start = Clock::now();
+        for (int i = 0; i < SCOPES; ++i) {
+            OMNICPP_PROFILE_SCOPE("bench");
+        }
+        disabled_ns = std::min(disabled_ns, std::chrono::duration<double, std::nano>(Clock::now() - start).count() / SCOPES);
+    }
+
+    EXPECT_EQ(Profiler::instance().dropped(), 0u);
+    EXPECT_LT(disabled_ns, enabled_ns);
+    RecordProperty("scope_ns", static_cast<int>(enabled_ns));
+    RecordProperty("disabled_scope_ns", static_cast<int>(disabled_ns));
+}
+
+#else
+
+TEST(ProfilerTest, ScopesCompileToNothing) {
+    Profiler::instance().set_enabled(true);
+    OMNICPP_PROFILE_FRAME();
+    {
+        OMNICPP_PROFILE_SCOPE("update");
+    }
+    OMNICPP_PROFILE_FRAME();
+    EXPECT_TRUE(Profiler::instance().last_frame().samples.empty());
+    EXPECT_TRUE(Profiler::instance().worst_frames().empty());
+    Profiler::instance().set_enabled(false);
+}
+
+#endif
+
+} // namespace test
+} // namespace omnicpp
@@ -0,0 +1,301 @@
+/**
+ * @file test_snapshot_replication.cpp
+ * @brief Unit tests and benchmark for bit packing and snapshot delta encoding
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/network/bit_stream.hpp"
+#include "engine/network/snapshot.hpp"
+#include "engine/ecs/TransformComponent.hpp"
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace OmniCpp::Engine::Network;
+using omnicpp::ecs::TransformComponent;
+using omnicpp::math::Vec3;
+
+namespace omnicpp {
+namespace test {
+
+TEST(BitStreamTest, RoundTripsMixedValues) {
+    std::array<uint8_t, 256> buffer{};
+    BitWriter writer(buffer);
+    writer.write_bits(5, 3);
+    writer.write_bool(true);
+    writer.write_bits(0xDEADBEEF, 32);
+    writer.write_varint(0);
+    writer.write_varint(300);
+    writer.write_varint(UINT64_MAX);
+    writer.write_varint_signed(-2);
+    writer.write_bounded(-7, -10, 10);
+    writer.write_quantized(12.3456f, -100.0f, 100.0f, 0.01f);
+    writer.write_float(3.25f);
+    writer.write_u64(0x0123456789ABCDEFull);
+    writer.write(core::Health(42));
+    writer.write(core::Normalized(0.25f));
+    const std::size_t bytes = writer.flush();
+    EXPECT_FALSE(writer.overflowed());
+    EXPECT_EQ(bytes, writer.bytes_written());
+
+    BitReader reader(std::span<const uint8_t>(buffer.data(), bytes));
+    EXPECT_EQ(reader.read_bits(3), 5u);
+    EXPECT_TRUE(reader.read_bool());
+    EXPECT_EQ(reader.read_bits(32), 0xDEADBEEFu);
+    EXPECT_EQ(reader.read_varint(), 0u);
+    EXPECT_EQ(reader.read_varint(), 300u);
+    EXPECT_EQ(reader.read_varint(), UINT64_MAX);
+    EXPECT_EQ(reader.read_varint_signed(), -2);
+    EXPECT_EQ(reader.read_bounded(-10, 10), -7);
+    EXPECT_NEAR(reader.read_quantized(-100.0f, 100.0f, 0.01f), 12.3456f, 0.005f);
+    EXPECT_FLOAT_EQ(reader.read_float(), 3.25f);
+    EXPECT_EQ(reader.read_u64(), 0x0123456789ABCDEFull);
+    core::Health health;
+    reader.read(health);
+    EXPECT_EQ(health.get(), 42);
+    core::Normalized normalized;
+    reader.read(normalized);
+    EXPECT_NEAR(normalized.get(), 0.25f, 1.0f / 65535.0f);
+    EXPECT_FALSE(reader.failed());
+}
+
+TEST(BitStreamTest, BoundedValuesUseMinimalBits) {
+    EXPECT_EQ(bits_required(0), 0u);
+    EXPECT_EQ(bits_required(1), 1u);
+    EXPECT_EQ(bits_required(100), 7u);
+    EXPECT_EQ(bits_required(255), 8u);
+
+    std::array<uint8_t, 16> buffer{};
+    BitWriter writer(buffer);
+    writer.write(core::Health(100));
+    EXPECT_EQ(writer.bits_written(), 7u);
+    writer.write_bounded(500, 0, 100); // Clamped
+    writer.flush();
+
+    BitReader reader(buffer);
+    EXPECT_EQ(reader.read_bounded(0, 100), 100);
+    EXPECT_EQ(reader.read_bounded(0, 100), 100);
+}
+
+TEST(BitStreamTest, OverflowAndUnderflowAreFlagged) {
+    std::array<uint8_t, 2> buffer{};
+    BitWriter writer(buffer);
+    writer.write_bits(0xFFFFFF, 24);
+    writer.flush();
+    EXPECT_TRUE(writer.overflowed());
+
+    BitReader reader(buffer);
+    reader.read_bits(16);
+    EXPECT_FALSE(reader.failed());
+    EXPECT_EQ(reader.read_bits(8), 0u);
+    EXPECT_TRUE(reader.failed());
+}
+
+class SnapshotTest : public ::testing::Test {
+protected:
+    std::vector<TransformState> make_world(std::size_t count) {
+        std::vector<TransformState> states(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const float f = static_cast<float>(i);
+            states[i].entity_id = static_cast<uint32_t>(i * 3 + 1);
+            states[i].position = Vec3(f, -f * 0.5f, 10.0f + f * 0.25f);
+            states[i].rotation = Vec3(0.0f, std::fmod(f * 7.0f, 360.0f), -45.0f);
+            states[i].scale = Vec3(1.0f, 1.0f, 1.0f);
+        }
+        return states;
+    }
+
+    std::vector<uint8_t> encode(const Snapshot& current, const Snapshot* baseline) {
+        std::vector<uint8_t> bytes(64 * 1024);
+        BitWriter writer(bytes);
+        EXPECT_TRUE(codec.encode(current, baseline, writer));
+        bytes.resize(writer.bytes_written());
+        return bytes;
+    }
+
+    SnapshotCodec codec;
+};
+
+TEST_F(SnapshotTest, QuantizationStaysWithinResolution) {
+    auto states = make_world(50);
+    states[3].rotation = Vec3(-90.0f, 450.0f, 359.999f);
+    Snapshot snapshot;
+    codec.quantize(1, states, snapshot);
+    std::vector<TransformState> restored;
+    codec.dequantize(snapshot, restored);
+
+    ASSERT_EQ(restored.size(), states.size());
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        EXPECT_EQ(restored[i].entity_id, states[i].entity_id);
+        EXPECT_NEAR(restored[i].position.x, states[i].position.x, 0.001f);
+        EXPECT_NEAR(restored[i].position.z, states[i].position.z, 0.001f);
+        EXPECT_NEAR(restored[i].scale.y, 1.0f, 0.001f);
+    }
+    EXPECT_NEAR(restored[3].rotation.x, 270.0f, 0.01f);
+    EXPECT_NEAR(restored[3].rotation.y, 90.0f, 0.01f);
+    EXPECT_NEAR(restored[3].rotation.z, 0.0f, 0.01f); // 359.999 rounds to a full turn
+}
+
+TEST_F(SnapshotTest, FullSnapshotRoundTrips) {
+    Snapshot snapshot;
+    codec.quantize(7, make_world(100), snapshot);
+    const auto bytes = encode(snapshot, nullptr);
+
+    BitReader reader(bytes);
+    Snapshot decoded;
+    ASSERT_TRUE(codec.decode(reader, nullptr, decoded));
+    EXPECT_EQ(decoded.tick, 7u);
+    EXPECT_EQ(decoded.entities, snapshot.entities);
+}
+
+TEST_F(SnapshotTest, DeltaSendsOnlyChangedFields) {
+    auto states = make_world(100);
+    Snapshot baseline;
+    codec.quantize(10, states, baseline);
+
+    // Move one entity a little, rotate another, remove one and spawn one
+    states[5].position.x += 0.05f;
+    states[20].rotation.y += 90.0f;
+    states.erase(states.begin() + 50);
+    TransformState spawned;
+    spawned.entity_id = 1000;
+    spawned.position = Vec3(1.0f, 2.0f, 3.0f);
+    states.push_back(spawned);
+
+    Snapshot current;
+    codec.quantize(12, states, current);
+    const auto delta = encode(current, &baseline);
+    const auto full = encode(current, nullptr);
+    EXPECT_LT(delta.size() * 20, full.size());
+
+    BitReader reader(delta);
+    Snapshot decoded;
+    ASSERT_TRUE(codec.decode(reader, &baseline, decoded));
+    EXPECT_EQ(decoded.tick, 12u);
+    EXPECT_EQ(decoded.entities, current.entities);
+
+    // Decoding against the wrong baseline is refused
+    Snapshot other = baseline;
+    other.tick = 11;
+    BitReader wrong(delta);
+    EXPECT_FALSE(codec.decode(wrong, &other, decoded));
+
+    uint32_t tick = 0;
+    std::optional<uint32_t> baseline_tick;
+    ASSERT_TRUE(SnapshotCodec::peek_header(delta, tick, baseline_tick));
+    EXPECT_EQ(tick, 12u);
+    EXPECT_EQ(baseline_tick, std::optional<uint32_t>(10u));
+}
+
+TEST_F(SnapshotTest, SenderUsesLastAcknowledgedBaseline) {
+    SnapshotSender sender(codec, 8);
+    SnapshotReceiver receiver(codec, 8);
+    auto states = make_world(64);
+    std::vector<uint8_t> buffer(64 * 1024);
+    Snapshot snapshot;
+    Snapshot decoded;
+
+    codec.quantize(1, states, snapshot);
+    std::size_t first = sender.encode(snapshot, buffer);
+    ASSERT_GT(first, 0u);
+    EXPECT_FALSE(sender.get_baseline_tick().has_value());
+    ASSERT_TRUE(receiver.decode(std::span<const uint8_t>(buffer.data(), first), decoded));
+    sender.acknowledge(decoded.tick);
+    EXPECT_EQ(sender.get_baseline_tick(), std::optional<uint32_t>(1u));
+
+    // Tick 2 is lost in transit; tick 3 still decodes against acked tick 1
+    states[0].position.y += 1.0f;
+    codec.quantize(2, states, snapshot);
+    ASSERT_GT(sender.encode(snapshot, buffer), 0u);
+    states[1].position.y += 1.0f;
+    codec.quantize(3, states, snapshot);
+    const std::size_t third = sender.encode(snapshot, buffer);
+    EXPECT_LT(third * 10, first);
+    ASSERT_TRUE(receiver.decode(std::span<const uint8_t>(buffer.data(), third), decoded));
+    EXPECT_EQ(decoded.entities, snapshot.entities);
+    EXPECT_EQ(receiver.get_latest()->tick, 3u);
+
+    // Stale acks do not move the baseline backwards
+    sender.acknowledge(3);
+    sender.acknowledge(2);
+    EXPECT_EQ(sender.get_baseline_tick(), std::optional<uint32_t>(3u));
+
+    // A receiver that never saw the baseline rejects the delta
+    SnapshotReceiver fresh(codec, 8);
+    codec.quantize(4, states, snapshot);
+    const std::size_t fourth = sender.encode(snapshot, buffer);
+    EXPECT_FALSE(fresh.decode(std::span<const uint8_t>(buffer.data(), fourth), decoded));
+}
+
+// Bytes per entity per tick and encode/decode cost, driven by TransformComponent data
+TEST_F(SnapshotTest, BenchmarkTransformReplication) {
+    constexpr std::size_t entity_count = 1000;
+    constexpr uint32_t ticks = 120;
+    constexpr uint32_t ack_delay = 3; // Baseline lags the newest tick by ~RTT
+
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> spread(-500.0f, 500.0f);
+    std::vector<TransformComponent> transforms;
+    transforms.reserve(entity_count);
+    for (std::size_t i = 0; i < entity_count; ++i) {
+        transforms.emplace_back(i + 1, Vec3(spread(rng), 0.0f, spread(rng)), Vec3(0.0f, 0.0f, 0.0f), Vec3(1.0f, 1.0f, 1.0f));
+    }
+
+    SnapshotSender sender(codec, 32);
+    SnapshotReceiver receiver(codec, 32);
+    std::vector<TransformState> states(entity_count);
+    std::vector<uint8_t> buffer(256 * 1024);
+    Snapshot snapshot;
+    Snapshot decoded;
+    std::size_t total_bytes = 0;
+    std::size_t full_bytes = 0;
+    double encode_ns = 0.0;
+    double decode_ns = 0.0;
+
+    for (uint32_t tick = 1; tick <= ticks; ++tick) {
+        // A quarter of the entities walk, a few turn
+        for (std::size_t i = 0; i < entity_count; i += 4) {
+            transforms[i].translate(Vec3(0.05f, 0.0f, 0.02f));
+        }
+        for (std::size_t i = 0; i < entity_count; i += 25) {
+            transforms[i].rotate(Vec3(0.0f, 3.0f, 0.0f));
+        }
+        for (std::size_t i = 0; i < entity_count; ++i) {
+            states[i] = capture_transform(transforms[i]);
+        }
+
+        const auto encode_start = std::chrono::steady_clock::now();
+        codec.quantize(tick, states, snapshot);
+        const std::size_t bytes = sender.encode(snapshot, buffer);
+        const auto encode_end = std::chrono::steady_clock::now();
+        ASSERT_GT(bytes, 0u);
+        ASSERT_TRUE(receiver.decode(std::span<const uint8_t>(buffer.data(), bytes), decoded));
+        const auto decode_end = std::chrono::steady_clock::now();
+        ASSERT_EQ(decoded.entities, snapshot.entities);
+
+        if (tick == 1) {
+            full_bytes = bytes;
+        } else {
+            total_bytes += bytes;
+            encode_ns += std::chrono::duration<double, std::nano>(encode_end - encode_start).count();
+            decode_ns += std::chrono::duration<double, std::nano>(decode_end - encode_end).count();
+        }
+        if (tick > ack_delay) {
+            sender.acknowledge(tick - ack_delay);
+        }
+    }
+
+    const double samples = static_cast<double>(entity_count) * (ticks - 1);
+    const double bytes_per_entity = static_cast<double>(total_bytes) / samples;
+    const double full_per_entity = static_cast<double>(full_bytes) / entity_count;
+    RecordProperty("delta_bytes_per_entity", std::to_string(bytes_per_entity));
+    RecordProperty("encode_ns_per_entity", std::to_string(encode_ns / samples));
+    RecordProperty("decode_ns_per_entity", std::to_string(decode_ns / samples));
+
+    EXPECT_LT(full_per_entity, 30.0);
+    EXPECT_LT(bytes_per_entity, 3.0);
+}
+
+} // namespace test
+} // namespace omnicpp
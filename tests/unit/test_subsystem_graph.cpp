@@ -0,0 +1,141 @@
+/**
+ * @file test_subsystem_graph.cpp
+ * @brief Unit tests for dependency-ordered subsystem startup
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/core/subsystem_graph.hpp"
+#include "engine/concurrency/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using OmniCpp::Engine::Core::SubsystemDesc;
+using OmniCpp::Engine::Core::SubsystemGraph;
+
+namespace omnicpp {
+namespace test {
+
+class SubsystemGraphTest : public ::testing::Test {
+protected:
+    SubsystemDesc make(const std::string& name, std::vector<std::string> deps, bool main_thread = false,
+                       bool succeed = true, int work_ms = 0) {
+        SubsystemDesc desc;
+        desc.name = name;
+        desc.dependencies = std::move(deps);
+        desc.main_thread_only = main_thread;
+        desc.initialize = [this, name, main_thread, succeed, work_ms]() {
+            if (work_ms > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(work_ms));
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            started.push_back(name);
+            if (main_thread && std::this_thread::get_id() != main_id) {
+                wrong_thread = true;
+            }
+            return succeed;
+        };
+        desc.shutdown = [this, name]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped.push_back(name);
+        };
+        return desc;
+    }
+
+    std::size_t position(const std::vector<std::string>& list, const std::string& name) {
+        return static_cast<std::size_t>(std::find(list.begin(), list.end(), name) - list.begin());
+    }
+
+    concurrency::ThreadPool pool{ 4 };
+    std::thread::id main_id = std::this_thread::get_id();
+    std::mutex mutex;
+    std::vector<std::string> started;
+    std::vector<std::string> stopped;
+    bool wrong_thread = false;
+};
+
+TEST_F(SubsystemGraphTest, RespectsDependenciesAndMainThread) {
+    SubsystemGraph graph;
+    graph.add(make("platform", {}, true));
+    graph.add(make("memory", {}));
+    graph.add(make("events", { "memory" }));
+    graph.add(make("window", { "platform", "events" }, true));
+    graph.add(make("renderer", { "window" }, true));
+    graph.add(make("audio", { "platform" }));
+
+    ASSERT_TRUE(graph.initialize(&pool));
+    EXPECT_FALSE(wrong_thread);
+    ASSERT_EQ(started.size(), 6u);
+    EXPECT_LT(position(started, "memory"), position(started, "events"));
+    EXPECT_LT(position(started, "events"), position(started, "window"));
+    EXPECT_LT(position(started, "window"), position(started, "renderer"));
+
+    graph.shutdown();
+    ASSERT_EQ(stopped.size(), 6u);
+    EXPECT_LT(position(stopped, "renderer"), position(stopped, "window"));
+    EXPECT_LT(position(stopped, "events"), position(stopped, "memory"));
+}
+
+TEST_F(SubsystemGraphTest, IndependentSubsystemsOverlap) {
+    SubsystemGraph graph;
+    for (int i = 0; i < 4; ++i) {
+        graph.add(make("worker" + std::to_string(i), {}, false, true, 30));
+    }
+
+    ASSERT_TRUE(graph.initialize(&pool));
+    const auto& report = graph.get_startup_report();
+    EXPECT_GE(report.serial_ms, 120.0);
+    EXPECT_LT(report.wall_ms, report.serial_ms);
+    EXPECT_EQ(report.critical_path.size(), 1u);
+}
+
+TEST_F(SubsystemGraphTest, CriticalPathFollowsLongestChain) {
+    SubsystemGraph graph;
+    graph.add(make("a", {}, false, true, 5));
+    graph.add(make("b", { "a" }, false, true, 20));
+    graph.add(make("c", { "a" }));
+    graph.add(make("d", { "b", "c" }));
+
+    ASSERT_TRUE(graph.initialize(&pool));
+    const std::vector<std::string> expected{ "a", "b", "d" };
+    EXPECT_EQ(graph.get_startup_report().critical_path, expected);
+}
+
+TEST_F(SubsystemGraphTest, FailureShutsDownWhatStarted) {
+    SubsystemGraph graph;
+    graph.add(make("memory", {}));
+    graph.add(make("broken", { "memory" }, false, false));
+    graph.add(make("dependent", { "broken" }));
+
+    EXPECT_FALSE(graph.initialize(&pool));
+    EXPECT_EQ(position(started, "dependent"), started.size());
+    ASSERT_EQ(stopped.size(), 1u);
+    EXPECT_EQ(stopped[0], "memory");
+}
+
+TEST_F(SubsystemGraphTest, RejectsCyclesAndUnknownDependencies) {
+    SubsystemGraph cyclic;
+    cyclic.add(make("a", { "b" }));
+    cyclic.add(make("b", { "a" }));
+    EXPECT_FALSE(cyclic.initialize(&pool));
+
+    SubsystemGraph unknown;
+    unknown.add(make("a", { "missing" }));
+    EXPECT_FALSE(unknown.initialize(nullptr));
+    EXPECT_TRUE(started.empty());
+}
+
+TEST_F(SubsystemGraphTest, SerialModeUsesTopologicalOrder) {
+    SubsystemGraph graph;
+    graph.add(make("scene", { "physics" }));
+    graph.add(make("physics", {}));
+
+    ASSERT_TRUE(graph.initialize(nullptr));
+    const std::vector<std::string> expected{ "physics", "scene" };
+    EXPECT_EQ(graph.get_initialization_order(), expected);
+}
+
+} // namespace test
+} // namespace omnicpp
@@ -0,0 +1,265 @@
+/**
+ * @file test_telemetry.cpp
+ * @brief Unit tests and benchmark for lock-free span recording
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/telemetry/Telemetry.hpp"
+#include "engine/telemetry/span_recorder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace omnicpp {
+namespace test {
+
+using namespace telemetry;
+
+namespace {
+
+class CollectingExporter : public SpanExporter {
+public:
+    bool export_spans(std::span<const SpanData> spans) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_spans.insert(m_spans.end(), spans.begin(), spans.end());
+        ++m_batches;
+        return true;
+    }
+
+    void force_flush() override {}
+    void shutdown() override {}
+
+    std::vector<SpanData> spans() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_spans;
+    }
+
+    int batches() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_batches;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<SpanData> m_spans;
+    int m_batches{ 0 };
+};
+
+} // namespace
+
+class TelemetryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_exporter = std::make_shared<CollectingExporter>();
+        m_config.service_name = "telemetry-test";
+        m_config.batch_timeout = std::chrono::milliseconds(50);
+    }
+
+    void TearDown() override { TelemetryManager::instance().shutdown(); }
+
+    void start() {
+        auto& manager = TelemetryManager::instance();
+        manager.set_exporter(m_exporter);
+        ASSERT_TRUE(manager.initialize(m_config));
+    }
+
+    std::shared_ptr<CollectingExporter> m_exporter;
+    TelemetryConfig m_config;
+};
+
+TEST_F(TelemetryTest, AttributesAreStoredFlat) {
+    Span span("flat", SpanKind::Internal, TraceId::generate());
+    static const AttributeKey kFrame("frame.number");
+    span.set_attribute(kFrame, 41);
+    span.set_attribute(kFrame, 42); // Overwrites in place
+    span.set_attribute("ratio", 0.5);
+    span.set_attribute("visible", true);
+    span.set_attribute("scene", std::string("level_1"));
+
+    const SpanRecord& record = span.record();
+    ASSERT_EQ(record.attribute_count, 4);
+    EXPECT_EQ(std::get<int64_t>(record.value(record.attributes[0])), 42);
+    EXPECT_EQ(std::get<double>(record.value(record.attributes[1])), 0.5);
+    EXPECT_TRUE(std::get<bool>(record.value(record.attributes[2])));
+    EXPECT_EQ(std::get<std::string>(record.value(record.attributes[3])), "level_1");
+    EXPECT_EQ(interned(record.attributes[0].key), "frame.number");
+    EXPECT_EQ(span.name(), "flat");
+    EXPECT_EQ(record.dropped, 0);
+}
+
+TEST_F(TelemetryTest, OverflowIsCountedNotAllocated) {
+    Span span("overflow", SpanKind::Internal, TraceId::generate());
+    for (std::size_t i = 0; i < SpanRecord::MAX_ATTRIBUTES + 3; ++i) {
+        span.set_attribute("key." + std::to_string(i), static_cast<int64_t>(i));
+    }
+    span.set_attribute("key.0", std::string(SpanRecord::TEXT_BYTES * 2, 'x'));
+
+    const SpanRecord& record = span.record();
+    EXPECT_EQ(record.attribute_count, SpanRecord::MAX_ATTRIBUTES);
+    EXPECT_EQ(record.dropped, 4);
+    EXPECT_EQ(std::get<std::string>(record.value(record.attributes[0])).size(), SpanRecord::TEXT_BYTES);
+}
+
+TEST_F(TelemetryTest, EndedSpansReachTheExporter) {
+    start();
+    auto& manager = TelemetryManager::instance();
+    {
+        Span root = manager.start_span("frame");
+        root.set_attribute("frame.number", 7);
+        root.add_event("vsync", { { "late", true } });
+        Span child = manager.start_span("physics", root);
+        child.set_status(StatusCode::Error, "diverged");
+        child.record_exception("SolverError", "too many iterations");
+        child.end();
+        root.end();
+    }
+    manager.force_flush();
+
+    const auto spans = m_exporter->spans();
+    ASSERT_EQ(spans.size(), 2u);
+    const SpanData& child = spans[0];
+    const SpanData& root = spans[1];
+    EXPECT_EQ(root.name, "frame");
+    EXPECT_EQ(child.name, "physics");
+    EXPECT_EQ(child.trace_id.to_hex(), root.trace_id.to_hex());
+    ASSERT_TRUE(child.parent_span_id.has_value());
+    EXPECT_EQ(child.parent_span_id->to_hex(), root.span_id.to_hex());
+    EXPECT_FALSE(root.parent_span_id.has_value());
+    EXPECT_EQ(child.status, StatusCode::Error);
+    EXPECT_EQ(child.status_description, "diverged");
+    ASSERT_EQ(child.events.size(), 1u);
+    EXPECT_EQ(child.events[0].name, "exception");
+    EXPECT_EQ(std::get<std::string>(child.events[0].attributes.at("exception.type")), "SolverError");
+    ASSERT_EQ(root.events.size(), 1u);
+    EXPECT_TRUE(std::get<bool>(root.events[0].attributes.at("late")));
+    EXPECT_EQ(std::get<int64_t>(root.attributes.at("frame.number")), 7);
+    EXPECT_EQ(std::get<std::string>(root.attributes.at("service.name")), "telemetry-test");
+
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    EXPECT_LE(root.start_time, now);
+    EXPECT_GT(root.start_time, now - std::chrono::minutes(1));
+    EXPECT_GE(root.duration, child.duration);
+}
+
+TEST_F(TelemetryTest, TicksAreConvertedToTime) {
+    start();
+    auto& manager = TelemetryManager::instance();
+    Span span = manager.start_span("sleep");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    span.add_event("woke");
+    span.end();
+    manager.force_flush();
+
+    const auto spans = m_exporter->spans();
+    ASSERT_EQ(spans.size(), 1u);
+    const SpanData& data = spans[0];
+    EXPECT_GE(data.duration, std::chrono::milliseconds(15));
+    EXPECT_LT(data.duration, std::chrono::seconds(1));
+    EXPECT_LT(std::chrono::abs(data.duration - span.duration()), std::chrono::microseconds(100)); // The rate may be refined in between
+    ASSERT_EQ(data.events.size(), 1u);
+    EXPECT_GE(data.events[0].time, data.start_time + std::chrono::milliseconds(15));
+    EXPECT_LE(data.events[0].time, data.start_time + data.duration);
+}
+
+TEST_F(TelemetryTest, SpansFromManyThreads) {
+    m_config.batch_size = 64;
+    start();
+    constexpr int THREADS = 4;
+    constexpr int SPANS = 500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < SPANS; ++i) {
+                Span span = TelemetryManager::instance().start_span("work");
+                span.set_attribute("worker", t);
+                span.end();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    TelemetryManager::instance().force_flush();
+
+    const auto spans = m_exporter->spans();
+    ASSERT_EQ(spans.size(), static_cast<std::size_t>(THREADS * SPANS));
+    std::set<std::string> ids;
+    for (const auto& span : spans) {
+        ids.insert(span.span_id.to_hex());
+    }
+    EXPECT_EQ(ids.size(), spans.size());
+    EXPECT_GE(m_exporter->batches(), THREADS * SPANS / 64);
+}
+
+TEST_F(TelemetryTest, FullRingDropsAndCounts) {
+    m_config.max_queue_size = 16;
+    m_config.batch_timeout = std::chrono::hours(1); // Nothing drains until the flush
+    start();
+
+    const auto before = SpanRecorder::instance().stats();
+    std::thread producer([] { // A new thread gets a ring of the configured size
+        for (int i = 0; i < 40; ++i) {
+            TelemetryManager::instance().start_span("burst").end();
+        }
+    });
+    producer.join();
+    const auto after = SpanRecorder::instance().stats();
+    EXPECT_EQ(after.recorded - before.recorded, 16u);
+    EXPECT_EQ(after.dropped - before.dropped, 24u);
+
+    TelemetryManager::instance().force_flush();
+    EXPECT_EQ(m_exporter->spans().size(), 16u);
+}
+
+TEST_F(TelemetryTest, SamplingRateZeroRecordsNothing) {
+    m_config.sampling_rate = 0.0;
+    start();
+    Span span = TelemetryManager::instance().start_span("unsampled");
+    EXPECT_FALSE(span.is_recording());
+    EXPECT_TRUE(span.trace_id().is_valid());
+    span.end();
+    TelemetryManager::instance().force_flush();
+    EXPECT_TRUE(m_exporter->spans().empty());
+}
+
+TEST_F(TelemetryTest, BenchmarkSpanStartEnd) {
+    using Clock = std::chrono::steady_clock;
+    constexpr int SPANS = 256; // A frame's worth; fits the ring, so the exporter has no reason to run while timed
+    constexpr int ROUNDS = 1000;
+    m_config.max_queue_size = SPANS;
+    m_config.batch_timeout = std::chrono::seconds(10);
+    start();
+    static const AttributeKey kEntity("entity.id");
+    const auto before = SpanRecorder::instance().stats();
+
+    double span_ns = 1e9;
+    std::thread producer([&span_ns] {
+        auto& manager = TelemetryManager::instance();
+        manager.start_span("warmup").end(); // Create this thread's ring outside the timing
+        manager.force_flush();
+        for (int round = 0; round < ROUNDS; ++round) {
+            const auto start_time = Clock::now();
+            for (int i = 0; i < SPANS; ++i) {
+                Span span = manager.start_span("update");
+                span.set_attribute(kEntity, i);
+                span.end();
+            }
+            span_ns = std::min(span_ns, std::chrono::duration<double, std::nano>(Clock::now() - start_time).count() / SPANS);
+            manager.force_flush();
+        }
+    });
+    producer.join();
+
+    const auto after = SpanRecorder::instance().stats();
+    EXPECT_EQ(after.dropped, before.dropped);
+    EXPECT_EQ(m_exporter->spans().size(), static_cast<std::size_t>(SPANS * ROUNDS + 1));
+    RecordProperty("span_ns", static_cast<int>(span_ns));
+}
+
+} // namespace test
+} // namespace omnicpp
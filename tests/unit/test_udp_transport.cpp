@@ -0,0 +1,359 @@
+/**
+ * @file test_udp_transport.cpp
+ * @brief Loopback tests for the UDP transport and its reliability channels
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/network/network_manager.hpp"
+#include "engine/network/transport.hpp"
+#include "engine/network/udp_socket.hpp"
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <thread>
+
+using namespace OmniCpp::Engine::Network;
+
+namespace omnicpp {
+namespace test {
+
+class UdpTransportTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        TransportConfig server_config;
+        server_config.bind_address = "127.0.0.1";
+        server_config.accept_connections = true;
+        server_config.max_connections = 4;
+        ASSERT_TRUE(server.initialize(server_config));
+
+        TransportConfig client_config;
+        client_config.bind_address = "127.0.0.1";
+        ASSERT_TRUE(client.initialize(client_config));
+    }
+
+    // Drive both ends (and the optional relay) until the predicate holds
+    bool pump(const std::function<bool()>& done, std::chrono::milliseconds timeout = std::chrono::milliseconds(3000)) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline) {
+            client.update();
+            if (relay) {
+                relay();
+            }
+            server.update();
+            if (relay) {
+                relay();
+            }
+            if (done()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    // Connects the client to `port` and waits for both sides to report it
+    ConnectionId connect(uint16_t port) {
+        auto id = client.connect("127.0.0.1", port);
+        EXPECT_TRUE(id.has_value());
+        EXPECT_TRUE(pump([&]() { return client.is_connected(*id) && server.get_connection_count() == 1; }));
+        return *id;
+    }
+
+    void drain_server(std::vector<Message>& out) {
+        Message message;
+        while (server.poll_message(message)) {
+            out.push_back(std::move(message));
+        }
+    }
+
+    static std::vector<uint8_t> encode(uint32_t value) {
+        std::vector<uint8_t> bytes(4);
+        std::memcpy(bytes.data(), &value, 4);
+        return bytes;
+    }
+
+    // Relays between the client and `target_port`, dropping every `drop_every`th datagram per direction
+    uint16_t start_lossy_relay(uint16_t target_port, uint64_t drop_every) {
+        EXPECT_TRUE(relay_socket.open(0, "127.0.0.1"));
+        EXPECT_TRUE(relay_socket.resolve("127.0.0.1", target_port, relay_target));
+        relay = [this, drop_every]() {
+            relay_socket.receive(relay_in);
+            relay_out.clear();
+            for (std::size_t i = 0; i < relay_in.size(); ++i) {
+                const bool from_server = relay_in.endpoint(i) == relay_target;
+                if (!from_server) {
+                    relay_client = relay_in.endpoint(i);
+                }
+                if (++relay_forwarded[from_server ? 1 : 0] % drop_every == 0) {
+                    continue;
+                }
+                auto buffer = relay_out.prepare(from_server ? relay_client : relay_target);
+                std::memcpy(buffer.data(), relay_in.data(i).data(), relay_in.data(i).size());
+                relay_out.commit(relay_in.data(i).size());
+            }
+            relay_socket.send(relay_out);
+        };
+        return relay_socket.get_local_port();
+    }
+
+    static uint32_t decode(std::span<const uint8_t> bytes) {
+        uint32_t value = 0;
+        std::memcpy(&value, bytes.data(), 4);
+        return value;
+    }
+
+    Transport server;
+    Transport client;
+    std::function<void()> relay;
+    UdpSocket relay_socket;
+    Endpoint relay_target;
+    Endpoint relay_client;
+    DatagramBatch relay_in{ 64, 1500 };
+    DatagramBatch relay_out{ 64, 1500 };
+    uint64_t relay_forwarded[2] = { 0, 0 };
+};
+
+TEST_F(UdpTransportTest, HandshakeRaisesConnectedEvents) {
+    const ConnectionId id = connect(server.get_local_port());
+
+    TransportEvent event;
+    ASSERT_TRUE(client.poll_event(event));
+    EXPECT_EQ(event.type, TransportEvent::Type::Connected);
+    EXPECT_EQ(event.connection, id);
+    ASSERT_TRUE(server.poll_event(event));
+    EXPECT_EQ(event.type, TransportEvent::Type::Connected);
+
+    // Keepalives carry acks, which give an RTT sample
+    EXPECT_TRUE(pump([&]() { return client.get_rtt_ms(id) > 0.0; }));
+}
+
+TEST_F(UdpTransportTest, ReliableOrderedDeliversInSendOrder) {
+    const ConnectionId id = connect(server.get_local_port());
+    for (uint32_t i = 0; i < 300; ++i) {
+        ASSERT_TRUE(client.send(id, Channel::ReliableOrdered, encode(i)));
+    }
+
+    std::vector<Message> received;
+    ASSERT_TRUE(pump([&]() {
+        drain_server(received);
+        return received.size() >= 300;
+    }));
+    ASSERT_EQ(received.size(), 300u);
+    for (uint32_t i = 0; i < 300; ++i) {
+        EXPECT_EQ(received[i].channel, Channel::ReliableOrdered);
+        EXPECT_EQ(decode(received[i].data), i);
+    }
+}
+
+TEST_F(UdpTransportTest, SmallMessagesAreCoalesced) {
+    const ConnectionId id = connect(server.get_local_port());
+    const auto before = client.get_stats();
+    for (uint32_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(client.send(id, Channel::Unreliable, encode(i)));
+    }
+    client.update();
+    const auto after = client.get_stats();
+
+    // 100 x (5 + 4) bytes fit in one 1200-byte packet
+    EXPECT_EQ(after.packets_sent - before.packets_sent, 1u);
+    EXPECT_LE(after.send_syscalls - before.send_syscalls, 1u);
+
+    std::vector<Message> received;
+    EXPECT_TRUE(pump([&]() {
+        drain_server(received);
+        return received.size() == 100;
+    }));
+}
+
+TEST_F(UdpTransportTest, LargeMessagesAreFragmentedAndReassembled) {
+    const ConnectionId id = connect(server.get_local_port());
+    std::vector<uint8_t> payload(20000);
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<uint8_t>(i * 31u);
+    }
+
+    for (Channel channel : { Channel::Unreliable, Channel::ReliableOrdered, Channel::ReliableUnordered }) {
+        ASSERT_TRUE(client.send(id, channel, payload));
+    }
+
+    std::vector<Message> received;
+    ASSERT_TRUE(pump([&]() {
+        drain_server(received);
+        return received.size() == 3;
+    }));
+    for (const auto& message : received) {
+        EXPECT_EQ(message.data, payload);
+    }
+    EXPECT_GE(client.get_stats().fragments_sent, 3u * 17u);
+}
+
+TEST_F(UdpTransportTest, RejectsOversizedMessagesAndUnknownConnections) {
+    const ConnectionId id = connect(server.get_local_port());
+    std::vector<uint8_t> too_big(128 * 1024);
+    EXPECT_FALSE(client.send(id, Channel::ReliableOrdered, too_big));
+    EXPECT_FALSE(client.send(id + 100, Channel::Unreliable, encode(1)));
+}
+
+TEST_F(UdpTransportTest, DisconnectNotifiesPeer) {
+    const ConnectionId id = connect(server.get_local_port());
+    TransportEvent event;
+    while (server.poll_event(event)) {
+    }
+
+    client.disconnect(id);
+    EXPECT_FALSE(client.is_connected(id));
+    ASSERT_TRUE(pump([&]() { return server.get_connection_count() == 0; }));
+    ASSERT_TRUE(server.poll_event(event));
+    EXPECT_EQ(event.type, TransportEvent::Type::Disconnected);
+}
+
+TEST_F(UdpTransportTest, ReliableChannelsSurvivePacketLoss) {
+    const ConnectionId id = connect(start_lossy_relay(server.get_local_port(), 3));
+    std::vector<uint8_t> large(5000, 0xAB);
+    for (uint32_t i = 0; i < 200; ++i) {
+        ASSERT_TRUE(client.send(id, Channel::ReliableOrdered, encode(i)));
+        ASSERT_TRUE(client.send(id, Channel::ReliableUnordered, encode(i)));
+    }
+    ASSERT_TRUE(client.send(id, Channel::ReliableOrdered, large));
+
+    std::vector<Message> received;
+    ASSERT_TRUE(pump([&]() {
+        drain_server(received);
+        return received.size() >= 401;
+    }, std::chrono::milliseconds(10000)));
+    ASSERT_EQ(received.size(), 401u);
+
+    uint32_t next_ordered = 0;
+    std::set<uint32_t> unordered;
+    for (const auto& message : received) {
+        if (message.channel == Channel::ReliableOrdered) {
+            if (next_ordered < 200) {
+                EXPECT_EQ(decode(message.data), next_ordered);
+            } else {
+                EXPECT_EQ(message.data, large);
+            }
+            ++next_ordered;
+        } else {
+            EXPECT_TRUE(unordered.insert(decode(message.data)).second) << "duplicate delivery";
+        }
+    }
+    EXPECT_EQ(next_ordered, 201u);
+    EXPECT_EQ(unordered.size(), 200u);
+    EXPECT_GT(client.get_stats().resends, 0u);
+}
+
+TEST_F(UdpTransportTest, FragmentsClaimingAnOversizedMessageAreRejected) {
+    Transport guarded;
+    TransportConfig config;
+    config.bind_address = "127.0.0.1";
+    config.accept_connections = true;
+    config.max_message_size = 4096;
+    ASSERT_TRUE(guarded.initialize(config));
+    server.shutdown();
+    server = std::move(guarded);
+
+    const ConnectionId id = connect(server.get_local_port());
+    ASSERT_TRUE(client.send(id, Channel::Unreliable, std::vector<uint8_t>(20000, 1)));
+    ASSERT_TRUE(pump([&]() { return server.get_stats().invalid_packets > 0; }));
+
+    Message message;
+    EXPECT_FALSE(server.poll_message(message));
+    EXPECT_EQ(server.get_connection_count(), 1u);
+}
+
+TEST_F(UdpTransportTest, IncompleteFragmentsBeyondTheCapDropThePeer) {
+    Transport guarded;
+    TransportConfig config;
+    config.bind_address = "127.0.0.1";
+    config.accept_connections = true;
+    config.max_reassembly_bytes = 32 * 1024; // Three groups of seven fragments
+    ASSERT_TRUE(guarded.initialize(config));
+    server.shutdown();
+    server = std::move(guarded);
+
+    // Every other datagram is lost, so unreliable groups stay open until they time out
+    const ConnectionId id = connect(start_lossy_relay(server.get_local_port(), 2));
+    TransportEvent event;
+    while (server.poll_event(event)) {
+    }
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(client.send(id, Channel::Unreliable, std::vector<uint8_t>(8000, 2)));
+    }
+
+    ASSERT_TRUE(pump([&]() { return server.get_connection_count() == 0; }));
+    EXPECT_EQ(server.get_stats().reassembly_overflows, 1u);
+    ASSERT_TRUE(server.poll_event(event));
+    EXPECT_EQ(event.type, TransportEvent::Type::Disconnected);
+}
+
+TEST_F(UdpTransportTest, DatagramBatchRoundTripsThroughSocket) {
+    UdpSocket a;
+    UdpSocket b;
+    ASSERT_TRUE(a.open(0, "127.0.0.1"));
+    ASSERT_TRUE(b.open(0, "127.0.0.1"));
+    Endpoint to_b;
+    ASSERT_TRUE(a.resolve("127.0.0.1", b.get_local_port(), to_b));
+
+    DatagramBatch out(16, 256);
+    for (uint8_t i = 0; i < 16; ++i) {
+        auto buffer = out.prepare(to_b);
+        ASSERT_FALSE(buffer.empty());
+        buffer[0] = i;
+        out.commit(1 + i);
+    }
+    EXPECT_TRUE(out.full());
+    EXPECT_TRUE(out.prepare(to_b).empty());
+    EXPECT_EQ(a.send(out), 16u);
+
+    DatagramBatch in(32, 256);
+    std::size_t total = 0;
+    for (int attempt = 0; attempt < 100 && total < 16; ++attempt) {
+        total += b.receive(in);
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            EXPECT_EQ(in.data(i).size(), 1u + in.data(i)[0]);
+            EXPECT_EQ(in.endpoint(i).port(), a.get_local_port());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(total, 16u);
+}
+
+TEST(NetworkManagerTest, ClientAndServerExchangeMessages) {
+    NetworkManager server;
+    NetworkConfig server_config;
+    server_config.port = 0;
+    server_config.is_server = true;
+    ASSERT_TRUE(server.initialize(server_config));
+    ASSERT_TRUE(server.start_server());
+    const uint16_t port = server.get_transport().get_local_port();
+
+    NetworkManager client;
+    ASSERT_TRUE(client.initialize({}));
+    EXPECT_FALSE(client.connect_to_server("127.0.0.1:notaport"));
+    ASSERT_TRUE(client.connect_to_server("127.0.0.1:" + std::to_string(port)));
+
+    const std::vector<uint8_t> hello = { 'h', 'i' };
+    Message message;
+    bool replied = false;
+    for (int i = 0; i < 2000 && !replied; ++i) {
+        client.update();
+        server.update();
+        if (server.poll_message(message)) {
+            EXPECT_EQ(message.data, hello);
+            server.broadcast(Channel::ReliableOrdered, message.data);
+        }
+        if (client.is_connected() && i % 50 == 0) {
+            client.send(client.get_transport().get_connections().front(), Channel::ReliableOrdered, hello);
+        }
+        replied = client.poll_message(message);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(replied);
+    client.shutdown();
+    server.shutdown();
+}
+
+} // namespace test
+} // namespace omnicpp
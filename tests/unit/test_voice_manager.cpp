@@ -0,0 +1,281 @@
+/**
+ * @file test_voice_manager.cpp
+ * @brief Unit tests and scaling benchmark for voice virtualization and stealing
+ * @version 1.0.0
+ */
+
+#include <gtest/gtest.h>
+#include "engine/audio/voice_manager.hpp"
+#include <cmath>
+#include <random>
+
+using namespace omnicpp::audio;
+using omnicpp::math::Vec3;
+
+namespace omnicpp {
+namespace test {
+
+namespace {
+
+constexpr uint32_t BLOCK = 256;
+constexpr float TICK = 1.0f / 60.0f;
+
+class VoiceManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        MixerConfig config;
+        config.block_frames = BLOCK;
+        config.max_voices = 64;
+        ASSERT_TRUE(mixer.initialize(config));
+        block.resize(BLOCK * 2);
+
+        auto data = std::make_shared<SoundData>();
+        data->samples.assign(48000, 0.5f); // One second
+        sound = mixer.add_sound(data);
+        ASSERT_NE(sound, INVALID_SOUND);
+    }
+
+    // One game tick: manage voices, then let the mixer apply and recycle
+    void tick(VoiceManager& voices, float dt = TICK) {
+        voices.update(listener, dt);
+        mixer.render(block);
+        mixer.update();
+    }
+
+    EmitterDesc emitter(const Vec3& position, float priority = 1.0f, bool loop = true) const {
+        EmitterDesc desc;
+        desc.sound = sound;
+        desc.position = position;
+        desc.priority = priority;
+        desc.loop = loop;
+        return desc;
+    }
+
+    Mixer mixer;
+    SoundId sound{ INVALID_SOUND };
+    Listener listener;
+    std::vector<float> block;
+};
+
+} // namespace
+
+TEST(SpatializeTest, BatchMatchesScalarModel) {
+    Listener listener;
+    listener.position = Vec3(1.0f, 2.0f, 3.0f);
+    listener.right = Vec3(0.0f, 0.0f, 1.0f);
+
+    constexpr std::size_t COUNT = 37; // Not a multiple of the SIMD width
+    std::vector<float> x(COUNT), y(COUNT), z(COUNT), inner(COUNT, 2.0f), outer(COUNT, 40.0f);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        x[i] = coordinate(rng);
+        y[i] = coordinate(rng);
+        z[i] = coordinate(rng);
+    }
+    x[0] = 1.0f; // On top of the listener
+    y[0] = 2.0f;
+    z[0] = 3.0f;
+
+    std::vector<float> attenuation(COUNT), pan(COUNT);
+    spatialize(listener, COUNT, x.data(), y.data(), z.data(), inner.data(), outer.data(), attenuation.data(),
+               pan.data());
+
+    for (std::size_t i = 0; i < COUNT; ++i) {
+        const Vec3 offset(x[i] - 1.0f, y[i] - 2.0f, z[i] - 3.0f);
+        const float dist = offset.length();
+        const float expected = dist > 40.0f ? 0.0f : 2.0f / std::max(dist, 2.0f);
+        EXPECT_NEAR(attenuation[i], expected, 1e-5f) << i;
+        EXPECT_NEAR(pan[i], std::clamp(offset.z / std::max(dist, 2.0f), -1.0f, 1.0f), 1e-5f) << i;
+    }
+    EXPECT_FLOAT_EQ(attenuation[0], 1.0f);
+    EXPECT_FLOAT_EQ(pan[0], 0.0f);
+}
+
+TEST_F(VoiceManagerTest, RealVoicesStayWithinBudget) {
+    VoiceManagerConfig config;
+    config.max_real_voices = 8;
+    VoiceManager voices(mixer, config);
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_NE(voices.add_emitter(emitter(Vec3(static_cast<float>(i % 20), 0.0f, static_cast<float>(i / 20)))),
+                  INVALID_EMITTER);
+    }
+
+    for (int i = 0; i < 10; ++i) {
+        tick(voices);
+        EXPECT_LE(voices.get_stats().real_voices, 8u);
+        EXPECT_LE(mixer.get_active_voice_count(), 16u); // 8 playing plus at most 8 fading out
+    }
+    EXPECT_EQ(voices.get_stats().real_voices, 8u);
+    EXPECT_EQ(voices.get_stats().virtual_voices, 192u);
+    EXPECT_EQ(voices.get_stats().emitters, 200u);
+}
+
+TEST_F(VoiceManagerTest, InaudibleEmittersStayVirtual) {
+    VoiceManager voices(mixer);
+    const EmitterId remote = voices.add_emitter(emitter(Vec3(500.0f, 0.0f, 0.0f)));
+    const EmitterId quiet = voices.add_emitter(emitter(Vec3(1.0f, 0.0f, 0.0f)));
+    voices.set_gain(quiet, 0.0f);
+    tick(voices);
+
+    EXPECT_FALSE(voices.is_real(remote));
+    EXPECT_FALSE(voices.is_real(quiet));
+    EXPECT_EQ(voices.get_audibility(remote), 0.0f);
+    EXPECT_EQ(mixer.get_active_voice_count(), 0u);
+
+    voices.set_position(remote, Vec3(3.0f, 0.0f, 0.0f));
+    tick(voices);
+    EXPECT_TRUE(voices.is_real(remote));
+    EXPECT_NEAR(voices.get_audibility(remote), 1.0f / 3.0f, 1e-5f);
+}
+
+TEST_F(VoiceManagerTest, StealsByPriorityAndDistance) {
+    VoiceManagerConfig config;
+    config.max_real_voices = 2;
+    VoiceManager voices(mixer, config);
+    const EmitterId closest = voices.add_emitter(emitter(Vec3(1.0f, 0.0f, 0.0f)));
+    const EmitterId mid = voices.add_emitter(emitter(Vec3(4.0f, 0.0f, 0.0f)));
+    const EmitterId distant = voices.add_emitter(emitter(Vec3(10.0f, 0.0f, 0.0f)));
+    tick(voices);
+    EXPECT_TRUE(voices.is_real(closest));
+    EXPECT_TRUE(voices.is_real(mid));
+    EXPECT_FALSE(voices.is_real(distant));
+
+    // Priority outweighs a 10x attenuation gap and takes the weakest real voice
+    voices.set_priority(distant, 20.0f);
+    tick(voices);
+    EXPECT_TRUE(voices.is_real(distant));
+    EXPECT_TRUE(voices.is_real(closest));
+    EXPECT_FALSE(voices.is_real(mid));
+    EXPECT_EQ(voices.get_stats().steals, 1u);
+
+    // Hysteresis: a challenger slightly louder than a real voice does not take it
+    voices.set_position(closest, Vec3(1.1f, 0.0f, 0.0f)); // 0.91, x1.25 while real
+    voices.set_position(mid, Vec3(1.0f, 0.0f, 0.0f));  // 1.0
+    tick(voices);
+    EXPECT_TRUE(voices.is_real(closest));
+    EXPECT_FALSE(voices.is_real(mid));
+
+    voices.set_position(closest, Vec3(2.0f, 0.0f, 0.0f)); // 0.5 x 1.25 < 1.0
+    tick(voices);
+    EXPECT_TRUE(voices.is_real(mid));
+    EXPECT_FALSE(voices.is_real(closest));
+    EXPECT_TRUE(voices.is_real(distant));
+    EXPECT_EQ(voices.get_stats().steals, 2u);
+}
+
+TEST_F(VoiceManagerTest, VirtualVoiceResumesAtAdvancedPosition) {
+    VoiceManager voices(mixer);
+    const EmitterId id = voices.add_emitter(emitter(Vec3(500.0f, 0.0f, 0.0f)));
+    for (int i = 0; i < 30; ++i) {
+        tick(voices); // Half a second, inaudible
+    }
+    EXPECT_FALSE(voices.is_real(id));
+    EXPECT_NEAR(static_cast<double>(voices.get_cursor(id)), 24000.0, 2.0);
+
+    voices.set_position(id, Vec3(0.5f, 0.0f, 0.0f));
+    tick(voices);
+    ASSERT_TRUE(voices.is_real(id));
+    EXPECT_EQ(voices.get_stats().promotions, 1u);
+
+    // The cursor keeps counting and the loop wraps it
+    for (int i = 0; i < 40; ++i) {
+        tick(voices);
+    }
+    EXPECT_NEAR(static_cast<double>(voices.get_cursor(id)), (24000.0 + 41 * 800.0) - 48000.0, 4.0);
+}
+
+TEST(VoiceStartFrameTest, MixerStartsAtRequestedFrame) {
+    Mixer mixer;
+    MixerConfig config;
+    config.block_frames = BLOCK;
+    ASSERT_TRUE(mixer.initialize(config));
+    auto data = std::make_shared<SoundData>();
+    data->samples.resize(1000);
+    for (std::size_t i = 0; i < data->samples.size(); ++i) {
+        data->samples[i] = static_cast<float>(i) * 0.001f;
+    }
+    const SoundId sound = mixer.add_sound(data);
+
+    VoiceParams params;
+    params.pan = -1.0f; // Constant-power pan puts the full sample on the left
+    params.start_frame = 600;
+    ASSERT_TRUE(mixer.play(sound, params).valid());
+    std::vector<float> block(BLOCK * 2);
+    mixer.render(block);
+    EXPECT_NEAR(block[0], 0.6f, 1e-5f);
+    EXPECT_NEAR(block[2], 0.601f, 1e-5f);
+
+    params.start_frame = 5000; // Past the end of a one-shot: nothing to play
+    const VoiceHandle late = mixer.play(sound, params);
+    mixer.render(block);
+    mixer.render(block);
+    mixer.update();
+    EXPECT_FALSE(mixer.is_playing(late));
+}
+
+TEST_F(VoiceManagerTest, OneShotsExpireWhileVirtual) {
+    VoiceManager voices(mixer);
+    const EmitterId distant = voices.add_emitter(emitter(Vec3(500.0f, 0.0f, 0.0f), 1.0f, false));
+    const EmitterId close = voices.add_emitter(emitter(Vec3(1.0f, 0.0f, 0.0f), 1.0f, false));
+    tick(voices);
+    EXPECT_TRUE(voices.is_real(close));
+
+    for (int i = 0; i < 61; ++i) {
+        tick(voices, TICK);
+    }
+    EXPECT_FALSE(voices.is_active(distant)); // Expired by its cursor alone
+    // The real one ends when the mixer has played it out (one second at 256-frame blocks is 188 renders)
+    for (int i = 0; i < 200 && voices.is_active(close); ++i) {
+        tick(voices, 0.0f);
+    }
+    EXPECT_FALSE(voices.is_active(close));
+    EXPECT_EQ(voices.get_stats().expired, 2u);
+    EXPECT_EQ(voices.get_stats().emitters, 0u);
+}
+
+TEST_F(VoiceManagerTest, RemovedEmitterStopsItsVoice) {
+    VoiceManager voices(mixer);
+    const EmitterId id = voices.add_emitter(emitter(Vec3(1.0f, 0.0f, 0.0f)));
+    tick(voices);
+    const VoiceHandle voice = voices.get_voice(id);
+    ASSERT_TRUE(voice.valid());
+
+    voices.remove_emitter(id);
+    EXPECT_FALSE(voices.is_active(id));
+    mixer.render(block);
+    mixer.render(block);
+    mixer.update();
+    EXPECT_FALSE(mixer.is_playing(voice));
+    EXPECT_EQ(voices.add_emitter(EmitterDesc{}), INVALID_EMITTER);
+}
+
+TEST_F(VoiceManagerTest, BenchmarkUpdateCostIsBoundedByRealVoices) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> coordinate(-200.0f, 200.0f);
+
+    double last_per_emitter = 0.0;
+    for (const int count : { 1000, 10000, 50000 }) {
+        VoiceManager voices(mixer);
+        for (int i = 0; i < count; ++i) {
+            auto desc = emitter(Vec3(coordinate(rng), 0.0f, coordinate(rng)));
+            desc.priority = 1.0f + static_cast<float>(i % 4);
+            voices.add_emitter(desc);
+        }
+        uint64_t total_ns = 0;
+        constexpr int TICKS = 20;
+        for (int i = 0; i < TICKS; ++i) {
+            tick(voices);
+            total_ns += voices.get_stats().update_ns;
+            EXPECT_LE(voices.get_stats().real_voices, 32u);
+            EXPECT_LE(mixer.get_active_voice_count(), 64u);
+        }
+        last_per_emitter = static_cast<double>(total_ns) / TICKS / count;
+        mixer.render(block);
+        mixer.update();
+    }
+    RecordProperty("ns_per_emitter", static_cast<int>(last_per_emitter));
+}
+
+} // namespace test
+} // namespace omnicpp